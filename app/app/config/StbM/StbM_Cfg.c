@@ -0,0 +1,31 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "StbM_Cfg.h"
+#include "StbM_Priv.h"
+#include "StbM.h"
+/* ================================ [ MACROS    ] ============================================== */
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static StbM_TimeBaseContextType StbM_TimeBaseContext0;
+
+static const StbM_TimeBaseConfigType StbM_TimeBases[1] = {
+  {
+    &StbM_TimeBaseContext0,
+    1000000,                              /* stepThreshold: 1ms */
+    500000,                               /* maxRate: 500ppm */
+    STBM_SERVO_GAIN(0.7),                 /* kp */
+    STBM_SERVO_GAIN(0.3),                 /* ki */
+    STBM_CONVERT_MS_TO_MAIN_CYCLES(2500), /* syncLossTimeout */
+  },
+};
+
+const StbM_ConfigType StbM_Config = {
+  StbM_TimeBases,
+  ARRAY_SIZE(StbM_TimeBases),
+};
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
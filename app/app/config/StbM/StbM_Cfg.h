@@ -0,0 +1,19 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ */
+#ifndef _STBM_CFG_H
+#define _STBM_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef STBM_MAIN_FUNCTION_PERIOD
+#define STBM_MAIN_FUNCTION_PERIOD 10
+#endif
+#define STBM_CONVERT_MS_TO_MAIN_CYCLES(x)                                                          \
+  ((x + STBM_MAIN_FUNCTION_PERIOD - 1) / STBM_MAIN_FUNCTION_PERIOD)
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* _STBM_CFG_H */
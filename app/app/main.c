@@ -66,6 +66,10 @@ boolean __weak Mcu_IsResetRequested(void) {
 #endif
 
 extern boolean Can_WakeupCheck();
+#if defined(USE_OSAL) && defined(USE_CANIF) && (defined(_WIN32) || defined(linux))
+extern boolean Can_WaitEvent(uint32_t timeoutUs);
+extern void Can_MainFunction_Read(void);
+#endif
 void __weak Mcu_EnterSleepMode(void) {
   boolean bWakeup = FALSE;
   ASLOG(INFO, ("Enter Sleep Mode!!!\n"));
@@ -254,7 +258,14 @@ void Task_MainLoop(void) {
     stdio_main_function();
 #endif
 #ifdef USE_OSAL
+#if defined(USE_CANIF) && (defined(_WIN32) || defined(linux))
+    /* woken up by the CAN RX threads to indicate the frames before the next 1ms tick */
+    if (TRUE == Can_WaitEvent(1000)) {
+      Can_MainFunction_Read();
+    }
+#else
     OSAL_SleepUs(1000);
+#endif
 #else
     TaskIdleHook();
 #endif
@@ -27,6 +27,9 @@
 
 #include <thread>
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
 
 #include "Std_Debug.h"
 
@@ -44,6 +47,7 @@ static Std_TimerType timer1s;
 static std::unique_ptr<RadarServiceProxy> myRadarProxy;
 static std::thread radarServiceThread;
 static std::thread radarServiceMethodThread;
+static uint32_t benchCount = 0;
 /* ================================ [ LOCALS    ] ============================================== */
 void handleBrakeEventReception() {
   myRadarProxy->BrakeEvent.GetNewSamples([&](SamplePtr<events::BrakeEvent::SampleType> samplePtr) {
@@ -176,6 +180,55 @@ static void RadarServiceMethodMain(void) {
   ASLOG(RADAR, ("Method offline\n"));
 }
 
+/* round trip latency of the Adjust method, one request in flight at a time */
+static void RadarServiceMethodBench(void) {
+  std::vector<uint32_t> latency;
+  uint32_t errors = 0;
+  while (nullptr == myRadarProxy) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  auto state = myRadarProxy->BrakeEvent.GetSubscriptionState();
+  while (state != SubscriptionState::kSubscribed) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    state = myRadarProxy->BrakeEvent.GetSubscriptionState();
+  }
+
+  latency.reserve(benchCount);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < benchCount; i++) {
+    methods::Adjust::Position target_position = {i, i + 1, i + 2};
+    auto t0 = std::chrono::steady_clock::now();
+    Future<methods::Adjust::Output> future = myRadarProxy->Adjust(target_position);
+    Result<methods::Adjust::Output> rslt = future.GetResult();
+    auto t1 = std::chrono::steady_clock::now();
+    if (rslt.HasValue()) {
+      latency.push_back(
+        (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count());
+    } else {
+      errors++;
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  if (false == latency.empty()) {
+    uint64_t sum = 0;
+    for (auto us : latency) {
+      sum += us;
+    }
+    std::sort(latency.begin(), latency.end());
+    printf("Adjust round trip: %u requests, %u errors, %.1f req/s\n", benchCount, errors,
+           (double)latency.size() * 1000000.0 / (double)(elapsed > 0 ? elapsed : 1));
+    printf("  latency us: min %u, avg %u, p50 %u, p99 %u, max %u\n", latency.front(),
+           (uint32_t)(sum / latency.size()), latency[latency.size() / 2],
+           latency[(latency.size() * 99) / 100], latency.back());
+  } else {
+    printf("Adjust round trip: all %u requests failed\n", benchCount);
+  }
+  exit(0);
+}
+
 static void RadarServiceMethodMainLoop(void) {
   while (true) {
     RadarServiceMethodMain();
@@ -184,6 +237,9 @@ static void RadarServiceMethodMainLoop(void) {
 }
 /* ================================ [ FUNCTIONS ] ============================================== */
 int main(int argc, char *argv[]) {
+  if ((argc > 2) && (0 == strcmp(argv[1], "-b"))) {
+    benchCount = (uint32_t)atoi(argv[2]);
+  }
 #ifdef USE_SOMEIP
   TcpIp_Init(NULL);
   SoAd_Init(NULL);
@@ -195,7 +251,11 @@ int main(int argc, char *argv[]) {
   Std_TimerStart(&timer1s);
 
   radarServiceThread = std::thread(RadarServiceMainLoop);
-  radarServiceMethodThread = std::thread(RadarServiceMethodMainLoop);
+  if (benchCount > 0) {
+    radarServiceMethodThread = std::thread(RadarServiceMethodBench);
+  } else {
+    radarServiceMethodThread = std::thread(RadarServiceMethodMainLoop);
+  }
 
   for (;;) {
     if (Std_GetTimerElapsedTime(&timer10ms) >= 10000) {
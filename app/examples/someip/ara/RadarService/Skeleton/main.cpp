@@ -16,6 +16,7 @@
 #include "SomeIp.h"
 #include "SomeIpXf.h"
 #include "E2E.h"
+#include "ara/core/executor.h"
 
 #include "Sd_Cfg.h"
 #include "SomeIp_Cfg.h"
@@ -51,19 +52,18 @@ public:
 #if 0
     promise.set_value(doAdjustInternal(position));
 #else
-    // asynchronous call to internal adjust function in a new Thread
-    std::thread th(
-      [this](const Position &pos, ara::core::Promise<AdjustOutput> prom) {
-        prom.set_value(doAdjustInternal(pos));
-      },
-      std::cref(position), std::move(promise));
-    th.detach();
+    // asynchronous call to internal adjust function in the worker pool
+    m_executor([this, pos = position, prom = std::move(promise)]() mutable {
+      prom.set_value(doAdjustInternal(pos));
+    });
 #endif
     // we return a future, which might be set or not at this point...
     return future;
   }
 
 private:
+  ara::core::ThreadPoolExecutor m_executor{2};
+
   AdjustOutput doAdjustInternal(const Position &position) {
     AdjustOutput out;
 
@@ -17,8 +17,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include "Std_Timer.h"
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include "shell.h"
+#ifdef USE_PCAP
+#include "pcap.h"
+#endif
 /* ================================ [ MACROS    ] ============================================== */
 /* this simulation just alow only one HTH/HRH for each CAN controller */
 #define CAN_MAX_HOH 64
@@ -36,6 +43,29 @@
 #ifndef USE_CAN_FILE_LOG
 #define logCan(isRx, Controller, canid, dlc, data)
 #endif
+
+#ifdef USE_PCAP
+#define PCAP_TRACE(isRx, Controller, canid, dlc, data) PCap_Can(Controller, canid, dlc, data, isRx)
+#else
+#define PCAP_TRACE(isRx, Controller, canid, dlc, data)
+#endif
+
+/* the number of frames waiting for the TX mailbox of each controller, a power of 2 */
+#ifndef CAN_TX_QUEUE_SIZE
+#define CAN_TX_QUEUE_SIZE 32
+#endif
+
+/* the number of frames received by the RX thread of each controller, a power of 2 */
+#ifndef CAN_RX_QUEUE_SIZE
+#define CAN_RX_QUEUE_SIZE 128
+#endif
+
+/* the maximum number of frames indicated by one Can_MainFunction_ReadChannel */
+#ifndef CAN_RX_BATCH_SIZE
+#define CAN_RX_BATCH_SIZE 32
+#endif
+
+#define CAN_CACHE_LINE_SIZE 64
 /* ================================ [ TYPES     ] ============================================== */
 struct CanFrame {
   PduIdType handle;
@@ -43,6 +73,84 @@ struct CanFrame {
   uint8_t dlc;
   uint8_t data[64];
 };
+
+/* single producer single consumer ring of frames: the producer only writes the tail and the
+ * consumer only writes the head, each on its own cache line, so no lock is needed */
+template <uint32_t N> struct CanRing {
+  static_assert(0 == (N & (N - 1)), "the size of the CAN ring must be a power of 2");
+  alignas(CAN_CACHE_LINE_SIZE) std::atomic<uint32_t> head;
+  alignas(CAN_CACHE_LINE_SIZE) std::atomic<uint32_t> tail;
+  alignas(CAN_CACHE_LINE_SIZE) CanFrame frames[N];
+
+  /* only when neither the producer nor the consumer is active */
+  void clear(void) {
+    head.store(tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  bool empty(void) {
+    return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+  }
+
+  /* consumer: no free slot, so the producer does not read the bus until a frame is released */
+  bool full(void) {
+    return (tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed)) >= N;
+  }
+
+  /* producer: the free slot to be filled and committed, nullptr if the ring is full */
+  CanFrame *reserve(void) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    CanFrame *frame = nullptr;
+    if ((t - head.load(std::memory_order_acquire)) < N) {
+      frame = &frames[t & (N - 1)];
+    }
+    return frame;
+  }
+
+  void commit(void) {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /* consumer: the oldest frame to be released after use, nullptr if the ring is empty */
+  CanFrame *front(void) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    CanFrame *frame = nullptr;
+    if (h != tail.load(std::memory_order_acquire)) {
+      frame = &frames[h & (N - 1)];
+    }
+    return frame;
+  }
+
+  /* consumer: the oldest frame of canid moved to the front, the frames before it are shifted back
+   * by one slot so that the others keep their order, nullptr if there is no such frame */
+  CanFrame *find(uint32_t canid) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    uint32_t i = h;
+    CanFrame *frame = nullptr;
+    CanFrame found;
+
+    while ((i != t) && (nullptr == frame)) {
+      if ((frames[i & (N - 1)].canid & (~CAN_ID_EXTENDED)) == (canid & (~CAN_ID_EXTENDED))) {
+        frame = &frames[i & (N - 1)];
+      } else {
+        i++;
+      }
+    }
+    if ((nullptr != frame) && (i != h)) {
+      found = *frame;
+      for (; i != h; i--) {
+        frames[i & (N - 1)] = frames[(i - 1) & (N - 1)];
+      }
+      frame = &frames[h & (N - 1)];
+      *frame = found;
+    }
+    return frame;
+  }
+
+  void release(void) {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+};
 /* ================================ [ DECLARES  ] ============================================== */
 extern "C" Can_ConfigType Can_Config;
 /* ================================ [ DATAS     ] ============================================== */
@@ -53,8 +161,16 @@ static int lBusIdMap[CAN_MAX_HOH];
 #ifdef USE_CAN_FILE_LOG
 static FILE *lBusLog[CAN_MAX_HOH];
 #endif
-static std::queue<CanFrame> lPendingFrames[CAN_MAX_HOH];
+static CanRing<CAN_TX_QUEUE_SIZE> lPendingFrames[CAN_MAX_HOH];
 static bool lStopConfirm[CAN_MAX_HOH];
+/* the frames read from the bus by the RX thread if the environment CAN_RX_THREAD=YES */
+static CanRing<CAN_RX_QUEUE_SIZE> lRxFrames[CAN_MAX_HOH];
+static std::thread lRxThread[CAN_MAX_HOH];
+static std::atomic<bool> lRxThreadRunning[CAN_MAX_HOH];
+static std::atomic<uint64_t> lRxThreadFlag(0);
+static std::atomic<bool> lRxEvent(false);
+static std::mutex lRxEventLock;
+static std::condition_variable lRxEventCond;
 /* ================================ [ LOCALS    ] ============================================== */
 #ifndef _MSC_VER
 FUNC(void, __weak) CanIf_RxIndication(const Can_HwType *Mailbox, const PduInfoType *PduInfoPtr) {
@@ -104,35 +220,171 @@ INITIALIZER(__mcal_can_sim_init) {
 }
 #endif /* USE_CAN_FILE_LOG */
 
-static void clear_queue(uint8_t Controller) {
+static bool push_to_queue(uint8_t Controller, const Can_PduType *PduInfo) {
   auto &queue = lPendingFrames[Controller];
-  while (false == queue.empty()) {
-    queue.pop();
+  CanFrame *frame = queue.reserve();
+  bool ret = false;
+
+  if (nullptr != frame) {
+    frame->handle = PduInfo->swPduHandle;
+    frame->canid = PduInfo->id;
+    frame->dlc = PduInfo->length;
+    memcpy(frame->data, PduInfo->sdu, PduInfo->length);
+    queue.commit();
+    ret = true;
   }
-}
 
-static void push_to_queue(uint8_t Controller, const Can_PduType *PduInfo) {
-  auto &queue = lPendingFrames[Controller];
-  CanFrame frame;
-  frame.handle = PduInfo->swPduHandle;
-  frame.canid = PduInfo->id;
-  frame.dlc = PduInfo->length;
-  memcpy(frame.data, PduInfo->sdu, PduInfo->length);
-  queue.push(frame);
+  return ret;
 }
 
 static bool pop_from_queue(uint8_t Controller, CanFrame &frame) {
   auto &queue = lPendingFrames[Controller];
+  CanFrame *front = queue.front();
   bool ret = false;
 
-  if (false == queue.empty()) {
-    frame = queue.front();
-    queue.pop();
+  if (nullptr != front) {
+    frame = *front;
+    queue.release();
     ret = true;
   }
 
   return ret;
 }
+
+static void notify_rx_event(void) {
+  if (false == lRxEvent.exchange(true)) {
+    std::lock_guard<std::mutex> lck(lRxEventLock);
+    lRxEventCond.notify_one();
+  }
+}
+
+static void rx_daemon(uint8_t Controller) {
+  auto &ring = lRxFrames[Controller];
+  CanFrame *frame;
+  bool r;
+
+  while (lRxThreadRunning[Controller]) {
+    frame = ring.reserve();
+    if (nullptr != frame) {
+      frame->canid = -1;
+      frame->dlc = sizeof(frame->data);
+      r = can_read(lBusIdMap[Controller], &frame->canid, &frame->dlc, frame->data);
+      if (TRUE == r) {
+        ring.commit();
+        notify_rx_event();
+      } else {
+        (void)can_wait(lBusIdMap[Controller], -1, 1);
+      }
+    } else {
+      /* the main function is behind, the frames are kept by the bus until it catches up */
+      notify_rx_event();
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+}
+
+static void start_rx_thread(uint8_t Controller) {
+  const char *env = getenv("CAN_RX_THREAD");
+
+  lRxFrames[Controller].clear();
+  if ((NULL != env) && (0 == strcmp(env, "YES"))) {
+    lRxThreadRunning[Controller] = true;
+    lRxThread[Controller] = std::thread(rx_daemon, Controller);
+    lRxThreadFlag |= ((uint64_t)1 << Controller);
+  }
+}
+
+static void stop_rx_thread(uint8_t Controller) {
+  if (lRxThreadFlag & ((uint64_t)1 << Controller)) {
+    lRxThreadRunning[Controller] = false;
+    if (lRxThread[Controller].joinable()) {
+      lRxThread[Controller].join();
+    }
+    lRxThreadFlag &= ~((uint64_t)1 << Controller);
+  }
+  lRxFrames[Controller].clear();
+}
+
+/* the next received frame of the controller from the RX thread or directly from the bus, to be
+ * released by release_frame after use, nullptr if there is no frame */
+static CanFrame *read_frame(uint8_t Channel, uint32_t byId, CanFrame &local) {
+  CanFrame *frame = nullptr;
+  bool r;
+
+  if (lRxThreadFlag & ((uint64_t)1 << Channel)) {
+    if ((uint32_t)-1 == byId) {
+      frame = lRxFrames[Channel].front();
+    } else {
+      frame = lRxFrames[Channel].find(byId);
+      if ((nullptr == frame) && lRxFrames[Channel].full()) {
+        /* the ring is full of other frames and the RX thread stopped reading the bus, so the
+         * frames of byId still on the bus are all newer than the ones in the ring */
+        local.canid = byId;
+        local.dlc = sizeof(local.data);
+        r = can_read(lBusIdMap[Channel], &local.canid, &local.dlc, local.data);
+        if (TRUE == r) {
+          frame = &local;
+        }
+      }
+    }
+  } else {
+    local.canid = byId;
+    local.dlc = sizeof(local.data);
+    r = can_read(lBusIdMap[Channel], &local.canid, &local.dlc, local.data);
+    if (TRUE == r) {
+      frame = &local;
+    }
+  }
+
+  return frame;
+}
+
+static void release_frame(uint8_t Channel, CanFrame *frame, CanFrame &local) {
+  if (frame != &local) {
+    lRxFrames[Channel].release();
+  }
+}
+
+/* returns TRUE if the frame is indicated to the CanIf, FALSE if it is a simulator command */
+static int indicate_frame(uint8_t Channel, CanFrame *frame) {
+  int r = TRUE;
+  Can_HwType Mailbox;
+  PduInfoType PduInfo;
+
+#if defined(USE_STDIO_CAN) && defined(USE_SHELL)
+  if (STDIO_RX_CANID == frame->canid) {
+    for (r = 0; r < frame->dlc; r++) {
+      Shell_Input((char)frame->data[r]);
+    }
+    r = FALSE;
+  }
+#endif
+#ifdef USE_CANSM
+  if ((TRUE == r) && (CAN_BUSOFF_SIMULAE_CANID == frame->canid)) {
+    ASLOG(INFO, ("[%d] Trigger BusOff\n", Channel));
+    CanIf_ControllerBusOff(Channel);
+    r = FALSE;
+  }
+  if ((TRUE == r) && (CAN_TX_TIMEOUT_SIMULAE_CANID == frame->canid)) {
+    ASLOG(INFO, ("[%d] Trigger TxTimeout\n", Channel));
+    lStopConfirm[Channel] = true;
+    r = FALSE;
+  }
+#endif
+  if (TRUE == r) {
+    Mailbox.CanId = frame->canid;
+    Mailbox.ControllerId = Channel;
+    Mailbox.Hoh = Channel;
+    PduInfo.SduLength = frame->dlc;
+    PduInfo.SduDataPtr = frame->data;
+    PduInfo.MetaDataPtr = (uint8_t *)&Mailbox;
+    logCan(TRUE, Channel, frame->canid, frame->dlc, frame->data);
+    PCAP_TRACE(TRUE, Channel, frame->canid, frame->dlc, frame->data);
+    CanIf_RxIndication(&Mailbox, &PduInfo);
+  }
+
+  return r;
+}
 /* ================================ [ FUNCTIONS ] ============================================== */
 Std_ReturnType CanAc_SetupPinMode(const Can_CtrlPinType *pin) {
   return E_OK;
@@ -150,7 +402,8 @@ Std_ReturnType CanAc_Init(uint8_t Controller, const Can_ChannelConfigType *confi
       ret = E_OK;
       lOpenFlag |= ((uint64_t)1 << Controller);
       lWriteFlag = 0;
-      clear_queue(Controller);
+      lPendingFrames[Controller].clear();
+      start_rx_thread(Controller);
 #ifdef USE_CAN_FILE_LOG
       snprintf(path, sizeof(path), ".CAN%d-%s-%d.log", Controller, config->device, config->port);
       lBusLog[Controller] = fopen(path, "wb");
@@ -167,6 +420,7 @@ Std_ReturnType CanAc_DeInit(uint8_t Controller, const Can_ChannelConfigType *con
   Std_ReturnType ret = E_NOT_OK;
   int rv;
   if (0 != (lOpenFlag & ((uint64_t)1 << Controller))) {
+    stop_rx_thread(Controller);
     rv = can_close(lBusIdMap[Controller]);
     if (TRUE == rv) {
       ret = E_OK;
@@ -177,7 +431,7 @@ Std_ReturnType CanAc_DeInit(uint8_t Controller, const Can_ChannelConfigType *con
         lBusLog[Controller] = NULL;
       }
 #endif
-      clear_queue(Controller);
+      lPendingFrames[Controller].clear();
     }
   } else {
     ret = E_OK;
@@ -202,13 +456,14 @@ Std_ReturnType Can_Write(Can_HwHandleType Hth, const Can_PduType *PduInfo) {
       InterEnterCritical();
       if (TRUE == r) {
         logCan(FALSE, Hth, PduInfo->id, PduInfo->length, PduInfo->sdu);
+        PCAP_TRACE(FALSE, Hth, PduInfo->id, PduInfo->length, PduInfo->sdu);
         lswPduHandle[Hth] = PduInfo->swPduHandle;
       } else {
         lWriteFlag &= ~((uint64_t)1 << Hth);
         ret = E_NOT_OK;
       }
-    } else {
-      push_to_queue(Hth, PduInfo);
+    } else if (false == push_to_queue(Hth, PduInfo)) {
+      ret = CAN_BUSY;
     }
   } else {
     ret = E_NOT_OK;
@@ -242,6 +497,7 @@ void Can_MainFunction_WriteChannel(uint8_t Channel) {
       InterEnterCritical();
       if (TRUE == r) {
         logCan(FALSE, Channel, frame.canid, frame.dlc, frame.data);
+        PCAP_TRACE(FALSE, Channel, frame.canid, frame.dlc, frame.data);
         InterLeaveCritical();
         if (STDIO_TX_CAN_HANDLE == frame.handle) {
         } else {
@@ -265,55 +521,18 @@ void Can_MainFunction_Write(void) {
 
 extern "C" int Can_MainFunction_ReadChannelById(uint8_t Channel, uint32_t byId) {
   int r = FALSE;
-  uint32_t canid;
-  uint8_t dlc;
-  uint8_t data[64];
-  Can_HwType Mailbox;
-  PduInfoType PduInfo;
+  CanFrame local;
+  CanFrame *frame;
 
-  EnterCritical();
   if (Channel < CAN_MAX_HOH) {
     if (lOpenFlag & ((uint64_t)1 << Channel)) {
-      canid = byId;
-      dlc = sizeof(data);
-      InterLeaveCritical();
-      r = can_read(lBusIdMap[Channel], &canid, &dlc, data);
-      InterEnterCritical();
-#if defined(USE_STDIO_CAN) && defined(USE_SHELL)
-      if ((TRUE == r) && (STDIO_RX_CANID == canid)) {
-        for (r = 0; r < dlc; r++) {
-          Shell_Input((char)data[r]);
-        }
-        r = FALSE;
-      }
-#endif
-#ifdef USE_CANSM
-      if ((TRUE == r) && (CAN_BUSOFF_SIMULAE_CANID == canid)) {
-        ASLOG(INFO, ("[%d] Trigger BusOff\n", Channel));
-        CanIf_ControllerBusOff(Channel);
-        r = FALSE;
-      }
-      if ((TRUE == r) && (CAN_TX_TIMEOUT_SIMULAE_CANID == canid)) {
-        ASLOG(INFO, ("[%d] Trigger TxTimeout\n", Channel));
-        lStopConfirm[Channel] = true;
-        r = FALSE;
-      }
-#endif
-      if (TRUE == r) {
-        Mailbox.CanId = canid;
-        Mailbox.ControllerId = Channel;
-        Mailbox.Hoh = Channel;
-        PduInfo.SduLength = dlc;
-        PduInfo.SduDataPtr = data;
-        PduInfo.MetaDataPtr = (uint8_t *)&Mailbox;
-        logCan(TRUE, Channel, canid, dlc, data);
-        InterLeaveCritical();
-        CanIf_RxIndication(&Mailbox, &PduInfo);
-        InterEnterCritical();
+      frame = read_frame(Channel, byId, local);
+      if (nullptr != frame) {
+        r = indicate_frame(Channel, frame);
+        release_frame(Channel, frame, local);
       }
     }
   }
-  ExitCritical();
 
   return r;
 }
@@ -328,7 +547,12 @@ extern "C" boolean Can_WakeupCheck() { /* polling method to check wakeup CAN mes
 
   EnterCritical();
   for (Channel = 0; Channel < CAN_MAX_HOH; Channel++) {
-    if (lOpenFlag & ((uint64_t)1 << Channel)) {
+    if (lRxThreadFlag & ((uint64_t)1 << Channel)) {
+      if (false == lRxFrames[Channel].empty()) {
+        bWakeup = TRUE;
+        break;
+      }
+    } else if (lOpenFlag & ((uint64_t)1 << Channel)) {
       canid = -1;
       dlc = sizeof(data);
       InterLeaveCritical();
@@ -346,7 +570,21 @@ extern "C" boolean Can_WakeupCheck() { /* polling method to check wakeup CAN mes
 }
 
 void Can_MainFunction_ReadChannel(uint8_t Channel) {
-  Can_MainFunction_ReadChannelById(Channel, -1);
+  CanFrame local;
+  CanFrame *frame = &local;
+  uint32_t i;
+
+  if (Channel < CAN_MAX_HOH) {
+    if (lOpenFlag & ((uint64_t)1 << Channel)) {
+      for (i = 0; (i < CAN_RX_BATCH_SIZE) && (nullptr != frame); i++) {
+        frame = read_frame(Channel, -1, local);
+        if (nullptr != frame) {
+          (void)indicate_frame(Channel, frame);
+          release_frame(Channel, frame, local);
+        }
+      }
+    }
+  }
 }
 
 void Can_MainFunction_Read(void) {
@@ -357,10 +595,18 @@ void Can_MainFunction_Read(void) {
 }
 
 extern "C" void Can_Wait(uint8_t Channel, uint32_t canid, uint32_t timeoutMs) {
+  uint32_t i;
 
   EnterCritical();
   if (Channel < CAN_MAX_HOH) {
-    if (lOpenFlag & ((uint64_t)1 << Channel)) {
+    if (lRxThreadFlag & ((uint64_t)1 << Channel)) {
+      /* the bus is drained by the RX thread, wait for its ring */
+      InterLeaveCritical();
+      for (i = 0; (i < (timeoutMs * 10)) && lRxFrames[Channel].empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+      InterEnterCritical();
+    } else if (lOpenFlag & ((uint64_t)1 << Channel)) {
       InterLeaveCritical();
       (void)can_wait(lBusIdMap[Channel], canid, timeoutMs);
       InterEnterCritical();
@@ -368,3 +614,22 @@ extern "C" void Can_Wait(uint8_t Channel, uint32_t canid, uint32_t timeoutMs) {
   }
   ExitCritical();
 }
+
+/* wait for the frames received by the RX threads, returns TRUE if there are frames to be read by
+ * Can_MainFunction_Read, without RX thread this just sleeps timeoutUs */
+extern "C" boolean Can_WaitEvent(uint32_t timeoutUs) {
+  boolean bEvent = FALSE;
+
+  if (0 != lRxThreadFlag) {
+    std::unique_lock<std::mutex> lck(lRxEventLock);
+    lRxEventCond.wait_for(lck, std::chrono::microseconds(timeoutUs),
+                          [] { return lRxEvent.load(); });
+    if (lRxEvent.exchange(false)) {
+      bEvent = TRUE;
+    }
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(timeoutUs));
+  }
+
+  return bEvent;
+}
@@ -9,9 +9,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <chrono>
 #include <mutex>
 #include <thread>
 #include "Semaphore.hpp"
+#ifndef FLS_AC_RAM_ONLY
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#endif
 
 #ifdef USE_TRACE_APP
 #include "TraceApp_Cfg.h"
@@ -32,6 +43,29 @@ using namespace as;
 #ifndef FLS_ERASED_VALUE
 #define FLS_ERASED_VALUE 0xFF
 #endif
+
+#define FLS_AC_IMG "Fls.img"
+
+/* the timing emulation, the erase time is per sector and the write time is per page, both are 0
+ * by default so that the job completes as soon as the engine thread runs, they could be changed
+ * by the environment FLS_AC_ERASE_TIME_US and FLS_AC_WRITE_TIME_US. */
+#ifndef FLS_AC_SECTOR_SIZE
+#define FLS_AC_SECTOR_SIZE 4096
+#endif
+
+#ifndef FLS_AC_PAGE_SIZE
+#define FLS_AC_PAGE_SIZE 8
+#endif
+
+#ifndef FLS_AC_ERASE_TIME_US
+#define FLS_AC_ERASE_TIME_US 0
+#endif
+
+#ifndef FLS_AC_WRITE_TIME_US
+#define FLS_AC_WRITE_TIME_US 0
+#endif
+
+#define FLS_AC_BLANK_CHUNK_SIZE 4096
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 typedef enum {
@@ -46,9 +80,23 @@ typedef enum {
   FLS_AC_JOB_DONE,
   FLS_AC_JOB_FAIL,
 } FlsAc_JobStatusType;
+
+/* when the image file is mapped, the page cache is shared with the other processes just as the
+ * fflush did, the msync only matters for the durability on the disk */
+typedef enum {
+  FLS_AC_SYNC_NONE,  /* let the kernel write back */
+  FLS_AC_SYNC_ASYNC, /* schedule the write back of the changed range after each job */
+  FLS_AC_SYNC_SYNC,  /* wait the changed range on disk after each job */
+} FlsAc_SyncPolicyType;
 /* ================================ [ DATAS     ] ============================================== */
 #ifndef FLS_AC_RAM_ONLY
-static FILE *lFls = NULL;
+#ifdef _WIN32
+static HANDLE lFls = INVALID_HANDLE_VALUE;
+static HANDLE lFlsMapping = NULL;
+#else
+static int lFls = -1;
+#endif
+static FlsAc_SyncPolicyType lSyncPolicy = FLS_AC_SYNC_NONE;
 #endif
 static std::thread lThread;
 static std::mutex lMutex;
@@ -60,12 +108,16 @@ static Fls_AddressType lAddress;
 static Fls_LengthType lLength;
 static int lStoped = FALSE;
 static FlsAc_JobType lJobType = FLS_AC_JOB_NONE;
-uint8_t g_FlsAcMirror[FLS_TOTAL_SIZE];
+static uint32_t lEraseTimeUs = FLS_AC_ERASE_TIME_US;
+static uint32_t lWriteTimeUs = FLS_AC_WRITE_TIME_US;
+static uint8_t lErased[FLS_AC_BLANK_CHUNK_SIZE];
+/* used when the image could not be mapped */
+static uint8_t lFlsRam[FLS_TOTAL_SIZE];
+/* the flash content, the mapped image or lFlsRam */
+uint8_t *g_FlsAcMirror = lFlsRam;
 /* ================================ [ LOCALS    ] ============================================== */
 extern "C" void FlsAc_Stop(void) {
-#ifndef FLS_AC_RAM_ONLY
-  if (NULL != lFls) {
-#endif
+  if (FALSE == lStoped) {
     lStoped = TRUE;
     lJobType = FLS_AC_JOB_NONE;
     lSem.post();
@@ -73,95 +125,216 @@ extern "C" void FlsAc_Stop(void) {
       lThread.join();
     }
 #ifndef FLS_AC_RAM_ONLY
-    fclose(lFls);
+#ifdef _WIN32
+    if (NULL != lFlsMapping) {
+      FlushViewOfFile(g_FlsAcMirror, FLS_TOTAL_SIZE);
+      UnmapViewOfFile(g_FlsAcMirror);
+      CloseHandle(lFlsMapping);
+      lFlsMapping = NULL;
+      g_FlsAcMirror = lFlsRam;
+    }
+    if (INVALID_HANDLE_VALUE != lFls) {
+      CloseHandle(lFls);
+      lFls = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (lFlsRam != g_FlsAcMirror) {
+      munmap(g_FlsAcMirror, FLS_TOTAL_SIZE);
+      g_FlsAcMirror = lFlsRam;
+    }
+    if (lFls >= 0) {
+      close(lFls);
+      lFls = -1;
+    }
+#endif
+#endif
   }
+}
+
+static boolean FlsAc_IsBlank(Fls_AddressType address, Fls_LengthType length) {
+  boolean blank = TRUE;
+  Fls_LengthType len;
+
+  while ((length > 0) && (TRUE == blank)) {
+    len = length;
+    if (len > sizeof(lErased)) {
+      len = sizeof(lErased);
+    }
+    if (0 != memcmp(&g_FlsAcMirror[address], lErased, len)) {
+      blank = FALSE;
+    }
+    address += len;
+    length -= len;
+  }
+
+  return blank;
+}
+
+static void FlsAc_Sync(Fls_AddressType address, Fls_LengthType length) {
+#ifndef FLS_AC_RAM_ONLY
+  uintptr_t start;
+  uintptr_t end;
+  if ((FLS_AC_SYNC_NONE != lSyncPolicy) && (lFlsRam != g_FlsAcMirror) && (length > 0)) {
+#ifdef _WIN32
+    start = (uintptr_t)&g_FlsAcMirror[address];
+    end = start + length;
+    FlushViewOfFile((void *)start, (SIZE_T)(end - start));
+    if (FLS_AC_SYNC_SYNC == lSyncPolicy) {
+      FlushFileBuffers(lFls);
+    }
+#else
+    /* msync wants a page aligned address */
+    start = (uintptr_t)&g_FlsAcMirror[address] & ~((uintptr_t)sysconf(_SC_PAGESIZE) - 1);
+    end = (uintptr_t)&g_FlsAcMirror[address] + length;
+    msync((void *)start, end - start, (FLS_AC_SYNC_SYNC == lSyncPolicy) ? MS_SYNC : MS_ASYNC);
+#endif
+  }
+#else
+  (void)address;
+  (void)length;
 #endif
 }
 
+static uint32_t FlsAc_GetTimeUs(FlsAc_JobType job, Fls_LengthType length) {
+  uint32_t us;
+
+  if (FLS_AC_JOB_ERASE == job) {
+    us = ((length + FLS_AC_SECTOR_SIZE - 1) / FLS_AC_SECTOR_SIZE) * lEraseTimeUs;
+  } else {
+    us = ((length + FLS_AC_PAGE_SIZE - 1) / FLS_AC_PAGE_SIZE) * lWriteTimeUs;
+  }
+
+  return us;
+}
+
 static void _fls_engine(void *arg) {
-  const uint8_t EraseMask = FLS_ERASED_VALUE;
-  uint8_t u8V;
-  boolean conditionOk;
+  FlsAc_JobStatusType status;
+  uint32_t us;
   while (FALSE == lStoped) {
     lSem.wait();
-    std::lock_guard<std::mutex> lck(lMutex);
+    std::unique_lock<std::mutex> lck(lMutex);
+    status = FLS_AC_JOB_ONGOING;
+    us = 0;
     switch (lJobType) {
     case FLS_AC_JOB_ERASE:
       ASLOG(FLSAC, ("erase(0x%X, %d)\n", lAddress, lLength));
-#ifndef FLS_AC_RAM_ONLY
-      fseek(lFls, lAddress, SEEK_SET);
-#endif
-      for (Fls_LengthType i = 0; i < lLength; i++) {
-#ifndef FLS_AC_RAM_ONLY
-        fwrite(&EraseMask, 1, 1, lFls);
-#endif
-        g_FlsAcMirror[lAddress + i] = EraseMask;
-      }
-      fflush(lFls);
-      lJobStatus = FLS_AC_JOB_DONE;
+      memset(&g_FlsAcMirror[lAddress], FLS_ERASED_VALUE, lLength);
+      FlsAc_Sync(lAddress, lLength);
+      us = FlsAc_GetTimeUs(FLS_AC_JOB_ERASE, lLength);
+      status = FLS_AC_JOB_DONE;
       break;
     case FLS_AC_JOB_WRITE:
       ASLOG(FLSAC, ("write(0x%X, %p, %d)\n", lAddress, lData, lLength));
-#ifndef FLS_AC_RAM_ONLY
-      fseek(lFls, lAddress, SEEK_SET);
-#endif
-      conditionOk = TRUE;
-      for (Fls_LengthType i = 0; i < lLength; i++) {
-#ifndef FLS_AC_RAM_ONLY
-        fread(&u8V, 1, 1, lFls);
-#else
-        u8V = g_FlsAcMirror[lAddress + i];
-#endif
-        if (u8V != FLS_ERASED_VALUE) {
-          conditionOk = FALSE;
-          break;
-        }
-      }
-      if (FALSE == conditionOk) {
+      if (FALSE == FlsAc_IsBlank(lAddress, lLength)) {
         ASLOG(ERROR, ("FLS write without erase @ %X\n", lAddress));
-        lJobStatus = FLS_AC_JOB_FAIL;
+        status = FLS_AC_JOB_FAIL;
       } else {
-#ifndef FLS_AC_RAM_ONLY
-        fseek(lFls, lAddress, SEEK_SET);
-        fwrite(lData, lLength, 1, lFls);
-        fflush(lFls);
-#endif
         memcpy(&g_FlsAcMirror[lAddress], lData, lLength);
-        lJobStatus = FLS_AC_JOB_DONE;
+        FlsAc_Sync(lAddress, lLength);
+        us = FlsAc_GetTimeUs(FLS_AC_JOB_WRITE, lLength);
+        status = FLS_AC_JOB_DONE;
       }
       break;
     default:
       break;
     }
+    if (us > 0) {
+      /* the job stays ongoing as the HW is busy */
+      lck.unlock();
+      std::this_thread::sleep_for(std::chrono::microseconds(us));
+      lck.lock();
+    }
+    if (FLS_AC_JOB_ONGOING != status) {
+      lJobStatus = status;
+    }
   }
 }
 
-INITIALIZER(_fls_start) {
 #ifndef FLS_AC_RAM_ONLY
-  size_t sz;
-  uint8_t EraseMask = FLS_ERASED_VALUE;
-  lFls = fopen("Fls.img", "rb+");
-  if (NULL == lFls) {
-    lFls = fopen("Fls.img", "wb+");
+static void FlsAc_MapImage(void) {
+  size_t sz = 0;
+#ifdef _WIN32
+  LARGE_INTEGER fileSize;
+  void *addr = NULL;
+  lFls = CreateFileA(FLS_AC_IMG, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                     NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE != lFls) {
+    if (GetFileSizeEx(lFls, &fileSize)) {
+      sz = (size_t)fileSize.QuadPart;
+    }
+    /* the mapping extends the file if it is smaller */
+    lFlsMapping = CreateFileMappingA(lFls, NULL, PAGE_READWRITE, 0, FLS_TOTAL_SIZE, NULL);
+    if (NULL != lFlsMapping) {
+      addr = MapViewOfFile(lFlsMapping, FILE_MAP_ALL_ACCESS, 0, 0, FLS_TOTAL_SIZE);
+      if (NULL == addr) {
+        CloseHandle(lFlsMapping);
+        lFlsMapping = NULL;
+      }
+    }
   }
-  if (lFls) {
-    fseek(lFls, 0, SEEK_END);
-    sz = ftell(lFls);
+#else
+  struct stat st;
+  void *addr = MAP_FAILED;
+  lFls = open(FLS_AC_IMG, O_RDWR | O_CREAT, 0644);
+  if (lFls >= 0) {
+    if (0 == fstat(lFls, &st)) {
+      sz = (size_t)st.st_size;
+    }
+    if ((sz >= FLS_TOTAL_SIZE) || (0 == ftruncate(lFls, FLS_TOTAL_SIZE))) {
+      addr = mmap(NULL, FLS_TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, lFls, 0);
+    }
+  }
+  if (MAP_FAILED == addr) {
+    addr = NULL;
+  }
+#endif
+  if (NULL != addr) {
+    g_FlsAcMirror = (uint8_t *)addr;
     if (sz < FLS_TOTAL_SIZE) {
-      for (size_t i = sz; i < FLS_TOTAL_SIZE; i++) {
-        fwrite(&EraseMask, 1, 1, lFls);
-      }
+      /* the new part of the image is blank */
+      memset(&g_FlsAcMirror[sz], FLS_ERASED_VALUE, FLS_TOTAL_SIZE - sz);
     }
-    fseek(lFls, 0, SEEK_SET);
-    fread(g_FlsAcMirror, FLS_TOTAL_SIZE, 1, lFls);
-    lThread = std::thread(_fls_engine, nullptr);
   } else {
-    ASLOG(ERROR, ("Failed to create Fls.img\n"));
+    ASLOG(ERROR, ("Failed to map %s, simulate the flash in RAM\n", FLS_AC_IMG));
+    memset(lFlsRam, FLS_ERASED_VALUE, sizeof(lFlsRam));
+  }
+}
+#endif
+
+static void FlsAc_GetEnv(void) {
+  char *env;
+
+  env = getenv("FLS_AC_ERASE_TIME_US");
+  if (NULL != env) {
+    lEraseTimeUs = (uint32_t)strtoul(env, NULL, 10);
+  }
+  env = getenv("FLS_AC_WRITE_TIME_US");
+  if (NULL != env) {
+    lWriteTimeUs = (uint32_t)strtoul(env, NULL, 10);
+  }
+#ifndef FLS_AC_RAM_ONLY
+  env = getenv("FLS_AC_SYNC");
+  if (NULL != env) {
+    if (0 == strcmp(env, "ASYNC")) {
+      lSyncPolicy = FLS_AC_SYNC_ASYNC;
+    } else if (0 == strcmp(env, "SYNC")) {
+      lSyncPolicy = FLS_AC_SYNC_SYNC;
+    } else {
+      lSyncPolicy = FLS_AC_SYNC_NONE;
+    }
   }
+#endif
+}
+
+INITIALIZER(_fls_start) {
+  memset(lErased, FLS_ERASED_VALUE, sizeof(lErased));
+  FlsAc_GetEnv();
+#ifndef FLS_AC_RAM_ONLY
+  FlsAc_MapImage();
 #else
-  memset(g_FlsAcMirror, FLS_ERASED_VALUE, sizeof(g_FlsAcMirror));
-  lThread = std::thread(_fls_engine, nullptr);
+  memset(lFlsRam, FLS_ERASED_VALUE, sizeof(lFlsRam));
 #endif
+  lThread = std::thread(_fls_engine, nullptr);
   atexit(FlsAc_Stop);
 }
 /* ================================ [ FUNCTIONS ] ============================================== */
@@ -254,12 +427,7 @@ Std_ReturnType Fls_AcRead(Fls_AddressType address, uint8_t *data, Fls_LengthType
   if (IS_FLS_ADDRESS(address) && IS_FLS_ADDRESS(address + length)) {
     ASLOG(FLSAC, ("read(0x%X, %p, %d)\n", address, data, length));
     std::lock_guard<std::mutex> lg(lMutex);
-#ifndef FLS_AC_RAM_ONLY
-    fseek(lFls, address, SEEK_SET);
-    fread(data, length, 1, lFls);
-#else
     memcpy(data, &g_FlsAcMirror[address], length);
-#endif
   } else {
     r = E_NOT_OK;
   }
@@ -269,25 +437,12 @@ Std_ReturnType Fls_AcRead(Fls_AddressType address, uint8_t *data, Fls_LengthType
 
 Std_ReturnType Fls_AcCompare(Fls_AddressType address, uint8_t *data, Fls_LengthType length) {
   Std_ReturnType r = E_OK;
-#ifndef FLS_AC_RAM_ONLY
-  uint8_t u8V;
-#endif
+
   if (IS_FLS_ADDRESS(address) && IS_FLS_ADDRESS(address + length)) {
     std::lock_guard<std::mutex> lg(lMutex);
-#ifndef FLS_AC_RAM_ONLY
-    fseek(lFls, address, SEEK_SET);
-    for (Fls_LengthType i = 0; i < length; i++) {
-      fread(&u8V, 1, 1, lFls);
-      if (u8V != data[i]) {
-        r = E_FLS_INCONSISTENT;
-        break;
-      }
-    }
-#else
     if (0 != memcmp(data, &g_FlsAcMirror[address], length)) {
       r = E_FLS_INCONSISTENT;
     }
-#endif
   } else {
     r = E_NOT_OK;
   }
@@ -298,28 +453,11 @@ Std_ReturnType Fls_AcCompare(Fls_AddressType address, uint8_t *data, Fls_LengthT
 Std_ReturnType Fls_AcBlankCheck(Fls_AddressType address, Fls_LengthType length) {
   Std_ReturnType r = E_OK;
 
-  uint8_t u8V;
-
   if (IS_FLS_ADDRESS(address) && IS_FLS_ADDRESS(address + length)) {
     std::lock_guard<std::mutex> lg(lMutex);
-#ifndef FLS_AC_RAM_ONLY
-    fseek(lFls, address, SEEK_SET);
-    for (Fls_LengthType i = 0; i < length; i++) {
-      fread(&u8V, 1, 1, lFls);
-      if (u8V != FLS_ERASED_VALUE) {
-        r = E_FLS_INCONSISTENT;
-        break;
-      }
-    }
-#else
-    for (Fls_LengthType i = 0; i < length; i++) {
-      u8V = g_FlsAcMirror[address + i];
-      if (u8V != FLS_ERASED_VALUE) {
-        r = E_FLS_INCONSISTENT;
-        break;
-      }
+    if (FALSE == FlsAc_IsBlank(address, length)) {
+      r = E_FLS_INCONSISTENT;
     }
-#endif
   } else {
     r = E_NOT_OK;
   }
@@ -14,6 +14,9 @@
 #include "LinIf_Cfg.h"
 #endif
 #include "Lin_Priv.h"
+#ifdef USE_PCAP
+#include "pcap.h"
+#endif
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
@@ -34,12 +37,28 @@
 #define LIN_TYPE_HEADER_AND_DATA ((uint8_t)'F')
 #define LIN_TYPE_EXT_HEADER ((uint8_t)'h')
 #define LIN_TYPE_EXT_HEADER_AND_DATA ((uint8_t)'f')
+
+#ifdef USE_PCAP
+#define PCAP_TRACE Lin_Trace
+#else
+#define PCAP_TRACE(Channel, pid, dlc, data, checksum, isRx)
+#endif
 /* ================================ [ TYPES     ] ============================================== */
 
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 extern Lin_ConfigType Lin_Config;
 /* ================================ [ LOCALS    ] ============================================== */
+#ifdef USE_PCAP
+/* the extended ids of the simulator have no LINKTYPE_LIN format, only the standard frames */
+static void Lin_Trace(uint8_t Channel, Lin_FramePidType pid, uint8_t dlc, const uint8_t *data,
+                      uint8_t checksum, boolean isRx) {
+  if (pid <= 0xFF) {
+    PCap_Lin(Channel, (uint8_t)pid, dlc, data, checksum, isRx);
+  }
+}
+#endif
+
 static Lin_FramePidType Lin_GetPid(const Lin_PduType *PduInfoPtr) {
   Lin_FramePidType id = PduInfoPtr->Pid;
   uint8_t pid;
@@ -257,6 +276,9 @@ Std_ReturnType Lin_SendFrame(uint8_t Channel, const Lin_PduType *PduInfoPtr) {
         ercd = E_NOT_OK;
       } else {
         context->state = state;
+        if (LIN_TYPE_HEADER_AND_DATA == data[0]) {
+          PCAP_TRACE(Channel, data[1], PduInfoPtr->Dl, &data[2], data[2 + PduInfoPtr->Dl], FALSE);
+        }
       }
     }
   } else {
@@ -337,6 +359,7 @@ void Lin_MainFunction_Read(void) {
             ASLOG(LINE, ("failed to slave response %x\n", linPdu.Pid));
           } else {
             context->state = LIN_STATE_DATA_TRANSMITTING;
+            PCAP_TRACE(i, context->frame.pid, linPdu.Dl, &data[1], data[1 + linPdu.Dl], FALSE);
           }
         } else if (LIN_FRAMERESPONSE_RX == linPdu.Drc) {
           context->frame.dlc = linPdu.Dl;
@@ -354,13 +377,15 @@ void Lin_MainFunction_Read(void) {
       context->frame.checksum = data[size - 1];
       ret = Lin_IsFrameGood(&context->frame);
       if (ret == E_OK) {
+        PCAP_TRACE(i, context->frame.pid, context->frame.dlc, context->frame.data,
+                   context->frame.checksum, TRUE);
         if (context->state == LIN_STATE_ONLY_HEADER_TRANSMITTING) {
           /* slave to slave response */
           context->state = LIN_STATE_ONLY_HEADER_TRANSMITTED;
         } else if ((context->state == LIN_STATE_WAITING_RESPONSE) ||
                    (context->state == LIN_STATE_HEADER_TRANSMITTING)) {
           context->state = LIN_STATE_RESPONSE_RECEIVED;
-#ifdef LINIF_SCHED_MODE_INTERRUPT
+#if defined(LINIF_SCHED_MODE_INTERRUPT) || defined(LINIF_SCHED_MODE_DEADLINE)
           LinIf_RxIndication(i, context->frame.data);
 #endif
         } else if (context->state == LIN_STATE_WAITING_DATA) {
@@ -383,6 +408,8 @@ void Lin_MainFunction_Read(void) {
         context->frame.Cs = linPdu.Cs;
         ret = Lin_IsFrameGood(&context->frame);
         if (E_OK == ret) {
+          PCAP_TRACE(i, context->frame.pid, context->frame.dlc, context->frame.data,
+                     context->frame.checksum, TRUE);
           LinIf_RxIndication(i, context->frame.data);
         }
       } else {
@@ -405,6 +432,7 @@ void Lin_MainFunction_Read(void) {
             ASLOG(LINE, ("failed to slave response %x\n", linPdu.Pid));
           } else {
             context->state = LIN_STATE_DATA_TRANSMITTING;
+            PCAP_TRACE(i, context->frame.pid, linPdu.Dl, &data[1], data[1 + linPdu.Dl], FALSE);
           }
         } else if (LIN_FRAMERESPONSE_RX == linPdu.Drc) {
           context->frame.dlc = linPdu.Dl;
@@ -428,6 +456,8 @@ void Lin_MainFunction_Read(void) {
         context->frame.Cs = linPdu.Cs;
         ret = Lin_IsFrameGood(&context->frame);
         if (E_OK == ret) {
+          PCAP_TRACE(i, context->frame.pid, context->frame.dlc, context->frame.data,
+                     context->frame.checksum, TRUE);
           LinIf_RxIndication(i, context->frame.data);
         }
       } else {
@@ -451,7 +481,7 @@ void Lin_MainFunction_Read(void) {
       break;
     case LIN_STATE_FULL_TRANSMITTING:
       context->state = LIN_STATE_FULL_TRANSMITTED;
-#ifdef LINIF_SCHED_MODE_INTERRUPT
+#if defined(LINIF_SCHED_MODE_INTERRUPT) || defined(LINIF_SCHED_MODE_DEADLINE)
       LinIf_TxConfirmation(i);
 #endif
       break;
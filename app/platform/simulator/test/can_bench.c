@@ -0,0 +1,204 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Sustained frames per second per controller received by the simulator CAN driver from the
+ * simulator_v2 bus. One sender process per controller offers BENCH_TX_RATE frames per second and
+ * the receiver runs the 1ms main loop of app/app/main.c with 3 read strategies: 1 frame per
+ * controller per tick as before, a batch of frames per tick, and the RX thread which wakes up the
+ * main loop through Can_WaitEvent. The senders are started as "can_bench sender <port>" so that
+ * they do not share the simulator_v2 bus of the receiver. The delivery and the order of the frames
+ * of each strategy are asserted by can_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Can.h"
+#include "Can_Priv.h"
+#include "CanIf_Can.h"
+#include "canlib.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_CONTROLLERS
+#define BENCH_CONTROLLERS 2
+#endif
+
+/* the simulator_v2 ports used by the benchmark, away from the ones of the running applications */
+#ifndef BENCH_PORT_BASE
+#define BENCH_PORT_BASE 60
+#endif
+
+/* frames per second offered by each sender */
+#ifndef BENCH_TX_RATE
+#define BENCH_TX_RATE 20000
+#endif
+
+#ifndef BENCH_DURATION
+#define BENCH_DURATION 2000000 /* us */
+#endif
+
+#define BENCH_SENDER_DELAY 200000 /* us, for the receiver to be ready */
+/* ================================ [ TYPES     ] ============================================== */
+typedef void (*bench_read_t)(void);
+
+typedef struct {
+  const char *name;
+  bench_read_t read;
+  const char *rxThread;
+} bench_mode_t;
+/* ================================ [ DECLARES  ] ============================================== */
+extern int Can_MainFunction_ReadChannelById(uint8_t Channel, uint32_t byId);
+extern boolean Can_WaitEvent(uint32_t timeoutUs);
+/* ================================ [ DATAS     ] ============================================== */
+static const char *bench_self;
+static uint32_t bench_rx_count[BENCH_CONTROLLERS];
+static Can_ChannelConfigType bench_configs[BENCH_CONTROLLERS];
+/* ================================ [ LOCALS    ] ============================================== */
+static void bench_read_single(void) {
+  uint8_t i;
+
+  for (i = 0; i < BENCH_CONTROLLERS; i++) {
+    (void)Can_MainFunction_ReadChannelById(i, -1);
+  }
+}
+
+static void bench_read_batch(void) {
+  Can_MainFunction_Read();
+}
+
+static const bench_mode_t bench_modes[] = {
+  {"1 frame per tick", bench_read_single, "NO"},
+  {"batched read", bench_read_batch, "NO"},
+  {"rx thread", bench_read_batch, "YES"},
+};
+
+static int bench_sender(uint32_t port) {
+  int busid;
+  uint32_t sent = 0;
+  uint32_t expected;
+  uint8_t data[8] = {0};
+  Std_TimerType timer;
+  std_time_t elapsed;
+
+  busid = can_open("simulator_v2", port, 500000);
+  if (busid >= 0) {
+    usleep(BENCH_SENDER_DELAY);
+    Std_TimerStart(&timer);
+    do {
+      elapsed = Std_GetTimerElapsedTime(&timer);
+      expected = (uint32_t)(((uint64_t)elapsed * BENCH_TX_RATE) / 1000000u);
+      while (sent < expected) {
+        memcpy(data, &sent, sizeof(sent));
+        if (TRUE == can_write(busid, 0x100 + port, sizeof(data), data)) {
+          sent++;
+        } else {
+          break;
+        }
+      }
+      usleep(100);
+    } while (elapsed < BENCH_DURATION);
+    can_close(busid);
+  }
+
+  return (busid >= 0) ? 0 : -1;
+}
+
+static int bench_run(const bench_mode_t *mode) {
+  int ercd = 0;
+  uint8_t i;
+  pid_t senders[BENCH_CONTROLLERS];
+  Std_TimerType timer;
+  Std_TimerType tick;
+  std_time_t elapsed;
+  int status;
+  char port[8];
+
+  for (i = 0; i < BENCH_CONTROLLERS; i++) {
+    snprintf(port, sizeof(port), "%u", BENCH_PORT_BASE + i);
+    senders[i] = fork();
+    if (0 == senders[i]) {
+      execl(bench_self, bench_self, "sender", port, NULL);
+      _exit(-1);
+    }
+  }
+
+  setenv("CAN_RX_THREAD", mode->rxThread, 1);
+  for (i = 0; (i < BENCH_CONTROLLERS) && (0 == ercd); i++) {
+    bench_rx_count[i] = 0;
+    if (E_OK != CanAc_Init(i, &bench_configs[i])) {
+      printf("failed to open CAN%u\n", i);
+      ercd = -1;
+    }
+  }
+
+  if (0 == ercd) {
+    usleep(BENCH_SENDER_DELAY);
+    Std_TimerStart(&timer);
+    Std_TimerStart(&tick);
+    do {
+      if (Std_GetTimerElapsedTime(&tick) >= 1000) {
+        Std_TimerStart(&tick);
+        mode->read();
+      }
+      if (TRUE == Can_WaitEvent(1000)) {
+        mode->read();
+      }
+      elapsed = Std_GetTimerElapsedTime(&timer);
+    } while (elapsed < BENCH_DURATION);
+
+    for (i = 0; i < BENCH_CONTROLLERS; i++) {
+      printf("%-16s: CAN%u %8.0f frames/s of %u offered\n", mode->name, i,
+             (double)bench_rx_count[i] * 1000000.0 / (double)elapsed, BENCH_TX_RATE);
+    }
+  }
+
+  for (i = 0; i < BENCH_CONTROLLERS; i++) {
+    if (senders[i] > 0) {
+      waitpid(senders[i], &status, 0);
+      if ((0 == ercd) && (0 != status)) {
+        printf("sender of CAN%u failed\n", i);
+        ercd = -1;
+      }
+    } else {
+      ercd = -1;
+    }
+    (void)CanAc_DeInit(i, &bench_configs[i]);
+  }
+
+  return ercd;
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+void CanIf_RxIndication(const Can_HwType *Mailbox, const PduInfoType *PduInfoPtr) {
+  if (Mailbox->ControllerId < BENCH_CONTROLLERS) {
+    bench_rx_count[Mailbox->ControllerId]++;
+  }
+}
+
+void CanIf_TxConfirmation(PduIdType CanTxPduId) {
+}
+
+int main(int argc, char *argv[]) {
+  int ercd = 0;
+  uint8_t i;
+  uint32_t m;
+
+  if ((3 == argc) && (0 == strcmp(argv[1], "sender"))) {
+    ercd = bench_sender(atoi(argv[2]));
+  } else {
+    bench_self = argv[0];
+    for (i = 0; i < BENCH_CONTROLLERS; i++) {
+      bench_configs[i].baudrate = 500000;
+      bench_configs[i].hwInstanceId = BENCH_PORT_BASE + i;
+      strcpy(bench_configs[i].device, "simulator_v2");
+    }
+
+    for (m = 0; (m < ARRAY_SIZE(bench_modes)) && (0 == ercd); m++) {
+      ercd = bench_run(&bench_modes[m]);
+    }
+  }
+
+  return (0 == ercd) ? 0 : -1;
+}
@@ -0,0 +1,236 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Test of the simulator CAN driver on the simulator_v2 bus, with and without the RX thread: read by
+ * id, and read in batches by the main loop of app/app/main.c which is woken up by Can_WaitEvent.
+ * The frames are sent by "can_test sender <port> <frames>" so that they do not share the bus of
+ * the receiver.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Can.h"
+#include "Can_Priv.h"
+#include "CanIf_Can.h"
+#include "canlib.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/wait.h>
+/* ================================ [ MACROS    ] ============================================== */
+/* the simulator_v2 port used by the test, away from the ones of the running applications */
+#ifndef TEST_PORT
+#define TEST_PORT 70
+#endif
+
+/* frames of each of the 2 interleaved CAN IDs: the bus keeps up to 128 frames of each CAN ID and
+ * the RX ring holds 128 frames, so with the RX thread the frames overflow the ring */
+#define TEST_FRAMES 100
+#define TEST_FRAMES_RX_THREAD 200
+
+#define TEST_CANID_OTHER 0x101
+#define TEST_CANID_BY_ID 0x102
+
+#define TEST_SENDER_DELAY 200000 /* us, for the receiver to be ready */
+#define TEST_TIMEOUT 5000000     /* us */
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t count;
+  bool inOrder;
+} test_rx_t;
+/* ================================ [ DECLARES  ] ============================================== */
+extern int Can_MainFunction_ReadChannelById(uint8_t Channel, uint32_t byId);
+extern boolean Can_WaitEvent(uint32_t timeoutUs);
+/* ================================ [ DATAS     ] ============================================== */
+static const char *test_self;
+static Can_ChannelConfigType test_config;
+static test_rx_t test_rx_other;
+static test_rx_t test_rx_by_id;
+/* ================================ [ LOCALS    ] ============================================== */
+static int test_sender(uint32_t port, uint32_t frames) {
+  int busid;
+  uint32_t i;
+  uint8_t data[8] = {0};
+  bool r = true;
+
+  busid = can_open("simulator_v2", port, 500000);
+  if (busid >= 0) {
+    usleep(TEST_SENDER_DELAY);
+    for (i = 0; (i < frames) && r; i++) {
+      memcpy(data, &i, sizeof(i));
+      r = can_write(busid, TEST_CANID_OTHER, sizeof(data), data);
+      if (r) {
+        r = can_write(busid, TEST_CANID_BY_ID, sizeof(data), data);
+      }
+      usleep(200);
+    }
+    can_close(busid);
+  }
+
+  return ((busid >= 0) && r) ? 0 : -1;
+}
+
+static void test_receive(test_rx_t *rx, uint32_t byId, uint32_t frames) {
+  Std_TimerType timer;
+
+  Std_TimerStart(&timer);
+  while ((rx->count < frames) && (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT)) {
+    if (FALSE == Can_MainFunction_ReadChannelById(0, byId)) {
+      usleep(100);
+    }
+  }
+}
+
+/* the 1ms main loop, it is woken up earlier by the frames of the RX thread */
+static void test_receive_batch(uint32_t frames, uint32_t *reads, uint32_t *wakeups) {
+  Std_TimerType timer;
+  uint32_t count;
+
+  Std_TimerStart(&timer);
+  while (((test_rx_by_id.count < frames) || (test_rx_other.count < frames)) &&
+         (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT)) {
+    if (TRUE == Can_WaitEvent(1000)) {
+      (*wakeups)++;
+    }
+    count = test_rx_by_id.count + test_rx_other.count;
+    Can_MainFunction_Read();
+    if ((test_rx_by_id.count + test_rx_other.count) > count) {
+      (*reads)++;
+    }
+  }
+}
+
+static void Test_ReadById(const char *rxThread, uint32_t frames) {
+  pid_t sender;
+  int status = -1;
+  char port[8];
+  char count[8];
+  bool bPass;
+
+  printf("Test read by id with CAN_RX_THREAD=%s:", rxThread);
+  memset(&test_rx_other, 0, sizeof(test_rx_other));
+  memset(&test_rx_by_id, 0, sizeof(test_rx_by_id));
+  test_rx_other.inOrder = true;
+  test_rx_by_id.inOrder = true;
+  setenv("CAN_RX_THREAD", rxThread, 1);
+  bPass = (E_OK == CanAc_Init(0, &test_config));
+  if (bPass) {
+    snprintf(port, sizeof(port), "%u", TEST_PORT);
+    snprintf(count, sizeof(count), "%u", frames);
+    sender = fork();
+    if (0 == sender) {
+      execl(test_self, test_self, "sender", port, count, NULL);
+      _exit(-1);
+    }
+    /* only the frames of TEST_CANID_BY_ID, the interleaved ones are kept for the next read */
+    test_receive(&test_rx_by_id, TEST_CANID_BY_ID, frames);
+    bPass = (frames == test_rx_by_id.count) && (0 == test_rx_other.count);
+    test_receive(&test_rx_other, -1, frames);
+    bPass = bPass && (frames == test_rx_other.count);
+    bPass = bPass && test_rx_by_id.inOrder && test_rx_other.inOrder;
+    if (sender > 0) {
+      waitpid(sender, &status, 0);
+    }
+    bPass = bPass && (0 == status);
+    (void)CanAc_DeInit(0, &test_config);
+  }
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u frames of 0x%X, %u frames of 0x%X, sender status %d\n", test_rx_by_id.count,
+           TEST_CANID_BY_ID, test_rx_other.count, TEST_CANID_OTHER, status);
+    exit(-1);
+  }
+}
+
+static void Test_ReadBatch(const char *rxThread, uint32_t frames) {
+  pid_t sender;
+  int status = -1;
+  char port[8];
+  char count[8];
+  uint32_t reads = 0;
+  uint32_t wakeups = 0;
+  bool bPass;
+
+  printf("Test batched read with CAN_RX_THREAD=%s:", rxThread);
+  memset(&test_rx_other, 0, sizeof(test_rx_other));
+  memset(&test_rx_by_id, 0, sizeof(test_rx_by_id));
+  test_rx_other.inOrder = true;
+  test_rx_by_id.inOrder = true;
+  setenv("CAN_RX_THREAD", rxThread, 1);
+  bPass = (E_OK == CanAc_Init(0, &test_config));
+  if (bPass) {
+    snprintf(port, sizeof(port), "%u", TEST_PORT);
+    snprintf(count, sizeof(count), "%u", frames);
+    sender = fork();
+    if (0 == sender) {
+      execl(test_self, test_self, "sender", port, count, NULL);
+      _exit(-1);
+    }
+    test_receive_batch(frames, &reads, &wakeups);
+    bPass = (frames == test_rx_by_id.count) && (frames == test_rx_other.count);
+    bPass = bPass && test_rx_by_id.inOrder && test_rx_other.inOrder;
+    if (0 == strcmp(rxThread, "YES")) {
+      /* the frames wake up the main loop */
+      bPass = bPass && (wakeups > 0u);
+    } else {
+      /* the frames sent within one tick are read by one main function */
+      bPass = bPass && (reads < frames);
+    }
+    if (sender > 0) {
+      waitpid(sender, &status, 0);
+    }
+    bPass = bPass && (0 == status);
+    (void)CanAc_DeInit(0, &test_config);
+  }
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u frames of 0x%X, %u frames of 0x%X, %u reads, %u wakeups, sender status %d\n",
+           test_rx_by_id.count, TEST_CANID_BY_ID, test_rx_other.count, TEST_CANID_OTHER, reads,
+           wakeups, status);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+void CanIf_RxIndication(const Can_HwType *Mailbox, const PduInfoType *PduInfoPtr) {
+  test_rx_t *rx = NULL;
+  uint32_t seq;
+
+  if (TEST_CANID_BY_ID == Mailbox->CanId) {
+    rx = &test_rx_by_id;
+  } else if (TEST_CANID_OTHER == Mailbox->CanId) {
+    rx = &test_rx_other;
+  }
+  if (NULL != rx) {
+    memcpy(&seq, PduInfoPtr->SduDataPtr, sizeof(seq));
+    if (seq != rx->count) {
+      rx->inOrder = false;
+    }
+    rx->count++;
+  }
+}
+
+void CanIf_TxConfirmation(PduIdType CanTxPduId) {
+}
+
+int main(int argc, char *argv[]) {
+  int ercd = 0;
+
+  if ((4 == argc) && (0 == strcmp(argv[1], "sender"))) {
+    ercd = test_sender(atoi(argv[2]), atoi(argv[3]));
+  } else {
+    test_self = argv[0];
+    test_config.baudrate = 500000;
+    test_config.hwInstanceId = TEST_PORT;
+    strcpy(test_config.device, "simulator_v2");
+    Test_ReadById("NO", TEST_FRAMES);
+    Test_ReadById("YES", TEST_FRAMES_RX_THREAD);
+    Test_ReadBatch("NO", TEST_FRAMES);
+    Test_ReadBatch("YES", TEST_FRAMES);
+  }
+
+  return ercd;
+}
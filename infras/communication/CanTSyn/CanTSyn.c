@@ -185,10 +185,13 @@ CanTSyn_CalcGlobalTimestamp(StbM_TimeStampType *timestamp, uint32_t st0r /* seco
   if (E_OK == ret) {
     timestamp->seconds = diff / CANTSYN_NANOSECONDS_PER_SECOND;
     diff = diff - timestamp->seconds * CANTSYN_NANOSECONDS_PER_SECOND;
-    timestamp->seconds += ovs;
 
     seconds = t4r / CANTSYN_NANOSECONDS_PER_SECOND;
     timestamp->nanoseconds = t4r - seconds * CANTSYN_NANOSECONDS_PER_SECOND + diff;
+    if (timestamp->nanoseconds >= CANTSYN_NANOSECONDS_PER_SECOND) {
+      timestamp->nanoseconds -= CANTSYN_NANOSECONDS_PER_SECOND;
+      seconds++;
+    }
 
     timestamp->seconds += ovs + seconds;
     timestamp->secondsHi = 0;
@@ -299,8 +302,8 @@ static void CanTSyn_TransmitSYNC(const CanTSyn_GlobalTimeDomainType *domain) {
   Std_ReturnType ret = E_OK;
   uint8_t data[16];
   PduInfoType PduInfo;
-  uint64_t t0rNs;
   uint32_t st0r;
+  StbM_UserDataType userData;
   CanTSyn_MasterContextType *context = domain->U.M.context;
 
   if (domain->U.M.Master->GlobalTimeTxCrcSecured) {
@@ -313,10 +316,11 @@ static void CanTSyn_TransmitSYNC(const CanTSyn_GlobalTimeDomainType *domain) {
   data[2] = (domain->GlobalTimeDomainId << 4) + context->SC;
   data[3] = 0x00;
 
-  ret = StbM_GetCurrentVirtualLocalTime(domain->SynchronizedTimeBaseRef, &context->t0r);
+  /* the global time T0 and its virtual local time t0r are taken at the same time */
+  ret = StbM_BusGetCurrentTime(domain->SynchronizedTimeBaseRef, &context->T0, &context->t0r,
+                               &userData);
   if (E_OK == ret) {
-    t0rNs = ((uint64_t)context->t0r.nanosecondsHi << 32) + context->t0r.nanosecondsLo;
-    st0r = t0rNs / CANTSYN_NANOSECONDS_PER_SECOND;
+    st0r = context->T0.seconds;
     data[4] = (st0r >> 24) & 0xFF;
     data[5] = (st0r >> 16) & 0xFF;
     data[6] = (st0r >> 8) & 0xFF;
@@ -354,7 +358,6 @@ static void CanTSyn_TransmitFUP(const CanTSyn_GlobalTimeDomainType *domain) {
   Std_ReturnType ret = E_OK;
   uint8_t data[16];
   PduInfoType PduInfo;
-  uint32_t st0r;
   uint64_t t4r;
   uint64_t t0rNs;
   uint64_t t1rNs;
@@ -377,8 +380,8 @@ static void CanTSyn_TransmitFUP(const CanTSyn_GlobalTimeDomainType *domain) {
 
   t0rNs = ((uint64_t)context->t0r.nanosecondsHi << 32) + context->t0r.nanosecondsLo;
   t1rNs = ((uint64_t)context->t1r.nanosecondsHi << 32) + context->t1r.nanosecondsLo;
-  st0r = t0rNs / CANTSYN_NANOSECONDS_PER_SECOND;
-  t4r = t1rNs - (uint64_t)st0r * CANTSYN_NANOSECONDS_PER_SECOND;
+  /* t4r = T1 - s(t0r) with T1 = T0 + (t1r - t0r), the virtual local time is not synchronized */
+  t4r = context->T0.nanoseconds + (t1rNs - t0rNs);
 
   if (t4r >= CANTSYN_NANOSECONDS_MAX_U32) {
     if (t4r <= CANTSYN_NANOSECONDS_MAX_WITH_OVS) {
@@ -595,9 +598,11 @@ void CanTSyn_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   versionInfo->moduleID = MODULE_ID_CANTSYN;
   versionInfo->sw_major_version = 4;
   versionInfo->sw_minor_version = 0;
-  versionInfo->sw_patch_version = 1;
+  versionInfo->sw_patch_version = 2;
 }
 
 /** @brief release notes
  * - 4.0.1: Avoid to use uint64 to calculate time difference in CanTSyn_CalcGlobalTimestamp
+ * - 4.0.2: Fix the OVS counted twice and the nanoseconds not normalized in the
+ *          CanTSyn_CalcGlobalTimestamp, the master takes s(t0r) from the global time of the StbM
  */
@@ -85,6 +85,7 @@ typedef struct {
 typedef uint8_t CanTSync_MasterStateType;
 
 typedef struct {
+  StbM_TimeStampType T0; /* the global time at t0r */
   StbM_VirtualLocalTimeType t0r;
   StbM_VirtualLocalTimeType t1r;
   uint16_t timer;
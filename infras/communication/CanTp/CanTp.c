@@ -30,6 +30,32 @@
 #define CANTP_STMIN_ADJUST 0
 #endif
 
+/* the FC.WT shall be repeated well before the sender's N_Bs timeout */
+#ifndef CANTP_RX_WT_PERIOD
+#define CANTP_RX_WT_PERIOD(config) ((config)->N_Bs / 2u)
+#endif
+
+/* The max number of CFs queued to CanIf in one go when the receiver allows STmin 0. CanIf copies
+ * the frame, so the channel data buffer can be reused right after CanIf_Transmit, a CanIf busy
+ * return stops the burst and the CF is resent by the fast main function. 1 for one CF per TX
+ * confirmation or main function cycle. The TX confirmation must not preempt the CanTp main
+ * functions when this is greater than 1. */
+#ifndef CANTP_CF_BURST_MAX
+#define CANTP_CF_BURST_MAX 1u
+#endif
+
+#ifdef CANTP_USE_TRIGGER_TRANSMIT
+#undef CANTP_CF_BURST_MAX
+#define CANTP_CF_BURST_MAX 1u
+#endif
+
+/* without TX confirmation, a CF is regarded as sent once CanIf accepted it */
+#ifdef CANTP_USE_TX_CONFIRMATION
+#define CANTP_CF_IN_FLIGHT_MAX CANTP_CF_BURST_MAX
+#else
+#define CANTP_CF_IN_FLIGHT_MAX 1u
+#endif
+
 #ifdef CANTP_USE_PB_CONFIG
 #define CANTP_CONFIG cantpConfig
 #else
@@ -70,6 +96,7 @@ extern const CanTp_ConfigType CanTp_Config;
 static void CanTp_SendSF(PduIdType TxPduId);
 #ifndef CANTP_NO_FC
 static void CanTp_SendFC(PduIdType TxPduId, uint8_t FlowStatus);
+static void CanTp_PollRxBuffer(PduIdType RxPduId);
 #endif
 static void CanTp_SendCF(PduIdType TxPduId);
 /* ================================ [ DATAS     ] ============================================== */
@@ -81,6 +108,10 @@ static void CanTp_ResetToIdle(CanTp_ChannelContextType *context) {
   CanTpCancelAlarm();
   context->state = CANTP_IDLE;
   context->TpSduLength = 0;
+  context->numOfTxCF = 0;
+#if CANTP_RX_CACHE_SIZE > 0
+  context->rxCacheLen = 0;
+#endif
 }
 
 #ifndef CANTP_FIX_LL_DL
@@ -99,6 +130,16 @@ static PduLengthType CanTp_GetDL(PduLengthType len, PduLengthType LL_DL) {
 }
 #endif
 
+static PduLengthType CanTp_GetCFLen(const CanTp_ChannelConfigType *config) {
+  PduLengthType cfLen;
+  if (CANTP_EXTENDED == config->AddressingFormat) {
+    cfLen = config->LL_DL - 2u;
+  } else {
+    cfLen = config->LL_DL - 1u;
+  }
+  return cfLen;
+}
+
 static uint8_t CanTp_GetSFMaxLen(const CanTp_ChannelConfigType *config) {
   PduLengthType sfMaxLen;
   if (config->LL_DL > 8u) {
@@ -128,6 +169,8 @@ static BufReq_ReturnType CanTp_RxPreCheckState(CanTp_ChannelContextType *context
     case CANTP_RESEND_FC_OVFLW:
     case CANTP_WAIT_FC_CTS_TX_COMPLETED:
     case CANTP_WAIT_FC_OVFLW_TX_COMPLETED:
+    case CANTP_WAIT_RX_BUFFER:
+    case CANTP_RESEND_FC_WT:
       /* Rx new message when previous Rx is not finished */
       PduR_CanTpRxIndication(config->PduR_RxPduId, E_NOT_OK);
       CanTp_ResetToIdle(context);
@@ -199,7 +242,42 @@ static void CanTp_HandleSF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_
 }
 
 #ifndef CANTP_NO_FC
-static void CanTp_SendFC(PduIdType RxPduId, uint8_t FlowStatus) {
+/* The block size is limited by the buffer the upper layer has available, which can be smaller
+ * than the SDU when the PduR gateway routes on-the-fly. The sender keeps the BS of the first FC
+ * for the whole message, so it is decided once at the FF reception. */
+static uint8_t CanTp_GetRxBlockSize(const CanTp_ChannelConfigType *config,
+                                    const CanTp_ChannelContextType *context) {
+  uint8_t BS = config->BS;
+  PduLengthType blocks;
+
+  if (context->bufferSize < context->TpSduLength) {
+    blocks = context->bufferSize / CanTp_GetCFLen(config);
+    if (0u == blocks) {
+      BS = 1u;
+    } else if ((0u == config->BS) || (blocks < config->BS)) {
+      BS = (blocks > 0xFFu) ? 0xFFu : (uint8_t)blocks;
+    } else {
+      /* config->BS fits in the buffer */
+    }
+  }
+
+  return BS;
+}
+
+/* FC.CTS only when the next block fits in the buffer, otherwise FC.WT */
+static boolean CanTp_HasRxBlockBuffer(const CanTp_ChannelConfigType *config,
+                                      const CanTp_ChannelContextType *context) {
+  PduLengthType required = context->TpSduLength;
+
+  if ((context->cfgBS > 0u) &&
+      (((PduLengthType)context->cfgBS * CanTp_GetCFLen(config)) < required)) {
+    required = (PduLengthType)context->cfgBS * CanTp_GetCFLen(config);
+  }
+
+  return (context->bufferSize >= required) ? TRUE : FALSE;
+}
+
+static void CanTp_TransmitFC(PduIdType RxPduId, uint8_t FlowStatus, uint8_t BS) {
   const CanTp_ChannelConfigType *config;
   CanTp_ChannelContextType *context;
 #ifndef CANTP_USE_TRIGGER_TRANSMIT
@@ -220,7 +298,7 @@ static void CanTp_SendFC(PduIdType RxPduId, uint8_t FlowStatus) {
 
   data[pos] = N_PCI_FC | FlowStatus;
   pos++;
-  data[pos] = config->BS;
+  data[pos] = BS;
   pos++;
   data[pos] = config->STmin;
   pos++;
@@ -232,11 +310,14 @@ static void CanTp_SendFC(PduIdType RxPduId, uint8_t FlowStatus) {
                  data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]));
   context->PduInfo.SduDataPtr = data;
   context->PduInfo.SduLength = 8;
+  context->BS = BS;
 
 #ifdef CANTP_USE_TRIGGER_TRANSMIT
   CanTpSetAlarm(config->N_As);
   if (N_PCI_CTS == FlowStatus) {
     context->state = CANTP_RESEND_FC_CTS;
+  } else if (N_PCI_WT == FlowStatus) {
+    context->state = CANTP_RESEND_FC_WT;
   } else {
     context->state = CANTP_RESEND_FC_OVFLW;
   }
@@ -252,6 +333,9 @@ static void CanTp_SendFC(PduIdType RxPduId, uint8_t FlowStatus) {
       context->state = CANTP_WAIT_CF;
 #endif
       CanTpSetAlarm(config->N_Cr);
+    } else if (N_PCI_WT == FlowStatus) {
+      context->state = CANTP_WAIT_RX_BUFFER;
+      CanTpSetAlarm(CANTP_RX_WT_PERIOD(config));
     } else {
 #ifdef CANTP_USE_TX_CONFIRMATION
       context->state = CANTP_WAIT_FC_OVFLW_TX_COMPLETED;
@@ -259,17 +343,74 @@ static void CanTp_SendFC(PduIdType RxPduId, uint8_t FlowStatus) {
       CanTp_ResetToIdle(context);
 #endif
     }
-    context->BS = config->BS;
   } else {
     CanTpSetAlarm(config->N_As);
     if (N_PCI_CTS == FlowStatus) {
       context->state = CANTP_RESEND_FC_CTS;
+    } else if (N_PCI_WT == FlowStatus) {
+      context->state = CANTP_RESEND_FC_WT;
     } else {
       context->state = CANTP_RESEND_FC_OVFLW;
     }
   }
 #endif
 }
+
+static void CanTp_SendFC(PduIdType RxPduId, uint8_t FlowStatus) {
+  const CanTp_ChannelConfigType *config;
+  CanTp_ChannelContextType *context;
+  uint8_t BS;
+
+  context = &(CANTP_CONFIG->channelContexts[RxPduId]);
+  config = &(CANTP_CONFIG->channelConfigs[RxPduId]);
+
+  BS = context->cfgBS;
+  if (N_PCI_CTS == FlowStatus) {
+    if (TRUE == CanTp_HasRxBlockBuffer(config, context)) {
+      context->WftCounter = 0u;
+    } else {
+      FlowStatus = N_PCI_WT;
+    }
+  }
+
+  if ((N_PCI_WT == FlowStatus) && (context->WftCounter >= config->CanTpRxWftMax)) {
+    ASLOG(CANTPE, ("[%d]no Rx buffer after %d FC.WT, abort\n", RxPduId, context->WftCounter));
+    CanTp_ResetToIdle(context);
+    PduR_CanTpRxIndication(config->PduR_RxPduId, E_NOT_OK);
+  } else {
+    if (N_PCI_WT == FlowStatus) {
+      context->WftCounter++;
+    }
+    CanTp_TransmitFC(RxPduId, FlowStatus, BS);
+  }
+}
+
+static void CanTp_PollRxBuffer(PduIdType RxPduId) {
+  const CanTp_ChannelConfigType *config;
+  CanTp_ChannelContextType *context;
+  PduInfoType PduInfo;
+  BufReq_ReturnType bufReq;
+  PduLengthType bufferSize = 0;
+
+  context = &(CANTP_CONFIG->channelContexts[RxPduId]);
+  config = &(CANTP_CONFIG->channelConfigs[RxPduId]);
+
+  /* query the available buffer with a 0 length copy */
+  PduInfo.SduDataPtr = NULL;
+  PduInfo.SduLength = 0;
+  PduInfo.MetaDataPtr = (uint8_t *)&context->TpSduOffset;
+  bufReq = PduR_CanTpCopyRxData(config->PduR_RxPduId, &PduInfo, &bufferSize);
+  if ((BUFREQ_OK == bufReq) || (BUFREQ_E_BUSY == bufReq)) {
+    context->bufferSize = bufferSize;
+    if (TRUE == CanTp_HasRxBlockBuffer(config, context)) {
+      CanTp_SendFC(RxPduId, N_PCI_CTS);
+    }
+  } else {
+    ASLOG(CANTPE, ("[%d]Rx buffer query failed, abort\n", RxPduId));
+    CanTp_ResetToIdle(context);
+    PduR_CanTpRxIndication(config->PduR_RxPduId, E_NOT_OK);
+  }
+}
 #endif
 
 static void CanTp_HandleFF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_t length) {
@@ -337,12 +478,15 @@ static void CanTp_HandleFF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_
     } else {
       context->TpSduLength = (PduLengthType)TpSduLength - ffLen;
       context->TpSduOffset = ffLen;
+      context->bufferSize = bufferSize;
+      context->WftCounter = 0u;
       context->SN = 1;
 #ifdef CANTP_NO_FC
       context->state = CANTP_WAIT_CF;
       CanTpSetAlarm(config->N_Cr);
       context->BS = 0;
 #else
+      context->cfgBS = CanTp_GetRxBlockSize(config, context);
       CanTp_SendFC(RxPduId, N_PCI_CTS);
 #endif
     }
@@ -352,12 +496,76 @@ static void CanTp_HandleFF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_
   }
 }
 
+#if CANTP_RX_CACHE_SIZE > 0
+/* copy the cached CF payload, which ends at the SDU offset end, to the upper layer */
+static BufReq_ReturnType CanTp_FlushRxCache(const CanTp_ChannelConfigType *config,
+                                            CanTp_ChannelContextType *context,
+                                            PduLengthType end) {
+  BufReq_ReturnType bufReq = BUFREQ_OK;
+  PduInfoType PduInfo;
+  PduLengthType bufferSize;
+  PduLengthType offset;
+
+  if (context->rxCacheLen > 0u) {
+    offset = end - context->rxCacheLen;
+    PduInfo.SduDataPtr = context->rxCache;
+    PduInfo.SduLength = context->rxCacheLen;
+    PduInfo.MetaDataPtr = (uint8_t *)&offset;
+    bufReq = PduR_CanTpCopyRxData(config->PduR_RxPduId, &PduInfo, &bufferSize);
+    if (BUFREQ_OK == bufReq) {
+      context->bufferSize = bufferSize;
+      context->rxCacheLen = 0u;
+    }
+  }
+
+  return bufReq;
+}
+#endif
+
+/* The buffer reported by the upper layer only shrinks by what was copied, so once it can hold
+ * the rest of the message, the CF payload is cached and handed over at the end of the cache, the
+ * block or the message instead of one PduR_CanTpCopyRxData per CF. */
+static BufReq_ReturnType CanTp_CopyRxCF(const CanTp_ChannelConfigType *config,
+                                        CanTp_ChannelContextType *context,
+                                        const PduInfoType *PduInfo) {
+  BufReq_ReturnType bufReq = BUFREQ_OK;
+  PduLengthType bufferSize;
+
+#if CANTP_RX_CACHE_SIZE > 0
+  if ((context->bufferSize < context->TpSduLength) ||
+      ((context->rxCacheLen + PduInfo->SduLength) > CANTP_RX_CACHE_SIZE)) {
+    bufReq = CanTp_FlushRxCache(config, context, context->TpSduOffset);
+  }
+
+  if (BUFREQ_OK != bufReq) {
+    /* abort */
+  } else if ((context->bufferSize >= context->TpSduLength) &&
+             (PduInfo->SduLength <= CANTP_RX_CACHE_SIZE)) {
+    (void)memcpy(&context->rxCache[context->rxCacheLen], PduInfo->SduDataPtr,
+                 PduInfo->SduLength);
+    context->rxCacheLen += PduInfo->SduLength;
+    context->bufferSize -= PduInfo->SduLength;
+    /* the upper layer has all the data before the RX indication or the next FC */
+    if ((PduInfo->SduLength == context->TpSduLength) || (1u == context->BS)) {
+      bufReq = CanTp_FlushRxCache(config, context, context->TpSduOffset + PduInfo->SduLength);
+    }
+  } else
+#endif
+  {
+    bufReq = PduR_CanTpCopyRxData(config->PduR_RxPduId, PduInfo, &bufferSize);
+    if (BUFREQ_OK == bufReq) {
+      context->bufferSize = bufferSize;
+    }
+  }
+
+  return bufReq;
+}
+
 static void CanTp_HandleCF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_t length) {
   const CanTp_ChannelConfigType *config;
   CanTp_ChannelContextType *context;
   PduInfoType PduInfo;
   BufReq_ReturnType bufReq = BUFREQ_OK;
-  PduLengthType bufferSize;
   PduLengthType cfLen;
 
   context = &(CANTP_CONFIG->channelContexts[RxPduId]);
@@ -369,11 +577,7 @@ static void CanTp_HandleCF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_
     context->state = CANTP_WAIT_CF;
   }
 
-  if (CANTP_EXTENDED == config->AddressingFormat) {
-    cfLen = config->LL_DL - 2u;
-  } else {
-    cfLen = config->LL_DL - 1u;
-  }
+  cfLen = CanTp_GetCFLen(config);
 
   if (context->state != CANTP_WAIT_CF) {
     ASLOG(CANTPE, ("[%d]CF received when in state %d.\n", RxPduId, context->state));
@@ -398,8 +602,7 @@ static void CanTp_HandleCF(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_
       PduInfo.MetaDataPtr = (uint8_t *)&context->TpSduOffset;
       PduInfo.SduDataPtr = data;
 
-      bufReq = PduR_CanTpCopyRxData(config->PduR_RxPduId, &PduInfo, &bufferSize);
-
+      bufReq = CanTp_CopyRxCF(config, context, &PduInfo);
       if (BUFREQ_OK == bufReq) {
         context->TpSduLength -= PduInfo.SduLength;
         context->TpSduOffset += PduInfo.SduLength;
@@ -443,8 +646,10 @@ static void CanTp_HandleFC(PduIdType RxPduId, uint8_t pci, uint8_t *data, uint8_
     ASLOG(CANTPE, ("[%d]FC received before FF TxConfirm\n", RxPduId));
     context->state = CANTP_WAIT_FIRST_FC;
   } else if (CANTP_WAIT_CF_TX_COMPLETED == context->state) {
-    if (1u == context->BS) {
+    /* all the CFs of the block are sent, but not all of them are confirmed */
+    if ((context->BS > 0u) && (context->BS == context->numOfTxCF)) {
       ASLOG(CANTPE, ("[%d]FC received before CF TxConfirm\n", RxPduId));
+      context->numOfTxCF = 0u;
       context->BS = context->cfgBS;
       context->state = CANTP_WAIT_FC;
       context->WftCounter = 0u;
@@ -535,9 +740,8 @@ static void CanTp_SendSF(PduIdType TxPduId) {
   if (BUFREQ_OK == bufReq) {
     pos += context->TpSduLength;
     ll_dl = CanTp_GetDL(pos, config->LL_DL);
-    while (pos < ll_dl) {
-      data[pos] = config->padding;
-      pos++;
+    if (pos < ll_dl) {
+      (void)memset(&data[pos], config->padding, ll_dl - pos);
     }
     ASLOG(CANTPI, ("[%d]TX len=%d data=[%02X,%02X,%02X,%02X,%02X,%02X,%02X,%02X]\n", TxPduId, ll_dl,
                    data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]));
@@ -675,10 +879,6 @@ static void CanTp_SendCF(PduIdType TxPduId) {
 
   data[pos] = N_PCI_CF | context->SN;
   pos++;
-  context->SN++;
-  if (context->SN > 15u) {
-    context->SN = 0u;
-  }
 
   bufferSize = config->LL_DL - pos;
 
@@ -692,13 +892,18 @@ static void CanTp_SendCF(PduIdType TxPduId) {
 
   bufReq = PduR_CanTpCopyTxData(config->PduR_TxPduId, &PduInfo, NULL, &bufferSize);
   if (BUFREQ_OK == bufReq) {
+    context->SN++;
+    if (context->SN > 15u) {
+      context->SN = 0u;
+    }
     context->TpSduLength -= PduInfo.SduLength;
     context->TpSduOffset += PduInfo.SduLength;
+    context->numOfTxCF++;
     pos += PduInfo.SduLength;
+    /* only the last CF can be short, a CAN FD one is padded up to the next valid DLC */
     ll_dl = CanTp_GetDL(pos, config->LL_DL);
-    while (pos < ll_dl) {
-      data[pos] = config->padding;
-      pos++;
+    if (pos < ll_dl) {
+      (void)memset(&data[pos], config->padding, ll_dl - pos);
     }
     ASLOG(CANTPI, ("[%d]TX len=%d data=[%02X,%02X,%02X,%02X,%02X,%02X,%02X,%02X]\n", TxPduId, ll_dl,
                    data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]));
@@ -719,6 +924,10 @@ static void CanTp_SendCF(PduIdType TxPduId) {
       CanTpSetAlarm(config->N_As);
     }
 #endif
+  } else if (BUFREQ_E_BUSY == bufReq) {
+    /* the data is routed on-the-fly and not yet received, retry in the next cycle */
+    context->state = CANTP_SEND_CF_DELAY;
+    CanTpSetAlarm(0u);
   } else {
     ASLOG(CANTPE, ("[%d]CF: failed to provide TX data, reset to idle\n", TxPduId));
     CanTp_ResetToIdle(context);
@@ -726,12 +935,42 @@ static void CanTp_SendCF(PduIdType TxPduId) {
   }
 }
 
+/* BS counts down the CFs of the block at their TX completion, so the CFs in flight must not
+ * exceed the CFs left in the block */
+static boolean CanTp_IsCFBurstAllowed(const CanTp_ChannelContextType *context) {
+  boolean allowed = FALSE;
+
+  if ((0u == context->STmin) && (context->TpSduLength > 0u) &&
+      (context->numOfTxCF < CANTP_CF_IN_FLIGHT_MAX) &&
+      ((0u == context->cfgBS) || (context->BS > context->numOfTxCF))) {
+    allowed = TRUE;
+  }
+
+  return allowed;
+}
+
+static void CanTp_SendCFBurst(PduIdType TxPduId) {
+  CanTp_ChannelContextType *context;
+  uint8_t numOfCF = 0u;
+
+  context = &(CANTP_CONFIG->channelContexts[TxPduId]);
+  do {
+    CanTp_SendCF(TxPduId);
+    numOfCF++;
+  } while ((numOfCF < CANTP_CF_BURST_MAX) && (CANTP_WAIT_CF_TX_COMPLETED == context->state) &&
+           (TRUE == CanTp_IsCFBurstAllowed(context)));
+}
+
 static void CanTp_HandleCFTxCompleted(PduIdType TxPduId) {
   const CanTp_ChannelConfigType *config;
   CanTp_ChannelContextType *context;
   context = &(CANTP_CONFIG->channelContexts[TxPduId]);
   config = &(CANTP_CONFIG->channelConfigs[TxPduId]);
 
+  if (context->numOfTxCF > 0u) {
+    context->numOfTxCF--;
+  }
+
   if (context->TpSduLength > 0u) {
     if (context->cfgBS > 0u) {
       if (context->BS > 0u) {
@@ -751,17 +990,35 @@ static void CanTp_HandleCFTxCompleted(PduIdType TxPduId) {
       if (context->STmin > 0u) {
         context->state = CANTP_SEND_CF_DELAY;
         CanTpSetAlarm(CANTP_CONVERT_MS_TO_MAIN_CYCLES(context->STmin + CANTP_STMIN_ADJUST));
+      } else if (TRUE == CanTp_IsCFBurstAllowed(context)) {
+        CanTp_SendCFBurst(TxPduId);
       } else {
-        CanTp_SendCF(TxPduId);
+        /* the rest of the block is in flight */
+        CanTpSetAlarm(config->N_As);
       }
 #endif
     }
-  } else {
+  } else if (0u == context->numOfTxCF) {
     CanTp_ResetToIdle(context);
     PduR_CanTpTxConfirmation(config->PduR_TxPduId, E_OK);
+  } else {
+    CanTpSetAlarm(config->N_As);
   }
 }
 
+#ifdef CANTP_USE_TX_CONFIRMATION
+/* a CF of the burst confirmed while the next CF waits for CanIf or for the upper layer data,
+ * pending is 1 if that CF is already counted in numOfTxCF */
+static void CanTp_HandleCFTxCompletedInBurst(CanTp_ChannelContextType *context, uint8_t pending) {
+  if (context->numOfTxCF > pending) {
+    context->numOfTxCF--;
+    if (context->BS > 1u) {
+      context->BS--;
+    }
+  }
+}
+#endif
+
 #ifdef CANTP_USE_TRIGGER_TRANSMIT
 Std_ReturnType CanTp_ReSend(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
 #else
@@ -801,12 +1058,25 @@ static void CanTp_ReSend(PduIdType TxPduId) {
       context->state = CANTP_WAIT_FC_CTS_TX_COMPLETED;
     } else if (CANTP_RESEND_FC_OVFLW == context->state) {
       context->state = CANTP_WAIT_FC_OVFLW_TX_COMPLETED;
+    } else if (CANTP_RESEND_FC_WT == context->state) {
+      context->state = CANTP_WAIT_RX_BUFFER;
     } else if (CANTP_RESEND_CF == context->state) {
       context->state = CANTP_WAIT_CF_TX_COMPLETED;
     } else {
       ASLOG(CANTPE, ("[%d]resend in wrong state %d, impossible case", TxPduId, context->state));
     }
-    CanTpSetAlarm(config->N_As);
+    if (CANTP_WAIT_RX_BUFFER == context->state) {
+      CanTpSetAlarm(CANTP_RX_WT_PERIOD(config));
+    } else {
+      CanTpSetAlarm(config->N_As);
+    }
+#ifndef CANTP_USE_TRIGGER_TRANSMIT
+    /* CanIf has room again, go on with the burst */
+    if ((CANTP_WAIT_CF_TX_COMPLETED == context->state) &&
+        (TRUE == CanTp_IsCFBurstAllowed(context))) {
+      CanTp_SendCFBurst(TxPduId);
+    }
+#endif
 #else
     if (CANTP_RESEND_SF == context->state) {
       CanTp_ResetToIdle(context);
@@ -824,6 +1094,9 @@ static void CanTp_ReSend(PduIdType TxPduId) {
       CanTpSetAlarm(config->N_Cr);
     } else if (CANTP_RESEND_FC_OVFLW == context->state) {
       CanTp_ResetToIdle(context);
+    } else if (CANTP_RESEND_FC_WT == context->state) {
+      context->state = CANTP_WAIT_RX_BUFFER;
+      CanTpSetAlarm(CANTP_RX_WT_PERIOD(config));
     } else if (CANTP_RESEND_CF == context->state) {
 #ifdef CANTP_USE_TRIGGER_TRANSMIT
       CanTp_HandleCFTxCompleted(TxPduId);
@@ -1006,6 +1279,12 @@ void CanTp_TxConfirmation(PduIdType TxPduId, Std_ReturnType result) {
     case CANTP_WAIT_CF_TX_COMPLETED:
       CanTp_HandleCFTxCompleted(TxPduId);
       break;
+    case CANTP_RESEND_CF:
+      CanTp_HandleCFTxCompletedInBurst(context, 1u);
+      break;
+    case CANTP_SEND_CF_DELAY:
+      CanTp_HandleCFTxCompletedInBurst(context, 0u);
+      break;
     case CANTP_WAIT_FF_TX_COMPLETED:
       context->state = CANTP_WAIT_FIRST_FC;
       context->WftCounter = 0;
@@ -1071,25 +1350,32 @@ void CanTp_MainFunction_Channel(uint8_t Channel) {
   tpExitCritical();
 
   if (TRUE == bTimeout) {
-    if (CANTP_SEND_CF_DELAY != context->state) {
+    if ((CANTP_SEND_CF_DELAY != context->state) && (CANTP_WAIT_RX_BUFFER != context->state)) {
       ASLOG(CANTPE, ("[%d] timer timeout in state %d\n", Channel, context->state));
     }
 
     switch (context->state) {
     case CANTP_WAIT_CF:
+    case CANTP_RESEND_FC_WT:
 #ifdef CANTP_USE_TX_CONFIRMATION
     case CANTP_WAIT_FC_CTS_TX_COMPLETED:
 #endif
       CanTp_ResetToIdle(context);
       PduR_CanTpRxIndication(config->PduR_RxPduId, E_NOT_OK);
       break;
+#ifndef CANTP_NO_FC
+    case CANTP_WAIT_RX_BUFFER:
+      /* still no buffer, FC.WT again or abort if CanTpRxWftMax reached */
+      CanTp_SendFC((PduIdType)Channel, N_PCI_CTS);
+      break;
+#endif
 #ifdef CANTP_USE_TX_CONFIRMATION
     case CANTP_WAIT_FC_OVFLW_TX_COMPLETED:
       CanTp_ResetToIdle(context);
       break;
 #endif
     case CANTP_SEND_CF_DELAY:
-      CanTp_SendCF((PduIdType)Channel);
+      CanTp_SendCFBurst((PduIdType)Channel);
       break;
     default:
       CanTp_ResetToIdle(context);
@@ -1099,13 +1385,23 @@ void CanTp_MainFunction_Channel(uint8_t Channel) {
   }
 
   if (CANTP_SEND_CF_START == context->state) { /* FC allow CF */
-    CanTp_SendCF((PduIdType)Channel);
+    CanTp_SendCFBurst((PduIdType)Channel);
   }
+#ifndef CANTP_NO_FC
+  else if (CANTP_WAIT_RX_BUFFER == context->state) {
+    CanTp_PollRxBuffer((PduIdType)Channel);
+  } else {
+    /* do nothing */
+  }
+#endif
 }
 
 void CanTp_MainFunction_ChannelFast(uint8_t Channel) {
 #ifndef CANTP_USE_TRIGGER_TRANSMIT
   CanTp_ChannelContextType *context;
+#ifndef CANTP_USE_TX_CONFIRMATION
+  uint8_t numOfCF = 0u;
+#endif
 
   DET_VALIDATE(NULL != CANTP_CONFIG, 0x06, CANTP_E_UNINIT, return);
   context = &(CANTP_CONFIG->channelContexts[Channel]);
@@ -1115,12 +1411,17 @@ void CanTp_MainFunction_ChannelFast(uint8_t Channel) {
   case CANTP_RESEND_FF:
   case CANTP_RESEND_FC_CTS:
   case CANTP_RESEND_FC_OVFLW:
+  case CANTP_RESEND_FC_WT:
   case CANTP_RESEND_CF:
     CanTp_ReSend((PduIdType)Channel);
     break;
 #ifndef CANTP_USE_TX_CONFIRMATION
   case CANTP_WAIT_CF_TX_COMPLETED:
-    CanTp_HandleCFTxCompleted(Channel);
+    /* each CF is regarded as sent, queue up to CANTP_CF_BURST_MAX CFs per cycle */
+    do {
+      CanTp_HandleCFTxCompleted(Channel);
+      numOfCF++;
+    } while ((numOfCF < CANTP_CF_BURST_MAX) && (CANTP_WAIT_CF_TX_COMPLETED == context->state));
     break;
 #endif
   default:
@@ -1166,6 +1467,7 @@ PduLengthType CanTp_GetTxPacketLength(PduIdType TxPduId) {
   case CANTP_RESEND_FF:
   case CANTP_RESEND_FC_CTS:
   case CANTP_RESEND_FC_OVFLW:
+  case CANTP_RESEND_FC_WT:
   case CANTP_RESEND_CF:
     ret = context->PduInfo.SduLength;
     break;
@@ -1214,6 +1516,7 @@ Std_ReturnType CanTp_TriggerTransmit(PduIdType TxPduId, const PduInfoType *PduIn
   case CANTP_RESEND_FF:
   case CANTP_RESEND_FC_CTS:
   case CANTP_RESEND_FC_OVFLW:
+  case CANTP_RESEND_FC_WT:
   case CANTP_RESEND_CF:
     ret = CanTp_ReSend(TxPduId, PduInfoPtr);
     break;
@@ -1234,7 +1537,7 @@ void CanTp_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   versionInfo->moduleID = DET_THIS_MODULE_ID;
   versionInfo->sw_major_version = 4;
   versionInfo->sw_minor_version = 0;
-  versionInfo->sw_patch_version = 3;
+  versionInfo->sw_patch_version = 4;
 }
 
 /** @brief release notes
@@ -1242,4 +1545,5 @@ void CanTp_GetVersionInfo(Std_VersionInfoType *versionInfo) {
  *    the private API for improved robustness and safety.
  * - 4.0.2: Don't abort transmission when new request received.
  * - 4.0.3: Add strict RX message DLC validation.
+ * - 4.0.4: Add CF burst transmission for STmin 0 and RX CF payload caching.
  */
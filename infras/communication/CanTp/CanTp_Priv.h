@@ -14,6 +14,12 @@
 #define DET_THIS_MODULE_ID MODULE_ID_CANTP
 #endif
 
+/* CF payload received while the upper layer buffer holds the rest of the message is collected
+ * here and copied with one PduR_CanTpCopyRxData per cache, block or message end, 0 to disable */
+#ifndef CANTP_RX_CACHE_SIZE
+#define CANTP_RX_CACHE_SIZE 0u
+#endif
+
 #define CANTP_PHYSICAL ((CanTp_CommunicationType)0)
 #define CANTP_FUNCTIONAL ((CanTp_CommunicationType)1)
 
@@ -105,6 +111,8 @@ enum {
   CANTP_WAIT_CF_TX_COMPLETED,
   CANTP_WAIT_FC_CTS_TX_COMPLETED,
   CANTP_WAIT_FC_OVFLW_TX_COMPLETED,
+  CANTP_WAIT_RX_BUFFER, /* FC.WT sent, polling the upper layer for buffer */
+  CANTP_RESEND_FC_WT,
 };
 
 typedef struct {
@@ -116,11 +124,17 @@ typedef struct {
 #endif
   PduLengthType TpSduLength;
   PduLengthType TpSduOffset; /* added for SecOC & Com */
+  PduLengthType bufferSize;  /* the available Rx buffer reported by the upper layer */
+#if CANTP_RX_CACHE_SIZE > 0
+  PduLengthType rxCacheLen;
+  uint8_t rxCache[CANTP_RX_CACHE_SIZE];
+#endif
   uint8_t cfgBS;
   uint8_t BS;
   uint8_t SN;
   uint8_t STmin;
   uint8_t WftCounter;
+  uint8_t numOfTxCF; /* CFs handed to CanIf but not yet confirmed */
   uint8_t state;
 } CanTp_ChannelContextType;
 
@@ -0,0 +1,27 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * CanTp config of cantp_test.c: channel 0 sends, channel 1 receives, both looped back by the CanIf
+ * of the test, with the CF burst, the TX confirmation and the RX cache enabled
+ */
+#ifndef CANTP_CFG_H
+#define CANTP_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Std_Types.h"
+/* ================================ [ MACROS    ] ============================================== */
+#define CANTP_MAIN_FUNCTION_PERIOD 1
+#define CANTP_CONVERT_MS_TO_MAIN_CYCLES(x)                                                         \
+  ((x + CANTP_MAIN_FUNCTION_PERIOD - 1) / CANTP_MAIN_FUNCTION_PERIOD)
+
+#define CANTP_USE_TX_CONFIRMATION
+#define CANTP_CF_BURST_MAX 4u
+#define CANTP_RX_CACHE_SIZE 48u
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+uint32_t CanIf_CanTpGetTxCanId(uint8_t Channel);
+uint32_t CanIf_CanTpGetRxCanId(uint8_t Channel);
+#endif /* CANTP_CFG_H */
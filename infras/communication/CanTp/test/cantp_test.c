@@ -0,0 +1,340 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * CanTp channel 0 sends a segmented message to channel 1 over a looped back CanIf which confirms
+ * each frame once it is delivered. With STmin 0 and BS 0, CANTP_CF_BURST_MAX CFs must be queued
+ * to CanIf before the first one is confirmed. The receiver upper layer drains right away but only
+ * offers a window of a given size: while the window is shorter than the rest of the message each
+ * CF is copied on its own, then the CFs are cached and copied per cache, block or message end, in
+ * order, never beyond the offered window and all of them before the RX indication.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "CanTp.h"
+#include "CanTp_Cfg.h"
+#include "CanTp_Priv.h"
+#include "PduR_CanTp.h"
+#include "CanIf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define TEST_CH_TX 0u
+#define TEST_CH_RX 1u
+
+#define TEST_CF_LEN 7u
+#define TEST_MAX_SDU 4095u
+#define TEST_MAX_FRAMES 64u
+#define TEST_MAX_TICKS 1000u
+
+/* frames delivered per cycle */
+#define TEST_BUS_RATE 16u
+
+#ifndef TEST_RANDOM_ROUNDS
+#define TEST_RANDOM_ROUNDS 200u
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  PduIdType CanIfTxPduId;
+  PduLengthType length;
+  uint8_t data[8];
+} test_frame_t;
+
+typedef struct {
+  uint32_t numCF;
+  uint32_t numFC;
+  uint32_t maxInFlight; /* CFs handed to CanIf and not yet confirmed */
+  uint32_t numCopyRx;
+  PduLengthType maxCopyRx;
+  PduLengthType copiedAtInd; /* received bytes at the RX indication */
+  Std_ReturnType txResult;
+  Std_ReturnType rxResult;
+  bool rxError; /* copy out of order or beyond the offered window */
+  bool ok;
+} test_result_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static uint8_t testCanTpData[2][8];
+static const CanTp_ChannelConfigType testCanTpChannelConfigs[] = {
+  {testCanTpData[TEST_CH_TX], CANTP_STANDARD, TEST_CH_TX, TEST_CH_TX, TEST_CH_TX,
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), CANTP_CONVERT_MS_TO_MAIN_CYCLES(100),
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), 0, 0, 0, 8, 8, 0x55, CANTP_PHYSICAL},
+  {testCanTpData[TEST_CH_RX], CANTP_STANDARD, TEST_CH_RX, TEST_CH_RX, TEST_CH_RX,
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), CANTP_CONVERT_MS_TO_MAIN_CYCLES(100),
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), 0, 0, 0, 8, 8, 0x55, CANTP_PHYSICAL},
+};
+static CanTp_ChannelContextType testCanTpChannelContexts[ARRAY_SIZE(testCanTpChannelConfigs)];
+const CanTp_ConfigType CanTp_Config = {
+  testCanTpChannelConfigs,
+  testCanTpChannelContexts,
+  ARRAY_SIZE(testCanTpChannelConfigs),
+};
+
+static test_frame_t testFrames[TEST_MAX_FRAMES];
+static uint32_t testFrameIn;
+static uint32_t testFrameOut;
+static uint32_t testInFlight;
+
+static PduLengthType testSduLength;
+static PduLengthType testTxOffset;
+static PduLengthType testRxWindow;
+static PduLengthType testRxFree;
+static PduLengthType testRxCopied;
+static uint8_t testRxData[TEST_MAX_SDU];
+static bool testTxDone;
+static bool testRxDone;
+
+static test_result_t testResult;
+/* ================================ [ LOCALS    ] ============================================== */
+static uint8_t test_pattern(PduLengthType offset) {
+  return (uint8_t)((offset * 7u) + 3u);
+}
+
+/* the upper layer drains right away, so it offers the window or what is left of the message */
+static PduLengthType test_rx_free(void) {
+  PduLengthType left = testSduLength - testRxCopied;
+
+  return (testRxWindow < left) ? testRxWindow : left;
+}
+
+/* deliver the frames to the peer channel, each one confirmed to its sender once delivered */
+static void test_can_main_function(void) {
+  uint32_t n = 0;
+  test_frame_t *frame;
+  PduInfoType PduInfo;
+
+  while ((testFrameOut != testFrameIn) && (n < TEST_BUS_RATE)) {
+    frame = &testFrames[testFrameOut % TEST_MAX_FRAMES];
+    PduInfo.SduDataPtr = frame->data;
+    PduInfo.SduLength = frame->length;
+    PduInfo.MetaDataPtr = NULL;
+    testFrameOut++;
+    n++;
+    if (TEST_CH_TX == frame->CanIfTxPduId) {
+      CanTp_RxIndication(TEST_CH_RX, &PduInfo);
+      if (0x20u == (frame->data[0] & 0xF0u)) {
+        testInFlight--;
+      }
+      CanTp_TxConfirmation(TEST_CH_TX, E_OK);
+    } else {
+      CanTp_RxIndication(TEST_CH_TX, &PduInfo);
+      CanTp_TxConfirmation(TEST_CH_RX, E_OK);
+    }
+  }
+}
+
+static void test_run(PduLengthType sduLength, PduLengthType window) {
+  PduInfoType PduInfo;
+  PduLengthType i;
+  uint32_t tick;
+
+  memset(&testResult, 0, sizeof(testResult));
+  testResult.txResult = E_NOT_OK;
+  testResult.rxResult = E_NOT_OK;
+  memset(testRxData, 0, sizeof(testRxData));
+  testFrameIn = testFrameOut = 0;
+  testInFlight = 0;
+  testSduLength = sduLength;
+  testTxOffset = 0;
+  testRxWindow = window;
+  testRxFree = 0;
+  testRxCopied = 0;
+  testTxDone = false;
+  testRxDone = false;
+
+  CanTp_Init(NULL);
+  PduInfo.SduDataPtr = NULL;
+  PduInfo.SduLength = sduLength;
+  PduInfo.MetaDataPtr = NULL;
+  if (E_OK == CanTp_Transmit(TEST_CH_TX, &PduInfo)) {
+    for (tick = 0; (tick < TEST_MAX_TICKS) && ((false == testTxDone) || (false == testRxDone));
+         tick++) {
+      CanTp_MainFunction_Fast();
+      test_can_main_function();
+    }
+  }
+
+  testResult.ok = (E_OK == testResult.txResult) && (E_OK == testResult.rxResult) &&
+                  (sduLength == testResult.copiedAtInd) && (false == testResult.rxError);
+  for (i = 0; (i < sduLength) && testResult.ok; i++) {
+    testResult.ok = (test_pattern(i) == testRxData[i]);
+  }
+}
+
+static void test_report(bool bPass, PduLengthType sduLength, PduLengthType window) {
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u bytes with a %u bytes window: data %s%s, CF %u, FC %u, max in flight %u, "
+           "copies %u (max %u bytes), %u bytes at the RX indication\n",
+           (uint32_t)sduLength, (uint32_t)window, testResult.ok ? "ok" : "wrong",
+           testResult.rxError ? " (bad copy)" : "", testResult.numCF, testResult.numFC,
+           testResult.maxInFlight, testResult.numCopyRx, (uint32_t)testResult.maxCopyRx,
+           (uint32_t)testResult.copiedAtInd);
+    exit(-1);
+  }
+}
+
+static void Test_CFBurst(void) {
+  bool bPass;
+
+  printf("Test STmin 0 and BS 0 queue %u CFs before the first TX confirmation:",
+         (uint32_t)CANTP_CF_BURST_MAX);
+  test_run(200, TEST_MAX_SDU);
+  bPass = testResult.ok && (CANTP_CF_BURST_MAX == testResult.maxInFlight) &&
+          (1u == testResult.numFC);
+  test_report(bPass, 200, TEST_MAX_SDU);
+}
+
+static void Test_ShortBuffer(void) {
+  bool bPass;
+
+  printf("Test the CFs are copied one by one then cached across a short upper layer buffer:");
+  test_run(200, 32);
+  /* the window forces blocks, the copies of the cache span more than one CF */
+  bPass = testResult.ok && (testResult.numFC > 1u) && (testResult.maxCopyRx > TEST_CF_LEN) &&
+          (testResult.numCopyRx < (testResult.numCF + 1u));
+  test_report(bPass, 200, 32);
+}
+
+static void Test_FlushOnLastCF(void) {
+  bool bPass;
+
+  printf("Test the cache is flushed by the last CF before the RX indication:");
+  /* 6 bytes in the FF, then 13 CFs and a short one, less than the cache since the last flush */
+  test_run(100, TEST_MAX_SDU);
+  bPass = testResult.ok && (testResult.numCopyRx < (testResult.numCF + 1u));
+  test_report(bPass, 100, TEST_MAX_SDU);
+}
+
+static void Test_Random(void) {
+  uint32_t round;
+  PduLengthType sduLength = 0;
+  PduLengthType window = 0;
+  bool bPass = true;
+
+  printf("Test %u random message sizes and upper layer windows:", TEST_RANDOM_ROUNDS);
+  for (round = 0; (round < TEST_RANDOM_ROUNDS) && bPass; round++) {
+    sduLength = (PduLengthType)(8u + ((uint32_t)rand() % (TEST_MAX_SDU - 7u)));
+    window = (PduLengthType)(TEST_CF_LEN + ((uint32_t)rand() % 256u));
+    test_run(sduLength, window);
+    bPass = testResult.ok;
+  }
+  test_report(bPass, sduLength, window);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+BufReq_ReturnType PduR_CanTpCopyTxData(PduIdType id, const PduInfoType *info,
+                                       const RetryInfoType *retry,
+                                       PduLengthType *availableDataPtr) {
+  PduLengthType i;
+
+  (void)id;
+  (void)retry;
+  for (i = 0; i < info->SduLength; i++) {
+    info->SduDataPtr[i] = test_pattern(testTxOffset + i);
+  }
+  testTxOffset += info->SduLength;
+  *availableDataPtr = testSduLength - testTxOffset;
+
+  return BUFREQ_OK;
+}
+
+void PduR_CanTpTxConfirmation(PduIdType id, Std_ReturnType result) {
+  (void)id;
+  testResult.txResult = result;
+  testTxDone = true;
+}
+
+BufReq_ReturnType PduR_CanTpStartOfReception(PduIdType id, const PduInfoType *info,
+                                             PduLengthType TpSduLength,
+                                             PduLengthType *bufferSizePtr) {
+  (void)id;
+  (void)info;
+  if (TpSduLength != testSduLength) {
+    testResult.rxError = true;
+  }
+  testRxFree = test_rx_free();
+  *bufferSizePtr = testRxFree;
+
+  return BUFREQ_OK;
+}
+
+BufReq_ReturnType PduR_CanTpCopyRxData(PduIdType id, const PduInfoType *info,
+                                       PduLengthType *bufferSizePtr) {
+  BufReq_ReturnType ret = BUFREQ_OK;
+  PduLengthType offset;
+
+  (void)id;
+  if (info->SduLength > 0u) {
+    offset = *(const PduLengthType *)info->MetaDataPtr;
+    if ((offset != testRxCopied) || (info->SduLength > testRxFree)) {
+      testResult.rxError = true;
+      ret = BUFREQ_E_NOT_OK;
+    } else {
+      memcpy(&testRxData[offset], info->SduDataPtr, info->SduLength);
+      testRxCopied += info->SduLength;
+      testResult.numCopyRx++;
+      if (info->SduLength > testResult.maxCopyRx) {
+        testResult.maxCopyRx = info->SduLength;
+      }
+    }
+  }
+  testRxFree = test_rx_free();
+  *bufferSizePtr = testRxFree;
+
+  return ret;
+}
+
+void PduR_CanTpRxIndication(PduIdType id, Std_ReturnType result) {
+  (void)id;
+  testResult.rxResult = result;
+  testResult.copiedAtInd = testRxCopied;
+  testRxDone = true;
+}
+
+Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  test_frame_t *frame;
+
+  if (((testFrameIn - testFrameOut) < TEST_MAX_FRAMES) &&
+      (PduInfoPtr->SduLength <= sizeof(frame->data))) {
+    frame = &testFrames[testFrameIn % TEST_MAX_FRAMES];
+    frame->CanIfTxPduId = TxPduId;
+    frame->length = PduInfoPtr->SduLength;
+    memcpy(frame->data, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+    testFrameIn++;
+    if (0x20u == (frame->data[0] & 0xF0u)) {
+      testResult.numCF++;
+      testInFlight++;
+      if (testInFlight > testResult.maxInFlight) {
+        testResult.maxInFlight = testInFlight;
+      }
+    } else if (0x30u == (frame->data[0] & 0xF0u)) {
+      testResult.numFC++;
+    } else {
+      /* FF */
+    }
+    ret = E_OK;
+  }
+
+  return ret;
+}
+
+uint32_t CanIf_CanTpGetTxCanId(uint8_t Channel) {
+  return 0x731u + Channel;
+}
+
+uint32_t CanIf_CanTpGetRxCanId(uint8_t Channel) {
+  return 0x732u - Channel;
+}
+
+int main(int argc, char *argv[]) {
+  srand(1);
+
+  Test_CFBurst();
+  Test_ShortBuffer();
+  Test_FlushOnLastCF();
+  Test_Random();
+
+  return 0;
+}
@@ -1007,16 +1007,15 @@ static void doipHandleDiagMsgResponse(void) {
   uint8_t *res;
   uint32_t resLen;
 
-  for (i = 0; (NULL == connection) && (i < config->MaxTesterConnections); i++) {
+  for (i = 0; (NULL == targetNode) && (i < config->MaxTesterConnections); i++) {
     connection = &config->testerConnections[i];
     if (DOIP_CON_CLOSED != connection->context->state) {
       TargetAddressRef = connection->context->msg.TargetAddressRef;
       if (NULL != TargetAddressRef) {
-        for (j = 0; (NULL == connection) && (j < TargetAddressRef->numTargetNodes); j++) {
-          targetNode = &TargetAddressRef->targetNodes[j];
-          if (DOIP_MSG_TX == targetNode->context->state) {
+        for (j = 0; (NULL == targetNode) && (j < TargetAddressRef->numTargetNodes); j++) {
+          if (DOIP_MSG_TX == TargetAddressRef->targetNodes[j].context->state) {
+            targetNode = &TargetAddressRef->targetNodes[j];
             TxPduId = targetNode->TxPduId;
-            connection = &config->testerConnections[i];
             resLen = targetNode->context->TpSduLength - targetNode->context->index;
             res = Net_MemGet(&resLen);
             if (NULL != res) {
@@ -1037,6 +1036,11 @@ static void doipHandleDiagMsgResponse(void) {
     offset = targetNode->context->index;
     PduInfo.MetaDataPtr = (uint8_t *)&offset;
     bret = PduR_DoIPCopyTxData(TxPduId, &PduInfo, NULL, &left);
+    if ((BUFREQ_E_BUSY == bret) && (left > 0u) && (left < PduInfo.SduLength)) {
+      /* routed on-the-fly by the PduR gateway, send what is available now */
+      PduInfo.SduLength = left;
+      bret = PduR_DoIPCopyTxData(TxPduId, &PduInfo, NULL, &left);
+    }
     if (BUFREQ_OK == bret) {
       ret = doipTpSendResponse(connection, PduInfo.SduDataPtr, PduInfo.SduLength);
       if (E_OK != ret) {
@@ -1456,6 +1460,16 @@ Std_ReturnType DoIP_TpTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr)
     offset = 0;
     PduInfo.MetaDataPtr = (uint8_t *)&offset;
     bret = PduR_DoIPCopyTxData(targetNode->TxPduId, &PduInfo, NULL, &left);
+    if ((BUFREQ_E_BUSY == bret) && (left < PduInfo.SduLength)) {
+      /* routed on-the-fly by the PduR gateway: send the header and what is available now, the
+       * rest is sent by the main function as it is received */
+      PduInfo.SduLength = left;
+      if (left > 0u) {
+        bret = PduR_DoIPCopyTxData(targetNode->TxPduId, &PduInfo, NULL, &left);
+      } else {
+        bret = BUFREQ_OK;
+      }
+    }
     if (BUFREQ_OK == bret) {
       resLen = DOIP_HEADER_LENGTH + PduInfo.SduLength + 4;
       ret = doipTpSendResponse(connection, res, resLen);
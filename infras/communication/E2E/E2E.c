@@ -31,41 +31,53 @@ static const E2E_ConfigType *e2eConfig = NULL;
 #endif
 /* ================================ [ LOCALS    ] ============================================== */
 #if defined(E2E_USE_PROTECT_P11) || defined(E2E_USE_CHECK_P11)
-/* @PRS_E2E_00634 */
-static uint8_t ComputeP11Crc(const E2E_Profile11ConfigType *config, uint8_t *data,
-                             uint16_t length) {
-  uint8_t tmp;
+/* @PRS_E2E_00513, @PRS_E2E_00163 */
+static void InitP11Seed(const E2E_Profile11ConfigType *config, E2E_P11SeedType *seed) {
+  uint8_t tmp[2];
   uint8_t crc = 0xFFu;
-  uint8_t Counter;
 
-  /* @PRS_E2E_00513, @PRS_E2E_00163 */
+  tmp[0] = config->DataID & 0xFFu;
+  tmp[1] = (config->DataID >> 8) & 0xFFu;
   if (E2E_P11_DATAID_BOTH == config->DataIDMode) {
     /* both two bytes (double ID configuration) are included in the CRC, first low byte and then
      * high byte (see variant 1A - PRS_E2EProtocol_00227) */
-    tmp = config->DataID & 0xFFu;
-    crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
-    tmp = (config->DataID >> 8) & 0xFFu;
-    crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
+    crc = Crc_CalculateCRC8(tmp, 2u, crc, FALSE);
+    seed->Crc[0] = crc;
+    seed->Crc[1] = crc;
   } else if (E2E_P11_DATAID_ALT == config->DataIDMode) {
     /* depending on parity of the counter (alternating ID configuration) the high and the low byte
      * is included (see variant 1B - PRS_E2EProtocol_00228). For even counter values the low byte is
      * included and for odd counter values the high byte is included. */
-    Counter = (data[config->CounterOffset >> 3] >> (config->CounterOffset & 0x07u)) & 0x0Fu;
-    if (0u != (Counter & 0x01u)) { /* even counter */
-      tmp = config->DataID & 0xFFu;
-      crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
-    } else {
-      tmp = (config->DataID >> 8) & 0xFFu;
-      crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
-    }
+    seed->Crc[0] = Crc_CalculateCRC8(&tmp[1], 1u, crc, FALSE);
+    seed->Crc[1] = Crc_CalculateCRC8(&tmp[0], 1u, crc, FALSE);
   } else if (E2E_P11_DATAID_LOW == config->DataIDMode) {
-    tmp = config->DataID & 0xFFu;
-    crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
+    crc = Crc_CalculateCRC8(&tmp[0], 1u, crc, FALSE);
+    seed->Crc[0] = crc;
+    seed->Crc[1] = crc;
   } else { /* NIBBLE */
-    tmp = config->DataID & 0xFFu;
-    crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
-    tmp = 0;
-    crc = Crc_CalculateCRC8(&tmp, 1u, crc, FALSE);
+    tmp[1] = 0;
+    crc = Crc_CalculateCRC8(tmp, 2u, crc, FALSE);
+    seed->Crc[0] = crc;
+    seed->Crc[1] = crc;
+  }
+  seed->bValid = TRUE;
+}
+
+/* @PRS_E2E_00634 */
+static uint8_t ComputeP11Crc(const E2E_Profile11ConfigType *config, E2E_P11SeedType *seed,
+                             uint8_t *data, uint16_t length) {
+  uint8_t crc;
+  uint8_t Counter;
+
+  if (FALSE == seed->bValid) {
+    InitP11Seed(config, seed);
+  }
+
+  if (E2E_P11_DATAID_ALT == config->DataIDMode) {
+    Counter = (data[config->CounterOffset >> 3] >> (config->CounterOffset & 0x07u)) & 0x0Fu;
+    crc = seed->Crc[Counter & 0x01u];
+  } else {
+    crc = seed->Crc[0];
   }
 
   if (config->CRCOffset >= 8u) {
@@ -130,6 +142,32 @@ static uint16_t ComputeP05Crc(const E2E_Profile05ConfigType *config, uint8_t *da
   return crc;
 }
 #endif
+
+#if defined(E2E_USE_PROTECT_P07) || defined(E2E_USE_CHECK_P07)
+/* @PRS_E2E_00489: over the data without the CRC, the header fields included */
+static uint64_t ComputeP07Crc(uint32_t offset, uint8_t *data, uint32_t length) {
+  uint64_t crc = 0u;
+
+  if (offset > 0u) {
+    crc = Crc_CalculateCRC64(data, offset, crc, FALSE);
+  }
+  crc = Crc_CalculateCRC64(&data[offset + 8u], length - offset - 8u, crc, FALSE);
+
+  return crc;
+}
+
+static void WriteU32(uint8_t *data, uint32_t value) {
+  data[0] = (value >> 24) & 0xFFu;
+  data[1] = (value >> 16) & 0xFFu;
+  data[2] = (value >> 8) & 0xFFu;
+  data[3] = value & 0xFFu;
+}
+
+static uint32_t ReadU32(const uint8_t *data) {
+  return ((uint32_t)data[0] << 24) + ((uint32_t)data[1] << 16) + ((uint32_t)data[2] << 8) +
+         data[3];
+}
+#endif
 /* ================================ [ FUNCTIONS ] ============================================== */
 void E2E_Init(const E2E_ConfigType *config) {
   uint16_t i;
@@ -145,11 +183,13 @@ void E2E_Init(const E2E_ConfigType *config) {
 #ifdef E2E_USE_PROTECT_P11
   for (i = 0; i < E2E_CONFIG->numOfProtectP11; i++) { /* @PRS_E2E_00504 */
     E2E_CONFIG->ProtectP11Configs[i].context->Counter = 0u;
+    E2E_CONFIG->ProtectP11Configs[i].context->Seed.bValid = FALSE;
   }
 #endif
 #ifdef E2E_USE_CHECK_P11
   for (i = 0; i < E2E_CONFIG->numOfCheckP11; i++) { /* @PRS_E2E_00504 */
     E2E_CONFIG->CheckP11Configs[i].context->Counter = 0u;
+    E2E_CONFIG->CheckP11Configs[i].context->Seed.bValid = FALSE;
   }
 #endif
 #ifdef E2E_USE_PROTECT_P22
@@ -184,6 +224,17 @@ void E2E_Init(const E2E_ConfigType *config) {
     E2E_CONFIG->CheckP05Configs[i].context->bSynced = FALSE;
   }
 #endif
+#ifdef E2E_USE_PROTECT_P07
+  for (i = 0; i < E2E_CONFIG->numOfProtectP07; i++) {
+    E2E_CONFIG->ProtectP07Configs[i].context->Counter = 0u;
+  }
+#endif
+#ifdef E2E_USE_CHECK_P07
+  for (i = 0; i < E2E_CONFIG->numOfCheckP07; i++) {
+    E2E_CONFIG->CheckP07Configs[i].context->Counter = 0u;
+    E2E_CONFIG->CheckP07Configs[i].context->bSynced = FALSE;
+  }
+#endif
 }
 
 #ifdef E2E_USE_PROTECT_P11
@@ -207,7 +258,8 @@ Std_ReturnType E2E_P11Protect(E2E_ProfileIdType profileId, uint8_t *data, uint16
                                           << (config->P11.CounterOffset & 0x7u);
 
   /* @PRS_E2E_00514 */
-  data[config->P11.CRCOffset >> 3] = ComputeP11Crc(&config->P11, data, length);
+  data[config->P11.CRCOffset >> 3] =
+    ComputeP11Crc(&config->P11, &config->context->Seed, data, length);
 
   ASHEXDUMP(E2E,
             ("[%u]: P11 crc=0x%x DataId=0x%x Mode=%u Counter=%u", profileId,
@@ -259,7 +311,7 @@ Std_ReturnType E2E_P11Check(E2E_ProfileIdType profileId, uint8_t *data, uint16_t
   if (E_OK == ret) {
     /* @PRS_E2E_00519 */
     ReceivedCrc = data[config->P11.CRCOffset >> 3];
-    crc = ComputeP11Crc(&config->P11, data, length);
+    crc = ComputeP11Crc(&config->P11, &config->context->Seed, data, length);
     if (crc != ReceivedCrc) {
       ret = E2E_E_WRONG_CRC;
       ASLOG(E2EE, ("[%u] P11 Wrong Crc %x != %x\n", profileId, crc, ReceivedCrc));
@@ -459,7 +511,7 @@ Std_ReturnType E2E_P44Check(E2E_ProfileIdType profileId, uint8_t *data, uint16_t
   DET_VALIDATE((NULL != data) && (length > 12u), 0x45, E2E_E_PARAM_POINTER, return E_NOT_OK);
   config = &E2E_CONFIG->CheckP44Configs[profileId];
 
-  offset = config->P44.Offset;
+  offset = config->P44.Offset >> 3;
 
   ReceivedLength = ((uint16_t)data[offset + 0u] << 8) + data[offset + 1u];
   if ((ReceivedLength < length) || ((offset + 12u) >= ReceivedLength)) {
@@ -619,3 +671,193 @@ Std_ReturnType E2E_P05Check(E2E_ProfileIdType profileId, uint8_t *data, uint16_t
   return ret;
 }
 #endif
+
+#ifdef E2E_USE_PROTECT_P07
+Std_ReturnType E2E_P07Protect(E2E_ProfileIdType profileId, uint8_t *data, uint32_t length) {
+  Std_ReturnType ret = E_NOT_OK;
+  const E2E_ProtectProfile07ConfigType *config;
+  uint32_t offset;
+  uint64_t crc;
+  uint8_t i;
+  DET_VALIDATE(NULL != E2E_CONFIG, 0x07, E2E_E_UNINIT, return E_NOT_OK);
+  DET_VALIDATE(profileId < E2E_CONFIG->numOfProtectP07, 0x07, E2E_E_PARAM_ID, return E_NOT_OK);
+  DET_VALIDATE((NULL != data) && (length >= 20u), 0x07, E2E_E_PARAM_POINTER, return E_NOT_OK);
+  config = &E2E_CONFIG->ProtectP07Configs[profileId];
+
+  offset = config->P07.Offset >> 3;
+  if ((offset + 20u) <= length) {
+    /* @PRS_E2E_00487, @PRS_E2E_00488 */
+    WriteU32(&data[offset + 8u], length);
+    WriteU32(&data[offset + 12u], config->context->Counter);
+    WriteU32(&data[offset + 16u], config->P07.DataID);
+
+    crc = ComputeP07Crc(offset, data, length);
+    for (i = 0u; i < 8u; i++) {
+      data[offset + i] = (uint8_t)(crc >> (56u - (8u * i)));
+    }
+    ASLOG(E2E, ("[%u]: P07 crc=0x%x%08x Counter=%u\n", profileId, (uint32_t)(crc >> 32),
+                (uint32_t)crc, config->context->Counter));
+
+    config->context->Counter++;
+    ret = E_OK;
+  }
+
+  return ret;
+}
+#endif
+
+#ifdef E2E_USE_CHECK_P07
+Std_ReturnType E2E_P07Check(E2E_ProfileIdType profileId, uint8_t *data, uint32_t length) {
+  Std_ReturnType ret = E_OK;
+  uint32_t ReceivedCounter = 0;
+  uint64_t ReceivedCrc = 0;
+  uint32_t ReceivedDataID;
+  uint32_t ReceivedLength;
+  uint32_t offset;
+  uint64_t crc;
+  const E2E_CheckProfile07ConfigType *config;
+  uint32_t deltaCounter = 0;
+  uint8_t i;
+  DET_VALIDATE(NULL != E2E_CONFIG, 0x17, E2E_E_UNINIT, return E_NOT_OK);
+  DET_VALIDATE(profileId < E2E_CONFIG->numOfCheckP07, 0x17, E2E_E_PARAM_ID, return E_NOT_OK);
+  DET_VALIDATE((NULL != data) && (length >= 20u), 0x17, E2E_E_PARAM_POINTER, return E_NOT_OK);
+  config = &E2E_CONFIG->CheckP07Configs[profileId];
+
+  offset = config->P07.Offset >> 3;
+  if ((offset + 20u) > length) {
+    ASLOG(E2EE, ("[%u] P07 length %u too short\n", profileId, length));
+    ret = E_NOT_OK;
+  }
+
+  if (E_OK == ret) {
+    ReceivedLength = ReadU32(&data[offset + 8u]);
+    ReceivedDataID = ReadU32(&data[offset + 16u]);
+    if (ReceivedLength != length) {
+      ASLOG(E2EE, ("[%u] P07 length %u != %u\n", profileId, ReceivedLength, length));
+      ret = E_NOT_OK;
+    } else if (ReceivedDataID != config->P07.DataID) {
+      ret = E_NOT_OK;
+      ASLOG(E2EE,
+            ("[%u] P07 Wrong DataID %x != %x\n", profileId, ReceivedDataID, config->P07.DataID));
+    } else {
+      for (i = 0u; i < 8u; i++) {
+        ReceivedCrc = (ReceivedCrc << 8) + data[offset + i];
+      }
+      crc = ComputeP07Crc(offset, data, length);
+      if (crc != ReceivedCrc) {
+        ret = E2E_E_WRONG_CRC;
+        ASLOG(E2EE, ("[%u] P07 Wrong Crc\n", profileId));
+      }
+    }
+  }
+
+  if (E_OK == ret) {
+    ReceivedCounter = ReadU32(&data[offset + 12u]);
+    if (FALSE == config->context->bSynced) {
+      deltaCounter = 1u;
+    } else {
+      deltaCounter = ReceivedCounter - config->context->Counter; /* wraps at 2^32 */
+    }
+
+    if (deltaCounter <= config->MaxDeltaCounter) {
+      if (deltaCounter > 0u) {
+        if (1u == deltaCounter) {
+          ret = E_OK;
+        } else {
+          ret = E2E_E_OK_SOME_LOST;
+          ASLOG(E2EE, ("[%u] P07 delta %u but OK\n", profileId, deltaCounter));
+        }
+      } else {
+        ret = E2E_E_REPEATED;
+        ASLOG(E2EE, ("[%u] P07 repeat\n", profileId));
+      }
+    } else {
+      ret = E2E_E_WRONG_SEQUENCE;
+      ASLOG(E2EE, ("[%u] P07 wrong sequence %u: %x %x\n", profileId, deltaCounter, ReceivedCounter,
+                   config->context->Counter));
+    }
+    config->context->Counter = ReceivedCounter;
+    config->context->bSynced = TRUE;
+  }
+
+  return ret;
+}
+#endif
+
+uint16_t E2E_ExecuteBatch(E2E_BatchItemType *items, uint16_t numOfItems) {
+  uint16_t i;
+  uint16_t numOfOK = 0u;
+  E2E_BatchItemType *item;
+  E2E_OperationType operation;
+  DET_VALIDATE(NULL != E2E_CONFIG, 0x30, E2E_E_UNINIT, return 0);
+  DET_VALIDATE((NULL != items) || (0u == numOfItems), 0x30, E2E_E_PARAM_POINTER, return 0);
+
+  for (i = 0u; i < numOfItems; i++) {
+    item = &items[i];
+    item->result = E_NOT_OK;
+    operation = item->operation;
+    if ((item->length > 0xFFFFu) && (operation < E2E_PROTECT_P07)) {
+      operation = E2E_OPERATION_MAX; /* too big for the classic profiles */
+    }
+    switch (operation) {
+#ifdef E2E_USE_PROTECT_P11
+    case E2E_PROTECT_P11:
+      item->result = E2E_P11Protect(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_CHECK_P11
+    case E2E_CHECK_P11:
+      item->result = E2E_P11Check(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_PROTECT_P22
+    case E2E_PROTECT_P22:
+      item->result = E2E_P22Protect(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_CHECK_P22
+    case E2E_CHECK_P22:
+      item->result = E2E_P22Check(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_PROTECT_P44
+    case E2E_PROTECT_P44:
+      item->result = E2E_P44Protect(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_CHECK_P44
+    case E2E_CHECK_P44:
+      item->result = E2E_P44Check(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_PROTECT_P05
+    case E2E_PROTECT_P05:
+      item->result = E2E_P05Protect(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_CHECK_P05
+    case E2E_CHECK_P05:
+      item->result = E2E_P05Check(item->profileId, item->data, (uint16_t)item->length);
+      break;
+#endif
+#ifdef E2E_USE_PROTECT_P07
+    case E2E_PROTECT_P07:
+      item->result = E2E_P07Protect(item->profileId, item->data, item->length);
+      break;
+#endif
+#ifdef E2E_USE_CHECK_P07
+    case E2E_CHECK_P07:
+      item->result = E2E_P07Check(item->profileId, item->data, item->length);
+      break;
+#endif
+    default:
+      break;
+    }
+
+    if ((E2E_E_OK == item->result) || (E2E_E_OK_SOME_LOST == item->result)) {
+      numOfOK++;
+    }
+  }
+
+  return numOfOK;
+}
@@ -30,8 +30,16 @@ extern "C" {
 /* @PRS_E2E_00583  */
 typedef uint8_t E2E_P11DataIDModeType;
 
+/* the CRC over the implicit DataID bytes, computed on first use, the index is the counter parity
+ * for the alternating ID configuration */
+typedef struct {
+  uint8_t Crc[2];
+  boolean bValid;
+} E2E_P11SeedType;
+
 typedef struct {
   uint8_t Counter;
+  E2E_P11SeedType Seed;
 } E2E_ProtectProfile11ContextType;
 
 /* @PRS_E2E_00503 */
@@ -53,6 +61,7 @@ typedef struct {
 
 typedef struct {
   uint8_t Counter;
+  E2E_P11SeedType Seed;
 } E2E_CheckProfile11ContextType;
 
 typedef struct {
@@ -138,6 +147,32 @@ typedef struct {
   uint8_t MaxDeltaCounter;
 } E2E_CheckProfile05ConfigType;
 
+/* @PRS_E2E_00484 */
+typedef struct {
+  uint32_t DataID;
+  uint32_t Offset; /* bit position of the 20 bytes header: CRC64, Length, Counter, DataID */
+} E2E_Profile07ConfigType;
+
+typedef struct {
+  uint32_t Counter;
+} E2E_ProtectProfile07ContextType;
+
+typedef struct {
+  E2E_ProtectProfile07ContextType *context;
+  E2E_Profile07ConfigType P07;
+} E2E_ProtectProfile07ConfigType;
+
+typedef struct {
+  uint32_t Counter;
+  boolean bSynced;
+} E2E_CheckProfile07ContextType;
+
+typedef struct {
+  E2E_CheckProfile07ContextType *context;
+  E2E_Profile07ConfigType P07;
+  uint32_t MaxDeltaCounter;
+} E2E_CheckProfile07ConfigType;
+
 struct E2E_Config_s {
 #ifdef E2E_USE_PROTECT_P11
   const E2E_ProtectProfile11ConfigType *ProtectP11Configs;
@@ -163,6 +198,12 @@ struct E2E_Config_s {
 #ifdef E2E_USE_CHECK_P05
   const E2E_CheckProfile05ConfigType *CheckP05Configs;
 #endif
+#ifdef E2E_USE_PROTECT_P07
+  const E2E_ProtectProfile07ConfigType *ProtectP07Configs;
+#endif
+#ifdef E2E_USE_CHECK_P07
+  const E2E_CheckProfile07ConfigType *CheckP07Configs;
+#endif
 #ifdef E2E_USE_PROTECT_P11
   uint16_t numOfProtectP11;
 #endif
@@ -187,6 +228,12 @@ struct E2E_Config_s {
 #ifdef E2E_USE_CHECK_P05
   uint16_t numOfCheckP05;
 #endif
+#ifdef E2E_USE_PROTECT_P07
+  uint16_t numOfProtectP07;
+#endif
+#ifdef E2E_USE_CHECK_P07
+  uint16_t numOfCheckP07;
+#endif
 };
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
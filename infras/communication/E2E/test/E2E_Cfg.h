@@ -0,0 +1,28 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ */
+#ifndef E2E_CFG_H
+#define E2E_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#define E2E_USE_PROTECT_P11
+#define E2E_USE_CHECK_P11
+
+#define E2E_USE_PROTECT_P22
+#define E2E_USE_CHECK_P22
+
+#define E2E_USE_PROTECT_P44
+#define E2E_USE_CHECK_P44
+
+#define E2E_USE_PROTECT_P05
+#define E2E_USE_CHECK_P05
+
+#define E2E_USE_PROTECT_P07
+#define E2E_USE_CHECK_P07
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* E2E_CFG_H */
@@ -0,0 +1,266 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Protect and then check a ring of frames per profile, once with the single call API and once
+ * with E2E_ExecuteBatch, verify every check is okay and report the checks per second. The
+ * functional checks of the batch are done by e2e_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "E2E.h"
+#include "E2E_Cfg.h"
+#include "E2E_Priv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_BYTES_PER_CASE
+#define BENCH_BYTES_PER_CASE (256u * 1024u * 1024u)
+#endif
+
+/* frames protected and then checked by one batch */
+#define BENCH_RING_SIZE 64u
+
+#define BENCH_P11 0
+#define BENCH_P22 1
+#define BENCH_P44 2
+#define BENCH_P05 3
+#define BENCH_P07 4
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  const char *name;
+  int profile;
+  uint32_t length;
+} Bench_CaseType;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static E2E_ProtectProfile11ContextType Bench_ProtectP11_Context;
+static const E2E_ProtectProfile11ConfigType Bench_ProtectP11Configs[] = {
+  {&Bench_ProtectP11_Context, {0x123u, 0u, 8u, 12u, E2E_P11_DATAID_BOTH}},
+};
+static E2E_CheckProfile11ContextType Bench_CheckP11_Context;
+static const E2E_CheckProfile11ConfigType Bench_CheckP11Configs[] = {
+  {&Bench_CheckP11_Context, {0x123u, 0u, 8u, 12u, E2E_P11_DATAID_BOTH}, 1u},
+};
+
+static E2E_ProtectProfile22ContextType Bench_ProtectP22_Context;
+static const E2E_ProtectProfile22ConfigType Bench_ProtectP22Configs[] = {
+  {&Bench_ProtectP22_Context, {0u, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}}},
+};
+static E2E_CheckProfile22ContextType Bench_CheckP22_Context;
+static const E2E_CheckProfile22ConfigType Bench_CheckP22Configs[] = {
+  {&Bench_CheckP22_Context, {0u, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}}, 1u},
+};
+
+static E2E_ProtectProfile44ContextType Bench_ProtectP44_Context;
+static const E2E_ProtectProfile44ConfigType Bench_ProtectP44Configs[] = {
+  {&Bench_ProtectP44_Context, {0x0a0b0c0du, 0u}},
+};
+static E2E_CheckProfile44ContextType Bench_CheckP44_Context;
+static const E2E_CheckProfile44ConfigType Bench_CheckP44Configs[] = {
+  {&Bench_CheckP44_Context, {0x0a0b0c0du, 0u}, 1u},
+};
+
+static E2E_ProtectProfile05ContextType Bench_ProtectP05_Context;
+static const E2E_ProtectProfile05ConfigType Bench_ProtectP05Configs[] = {
+  {&Bench_ProtectP05_Context, {0x1234u, 0u}},
+};
+static E2E_CheckProfile05ContextType Bench_CheckP05_Context;
+static const E2E_CheckProfile05ConfigType Bench_CheckP05Configs[] = {
+  {&Bench_CheckP05_Context, {0x1234u, 0u}, 1u},
+};
+
+static E2E_ProtectProfile07ContextType Bench_ProtectP07_Context;
+static const E2E_ProtectProfile07ConfigType Bench_ProtectP07Configs[] = {
+  {&Bench_ProtectP07_Context, {0x0a0b0c0du, 64u}},
+};
+static E2E_CheckProfile07ContextType Bench_CheckP07_Context;
+static const E2E_CheckProfile07ConfigType Bench_CheckP07Configs[] = {
+  {&Bench_CheckP07_Context, {0x0a0b0c0du, 64u}, 1u},
+};
+
+const E2E_ConfigType E2E_Config = {
+  Bench_ProtectP11Configs,
+  Bench_CheckP11Configs,
+  Bench_ProtectP22Configs,
+  Bench_CheckP22Configs,
+  Bench_ProtectP44Configs,
+  Bench_CheckP44Configs,
+  Bench_ProtectP05Configs,
+  Bench_CheckP05Configs,
+  Bench_ProtectP07Configs,
+  Bench_CheckP07Configs,
+  ARRAY_SIZE(Bench_ProtectP11Configs),
+  ARRAY_SIZE(Bench_CheckP11Configs),
+  ARRAY_SIZE(Bench_ProtectP22Configs),
+  ARRAY_SIZE(Bench_CheckP22Configs),
+  ARRAY_SIZE(Bench_ProtectP44Configs),
+  ARRAY_SIZE(Bench_CheckP44Configs),
+  ARRAY_SIZE(Bench_ProtectP05Configs),
+  ARRAY_SIZE(Bench_CheckP05Configs),
+  ARRAY_SIZE(Bench_ProtectP07Configs),
+  ARRAY_SIZE(Bench_CheckP07Configs),
+};
+
+static const Bench_CaseType Bench_Cases[] = {
+  {"P11", BENCH_P11, 8u},       {"P22", BENCH_P22, 8u},       {"P44", BENCH_P44, 64u},
+  {"P44", BENCH_P44, 4096u},    {"P05", BENCH_P05, 64u},      {"P05", BENCH_P05, 4096u},
+  {"P07", BENCH_P07, 4096u},    {"P07", BENCH_P07, 65536u},   {"P07", BENCH_P07, 1048576u},
+};
+
+static const E2E_OperationType Bench_Protects[] = {
+  E2E_PROTECT_P11, E2E_PROTECT_P22, E2E_PROTECT_P44, E2E_PROTECT_P05, E2E_PROTECT_P07,
+};
+
+static const E2E_OperationType Bench_Checks[] = {
+  E2E_CHECK_P11, E2E_CHECK_P22, E2E_CHECK_P44, E2E_CHECK_P05, E2E_CHECK_P07,
+};
+
+static E2E_BatchItemType Bench_Items[2u * BENCH_RING_SIZE];
+/* ================================ [ LOCALS    ] ============================================== */
+static double Bench_Now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static Std_ReturnType Bench_Protect(int profile, uint8_t *data, uint32_t length) {
+  Std_ReturnType ret = E_NOT_OK;
+
+  switch (profile) {
+  case BENCH_P11:
+    ret = E2E_P11Protect(0u, data, (uint16_t)length);
+    break;
+  case BENCH_P22:
+    ret = E2E_P22Protect(0u, data, (uint16_t)length);
+    break;
+  case BENCH_P44:
+    ret = E2E_P44Protect(0u, data, (uint16_t)length);
+    break;
+  case BENCH_P05:
+    ret = E2E_P05Protect(0u, data, (uint16_t)length);
+    break;
+  default:
+    ret = E2E_P07Protect(0u, data, length);
+    break;
+  }
+
+  return ret;
+}
+
+static Std_ReturnType Bench_Check(int profile, uint8_t *data, uint32_t length) {
+  Std_ReturnType ret = E_NOT_OK;
+
+  switch (profile) {
+  case BENCH_P11:
+    ret = E2E_P11Check(0u, data, (uint16_t)length);
+    break;
+  case BENCH_P22:
+    ret = E2E_P22Check(0u, data, (uint16_t)length);
+    break;
+  case BENCH_P44:
+    ret = E2E_P44Check(0u, data, (uint16_t)length);
+    break;
+  case BENCH_P05:
+    ret = E2E_P05Check(0u, data, (uint16_t)length);
+    break;
+  default:
+    ret = E2E_P07Check(0u, data, length);
+    break;
+  }
+
+  return ret;
+}
+
+/* returns the number of failed checks */
+static uint32_t Bench_Single(const Bench_CaseType *bc, uint8_t *ring, uint32_t rounds) {
+  uint32_t failed = 0u;
+  uint32_t r, i;
+
+  for (r = 0u; r < rounds; r++) {
+    for (i = 0u; i < BENCH_RING_SIZE; i++) {
+      if (E_OK != Bench_Protect(bc->profile, &ring[i * bc->length], bc->length)) {
+        failed++;
+      }
+    }
+    for (i = 0u; i < BENCH_RING_SIZE; i++) {
+      if (E2E_E_OK != Bench_Check(bc->profile, &ring[i * bc->length], bc->length)) {
+        failed++;
+      }
+    }
+  }
+
+  return failed;
+}
+
+static uint32_t Bench_Batch(const Bench_CaseType *bc, uint8_t *ring, uint32_t rounds) {
+  uint32_t failed = 0u;
+  uint32_t r, i;
+
+  for (i = 0u; i < BENCH_RING_SIZE; i++) {
+    Bench_Items[i].data = &ring[i * bc->length];
+    Bench_Items[i].length = bc->length;
+    Bench_Items[i].profileId = 0u;
+    Bench_Items[i].operation = Bench_Protects[bc->profile];
+    Bench_Items[BENCH_RING_SIZE + i] = Bench_Items[i];
+    Bench_Items[BENCH_RING_SIZE + i].operation = Bench_Checks[bc->profile];
+  }
+
+  for (r = 0u; r < rounds; r++) {
+    failed += (2u * BENCH_RING_SIZE) - E2E_ExecuteBatch(Bench_Items, 2u * BENCH_RING_SIZE);
+  }
+
+  return failed;
+}
+
+static void Bench_Run(const Bench_CaseType *bc, uint8_t *ring, int batch) {
+  uint32_t rounds = BENCH_BYTES_PER_CASE / (bc->length * BENCH_RING_SIZE);
+  uint32_t failed;
+  double t0, t;
+  double checks;
+
+  if (0u == rounds) {
+    rounds = 1u;
+  }
+
+  E2E_Init(&E2E_Config);
+  t0 = Bench_Now();
+  if (batch) {
+    failed = Bench_Batch(bc, ring, rounds);
+  } else {
+    failed = Bench_Single(bc, ring, rounds);
+  }
+  t = Bench_Now() - t0;
+  checks = (double)rounds * BENCH_RING_SIZE;
+  printf("%s %7u bytes %-6s: %10.0f protect+check/s, %8.1f MB/s, failed %u\n", bc->name,
+         bc->length, batch ? "batch" : "single", checks / t, checks * bc->length / t / 1e6, failed);
+  if (0u != failed) {
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  uint8_t *ring;
+  uint32_t i;
+  size_t size = 1048576u * BENCH_RING_SIZE;
+
+  ring = (uint8_t *)malloc(size);
+  if (NULL == ring) {
+    printf("no memory\n");
+    return -1;
+  }
+
+  for (i = 0u; i < size; i++) {
+    ring[i] = (uint8_t)(i * 7u);
+  }
+
+  for (i = 0u; i < ARRAY_SIZE(Bench_Cases); i++) {
+    Bench_Run(&Bench_Cases[i], ring, 0);
+    Bench_Run(&Bench_Cases[i], ring, 1);
+  }
+
+  free(ring);
+  return 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Protect and then check a ring of frames per profile, once with the single call API and once
+ * with E2E_ExecuteBatch. Both must protect the frames the same way and every check must be okay,
+ * then a corrupted frame, a repeated frame and a frame too long for the classic profiles must be
+ * reported by the batch.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "E2E.h"
+#include "E2E_Cfg.h"
+#include "E2E_Priv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+/* frames protected and then checked by one batch */
+#define TEST_RING_SIZE 16u
+
+#ifndef TEST_ROUNDS
+#define TEST_ROUNDS 4u
+#endif
+
+#define TEST_MAX_LENGTH 1048576u
+
+#define TEST_P11 0
+#define TEST_P22 1
+#define TEST_P44 2
+#define TEST_P05 3
+#define TEST_P07 4
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  const char *name;
+  int profile;
+  uint32_t length;
+} test_case_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static E2E_ProtectProfile11ContextType testProtectP11Context;
+static const E2E_ProtectProfile11ConfigType testProtectP11Configs[] = {
+  {&testProtectP11Context, {0x123u, 0u, 8u, 12u, E2E_P11_DATAID_BOTH}},
+};
+static E2E_CheckProfile11ContextType testCheckP11Context;
+static const E2E_CheckProfile11ConfigType testCheckP11Configs[] = {
+  {&testCheckP11Context, {0x123u, 0u, 8u, 12u, E2E_P11_DATAID_BOTH}, 1u},
+};
+
+static E2E_ProtectProfile22ContextType testProtectP22Context;
+static const E2E_ProtectProfile22ConfigType testProtectP22Configs[] = {
+  {&testProtectP22Context, {0u, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}}},
+};
+static E2E_CheckProfile22ContextType testCheckP22Context;
+static const E2E_CheckProfile22ConfigType testCheckP22Configs[] = {
+  {&testCheckP22Context, {0u, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}}, 1u},
+};
+
+static E2E_ProtectProfile44ContextType testProtectP44Context;
+static const E2E_ProtectProfile44ConfigType testProtectP44Configs[] = {
+  {&testProtectP44Context, {0x0a0b0c0du, 0u}},
+};
+static E2E_CheckProfile44ContextType testCheckP44Context;
+static const E2E_CheckProfile44ConfigType testCheckP44Configs[] = {
+  {&testCheckP44Context, {0x0a0b0c0du, 0u}, 1u},
+};
+
+static E2E_ProtectProfile05ContextType testProtectP05Context;
+static const E2E_ProtectProfile05ConfigType testProtectP05Configs[] = {
+  {&testProtectP05Context, {0x1234u, 0u}},
+};
+static E2E_CheckProfile05ContextType testCheckP05Context;
+static const E2E_CheckProfile05ConfigType testCheckP05Configs[] = {
+  {&testCheckP05Context, {0x1234u, 0u}, 1u},
+};
+
+static E2E_ProtectProfile07ContextType testProtectP07Context;
+static const E2E_ProtectProfile07ConfigType testProtectP07Configs[] = {
+  {&testProtectP07Context, {0x0a0b0c0du, 64u}},
+};
+static E2E_CheckProfile07ContextType testCheckP07Context;
+static const E2E_CheckProfile07ConfigType testCheckP07Configs[] = {
+  {&testCheckP07Context, {0x0a0b0c0du, 64u}, 1u},
+};
+
+const E2E_ConfigType E2E_Config = {
+  testProtectP11Configs,
+  testCheckP11Configs,
+  testProtectP22Configs,
+  testCheckP22Configs,
+  testProtectP44Configs,
+  testCheckP44Configs,
+  testProtectP05Configs,
+  testCheckP05Configs,
+  testProtectP07Configs,
+  testCheckP07Configs,
+  ARRAY_SIZE(testProtectP11Configs),
+  ARRAY_SIZE(testCheckP11Configs),
+  ARRAY_SIZE(testProtectP22Configs),
+  ARRAY_SIZE(testCheckP22Configs),
+  ARRAY_SIZE(testProtectP44Configs),
+  ARRAY_SIZE(testCheckP44Configs),
+  ARRAY_SIZE(testProtectP05Configs),
+  ARRAY_SIZE(testCheckP05Configs),
+  ARRAY_SIZE(testProtectP07Configs),
+  ARRAY_SIZE(testCheckP07Configs),
+};
+
+static const test_case_t testCases[] = {
+  {"P11", TEST_P11, 8u},       {"P22", TEST_P22, 8u},       {"P44", TEST_P44, 64u},
+  {"P44", TEST_P44, 4096u},    {"P05", TEST_P05, 64u},      {"P05", TEST_P05, 4096u},
+  {"P07", TEST_P07, 4096u},    {"P07", TEST_P07, 65536u},   {"P07", TEST_P07, 1048576u},
+};
+
+static const E2E_OperationType testProtects[] = {
+  E2E_PROTECT_P11, E2E_PROTECT_P22, E2E_PROTECT_P44, E2E_PROTECT_P05, E2E_PROTECT_P07,
+};
+
+static const E2E_OperationType testChecks[] = {
+  E2E_CHECK_P11, E2E_CHECK_P22, E2E_CHECK_P44, E2E_CHECK_P05, E2E_CHECK_P07,
+};
+
+static E2E_BatchItemType testItems[2u * TEST_RING_SIZE];
+static uint8_t *testSingleRing;
+static uint8_t *testBatchRing;
+/* ================================ [ LOCALS    ] ============================================== */
+static Std_ReturnType test_protect(int profile, uint8_t *data, uint32_t length) {
+  Std_ReturnType ret = E_NOT_OK;
+
+  switch (profile) {
+  case TEST_P11:
+    ret = E2E_P11Protect(0u, data, (uint16_t)length);
+    break;
+  case TEST_P22:
+    ret = E2E_P22Protect(0u, data, (uint16_t)length);
+    break;
+  case TEST_P44:
+    ret = E2E_P44Protect(0u, data, (uint16_t)length);
+    break;
+  case TEST_P05:
+    ret = E2E_P05Protect(0u, data, (uint16_t)length);
+    break;
+  default:
+    ret = E2E_P07Protect(0u, data, length);
+    break;
+  }
+
+  return ret;
+}
+
+static Std_ReturnType test_check(int profile, uint8_t *data, uint32_t length) {
+  Std_ReturnType ret = E_NOT_OK;
+
+  switch (profile) {
+  case TEST_P11:
+    ret = E2E_P11Check(0u, data, (uint16_t)length);
+    break;
+  case TEST_P22:
+    ret = E2E_P22Check(0u, data, (uint16_t)length);
+    break;
+  case TEST_P44:
+    ret = E2E_P44Check(0u, data, (uint16_t)length);
+    break;
+  case TEST_P05:
+    ret = E2E_P05Check(0u, data, (uint16_t)length);
+    break;
+  default:
+    ret = E2E_P07Check(0u, data, length);
+    break;
+  }
+
+  return ret;
+}
+
+static void test_fill(uint8_t *ring, uint32_t size) {
+  uint32_t i;
+
+  for (i = 0u; i < size; i++) {
+    ring[i] = (uint8_t)rand();
+  }
+}
+
+/* returns the number of failed operations */
+static uint32_t test_single(const test_case_t *tc, uint8_t *ring) {
+  uint32_t failed = 0u;
+  uint32_t r, i;
+
+  E2E_Init(&E2E_Config);
+  for (r = 0u; r < TEST_ROUNDS; r++) {
+    for (i = 0u; i < TEST_RING_SIZE; i++) {
+      if (E_OK != test_protect(tc->profile, &ring[i * tc->length], tc->length)) {
+        failed++;
+      }
+    }
+    for (i = 0u; i < TEST_RING_SIZE; i++) {
+      if (E2E_E_OK != test_check(tc->profile, &ring[i * tc->length], tc->length)) {
+        failed++;
+      }
+    }
+  }
+
+  return failed;
+}
+
+static void test_setup_batch(const test_case_t *tc, uint8_t *ring) {
+  uint32_t i;
+
+  for (i = 0u; i < TEST_RING_SIZE; i++) {
+    testItems[i].data = &ring[i * tc->length];
+    testItems[i].length = tc->length;
+    testItems[i].profileId = 0u;
+    testItems[i].operation = testProtects[tc->profile];
+    testItems[TEST_RING_SIZE + i] = testItems[i];
+    testItems[TEST_RING_SIZE + i].operation = testChecks[tc->profile];
+  }
+}
+
+static uint32_t test_batch(const test_case_t *tc, uint8_t *ring) {
+  uint32_t failed = 0u;
+  uint32_t r, i;
+
+  E2E_Init(&E2E_Config);
+  test_setup_batch(tc, ring);
+  for (r = 0u; r < TEST_ROUNDS; r++) {
+    failed += (2u * TEST_RING_SIZE) - E2E_ExecuteBatch(testItems, 2u * TEST_RING_SIZE);
+    for (i = 0u; i < (2u * TEST_RING_SIZE); i++) {
+      if (E2E_E_OK != testItems[i].result) {
+        failed++;
+      }
+    }
+  }
+
+  return failed;
+}
+
+static void Test_SingleAndBatch(const test_case_t *tc) {
+  uint32_t size = tc->length * TEST_RING_SIZE;
+  uint32_t singleFailed, batchFailed;
+  bool bPass;
+
+  printf("Test %s %u bytes single and batch:", tc->name, tc->length);
+  test_fill(testSingleRing, size);
+  memcpy(testBatchRing, testSingleRing, size);
+  singleFailed = test_single(tc, testSingleRing);
+  batchFailed = test_batch(tc, testBatchRing);
+  bPass = (0u == singleFailed) && (0u == batchFailed) &&
+          (0 == memcmp(testSingleRing, testBatchRing, size));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  failed single %u batch %u, same frames: %s\n", singleFailed, batchFailed,
+           (0 == memcmp(testSingleRing, testBatchRing, size)) ? "yes" : "no");
+    exit(-1);
+  }
+}
+
+/* the last frame is corrupted after being protected, restored and then checked twice */
+static void Test_BatchErrors(const test_case_t *tc) {
+  uint32_t size = tc->length * TEST_RING_SIZE;
+  E2E_BatchItemType items[2];
+  E2E_BatchItemType tooLong;
+  uint16_t numOfOK;
+  Std_ReturnType corrupted;
+  bool bPass;
+
+  printf("Test %s %u bytes batch errors:", tc->name, tc->length);
+  test_fill(testBatchRing, size);
+  E2E_Init(&E2E_Config);
+  test_setup_batch(tc, testBatchRing);
+  numOfOK = E2E_ExecuteBatch(testItems, TEST_RING_SIZE);
+  testBatchRing[size - 1u] ^= 0x01u;
+  numOfOK += E2E_ExecuteBatch(&testItems[TEST_RING_SIZE], TEST_RING_SIZE);
+  corrupted = testItems[2u * TEST_RING_SIZE - 1u].result;
+  testBatchRing[size - 1u] ^= 0x01u;
+  items[0] = testItems[2u * TEST_RING_SIZE - 1u];
+  items[1] = items[0];
+  numOfOK += E2E_ExecuteBatch(items, 2u);
+
+  /* only the profile 07 supports frames longer than 64KB */
+  tooLong = testItems[0];
+  tooLong.length = 0x10000u;
+  bPass = ((2u * TEST_RING_SIZE) == numOfOK) && (E2E_E_WRONG_CRC == corrupted) &&
+          (E2E_E_OK == items[0].result) && (E2E_E_REPEATED == items[1].result) &&
+          ((TEST_P07 == tc->profile) || (0u == E2E_ExecuteBatch(&tooLong, 1u)));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u okay, corrupted frame %02X, restored frame %02X then %02X, too long %02X\n",
+           numOfOK, corrupted, items[0].result, items[1].result, tooLong.result);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  uint32_t i;
+
+  srand(1);
+  testSingleRing = (uint8_t *)malloc(TEST_MAX_LENGTH * TEST_RING_SIZE);
+  testBatchRing = (uint8_t *)malloc(TEST_MAX_LENGTH * TEST_RING_SIZE);
+  if ((NULL == testSingleRing) || (NULL == testBatchRing)) {
+    printf("no memory\n");
+    return -1;
+  }
+
+  for (i = 0u; i < ARRAY_SIZE(testCases); i++) {
+    Test_SingleAndBatch(&testCases[i]);
+    Test_BatchErrors(&testCases[i]);
+  }
+
+  free(testSingleRing);
+  free(testBatchRing);
+  return 0;
+}
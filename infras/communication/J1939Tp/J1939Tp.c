@@ -9,8 +9,8 @@
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "J1939Tp.h"
-#include "J1939Tp_Priv.h"
 #include "J1939Tp_Cfg.h"
+#include "J1939Tp_Priv.h"
 #include "PduR_J1939Tp.h"
 #include "CanIf.h"
 
@@ -35,6 +35,12 @@
 
 #define IS_J1939TP_FD(config) (config->LL_DL > 8u)
 
+/* the max DT packets of a CMDT CTS window in flight at once, they are sent back to back without
+ * waiting for the TX confirmation of each one, 1 to send them one by one with STMin in between */
+#ifndef J1939TP_DT_BURST_MAX
+#define J1939TP_DT_BURST_MAX 1u
+#endif
+
 #define J1939TP_CM_RTS 16u
 #define J1939TP_CM_CTS 17u
 #define J1939TP_CM_EOMA 19u
@@ -245,7 +251,69 @@ static void J1939Tp_StartToSend_CMDT(PduIdType TxPduId) {
   }
 }
 
-static void J1939Tp_SendDT(PduIdType TxPduId) {
+static void J1939Tp_StartSTMin(const J1939Tp_TxChannelType *config) {
+#ifdef J1939TP_USE_STD_TIMER
+  config->context->dtTime = Std_GetTime();
+#else
+  config->context->stTimer = config->STMin;
+#endif
+}
+
+static boolean J1939Tp_IsSTMinElapsed(const J1939Tp_TxChannelType *config) {
+  boolean elapsed;
+#ifdef J1939TP_USE_STD_TIMER
+  elapsed = ((Std_GetTime() - config->context->dtTime) >=
+             ((std_time_t)config->STMin * J1939TP_MAIN_FUNCTION_PERIOD * 1000u));
+#else
+  elapsed = (0u == config->context->stTimer);
+#endif
+  return elapsed;
+}
+
+static uint32_t J1939Tp_GetNumOfTxDTPackets(const J1939Tp_TxChannelType *config) {
+  uint32_t numOfPackets;
+
+  if (IS_J1939TP_FD(config)) {
+    numOfPackets = NUM_OF_FD_DT_PACKETS;
+  } else {
+    numOfPackets = NUM_OF_DT_PACKETS;
+  }
+
+  return numOfPackets;
+}
+
+/* the first DT of a CTS window and the DTs of a CMDT burst are sent at once, the others wait
+ * until STMin since the last one is elapsed */
+static boolean J1939Tp_IsDTDue(const J1939Tp_TxChannelType *config) {
+  boolean due;
+
+  if ((J1939TP_WAIT_CM_CTS_RX == config->context->state) || (0u == config->STMin)) {
+    due = TRUE;
+  } else if ((J1939TP_PROTOCOL_CMDT == config->TxProtocol) && (J1939TP_DT_BURST_MAX > 1u)) {
+    due = TRUE;
+  } else {
+    due = J1939Tp_IsSTMinElapsed(config);
+  }
+
+  return due;
+}
+
+static boolean J1939Tp_IsDTBurstAllowed(const J1939Tp_TxChannelType *config) {
+  boolean allowed = FALSE;
+
+  if ((J1939TP_PROTOCOL_CMDT == config->TxProtocol) &&
+      (J1939TP_WAIT_DT_TX_COMPLETED == config->context->state) &&
+      (config->context->numOfTxDT < J1939TP_DT_BURST_MAX) &&
+      (config->context->NumPacketsToSend > 0u) &&
+      (config->context->NextSN < J1939Tp_GetNumOfTxDTPackets(config))) {
+    allowed = TRUE;
+  }
+
+  return allowed;
+}
+
+/* build the DT packet NextSN + 1 in the channel buffer */
+static Std_ReturnType J1939Tp_BuildDT(PduIdType TxPduId) {
   const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[TxPduId];
   PduInfoType PduInfo;
   uint8_t *data;
@@ -254,7 +322,7 @@ static void J1939Tp_SendDT(PduIdType TxPduId) {
   PduLengthType ll_dl;
   PduLengthType pos;
   PduLengthType offset = 0u;
-  Std_ReturnType ret;
+  Std_ReturnType ret = E_NOT_OK;
 
   if (IS_J1939TP_FD(config)) {
     data = config->data;
@@ -299,24 +367,53 @@ static void J1939Tp_SendDT(PduIdType TxPduId) {
                      data[1], data[2], data[3], data[4], data[5], data[6], data[7]));
     config->context->PduInfo.SduDataPtr = data;
     config->context->PduInfo.SduLength = ll_dl;
+    ret = E_OK;
+  }
+
+  return ret;
+}
 
-    if ((J1939TP_WAIT_CM_CTS_RX == config->context->state) || (0u == config->STMin)) {
-      ret = CanIf_Transmit(config->CanIf_TxDtNPdu, &config->context->PduInfo);
-      if (E_OK == ret) {
-        config->context->state = J1939TP_WAIT_DT_TX_COMPLETED;
-        config->context->timer = config->Tr;
+/* transmit the DT packet built in the channel buffer */
+static void J1939Tp_TransmitDT(PduIdType TxPduId) {
+  const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[TxPduId];
+  Std_ReturnType ret;
+
+  ret = CanIf_Transmit(config->CanIf_TxDtNPdu, &config->context->PduInfo);
+  if (E_OK == ret) {
+    config->context->NextSN++;
+    config->context->numOfTxDT++;
+    if ((J1939TP_PROTOCOL_CMDT == config->TxProtocol) &&
+        (config->context->NumPacketsToSend > 0u)) {
+      config->context->NumPacketsToSend--;
+    }
+    J1939Tp_StartSTMin(config);
+    config->context->state = J1939TP_WAIT_DT_TX_COMPLETED;
+    config->context->timer = config->Tr;
+  } else {
+    config->context->state = J1939TP_RESEND_DT;
+    config->context->timer = config->Tr;
+  }
+}
+
+static void J1939Tp_SendDT(PduIdType TxPduId) {
+  const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[TxPduId];
+  boolean more = TRUE;
+
+  while (TRUE == more) {
+    more = FALSE;
+    if (E_OK == J1939Tp_BuildDT(TxPduId)) {
+      if (TRUE == J1939Tp_IsDTDue(config)) {
+        J1939Tp_TransmitDT(TxPduId);
+        more = J1939Tp_IsDTBurstAllowed(config);
       } else {
-        config->context->state = J1939TP_RESEND_DT;
-        config->context->timer = config->Tr;
+        config->context->state = J1939TP_WAIT_DT_STMIN_TIMEOUT;
+        config->context->timer = 0u; /* the main functions send it once STMin is elapsed */
       }
     } else {
-      config->context->state = J1939TP_WAIT_DT_STMIN_TIMEOUT;
-      config->context->timer = config->STMin;
+      ASLOG(J1939TPE, ("[%d]DT: failed to provide TX data, reset to idle\n", TxPduId));
+      J1939Tp_TxResetToIdle(config);
+      PduR_J1939TpTxConfirmation(config->PduR_TxPduId, E_NOT_OK);
     }
-  } else {
-    ASLOG(J1939TPE, ("[%d]DT: failed to provide TX data, reset to idle\n", TxPduId));
-    J1939Tp_TxResetToIdle(config);
-    PduR_J1939TpTxConfirmation(config->PduR_TxPduId, E_NOT_OK);
   }
 }
 
@@ -671,20 +768,21 @@ static void J1939Tp_RxSendCmEOMA(PduIdType Channel) {
 
 static void J1939Tp_HandleDT_TxConfirmation_TxChannel(PduIdType Channel, Std_ReturnType result) {
   const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[Channel];
+
+  if (config->context->numOfTxDT > 0u) {
+    config->context->numOfTxDT--;
+  }
+
   if (E_OK == result) {
-    if ((IS_J1939TP_FD(config) && ((config->context->NextSN + 1u) < NUM_OF_FD_DT_PACKETS)) ||
-        ((config->context->NextSN + 1u) < NUM_OF_DT_PACKETS)) {
-      config->context->NextSN++;
-      if (J1939TP_PROTOCOL_CMDT == config->TxProtocol) {
-        if (config->context->NumPacketsToSend > 0u) {
-          config->context->NumPacketsToSend--;
-        }
-        if (0u == config->context->NumPacketsToSend) {
-          config->context->state = J1939TP_WAIT_CM_CTS_RX;
-          config->context->timer = config->T3;
-        } else {
-          J1939Tp_SendDT(Channel);
-        }
+    if (TRUE == J1939Tp_IsDTBurstAllowed(config)) {
+      J1939Tp_SendDT(Channel); /* keep the CTS window flowing */
+    } else if (config->context->numOfTxDT > 0u) {
+      /* wait for the confirmation of the others in flight */
+    } else if (config->context->NextSN < J1939Tp_GetNumOfTxDTPackets(config)) {
+      if ((J1939TP_PROTOCOL_CMDT == config->TxProtocol) &&
+          (0u == config->context->NumPacketsToSend)) {
+        config->context->state = J1939TP_WAIT_CM_CTS_RX;
+        config->context->timer = config->T3;
       } else {
         J1939Tp_SendDT(Channel);
       }
@@ -709,6 +807,24 @@ static void J1939Tp_HandleDT_TxConfirmation_TxChannel(PduIdType Channel, Std_Ret
   }
 }
 
+/* the confirmation of a DT of the burst while the next one waits for CanIf or STMin */
+static void J1939Tp_HandleDT_TxConfirmationInBurst(PduIdType Channel, Std_ReturnType result) {
+  const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[Channel];
+
+  if (config->context->numOfTxDT > 0u) {
+    config->context->numOfTxDT--;
+    if (E_OK != result) {
+      J1939Tp_TxResetToIdle(config);
+      PduR_J1939TpTxConfirmation(config->PduR_TxPduId, E_NOT_OK);
+      ASLOG(J1939TPE, ("[%d] Fatal Error, send DT failed\n", Channel));
+    }
+  } else {
+    ASLOG(J1939TPE,
+          ("[%d] TX TxConfirmation when in state %d, abort\n", Channel, config->context->state));
+    J1939Tp_TxResetToIdle(config);
+  }
+}
+
 static void J1939Tp_TxConfirmation_TxChannel(PduIdType Channel, Std_ReturnType result) {
   const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[Channel];
   switch (config->context->state) {
@@ -731,6 +847,8 @@ static void J1939Tp_TxConfirmation_TxChannel(PduIdType Channel, Std_ReturnType r
       PduR_J1939TpTxConfirmation(config->PduR_TxPduId, result);
     } else {
       config->context->NumPacketsToSend = 0xFFu;
+      /* the BAM needs the gap before the first DT as well */
+      J1939Tp_StartSTMin(config);
       J1939Tp_SendDT(Channel);
     }
     break;
@@ -741,6 +859,10 @@ static void J1939Tp_TxConfirmation_TxChannel(PduIdType Channel, Std_ReturnType r
   case J1939TP_WAIT_DT_TX_COMPLETED:
     J1939Tp_HandleDT_TxConfirmation_TxChannel(Channel, result);
     break;
+  case J1939TP_RESEND_DT:
+  case J1939TP_WAIT_DT_STMIN_TIMEOUT:
+    J1939Tp_HandleDT_TxConfirmationInBurst(Channel, result);
+    break;
   case J1939TP_WAIT_CM_EOMS_TX_COMPLETED:
     if (E_OK != result) {
       J1939Tp_TxResetToIdle(config);
@@ -777,10 +899,10 @@ static void J1939Tp_HandleCM_CTS(PduIdType Channel, const PduInfoType *PduInfoPt
       NextSN = PduInfoPtr->SduDataPtr[4] + ((uint32_t)PduInfoPtr->SduDataPtr[5] << 8) +
                ((uint32_t)PduInfoPtr->SduDataPtr[6] << 16);
       NumPacketsToSend = PduInfoPtr->SduDataPtr[7];
-      RequestField = PduInfoPtr->SduDataPtr[9];
+      RequestField = PduInfoPtr->SduDataPtr[8];
       PgPGN = PduInfoPtr->SduDataPtr[9] + ((uint32_t)PduInfoPtr->SduDataPtr[10] << 8) +
               ((uint32_t)PduInfoPtr->SduDataPtr[11] << 16);
-      numOfDtPackets = NUM_OF_DT_PACKETS;
+      numOfDtPackets = NUM_OF_FD_DT_PACKETS;
       ret = E_OK;
     }
   } else {
@@ -790,7 +912,7 @@ static void J1939Tp_HandleCM_CTS(PduIdType Channel, const PduInfoType *PduInfoPt
       NextSN = PduInfoPtr->SduDataPtr[2];
       PgPGN = PduInfoPtr->SduDataPtr[5] + ((uint32_t)PduInfoPtr->SduDataPtr[6] << 8) +
               ((uint32_t)PduInfoPtr->SduDataPtr[7] << 16);
-      numOfDtPackets = NUM_OF_FD_DT_PACKETS;
+      numOfDtPackets = NUM_OF_DT_PACKETS;
       ret = E_OK;
     }
   }
@@ -865,9 +987,20 @@ static void J1939Tp_HandleCM_EOMA(PduIdType Channel, const PduInfoType *PduInfoP
 
 static void J1939Tp_HandleCM(PduIdType Channel, const PduInfoType *PduInfoPtr) {
   const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[Channel];
-  if (J1939TP_WAIT_CM_CTS_RX == config->context->state) {
+  boolean windowSent = FALSE;
+  boolean allSent = FALSE;
+
+  /* the CTS or EOMA may overtake the TX confirmation of the last DT of a burst */
+  if ((J1939TP_WAIT_DT_TX_COMPLETED == config->context->state) &&
+      (J1939TP_PROTOCOL_CMDT == config->TxProtocol)) {
+    allSent = (config->context->NextSN >= J1939Tp_GetNumOfTxDTPackets(config));
+    windowSent = (0u == config->context->NumPacketsToSend) && (FALSE == allSent);
+  }
+
+  if ((J1939TP_WAIT_CM_CTS_RX == config->context->state) || (TRUE == windowSent)) {
     J1939Tp_HandleCM_CTS(Channel, PduInfoPtr);
-  } else if (J1939TP_WAIT_END_OF_MSG_ACK_RX == config->context->state) {
+  } else if ((J1939TP_WAIT_END_OF_MSG_ACK_RX == config->context->state) ||
+             ((TRUE == allSent) && (FALSE == IS_J1939TP_FD(config)))) {
     J1939Tp_HandleCM_EOMA(Channel, PduInfoPtr);
   } else {
     ASLOG(J1939TPE,
@@ -1260,10 +1393,14 @@ void J1939Tp_MainFunction_TxChannelFast(uint16_t Channel) {
     }
     break;
   case J1939TP_RESEND_DT:
-    ret = CanIf_Transmit(config->CanIf_TxDtNPdu, &config->context->PduInfo);
-    if (E_OK == ret) {
-      config->context->state = J1939TP_WAIT_DT_TX_COMPLETED;
-      config->context->timer = config->Tr;
+    J1939Tp_TransmitDT(Channel);
+    if (TRUE == J1939Tp_IsDTBurstAllowed(config)) {
+      J1939Tp_SendDT(Channel);
+    }
+    break;
+  case J1939TP_WAIT_DT_STMIN_TIMEOUT:
+    if (TRUE == J1939Tp_IsSTMinElapsed(config)) {
+      J1939Tp_TransmitDT(Channel);
     }
     break;
   case J1939TP_RESEND_CM_EOMS:
@@ -1280,25 +1417,22 @@ void J1939Tp_MainFunction_TxChannelFast(uint16_t Channel) {
 
 void J1939Tp_MainFunction_TxChannel(uint16_t Channel) {
   const J1939Tp_TxChannelType *config = &J1939TP_CONFIG->TxChannels[Channel];
-  Std_ReturnType ret;
+
+#ifndef J1939TP_USE_STD_TIMER
+  if (config->context->stTimer > 0u) {
+    config->context->stTimer--;
+  }
+#endif
+  if ((J1939TP_WAIT_DT_STMIN_TIMEOUT == config->context->state) &&
+      (TRUE == J1939Tp_IsSTMinElapsed(config))) {
+    J1939Tp_TransmitDT(Channel);
+  }
 
   if (config->context->timer > 0u) {
     config->context->timer--;
     if (0u == config->context->timer) {
-      if (J1939TP_WAIT_DT_STMIN_TIMEOUT != config->context->state) {
-        ASLOG(J1939TPE, ("[%d]TX timer timeout in state %d\n", Channel, config->context->state));
-      }
+      ASLOG(J1939TPE, ("[%d]TX timer timeout in state %d\n", Channel, config->context->state));
       switch (config->context->state) {
-      case J1939TP_WAIT_DT_STMIN_TIMEOUT:
-        ret = CanIf_Transmit(config->CanIf_TxDtNPdu, &config->context->PduInfo);
-        if (E_OK == ret) {
-          config->context->state = J1939TP_WAIT_DT_TX_COMPLETED;
-          config->context->timer = config->Tr;
-        } else {
-          config->context->state = J1939TP_RESEND_DT;
-          config->context->timer = config->Tr;
-        }
-        break;
       case J1939TP_WAIT_DIRECT_PG_TX_COMPLETED:
       case J1939TP_WAIT_CM_RTS_TX_COMPLETED:
       case J1939TP_WAIT_CM_BAM_TX_COMPLETED:
@@ -1527,8 +1661,11 @@ void J1939Tp_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   versionInfo->moduleID = MODULE_ID_J1939TP;
   versionInfo->sw_major_version = 4;
   versionInfo->sw_minor_version = 0;
-  versionInfo->sw_patch_version = 1;
+  versionInfo->sw_patch_version = 2;
 }
 /** @brief release notes
  * - 4.0.1: Fix FD DT transmit SN check issue
+ * - 4.0.2: CMDT CTS window sent in bursts of J1939TP_DT_BURST_MAX, STMin counted from the
+ *    transmission of the last DT and optionally paced by the Std_Timer, fix the number of DT
+ *    packets and the request field checked on FD and classic CTS.
  */
@@ -9,6 +9,7 @@
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "ComStack_Types.h"
 #include "J1939Tp.h"
+#include "Std_Timer.h"
 /* ================================ [ MACROS    ] ============================================== */
 #ifndef DET_THIS_MODULE_ID
 #define DET_THIS_MODULE_ID MODULE_ID_J1939TP
@@ -95,7 +96,13 @@ typedef struct {
   PduInfoType PduInfo;
   PduLengthType TpSduLength;
   uint16_t timer;
+#ifdef J1939TP_USE_STD_TIMER
+  std_time_t dtTime; /* when the last DT was sent */
+#else
+  uint16_t stTimer; /* main function cycles until STMin since the last DT is elapsed */
+#endif
   uint8_t NumPacketsToSend;
+  uint8_t numOfTxDT; /* DT packets sent but not confirmed yet */
   uint8_t state;
 } J1939Tp_TxChannelContextType;
 
@@ -26,6 +26,11 @@
 #else
 #define LINIF_CONFIG (&LinIf_Config)
 #endif
+
+#ifdef LINIF_SCHED_MODE_DEADLINE
+/* time t is reached, the std_time_t may wrap around */
+#define LINIF_TIME_REACHED(now, t) (((std_time_t)((now) - (t))) < (STD_TIME_MAX >> 1))
+#endif
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 extern const LinIf_ConfigType LinIf_Config;
@@ -122,6 +127,37 @@ static void LinIf_CheckEntry(uint8_t Channel) {
 #endif
 }
 #endif /* LINIF_SCHED_MODE_POLLING */
+
+#ifdef LINIF_SCHED_MODE_DEADLINE
+/* The slots are started at absolute deadlines: the next deadline is the last one plus the slot
+ * time, so neither the call period of the main function nor its latency is accumulated. */
+static void LinIf_ScheduleDeadline(NetworkHandleType Channel) {
+  LinIf_ChannelContextType *context;
+  const LinIf_ScheduleTableEntryType *entry;
+  std_time_t now = Std_GetTime();
+
+  context = &LINIF_CONFIG->channelContexts[Channel];
+  if (LINIF_TIME_REACHED(now, context->deadline)) {
+    if (LINIF_STATUS_IDLE != context->status) {
+      ASLOG(LINIFE, ("%d: master timeout for entry %u\n", Channel, context->curSch));
+      context->status = LINIF_STATUS_IDLE;
+    }
+    context->curSch++;
+    if (context->curSch >= context->scheduleTable->numOfEntries) {
+      context->curSch = 0;
+    }
+    entry = &context->scheduleTable->entrys[context->curSch];
+    context->deadline += entry->slotTime;
+    if (LINIF_TIME_REACHED(now, context->deadline)) {
+      /* late for more than one slot, restart the schedule from now */
+      ASLOG(LINIFE, ("%d: schedule overrun for entry %u\n", Channel, context->curSch));
+      context->deadline = now + entry->slotTime;
+      context->overruns++;
+    }
+    LinIf_ScheduleEntry(Channel);
+  }
+}
+#endif /* LINIF_SCHED_MODE_DEADLINE */
 #endif /* LINIF_VARIANT_MASTER */
 
 #if (LINIF_VARIANT & LINIF_VARIANT_MASTER) == LINIF_VARIANT_MASTER
@@ -179,6 +215,9 @@ static void LinIf_MainFunction_Master(NetworkHandleType Channel) {
       ASLOG(LINIF, ("%d: switch to schedule table %d\n", Channel, context->scheduleRequested));
       context->scheduleRequested = LINIF_INVALD_SCHEDULE_TABLE;
       context->timer = 0;
+#ifdef LINIF_SCHED_MODE_DEADLINE
+      context->deadline = Std_GetTime();
+#endif
       if (0 < context->scheduleTable->numOfEntries) {
         context->curSch = context->scheduleTable->numOfEntries - 1; /* default to the end */
       } else {
@@ -189,6 +228,9 @@ static void LinIf_MainFunction_Master(NetworkHandleType Channel) {
   }
 
   if ((E_OK == ret) && (NULL != context->scheduleTable)) {
+#ifdef LINIF_SCHED_MODE_DEADLINE
+    LinIf_ScheduleDeadline(Channel);
+#else
     if (context->timer > 0) {
       context->timer--;
     }
@@ -203,6 +245,7 @@ static void LinIf_MainFunction_Master(NetworkHandleType Channel) {
       context->timer = context->scheduleTable->entrys[context->curSch].delay;
       LinIf_ScheduleEntry(Channel);
     }
+#endif
   }
 }
 #endif
@@ -253,6 +296,10 @@ void LinIf_Init(const LinIf_ConfigType *ConfigPtr) {
 #endif
     context->state = LINIF_CHANNEL_SLEEP;
     context->timer = 0;
+#ifdef LINIF_SCHED_MODE_DEADLINE
+    context->deadline = 0;
+    context->overruns = 0;
+#endif
 #ifdef USE_MIRROR
     context->bMirroringActive = FALSE;
 #endif
@@ -379,6 +426,45 @@ void LinIf_MainFunction_Read(void) {
 #endif
 }
 
+uint32_t LinIf_GetNextSlotTime(void) {
+  uint32_t next = LINIF_MAIN_FUNCTION_PERIOD * 1000u;
+#if ((LINIF_VARIANT & LINIF_VARIANT_MASTER) == LINIF_VARIANT_MASTER) &&                            \
+  defined(LINIF_SCHED_MODE_DEADLINE)
+  int i;
+  LinIf_ChannelContextType *context;
+  std_time_t now;
+  std_time_t left;
+
+  DET_VALIDATE(NULL != LINIF_CONFIG, 0x81, LINIF_E_UNINIT, return next);
+  now = Std_GetTime();
+  for (i = 0; i < LINIF_CONFIG->numOfChannels; i++) {
+    context = &LINIF_CONFIG->channelContexts[i];
+#if LINIF_VARIANT == LINIF_VARIANT_BOTH
+    if (LINIF_MASTER != LINIF_CONFIG->channelConfigs[i].nodeType) {
+      continue;
+    }
+#endif
+    if ((LINIF_CHANNEL_OPERATIONAL == context->state) &&
+        (LINIF_INVALD_SCHEDULE_TABLE != context->scheduleRequested)) {
+      next = 0; /* start the requested schedule table now */
+    } else if ((LINIF_CHANNEL_OPERATIONAL == context->state) &&
+               (NULL != context->scheduleTable)) {
+      if (LINIF_TIME_REACHED(now, context->deadline)) {
+        next = 0;
+      } else {
+        left = context->deadline - now;
+        if (left < next) {
+          next = (uint32_t)left;
+        }
+      }
+    } else {
+      /* the sleep handling is still driven by the main function period */
+    }
+  }
+#endif
+  return next;
+}
+
 void LinIf_MainFunction(void) {
   int i;
 #if LINIF_VARIANT == LINIF_VARIANT_BOTH
@@ -635,11 +721,13 @@ void LinIf_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   versionInfo->vendorID = STD_VENDOR_ID_AS;
   versionInfo->moduleID = MODULE_ID_LINIF;
   versionInfo->sw_major_version = 4;
-  versionInfo->sw_minor_version = 0;
-  versionInfo->sw_patch_version = 2;
+  versionInfo->sw_minor_version = 1;
+  versionInfo->sw_patch_version = 0;
 }
 
 /** @brief release notes
  * - 4.0.1: Fix to ensure wake up to schedule the 1st frame from the schedule table.
  * - 4.0.2: For slave, when timer timeout, notify the application about the timeout.
+ * - 4.1.0: Add the LINIF_SCHED_MODE_DEADLINE: the master slots are started at absolute deadlines
+ *          in us and the frame completion is notified by the Lin driver callbacks.
  */
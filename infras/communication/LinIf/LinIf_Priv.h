@@ -7,13 +7,17 @@
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "LinIf.h"
 #include "LinIf_Cfg.h"
+#ifdef LINIF_SCHED_MODE_DEADLINE
+#include "Std_Timer.h"
+#endif
 /* ================================ [ MACROS    ] ============================================== */
 #define DET_THIS_MODULE_ID MODULE_ID_LINIF
 #ifndef LINIF_MAX_DATA_LENGHT
 #define LINIF_MAX_DATA_LENGHT 8
 #endif
 
-#if !defined(LINIF_SCHED_MODE_POLLING) && !defined(LINIF_SCHED_MODE_INTERRUPT)
+#if !defined(LINIF_SCHED_MODE_POLLING) && !defined(LINIF_SCHED_MODE_INTERRUPT) &&                  \
+  !defined(LINIF_SCHED_MODE_DEADLINE)
 #define LINIF_SCHED_MODE_POLLING
 #endif
 
@@ -34,6 +38,9 @@ typedef struct {
   Lin_FrameResponseType Drc;
   LinIf_NotificationCallbackType callback;
   uint16_t delay;
+#ifdef LINIF_SCHED_MODE_DEADLINE
+  uint32_t slotTime; /* the slot time in us, times LINIF_DELAY_UINT like the delay */
+#endif
 } LinIf_ScheduleTableEntryType;
 
 typedef struct {
@@ -51,6 +58,10 @@ typedef struct {
 #endif
   Lin_PduType frame;
   uint16_t timer; /* timer in ms */
+#ifdef LINIF_SCHED_MODE_DEADLINE
+  std_time_t deadline; /* the absolute start time of the next slot in us */
+  uint32_t overruns;   /* the times that the schedule was late for more than one slot */
+#endif
   LinIf_ChannelStateType state;
   LinIf_ChannelStatusType status;
   LinIf_SchHandleType curSch;
@@ -0,0 +1,20 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Com PDU IDs of the LinIf jitter test, the Com is stubbed by linif_test.c
+ */
+#ifndef COM_CFG_H
+#define COM_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#define COM_LIN0_SLAVE_STATUS_RX 0
+#define COM_LIN0_SLAVE_VALUE_RX 1
+#define COM_LIN0_MASTER_CMD_TX 2
+#define COM_LIN0_MASTER_MODE_TX 3
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* COM_CFG_H */
@@ -0,0 +1,239 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Slot jitter of the LinIf master schedule in the LINIF_SCHED_MODE_DEADLINE on a simulated clock:
+ * the schedule tables are generated from jitter.ldf, the Lin driver is stubbed to complete each
+ * frame after a fixed response time by the LinIf_TxConfirmation/LinIf_RxIndication callbacks and
+ * every wake up of the LinIf_MainFunction is late by a random latency. The start of each slot is
+ * compared with the nominal one of the LDF: called by a 1ms tick it must be less than one tick
+ * plus the latency away, called at the time given by LinIf_GetNextSlotTime it must be no more
+ * than the latency away, and neither may drift. A main function late for more than one slot must
+ * restart the schedule once.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "LinIf.h"
+#include "LinIf_Cfg.h"
+#include "LinIf_Priv.h"
+#include "Com.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_SECONDS
+#define TEST_SECONDS 10u
+#endif
+
+/* the time from the start of the header to the end of the response */
+#define TEST_RESPONSE_US 150u
+
+/* the wake up latency of the main function is random up to this */
+#define TEST_LATENCY_US 50u
+
+#define TEST_TICK_US 1000u
+#define TEST_CHANNEL 0u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t slots;
+  uint32_t rxSlots;
+  uint32_t received; /* the slave responses given to the Com */
+  uint32_t maxError; /* absolute slot start error in us */
+  uint64_t sumError;
+} test_stats_t;
+/* ================================ [ DECLARES  ] ============================================== */
+extern const LinIf_ConfigType LinIf_Config;
+/* ================================ [ DATAS     ] ============================================== */
+static test_stats_t testStats;
+static std_time_t testNow;
+static std_time_t testNominal;
+static uint32_t testOverruns;
+static boolean testPending;
+static std_time_t testDoneAt;
+static Lin_FrameResponseType testDrc;
+static uint8_t testRxData[8] = {0x55, 0xAA, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+static const LinIf_ScheduleTableType *testTable;
+/* ================================ [ LOCALS    ] ============================================== */
+static void test_complete(void) {
+  if ((TRUE == testPending) && (testNow >= testDoneAt)) {
+    testPending = FALSE;
+    if (LIN_FRAMERESPONSE_TX == testDrc) {
+      LinIf_TxConfirmation(TEST_CHANNEL);
+    } else {
+      LinIf_RxIndication(TEST_CHANNEL, testRxData);
+    }
+  }
+}
+
+static uint32_t test_cycle_time(void) {
+  uint32_t cycle = 0;
+  uint32_t i;
+
+  for (i = 0; i < testTable->numOfEntries; i++) {
+    cycle += testTable->entrys[i].slotTime;
+  }
+
+  return cycle;
+}
+
+static void test_start(LinIf_SchHandleType table) {
+  memset(&testStats, 0, sizeof(testStats));
+  testOverruns = 0;
+  testPending = FALSE;
+  testTable = &LinIf_Config.scheduleTables[table];
+  LinIf_Init(NULL);
+  (void)LinIf_WakeUp(TEST_CHANNEL);
+  (void)LinIf_ScheduleRequest(TEST_CHANNEL, table);
+}
+
+/* run the main function for the duration, return the number of overruns */
+static uint32_t test_run(std_time_t duration, boolean byDeadline) {
+  std_time_t end = testNow + duration;
+  std_time_t tick = testNow;
+  std_time_t wait;
+
+  while (testNow < end) {
+    test_complete();
+    LinIf_MainFunction();
+    if (byDeadline) {
+      wait = LinIf_GetNextSlotTime();
+      if ((TRUE == testPending) && ((testNow + wait) > testDoneAt)) {
+        testNow = testDoneAt; /* the completion is an interrupt, no latency */
+      } else {
+        testNow += wait + ((uint32_t)rand() % (TEST_LATENCY_US + 1u));
+      }
+    } else {
+      tick += TEST_TICK_US;
+      testNow = tick + ((uint32_t)rand() % (TEST_LATENCY_US + 1u));
+    }
+  }
+  testNow += TEST_RESPONSE_US;
+  test_complete();
+
+  return LinIf_Config.channelContexts[TEST_CHANNEL].overruns;
+}
+
+static void test_print(uint32_t overruns) {
+  printf("  slots=%u rx slots=%u received=%u overruns=%u, |error| mean=%.1f us max=%u us\n",
+         testStats.slots, testStats.rxSlots, testStats.received, overruns,
+         (testStats.slots > 0) ? (double)testStats.sumError / testStats.slots : 0.0,
+         testStats.maxError);
+}
+
+static void Test_Jitter(const char *name, LinIf_SchHandleType table, boolean byDeadline) {
+  std_time_t duration = (std_time_t)TEST_SECONDS * 1000000u;
+  uint32_t maxError = byDeadline ? TEST_LATENCY_US : (TEST_TICK_US - 1u + TEST_LATENCY_US);
+  uint32_t slots;
+  uint32_t overruns;
+  bool bPass;
+
+  printf("Test %s slots by %s:", name, byDeadline ? "deadline" : "1ms tick");
+  test_start(table);
+  overruns = test_run(duration, byDeadline);
+  LinIf_DeInit();
+  slots = (uint32_t)(duration / test_cycle_time() * testTable->numOfEntries);
+  bPass = (0u == overruns) && (testStats.maxError <= maxError) &&
+          (testStats.slots >= slots) && (testStats.slots <= (slots + testTable->numOfEntries)) &&
+          (testStats.rxSlots == testStats.received);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    test_print(overruns);
+    exit(-1);
+  }
+}
+
+static void Test_Overrun(void) {
+  uint32_t overruns;
+  uint32_t slots;
+  bool bPass;
+
+  printf("Test a main function late for more than a slot restarts the schedule:");
+  test_start(LINIF_SCHTBL_LIN0_NORMAL);
+  (void)test_run(100000u, TRUE);
+  slots = testStats.slots;
+  testNow += 3u * test_cycle_time();
+  overruns = test_run(100000u, TRUE);
+  LinIf_DeInit();
+  bPass = (1u == overruns) && (testStats.maxError <= TEST_LATENCY_US) &&
+          (testStats.slots > slots) && (testStats.rxSlots == testStats.received);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    test_print(overruns);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+std_time_t Std_GetTime(void) {
+  return testNow;
+}
+
+Std_ReturnType Lin_SendFrame(uint8_t Channel, const Lin_PduType *PduInfoPtr) {
+  const LinIf_ChannelContextType *context = &LinIf_Config.channelContexts[Channel];
+  int64_t error;
+
+  /* the slot of entry curSch is nominally started one slot time after the previous one, the
+   * first slot and the slot restarted after an overrun are the reference */
+  if ((0u == testStats.slots) || (testOverruns != context->overruns)) {
+    testOverruns = context->overruns;
+    testNominal = testNow;
+  } else {
+    testNominal +=
+      testTable->entrys[(context->curSch + testTable->numOfEntries - 1u) % testTable->numOfEntries]
+        .slotTime;
+  }
+  error = (int64_t)testNow - (int64_t)testNominal;
+  error = (error < 0) ? -error : error;
+  if ((uint32_t)error > testStats.maxError) {
+    testStats.maxError = (uint32_t)error;
+  }
+  testStats.sumError += (uint64_t)error;
+  testStats.slots++;
+  if (LIN_FRAMERESPONSE_RX == PduInfoPtr->Drc) {
+    testStats.rxSlots++;
+  }
+
+  testPending = TRUE;
+  testDoneAt = testNow + TEST_RESPONSE_US;
+  testDrc = PduInfoPtr->Drc;
+  return E_OK;
+}
+
+Lin_StatusType Lin_GetStatus(uint8_t Channel, uint8_t **Lin_SduPtr) {
+  *Lin_SduPtr = NULL;
+  return LIN_OPERATIONAL;
+}
+
+Std_ReturnType Lin_GoToSleep(uint8_t Channel) {
+  return E_OK;
+}
+
+Std_ReturnType Lin_GoToSleepInternal(uint8_t Channel) {
+  return E_OK;
+}
+
+Std_ReturnType Lin_Wakeup(uint8_t Channel) {
+  return E_OK;
+}
+
+void Com_RxIndication(PduIdType RxPduId, const PduInfoType *PduInfoPtr) {
+  testStats.received++;
+}
+
+Std_ReturnType Com_TriggerTransmit(PduIdType TxPduId, PduInfoType *PduInfoPtr) {
+  memset(PduInfoPtr->SduDataPtr, (int)TxPduId, PduInfoPtr->SduLength);
+  return E_OK;
+}
+
+int main(int argc, char *argv[]) {
+  srand(1);
+  testNow = 1000000u;
+
+  Test_Jitter("NORMAL", LINIF_SCHTBL_LIN0_NORMAL, FALSE);
+  Test_Jitter("NORMAL", LINIF_SCHTBL_LIN0_NORMAL, TRUE);
+  /* the 500us slots of the FAST table are shorter than the tick */
+  Test_Jitter("FAST", LINIF_SCHTBL_LIN0_FAST, TRUE);
+  Test_Overrun();
+
+  return 0;
+}
@@ -18,6 +18,166 @@
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
+static void PduR_GwReleaseBuffer(const PduR_RoutingPathType *RoutingPath) {
+  PduR_BufferType *buffer = RoutingPath->DestTxBufferRef;
+#if defined(PDUR_USE_MEMPOOL)
+  if ((NULL != buffer->data) && (buffer->data != RoutingPath->GwBuffer)) {
+    PduR_MemFree(buffer->data);
+  }
+#endif
+  buffer->data = NULL;
+  buffer->state = PDUR_GW_STORE_AND_FORWARD;
+}
+
+/* the ring position of the SDU byte at offset pos is (pos % size) */
+static void PduR_GwRingWrite(PduR_BufferType *buffer, PduLengthType pos, const uint8_t *data,
+                             PduLengthType len) {
+  PduLengthType start = pos % buffer->size;
+  PduLengthType first = buffer->size - start;
+  if (first > len) {
+    first = len;
+  }
+  (void)memcpy(&buffer->data[start], data, first);
+  if (first < len) {
+    (void)memcpy(buffer->data, &data[first], len - first);
+  }
+}
+
+static void PduR_GwRingRead(const PduR_BufferType *buffer, PduLengthType pos, uint8_t *data,
+                            PduLengthType len) {
+  PduLengthType start = pos % buffer->size;
+  PduLengthType first = buffer->size - start;
+  if (first > len) {
+    first = len;
+  }
+  (void)memcpy(data, &buffer->data[start], first);
+  if (first < len) {
+    (void)memcpy(&data[first], buffer->data, len - first);
+  }
+}
+
+static Std_ReturnType PduR_GwStartOnTheFly(PduIdType pathId) {
+  Std_ReturnType ret = E_NOT_OK;
+  const PduR_RoutingPathType *RoutingPath = &PDUR_CONFIG->RoutingPaths[pathId];
+  PduR_BufferType *buffer = RoutingPath->DestTxBufferRef;
+  const PduR_PduType *DestPduRef = &RoutingPath->DestPduRef[0];
+  PduInfoType PduInfo;
+
+  ASLOG(PDURI, ("[%u] start on-the-fly routing at %u/%u\n", pathId, buffer->index,
+                buffer->TpSduLength));
+  /* the destination may copy the data at once within the Transmit */
+  buffer->state = PDUR_GW_ON_THE_FLY_TX;
+  PduInfo.SduDataPtr = buffer->data;
+  PduInfo.SduLength = buffer->TpSduLength;
+  PduInfo.MetaDataPtr = NULL;
+  if (NULL != DestPduRef->api->Transmit) {
+    ret = DestPduRef->api->Transmit(DestPduRef->PduHandleId, &PduInfo);
+  } else {
+    ASLOG(PDURE, ("null Transmit\n"));
+  }
+
+  if ((E_OK != ret) && (NULL != buffer->data)) {
+    ASLOG(PDURE, ("[%u] on-the-fly Transmit failed\n", pathId));
+    PduR_GwReleaseBuffer(RoutingPath);
+  }
+
+  return ret;
+}
+
+static BufReq_ReturnType PduR_GwStartOfReceptionOnTheFly(PduIdType pathId,
+                                                          PduLengthType TpSduLength,
+                                                          PduLengthType *bufferSizePtr) {
+  BufReq_ReturnType ret = BUFREQ_E_NOT_OK;
+  const PduR_RoutingPathType *RoutingPath = &PDUR_CONFIG->RoutingPaths[pathId];
+  PduR_BufferType *buffer = RoutingPath->DestTxBufferRef;
+
+  if (NULL != buffer->data) {
+    ASLOG(PDURE, ("[%u] the previous on-the-fly routing is still in progress\n", pathId));
+    PduR_GwReleaseBuffer(RoutingPath);
+  }
+
+  /* the ring must at least hold TpThreshold bytes, otherwise the transmission never starts */
+  if ((NULL != RoutingPath->GwBuffer) && (RoutingPath->GwBufferSize >= RoutingPath->TpThreshold)) {
+    buffer->data = RoutingPath->GwBuffer;
+    buffer->size = RoutingPath->GwBufferSize;
+    if (buffer->size > TpSduLength) {
+      buffer->size = TpSduLength;
+    }
+  } else {
+#if defined(PDUR_USE_MEMPOOL)
+    buffer->data = PduR_MemAlloc(TpSduLength);
+    buffer->size = TpSduLength;
+#endif
+  }
+
+  if (NULL != buffer->data) {
+    buffer->index = 0;
+    buffer->txIndex = 0;
+    buffer->TpSduLength = TpSduLength;
+    buffer->state = PDUR_GW_ON_THE_FLY_RX;
+    *bufferSizePtr = buffer->size;
+    ret = BUFREQ_OK;
+  }
+
+  return ret;
+}
+
+static BufReq_ReturnType PduR_GwCopyRxDataOnTheFly(PduIdType pathId, const PduInfoType *info,
+                                                   PduLengthType *bufferSizePtr) {
+  BufReq_ReturnType ret = BUFREQ_OK;
+  const PduR_RoutingPathType *RoutingPath = &PDUR_CONFIG->RoutingPaths[pathId];
+  PduR_BufferType *buffer = RoutingPath->DestTxBufferRef;
+  PduLengthType freeSize = buffer->size - (buffer->index - buffer->txIndex);
+
+  if (PDUR_GW_ON_THE_FLY_ABORT == buffer->state) {
+    ret = BUFREQ_E_NOT_OK;
+  } else if (0u == info->SduLength) {
+    /* the source TP is polling for free buffer */
+    *bufferSizePtr = freeSize;
+  } else if (info->SduLength > (buffer->TpSduLength - buffer->index)) {
+    ASLOG(PDURE, ("Buffer Overflow\n"));
+    ret = BUFREQ_E_OVFL;
+  } else if (info->SduLength > freeSize) {
+    /* the destination is slower, let the source TP hold on by its flow control */
+    *bufferSizePtr = freeSize;
+    ret = BUFREQ_E_BUSY;
+  } else {
+    PduR_GwRingWrite(buffer, buffer->index, info->SduDataPtr, info->SduLength);
+    buffer->index += info->SduLength;
+    if ((PDUR_GW_ON_THE_FLY_RX == buffer->state) && (buffer->index >= RoutingPath->TpThreshold)) {
+      if (E_OK != PduR_GwStartOnTheFly(pathId)) {
+        ret = BUFREQ_E_NOT_OK;
+      }
+    }
+    if (BUFREQ_OK == ret) {
+      *bufferSizePtr = buffer->size - (buffer->index - buffer->txIndex);
+    }
+  }
+
+  return ret;
+}
+
+static BufReq_ReturnType PduR_GwCopyTxDataOnTheFly(PduR_BufferType *buffer,
+                                                   const PduInfoType *info,
+                                                   PduLengthType *availableDataPtr) {
+  BufReq_ReturnType ret = BUFREQ_OK;
+  PduLengthType offset = *((PduLengthType *)info->MetaDataPtr);
+
+  if ((PDUR_GW_ON_THE_FLY_ABORT == buffer->state) || (offset < buffer->txIndex) ||
+      (offset > buffer->index)) {
+    /* aborted, or the data to be retried was already released from the ring */
+    ret = BUFREQ_E_NOT_OK;
+  } else if (info->SduLength > (buffer->index - offset)) {
+    *availableDataPtr = buffer->index - offset;
+    ret = BUFREQ_E_BUSY;
+  } else {
+    PduR_GwRingRead(buffer, offset, info->SduDataPtr, info->SduLength);
+    buffer->txIndex = offset + info->SduLength;
+    *availableDataPtr = buffer->index - buffer->txIndex;
+  }
+
+  return ret;
+}
 /* ================================ [ FUNCTIONS ] ============================================== */
 void PduR_Init(const PduR_ConfigType *ConfigPtr) {
   (void)ConfigPtr;
@@ -237,7 +397,9 @@ BufReq_ReturnType PduR_GwCopyTxData(PduIdType pathId, const PduInfoType *info,
   if ((pathId < config->numOfRoutingPaths) &&
       (NULL != config->RoutingPaths[pathId].DestTxBufferRef)) {
     buffer = config->RoutingPaths[pathId].DestTxBufferRef;
-    if (NULL != buffer->data) {
+    if ((NULL != buffer->data) && (PDUR_GW_STORE_AND_FORWARD != buffer->state)) {
+      ret = PduR_GwCopyTxDataOnTheFly(buffer, info, availableDataPtr);
+    } else if (NULL != buffer->data) {
       (void)memcpy(info->SduDataPtr, &buffer->data[offset], info->SduLength);
       offset += info->SduLength;
       *availableDataPtr = buffer->size - offset;
@@ -262,12 +424,8 @@ void PduR_GwTxConfirmation(PduIdType pathId, Std_ReturnType result) {
   if (NULL != RoutingPath->DestTxBufferRef) {
     buffer = RoutingPath->DestTxBufferRef;
     if (NULL != buffer->data) {
-#if defined(PDUR_USE_MEMPOOL)
-      if (buffer->data != RoutingPath->GwBuffer) {
-        PduR_MemFree(buffer->data);
-      }
-#endif
-      buffer->data = NULL;
+      /* for on-the-fly routing, a failed transmission also aborts the ongoing reception */
+      PduR_GwReleaseBuffer(RoutingPath);
     }
   }
 }
@@ -289,7 +447,12 @@ BufReq_ReturnType PduR_GwStartOfReception(PduIdType pathId, const PduInfoType *i
   ASLOG(PDUR, ("PduR_GwStartOfReception %d\n", pathId));
   if (NULL != RoutingPath->DestTxBufferRef) {
     buffer = RoutingPath->DestTxBufferRef;
-    if ((NULL != RoutingPath->GwBuffer) && (RoutingPath->GwBufferSize >= TpSduLength)) {
+    buffer->state = PDUR_GW_STORE_AND_FORWARD;
+    if ((RoutingPath->TpThreshold > 0u) && (TpSduLength > RoutingPath->TpThreshold) &&
+        (1u == RoutingPath->numOfDestPdus) &&
+        (RoutingPath->DestPduRef[0].Module < PDUR_MODULE_ISOTP)) {
+      ret = PduR_GwStartOfReceptionOnTheFly(pathId, TpSduLength, bufferSizePtr);
+    } else if ((NULL != RoutingPath->GwBuffer) && (RoutingPath->GwBufferSize >= TpSduLength)) {
       buffer->data = RoutingPath->GwBuffer;
       buffer->size = TpSduLength;
       buffer->index = 0;
@@ -326,7 +489,9 @@ BufReq_ReturnType PduR_GwCopyRxData(PduIdType pathId, const PduInfoType *info,
   ASLOG(PDUR, ("PduR_GwCopyRxData %d\n", pathId));
   if (NULL != config->RoutingPaths[pathId].DestTxBufferRef) {
     buffer = config->RoutingPaths[pathId].DestTxBufferRef;
-    if (NULL != buffer->data) {
+    if ((NULL != buffer->data) && (PDUR_GW_STORE_AND_FORWARD != buffer->state)) {
+      ret = PduR_GwCopyRxDataOnTheFly(pathId, info, bufferSizePtr);
+    } else if (NULL != buffer->data) {
       if ((buffer->index < buffer->size) && (info->SduLength <= (buffer->size - buffer->index))) {
         (void)memcpy(&buffer->data[buffer->index], info->SduDataPtr, info->SduLength);
         buffer->index += info->SduLength;
@@ -356,7 +521,22 @@ void PduR_GwRxIndication(PduIdType pathId, Std_ReturnType result) {
   RoutingPath = &config->RoutingPaths[pathId];
 
   ASLOG(PDUR, ("PduR_GwRxIndication %d\n", pathId));
-  if (NULL != RoutingPath->DestTxBufferRef) {
+  buffer = RoutingPath->DestTxBufferRef;
+  if ((NULL != buffer) && (NULL != buffer->data) &&
+      (PDUR_GW_STORE_AND_FORWARD != buffer->state)) {
+    if (E_OK != result) {
+      if (PDUR_GW_ON_THE_FLY_TX == buffer->state) {
+        /* released by the destination TxConfirmation, after its next CopyTxData failed */
+        buffer->state = PDUR_GW_ON_THE_FLY_ABORT;
+      } else {
+        PduR_GwReleaseBuffer(RoutingPath);
+      }
+    } else if (PDUR_GW_ON_THE_FLY_RX == buffer->state) {
+      (void)PduR_GwStartOnTheFly(pathId);
+    } else {
+      /* transmission is ongoing, the buffer is released on its TxConfirmation */
+    }
+  } else if (NULL != RoutingPath->DestTxBufferRef) {
     for (i = 0; (i < RoutingPath->numOfDestPdus) && (E_OK == ret); i++) {
       DestPduRef = &RoutingPath->DestPduRef[i];
       buffer = RoutingPath->DestTxBufferRef;
@@ -17,3 +17,7 @@
 Std_ReturnType PduR_DcmTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
   return PduR_TpTransmit(TxPduId, PduInfoPtr);
 }
+
+Std_ReturnType PduR_DcmIfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  return PduR_Transmit(TxPduId, PduInfoPtr);
+}
@@ -16,6 +16,11 @@
 #define DET_THIS_MODULE_ID MODULE_ID_PDUR
 
 #define PDUR_CONFIG (&PduR_Config)
+
+#define PDUR_GW_STORE_AND_FORWARD 0u
+#define PDUR_GW_ON_THE_FLY_RX 1u    /* receiving, the destination transmission not started */
+#define PDUR_GW_ON_THE_FLY_TX 2u    /* receiving and transmitting */
+#define PDUR_GW_ON_THE_FLY_ABORT 3u /* the reception failed while transmitting */
 /* ================================ [ TYPES     ] ============================================== */
 typedef enum {
   PDUR_MODULE_CANIF,
@@ -61,8 +66,12 @@ typedef struct {
 
 typedef struct {
   uint8_t *data;
-  PduLengthType size;
-  PduLengthType index;
+  PduLengthType size;  /* the SDU length, or the ring capacity when routing on-the-fly */
+  PduLengthType index; /* number of bytes received */
+  /* the following are only used when routing on-the-fly */
+  PduLengthType TpSduLength;
+  PduLengthType txIndex; /* number of bytes copied out to the destination */
+  uint8_t state;
 } PduR_BufferType;
 
 /* @ECUC_PduR_00248 */
@@ -72,6 +81,9 @@ typedef struct {
   PduR_BufferType *DestTxBufferRef; /* @ECUC_PduR_00304 */
   uint8_t *GwBuffer;                /* static gateway dest buffer */
   PduLengthType GwBufferSize;
+  /* PduRTpThreshold: when not 0, the transmission to the destination is started once TpThreshold
+   * bytes are received, the GwBuffer is then used as a ring which can be smaller than the SDU */
+  PduLengthType TpThreshold;
   uint16_t numOfDestPdus;
 } PduR_RoutingPathType;
 
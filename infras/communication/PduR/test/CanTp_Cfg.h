@@ -0,0 +1,23 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * CanTp config of the gateway test and bench: channel 0 is the ECU which sends, channel 1 is the
+ * gateway which receives, both looped back by the CanIf of pdur_gw_test.c and PduR_GwBench.c
+ */
+#ifndef CANTP_CFG_H
+#define CANTP_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Std_Types.h"
+/* ================================ [ MACROS    ] ============================================== */
+#define CANTP_MAIN_FUNCTION_PERIOD 1
+#define CANTP_CONVERT_MS_TO_MAIN_CYCLES(x)                                                         \
+  ((x + CANTP_MAIN_FUNCTION_PERIOD - 1) / CANTP_MAIN_FUNCTION_PERIOD)
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+uint32_t CanIf_CanTpGetTxCanId(uint8_t Channel);
+uint32_t CanIf_CanTpGetRxCanId(uint8_t Channel);
+#endif /* CANTP_CFG_H */
@@ -0,0 +1,20 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * PduR config of the gateway test and bench, the routing paths are set up at runtime by
+ * pdur_gw_test.c and PduR_GwBench.c
+ */
+#ifndef PDUR_CFG_H
+#define PDUR_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef PDUR_TEST_MAX_SDU
+#define PDUR_TEST_MAX_SDU 4095
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* PDUR_CFG_H */
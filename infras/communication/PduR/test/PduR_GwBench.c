@@ -0,0 +1,371 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * PduR TP gateway latency: an ECU sends a segmented message over CanTp, the gateway routes it to a
+ * simulated DoIP socket which drains at most a given number of bytes per 1 ms cycle. The latency
+ * to the first and the last byte at the DoIP side is compared for the store-and-forward and the
+ * on-the-fly routing, the CAN bus is limited to a given number of frames per cycle.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "PduR.h"
+#include "PduR_Priv.h"
+#include "PduR_CanTp.h"
+#include "PduR_DoIP.h"
+#include "CanTp.h"
+#include "CanTp_Cfg.h"
+#include "CanTp_Priv.h"
+#include "CanIf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define BENCH_PATH_ECU 0u
+#define BENCH_PATH_GW 1u
+
+#define BENCH_CH_ECU 0u
+#define BENCH_CH_GW 1u
+
+#define BENCH_MAX_FRAMES 64u
+#define BENCH_MAX_TICKS 60000u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  PduIdType CanIfTxPduId;
+  PduLengthType length;
+  uint8_t data[64];
+} Bench_FrameType;
+
+typedef struct {
+  uint32_t ticks;
+  uint32_t ffTick;    /* FF received by the gateway */
+  uint32_t lastCfTick; /* last CF received by the gateway */
+  uint32_t firstTick; /* first byte sent by DoIP */
+  uint32_t lastTick;  /* last byte sent by DoIP */
+  uint32_t numWT;
+  uint32_t numFC;
+  PduLengthType maxInUse;
+  boolean ok;
+} Bench_ResultType;
+/* ================================ [ DECLARES  ] ============================================== */
+static BufReq_ReturnType Bench_EcuCopyTxData(PduIdType id, const PduInfoType *info,
+                                             const RetryInfoType *retry,
+                                             PduLengthType *availableDataPtr);
+static void Bench_EcuTxConfirmation(PduIdType id, Std_ReturnType result);
+static Std_ReturnType Bench_DoIPTransmit(PduIdType id, const PduInfoType *PduInfoPtr);
+/* ================================ [ DATAS     ] ============================================== */
+static const PduR_ApiType Bench_EcuApi = {
+  NULL, NULL, NULL, NULL, NULL, Bench_EcuCopyTxData, Bench_EcuTxConfirmation,
+};
+
+static const PduR_ApiType Bench_CanTpApi = {
+  PduR_CanTpGwStartOfReception,
+  PduR_CanTpGwCopyRxData,
+  PduR_CanTpGwRxIndication,
+  NULL,
+  CanTp_Transmit,
+  PduR_CanTpGwCopyTxData,
+  PduR_CanTpGwTxConfirmation,
+};
+
+static const PduR_ApiType Bench_DoIPApi = {
+  PduR_DoIPGwStartOfReception, PduR_DoIPGwCopyRxData, PduR_DoIPGwRxIndication, NULL,
+  Bench_DoIPTransmit,          PduR_DoIPGwCopyTxData, PduR_DoIPGwTxConfirmation,
+};
+
+static const PduR_PduType Bench_EcuPdu = {PDUR_MODULE_COM, 0, &Bench_EcuApi};
+static const PduR_PduType Bench_EcuCanTpPdu = {PDUR_MODULE_CANTP, BENCH_CH_ECU, &Bench_CanTpApi};
+static const PduR_PduType Bench_GwCanTpPdu = {PDUR_MODULE_CANTP, BENCH_CH_GW, &Bench_CanTpApi};
+static const PduR_PduType Bench_DoIPPdu = {PDUR_MODULE_DOIP, BENCH_PATH_GW, &Bench_DoIPApi};
+
+static uint8_t Bench_GwBuffer[PDUR_TEST_MAX_SDU];
+static PduR_BufferType Bench_Buffer;
+
+static PduR_RoutingPathType Bench_RoutingPaths[] = {
+  {&Bench_EcuPdu, &Bench_EcuCanTpPdu, NULL, NULL, 0, 0, 1},
+  {&Bench_GwCanTpPdu, &Bench_DoIPPdu, &Bench_Buffer, Bench_GwBuffer, 0, 0, 1},
+};
+
+const PduR_ConfigType PduR_Config = {
+  Bench_RoutingPaths,
+  ARRAY_SIZE(Bench_RoutingPaths),
+};
+
+static uint8_t Bench_CanTpData[2][64];
+static const CanTp_ChannelConfigType Bench_CanTpChannelConfigs[] = {
+  {Bench_CanTpData[BENCH_CH_ECU], CANTP_STANDARD, BENCH_CH_ECU, BENCH_PATH_ECU, BENCH_PATH_ECU,
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), CANTP_CONVERT_MS_TO_MAIN_CYCLES(100),
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), 0, 0, 0, 8, 8, 0x55, CANTP_PHYSICAL},
+  {Bench_CanTpData[BENCH_CH_GW], CANTP_STANDARD, BENCH_CH_GW, BENCH_PATH_GW, BENCH_PATH_GW,
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), CANTP_CONVERT_MS_TO_MAIN_CYCLES(100),
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), 0, 8, 0, 200, 8, 0x55, CANTP_PHYSICAL},
+};
+static CanTp_ChannelContextType Bench_CanTpChannelContexts[ARRAY_SIZE(Bench_CanTpChannelConfigs)];
+const CanTp_ConfigType CanTp_Config = {
+  Bench_CanTpChannelConfigs,
+  Bench_CanTpChannelContexts,
+  ARRAY_SIZE(Bench_CanTpChannelConfigs),
+};
+
+static Bench_FrameType Bench_Frames[BENCH_MAX_FRAMES];
+static uint32_t Bench_FrameIn;
+static uint32_t Bench_FrameOut;
+
+static uint8_t Bench_DoIPOut[PDUR_TEST_MAX_SDU];
+static PduLengthType Bench_DoIPTotal;
+static PduLengthType Bench_DoIPOffset;
+static boolean Bench_DoIPActive;
+static boolean Bench_EcuDone;
+
+static uint32_t Bench_Tick;
+static Bench_ResultType Bench_Result;
+
+static PduLengthType sduLength = 4095;
+static uint32_t busRate = 4;      /* CAN frames per cycle, about 500 kbps */
+static uint32_t doipRate = 1460; /* bytes per cycle the DoIP socket accepts */
+/* ================================ [ LOCALS    ] ============================================== */
+static uint8_t Bench_Pattern(PduLengthType offset) {
+  return (uint8_t)((offset * 7u) + 3u);
+}
+
+static BufReq_ReturnType Bench_EcuCopyTxData(PduIdType id, const PduInfoType *info,
+                                             const RetryInfoType *retry,
+                                             PduLengthType *availableDataPtr) {
+  PduLengthType offset = *((PduLengthType *)info->MetaDataPtr);
+  PduLengthType i;
+  (void)id;
+  (void)retry;
+  for (i = 0; i < info->SduLength; i++) {
+    info->SduDataPtr[i] = Bench_Pattern(offset + i);
+  }
+  *availableDataPtr = sduLength - offset - info->SduLength;
+  return BUFREQ_OK;
+}
+
+static void Bench_EcuTxConfirmation(PduIdType id, Std_ReturnType result) {
+  (void)id;
+  Bench_EcuDone = (E_OK == result);
+}
+
+static Std_ReturnType Bench_DoIPTransmit(PduIdType id, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  if ((BENCH_PATH_GW == id) && (FALSE == Bench_DoIPActive) &&
+      (PduInfoPtr->SduLength <= sizeof(Bench_DoIPOut))) {
+    Bench_DoIPTotal = PduInfoPtr->SduLength;
+    Bench_DoIPOffset = 0;
+    Bench_DoIPActive = TRUE;
+    ret = E_OK;
+  }
+  return ret;
+}
+
+/* the DoIP socket takes at most doipRate bytes per cycle, pull what the gateway has */
+static void Bench_DoIPMainFunction(void) {
+  PduInfoType PduInfo;
+  PduLengthType offset;
+  PduLengthType left = 0;
+  BufReq_ReturnType bret;
+
+  if (TRUE == Bench_DoIPActive) {
+    offset = Bench_DoIPOffset;
+    PduInfo.SduDataPtr = &Bench_DoIPOut[offset];
+    PduInfo.SduLength = Bench_DoIPTotal - offset;
+    if (PduInfo.SduLength > doipRate) {
+      PduInfo.SduLength = (PduLengthType)doipRate;
+    }
+    PduInfo.MetaDataPtr = (uint8_t *)&offset;
+    bret = PduR_DoIPCopyTxData(BENCH_PATH_GW, &PduInfo, NULL, &left);
+    if ((BUFREQ_E_BUSY == bret) && (left > 0u) && (left < PduInfo.SduLength)) {
+      PduInfo.SduLength = left;
+      bret = PduR_DoIPCopyTxData(BENCH_PATH_GW, &PduInfo, NULL, &left);
+    }
+    if (BUFREQ_OK == bret) {
+      if (0u == Bench_DoIPOffset) {
+        Bench_Result.firstTick = Bench_Tick;
+      }
+      Bench_DoIPOffset += PduInfo.SduLength;
+      if (Bench_DoIPOffset >= Bench_DoIPTotal) {
+        Bench_Result.lastTick = Bench_Tick;
+        Bench_DoIPActive = FALSE;
+        PduR_DoIPTxConfirmation(BENCH_PATH_GW, E_OK);
+      }
+    } else if (BUFREQ_E_BUSY != bret) {
+      printf("DoIP: copy failed at %u\n", (uint32_t)Bench_DoIPOffset);
+      Bench_DoIPActive = FALSE;
+      PduR_DoIPTxConfirmation(BENCH_PATH_GW, E_NOT_OK);
+    }
+  }
+}
+
+/* the CAN bus delivers at most busRate frames per cycle, the ECU and the gateway face each other */
+static void Bench_CanMainFunction(void) {
+  uint32_t n = 0;
+  Bench_FrameType *frame;
+  PduInfoType PduInfo;
+  PduLengthType inUse;
+
+  while ((Bench_FrameOut != Bench_FrameIn) && (n < busRate)) {
+    frame = &Bench_Frames[Bench_FrameOut % BENCH_MAX_FRAMES];
+    PduInfo.SduDataPtr = frame->data;
+    PduInfo.SduLength = frame->length;
+    PduInfo.MetaDataPtr = NULL;
+    if (BENCH_CH_ECU == frame->CanIfTxPduId) {
+      if (0x10u == (frame->data[0] & 0xF0u)) {
+        Bench_Result.ffTick = Bench_Tick;
+      } else {
+        Bench_Result.lastCfTick = Bench_Tick;
+      }
+      CanTp_RxIndication(BENCH_CH_GW, &PduInfo);
+    } else {
+      if (0x30u == (frame->data[0] & 0xF0u)) {
+        Bench_Result.numFC++;
+        if (0x01u == (frame->data[0] & 0x0Fu)) {
+          Bench_Result.numWT++;
+        }
+      }
+      CanTp_RxIndication(BENCH_CH_ECU, &PduInfo);
+    }
+    Bench_FrameOut++;
+    n++;
+  }
+
+  if (NULL != Bench_Buffer.data) {
+    inUse = Bench_Buffer.index - Bench_Buffer.txIndex;
+    if (PDUR_GW_STORE_AND_FORWARD == Bench_Buffer.state) {
+      inUse = Bench_Buffer.index;
+    }
+    if (inUse > Bench_Result.maxInUse) {
+      Bench_Result.maxInUse = inUse;
+    }
+  }
+}
+
+static void Bench_Run(PduLengthType threshold, PduLengthType ringSize) {
+  PduInfoType PduInfo;
+  PduLengthType i;
+
+  memset(&Bench_Result, 0, sizeof(Bench_Result));
+  memset(&Bench_Buffer, 0, sizeof(Bench_Buffer));
+  memset(Bench_DoIPOut, 0, sizeof(Bench_DoIPOut));
+  Bench_FrameIn = Bench_FrameOut = 0;
+  Bench_DoIPActive = FALSE;
+  Bench_EcuDone = FALSE;
+  Bench_Tick = 0;
+  Bench_RoutingPaths[BENCH_PATH_GW].TpThreshold = threshold;
+  Bench_RoutingPaths[BENCH_PATH_GW].GwBufferSize = ringSize;
+
+  PduR_Init(NULL);
+  CanTp_Init(NULL);
+
+  PduInfo.SduDataPtr = NULL;
+  PduInfo.SduLength = sduLength;
+  PduInfo.MetaDataPtr = NULL;
+  if (E_OK != CanTp_Transmit(BENCH_CH_ECU, &PduInfo)) {
+    printf("ECU: transmit failed\n");
+    return;
+  }
+
+  for (Bench_Tick = 1; Bench_Tick < BENCH_MAX_TICKS; Bench_Tick++) {
+    Bench_CanMainFunction();
+    CanTp_MainFunction_Fast();
+    Bench_DoIPMainFunction();
+    if ((TRUE == Bench_EcuDone) && (Bench_Result.lastTick > 0u)) {
+      break;
+    }
+  }
+  Bench_Result.ticks = Bench_Tick;
+
+  Bench_Result.ok = (Bench_Result.lastTick > 0u) && (Bench_DoIPOffset == sduLength);
+  for (i = 0; (i < sduLength) && (TRUE == Bench_Result.ok); i++) {
+    if (Bench_DoIPOut[i] != Bench_Pattern(i)) {
+      printf("data mismatch at %u\n", (uint32_t)i);
+      Bench_Result.ok = FALSE;
+    }
+  }
+
+  printf("%-18s threshold %4u ring %4u: first byte %4u ms, last byte %4u ms after the FF, "
+         "%u ms after the last CF; FC %u (WT %u), max buffered %u, %s\n",
+         (0u == threshold) ? "store-and-forward" : "on-the-fly", (uint32_t)threshold,
+         (uint32_t)ringSize, Bench_Result.firstTick - Bench_Result.ffTick,
+         Bench_Result.lastTick - Bench_Result.ffTick,
+         Bench_Result.lastTick - Bench_Result.lastCfTick, Bench_Result.numFC, Bench_Result.numWT,
+         (uint32_t)Bench_Result.maxInUse, (TRUE == Bench_Result.ok) ? "OK" : "FAILED");
+}
+
+static void usage(char *prog) {
+  printf("usage: %s [-n size] [-t TpThreshold] [-r ring size] [-b CAN frames per ms]"
+         " [-d DoIP bytes per ms]\n",
+         prog);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  Bench_FrameType *frame;
+
+  if (((Bench_FrameIn - Bench_FrameOut) < BENCH_MAX_FRAMES) &&
+      (PduInfoPtr->SduLength <= sizeof(frame->data))) {
+    frame = &Bench_Frames[Bench_FrameIn % BENCH_MAX_FRAMES];
+    frame->CanIfTxPduId = TxPduId;
+    frame->length = PduInfoPtr->SduLength;
+    memcpy(frame->data, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+    Bench_FrameIn++;
+    ret = E_OK;
+  }
+
+  return ret;
+}
+
+uint32_t CanIf_CanTpGetTxCanId(uint8_t Channel) {
+  return 0x731u + Channel;
+}
+
+uint32_t CanIf_CanTpGetRxCanId(uint8_t Channel) {
+  return 0x732u - Channel;
+}
+
+int main(int argc, char *argv[]) {
+  int ch;
+  PduLengthType threshold = 64;
+  PduLengthType ringSize = 512;
+
+  opterr = 0;
+  while ((ch = getopt(argc, argv, "b:d:hn:r:t:")) != -1) {
+    switch (ch) {
+    case 'b':
+      busRate = strtoul(optarg, NULL, 0);
+      break;
+    case 'd':
+      doipRate = strtoul(optarg, NULL, 0);
+      break;
+    case 'n':
+      sduLength = (PduLengthType)strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      ringSize = (PduLengthType)strtoul(optarg, NULL, 0);
+      break;
+    case 't':
+      threshold = (PduLengthType)strtoul(optarg, NULL, 0);
+      break;
+    case 'h':
+    default:
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  if ((sduLength <= 7u) || (sduLength > PDUR_TEST_MAX_SDU) || (ringSize > PDUR_TEST_MAX_SDU) ||
+      (0u == busRate) || (0u == doipRate)) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  printf("%u bytes, CAN %u frames/ms, DoIP %u bytes/ms\n", (uint32_t)sduLength, busRate,
+         doipRate);
+  Bench_Run(0, PDUR_TEST_MAX_SDU);
+  if (FALSE == Bench_Result.ok) {
+    return -1;
+  }
+  Bench_Run(threshold, ringSize);
+
+  return (TRUE == Bench_Result.ok) ? 0 : -1;
+}
@@ -0,0 +1,397 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * PduR TP gateway: an ECU sends a segmented message over CanTp, the gateway routes it to a
+ * simulated DoIP socket which drains at most a given number of bytes per 1 ms cycle, while the CAN
+ * bus delivers at most 4 frames per cycle. The store-and-forward routing must start the DoIP
+ * transmission after the last CF, the on-the-fly routing must start it after the TpThreshold and
+ * hold the CAN sender with FC WAIT when the ring buffer is full.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "PduR.h"
+#include "PduR_Priv.h"
+#include "PduR_CanTp.h"
+#include "PduR_DoIP.h"
+#include "CanTp.h"
+#include "CanTp_Cfg.h"
+#include "CanTp_Priv.h"
+#include "CanIf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define TEST_PATH_ECU 0u
+#define TEST_PATH_GW 1u
+
+#define TEST_CH_ECU 0u
+#define TEST_CH_GW 1u
+
+#define TEST_MAX_FRAMES 64u
+#define TEST_MAX_TICKS 60000u
+
+/* CAN frames per cycle, about 500 kbps */
+#define TEST_BUS_RATE 4u
+
+#define TEST_THRESHOLD 64u
+
+#ifndef TEST_RANDOM_ROUNDS
+#define TEST_RANDOM_ROUNDS 20u
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  PduIdType CanIfTxPduId;
+  PduLengthType length;
+  uint8_t data[64];
+} test_frame_t;
+
+typedef struct {
+  uint32_t ffTick;     /* FF received by the gateway */
+  uint32_t lastCfTick; /* last CF received by the gateway */
+  uint32_t firstTick;  /* first byte sent by DoIP */
+  uint32_t lastTick;   /* last byte sent by DoIP */
+  uint32_t numWT;
+  uint32_t numFC;
+  PduLengthType maxInUse;
+  bool ok;
+} test_result_t;
+/* ================================ [ DECLARES  ] ============================================== */
+static BufReq_ReturnType test_ecu_copy_tx_data(PduIdType id, const PduInfoType *info,
+                                               const RetryInfoType *retry,
+                                               PduLengthType *availableDataPtr);
+static void test_ecu_tx_confirmation(PduIdType id, Std_ReturnType result);
+static Std_ReturnType test_doip_transmit(PduIdType id, const PduInfoType *PduInfoPtr);
+/* ================================ [ DATAS     ] ============================================== */
+static const PduR_ApiType testEcuApi = {
+  NULL, NULL, NULL, NULL, NULL, test_ecu_copy_tx_data, test_ecu_tx_confirmation,
+};
+
+static const PduR_ApiType testCanTpApi = {
+  PduR_CanTpGwStartOfReception,
+  PduR_CanTpGwCopyRxData,
+  PduR_CanTpGwRxIndication,
+  NULL,
+  CanTp_Transmit,
+  PduR_CanTpGwCopyTxData,
+  PduR_CanTpGwTxConfirmation,
+};
+
+static const PduR_ApiType testDoIPApi = {
+  PduR_DoIPGwStartOfReception, PduR_DoIPGwCopyRxData, PduR_DoIPGwRxIndication, NULL,
+  test_doip_transmit,          PduR_DoIPGwCopyTxData, PduR_DoIPGwTxConfirmation,
+};
+
+static const PduR_PduType testEcuPdu = {PDUR_MODULE_COM, 0, &testEcuApi};
+static const PduR_PduType testEcuCanTpPdu = {PDUR_MODULE_CANTP, TEST_CH_ECU, &testCanTpApi};
+static const PduR_PduType testGwCanTpPdu = {PDUR_MODULE_CANTP, TEST_CH_GW, &testCanTpApi};
+static const PduR_PduType testDoIPPdu = {PDUR_MODULE_DOIP, TEST_PATH_GW, &testDoIPApi};
+
+static uint8_t testGwBuffer[PDUR_TEST_MAX_SDU];
+static PduR_BufferType testBuffer;
+
+static PduR_RoutingPathType testRoutingPaths[] = {
+  {&testEcuPdu, &testEcuCanTpPdu, NULL, NULL, 0, 0, 1},
+  {&testGwCanTpPdu, &testDoIPPdu, &testBuffer, testGwBuffer, 0, 0, 1},
+};
+
+const PduR_ConfigType PduR_Config = {
+  testRoutingPaths,
+  ARRAY_SIZE(testRoutingPaths),
+};
+
+static uint8_t testCanTpData[2][64];
+static const CanTp_ChannelConfigType testCanTpChannelConfigs[] = {
+  {testCanTpData[TEST_CH_ECU], CANTP_STANDARD, TEST_CH_ECU, TEST_PATH_ECU, TEST_PATH_ECU,
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), CANTP_CONVERT_MS_TO_MAIN_CYCLES(100),
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), 0, 0, 0, 8, 8, 0x55, CANTP_PHYSICAL},
+  {testCanTpData[TEST_CH_GW], CANTP_STANDARD, TEST_CH_GW, TEST_PATH_GW, TEST_PATH_GW,
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), CANTP_CONVERT_MS_TO_MAIN_CYCLES(100),
+   CANTP_CONVERT_MS_TO_MAIN_CYCLES(100), 0, 8, 0, 200, 8, 0x55, CANTP_PHYSICAL},
+};
+static CanTp_ChannelContextType testCanTpChannelContexts[ARRAY_SIZE(testCanTpChannelConfigs)];
+const CanTp_ConfigType CanTp_Config = {
+  testCanTpChannelConfigs,
+  testCanTpChannelContexts,
+  ARRAY_SIZE(testCanTpChannelConfigs),
+};
+
+static test_frame_t testFrames[TEST_MAX_FRAMES];
+static uint32_t testFrameIn;
+static uint32_t testFrameOut;
+
+static uint8_t testDoIPOut[PDUR_TEST_MAX_SDU];
+static PduLengthType testDoIPTotal;
+static PduLengthType testDoIPOffset;
+static boolean testDoIPActive;
+static boolean testEcuDone;
+
+static uint32_t testTick;
+static test_result_t testResult;
+
+static PduLengthType testSduLength;
+static uint32_t testDoIPRate; /* bytes per cycle the DoIP socket accepts */
+/* ================================ [ LOCALS    ] ============================================== */
+static uint8_t test_pattern(PduLengthType offset) {
+  return (uint8_t)((offset * 7u) + 3u);
+}
+
+static BufReq_ReturnType test_ecu_copy_tx_data(PduIdType id, const PduInfoType *info,
+                                               const RetryInfoType *retry,
+                                               PduLengthType *availableDataPtr) {
+  PduLengthType offset = *((PduLengthType *)info->MetaDataPtr);
+  PduLengthType i;
+  (void)id;
+  (void)retry;
+  for (i = 0; i < info->SduLength; i++) {
+    info->SduDataPtr[i] = test_pattern(offset + i);
+  }
+  *availableDataPtr = testSduLength - offset - info->SduLength;
+  return BUFREQ_OK;
+}
+
+static void test_ecu_tx_confirmation(PduIdType id, Std_ReturnType result) {
+  (void)id;
+  testEcuDone = (E_OK == result);
+}
+
+static Std_ReturnType test_doip_transmit(PduIdType id, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  if ((TEST_PATH_GW == id) && (FALSE == testDoIPActive) &&
+      (PduInfoPtr->SduLength <= sizeof(testDoIPOut))) {
+    testDoIPTotal = PduInfoPtr->SduLength;
+    testDoIPOffset = 0;
+    testDoIPActive = TRUE;
+    ret = E_OK;
+  }
+  return ret;
+}
+
+/* the DoIP socket takes at most testDoIPRate bytes per cycle, pull what the gateway has */
+static void test_doip_main_function(void) {
+  PduInfoType PduInfo;
+  PduLengthType offset;
+  PduLengthType left = 0;
+  BufReq_ReturnType bret;
+
+  if (TRUE == testDoIPActive) {
+    offset = testDoIPOffset;
+    PduInfo.SduDataPtr = &testDoIPOut[offset];
+    PduInfo.SduLength = testDoIPTotal - offset;
+    if (PduInfo.SduLength > testDoIPRate) {
+      PduInfo.SduLength = (PduLengthType)testDoIPRate;
+    }
+    PduInfo.MetaDataPtr = (uint8_t *)&offset;
+    bret = PduR_DoIPCopyTxData(TEST_PATH_GW, &PduInfo, NULL, &left);
+    if ((BUFREQ_E_BUSY == bret) && (left > 0u) && (left < PduInfo.SduLength)) {
+      PduInfo.SduLength = left;
+      bret = PduR_DoIPCopyTxData(TEST_PATH_GW, &PduInfo, NULL, &left);
+    }
+    if (BUFREQ_OK == bret) {
+      if (0u == testDoIPOffset) {
+        testResult.firstTick = testTick;
+      }
+      testDoIPOffset += PduInfo.SduLength;
+      if (testDoIPOffset >= testDoIPTotal) {
+        testResult.lastTick = testTick;
+        testDoIPActive = FALSE;
+        PduR_DoIPTxConfirmation(TEST_PATH_GW, E_OK);
+      }
+    } else if (BUFREQ_E_BUSY != bret) {
+      testDoIPActive = FALSE;
+      PduR_DoIPTxConfirmation(TEST_PATH_GW, E_NOT_OK);
+    }
+  }
+}
+
+/* the CAN bus delivers at most TEST_BUS_RATE frames per cycle, the ECU and the gateway face each
+ * other */
+static void test_can_main_function(void) {
+  uint32_t n = 0;
+  test_frame_t *frame;
+  PduInfoType PduInfo;
+  PduLengthType inUse;
+
+  while ((testFrameOut != testFrameIn) && (n < TEST_BUS_RATE)) {
+    frame = &testFrames[testFrameOut % TEST_MAX_FRAMES];
+    PduInfo.SduDataPtr = frame->data;
+    PduInfo.SduLength = frame->length;
+    PduInfo.MetaDataPtr = NULL;
+    if (TEST_CH_ECU == frame->CanIfTxPduId) {
+      if (0x10u == (frame->data[0] & 0xF0u)) {
+        testResult.ffTick = testTick;
+      } else {
+        testResult.lastCfTick = testTick;
+      }
+      CanTp_RxIndication(TEST_CH_GW, &PduInfo);
+    } else {
+      if (0x30u == (frame->data[0] & 0xF0u)) {
+        testResult.numFC++;
+        if (0x01u == (frame->data[0] & 0x0Fu)) {
+          testResult.numWT++;
+        }
+      }
+      CanTp_RxIndication(TEST_CH_ECU, &PduInfo);
+    }
+    testFrameOut++;
+    n++;
+  }
+
+  if (NULL != testBuffer.data) {
+    inUse = testBuffer.index - testBuffer.txIndex;
+    if (PDUR_GW_STORE_AND_FORWARD == testBuffer.state) {
+      inUse = testBuffer.index;
+    }
+    if (inUse > testResult.maxInUse) {
+      testResult.maxInUse = inUse;
+    }
+  }
+}
+
+static void test_run(PduLengthType sduLength, PduLengthType threshold, PduLengthType ringSize,
+                     uint32_t doipRate) {
+  PduInfoType PduInfo;
+  PduLengthType i;
+
+  memset(&testResult, 0, sizeof(testResult));
+  memset(&testBuffer, 0, sizeof(testBuffer));
+  memset(testDoIPOut, 0, sizeof(testDoIPOut));
+  testFrameIn = testFrameOut = 0;
+  testDoIPActive = FALSE;
+  testDoIPOffset = 0;
+  testEcuDone = FALSE;
+  testTick = 0;
+  testSduLength = sduLength;
+  testDoIPRate = doipRate;
+  testRoutingPaths[TEST_PATH_GW].TpThreshold = threshold;
+  testRoutingPaths[TEST_PATH_GW].GwBufferSize = ringSize;
+
+  PduR_Init(NULL);
+  CanTp_Init(NULL);
+
+  PduInfo.SduDataPtr = NULL;
+  PduInfo.SduLength = sduLength;
+  PduInfo.MetaDataPtr = NULL;
+  if (E_OK == CanTp_Transmit(TEST_CH_ECU, &PduInfo)) {
+    for (testTick = 1; testTick < TEST_MAX_TICKS; testTick++) {
+      test_can_main_function();
+      CanTp_MainFunction_Fast();
+      test_doip_main_function();
+      if ((TRUE == testEcuDone) && (testResult.lastTick > 0u)) {
+        break;
+      }
+    }
+  }
+
+  testResult.ok = (TRUE == testEcuDone) && (testResult.lastTick > 0u) &&
+                  (testDoIPOffset == sduLength);
+  for (i = 0; (i < sduLength) && testResult.ok; i++) {
+    if (testDoIPOut[i] != test_pattern(i)) {
+      testResult.ok = false;
+    }
+  }
+}
+
+static void test_report(bool bPass, PduLengthType sduLength, PduLengthType threshold,
+                        PduLengthType ringSize, uint32_t doipRate) {
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u bytes, threshold %u, ring %u, DoIP %u bytes/ms: data %s, first byte %u ms and "
+           "last byte %u ms after the FF, last CF %u ms after the FF, FC %u (WT %u), max buffered "
+           "%u\n",
+           (uint32_t)sduLength, (uint32_t)threshold, (uint32_t)ringSize, doipRate,
+           testResult.ok ? "ok" : "wrong", testResult.firstTick - testResult.ffTick,
+           testResult.lastTick - testResult.ffTick, testResult.lastCfTick - testResult.ffTick,
+           testResult.numFC, testResult.numWT, (uint32_t)testResult.maxInUse);
+    exit(-1);
+  }
+}
+
+static void Test_StoreAndForward(void) {
+  bool bPass;
+
+  printf("Test store-and-forward starts DoIP after the last CF:");
+  test_run(PDUR_TEST_MAX_SDU, 0, PDUR_TEST_MAX_SDU, 1460);
+  bPass = testResult.ok && (testResult.firstTick >= testResult.lastCfTick) &&
+          (0u == testResult.numWT);
+  test_report(bPass, PDUR_TEST_MAX_SDU, 0, PDUR_TEST_MAX_SDU, 1460);
+}
+
+static void Test_OnTheFly(void) {
+  uint32_t cfTicks;
+  bool bPass;
+
+  printf("Test on-the-fly starts DoIP after the TpThreshold:");
+  test_run(PDUR_TEST_MAX_SDU, TEST_THRESHOLD, 512, 1460);
+  cfTicks = testResult.lastCfTick - testResult.ffTick;
+  /* the first byte goes out within the first CF block, the last one right after the last CF */
+  bPass = testResult.ok && ((testResult.firstTick - testResult.ffTick) < (cfTicks / 10u)) &&
+          ((testResult.lastTick - testResult.lastCfTick) <= 1u) && (0u == testResult.numWT) &&
+          (testResult.maxInUse <= 512u);
+  test_report(bPass, PDUR_TEST_MAX_SDU, TEST_THRESHOLD, 512, 1460);
+}
+
+static void Test_BackPressure(void) {
+  bool bPass;
+
+  printf("Test on-the-fly holds the CAN sender with FC WAIT when the ring is full:");
+  test_run(PDUR_TEST_MAX_SDU, TEST_THRESHOLD, 256, 2);
+  /* the DoIP side is the bottleneck, 2 bytes per ms */
+  bPass = testResult.ok && (testResult.numWT > 0u) && (testResult.maxInUse <= 256u) &&
+          ((testResult.lastTick - testResult.firstTick) <= (PDUR_TEST_MAX_SDU / 2u + 8u));
+  test_report(bPass, PDUR_TEST_MAX_SDU, TEST_THRESHOLD, 256, 2);
+}
+
+static void Test_Random(void) {
+  uint32_t round;
+  PduLengthType sduLength = 0;
+  PduLengthType ringSize = 0;
+  uint32_t doipRate = 0;
+  bool bPass = true;
+
+  printf("Test %u random message sizes, ring sizes and DoIP rates:", TEST_RANDOM_ROUNDS);
+  for (round = 0; (round < TEST_RANDOM_ROUNDS) && bPass; round++) {
+    sduLength = (PduLengthType)(8u + ((uint32_t)rand() % (PDUR_TEST_MAX_SDU - 7u)));
+    ringSize = (PduLengthType)(2u * TEST_THRESHOLD + ((uint32_t)rand() % 1024u));
+    doipRate = 2u + ((uint32_t)rand() % 1459u);
+    test_run(sduLength, TEST_THRESHOLD, ringSize, doipRate);
+    bPass = testResult.ok && (testResult.maxInUse <= ringSize);
+  }
+  test_report(bPass, sduLength, TEST_THRESHOLD, ringSize, doipRate);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  test_frame_t *frame;
+
+  if (((testFrameIn - testFrameOut) < TEST_MAX_FRAMES) &&
+      (PduInfoPtr->SduLength <= sizeof(frame->data))) {
+    frame = &testFrames[testFrameIn % TEST_MAX_FRAMES];
+    frame->CanIfTxPduId = TxPduId;
+    frame->length = PduInfoPtr->SduLength;
+    memcpy(frame->data, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+    testFrameIn++;
+    ret = E_OK;
+  }
+
+  return ret;
+}
+
+uint32_t CanIf_CanTpGetTxCanId(uint8_t Channel) {
+  return 0x731u + Channel;
+}
+
+uint32_t CanIf_CanTpGetRxCanId(uint8_t Channel) {
+  return 0x732u - Channel;
+}
+
+int main(int argc, char *argv[]) {
+  srand(1);
+
+  Test_StoreAndForward();
+  Test_OnTheFly();
+  Test_BackPressure();
+  Test_Random();
+
+  return 0;
+}
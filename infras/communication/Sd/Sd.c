@@ -98,6 +98,32 @@
 #define SD_SUBSCRIBE_EVENT_GROUP_ACK 0x07u
 #define SD_SUBSCRIBE_EVENT_GROUP_NACK 0x07u
 
+/* open addressing table of the (service, instance, event group) keys, must be a power of 2 */
+#ifndef SD_SERVICE_INDEX_SIZE
+#define SD_SERVICE_INDEX_SIZE 64u
+#endif
+#define SD_SERVICE_INDEX_MASK (SD_SERVICE_INDEX_SIZE - 1u)
+
+#define SD_INDEX_EMPTY 0u
+#define SD_INDEX_SERVER_SERVICE 1u
+#define SD_INDEX_CLIENT_SERVICE 2u
+#define SD_INDEX_EVENT_HANDLER 3u
+#define SD_INDEX_CONSUMED_EVENT_GROUP 4u
+
+#define SD_SUBSCRIBER_NONE 0xFFFFu
+
+/* distinct options and entries of one SD message under construction */
+#ifndef SD_MSG_OPTIONS_MAX
+#define SD_MSG_OPTIONS_MAX 16u
+#endif
+
+#ifndef SD_MSG_ENTRIES_MAX
+#define SD_MSG_ENTRIES_MAX 64u
+#endif
+
+#define SD_ENTRY_SIZE 16u
+#define SD_OPTION_IPV4_SIZE 12u
+
 #ifdef USE_PCAP
 #define PCAP_TRACE PCap_SD
 #else
@@ -240,17 +266,64 @@ typedef struct {
   TcpIp_ProtocolType ProtocolType;
   TcpIp_SockAddrType Addr;
 } Sd_OptionIPv4Type;
+
+typedef struct {
+  uint16_t serviceId;
+  uint16_t instanceId;
+  uint16_t eventGroupId;
+  uint16_t index;    /* of the server or client service in the instance */
+  uint16_t subIndex; /* of the event handler or consumed event group in the service */
+  uint8_t kind;
+  uint8_t instance;
+} Sd_IndexEntryType;
+
+/* One SD message under construction: the entries are appended in place to the instance buffer,
+ * the options are collected de-duplicated and placed behind the entries when flushed. */
+typedef struct {
+  const Sd_InstanceType *Instance;
+  TcpIp_SockAddrType RemoteAddr;
+  PduIdType TxPduId;
+  boolean isBound;
+  boolean isUnicast;
+  boolean isTxFailed;
+  uint8_t numOfEntries;
+  uint8_t numOfOptions;
+  uint16_t numOfMsgs;
+  uint32_t lengthOfEntries;
+  uint8_t options[SD_MSG_OPTIONS_MAX][SD_OPTION_IPV4_SIZE];
+  /* the pending flags cleared by the entries, restored if the message failed to be sent */
+  uint8_t *pendingFlags[SD_MSG_ENTRIES_MAX];
+  uint8_t pendingMasks[SD_MSG_ENTRIES_MAX];
+} Sd_MessageType;
 /* ================================ [ DECLARES  ] ============================================== */
 extern const Sd_ConfigType Sd_Config;
 
 static void Sd_InitClientServiceConsumedEventGroups(const Sd_ClientServiceType *config,
                                                     boolean soft);
 
+static void Sd_ServerServiceEventGroupAckFlush(Sd_MessageType *msg);
+
 extern Std_ReturnType SomeIp_ResolveSubscriber(uint16_t ServiceId,
                                                Sd_EventHandlerSubscriberType *sub);
 /* ================================ [ DATAS     ] ============================================== */
 DEF_SQP(EventHandlerSubscriber, SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE)
 
+/* subscribers hashed by (event handler, remote endpoint), chained by slot index */
+static uint16_t sdSubscriberBuckets[SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE];
+static uint16_t sdSubscriberNext[SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE];
+static const Sd_EventHandlerType *sdSubscriberOwner[SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE];
+static const Sd_ServerServiceType *sdSubscriberService[SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE];
+
+/* slots of the subscribers with an ACK pending, kept until the ACK is known to be sent */
+static uint16_t sdPendingAcks[SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE];
+static boolean sdIsAckQueued[SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE];
+static uint16_t sdNumOfPendingAcks = 0u;
+
+static Sd_IndexEntryType sdServiceIndex[SD_SERVICE_INDEX_SIZE];
+static boolean sdServiceIndexOverflow = FALSE;
+
+static Sd_MessageType sdMessage;
+
 static const Sd_ConfigType *sdConfigPtr = NULL;
 /* ================================ [ LOCALS    ] ============================================== */
 static uint16_t Sd_RandTime(uint16_t min, uint16_t max) {
@@ -607,36 +680,392 @@ static Std_ReturnType Sd_Transmit(PduIdType TxPduId, uint8_t *data, uint32_t len
   return ret;
 }
 
-static Std_ReturnType Sd_HandleFindService(const Sd_InstanceType *Instance,
-                                           const TcpIp_SockAddrType *RemoteAddr,
-                                           const Sd_EntryType1Type *entry1) {
-  Std_ReturnType ret = E_NOT_OK;
+static uint32_t Sd_IndexHash(uint8_t kind, uint8_t instance, uint16_t serviceId,
+                             uint16_t instanceId, uint16_t eventGroupId) {
+  uint32_t key = ((uint32_t)serviceId << 16) | instanceId;
+
+  key ^= ((uint32_t)eventGroupId << 7) ^ ((uint32_t)instance << 24) ^ ((uint32_t)kind << 29);
+  key *= 0x9E3779B1u; /* Fibonacci hashing, the high bits are the well mixed ones */
+
+  return key >> 16;
+}
+
+static void Sd_IndexAdd(uint8_t kind, uint8_t instance, uint16_t serviceId, uint16_t instanceId,
+                        uint16_t eventGroupId, uint16_t index, uint16_t subIndex) {
+  uint32_t slot = Sd_IndexHash(kind, instance, serviceId, instanceId, eventGroupId);
+  Sd_IndexEntryType *entry = NULL;
+  uint32_t i;
+
+  for (i = 0u; (i < SD_SERVICE_INDEX_SIZE) && (NULL == entry); i++) {
+    slot &= SD_SERVICE_INDEX_MASK;
+    if (SD_INDEX_EMPTY == sdServiceIndex[slot].kind) {
+      entry = &sdServiceIndex[slot];
+    }
+    slot++;
+  }
+
+  if (NULL != entry) {
+    entry->serviceId = serviceId;
+    entry->instanceId = instanceId;
+    entry->eventGroupId = eventGroupId;
+    entry->index = index;
+    entry->subIndex = subIndex;
+    entry->kind = kind;
+    entry->instance = instance;
+  } else {
+    sdServiceIndexOverflow = TRUE;
+  }
+}
+
+static void Sd_IndexBuild(void) {
   uint16_t i;
-  TcpIp_SockAddrType LocalAddr;
-  const Sd_ServerServiceType *config;
-  Sd_ServerServiceContextType *context;
+  uint16_t j;
+  uint16_t k;
+  const Sd_InstanceType *Instance;
+  const Sd_ServerServiceType *server;
+  const Sd_ClientServiceType *client;
 
-  for (i = 0u; i < Instance->numOfServerServices; i++) {
-    config = &Instance->ServerServices[i];
-    context = config->context;
-    if ((config->ServiceId == entry1->serviceId) || (config->InstanceId == entry1->instanceId)) {
-      ret = E_OK;
+  (void)memset(sdServiceIndex, 0u, sizeof(sdServiceIndex));
+  sdServiceIndexOverflow = FALSE;
+  for (i = 0u; i < SD_CONFIG->numOfInstances; i++) {
+    Instance = &SD_CONFIG->Instances[i];
+    for (j = 0u; j < Instance->numOfServerServices; j++) {
+      server = &Instance->ServerServices[j];
+      Sd_IndexAdd(SD_INDEX_SERVER_SERVICE, (uint8_t)i, server->ServiceId, server->InstanceId, 0u, j,
+                  0u);
+      for (k = 0u; k < server->numOfEventHandlers; k++) {
+        Sd_IndexAdd(SD_INDEX_EVENT_HANDLER, (uint8_t)i, server->ServiceId, server->InstanceId,
+                    server->EventHandlers[k].EventGroupId, j, k);
+      }
+    }
+    for (j = 0u; j < Instance->numOfClientServices; j++) {
+      client = &Instance->ClientServices[j];
+      Sd_IndexAdd(SD_INDEX_CLIENT_SERVICE, (uint8_t)i, client->ServiceId, client->InstanceId, 0u, j,
+                  0u);
+      for (k = 0u; k < client->numOfConsumedEventGroups; k++) {
+        Sd_IndexAdd(SD_INDEX_CONSUMED_EVENT_GROUP, (uint8_t)i, client->ServiceId,
+                    client->InstanceId, client->ConsumedEventGroups[k].EventGroupId, j, k);
+      }
+    }
+  }
+
+  if (TRUE == sdServiceIndexOverflow) {
+    ASLOG(SDE, ("SD_SERVICE_INDEX_SIZE %u too small, fall back to linear search\n",
+                (uint32_t)SD_SERVICE_INDEX_SIZE));
+  }
+}
+
+/* the linear search used when the index is too small to hold all the keys */
+static const Sd_IndexEntryType *Sd_IndexScan(const Sd_InstanceType *Instance, uint8_t kind,
+                                             uint16_t serviceId, uint16_t instanceId,
+                                             uint16_t eventGroupId) {
+  static Sd_IndexEntryType scanned;
+  const Sd_IndexEntryType *entry = NULL;
+  const Sd_ServerServiceType *server;
+  const Sd_ClientServiceType *client;
+  uint16_t i;
+  uint16_t j;
+
+  scanned.kind = kind;
+  scanned.subIndex = 0u;
+  if ((SD_INDEX_SERVER_SERVICE == kind) || (SD_INDEX_EVENT_HANDLER == kind)) {
+    for (i = 0u; (i < Instance->numOfServerServices) && (NULL == entry); i++) {
+      server = &Instance->ServerServices[i];
+      if ((server->ServiceId == serviceId) && (server->InstanceId == instanceId)) {
+        scanned.index = i;
+        if (SD_INDEX_SERVER_SERVICE == kind) {
+          entry = &scanned;
+        }
+        for (j = 0u; (j < server->numOfEventHandlers) && (NULL == entry); j++) {
+          if (server->EventHandlers[j].EventGroupId == eventGroupId) {
+            scanned.subIndex = j;
+            entry = &scanned;
+          }
+        }
+      }
+    }
+  } else {
+    for (i = 0u; (i < Instance->numOfClientServices) && (NULL == entry); i++) {
+      client = &Instance->ClientServices[i];
+      if ((client->ServiceId == serviceId) && (client->InstanceId == instanceId)) {
+        scanned.index = i;
+        if (SD_INDEX_CLIENT_SERVICE == kind) {
+          entry = &scanned;
+        }
+        for (j = 0u; (j < client->numOfConsumedEventGroups) && (NULL == entry); j++) {
+          if (client->ConsumedEventGroups[j].EventGroupId == eventGroupId) {
+            scanned.subIndex = j;
+            entry = &scanned;
+          }
+        }
+      }
+    }
+  }
+
+  return entry;
+}
+
+static const Sd_IndexEntryType *Sd_IndexLookup(const Sd_InstanceType *Instance, uint8_t kind,
+                                               uint16_t serviceId, uint16_t instanceId,
+                                               uint16_t eventGroupId) {
+  uint8_t instance = (uint8_t)(Instance - SD_CONFIG->Instances);
+  uint32_t slot = Sd_IndexHash(kind, instance, serviceId, instanceId, eventGroupId);
+  const Sd_IndexEntryType *entry = NULL;
+  const Sd_IndexEntryType *var;
+  uint32_t i;
+
+  for (i = 0u; i < SD_SERVICE_INDEX_SIZE; i++) {
+    var = &sdServiceIndex[slot & SD_SERVICE_INDEX_MASK];
+    if (SD_INDEX_EMPTY == var->kind) {
+      break;
+    }
+    if ((var->kind == kind) && (var->instance == instance) && (var->serviceId == serviceId) &&
+        (var->instanceId == instanceId) && (var->eventGroupId == eventGroupId)) {
+      entry = var;
       break;
     }
+    slot++;
   }
 
-  if (E_OK == ret) {
-    if ((config->MajorVersion != SD_ANY_MAJOR_VERSION) && (entry1->major != SD_ANY_MAJOR_VERSION) &&
-        (config->MajorVersion != entry1->major)) {
-      ASLOG(SDE, ("major version not matched: %u != %u\n", config->MajorVersion, entry1->major));
-      ret = E_NOT_OK;
-    } else if ((config->MinorVersion != SD_ANY_MINOR_VERSION) &&
-               (entry1->minor != SD_ANY_MINOR_VERSION) && (config->MinorVersion != entry1->minor)) {
-      ASLOG(SDE, ("minor version not matched: %du != %u\n", config->MinorVersion, entry1->minor));
-      ret = E_NOT_OK;
+  if ((NULL == entry) && (TRUE == sdServiceIndexOverflow)) {
+    entry = Sd_IndexScan(Instance, kind, serviceId, instanceId, eventGroupId);
+  }
+
+  return entry;
+}
+
+static const Sd_ServerServiceType *Sd_LookupServerService(const Sd_InstanceType *Instance,
+                                                          uint16_t serviceId,
+                                                          uint16_t instanceId) {
+  const Sd_ServerServiceType *config = NULL;
+  const Sd_IndexEntryType *entry;
+
+  entry = Sd_IndexLookup(Instance, SD_INDEX_SERVER_SERVICE, serviceId, instanceId, 0u);
+  if (NULL != entry) {
+    config = &Instance->ServerServices[entry->index];
+  }
+
+  return config;
+}
+
+static const Sd_ClientServiceType *Sd_LookupClientService(const Sd_InstanceType *Instance,
+                                                          uint16_t serviceId,
+                                                          uint16_t instanceId) {
+  const Sd_ClientServiceType *config = NULL;
+  const Sd_IndexEntryType *entry;
+
+  entry = Sd_IndexLookup(Instance, SD_INDEX_CLIENT_SERVICE, serviceId, instanceId, 0u);
+  if (NULL == entry) { /* client service which requires any instance */
+    entry = Sd_IndexLookup(Instance, SD_INDEX_CLIENT_SERVICE, serviceId, SD_ANY_INSTANCE_ID, 0u);
+  }
+  if (NULL != entry) {
+    config = &Instance->ClientServices[entry->index];
+  }
+
+  return config;
+}
+
+static const Sd_EventHandlerType *Sd_LookupEventHandler(const Sd_InstanceType *Instance,
+                                                        const Sd_EntryType2Type *entry2,
+                                                        const Sd_ServerServiceType **config) {
+  const Sd_EventHandlerType *EventHandler = NULL;
+  const Sd_IndexEntryType *entry;
+
+  entry = Sd_IndexLookup(Instance, SD_INDEX_EVENT_HANDLER, entry2->serviceId, entry2->instanceId,
+                         entry2->eventGroupId);
+  if (NULL != entry) {
+    *config = &Instance->ServerServices[entry->index];
+    EventHandler = &(*config)->EventHandlers[entry->subIndex];
+  }
+
+  return EventHandler;
+}
+
+static const Sd_ConsumedEventGroupType *
+Sd_LookupConsumedEventGroup(const Sd_InstanceType *Instance, const Sd_EntryType2Type *entry2) {
+  const Sd_ConsumedEventGroupType *ConsumedEventGroup = NULL;
+  const Sd_IndexEntryType *entry;
+
+  entry = Sd_IndexLookup(Instance, SD_INDEX_CONSUMED_EVENT_GROUP, entry2->serviceId,
+                         entry2->instanceId, entry2->eventGroupId);
+  if (NULL == entry) {
+    entry = Sd_IndexLookup(Instance, SD_INDEX_CONSUMED_EVENT_GROUP, entry2->serviceId,
+                           SD_ANY_INSTANCE_ID, entry2->eventGroupId);
+  }
+  if (NULL != entry) {
+    ConsumedEventGroup =
+      &Instance->ClientServices[entry->index].ConsumedEventGroups[entry->subIndex];
+  }
+
+  return ConsumedEventGroup;
+}
+
+static void Sd_MsgInit(Sd_MessageType *msg, const Sd_InstanceType *Instance) {
+  msg->Instance = Instance;
+  msg->isBound = FALSE;
+  msg->isTxFailed = FALSE;
+  msg->numOfMsgs = 0u;
+  msg->numOfEntries = 0u;
+  msg->numOfOptions = 0u;
+  msg->lengthOfEntries = 0u;
+}
+
+/* An empty message is bound to the destination of its first entry, the following entries must go
+ * to the same destination, RemoteAddr NULL means the default remote of the TxPduId. */
+static boolean Sd_MsgBind(Sd_MessageType *msg, PduIdType TxPduId,
+                          const TcpIp_SockAddrType *RemoteAddr) {
+  boolean ret = FALSE;
+
+  if (FALSE == msg->isBound) {
+    msg->isBound = TRUE;
+    msg->TxPduId = TxPduId;
+    if (NULL != RemoteAddr) {
+      msg->RemoteAddr = *RemoteAddr;
+      msg->isUnicast = TRUE;
     } else {
-      /* version okay */
+      msg->isUnicast = FALSE;
+    }
+    ret = TRUE;
+  } else if (TxPduId == msg->TxPduId) {
+    if (NULL == RemoteAddr) {
+      ret = (FALSE == msg->isUnicast);
+    } else if (TRUE == msg->isUnicast) {
+      ret = (0 == memcmp(&msg->RemoteAddr, RemoteAddr, sizeof(TcpIp_SockAddrType)));
+    } else {
+      /* multicast message */
+    }
+  } else {
+    /* other PDU */
+  }
+
+  return ret;
+}
+
+/* Append the entry and its optional IPv4 option, an option identical to one already carried by the
+ * message is referenced instead of being added again. E_NOT_OK if the message is full. */
+static Std_ReturnType Sd_MsgAppend(Sd_MessageType *msg, const uint8_t *entry,
+                                   const uint8_t *option, uint8_t *flags, uint8_t mask) {
+  Std_ReturnType ret = E_NOT_OK;
+  uint8_t *data;
+  uint8_t index = 0u;
+  uint8_t numOfOptions = msg->numOfOptions;
+
+  if (NULL != option) {
+    while ((index < msg->numOfOptions) &&
+           (0 != memcmp(msg->options[index], option, SD_OPTION_IPV4_SIZE))) {
+      index++;
+    }
+    if (index == msg->numOfOptions) {
+      numOfOptions++;
+    }
+  }
+
+  if ((msg->numOfEntries < SD_MSG_ENTRIES_MAX) && (numOfOptions <= SD_MSG_OPTIONS_MAX) &&
+      ((28u + msg->lengthOfEntries + SD_ENTRY_SIZE + (SD_OPTION_IPV4_SIZE * numOfOptions)) <=
+       msg->Instance->bufLen)) {
+    data = &msg->Instance->buffer[24u + msg->lengthOfEntries];
+    (void)memcpy(data, entry, SD_ENTRY_SIZE);
+    if (NULL != option) {
+      if (index == msg->numOfOptions) {
+        (void)memcpy(msg->options[index], option, SD_OPTION_IPV4_SIZE);
+        msg->numOfOptions = numOfOptions;
+      }
+      data[1] = index;
+      data[3] = (1u << 4) | (data[3] & 0x0Fu);
     }
+    msg->pendingFlags[msg->numOfEntries] = flags;
+    msg->pendingMasks[msg->numOfEntries] = mask;
+    msg->numOfEntries++;
+    msg->lengthOfEntries += SD_ENTRY_SIZE;
+    ret = E_OK;
+  }
+
+  return ret;
+}
+
+static Std_ReturnType Sd_MsgFlush(Sd_MessageType *msg) {
+  Std_ReturnType ret = E_OK;
+  const Sd_InstanceType *Instance = msg->Instance;
+  uint32_t offset;
+  uint8_t i;
+
+  if (msg->numOfEntries > 0u) {
+    offset = 28u + msg->lengthOfEntries;
+    for (i = 0u; i < msg->numOfOptions; i++) {
+      (void)memcpy(&Instance->buffer[offset], msg->options[i], SD_OPTION_IPV4_SIZE);
+      offset += SD_OPTION_IPV4_SIZE;
+    }
+    Sd_BuildHeader(Instance->buffer, Instance->context->flags,
+                   Instance->context->multicastSessionId, msg->lengthOfEntries,
+                   SD_OPTION_IPV4_SIZE * msg->numOfOptions);
+    Instance->context->multicastSessionId++;
+    if (0u == Instance->context->multicastSessionId) {
+      Instance->context->multicastSessionId = 1u;
+      Instance->context->flags &= ~SD_REBOOT_FLAG;
+    }
+    ret = Sd_Transmit(msg->TxPduId, Instance->buffer, offset,
+                      (TRUE == msg->isUnicast) ? &msg->RemoteAddr : NULL);
+    msg->numOfMsgs++;
+    if (E_OK != ret) { /* retry the entries next time */
+      for (i = 0u; i < msg->numOfEntries; i++) {
+        if (NULL != msg->pendingFlags[i]) {
+          SD_SET(*msg->pendingFlags[i], msg->pendingMasks[i]);
+        }
+      }
+      msg->isTxFailed = TRUE;
+    }
+  }
+
+  msg->isBound = FALSE;
+  msg->numOfEntries = 0u;
+  msg->numOfOptions = 0u;
+  msg->lengthOfEntries = 0u;
+
+  return ret;
+}
+
+/* Put the entry into the message, the message is sent out first if full. The pending flags of the
+ * entry are cleared if accepted, E_NOT_OK if the message is bound to another destination. */
+static Std_ReturnType Sd_MsgPut(Sd_MessageType *msg, PduIdType TxPduId,
+                                const TcpIp_SockAddrType *RemoteAddr, const uint8_t *entry,
+                                const uint8_t *option, uint8_t *flags, uint8_t mask) {
+  Std_ReturnType ret = E_NOT_OK;
+
+  if (TRUE == Sd_MsgBind(msg, TxPduId, RemoteAddr)) {
+    ret = Sd_MsgAppend(msg, entry, option, flags, mask);
+    if (E_OK != ret) {
+      (void)Sd_MsgFlush(msg);
+      (void)Sd_MsgBind(msg, TxPduId, RemoteAddr);
+      ret = Sd_MsgAppend(msg, entry, option, flags, mask);
+    }
+  }
+
+  if ((E_OK == ret) && (NULL != flags)) {
+    SD_CLEAR(*flags, mask);
+  }
+
+  return ret;
+}
+
+static Std_ReturnType Sd_ReplyFindService(Sd_MessageType *msg, const Sd_ServerServiceType *config,
+                                          const TcpIp_SockAddrType *RemoteAddr,
+                                          const Sd_EntryType1Type *entry1) {
+  Std_ReturnType ret = E_OK;
+  TcpIp_SockAddrType LocalAddr;
+  Sd_ServerServiceContextType *context = config->context;
+  uint8_t entry[SD_ENTRY_SIZE];
+  uint8_t option[SD_OPTION_IPV4_SIZE];
+
+  if ((config->MajorVersion != SD_ANY_MAJOR_VERSION) && (entry1->major != SD_ANY_MAJOR_VERSION) &&
+      (config->MajorVersion != entry1->major)) {
+    ASLOG(SDE, ("major version not matched: %u != %u\n", config->MajorVersion, entry1->major));
+    ret = E_NOT_OK;
+  } else if ((config->MinorVersion != SD_ANY_MINOR_VERSION) &&
+             (entry1->minor != SD_ANY_MINOR_VERSION) && (config->MinorVersion != entry1->minor)) {
+    ASLOG(SDE, ("minor version not matched: %du != %u\n", config->MinorVersion, entry1->minor));
+    ret = E_NOT_OK;
+  } else {
+    /* version okay */
   }
 
   if (E_OK == ret) {
@@ -648,19 +1077,12 @@ static Std_ReturnType Sd_HandleFindService(const Sd_InstanceType *Instance,
 
   if ((E_OK == ret) &&
       ((SD_PHASE_DOWN != context->phase) || (context->flags & SD_FLG_STATE_REQUEST_ONLINE))) {
-    Sd_BuildEntryType1(&Instance->buffer[24u], SD_OFFER_SERVICE, 0u, 0u, 1u, 0u, config->ServiceId,
+    Sd_BuildEntryType1(entry, SD_OFFER_SERVICE, 0u, 0u, 1u, 0u, config->ServiceId,
                        config->InstanceId, config->MajorVersion, config->MinorVersion,
                        config->ServerTimer->TTL);
     (void)SoAd_GetLocalAddr(config->SoConId, &LocalAddr, NULL, NULL);
-    Sd_BuildOptionIPv4Endpoint(&Instance->buffer[44u], &LocalAddr, config->ProtocolType);
-    Sd_BuildHeader(Instance->buffer, Instance->context->flags,
-                   Instance->context->multicastSessionId, 16u, 12u);
-    Instance->context->multicastSessionId++;
-    if (0u == Instance->context->multicastSessionId) {
-      Instance->context->multicastSessionId = 1u;
-      Instance->context->flags &= ~SD_REBOOT_FLAG;
-    }
-    ret = Sd_Transmit(Instance->TxPdu.UnicastTxPduId, Instance->buffer, 56u, RemoteAddr);
+    Sd_BuildOptionIPv4Endpoint(option, &LocalAddr, config->ProtocolType);
+    ret = Sd_MsgPut(msg, msg->Instance->TxPdu.UnicastTxPduId, RemoteAddr, entry, option, NULL, 0u);
     if (E_OK != ret) {
       ASLOG(SDE, ("response to find service failed\n"));
     }
@@ -669,23 +1091,46 @@ static Std_ReturnType Sd_HandleFindService(const Sd_InstanceType *Instance,
   return ret;
 }
 
+static Std_ReturnType Sd_HandleFindService(Sd_MessageType *msg,
+                                           const TcpIp_SockAddrType *RemoteAddr,
+                                           const Sd_EntryType1Type *entry1) {
+  Std_ReturnType ret = E_NOT_OK;
+  const Sd_InstanceType *Instance = msg->Instance;
+  const Sd_ServerServiceType *config;
+  uint16_t i;
+
+  if (SD_ANY_INSTANCE_ID == entry1->instanceId) { /* all the instances of the service */
+    for (i = 0u; i < Instance->numOfServerServices; i++) {
+      config = &Instance->ServerServices[i];
+      if (config->ServiceId == entry1->serviceId) {
+        if (E_OK == Sd_ReplyFindService(msg, config, RemoteAddr, entry1)) {
+          ret = E_OK;
+        }
+      }
+    }
+  } else {
+    config = Sd_LookupServerService(Instance, entry1->serviceId, entry1->instanceId);
+    if (NULL != config) {
+      ret = Sd_ReplyFindService(msg, config, RemoteAddr, entry1);
+    }
+  }
+
+  return ret;
+}
+
 static Std_ReturnType Sd_HandleOfferService(const Sd_InstanceType *Instance,
                                             const TcpIp_SockAddrType *RemoteAddr,
                                             Sd_HeaderType *header, const Sd_EntryType1Type *entry1,
                                             const Sd_OptionIPv4Type *ipv4Opt) {
   Std_ReturnType ret = E_NOT_OK;
-  uint16_t i;
   int result;
-
   const Sd_ClientServiceType *config;
-  Sd_ClientServiceContextType *context;
-  for (i = 0u; i < Instance->numOfClientServices; i++) {
-    config = &Instance->ClientServices[i];
+  Sd_ClientServiceContextType *context = NULL;
+
+  config = Sd_LookupClientService(Instance, entry1->serviceId, entry1->instanceId);
+  if (NULL != config) {
     context = config->context;
-    if ((config->ServiceId == entry1->serviceId) || (config->InstanceId == entry1->instanceId)) {
-      ret = E_OK;
-      break;
-    }
+    ret = E_OK;
   }
 
   if (E_OK == ret) {
@@ -767,74 +1212,135 @@ static Std_ReturnType Sd_HandleOfferService(const Sd_InstanceType *Instance,
   return ret;
 }
 
-static Std_ReturnType Sd_ResponseSubscribeEventGroup(const Sd_InstanceType *Instance,
-                                                     const Sd_ServerServiceType *config,
-                                                     const Sd_EventHandlerType *EventHandler,
-                                                     Sd_EventHandlerSubscriberType *sub) {
+static Std_ReturnType Sd_PutSubscribeEventGroupAck(Sd_MessageType *msg,
+                                                   const Sd_ServerServiceType *config,
+                                                   const Sd_EventHandlerType *EventHandler,
+                                                   Sd_EventHandlerSubscriberType *sub) {
+  const Sd_InstanceType *Instance = msg->Instance;
 #if (defined(_WIN32) || defined(linux)) && !defined(USE_LWIP)
 #else
   TcpIp_SockAddrType RemoteAddr;
 #endif
-  uint32_t lengthOfOptions = 0u;
-  uint8_t numOf1stOpt = 0u;
+  const uint8_t *option = NULL;
+  uint8_t entry[SD_ENTRY_SIZE];
+  uint8_t multicast[SD_OPTION_IPV4_SIZE];
+
   if (sub->TxPduId == EventHandler->MulticastTxPduId) {
-    Sd_BuildOptionIPv4Multicast(&Instance->buffer[44], &EventHandler->MulticastEventAddr,
-                                TCPIP_IPPROTO_UDP);
-    lengthOfOptions = 12u;
-    numOf1stOpt = 1u;
-  }
-  Sd_BuildEntryType2(&Instance->buffer[24], SD_SUBSCRIBE_EVENT_GROUP_ACK, 0u, 0u, numOf1stOpt, 0u,
-                     config->ServiceId, config->InstanceId, config->MajorVersion, 0u,
-                     EventHandler->EventGroupId, config->ServerTimer->TTL);
-  Sd_BuildHeader(Instance->buffer, Instance->context->flags, Instance->context->multicastSessionId,
-                 16u, lengthOfOptions);
-  Instance->context->multicastSessionId++;
-  if (0u == Instance->context->multicastSessionId) {
-    Instance->context->multicastSessionId = 1;
-    Instance->context->flags &= ~SD_REBOOT_FLAG;
+    Sd_BuildOptionIPv4Multicast(multicast, &EventHandler->MulticastEventAddr, TCPIP_IPPROTO_UDP);
+    option = multicast;
   }
+  Sd_BuildEntryType2(entry, SD_SUBSCRIBE_EVENT_GROUP_ACK, 0u, 0u, 0u, 0u, config->ServiceId,
+                     config->InstanceId, config->MajorVersion, 0u, EventHandler->EventGroupId,
+                     config->ServerTimer->TTL);
 #if (defined(_WIN32) || defined(linux)) && !defined(USE_LWIP)
-  return Sd_Transmit(Instance->TxPdu.MulticastTxPduId, Instance->buffer, 44u + lengthOfOptions,
-                     NULL);
+  return Sd_MsgPut(msg, Instance->TxPdu.MulticastTxPduId, NULL, entry, option, &sub->flags,
+                   SD_FLG_PENDING_EVENT_GROUP_ACK);
 #else
   RemoteAddr = sub->RemoteAddr;
   RemoteAddr.port = sub->port;
-  return Sd_Transmit(Instance->TxPdu.UnicastTxPduId, Instance->buffer, 44u + lengthOfOptions,
-                     &RemoteAddr);
+  return Sd_MsgPut(msg, Instance->TxPdu.UnicastTxPduId, &RemoteAddr, entry, option, &sub->flags,
+                   SD_FLG_PENDING_EVENT_GROUP_ACK);
 #endif
 }
 
-static uint16_t Sd_NumberOfSubscribes(const Sd_EventHandlerType *EventHandler) {
-  uint16_t numberOfSubscribes = 0u;
+static uint16_t Sd_SubscriberHash(const Sd_EventHandlerType *EventHandler,
+                                  const TcpIp_SockAddrType *RemoteAddr) {
+  uint32_t key = ((uint32_t)RemoteAddr->addr[0] << 24) + ((uint32_t)RemoteAddr->addr[1] << 16) +
+                 ((uint32_t)RemoteAddr->addr[2] << 8) + RemoteAddr->addr[3];
+
+  key ^= ((uint32_t)RemoteAddr->port << 16) ^ EventHandler->HandleId;
+  key *= 0x9E3779B1u;
+
+  return (uint16_t)((key >> 16) % SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE);
+}
+
+static void Sd_SubscriberIndexInit(void) {
+  uint16_t i;
+
+  for (i = 0u; i < SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE; i++) {
+    sdSubscriberBuckets[i] = SD_SUBSCRIBER_NONE;
+    sdSubscriberNext[i] = SD_SUBSCRIBER_NONE;
+    sdSubscriberOwner[i] = NULL;
+    sdSubscriberService[i] = NULL;
+    sdIsAckQueued[i] = FALSE;
+  }
+  sdNumOfPendingAcks = 0u;
+}
+
+static void Sd_SubscriberIndexAdd(const Sd_ServerServiceType *config,
+                                  const Sd_EventHandlerType *EventHandler,
+                                  Sd_EventHandlerSubscriberType *sub) {
+  uint16_t slot = (uint16_t)(sub - sdEventHandlerSubscriberSlots);
+  uint16_t bucket = Sd_SubscriberHash(EventHandler, &sub->RemoteAddr);
+
+  EnterCritical();
+  sdSubscriberOwner[slot] = EventHandler;
+  sdSubscriberService[slot] = config;
+  sdSubscriberNext[slot] = sdSubscriberBuckets[bucket];
+  sdSubscriberBuckets[bucket] = slot;
+  EventHandler->context->numOfSubscribers++;
+  ExitCritical();
+}
+
+/* unlink the subscriber from the event handler list and the index and free it */
+static void Sd_SubscriberRemove(const Sd_EventHandlerType *EventHandler,
+                                Sd_EventHandlerSubscriberType *var) {
   Sd_EventHandlerContextType *context = EventHandler->context;
-  DEC_SQP(EventHandlerSubscriber);
-  SQP_WHILE(EventHandlerSubscriber) {
-    numberOfSubscribes++;
+  uint16_t slot = (uint16_t)(var - sdEventHandlerSubscriberSlots);
+  uint16_t *link = &sdSubscriberBuckets[Sd_SubscriberHash(EventHandler, &var->RemoteAddr)];
+
+  EnterCritical();
+  while ((SD_SUBSCRIBER_NONE != *link) && (slot != *link)) {
+    link = &sdSubscriberNext[*link];
+  }
+  if (slot == *link) {
+    *link = sdSubscriberNext[slot];
+    sdSubscriberNext[slot] = SD_SUBSCRIBER_NONE;
+    sdSubscriberOwner[slot] = NULL;
+    sdSubscriberService[slot] = NULL;
+    context->numOfSubscribers--;
   }
-  SQP_WHILE_END()
+  ExitCritical();
+  SQP_CRM_AND_FREE(EventHandlerSubscriber, var);
+}
+
+static void Sd_SubscriberQueueAck(Sd_EventHandlerSubscriberType *sub) {
+  uint16_t slot = (uint16_t)(sub - sdEventHandlerSubscriberSlots);
 
-  return numberOfSubscribes;
+  EnterCritical();
+  sub->flags |= SD_FLG_PENDING_EVENT_GROUP_ACK;
+  if (FALSE == sdIsAckQueued[slot]) {
+    sdIsAckQueued[slot] = TRUE;
+    sdPendingAcks[sdNumOfPendingAcks] = slot;
+    sdNumOfPendingAcks++;
+  }
+  ExitCritical();
 }
 
 static Sd_EventHandlerSubscriberType *Sd_LookupSubscribe(const Sd_EventHandlerType *EventHandler,
                                                          const TcpIp_SockAddrType *RemoteAddr) {
   Sd_EventHandlerSubscriberType *sub = NULL;
-  Sd_EventHandlerContextType *context = EventHandler->context;
-  int result;
-  DEC_SQP(EventHandlerSubscriber);
-  SQP_WHILE(EventHandlerSubscriber) {
-    ASLOG(SDI, ("Exist subscriber(%p) %d.%d.%d.%d:%d for event group %x\n", var,
-                var->RemoteAddr.addr[0], var->RemoteAddr.addr[1], var->RemoteAddr.addr[2],
-                var->RemoteAddr.addr[3], var->RemoteAddr.port, EventHandler->EventGroupId));
-    result = memcmp(&var->RemoteAddr, RemoteAddr, sizeof(TcpIp_SockAddrType));
-    if (0 == result) {
+  Sd_EventHandlerSubscriberType *var;
+  uint16_t slot;
+
+  EnterCritical();
+  slot = sdSubscriberBuckets[Sd_SubscriberHash(EventHandler, RemoteAddr)];
+  while ((SD_SUBSCRIBER_NONE != slot) && (NULL == sub)) {
+    var = &sdEventHandlerSubscriberSlots[slot];
+    if ((EventHandler == sdSubscriberOwner[slot]) &&
+        (0 == memcmp(&var->RemoteAddr, RemoteAddr, sizeof(TcpIp_SockAddrType)))) {
       sub = var;
-      break;
+    } else {
+      slot = sdSubscriberNext[slot];
     }
   }
-  SQP_WHILE_END()
+  ExitCritical();
 
-  if (NULL == sub) {
+  if (NULL != sub) {
+    ASLOG(SDI, ("Exist subscriber(%p) %d.%d.%d.%d:%d for event group %x\n", sub,
+                sub->RemoteAddr.addr[0], sub->RemoteAddr.addr[1], sub->RemoteAddr.addr[2],
+                sub->RemoteAddr.addr[3], sub->RemoteAddr.port, EventHandler->EventGroupId));
+  } else {
     sub = SQP_ALLOC(EventHandlerSubscriber);
     if (NULL != sub) {
       (void)memset(sub, 0u, sizeof(Sd_EventHandlerSubscriberType));
@@ -852,34 +1358,18 @@ static Std_ReturnType Sd_HandleSubscribeEventGroup(const Sd_InstanceType *Instan
                                                    const Sd_EntryType2Type *entry2,
                                                    const Sd_OptionIPv4Type *ipv4Opt) {
   Std_ReturnType ret = E_NOT_OK;
-  uint16_t i;
-  const Sd_ServerServiceType *config;
+  const Sd_ServerServiceType *config = NULL;
   const Sd_EventHandlerType *EventHandler;
   Sd_EventHandlerSubscriberType *sub = NULL;
   Sd_EventHandlerContextType *context = NULL;
-  uint16_t numOfSubscribers;
 #if !defined(_WIN32)
   int result;
 #endif
 
-  for (i = 0u; i < Instance->numOfServerServices; i++) {
-    config = &Instance->ServerServices[i];
-    if ((config->ServiceId == entry2->serviceId) || (config->InstanceId == entry2->instanceId)) {
-      ret = E_OK;
-      break;
-    }
-  }
-
-  if (E_OK == ret) {
-    ret = E_NOT_OK;
-    for (i = 0u; i < config->numOfEventHandlers; i++) {
-      EventHandler = &config->EventHandlers[i];
-      if (EventHandler->EventGroupId == entry2->eventGroupId) {
-        context = EventHandler->context;
-        ret = E_OK;
-        break;
-      }
-    }
+  EventHandler = Sd_LookupEventHandler(Instance, entry2, &config);
+  if (NULL != EventHandler) {
+    context = EventHandler->context;
+    ret = E_OK;
   }
 
   if (E_OK == ret) {
@@ -911,10 +1401,9 @@ static Std_ReturnType Sd_HandleSubscribeEventGroup(const Sd_InstanceType *Instan
     if (entry2->TTL > 0u) {
       sub->RemoteAddr = ipv4Opt->Addr;
       sub->port = RemoteAddr->port;
-      numOfSubscribers = Sd_NumberOfSubscribes(EventHandler);
       /* @ECUC_SD_00097 */
       if ((0u == EventHandler->MulticastThreshold) ||
-          ((numOfSubscribers + 1u) < EventHandler->MulticastThreshold)) {
+          ((context->numOfSubscribers + 1u) < EventHandler->MulticastThreshold)) {
         ret = SomeIp_ResolveSubscriber(config->SomeIpServiceId, sub);
         if (E_OK != ret) {
           ASLOG(SDE, ("can't resolve subscriber %d.%d.%d.%d:%d\n", sub->RemoteAddr.addr[0],
@@ -922,13 +1411,21 @@ static Std_ReturnType Sd_HandleSubscribeEventGroup(const Sd_InstanceType *Instan
                       sub->RemoteAddr.port));
           if (SD_FLG_EVENT_GROUP_UNSUBSCRIBED != sub->flags) {
             EventHandler->onSubscribe(FALSE, &sub->RemoteAddr);
-            SQP_CRM_AND_FREE(EventHandlerSubscriber, sub);
+            Sd_SubscriberRemove(EventHandler, sub);
           } else {
             SQP_FREE(EventHandlerSubscriber, sub);
           }
+          sub = NULL;
+        } else {
+          /* back to unicast if it was renewed below the threshold */
+          SD_CLEAR(sub->flags, SD_FLG_EVENT_GROUP_MULTICAST);
         }
       } else {
         sub->TxPduId = EventHandler->MulticastTxPduId;
+        if (SD_FLG_EVENT_GROUP_UNSUBSCRIBED != sub->flags) {
+          /* a unicast subscriber renewed above the threshold, the ACK moves it to multicast */
+          SD_SET(sub->flags, SD_FLG_EVENT_GROUP_MULTICAST);
+        }
         if (FALSE == context->isMulticastOpened) {
           (void)SoAd_OpenSoCon(EventHandler->MulticastEventSoConRef);
           context->isMulticastOpened = TRUE;
@@ -951,16 +1448,14 @@ static Std_ReturnType Sd_HandleSubscribeEventGroup(const Sd_InstanceType *Instan
         } else {
           SQP_CAPPEND(EventHandlerSubscriber, sub);
         }
+        Sd_SubscriberIndexAdd(config, EventHandler, sub);
         EventHandler->onSubscribe(TRUE, &sub->RemoteAddr);
       }
-      ret = Sd_ResponseSubscribeEventGroup(Instance, config, EventHandler, sub);
-      if (E_OK != ret) { /* retry next time */
-        SD_SET(sub->flags, SD_FLG_PENDING_EVENT_GROUP_ACK);
-      }
+      /* the ACKs are collected and sent after the whole SD message is handled */
+      Sd_SubscriberQueueAck(sub);
       if (DEFAULT_TTL != entry2->TTL) {
         sub->TTL = SD_CONVERT_MS_TO_MAIN_CYCLES(entry2->TTL * 1000u);
       }
-      ret = E_OK;
     } else {
       ret = E_NOT_OK;
     }
@@ -969,7 +1464,7 @@ static Std_ReturnType Sd_HandleSubscribeEventGroup(const Sd_InstanceType *Instan
   if ((E_OK != ret) && (NULL != sub)) {
     if (SD_FLG_EVENT_GROUP_UNSUBSCRIBED != sub->flags) {
       EventHandler->onSubscribe(FALSE, &sub->RemoteAddr);
-      SQP_CRM_AND_FREE(EventHandlerSubscriber, sub);
+      Sd_SubscriberRemove(EventHandler, sub);
     } else {
       SQP_FREE(EventHandlerSubscriber, sub);
     }
@@ -982,27 +1477,11 @@ static Std_ReturnType Sd_HandleSubscribeEventGroupAck(const Sd_InstanceType *Ins
                                                       const Sd_EntryType2Type *entry2,
                                                       const Sd_OptionIPv4Type *ipv4Opt) {
   Std_ReturnType ret = E_NOT_OK;
-  uint16_t i;
-  const Sd_ClientServiceType *config;
   const Sd_ConsumedEventGroupType *ConsumedEventGroup;
 
-  for (i = 0u; i < Instance->numOfClientServices; i++) {
-    config = &Instance->ClientServices[i];
-    if ((config->ServiceId == entry2->serviceId) || (config->InstanceId == entry2->instanceId)) {
-      ret = E_OK;
-      break;
-    }
-  }
-
-  if (E_OK == ret) {
-    ret = E_NOT_OK;
-    for (i = 0u; i < config->numOfConsumedEventGroups; i++) {
-      ConsumedEventGroup = &config->ConsumedEventGroups[i];
-      if (ConsumedEventGroup->EventGroupId == entry2->eventGroupId) {
-        ret = E_OK;
-        break;
-      }
-    }
+  ConsumedEventGroup = Sd_LookupConsumedEventGroup(Instance, entry2);
+  if (NULL != ConsumedEventGroup) {
+    ret = E_OK;
   }
 
   if (E_OK == ret) {
@@ -1052,12 +1531,14 @@ static void Sd_HandleMsg(const Sd_InstanceType *Instance, const PduInfoType *Pdu
     Sd_OptionIPv4Type ipv4Opt;
   } OPT;
   uint16_t i;
+  Sd_MessageType *msg = &sdMessage;
   (void)isMulticast;
 
   ASLOG(SD, ("[%s] Rx %s %d bytes from %d.%d.%d.%d:%d\n", Instance->Hostname,
              isMulticast ? "Multicast" : "Unicast", PduInfoPtr->SduLength, RemoteAddr->addr[0],
              RemoteAddr->addr[1], RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port));
 
+  Sd_MsgInit(msg, Instance);
   ret = Sd_DecodeHeader(data, length, &header);
   for (i = 0u; (i < header.lengthOfEntries) && (E_OK == ret);) {
     type = data[24u + i];
@@ -1065,7 +1546,7 @@ static void Sd_HandleMsg(const Sd_InstanceType *Instance, const PduInfoType *Pdu
     case SD_FIND_SERVICE:
       ret = Sd_DecodeEntryType1OF(&data[24u + i], NULL, &ET.entry1, NULL);
       if (E_OK == ret) {
-        (void)Sd_HandleFindService(Instance, RemoteAddr, &ET.entry1);
+        (void)Sd_HandleFindService(msg, RemoteAddr, &ET.entry1);
       }
       i += 16u;
       break;
@@ -1099,6 +1580,10 @@ static void Sd_HandleMsg(const Sd_InstanceType *Instance, const PduInfoType *Pdu
       break;
     }
   }
+
+  /* the offers replied to the finds in one message, then the ACKs to the subscribes */
+  (void)Sd_MsgFlush(msg);
+  Sd_ServerServiceEventGroupAckFlush(msg);
 }
 
 static void Sd_InitServerServiceEventHandlers(const Sd_ServerServiceType *config) {
@@ -1107,7 +1592,6 @@ static void Sd_InitServerServiceEventHandlers(const Sd_ServerServiceType *config
   for (i = 0u; i < config->numOfEventHandlers; i++) {
     EventHandler = &config->EventHandlers[i];
     (void)memset(EventHandler->context, 0u, sizeof(Sd_EventHandlerContextType));
-    SQP_INIT(EventHandlerSubscriber);
     STAILQ_INIT(&EventHandler->context->listEventHandlerSubscribers);
   }
 }
@@ -1125,7 +1609,7 @@ static void Sd_ReInitServerServiceEventHandlers(const Sd_ServerServiceType *conf
       if (SD_FLG_EVENT_GROUP_UNSUBSCRIBED != var->flags) {
         EventHandler->onSubscribe(FALSE, &var->RemoteAddr);
       }
-      SQP_CRM_AND_FREE(EventHandlerSubscriber, var);
+      Sd_SubscriberRemove(EventHandler, var);
     }
     SQP_WHILE_END()
     if (TRUE == context->isMulticastOpened) {
@@ -1485,116 +1969,64 @@ static void Sd_ClientServiceMain_Main(const Sd_ClientServiceType *config) {
   }
 }
 
-static void Sd_ServerServiceOfferCheck(const Sd_InstanceType *Instance, uint32_t *lengthOfEntries,
-                                       uint32_t *lengthOfOptions, uint8_t *numOfOptions) {
-  uint16_t i;
-  const Sd_ServerServiceType *config;
-  Sd_ServerServiceContextType *context;
-
-  for (i = 0u; i < Instance->numOfServerServices; i++) {
-    config = &Instance->ServerServices[i];
-    context = config->context;
-    if (0u != (context->flags & (SD_FLG_PENDING_OFFER | SD_FLG_PENDING_STOP_OFFER))) {
-      if (((28u + *lengthOfEntries + *lengthOfOptions) < (Instance->bufLen - 28u)) &&
-          (*numOfOptions < 255u)) {
-        /* @SWS_SD_00160 */
-        *lengthOfEntries += 16u;
-        *lengthOfOptions += 12u;
-        *numOfOptions += 1u;
-      } else {
-        break;
-      }
-    }
-  }
-}
-
-static void Sd_ClientServiceFindCheck(const Sd_InstanceType *Instance, uint32_t *lengthOfEntries,
-                                      uint32_t lengthOfOptions) {
-  uint16_t i;
-  const Sd_ClientServiceType *config;
-  Sd_ClientServiceContextType *context;
-
-  for (i = 0u; i < Instance->numOfClientServices; i++) {
-    config = &Instance->ClientServices[i];
-    context = config->context;
-    if (0u != (context->flags & SD_FLG_PENDING_FIND)) {
-      if ((28u + *lengthOfEntries + lengthOfOptions) < (Instance->bufLen - 16u)) {
-        *lengthOfEntries += 16u;
-      } else {
-        break;
-      }
-    }
-  }
-}
-
-static void Sd_ServerServiceOfferBuild(const Sd_InstanceType *Instance, uint32_t *offsetOfEntries,
-                                       uint32_t *offsetOfOptions, uint8_t *numOfOptions,
-                                       uint32_t *freeSpace) {
+static void Sd_ServerServiceOfferBuild(Sd_MessageType *msg) {
   uint16_t i;
+  const Sd_InstanceType *Instance = msg->Instance;
   const Sd_ServerServiceType *config;
   Sd_ServerServiceContextType *context;
   TcpIp_SockAddrType LocalAddr;
   uint32_t TTL;
+  uint8_t flags;
   Std_ReturnType ret;
+  uint8_t entry[SD_ENTRY_SIZE];
+  uint8_t option[SD_OPTION_IPV4_SIZE];
 
   for (i = 0u; i < Instance->numOfServerServices; i++) {
     config = &Instance->ServerServices[i];
     context = config->context;
-    if (0u != (context->flags & (SD_FLG_PENDING_OFFER | SD_FLG_PENDING_STOP_OFFER))) {
-      if (*freeSpace >= 28u) {
-        /* @SWS_SD_00416 */
-        ret = SoAd_GetLocalAddr(config->SoConId, &LocalAddr, NULL, NULL);
-        if (E_OK == ret) {
-          if (0u != (context->flags & SD_FLG_PENDING_STOP_OFFER)) {
-            TTL = 0u;
-          } else {
-            TTL = config->ServerTimer->TTL;
-          }
-          SD_CLEAR(context->flags, SD_FLG_PENDING_OFFER | SD_FLG_PENDING_STOP_OFFER);
-          Sd_BuildEntryType1(&Instance->buffer[*offsetOfEntries], SD_OFFER_SERVICE, *numOfOptions,
-                             0u, 1u, 0u, config->ServiceId, config->InstanceId,
-                             config->MajorVersion, config->MinorVersion, TTL);
-          Sd_BuildOptionIPv4Endpoint(&Instance->buffer[*offsetOfOptions], &LocalAddr,
-                                     config->ProtocolType);
-          *offsetOfEntries += 16;
-          *offsetOfOptions += 12;
-          *numOfOptions += 1;
-          *freeSpace -= 28;
+    flags = context->flags & (SD_FLG_PENDING_OFFER | SD_FLG_PENDING_STOP_OFFER);
+    if (0u != flags) {
+      /* @SWS_SD_00416 */
+      ret = SoAd_GetLocalAddr(config->SoConId, &LocalAddr, NULL, NULL);
+      if (E_OK == ret) {
+        if (0u != (flags & SD_FLG_PENDING_STOP_OFFER)) {
+          TTL = 0u;
+        } else {
+          TTL = config->ServerTimer->TTL;
         }
-      } else {
-        break;
+        /* @SWS_SD_00160: the services on the same endpoint share one option */
+        Sd_BuildEntryType1(entry, SD_OFFER_SERVICE, 0u, 0u, 1u, 0u, config->ServiceId,
+                           config->InstanceId, config->MajorVersion, config->MinorVersion, TTL);
+        Sd_BuildOptionIPv4Endpoint(option, &LocalAddr, config->ProtocolType);
+        (void)Sd_MsgPut(msg, Instance->TxPdu.MulticastTxPduId, NULL, entry, option,
+                        &context->flags, flags);
       }
     }
   }
 }
 
-static void Sd_ClientServiceFindBuild(const Sd_InstanceType *Instance, uint32_t *offsetOfEntries,
-                                      uint32_t *freeSpace) {
+static void Sd_ClientServiceFindBuild(Sd_MessageType *msg) {
   uint16_t i;
+  const Sd_InstanceType *Instance = msg->Instance;
   const Sd_ClientServiceType *config;
   Sd_ClientServiceContextType *context;
+  uint8_t entry[SD_ENTRY_SIZE];
 
   for (i = 0u; i < Instance->numOfClientServices; i++) {
     config = &Instance->ClientServices[i];
     context = config->context;
     if (0u != (context->flags & SD_FLG_PENDING_FIND)) {
-      if (*freeSpace >= 16) {
-        SD_CLEAR(context->flags, SD_FLG_PENDING_FIND);
-        Sd_BuildEntryType1(&Instance->buffer[*offsetOfEntries], SD_FIND_SERVICE, 0u, 0u, 0u, 0u,
-                           config->ServiceId, config->InstanceId, config->MajorVersion,
-                           config->MinorVersion, config->ClientTimer->TTL);
-        *offsetOfEntries += 16;
-        *freeSpace -= 16;
-      } else {
-        break;
-      }
+      Sd_BuildEntryType1(entry, SD_FIND_SERVICE, 0u, 0u, 0u, 0u, config->ServiceId,
+                         config->InstanceId, config->MajorVersion, config->MinorVersion,
+                         config->ClientTimer->TTL);
+      (void)Sd_MsgPut(msg, Instance->TxPdu.MulticastTxPduId, NULL, entry, NULL, &context->flags,
+                      SD_FLG_PENDING_FIND);
     }
   }
 }
 
 static void Sd_ServerServiceMain_TTL(const Sd_ServerServiceType *config) {
   uint16_t i;
-  uint16_t numOfSubscribers;
   const Sd_EventHandlerType *EventHandler;
   Sd_EventHandlerContextType *context;
   DEC_SQP(EventHandlerSubscriber);
@@ -1610,15 +2042,14 @@ static void Sd_ServerServiceMain_TTL(const Sd_ServerServiceType *config) {
                         var->RemoteAddr.addr[0], var->RemoteAddr.addr[1], var->RemoteAddr.addr[2],
                         var->RemoteAddr.addr[3], var->RemoteAddr.port, EventHandler->EventGroupId));
             EventHandler->onSubscribe(FALSE, &var->RemoteAddr);
-            SQP_CRM_AND_FREE(EventHandlerSubscriber, var);
+            Sd_SubscriberRemove(EventHandler, var);
           }
         }
       }
     }
     SQP_WHILE_END()
 
-    numOfSubscribers = Sd_NumberOfSubscribes(EventHandler);
-    if (0u == numOfSubscribers) {
+    if (0u == context->numOfSubscribers) {
       if (TRUE == context->isMulticastOpened) {
         context->isMulticastOpened = FALSE;
         (void)SoAd_CloseSoCon(EventHandler->MulticastEventSoConRef, TRUE);
@@ -1718,152 +2149,139 @@ static void Sd_ClientServiceMain(const Sd_InstanceType *Instance) {
   }
 }
 
-static boolean Sd_ServerServiceEventGroupAckCheck(const Sd_InstanceType *Instance) {
-  uint16_t i;
-  uint16_t j;
+/* Put the pending ACKs into the message, return TRUE if some are left for another destination */
+static boolean Sd_ServerServiceEventGroupAckBuild(Sd_MessageType *msg) {
+  const Sd_InstanceType *Instance = msg->Instance;
   const Sd_ServerServiceType *config;
-  const Sd_EventHandlerType *EventHandler;
-  Sd_EventHandlerContextType *context;
-  DEC_SQP(EventHandlerSubscriber);
-  boolean TxOne = FALSE;
-  Std_ReturnType ret = E_OK;
+  Sd_EventHandlerSubscriberType *sub;
+  boolean more = FALSE;
+  Std_ReturnType ret;
+  uint16_t numOfPendingAcks = 0u;
+  uint16_t slot;
+  uint16_t i;
 
-  for (i = 0u; (i < Instance->numOfServerServices) && (FALSE == TxOne); i++) {
-    config = &Instance->ServerServices[i];
-    for (j = 0u; j < config->numOfEventHandlers; j++) {
-      EventHandler = &config->EventHandlers[j];
-      context = EventHandler->context;
-      SQP_WHILE(EventHandlerSubscriber) {
-        if (0u != (var->flags & SD_FLG_PENDING_EVENT_GROUP_ACK)) {
-          ret = Sd_ResponseSubscribeEventGroup(Instance, config, EventHandler, var);
-          if (E_OK == ret) {
-            SD_CLEAR(var->flags, SD_FLG_PENDING_EVENT_GROUP_ACK);
-            TxOne = TRUE;
-            break;
-          } else {
-            ASLOG(SDE, ("Sending Subscribe Event Group Ack Failed\n"));
-          }
+  for (i = 0u; i < sdNumOfPendingAcks; i++) {
+    slot = sdPendingAcks[i];
+    sub = &sdEventHandlerSubscriberSlots[slot];
+    config = sdSubscriberService[slot];
+    if ((NULL == config) || (0u == (sub->flags & SD_FLG_PENDING_EVENT_GROUP_ACK))) {
+      sdIsAckQueued[slot] = FALSE; /* sent or unsubscribed */
+    } else {
+      if ((config >= Instance->ServerServices) &&
+          (config < &Instance->ServerServices[Instance->numOfServerServices])) {
+        ret = Sd_PutSubscribeEventGroupAck(msg, config, sdSubscriberOwner[slot], sub);
+        if (E_OK != ret) {
+          more = TRUE;
         }
       }
-      SQP_WHILE_END()
+      sdPendingAcks[numOfPendingAcks] = slot;
+      numOfPendingAcks++;
     }
   }
+  sdNumOfPendingAcks = numOfPendingAcks;
 
-  return TxOne;
+  return more;
+}
+
+static void Sd_ServerServiceEventGroupAckFlush(Sd_MessageType *msg) {
+  boolean more;
+  uint16_t numOfMsgs;
+
+  do {
+    numOfMsgs = msg->numOfMsgs;
+    more = Sd_ServerServiceEventGroupAckBuild(msg);
+    (void)Sd_MsgFlush(msg);
+  } while ((TRUE == more) && (FALSE == msg->isTxFailed) && (numOfMsgs != msg->numOfMsgs));
 }
 
 static Std_ReturnType
-Sd_SendSubscribeEventGroup(const Sd_InstanceType *Instance, const Sd_ClientServiceType *config,
-                           const Sd_ConsumedEventGroupType *ConsumedEventGroup) {
+Sd_PutSubscribeEventGroup(Sd_MessageType *msg, const Sd_ClientServiceType *config,
+                          const Sd_ConsumedEventGroupType *ConsumedEventGroup) {
   Std_ReturnType ret = E_OK;
+  const Sd_InstanceType *Instance = msg->Instance;
   TcpIp_SockAddrType LocalAddr;
   uint32_t TTL = 0u;
+  uint8_t flags = ConsumedEventGroup->context->flags &
+                  (SD_FLG_PENDING_SUBSCRIBE | SD_FLG_PENDING_STOP_SUBSCRIBE);
+  uint8_t entry[SD_ENTRY_SIZE];
+  uint8_t option[SD_OPTION_IPV4_SIZE];
 
-  if (0u == (ConsumedEventGroup->context->flags & SD_FLG_PENDING_STOP_SUBSCRIBE)) {
+  if (0u == (flags & SD_FLG_PENDING_STOP_SUBSCRIBE)) {
     TTL = config->ClientTimer->TTL;
   } else {
     /* send stop */
   }
 
-  Sd_BuildEntryType2(&Instance->buffer[24u], SD_SUBSCRIBE_EVENT_GROUP, 0u, 0u, 1u, 0u,
-                     config->ServiceId, config->InstanceId, config->MajorVersion, 0u,
+  Sd_BuildEntryType2(entry, SD_SUBSCRIBE_EVENT_GROUP, 0u, 0u, 1u, 0u, config->ServiceId,
+                     config->InstanceId, config->MajorVersion, 0u,
                      ConsumedEventGroup->EventGroupId, TTL);
   ret = SoAd_GetLocalAddr(config->SoConId, &LocalAddr, NULL, NULL);
   if (E_OK == ret) {
     ASLOG(SDI, ("SOCK[%u] local addr %d.%d.%d.%d:%d subscribe event group %x\n", config->SoConId,
                 LocalAddr.addr[0], LocalAddr.addr[1], LocalAddr.addr[2], LocalAddr.addr[3],
                 LocalAddr.port, ConsumedEventGroup->EventGroupId));
-    Sd_BuildOptionIPv4Endpoint(&Instance->buffer[44], &LocalAddr, config->ProtocolType);
-    Sd_BuildHeader(Instance->buffer, Instance->context->flags,
-                   Instance->context->multicastSessionId, 16, 12);
-    Instance->context->multicastSessionId++;
-    if (0u == Instance->context->multicastSessionId) {
-      Instance->context->multicastSessionId = 1;
-      Instance->context->flags &= ~SD_REBOOT_FLAG;
-    }
+    Sd_BuildOptionIPv4Endpoint(option, &LocalAddr, config->ProtocolType);
 #if (defined(_WIN32) || defined(linux)) && !defined(USE_LWIP)
     /* NOTE: this is a workaroud for case that server and client on the same host */
-    ret = Sd_Transmit(Instance->TxPdu.MulticastTxPduId, Instance->buffer, 56, NULL);
+    ret = Sd_MsgPut(msg, Instance->TxPdu.MulticastTxPduId, NULL, entry, option,
+                    &ConsumedEventGroup->context->flags, flags);
 #else
     (void)memcpy(LocalAddr.addr, config->context->RemoteAddr.addr, 4);
     LocalAddr.port = config->context->port;
-    ret = Sd_Transmit(Instance->TxPdu.UnicastTxPduId, Instance->buffer, 56, &LocalAddr);
+    ret = Sd_MsgPut(msg, Instance->TxPdu.UnicastTxPduId, &LocalAddr, entry, option,
+                    &ConsumedEventGroup->context->flags, flags);
 #endif
-    if (E_OK != ret) {
-      ASLOG(SDE, ("Sending Subscribe Event Group Ack Failed\n"));
-    }
   }
 
   return ret;
 }
 
-static boolean Sd_ClientServiceSubscribeEventGroupCheck(const Sd_InstanceType *Instance) {
+/* Put the pending subscribes into the message, return TRUE if some are left for another
+ * destination */
+static boolean Sd_ClientServiceSubscribeEventGroupBuild(Sd_MessageType *msg) {
   uint16_t i;
   uint16_t j;
+  const Sd_InstanceType *Instance = msg->Instance;
   const Sd_ClientServiceType *config;
   const Sd_ConsumedEventGroupType *ConsumedEventGroup;
-  boolean TxOne = FALSE;
+  boolean more = FALSE;
   Std_ReturnType ret;
 
-  for (i = 0u; (i < Instance->numOfClientServices) && (FALSE == TxOne); i++) {
+  for (i = 0u; i < Instance->numOfClientServices; i++) {
     config = &Instance->ClientServices[i];
-    for (j = 0u; (j < config->numOfConsumedEventGroups) && (FALSE == TxOne); j++) {
+    for (j = 0u; j < config->numOfConsumedEventGroups; j++) {
       ConsumedEventGroup = &config->ConsumedEventGroups[j];
       if (0u != (ConsumedEventGroup->context->flags &
                  (SD_FLG_PENDING_SUBSCRIBE | SD_FLG_PENDING_STOP_SUBSCRIBE))) {
-        ret = Sd_SendSubscribeEventGroup(Instance, config, ConsumedEventGroup);
-        if (E_OK == ret) {
-          SD_CLEAR(ConsumedEventGroup->context->flags,
-                   SD_FLG_PENDING_SUBSCRIBE | SD_FLG_PENDING_STOP_SUBSCRIBE);
-          TxOne = TRUE;
+        ret = Sd_PutSubscribeEventGroup(msg, config, ConsumedEventGroup);
+        if (E_OK != ret) {
+          more = TRUE;
         }
       }
     }
   }
 
-  return TxOne;
+  return more;
 }
 
+/* All the pending entries are packed into as few messages as possible: the finds and offers into
+ * the multicast ones, the ACKs and subscribes join them or are grouped by their destination. */
 static void Sd_ServerClientServiceMain(const Sd_InstanceType *Instance) {
-  uint32_t lengthOfEntries = 0u;
-  uint32_t lengthOfOptions = 0u;
-  uint32_t offsetOfEntries = 24;
-  uint8_t numOfOptions = 0u;
-  uint32_t offsetOfOptions;
-  uint32_t freeSpace;
-  boolean TxOne = FALSE;
-  Std_ReturnType ret;
+  Sd_MessageType *msg = &sdMessage;
+  boolean more;
+  uint16_t numOfMsgs;
 
-  Sd_ClientServiceFindCheck(Instance, &lengthOfEntries, lengthOfOptions);
-  Sd_ServerServiceOfferCheck(Instance, &lengthOfEntries, &lengthOfOptions, &numOfOptions);
-
-  if (lengthOfEntries > 0u) {
-    offsetOfOptions = offsetOfEntries + lengthOfEntries + 4u;
-    freeSpace = lengthOfEntries + lengthOfOptions;
-    numOfOptions = 0u;
-    Sd_ClientServiceFindBuild(Instance, &offsetOfEntries, &freeSpace);
-    Sd_ServerServiceOfferBuild(Instance, &offsetOfEntries, &offsetOfOptions, &numOfOptions,
-                               &freeSpace);
-    Sd_BuildHeader(Instance->buffer, Instance->context->flags,
-                   Instance->context->multicastSessionId, lengthOfEntries, lengthOfOptions);
-    Instance->context->multicastSessionId++;
-    if (0u == Instance->context->multicastSessionId) {
-      Instance->context->multicastSessionId = 1u;
-      Instance->context->flags &= ~SD_REBOOT_FLAG;
-    }
-
-    ret = Sd_Transmit(Instance->TxPdu.MulticastTxPduId, Instance->buffer,
-                      28u + lengthOfEntries + lengthOfOptions, NULL);
-    if (E_OK == ret) {
-      TxOne = TRUE;
+  Sd_MsgInit(msg, Instance);
+  Sd_ClientServiceFindBuild(msg);
+  Sd_ServerServiceOfferBuild(msg);
+  do {
+    numOfMsgs = msg->numOfMsgs;
+    more = Sd_ServerServiceEventGroupAckBuild(msg);
+    if (TRUE == Sd_ClientServiceSubscribeEventGroupBuild(msg)) {
+      more = TRUE;
     }
-  }
-  if (FALSE == TxOne) {
-    TxOne = Sd_ServerServiceEventGroupAckCheck(Instance);
-  }
-  if (FALSE == TxOne) {
-    TxOne = Sd_ClientServiceSubscribeEventGroupCheck(Instance);
-  }
+    (void)Sd_MsgFlush(msg);
+  } while ((TRUE == more) && (FALSE == msg->isTxFailed) && (numOfMsgs != msg->numOfMsgs));
 }
 
 static Std_ReturnType Sd_ServerSoConModeChg(const Sd_InstanceType *Instance,
@@ -1940,6 +2358,10 @@ void Sd_Init(const Sd_ConfigType *ConfigPtr) {
     sdConfigPtr = &Sd_Config;
   }
 
+  SQP_INIT(EventHandlerSubscriber);
+  Sd_SubscriberIndexInit();
+  Sd_IndexBuild();
+
   for (i = 0u; i < SD_CONFIG->numOfInstances; i++) {
     Instance = &SD_CONFIG->Instances[i];
     Instance->context->flags = SD_REBOOT_FLAG | SD_UNICAST_FLAG;
@@ -2146,7 +2568,7 @@ void Sd_RemoveSubscriber(uint16_t EventHandlerId, PduIdType TxPduId) {
     SQP_WHILE(EventHandlerSubscriber) {
       if (var->TxPduId == TxPduId) {
         EventHandler->onSubscribe(FALSE, &var->RemoteAddr);
-        SQP_CRM_AND_FREE(EventHandlerSubscriber, var);
+        Sd_SubscriberRemove(EventHandler, var);
       }
     }
     SQP_WHILE_END()
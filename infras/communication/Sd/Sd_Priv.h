@@ -15,6 +15,7 @@
 
 #define SD_ANY_MAJOR_VERSION 0xFFu
 #define SD_ANY_MINOR_VERSION 0xFFFFFFFFu
+#define SD_ANY_INSTANCE_ID 0xFFFFu
 /* ================================ [ TYPES     ] ============================================== */
 typedef enum {
   SD_PHASE_DOWN,
@@ -73,6 +74,7 @@ typedef struct {
 
 typedef struct {
   Sd_EventHandlerSubscriberListType listEventHandlerSubscribers;
+  uint16_t numOfSubscribers;
   boolean isMulticastOpened;
 } Sd_EventHandlerContextType;
 
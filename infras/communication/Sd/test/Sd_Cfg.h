@@ -0,0 +1,29 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Sd config of the SD storm test and bench, the services are set up at runtime by
+ * sd_storm_test.c and Sd_StormBench.c
+ */
+#ifndef SD_CFG_H
+#define SD_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#define SD_TEST_SERVICES 320
+#define SD_TEST_CLIENTS 16
+
+#define SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE (SD_TEST_SERVICES * SD_TEST_CLIENTS + 8)
+
+#define SD_SERVICE_INDEX_SIZE 2048u
+
+#ifndef SD_MAIN_FUNCTION_PERIOD
+#define SD_MAIN_FUNCTION_PERIOD 10u
+#endif
+#define SD_CONVERT_MS_TO_MAIN_CYCLES(x)                                                            \
+  (((x) + SD_MAIN_FUNCTION_PERIOD - 1u) / SD_MAIN_FUNCTION_PERIOD)
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* SD_CFG_H */
@@ -0,0 +1,446 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * SD storm after wake-up: an ECU provides and consumes SD_TEST_SERVICES services spread over a
+ * few sockets. All its services are offered at the same time, then SD_TEST_CLIENTS remote ECUs
+ * send packed SD messages finding and subscribing all of them and the remote servers offer all
+ * the consumed ones. The SD messages and bytes sent by the ECU and the CPU time spent per received
+ * entry are reported.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Sd.h"
+#include "Sd_Cfg.h"
+#include "Sd_Priv.h"
+#include "SoAd.h"
+#include "TcpIp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define BENCH_MSG_SIZE 1400u
+#define BENCH_SOCKETS 8u
+#define BENCH_SERVICE_ID_BASE 0x1000u
+#define BENCH_CLIENT_SERVICE_ID_BASE 0x4000u
+#define BENCH_EVENT_GROUP_ID 0x01u
+
+#define BENCH_TX_PID_MULTICAST 0u
+#define BENCH_TX_PID_UNICAST 1u
+#define BENCH_RX_PID_MULTICAST 0u
+#define BENCH_RX_PID_UNICAST 1u
+
+#define BENCH_ROUNDS 100u
+
+#define BENCH_ENTRY_FIND 0x00u
+#define BENCH_ENTRY_OFFER 0x01u
+#define BENCH_ENTRY_SUBSCRIBE 0x06u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t numOfMsgs;
+  uint32_t numOfBytes;
+  uint32_t numOfEntries;
+  uint32_t numOfOptions;
+} Bench_TxStatsType;
+/* ================================ [ DECLARES  ] ============================================== */
+static void Bench_OnSubscribe(boolean isSubscribe, TcpIp_SockAddrType *RemoteAddr);
+static void Bench_OnSubscribeAck(boolean isSubscribe);
+/* ================================ [ DATAS     ] ============================================== */
+static const Sd_ServerTimerType Bench_ServerTimer = {
+  1u,                                 /* InitialOfferDelayMax */
+  1u,                                 /* InitialOfferDelayMin */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(200),  /* InitialOfferRepetitionBaseDelay */
+  3,                                  /* InitialOfferRepetitionsMax */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(3000), /* OfferCyclicDelay */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(1500), /* RequestResponseMaxDelay */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(0),    /* RequestResponseMinDelay */
+  5,                                  /* TTL seconds */
+};
+
+static const Sd_ClientTimerType Bench_ClientTimer = {
+  SD_CONVERT_MS_TO_MAIN_CYCLES(100),  /* InitialFindDelayMax */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(10),   /* InitialFindDelayMin */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(200),  /* InitialFindRepetitionsBaseDelay */
+  3,                                  /* InitialFindRepetitionsMax */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(1500), /* RequestResponseMaxDelay */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(0),    /* RequestResponseMinDelay */
+  5,                                  /* TTL seconds */
+};
+
+static Sd_EventHandlerContextType Bench_EventHandlerContexts[SD_TEST_SERVICES];
+static Sd_EventHandlerType Bench_EventHandlers[SD_TEST_SERVICES];
+static Sd_ServerServiceContextType Bench_ServerContexts[SD_TEST_SERVICES];
+static Sd_ServerServiceType Bench_ServerServices[SD_TEST_SERVICES];
+static const Sd_ServerServiceType *Bench_ServerServicesMap[SD_TEST_SERVICES];
+static uint16_t Bench_EventHandlersMap[SD_TEST_SERVICES];
+static uint16_t Bench_PerServiceEventHandlerMap[SD_TEST_SERVICES];
+
+static Sd_ConsumedEventGroupContextType Bench_ConsumedEventGroupContexts[SD_TEST_SERVICES];
+static Sd_ConsumedEventGroupType Bench_ConsumedEventGroups[SD_TEST_SERVICES];
+static Sd_ClientServiceContextType Bench_ClientContexts[SD_TEST_SERVICES];
+static Sd_ClientServiceType Bench_ClientServices[SD_TEST_SERVICES];
+static const Sd_ClientServiceType *Bench_ClientServicesMap[SD_TEST_SERVICES];
+static uint16_t Bench_ConsumedEventGroupsMap[SD_TEST_SERVICES];
+static uint16_t Bench_PerServiceConsumedEventGroupsMap[SD_TEST_SERVICES];
+
+static uint8_t Bench_Buffer[BENCH_MSG_SIZE];
+static Sd_InstanceContextType Bench_InstanceContext;
+
+static const Sd_InstanceType Bench_Instances[] = {
+  {
+    "bench",                                         /* Hostname */
+    0,                                               /* SubscribeEventgroupRetryDelay */
+    0,                                               /* SubscribeEventgroupRetryMax */
+    {BENCH_RX_PID_MULTICAST, 0},                     /* MulticastRxPdu */
+    {BENCH_RX_PID_UNICAST, 1},                       /* UnicastRxPdu */
+    {BENCH_TX_PID_MULTICAST, BENCH_TX_PID_UNICAST},  /* TxPdu */
+    Bench_ServerServices,                            /* ServerServices */
+    SD_TEST_SERVICES,                               /* numOfServerServices */
+    Bench_ClientServices,                            /* ClientServices */
+    SD_TEST_SERVICES,                               /* numOfClientServices */
+    Bench_Buffer,                                    /* buffer */
+    sizeof(Bench_Buffer),                            /* bufLen */
+    &Bench_InstanceContext,                          /* context */
+  },
+};
+
+const Sd_ConfigType Sd_Config = {
+  Bench_Instances,
+  ARRAY_SIZE(Bench_Instances),
+  Bench_ServerServicesMap,
+  SD_TEST_SERVICES,
+  Bench_ClientServicesMap,
+  SD_TEST_SERVICES,
+  Bench_EventHandlersMap,
+  Bench_PerServiceEventHandlerMap,
+  SD_TEST_SERVICES,
+  Bench_ConsumedEventGroupsMap,
+  Bench_PerServiceConsumedEventGroupsMap,
+  SD_TEST_SERVICES,
+};
+
+static Bench_TxStatsType Bench_TxStats;
+static uint32_t Bench_NumOfSubscribed;
+static uint32_t Bench_NumOfAcked;
+static uint16_t Bench_SessionId = 1u;
+static uint8_t Bench_RxMsg[BENCH_MSG_SIZE];
+/* ================================ [ LOCALS    ] ============================================== */
+static void Bench_OnSubscribe(boolean isSubscribe, TcpIp_SockAddrType *RemoteAddr) {
+  (void)RemoteAddr;
+  if (isSubscribe) {
+    Bench_NumOfSubscribed++;
+  }
+}
+
+static void Bench_OnSubscribeAck(boolean isSubscribe) {
+  if (isSubscribe) {
+    Bench_NumOfAcked++;
+  }
+}
+
+static uint64_t Bench_NowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void Bench_Setup(void) {
+  uint16_t i;
+
+  for (i = 0u; i < SD_TEST_SERVICES; i++) {
+    Bench_EventHandlers[i].HandleId = i;
+    Bench_EventHandlers[i].EventGroupId = BENCH_EVENT_GROUP_ID;
+    Bench_EventHandlers[i].MulticastTxPduId = (PduIdType)-1;
+    Bench_EventHandlers[i].context = &Bench_EventHandlerContexts[i];
+    Bench_EventHandlers[i].onSubscribe = Bench_OnSubscribe;
+
+    Bench_ServerServices[i].AutoAvailable = TRUE;
+    Bench_ServerServices[i].HandleId = i;
+    Bench_ServerServices[i].ServiceId = BENCH_SERVICE_ID_BASE + i;
+    Bench_ServerServices[i].InstanceId = 1u + i;
+    Bench_ServerServices[i].SoConId = 2u + (i % BENCH_SOCKETS);
+    Bench_ServerServices[i].ProtocolType = TCPIP_IPPROTO_UDP;
+    Bench_ServerServices[i].ServerTimer = &Bench_ServerTimer;
+    Bench_ServerServices[i].context = &Bench_ServerContexts[i];
+    Bench_ServerServices[i].EventHandlers = &Bench_EventHandlers[i];
+    Bench_ServerServices[i].numOfEventHandlers = 1u;
+    Bench_ServerServices[i].SomeIpServiceId = i;
+    Bench_ServerServicesMap[i] = &Bench_ServerServices[i];
+    Bench_EventHandlersMap[i] = i;
+    Bench_PerServiceEventHandlerMap[i] = 0u;
+
+    Bench_ConsumedEventGroups[i].HandleId = i;
+    Bench_ConsumedEventGroups[i].EventGroupId = BENCH_EVENT_GROUP_ID;
+    Bench_ConsumedEventGroups[i].context = &Bench_ConsumedEventGroupContexts[i];
+    Bench_ConsumedEventGroups[i].onSubscribe = Bench_OnSubscribeAck;
+
+    Bench_ClientServices[i].HandleId = i;
+    Bench_ClientServices[i].ServiceId = BENCH_CLIENT_SERVICE_ID_BASE + i;
+    Bench_ClientServices[i].InstanceId = 1u + i;
+    Bench_ClientServices[i].MajorVersion = SD_ANY_MAJOR_VERSION;
+    Bench_ClientServices[i].MinorVersion = SD_ANY_MINOR_VERSION;
+    Bench_ClientServices[i].SoConId = 2u + BENCH_SOCKETS + (i % BENCH_SOCKETS);
+    Bench_ClientServices[i].ProtocolType = TCPIP_IPPROTO_UDP;
+    Bench_ClientServices[i].ClientTimer = &Bench_ClientTimer;
+    Bench_ClientServices[i].context = &Bench_ClientContexts[i];
+    Bench_ClientServices[i].ConsumedEventGroups = &Bench_ConsumedEventGroups[i];
+    Bench_ClientServices[i].numOfConsumedEventGroups = 1u;
+    Bench_ClientServicesMap[i] = &Bench_ClientServices[i];
+    Bench_ConsumedEventGroupsMap[i] = i;
+    Bench_PerServiceConsumedEventGroupsMap[i] = 0u;
+  }
+}
+
+static void Bench_Put32(uint8_t *data, uint32_t value) {
+  data[0] = (value >> 24) & 0xFFu;
+  data[1] = (value >> 16) & 0xFFu;
+  data[2] = (value >> 8) & 0xFFu;
+  data[3] = value & 0xFFu;
+}
+
+/* SD message of the remote ECU with the given entries which all refer to one endpoint option */
+static uint32_t Bench_BuildRxMsg(uint8_t type, uint16_t serviceIdBase, uint16_t first,
+                                 uint16_t num, const TcpIp_SockAddrType *endpoint) {
+  uint8_t *data = Bench_RxMsg;
+  uint8_t *entry;
+  uint8_t *option;
+  uint32_t lengthOfEntries = 16u * num;
+  uint32_t lengthOfOptions = (BENCH_ENTRY_FIND == type) ? 0u : 12u;
+  uint32_t length = 28u + lengthOfEntries + lengthOfOptions;
+  uint16_t i;
+  uint16_t id;
+
+  memset(data, 0, length);
+  data[0] = 0xFFu;
+  data[1] = 0xFFu;
+  data[2] = 0x81u;
+  Bench_Put32(&data[4], length - 8u);
+  data[10] = (Bench_SessionId >> 8) & 0xFFu;
+  data[11] = Bench_SessionId & 0xFFu;
+  Bench_SessionId++;
+  if (0u == Bench_SessionId) {
+    Bench_SessionId = 1u;
+  }
+  data[12] = 0x01u;
+  data[13] = 0x01u;
+  data[14] = 0x02u;
+  data[16] = 0xC0u;
+  Bench_Put32(&data[20], lengthOfEntries);
+  for (i = 0u; i < num; i++) {
+    id = first + i;
+    entry = &data[24u + 16u * i];
+    entry[0] = type;
+    entry[3] = (0u == lengthOfOptions) ? 0x00u : 0x10u;
+    entry[4] = ((serviceIdBase + id) >> 8) & 0xFFu;
+    entry[5] = (serviceIdBase + id) & 0xFFu;
+    entry[6] = ((1u + id) >> 8) & 0xFFu;
+    entry[7] = (1u + id) & 0xFFu;
+    entry[8] = (BENCH_ENTRY_FIND == type) ? 0xFFu : 0u;
+    entry[11] = 5u; /* TTL */
+    if (BENCH_ENTRY_SUBSCRIBE == type) {
+      entry[15] = BENCH_EVENT_GROUP_ID;
+    } else if (BENCH_ENTRY_FIND == type) {
+      entry[12] = entry[13] = entry[14] = entry[15] = 0xFFu;
+    } else {
+      /* offer, minor version 0 */
+    }
+  }
+  Bench_Put32(&data[24u + lengthOfEntries], lengthOfOptions);
+  if (0u != lengthOfOptions) {
+    option = &data[28u + lengthOfEntries];
+    option[1] = 0x09u;
+    option[2] = 0x04u;
+    memcpy(&option[4], endpoint->addr, 4);
+    option[9] = TCPIP_IPPROTO_UDP;
+    option[10] = (endpoint->port >> 8) & 0xFFu;
+    option[11] = endpoint->port & 0xFFu;
+  }
+
+  return length;
+}
+
+/* receive all the entries of the type from the remote ECU packed into full SD messages,
+ * return the time spent in ns */
+static uint64_t Bench_RxStorm(uint8_t type, uint16_t serviceIdBase,
+                              const TcpIp_SockAddrType *RemoteAddr, PduIdType RxPduId) {
+  uint16_t perMsg = (BENCH_MSG_SIZE - 28u - 12u) / 16u;
+  uint16_t first;
+  uint16_t num;
+  PduInfoType pduInfo;
+  uint64_t elapsed = 0u;
+  uint64_t start;
+
+  pduInfo.MetaDataPtr = (uint8_t *)RemoteAddr;
+  pduInfo.SduDataPtr = Bench_RxMsg;
+  for (first = 0u; first < SD_TEST_SERVICES; first += num) {
+    num = SD_TEST_SERVICES - first;
+    if (num > perMsg) {
+      num = perMsg;
+    }
+    pduInfo.SduLength = Bench_BuildRxMsg(type, serviceIdBase, first, num, RemoteAddr);
+    start = Bench_NowNs();
+    Sd_RxIndication(RxPduId, &pduInfo);
+    elapsed += Bench_NowNs() - start;
+  }
+
+  return elapsed;
+}
+
+static void Bench_Report(const char *name, const Bench_TxStatsType *stats, uint64_t ns,
+                         uint32_t numOfEntries) {
+  printf("%-24s: Tx %5u msgs %7u bytes %5u entries %5u options", name, stats->numOfMsgs,
+         stats->numOfBytes, stats->numOfEntries, stats->numOfOptions);
+  if (numOfEntries > 0u) {
+    printf(", %7.1f ns per Rx entry", (double)ns / numOfEntries);
+  }
+  printf("\n");
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  const uint8_t *data = PduInfoPtr->SduDataPtr;
+  uint32_t lengthOfEntries;
+  uint32_t lengthOfOptions;
+  (void)TxPduId;
+
+  lengthOfEntries =
+    ((uint32_t)data[20] << 24) + ((uint32_t)data[21] << 16) + ((uint32_t)data[22] << 8) + data[23];
+  lengthOfOptions = ((uint32_t)data[24u + lengthOfEntries] << 24) +
+                    ((uint32_t)data[25u + lengthOfEntries] << 16) +
+                    ((uint32_t)data[26u + lengthOfEntries] << 8) + data[27u + lengthOfEntries];
+  Bench_TxStats.numOfMsgs++;
+  Bench_TxStats.numOfBytes += PduInfoPtr->SduLength;
+  Bench_TxStats.numOfEntries += lengthOfEntries / 16u;
+  Bench_TxStats.numOfOptions += lengthOfOptions / 12u;
+
+  return E_OK;
+}
+
+Std_ReturnType SoAd_GetLocalAddr(SoAd_SoConIdType SoConId, TcpIp_SockAddrType *LocalAddrPtr,
+                                 uint8_t *NetmaskPtr, TcpIp_SockAddrType *DefaultRouterPtr) {
+  (void)NetmaskPtr;
+  (void)DefaultRouterPtr;
+  LocalAddrPtr->addr[0] = 172;
+  LocalAddrPtr->addr[1] = 18;
+  LocalAddrPtr->addr[2] = 0;
+  LocalAddrPtr->addr[3] = 200;
+  LocalAddrPtr->port = 30500u + SoConId;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_GetSoConId(PduIdType TxPduId, SoAd_SoConIdType *SoConIdPtr) {
+  *SoConIdPtr = (SoAd_SoConIdType)TxPduId;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_OpenSoCon(SoAd_SoConIdType SoConId) {
+  (void)SoConId;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_CloseSoCon(SoAd_SoConIdType SoConId, boolean abort) {
+  (void)SoConId;
+  (void)abort;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_SetRemoteAddr(SoAd_SoConIdType SoConId,
+                                  const TcpIp_SockAddrType *RemoteAddrPtr) {
+  (void)SoConId;
+  (void)RemoteAddrPtr;
+  return E_OK;
+}
+
+boolean TcpIp_IsLinkedUp(void) {
+  return TRUE;
+}
+
+Std_ReturnType SomeIp_ResolveSubscriber(uint16_t ServiceId, Sd_EventHandlerSubscriberType *sub) {
+  (void)ServiceId;
+  sub->TxPduId = 0u;
+  return E_OK;
+}
+
+int main(int argc, char *argv[]) {
+  TcpIp_SockAddrType RemoteAddr = {40000u, {172, 18, 0, 10}};
+  uint32_t cycles;
+  uint32_t round;
+  uint16_t c;
+  uint64_t ns;
+  (void)argc;
+  (void)argv;
+
+  printf("%u provided and %u consumed services over %u sockets, %u remote ECUs\n",
+         SD_TEST_SERVICES, SD_TEST_SERVICES, BENCH_SOCKETS, SD_TEST_CLIENTS);
+  Bench_Setup();
+  Sd_Init(NULL);
+
+  /* all the services are available after wake-up, until the 1st offer of each is sent */
+  for (cycles = 0u; cycles < 100u; cycles++) {
+    Sd_MainFunction();
+    if (Bench_TxStats.numOfEntries >= SD_TEST_SERVICES) {
+      break;
+    }
+  }
+  printf("initial offers sent in %u cycles\n", cycles + 1u);
+  Bench_Report("offer burst", &Bench_TxStats, 0u, 0u);
+
+  memset(&Bench_TxStats, 0, sizeof(Bench_TxStats));
+  ns = 0u;
+  for (c = 0u; c < SD_TEST_CLIENTS; c++) {
+    RemoteAddr.addr[3] = 10u + c;
+    ns += Bench_RxStorm(BENCH_ENTRY_FIND, BENCH_SERVICE_ID_BASE, &RemoteAddr,
+                        BENCH_RX_PID_MULTICAST);
+  }
+  Bench_Report("find storm", &Bench_TxStats, ns, SD_TEST_CLIENTS * SD_TEST_SERVICES);
+
+  memset(&Bench_TxStats, 0, sizeof(Bench_TxStats));
+  ns = 0u;
+  for (c = 0u; c < SD_TEST_CLIENTS; c++) {
+    RemoteAddr.addr[3] = 10u + c;
+    ns += Bench_RxStorm(BENCH_ENTRY_SUBSCRIBE, BENCH_SERVICE_ID_BASE, &RemoteAddr,
+                        BENCH_RX_PID_UNICAST);
+  }
+  for (cycles = 0u; cycles < 10u; cycles++) { /* pending ACKs, if any */
+    Sd_MainFunction();
+  }
+  Bench_Report("subscribe storm", &Bench_TxStats, ns, SD_TEST_CLIENTS * SD_TEST_SERVICES);
+  printf("  %u subscribed\n", Bench_NumOfSubscribed);
+
+  memset(&Bench_TxStats, 0, sizeof(Bench_TxStats));
+  ns = 0u;
+  for (round = 0u; round < BENCH_ROUNDS; round++) {
+    for (c = 0u; c < SD_TEST_CLIENTS; c++) {
+      RemoteAddr.addr[3] = 10u + c;
+      ns += Bench_RxStorm(BENCH_ENTRY_SUBSCRIBE, BENCH_SERVICE_ID_BASE, &RemoteAddr,
+                        BENCH_RX_PID_UNICAST);
+    }
+  }
+  Bench_Report("subscribe renewals", &Bench_TxStats, ns,
+               BENCH_ROUNDS * SD_TEST_CLIENTS * SD_TEST_SERVICES);
+
+  memset(&Bench_TxStats, 0, sizeof(Bench_TxStats));
+  ns = 0u;
+  RemoteAddr.addr[3] = 100u;
+  for (round = 0u; round < BENCH_ROUNDS; round++) {
+    ns += Bench_RxStorm(BENCH_ENTRY_OFFER, BENCH_CLIENT_SERVICE_ID_BASE, &RemoteAddr,
+                        BENCH_RX_PID_MULTICAST);
+  }
+  Bench_Report("remote offer storm", &Bench_TxStats, ns, BENCH_ROUNDS * SD_TEST_SERVICES);
+
+  /* all the offered services and their event groups are requested at once */
+  memset(&Bench_TxStats, 0, sizeof(Bench_TxStats));
+  for (c = 0u; c < SD_TEST_SERVICES; c++) {
+    (void)Sd_ClientServiceSetState(c, SD_CLIENT_SERVICE_REQUESTED);
+    (void)Sd_ConsumedEventGroupSetState(c, SD_CONSUMED_EVENTGROUP_REQUESTED);
+  }
+  for (cycles = 0u; cycles < 100u; cycles++) {
+    Sd_MainFunction();
+    if (Bench_TxStats.numOfEntries >= SD_TEST_SERVICES) {
+      break;
+    }
+  }
+  printf("subscribes sent in %u cycles\n", cycles + 1u);
+  Bench_Report("subscribe burst", &Bench_TxStats, 0u, 0u);
+
+  return 0;
+}
@@ -0,0 +1,554 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * SD storm after wake-up: an ECU provides and consumes SD_TEST_SERVICES services spread over a
+ * few sockets. All its services are offered at the same time, then SD_TEST_CLIENTS remote ECUs
+ * send packed SD messages finding and subscribing all of them and the remote servers offer and
+ * acknowledge all the consumed ones. Every entry must be answered, the SD messages sent must be
+ * packed up to the buffer size and their entries must share the endpoint options.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Sd.h"
+#include "Sd_Cfg.h"
+#include "Sd_Priv.h"
+#include "SoAd.h"
+#include "TcpIp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define TEST_MSG_SIZE 1400u
+#define TEST_SOCKETS 8u
+#define TEST_SERVICE_ID_BASE 0x1000u
+#define TEST_CLIENT_SERVICE_ID_BASE 0x4000u
+#define TEST_UNKNOWN_SERVICE_ID_BASE 0x7000u
+#define TEST_EVENT_GROUP_ID 0x01u
+
+#define TEST_TX_PID_MULTICAST 0u
+#define TEST_TX_PID_UNICAST 1u
+#define TEST_RX_PID_MULTICAST 0u
+#define TEST_RX_PID_UNICAST 1u
+
+#define TEST_ROUNDS 10u
+
+#define TEST_ENTRY_FIND 0x00u
+#define TEST_ENTRY_OFFER 0x01u
+#define TEST_ENTRY_SUBSCRIBE 0x06u
+#define TEST_ENTRY_SUBSCRIBE_ACK 0x07u
+
+/* the SD header, the length of the entries array and the length of the options array */
+#define TEST_MSG_OVERHEAD 28u
+#define TEST_ENTRY_SIZE 16u
+#define TEST_IPV4_OPTION_SIZE 12u
+/* the entries of one SD message are limited by the Sd */
+#define TEST_MSG_ENTRIES_MAX 64u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t numOfMsgs;
+  uint32_t numOfBytes;
+  uint32_t numOfEntries;
+  uint32_t numOfOptions;
+  uint32_t numOfPartialMsgs; /* with room left for one more entry */
+  uint32_t numOfBadMsgs;     /* too long, or with an entry that refers to a missing option */
+  uint32_t numOfRxMsgs;
+  uint16_t serviceIds[SD_TEST_SERVICES];
+} test_stats_t;
+/* ================================ [ DECLARES  ] ============================================== */
+static void test_on_subscribe(boolean isSubscribe, TcpIp_SockAddrType *RemoteAddr);
+static void test_on_subscribe_ack(boolean isSubscribe);
+/* ================================ [ DATAS     ] ============================================== */
+static const Sd_ServerTimerType testServerTimer = {
+  1u,                                 /* InitialOfferDelayMax */
+  1u,                                 /* InitialOfferDelayMin */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(200),  /* InitialOfferRepetitionBaseDelay */
+  3,                                  /* InitialOfferRepetitionsMax */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(3000), /* OfferCyclicDelay */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(1500), /* RequestResponseMaxDelay */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(0),    /* RequestResponseMinDelay */
+  5,                                  /* TTL seconds */
+};
+
+static const Sd_ClientTimerType testClientTimer = {
+  SD_CONVERT_MS_TO_MAIN_CYCLES(100),  /* InitialFindDelayMax */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(10),   /* InitialFindDelayMin */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(200),  /* InitialFindRepetitionsBaseDelay */
+  3,                                  /* InitialFindRepetitionsMax */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(1500), /* RequestResponseMaxDelay */
+  SD_CONVERT_MS_TO_MAIN_CYCLES(0),    /* RequestResponseMinDelay */
+  5,                                  /* TTL seconds */
+};
+
+static Sd_EventHandlerContextType testEventHandlerContexts[SD_TEST_SERVICES];
+static Sd_EventHandlerType testEventHandlers[SD_TEST_SERVICES];
+static Sd_ServerServiceContextType testServerContexts[SD_TEST_SERVICES];
+static Sd_ServerServiceType testServerServices[SD_TEST_SERVICES];
+static const Sd_ServerServiceType *testServerServicesMap[SD_TEST_SERVICES];
+static uint16_t testEventHandlersMap[SD_TEST_SERVICES];
+static uint16_t testPerServiceEventHandlerMap[SD_TEST_SERVICES];
+
+static Sd_ConsumedEventGroupContextType testConsumedEventGroupContexts[SD_TEST_SERVICES];
+static Sd_ConsumedEventGroupType testConsumedEventGroups[SD_TEST_SERVICES];
+static Sd_ClientServiceContextType testClientContexts[SD_TEST_SERVICES];
+static Sd_ClientServiceType testClientServices[SD_TEST_SERVICES];
+static const Sd_ClientServiceType *testClientServicesMap[SD_TEST_SERVICES];
+static uint16_t testConsumedEventGroupsMap[SD_TEST_SERVICES];
+static uint16_t testPerServiceConsumedEventGroupsMap[SD_TEST_SERVICES];
+
+static uint8_t testBuffer[TEST_MSG_SIZE];
+static Sd_InstanceContextType testInstanceContext;
+
+static const Sd_InstanceType testInstances[] = {
+  {
+    "test",                                        /* Hostname */
+    0,                                             /* SubscribeEventgroupRetryDelay */
+    0,                                             /* SubscribeEventgroupRetryMax */
+    {TEST_RX_PID_MULTICAST, 0},                    /* MulticastRxPdu */
+    {TEST_RX_PID_UNICAST, 1},                      /* UnicastRxPdu */
+    {TEST_TX_PID_MULTICAST, TEST_TX_PID_UNICAST},  /* TxPdu */
+    testServerServices,                            /* ServerServices */
+    SD_TEST_SERVICES,                              /* numOfServerServices */
+    testClientServices,                            /* ClientServices */
+    SD_TEST_SERVICES,                              /* numOfClientServices */
+    testBuffer,                                    /* buffer */
+    sizeof(testBuffer),                            /* bufLen */
+    &testInstanceContext,                          /* context */
+  },
+};
+
+const Sd_ConfigType Sd_Config = {
+  testInstances,
+  ARRAY_SIZE(testInstances),
+  testServerServicesMap,
+  SD_TEST_SERVICES,
+  testClientServicesMap,
+  SD_TEST_SERVICES,
+  testEventHandlersMap,
+  testPerServiceEventHandlerMap,
+  SD_TEST_SERVICES,
+  testConsumedEventGroupsMap,
+  testPerServiceConsumedEventGroupsMap,
+  SD_TEST_SERVICES,
+};
+
+static test_stats_t testStats;
+static uint32_t testNumOfSubscribed;
+static uint32_t testNumOfAcked;
+static uint16_t testSessionId = 1u;
+static uint8_t testRxMsg[TEST_MSG_SIZE];
+/* ================================ [ LOCALS    ] ============================================== */
+static void test_on_subscribe(boolean isSubscribe, TcpIp_SockAddrType *RemoteAddr) {
+  (void)RemoteAddr;
+  if (isSubscribe) {
+    testNumOfSubscribed++;
+  }
+}
+
+static void test_on_subscribe_ack(boolean isSubscribe) {
+  if (isSubscribe) {
+    testNumOfAcked++;
+  }
+}
+
+static void test_setup(void) {
+  uint16_t i;
+
+  for (i = 0u; i < SD_TEST_SERVICES; i++) {
+    testEventHandlers[i].HandleId = i;
+    testEventHandlers[i].EventGroupId = TEST_EVENT_GROUP_ID;
+    testEventHandlers[i].MulticastTxPduId = (PduIdType)-1;
+    testEventHandlers[i].context = &testEventHandlerContexts[i];
+    testEventHandlers[i].onSubscribe = test_on_subscribe;
+
+    testServerServices[i].AutoAvailable = TRUE;
+    testServerServices[i].HandleId = i;
+    testServerServices[i].ServiceId = TEST_SERVICE_ID_BASE + i;
+    testServerServices[i].InstanceId = 1u + i;
+    testServerServices[i].SoConId = 2u + (i % TEST_SOCKETS);
+    testServerServices[i].ProtocolType = TCPIP_IPPROTO_UDP;
+    testServerServices[i].ServerTimer = &testServerTimer;
+    testServerServices[i].context = &testServerContexts[i];
+    testServerServices[i].EventHandlers = &testEventHandlers[i];
+    testServerServices[i].numOfEventHandlers = 1u;
+    testServerServices[i].SomeIpServiceId = i;
+    testServerServicesMap[i] = &testServerServices[i];
+    testEventHandlersMap[i] = i;
+    testPerServiceEventHandlerMap[i] = 0u;
+
+    testConsumedEventGroups[i].HandleId = i;
+    testConsumedEventGroups[i].EventGroupId = TEST_EVENT_GROUP_ID;
+    testConsumedEventGroups[i].context = &testConsumedEventGroupContexts[i];
+    testConsumedEventGroups[i].onSubscribe = test_on_subscribe_ack;
+
+    testClientServices[i].HandleId = i;
+    testClientServices[i].ServiceId = TEST_CLIENT_SERVICE_ID_BASE + i;
+    testClientServices[i].InstanceId = 1u + i;
+    testClientServices[i].MajorVersion = SD_ANY_MAJOR_VERSION;
+    testClientServices[i].MinorVersion = SD_ANY_MINOR_VERSION;
+    testClientServices[i].SoConId = 2u + TEST_SOCKETS + (i % TEST_SOCKETS);
+    testClientServices[i].ProtocolType = TCPIP_IPPROTO_UDP;
+    testClientServices[i].ClientTimer = &testClientTimer;
+    testClientServices[i].context = &testClientContexts[i];
+    testClientServices[i].ConsumedEventGroups = &testConsumedEventGroups[i];
+    testClientServices[i].numOfConsumedEventGroups = 1u;
+    testClientServicesMap[i] = &testClientServices[i];
+    testConsumedEventGroupsMap[i] = i;
+    testPerServiceConsumedEventGroupsMap[i] = 0u;
+  }
+}
+
+static void test_put32(uint8_t *data, uint32_t value) {
+  data[0] = (value >> 24) & 0xFFu;
+  data[1] = (value >> 16) & 0xFFu;
+  data[2] = (value >> 8) & 0xFFu;
+  data[3] = value & 0xFFu;
+}
+
+static uint32_t test_get32(const uint8_t *data) {
+  return ((uint32_t)data[0] << 24) + ((uint32_t)data[1] << 16) + ((uint32_t)data[2] << 8) +
+         data[3];
+}
+
+/* SD message of the remote ECU with the given entries which all refer to one endpoint option */
+static uint32_t test_build_rx_msg(uint8_t type, uint16_t serviceIdBase, uint16_t first,
+                                  uint16_t num, const TcpIp_SockAddrType *endpoint) {
+  uint8_t *data = testRxMsg;
+  uint8_t *entry;
+  uint8_t *option;
+  uint32_t lengthOfEntries = TEST_ENTRY_SIZE * num;
+  uint32_t lengthOfOptions = (TEST_ENTRY_FIND == type) ? 0u : TEST_IPV4_OPTION_SIZE;
+  uint32_t length = TEST_MSG_OVERHEAD + lengthOfEntries + lengthOfOptions;
+  uint16_t i;
+  uint16_t id;
+
+  memset(data, 0, length);
+  data[0] = 0xFFu;
+  data[1] = 0xFFu;
+  data[2] = 0x81u;
+  test_put32(&data[4], length - 8u);
+  data[10] = (testSessionId >> 8) & 0xFFu;
+  data[11] = testSessionId & 0xFFu;
+  testSessionId++;
+  if (0u == testSessionId) {
+    testSessionId = 1u;
+  }
+  data[12] = 0x01u;
+  data[13] = 0x01u;
+  data[14] = 0x02u;
+  data[16] = 0xC0u;
+  test_put32(&data[20], lengthOfEntries);
+  for (i = 0u; i < num; i++) {
+    id = first + i;
+    entry = &data[24u + TEST_ENTRY_SIZE * i];
+    entry[0] = type;
+    entry[3] = (0u == lengthOfOptions) ? 0x00u : 0x10u;
+    entry[4] = ((serviceIdBase + id) >> 8) & 0xFFu;
+    entry[5] = (serviceIdBase + id) & 0xFFu;
+    entry[6] = ((1u + id) >> 8) & 0xFFu;
+    entry[7] = (1u + id) & 0xFFu;
+    entry[8] = (TEST_ENTRY_FIND == type) ? 0xFFu : 0u;
+    entry[11] = 5u; /* TTL */
+    if ((TEST_ENTRY_SUBSCRIBE == type) || (TEST_ENTRY_SUBSCRIBE_ACK == type)) {
+      entry[15] = TEST_EVENT_GROUP_ID;
+    } else if (TEST_ENTRY_FIND == type) {
+      entry[12] = entry[13] = entry[14] = entry[15] = 0xFFu;
+    } else {
+      /* offer, minor version 0 */
+    }
+  }
+  test_put32(&data[24u + lengthOfEntries], lengthOfOptions);
+  if (0u != lengthOfOptions) {
+    option = &data[TEST_MSG_OVERHEAD + lengthOfEntries];
+    option[1] = 0x09u;
+    option[2] = 0x04u;
+    memcpy(&option[4], endpoint->addr, 4);
+    option[9] = TCPIP_IPPROTO_UDP;
+    option[10] = (endpoint->port >> 8) & 0xFFu;
+    option[11] = endpoint->port & 0xFFu;
+  }
+
+  return length;
+}
+
+/* receive all the entries of the type from the remote ECU packed into full SD messages */
+static void test_rx_storm(uint8_t type, uint16_t serviceIdBase,
+                          const TcpIp_SockAddrType *RemoteAddr, PduIdType RxPduId) {
+  uint16_t perMsg = (TEST_MSG_SIZE - TEST_MSG_OVERHEAD - TEST_IPV4_OPTION_SIZE) / TEST_ENTRY_SIZE;
+  uint16_t first;
+  uint16_t num;
+  PduInfoType pduInfo;
+
+  pduInfo.MetaDataPtr = (uint8_t *)RemoteAddr;
+  pduInfo.SduDataPtr = testRxMsg;
+  for (first = 0u; first < SD_TEST_SERVICES; first += num) {
+    num = SD_TEST_SERVICES - first;
+    if (num > perMsg) {
+      num = perMsg;
+    }
+    pduInfo.SduLength = test_build_rx_msg(type, serviceIdBase, first, num, RemoteAddr);
+    testStats.numOfRxMsgs++;
+    Sd_RxIndication(RxPduId, &pduInfo);
+  }
+}
+
+static void test_clients_storm(uint8_t type, uint32_t rounds) {
+  TcpIp_SockAddrType RemoteAddr = {40000u, {172, 18, 0, 10}};
+  PduIdType RxPduId = (TEST_ENTRY_FIND == type) ? TEST_RX_PID_MULTICAST : TEST_RX_PID_UNICAST;
+  uint32_t round;
+  uint16_t c;
+
+  memset(&testStats, 0, sizeof(testStats));
+  for (round = 0u; round < rounds; round++) {
+    for (c = 0u; c < SD_TEST_CLIENTS; c++) {
+      RemoteAddr.addr[3] = 10u + c;
+      test_rx_storm(type, TEST_SERVICE_ID_BASE, &RemoteAddr, RxPduId);
+    }
+  }
+}
+
+static void test_main_functions(uint32_t cycles) {
+  uint32_t i;
+
+  for (i = 0u; i < cycles; i++) {
+    Sd_MainFunction();
+  }
+}
+
+/* the messages are packed: only the last message of each answer or burst may have room left */
+static bool test_is_packed(uint32_t numOfAnswers) {
+  uint32_t size = TEST_MSG_OVERHEAD * testStats.numOfMsgs +
+                  TEST_ENTRY_SIZE * testStats.numOfEntries +
+                  TEST_IPV4_OPTION_SIZE * testStats.numOfOptions;
+
+  return (size == testStats.numOfBytes) && (0u == testStats.numOfBadMsgs) &&
+         (testStats.numOfPartialMsgs <= numOfAnswers);
+}
+
+/* all the entries of a message refer to one endpoint option per socket */
+static bool test_is_option_shared(void) {
+  return testStats.numOfOptions <= (testStats.numOfMsgs * TEST_SOCKETS);
+}
+
+static bool test_all_services(uint32_t times) {
+  uint16_t i;
+  bool r = true;
+
+  for (i = 0u; (i < SD_TEST_SERVICES) && r; i++) {
+    r = (testStats.serviceIds[i] == times);
+  }
+
+  return r;
+}
+
+static void test_report(bool bPass, const char *what) {
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %s: Rx %u msgs, Tx %u msgs %u bytes %u entries %u options, %u partial, %u bad\n",
+           what, testStats.numOfRxMsgs, testStats.numOfMsgs, testStats.numOfBytes,
+           testStats.numOfEntries, testStats.numOfOptions, testStats.numOfPartialMsgs,
+           testStats.numOfBadMsgs);
+    printf("  %u subscribed, %u acked\n", testNumOfSubscribed, testNumOfAcked);
+    exit(-1);
+  }
+}
+
+static void Test_OfferBurst(void) {
+  uint32_t cycles;
+  bool bPass;
+
+  printf("Test the offers of all the services after wake-up are packed:");
+  memset(&testStats, 0, sizeof(testStats));
+  for (cycles = 0u; cycles < 100u; cycles++) {
+    Sd_MainFunction();
+    if (testStats.numOfEntries >= SD_TEST_SERVICES) {
+      break;
+    }
+  }
+  bPass = (cycles <= 1u) && (SD_TEST_SERVICES == testStats.numOfEntries) &&
+          test_all_services(1u) && test_is_packed(1u) &&
+          test_is_option_shared();
+  test_report(bPass, "offer burst");
+}
+
+static void Test_FindStorm(void) {
+  TcpIp_SockAddrType RemoteAddr = {40000u, {172, 18, 0, 200}};
+  bool bPass;
+
+  printf("Test every find of %u remote ECUs is answered by a packed offer:", SD_TEST_CLIENTS);
+  test_clients_storm(TEST_ENTRY_FIND, 1u);
+  bPass = ((SD_TEST_CLIENTS * SD_TEST_SERVICES) == testStats.numOfEntries) &&
+          test_all_services(SD_TEST_CLIENTS) && test_is_packed(testStats.numOfRxMsgs) &&
+          test_is_option_shared();
+  if (bPass) {
+    /* the services which are not provided are not answered */
+    memset(&testStats, 0, sizeof(testStats));
+    test_rx_storm(TEST_ENTRY_FIND, TEST_UNKNOWN_SERVICE_ID_BASE, &RemoteAddr,
+                  TEST_RX_PID_MULTICAST);
+    bPass = (0u == testStats.numOfMsgs);
+  }
+  test_report(bPass, "find storm");
+}
+
+static void Test_SubscribeStorm(void) {
+  bool bPass;
+
+  printf("Test every subscribe of %u remote ECUs is acknowledged:", SD_TEST_CLIENTS);
+  test_clients_storm(TEST_ENTRY_SUBSCRIBE, 1u);
+  test_main_functions(10u); /* pending ACKs, if any */
+  bPass = ((SD_TEST_CLIENTS * SD_TEST_SERVICES) == testStats.numOfEntries) &&
+          ((SD_TEST_CLIENTS * SD_TEST_SERVICES) == testNumOfSubscribed) &&
+          test_all_services(SD_TEST_CLIENTS) && test_is_packed(testStats.numOfRxMsgs);
+  test_report(bPass, "subscribe storm");
+}
+
+static void Test_SubscribeRenewals(void) {
+  bool bPass;
+
+  printf("Test %u rounds of renewals are acknowledged without new subscribers:", TEST_ROUNDS);
+  test_clients_storm(TEST_ENTRY_SUBSCRIBE, TEST_ROUNDS);
+  bPass = ((TEST_ROUNDS * SD_TEST_CLIENTS * SD_TEST_SERVICES) == testStats.numOfEntries) &&
+          ((SD_TEST_CLIENTS * SD_TEST_SERVICES) == testNumOfSubscribed) &&
+          test_all_services(TEST_ROUNDS * SD_TEST_CLIENTS) &&
+          test_is_packed(testStats.numOfRxMsgs);
+  test_report(bPass, "subscribe renewals");
+}
+
+static void Test_RemoteOffers(void) {
+  TcpIp_SockAddrType RemoteAddr = {40000u, {172, 18, 0, 100}};
+  uint32_t cycles;
+  uint16_t c;
+  bool bPass;
+
+  printf("Test the subscribes to all the remote offers are packed and acknowledged:");
+  memset(&testStats, 0, sizeof(testStats));
+  /* the consumed services are not requested yet, the offers are not answered */
+  test_rx_storm(TEST_ENTRY_OFFER, TEST_CLIENT_SERVICE_ID_BASE, &RemoteAddr,
+                TEST_RX_PID_MULTICAST);
+  bPass = (0u == testStats.numOfMsgs);
+
+  /* all the offered services and their event groups are requested at once */
+  for (c = 0u; c < SD_TEST_SERVICES; c++) {
+    (void)Sd_ClientServiceSetState(c, SD_CLIENT_SERVICE_REQUESTED);
+    (void)Sd_ConsumedEventGroupSetState(c, SD_CONSUMED_EVENTGROUP_REQUESTED);
+  }
+  for (cycles = 0u; (cycles < 100u) && bPass; cycles++) {
+    Sd_MainFunction();
+    if (testStats.numOfEntries >= SD_TEST_SERVICES) {
+      break;
+    }
+  }
+  bPass = bPass && (cycles <= 1u) && (SD_TEST_SERVICES == testStats.numOfEntries) &&
+          test_all_services(1u) && test_is_packed(1u) &&
+          test_is_option_shared();
+
+  if (bPass) {
+    test_rx_storm(TEST_ENTRY_SUBSCRIBE_ACK, TEST_CLIENT_SERVICE_ID_BASE, &RemoteAddr,
+                  TEST_RX_PID_UNICAST);
+    bPass = (SD_TEST_SERVICES == testNumOfAcked);
+  }
+  test_report(bPass, "remote offers");
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  const uint8_t *data = PduInfoPtr->SduDataPtr;
+  const uint8_t *entry;
+  uint32_t lengthOfEntries;
+  uint32_t lengthOfOptions;
+  uint32_t numOfOptions;
+  uint32_t i;
+  uint16_t serviceId;
+  (void)TxPduId;
+
+  lengthOfEntries = test_get32(&data[20]);
+  lengthOfOptions = test_get32(&data[24u + lengthOfEntries]);
+  numOfOptions = lengthOfOptions / TEST_IPV4_OPTION_SIZE;
+  testStats.numOfMsgs++;
+  testStats.numOfBytes += PduInfoPtr->SduLength;
+  testStats.numOfEntries += lengthOfEntries / TEST_ENTRY_SIZE;
+  testStats.numOfOptions += numOfOptions;
+  if (PduInfoPtr->SduLength > TEST_MSG_SIZE) {
+    testStats.numOfBadMsgs++;
+  } else if (((PduInfoPtr->SduLength + TEST_ENTRY_SIZE + TEST_IPV4_OPTION_SIZE) <=
+              TEST_MSG_SIZE) &&
+             ((lengthOfEntries / TEST_ENTRY_SIZE) < TEST_MSG_ENTRIES_MAX)) {
+    testStats.numOfPartialMsgs++;
+  } else {
+    /* full */
+  }
+
+  for (i = 0u; i < (lengthOfEntries / TEST_ENTRY_SIZE); i++) {
+    entry = &data[24u + TEST_ENTRY_SIZE * i];
+    if (((entry[1] + (entry[3] >> 4)) > numOfOptions) ||
+        ((entry[2] + (entry[3] & 0x0Fu)) > numOfOptions)) {
+      testStats.numOfBadMsgs++;
+    }
+    serviceId = ((uint16_t)entry[4] << 8) + entry[5];
+    if (((serviceId & 0x0FFFu) < SD_TEST_SERVICES) && ((1u + (serviceId & 0x0FFFu)) ==
+                                                        (((uint16_t)entry[6] << 8) + entry[7]))) {
+      testStats.serviceIds[serviceId & 0x0FFFu]++;
+    } else {
+      testStats.numOfBadMsgs++;
+    }
+  }
+
+  return E_OK;
+}
+
+Std_ReturnType SoAd_GetLocalAddr(SoAd_SoConIdType SoConId, TcpIp_SockAddrType *LocalAddrPtr,
+                                 uint8_t *NetmaskPtr, TcpIp_SockAddrType *DefaultRouterPtr) {
+  (void)NetmaskPtr;
+  (void)DefaultRouterPtr;
+  LocalAddrPtr->addr[0] = 172;
+  LocalAddrPtr->addr[1] = 18;
+  LocalAddrPtr->addr[2] = 0;
+  LocalAddrPtr->addr[3] = 200;
+  LocalAddrPtr->port = 30500u + SoConId;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_GetSoConId(PduIdType TxPduId, SoAd_SoConIdType *SoConIdPtr) {
+  *SoConIdPtr = (SoAd_SoConIdType)TxPduId;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_OpenSoCon(SoAd_SoConIdType SoConId) {
+  (void)SoConId;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_CloseSoCon(SoAd_SoConIdType SoConId, boolean abort) {
+  (void)SoConId;
+  (void)abort;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_SetRemoteAddr(SoAd_SoConIdType SoConId,
+                                  const TcpIp_SockAddrType *RemoteAddrPtr) {
+  (void)SoConId;
+  (void)RemoteAddrPtr;
+  return E_OK;
+}
+
+boolean TcpIp_IsLinkedUp(void) {
+  return TRUE;
+}
+
+Std_ReturnType SomeIp_ResolveSubscriber(uint16_t ServiceId, Sd_EventHandlerSubscriberType *sub) {
+  (void)ServiceId;
+  sub->TxPduId = 0u;
+  return E_OK;
+}
+
+int main(int argc, char *argv[]) {
+  test_setup();
+  Sd_Init(NULL);
+
+  Test_OfferBurst();
+  Test_FindStorm();
+  Test_SubscribeStorm();
+  Test_SubscribeRenewals();
+  Test_RemoteOffers();
+
+  return 0;
+}
@@ -38,12 +38,44 @@ static void SecOC_BitMove(uint8_t *buffer, uint16_t toBitPos, uint16_t fromBitPo
   }
 }
 
+static void SecOC_ProcTx(PduIdType TxPduId);
+static void SecOC_ProcRx(PduIdType RxPduId);
+
+static void SecOC_TxMacNotification(void *ctx, Std_ReturnType result) {
+  const SecOC_TxPduProcessingType *TxPduProc = (const SecOC_TxPduProcessingType *)ctx;
+  PduIdType TxPduId = (PduIdType)(TxPduProc - SECOC_CONFIG->TxPduProcs);
+
+  if (SECOC_TXPDU_PROC_STATE_AUTHENTICATING == TxPduProc->context->state) {
+    if (E_OK == result) {
+      TxPduProc->context->state = SECOC_TXPDU_PROC_STATE_ASSEMBLE;
+      SecOC_ProcTx(TxPduId); /* send it out in this cycle */
+    } else {
+      ASLOG(SECOCE, ("[%u] TxPdu authenticate FAIL\n", TxPduId));
+      TxPduProc->context->state = SECOC_TXPDU_PROC_STATE_REQUEST;
+    }
+  }
+}
+
+static void SecOC_RxMacNotification(void *ctx, Std_ReturnType result) {
+  const SecOC_RxPduProcessingType *RxPduProc = (const SecOC_RxPduProcessingType *)ctx;
+  PduIdType RxPduId = (PduIdType)(RxPduProc - SECOC_CONFIG->RxPduProcs);
+
+  if (SECOC_RXPDU_PROC_STATE_VERIFYING == RxPduProc->context->state) {
+    if (E_OK == result) {
+      RxPduProc->context->state = SECOC_RXPDU_PROC_STATE_CHECK;
+      SecOC_ProcRx(RxPduId);
+    } else {
+      ASLOG(SECOCE, ("[%u] RxPdu verify FAIL\n", RxPduId));
+      RxPduProc->context->state = SECOC_RXPDU_PROC_STATE_IDLE;
+    }
+  }
+}
+
 static void SecOC_ProcTx(PduIdType TxPduId) {
   Std_ReturnType ret = E_OK;
   const SecOC_TxPduProcessingType *TxPduProc;
   uint32_t FreshnessValueLength;
   uint16_t dataLength;
-  uint32_t macLength;
   uint32_t bitPos;
   uint8_t i;
   PduInfoType PduInfo;
@@ -61,28 +93,21 @@ static void SecOC_ProcTx(PduIdType TxPduId) {
         &FreshnessValueLength);
     }
     if (E_OK == ret) {
+      TxPduProc->context->FreshnessValueLength = (uint8_t)FreshnessValueLength;
       dataLength = 2u + TxPduProc->context->SduLength + ((FreshnessValueLength + 7u) >> 3);
-      macLength = (TxPduProc->AuthInfoLength + 7u) >> 3;
-      ret =
-        Csm_MacGenerate(TxPduProc->TxAuthServiceConfigRef, CRYPTO_OPERATION_MODE_START,
-                        &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u], dataLength,
-                        &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u + dataLength], &macLength);
-    }
-    if (E_OK == ret) {
-      ret =
-        Csm_MacGenerate(TxPduProc->TxAuthServiceConfigRef, CRYPTO_OPERATION_MODE_UPDATE,
-                        &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u], dataLength,
-                        &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u + dataLength], &macLength);
-    }
-    if (E_OK == ret) {
-      ret =
-        Csm_MacGenerate(TxPduProc->TxAuthServiceConfigRef, CRYPTO_OPERATION_MODE_FINISH,
-                        &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u], dataLength,
-                        &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u + dataLength], &macLength);
+      TxPduProc->context->macLength = (TxPduProc->AuthInfoLength + 7u) >> 3;
+      /* the MAC of all the PDUs requested in this cycle is calculated as one batch by Csm */
+      ret = Csm_MacGenerateAsync(TxPduProc->TxAuthServiceConfigRef,
+                                 &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u], dataLength,
+                                 &TxPduProc->buffer[TxPduProc->AuthPduOffset - 2u + dataLength],
+                                 &TxPduProc->context->macLength, SecOC_TxMacNotification,
+                                 (void *)TxPduProc);
     }
 
     if (E_OK == ret) {
-      TxPduProc->context->state = SECOC_TXPDU_PROC_STATE_ASSEMBLE;
+      TxPduProc->context->state = SECOC_TXPDU_PROC_STATE_AUTHENTICATING;
+    } else if (E_BUSY == ret) {
+      /* Csm job queue is full, retry in the next cycle */
     } else {
       ASLOG(SECOCE, ("[%u] TxPdu update FAIL\n", TxPduId));
     }
@@ -90,6 +115,7 @@ static void SecOC_ProcTx(PduIdType TxPduId) {
 
   if (SECOC_TXPDU_PROC_STATE_ASSEMBLE == TxPduProc->context->state) {
     /* @SWS_SecOC_00262 */
+    FreshnessValueLength = TxPduProc->context->FreshnessValueLength;
     dataLength = TxPduProc->context->SduLength;
     for (i = 0; i < TxPduProc->AuthPduHeaderLength; i++) {
       TxPduProc->buffer[TxPduProc->AuthPduOffset - 1u - i] = dataLength & 0xFFu;
@@ -165,50 +191,55 @@ static void SecOC_ProcRx(PduIdType RxPduId) {
                              &FreshnessValueLength);
     }
     if (E_OK == ret) {
-      macLength = (RxPduProc->AuthInfoLength + 7u) >> 3;
-      ret = Csm_MacGenerate(RxPduProc->RxAuthServiceConfigRef, CRYPTO_OPERATION_MODE_START,
-                            &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength],
-                            2u + dataLength + ((FreshnessValueLength + 7u) >> 3),
-                            &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength + 2u + dataLength +
-                                               ((FreshnessValueLength + 7u) >> 3)],
-                            &macLength);
-    }
-    if (E_OK == ret) {
-      ret = Csm_MacGenerate(RxPduProc->RxAuthServiceConfigRef, CRYPTO_OPERATION_MODE_UPDATE,
-                            &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength],
-                            2u + dataLength + ((FreshnessValueLength + 7u) >> 3),
-                            &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength + 2u + dataLength +
-                                               ((FreshnessValueLength + 7u) >> 3)],
-                            &macLength);
+      RxPduProc->context->DataLength = dataLength;
+      RxPduProc->context->FreshnessValueLength = (uint8_t)FreshnessValueLength;
+      RxPduProc->context->state = SECOC_RXPDU_PROC_STATE_ASSEMBLE;
+    } else {
+      ASLOG(SECOCE, ("[%u] RxPdu verify FAIL\n", RxPduId));
+      RxPduProc->context->state = SECOC_RXPDU_PROC_STATE_IDLE;
     }
+  }
+
+  if (SECOC_RXPDU_PROC_STATE_ASSEMBLE == RxPduProc->context->state) {
+    dataLength = RxPduProc->context->DataLength;
+    FreshnessValueLength = RxPduProc->context->FreshnessValueLength;
+    RxPduProc->context->macLength = (RxPduProc->AuthInfoLength + 7u) >> 3;
+    ret = Csm_MacGenerateAsync(RxPduProc->RxAuthServiceConfigRef,
+                               &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength],
+                               2u + dataLength + ((FreshnessValueLength + 7u) >> 3),
+                               &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength + 2u + dataLength +
+                                                  ((FreshnessValueLength + 7u) >> 3)],
+                               &RxPduProc->context->macLength, SecOC_RxMacNotification,
+                               (void *)RxPduProc);
     if (E_OK == ret) {
-      ret = Csm_MacGenerate(RxPduProc->RxAuthServiceConfigRef, CRYPTO_OPERATION_MODE_FINISH,
-                            &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength],
-                            2u + dataLength + ((FreshnessValueLength + 7u) >> 3),
-                            &RxPduProc->buffer[RxPduProc->AuthPduHeaderLength + 2u + dataLength +
-                                               ((FreshnessValueLength + 7u) >> 3)],
-                            &macLength);
+      RxPduProc->context->state = SECOC_RXPDU_PROC_STATE_VERIFYING;
+    } else if (E_BUSY == ret) {
+      /* Csm job queue is full, retry in the next cycle */
+    } else {
+      ASLOG(SECOCE, ("[%u] RxPdu verify FAIL\n", RxPduId));
+      RxPduProc->context->state = SECOC_RXPDU_PROC_STATE_IDLE;
     }
+  }
 
-    if (E_OK == ret) {
-      /* assemble */
-      bitPos = (2u + RxPduProc->AuthPduHeaderLength + dataLength) * 8u;
-      SecOC_BitMove(RxPduProc->buffer, bitPos,
-                    bitPos + FreshnessValueLength - RxPduProc->FreshnessValueTruncLength,
-                    RxPduProc->FreshnessValueTruncLength);
-      bitPos += RxPduProc->FreshnessValueTruncLength;
-      SecOC_BitMove(RxPduProc->buffer, bitPos,
-                    bitPos + FreshnessValueLength - RxPduProc->FreshnessValueTruncLength,
-                    RxPduProc->AuthInfoTruncLength);
-      macLength =
-        (((uint16_t)RxPduProc->FreshnessValueTruncLength + RxPduProc->AuthInfoTruncLength + 7) >>
-         3);
-      for (i = 0; i < macLength; i++) {
-        if (RxPduProc->buffer[2u + RxPduProc->AuthPduHeaderLength + dataLength + i] !=
-            RxPduProc->buffer[RxPduProc->bufLen - macLength + i]) {
-          ret = E_NOT_OK;
-          break;
-        }
+  if (SECOC_RXPDU_PROC_STATE_CHECK == RxPduProc->context->state) {
+    dataLength = RxPduProc->context->DataLength;
+    FreshnessValueLength = RxPduProc->context->FreshnessValueLength;
+    /* assemble */
+    bitPos = (2u + RxPduProc->AuthPduHeaderLength + dataLength) * 8u;
+    SecOC_BitMove(RxPduProc->buffer, bitPos,
+                  bitPos + FreshnessValueLength - RxPduProc->FreshnessValueTruncLength,
+                  RxPduProc->FreshnessValueTruncLength);
+    bitPos += RxPduProc->FreshnessValueTruncLength;
+    SecOC_BitMove(RxPduProc->buffer, bitPos,
+                  bitPos + FreshnessValueLength - RxPduProc->FreshnessValueTruncLength,
+                  RxPduProc->AuthInfoTruncLength);
+    macLength =
+      (((uint16_t)RxPduProc->FreshnessValueTruncLength + RxPduProc->AuthInfoTruncLength + 7) >> 3);
+    for (i = 0; i < macLength; i++) {
+      if (RxPduProc->buffer[2u + RxPduProc->AuthPduHeaderLength + dataLength + i] !=
+          RxPduProc->buffer[RxPduProc->bufLen - macLength + i]) {
+        ret = E_NOT_OK;
+        break;
       }
     }
 
@@ -267,6 +298,11 @@ Std_ReturnType SecOC_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr
                 ((TxPduProc->FreshnessValueLength + 7) / 8) +
                 ((TxPduProc->AuthInfoLength + 7) / 8)) < TxPduProc->bufLen,
                0x49, SECOC_E_PARAM_POINTER, return E_NOT_OK);
+  if (SECOC_TXPDU_PROC_STATE_AUTHENTICATING == TxPduProc->context->state) {
+    /* the working buffer is in use by the Csm job */
+    ASLOG(SECOCE, ("[%u] TxPdu is authenticating\n", TxPduId));
+    return E_NOT_OK;
+  }
   (void)memcpy(&TxPduProc->buffer[TxPduProc->AuthPduOffset], PduInfoPtr->SduDataPtr,
                PduInfoPtr->SduLength);
 
@@ -304,6 +340,9 @@ void SecOC_RxIndication(PduIdType RxPduId, const PduInfoType *PduInfoPtr) {
                0x42, SECOC_E_PARAM_POINTER, return);
   if (SECOC_RXPDU_PROC_STATE_IDLE != RxPduProc->context->state) {
     ASLOG(SECOCE, ("[%u] RxPdu in state %u\n", RxPduId, RxPduProc->context->state));
+    if (SECOC_RXPDU_PROC_STATE_VERIFYING == RxPduProc->context->state) {
+      return; /* the working buffer is in use by the Csm job */
+    }
   }
 
   (void)memcpy(&RxPduProc->buffer[2u], PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
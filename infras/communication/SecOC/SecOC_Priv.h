@@ -17,12 +17,14 @@
 #define SECOC_TXPDU_PROC_STATE_ASSEMBLE ((SecOC_TxPduProcStateType)2)
 #define SECOC_TXPDU_PROC_STATE_READY ((SecOC_TxPduProcStateType)3)
 #define SECOC_TXPDU_PROC_STATE_WAIT_TX_DONE ((SecOC_TxPduProcStateType)4)
+#define SECOC_TXPDU_PROC_STATE_AUTHENTICATING ((SecOC_TxPduProcStateType)5)
 
 #define SECOC_RXPDU_PROC_STATE_IDLE ((SecOC_RxPduProcStateType)0)
 #define SECOC_RXPDU_PROC_STATE_RECEIVED ((SecOC_RxPduProcStateType)1)
 #define SECOC_RXPDU_PROC_STATE_ASSEMBLE ((SecOC_RxPduProcStateType)2)
 #define SECOC_RXPDU_PROC_STATE_CHECK ((SecOC_RxPduProcStateType)3)
 #define SECOC_RXPDU_PROC_STATE_TP_RECV ((SecOC_RxPduProcStateType)4)
+#define SECOC_RXPDU_PROC_STATE_VERIFYING ((SecOC_RxPduProcStateType)5)
 
 #define SECOC_RX_OVERFLOW_QUEUE ((SecOC_ReceptionOverflowStrategyType)0x0)
 #define SECOC_RX_OVERFLOW_REJECT ((SecOC_ReceptionOverflowStrategyType)0x1)
@@ -39,7 +41,9 @@ typedef struct {
 typedef uint8_t SecOC_TxPduProcStateType;
 
 typedef struct {
+  uint32_t macLength; /* MAC length of the pending Csm job */
   PduLengthType SduLength;
+  uint8_t FreshnessValueLength;
   SecOC_TxPduProcStateType state;
 } SecOC_TxPduProcContextType;
 
@@ -71,7 +75,10 @@ typedef uint8_t SecOC_ReceptionOverflowStrategyType;
 typedef uint8_t SecOC_RxPduProcStateType;
 
 typedef struct {
+  uint32_t macLength; /* MAC length of the pending Csm job */
   PduLengthType SduLength;
+  PduLengthType DataLength; /* length of the Authentic I-PDU */
+  uint8_t FreshnessValueLength;
   SecOC_RxPduProcStateType state;
 } SecOC_RxPduProcContextType;
 
@@ -0,0 +1,350 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * SecOC throughput: every cycle all the PDUs are authenticated, looped back and verified through
+ * the asynchronous Csm job queue. The AES-CMAC is first checked against the RFC 4493 vectors, the
+ * functional checks of the loop back are done by secoc_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "SecOC.h"
+#include "SecOC_Priv.h"
+#include "SecOC_Cfg.h"
+#include "PduR_SecOC.h"
+#include "Csm.h"
+#include "Csm_Priv.h"
+#include "mbedtls/cmac.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define BENCH_AUTH_INFO_LENGTH 128u
+#define BENCH_AUTH_INFO_TRUNC_LENGTH 64u
+#define BENCH_FV_LENGTH 32u
+#define BENCH_FV_TRUNC_LENGTH 8u
+#define BENCH_HEADER_LENGTH 3u
+#define BENCH_MAX_PAYLOAD 64u
+
+#define BENCH_TX_BUF_LEN                                                                           \
+  (BENCH_HEADER_LENGTH + BENCH_AUTH_INFO_LENGTH / 8 + BENCH_MAX_PAYLOAD + BENCH_FV_LENGTH / 8)
+/* the received truncated MAC is backed up behind the full MAC calculated in place */
+#define BENCH_RX_BUF_LEN                                                                           \
+  (2u + BENCH_TX_BUF_LEN + (BENCH_AUTH_INFO_TRUNC_LENGTH + BENCH_FV_TRUNC_LENGTH + 7u) / 8)
+
+#define BENCH_JOB_NATIVE 0u
+#define BENCH_JOB_MBEDTLS 1u
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+static Std_ReturnType Bench_GetFreshness(uint8_t *FreshnessValue, uint32_t *FreshnessValueLength);
+/* ================================ [ DATAS     ] ============================================== */
+static const SecOC_FreshnessValueType SecOC_FreshnessValues[] = {
+  {Bench_GetFreshness, BENCH_FV_LENGTH},
+};
+
+static SecOC_TxPduProcContextType txContexts[SECOC_TEST_MAX_PDUS];
+static SecOC_RxPduProcContextType rxContexts[SECOC_TEST_MAX_PDUS];
+static uint8_t txBuffers[SECOC_TEST_MAX_PDUS][BENCH_TX_BUF_LEN];
+static uint8_t rxBuffers[SECOC_TEST_MAX_PDUS][BENCH_RX_BUF_LEN];
+static SecOC_TxPduProcessingType txProcs[SECOC_TEST_MAX_PDUS];
+static SecOC_RxPduProcessingType rxProcs[SECOC_TEST_MAX_PDUS];
+
+const SecOC_ConfigType SecOC_Config = {
+  SecOC_FreshnessValues, txProcs, rxProcs, SECOC_TEST_MAX_PDUS, SECOC_TEST_MAX_PDUS, 1,
+};
+
+static const uint8_t benchKey[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                     0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+static Csm_AesCmacContextType nativeContext;
+static mbedtls_cipher_context_t mbedtlsContext;
+
+static uint8_t payloads[SECOC_TEST_MAX_PDUS][BENCH_MAX_PAYLOAD];
+static PduIdType txPending[SECOC_TEST_MAX_PDUS];
+static uint32_t numTxPending;
+static uint32_t numTxConfirmed;
+static uint32_t numRxVerified;
+static uint32_t numRxCorrupted;
+static uint32_t payloadLength = 16;
+/* ================================ [ LOCALS    ] ============================================== */
+static Std_ReturnType Bench_GetFreshness(uint8_t *FreshnessValue, uint32_t *FreshnessValueLength) {
+  FreshnessValue[0] = 0x00;
+  FreshnessValue[1] = 0x00;
+  FreshnessValue[2] = 0x12;
+  FreshnessValue[3] = 0x34;
+  *FreshnessValueLength = BENCH_FV_LENGTH;
+  return E_OK;
+}
+
+/* the generated mbedtls cipher CMAC primitive, as the reference */
+static Std_ReturnType Bench_MbedTlsInit(void *AlgorithmContext, const uint8_t *AlgorithmKey,
+                                        uint32_t AlgorithmKeyLength) {
+  mbedtls_cipher_context_t *pCtx = (mbedtls_cipher_context_t *)AlgorithmContext;
+  mbedtls_cipher_init(pCtx);
+  if (0 != mbedtls_cipher_setup(pCtx, mbedtls_cipher_info_from_type(MBEDTLS_CIPHER_AES_128_ECB))) {
+    return E_NOT_OK;
+  }
+  return (0 == mbedtls_cipher_cmac_starts(pCtx, AlgorithmKey, AlgorithmKeyLength * 8)) ? E_OK
+                                                                                        : E_NOT_OK;
+}
+
+static Std_ReturnType Bench_MbedTlsStart(void *AlgorithmContext) {
+  return (0 == mbedtls_cipher_cmac_reset((mbedtls_cipher_context_t *)AlgorithmContext)) ? E_OK
+                                                                                      : E_NOT_OK;
+}
+
+static Std_ReturnType Bench_MbedTlsUpdate(void *AlgorithmContext, const uint8_t *data,
+                                          uint32_t len) {
+  return (0 == mbedtls_cipher_cmac_update((mbedtls_cipher_context_t *)AlgorithmContext, data, len))
+           ? E_OK
+           : E_NOT_OK;
+}
+
+static Std_ReturnType Bench_MbedTlsFinish(void *AlgorithmContext, uint8_t *mac, uint32_t *len) {
+  if (0 != mbedtls_cipher_cmac_finish((mbedtls_cipher_context_t *)AlgorithmContext, mac)) {
+    return E_NOT_OK;
+  }
+  *len = 16u;
+  return E_OK;
+}
+
+static void Bench_MbedTlsDeinit(void *AlgorithmContext) {
+  mbedtls_cipher_free((mbedtls_cipher_context_t *)AlgorithmContext);
+}
+
+static const Csm_MacGenPrimitiveType Bench_MbedTlsPrimitive = {
+  Bench_MbedTlsInit,   Bench_MbedTlsStart,  Bench_MbedTlsUpdate,
+  Bench_MbedTlsFinish, Bench_MbedTlsDeinit, NULL,
+};
+
+static const Csm_MacGenerateConfigType Csm_MacGenerateConfigs[] = {
+  {&nativeContext, benchKey, &Csm_AesCmacPrimitive, NULL, sizeof(benchKey), CRYPTO_ALGOFAM_AES,
+   CRYPTO_ALGOMODE_CMAC},
+  {&mbedtlsContext, benchKey, &Bench_MbedTlsPrimitive, NULL, sizeof(benchKey),
+   CRYPTO_ALGOFAM_AES, CRYPTO_ALGOMODE_CMAC},
+};
+
+static const Csm_JobConfigType Csm_JobConfigs[] = {
+  {BENCH_JOB_NATIVE, CRYPTO_MAC_GENERATE},
+  {BENCH_JOB_MBEDTLS, CRYPTO_MAC_GENERATE},
+};
+
+const Csm_ConfigType Csm_Config = {
+  Csm_JobConfigs,
+  Csm_MacGenerateConfigs,
+  sizeof(Csm_JobConfigs) / sizeof(Csm_JobConfigs[0]),
+  sizeof(Csm_MacGenerateConfigs) / sizeof(Csm_MacGenerateConfigs[0]),
+};
+
+static double Bench_Now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int Bench_CmacVectors(void) {
+  /* RFC 4493 section 4 */
+  static const uint8_t M[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+  static const uint8_t T[4][16] = {
+    {0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67,
+     0x46},
+    {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28,
+     0x7c},
+    {0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8,
+     0x27},
+    {0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c,
+     0xfe},
+  };
+  static const uint32_t L[4] = {0, 16, 40, 64};
+  const Csm_MacGenPrimitiveType *p = &Csm_AesCmacPrimitive;
+  boolean hw = nativeContext.hw;
+  uint8_t mac[16];
+  uint32_t macLen;
+  int errors = 0;
+  int pass;
+  int i;
+
+  for (pass = 0; pass < 2; pass++) {
+    nativeContext.hw = (0 == pass) ? hw : FALSE;
+    for (i = 0; i < 4; i++) {
+      macLen = sizeof(mac);
+      (void)p->SingleCallFnc(&nativeContext, M, L[i], mac, &macLen);
+      errors += (0 != memcmp(mac, T[i], 16)) ? 1 : 0;
+      /* streaming in odd pieces */
+      macLen = sizeof(mac);
+      (void)p->StartFnc(&nativeContext);
+      (void)p->UpdateFnc(&nativeContext, M, L[i] / 3);
+      (void)p->UpdateFnc(&nativeContext, &M[L[i] / 3], L[i] - L[i] / 3);
+      (void)p->FinishFnc(&nativeContext, mac, &macLen);
+      errors += (0 != memcmp(mac, T[i], 16)) ? 1 : 0;
+    }
+  }
+  nativeContext.hw = hw;
+  printf("AES-CMAC RFC 4493 vectors: %s (AES %s)\n", (0 == errors) ? "PASS" : "FAIL",
+         hw ? "hardware" : "software");
+  return errors;
+}
+
+static void Bench_Setup(uint32_t jobId) {
+  uint32_t i;
+  for (i = 0; i < SECOC_TEST_MAX_PDUS; i++) {
+    txProcs[i].context = &txContexts[i];
+    txProcs[i].buffer = txBuffers[i];
+    txProcs[i].TxAuthServiceConfigRef = jobId;
+    txProcs[i].FwTxPduId = (PduIdType)i;
+    txProcs[i].UpTxPduId = (PduIdType)i;
+    txProcs[i].bufLen = BENCH_TX_BUF_LEN;
+    txProcs[i].AuthInfoLength = BENCH_AUTH_INFO_LENGTH;
+    txProcs[i].AuthInfoTruncLength = BENCH_AUTH_INFO_TRUNC_LENGTH;
+    txProcs[i].DataId = (uint16_t)(0x1000 + i);
+    txProcs[i].FreshnessValueId = 0;
+    txProcs[i].FreshnessValueLength = BENCH_FV_LENGTH;
+    txProcs[i].FreshnessValueTruncLength = BENCH_FV_TRUNC_LENGTH;
+    txProcs[i].TxPduUnusedAreasDefault = 0x55;
+    txProcs[i].AuthPduHeaderLength = BENCH_HEADER_LENGTH;
+    txProcs[i].AuthPduOffset = BENCH_HEADER_LENGTH;
+
+    rxProcs[i].context = &rxContexts[i];
+    rxProcs[i].buffer = rxBuffers[i];
+    rxProcs[i].RxAuthServiceConfigRef = jobId;
+    rxProcs[i].UpRxPduId = (PduIdType)i;
+    rxProcs[i].bufLen = BENCH_RX_BUF_LEN;
+    rxProcs[i].AuthInfoLength = BENCH_AUTH_INFO_LENGTH;
+    rxProcs[i].AuthInfoTruncLength = BENCH_AUTH_INFO_TRUNC_LENGTH;
+    rxProcs[i].DataId = (uint16_t)(0x1000 + i);
+    rxProcs[i].FreshnessValueId = 0;
+    rxProcs[i].FreshnessValueLength = BENCH_FV_LENGTH;
+    rxProcs[i].FreshnessValueTruncLength = BENCH_FV_TRUNC_LENGTH;
+    rxProcs[i].AuthPduHeaderLength = BENCH_HEADER_LENGTH;
+    rxProcs[i].UseAuthDataFreshness = FALSE;
+  }
+}
+
+static void usage(char *prog) {
+  printf("usage: %s [-n PDUs] [-c cycles] [-l payload length] [-m]\n"
+         "\t-m: use the mbedtls cipher CMAC primitive instead of the native AES-CMAC\n",
+         prog);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType PduR_SecOCTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  (void)PduInfoPtr;
+  txPending[numTxPending++] = TxPduId;
+  return E_OK;
+}
+
+void PduR_SecOCTxConfirmation(PduIdType TxPduId, Std_ReturnType result) {
+  (void)TxPduId;
+  if (E_OK == result) {
+    numTxConfirmed++;
+  }
+}
+
+void PduR_SecOCRxIndication(PduIdType RxPduId, const PduInfoType *PduInfoPtr) {
+  if ((PduInfoPtr->SduLength == payloadLength) &&
+      (0 == memcmp(PduInfoPtr->SduDataPtr, payloads[RxPduId], payloadLength))) {
+    numRxVerified++;
+  } else {
+    numRxCorrupted++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int ch;
+  uint32_t numPdus = 256;
+  uint32_t cycles = 1000;
+  uint32_t jobId = BENCH_JOB_NATIVE;
+  uint32_t cycle;
+  uint32_t i;
+  uint32_t requested = 0;
+  uint32_t drain;
+  PduInfoType PduInfo;
+  double start;
+  double elapsed;
+
+  opterr = 0;
+  while ((ch = getopt(argc, argv, "c:hl:mn:")) != -1) {
+    switch (ch) {
+    case 'c':
+      cycles = strtoul(optarg, NULL, 0);
+      break;
+    case 'l':
+      payloadLength = strtoul(optarg, NULL, 0);
+      break;
+    case 'm':
+      jobId = BENCH_JOB_MBEDTLS;
+      break;
+    case 'n':
+      numPdus = strtoul(optarg, NULL, 0);
+      break;
+    case 'h':
+    default:
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  if ((numPdus > SECOC_TEST_MAX_PDUS) || (payloadLength > BENCH_MAX_PAYLOAD) ||
+      (0 == payloadLength)) {
+    usage(argv[0]);
+    return -1;
+  }
+
+  Bench_Setup(jobId);
+  Csm_Init(NULL);
+  SecOC_Init(NULL);
+  if (0 != Bench_CmacVectors()) {
+    return -1;
+  }
+
+  for (i = 0; i < numPdus; i++) {
+    memset(payloads[i], (int)i, payloadLength);
+  }
+
+  start = Bench_Now();
+  for (cycle = 0; cycle < cycles; cycle++) {
+    for (i = 0; i < numPdus; i++) {
+      /* a new request only when the loop back of the previous one is done */
+      if ((SECOC_TXPDU_PROC_STATE_IDLE == txContexts[i].state) &&
+          (SECOC_RXPDU_PROC_STATE_IDLE == rxContexts[i].state)) {
+        PduInfo.SduDataPtr = payloads[i];
+        PduInfo.SduLength = payloadLength;
+        if (E_OK == SecOC_IfTransmit((PduIdType)i, &PduInfo)) {
+          requested++;
+        }
+      }
+    }
+    SecOC_MainFunctionTx();
+    SecOC_MainFunctionRx();
+    Csm_MainFunction();
+    for (i = 0; i < numTxPending; i++) {
+      SecOC_TxConfirmation(txPending[i], E_OK);
+    }
+    numTxPending = 0;
+  }
+  /* drain what is still in flight */
+  for (drain = 0; (drain < 1000) && (numRxVerified + numRxCorrupted) < requested; drain++) {
+    SecOC_MainFunctionTx();
+    SecOC_MainFunctionRx();
+    Csm_MainFunction();
+    for (i = 0; i < numTxPending; i++) {
+      SecOC_TxConfirmation(txPending[i], E_OK);
+    }
+    numTxPending = 0;
+    usleep(100);
+  }
+  elapsed = Bench_Now() - start;
+
+  printf("%s CMAC, %u PDUs x %u cycles, payload %u bytes\n",
+         (BENCH_JOB_NATIVE == jobId) ? "native" : "mbedtls", numPdus, cycles, payloadLength);
+  printf("requested %u, confirmed %u, verified %u, corrupted %u\n", requested, numTxConfirmed,
+         numRxVerified, numRxCorrupted);
+  printf("%.3f s, %.0f secured PDUs/s (authenticate + verify), %.2f us per cycle\n", elapsed,
+         numRxVerified / elapsed, elapsed * 1e6 / cycles);
+
+  return ((numRxVerified == requested) && (0 == numRxCorrupted)) ? 0 : -1;
+}
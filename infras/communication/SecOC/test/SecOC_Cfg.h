@@ -0,0 +1,28 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * SecOC config of the loop back test, the PDUs are set up at runtime by secoc_test.c
+ */
+#ifndef SECOC_CFG_H
+#define SECOC_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef SECOC_MAIN_FUNCTION_PERIOD
+#define SECOC_MAIN_FUNCTION_PERIOD 1u
+#endif
+#define SECOC_CONVERT_MS_TO_MAIN_CYCLES(x)                                                         \
+  ((x + SECOC_MAIN_FUNCTION_PERIOD - 1u) / SECOC_MAIN_FUNCTION_PERIOD)
+
+/* each secured PDU is looped back to the Rx PDU with the same ID */
+#define SECOC_SELF_TEST
+
+#ifndef SECOC_TEST_MAX_PDUS
+#define SECOC_TEST_MAX_PDUS 256
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* SECOC_CFG_H */
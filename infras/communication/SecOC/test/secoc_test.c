@@ -0,0 +1,382 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * SecOC through the asynchronous Csm job queue: every cycle all the PDUs are authenticated, looped
+ * back and verified, with the native AES-CMAC and with the mbedtls cipher CMAC. The AES-CMAC is
+ * first checked against the RFC 4493 vectors.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "SecOC.h"
+#include "SecOC_Priv.h"
+#include "SecOC_Cfg.h"
+#include "PduR_SecOC.h"
+#include "Csm.h"
+#include "Csm_Priv.h"
+#include "mbedtls/cmac.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define TEST_AUTH_INFO_LENGTH 128u
+#define TEST_AUTH_INFO_TRUNC_LENGTH 64u
+#define TEST_FV_LENGTH 32u
+#define TEST_FV_TRUNC_LENGTH 8u
+#define TEST_HEADER_LENGTH 3u
+#define TEST_MAX_PAYLOAD 64u
+
+#define TEST_TX_BUF_LEN                                                                            \
+  (TEST_HEADER_LENGTH + TEST_AUTH_INFO_LENGTH / 8 + TEST_MAX_PAYLOAD + TEST_FV_LENGTH / 8)
+/* the received truncated MAC is backed up behind the full MAC calculated in place */
+#define TEST_RX_BUF_LEN                                                                            \
+  (2u + TEST_TX_BUF_LEN + (TEST_AUTH_INFO_TRUNC_LENGTH + TEST_FV_TRUNC_LENGTH + 7u) / 8)
+
+#define TEST_JOB_NATIVE 0u
+#define TEST_JOB_MBEDTLS 1u
+
+#ifndef TEST_CYCLES
+#define TEST_CYCLES 100u
+#endif
+
+/* cycles to wait for the PDUs still in flight after the last request */
+#define TEST_DRAIN_CYCLES 1000u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint8_t payload[TEST_MAX_PAYLOAD];
+  uint32_t length;
+  uint32_t requested;
+  uint32_t confirmed;
+  uint32_t verified;
+  uint32_t corrupted;
+} test_pdu_t;
+/* ================================ [ DECLARES  ] ============================================== */
+static Std_ReturnType test_get_freshness(uint8_t *FreshnessValue, uint32_t *FreshnessValueLength);
+/* ================================ [ DATAS     ] ============================================== */
+static const SecOC_FreshnessValueType SecOC_FreshnessValues[] = {
+  {test_get_freshness, TEST_FV_LENGTH},
+};
+
+static SecOC_TxPduProcContextType txContexts[SECOC_TEST_MAX_PDUS];
+static SecOC_RxPduProcContextType rxContexts[SECOC_TEST_MAX_PDUS];
+static uint8_t txBuffers[SECOC_TEST_MAX_PDUS][TEST_TX_BUF_LEN];
+static uint8_t rxBuffers[SECOC_TEST_MAX_PDUS][TEST_RX_BUF_LEN];
+static SecOC_TxPduProcessingType txProcs[SECOC_TEST_MAX_PDUS];
+static SecOC_RxPduProcessingType rxProcs[SECOC_TEST_MAX_PDUS];
+
+const SecOC_ConfigType SecOC_Config = {
+  SecOC_FreshnessValues, txProcs, rxProcs, SECOC_TEST_MAX_PDUS, SECOC_TEST_MAX_PDUS, 1,
+};
+
+static const uint8_t testKey[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+static Csm_AesCmacContextType nativeContext;
+static mbedtls_cipher_context_t mbedtlsContext;
+
+static test_pdu_t testPdus[SECOC_TEST_MAX_PDUS];
+static PduIdType txPending[SECOC_TEST_MAX_PDUS];
+static uint32_t numTxPending;
+/* ================================ [ LOCALS    ] ============================================== */
+static Std_ReturnType test_get_freshness(uint8_t *FreshnessValue, uint32_t *FreshnessValueLength) {
+  FreshnessValue[0] = 0x00;
+  FreshnessValue[1] = 0x00;
+  FreshnessValue[2] = 0x12;
+  FreshnessValue[3] = 0x34;
+  *FreshnessValueLength = TEST_FV_LENGTH;
+  return E_OK;
+}
+
+/* the generated mbedtls cipher CMAC primitive, as the reference */
+static Std_ReturnType test_mbedtls_init(void *AlgorithmContext, const uint8_t *AlgorithmKey,
+                                        uint32_t AlgorithmKeyLength) {
+  mbedtls_cipher_context_t *pCtx = (mbedtls_cipher_context_t *)AlgorithmContext;
+  mbedtls_cipher_init(pCtx);
+  if (0 != mbedtls_cipher_setup(pCtx, mbedtls_cipher_info_from_type(MBEDTLS_CIPHER_AES_128_ECB))) {
+    return E_NOT_OK;
+  }
+  return (0 == mbedtls_cipher_cmac_starts(pCtx, AlgorithmKey, AlgorithmKeyLength * 8)) ? E_OK
+                                                                                        : E_NOT_OK;
+}
+
+static Std_ReturnType test_mbedtls_start(void *AlgorithmContext) {
+  return (0 == mbedtls_cipher_cmac_reset((mbedtls_cipher_context_t *)AlgorithmContext)) ? E_OK
+                                                                                      : E_NOT_OK;
+}
+
+static Std_ReturnType test_mbedtls_update(void *AlgorithmContext, const uint8_t *data,
+                                          uint32_t len) {
+  return (0 == mbedtls_cipher_cmac_update((mbedtls_cipher_context_t *)AlgorithmContext, data, len))
+           ? E_OK
+           : E_NOT_OK;
+}
+
+static Std_ReturnType test_mbedtls_finish(void *AlgorithmContext, uint8_t *mac, uint32_t *len) {
+  if (0 != mbedtls_cipher_cmac_finish((mbedtls_cipher_context_t *)AlgorithmContext, mac)) {
+    return E_NOT_OK;
+  }
+  *len = 16u;
+  return E_OK;
+}
+
+static void test_mbedtls_deinit(void *AlgorithmContext) {
+  mbedtls_cipher_free((mbedtls_cipher_context_t *)AlgorithmContext);
+}
+
+static const Csm_MacGenPrimitiveType testMbedTlsPrimitive = {
+  test_mbedtls_init,   test_mbedtls_start,  test_mbedtls_update,
+  test_mbedtls_finish, test_mbedtls_deinit, NULL,
+};
+
+static const Csm_MacGenerateConfigType Csm_MacGenerateConfigs[] = {
+  {&nativeContext, testKey, &Csm_AesCmacPrimitive, NULL, sizeof(testKey), CRYPTO_ALGOFAM_AES,
+   CRYPTO_ALGOMODE_CMAC},
+  {&mbedtlsContext, testKey, &testMbedTlsPrimitive, NULL, sizeof(testKey), CRYPTO_ALGOFAM_AES,
+   CRYPTO_ALGOMODE_CMAC},
+};
+
+static const Csm_JobConfigType Csm_JobConfigs[] = {
+  {TEST_JOB_NATIVE, CRYPTO_MAC_GENERATE},
+  {TEST_JOB_MBEDTLS, CRYPTO_MAC_GENERATE},
+};
+
+const Csm_ConfigType Csm_Config = {
+  Csm_JobConfigs,
+  Csm_MacGenerateConfigs,
+  sizeof(Csm_JobConfigs) / sizeof(Csm_JobConfigs[0]),
+  sizeof(Csm_MacGenerateConfigs) / sizeof(Csm_MacGenerateConfigs[0]),
+};
+
+static void test_setup(uint32_t jobId) {
+  uint32_t i, j;
+
+  for (i = 0; i < SECOC_TEST_MAX_PDUS; i++) {
+    txProcs[i].context = &txContexts[i];
+    txProcs[i].buffer = txBuffers[i];
+    txProcs[i].TxAuthServiceConfigRef = jobId;
+    txProcs[i].FwTxPduId = (PduIdType)i;
+    txProcs[i].UpTxPduId = (PduIdType)i;
+    txProcs[i].bufLen = TEST_TX_BUF_LEN;
+    txProcs[i].AuthInfoLength = TEST_AUTH_INFO_LENGTH;
+    txProcs[i].AuthInfoTruncLength = TEST_AUTH_INFO_TRUNC_LENGTH;
+    txProcs[i].DataId = (uint16_t)(0x1000 + i);
+    txProcs[i].FreshnessValueId = 0;
+    txProcs[i].FreshnessValueLength = TEST_FV_LENGTH;
+    txProcs[i].FreshnessValueTruncLength = TEST_FV_TRUNC_LENGTH;
+    txProcs[i].TxPduUnusedAreasDefault = 0x55;
+    txProcs[i].AuthPduHeaderLength = TEST_HEADER_LENGTH;
+    txProcs[i].AuthPduOffset = TEST_HEADER_LENGTH;
+
+    rxProcs[i].context = &rxContexts[i];
+    rxProcs[i].buffer = rxBuffers[i];
+    rxProcs[i].RxAuthServiceConfigRef = jobId;
+    rxProcs[i].UpRxPduId = (PduIdType)i;
+    rxProcs[i].bufLen = TEST_RX_BUF_LEN;
+    rxProcs[i].AuthInfoLength = TEST_AUTH_INFO_LENGTH;
+    rxProcs[i].AuthInfoTruncLength = TEST_AUTH_INFO_TRUNC_LENGTH;
+    rxProcs[i].DataId = (uint16_t)(0x1000 + i);
+    rxProcs[i].FreshnessValueId = 0;
+    rxProcs[i].FreshnessValueLength = TEST_FV_LENGTH;
+    rxProcs[i].FreshnessValueTruncLength = TEST_FV_TRUNC_LENGTH;
+    rxProcs[i].AuthPduHeaderLength = TEST_HEADER_LENGTH;
+    rxProcs[i].UseAuthDataFreshness = FALSE;
+
+    memset(&testPdus[i], 0, sizeof(testPdus[i]));
+    testPdus[i].length = 1u + ((uint32_t)rand() % TEST_MAX_PAYLOAD);
+    for (j = 0; j < testPdus[i].length; j++) {
+      testPdus[i].payload[j] = (uint8_t)rand();
+    }
+  }
+  numTxPending = 0;
+}
+
+static void test_cycle(void) {
+  uint32_t i;
+
+  SecOC_MainFunctionTx();
+  SecOC_MainFunctionRx();
+  Csm_MainFunction();
+  for (i = 0; i < numTxPending; i++) {
+    SecOC_TxConfirmation(txPending[i], E_OK);
+  }
+  numTxPending = 0;
+}
+
+static bool test_busy(void) {
+  uint32_t i;
+  bool busy = false;
+
+  for (i = 0; (i < SECOC_TEST_MAX_PDUS) && (false == busy); i++) {
+    if ((SECOC_TXPDU_PROC_STATE_IDLE != txContexts[i].state) ||
+        (SECOC_RXPDU_PROC_STATE_IDLE != rxContexts[i].state)) {
+      busy = true;
+    }
+  }
+
+  return busy;
+}
+
+/* all the PDUs are requested again each time the loop back of the previous request is done */
+static void test_run(void) {
+  uint32_t cycle, i;
+  PduInfoType PduInfo;
+
+  Csm_Init(NULL);
+  SecOC_Init(NULL);
+  for (cycle = 0; cycle < TEST_CYCLES; cycle++) {
+    for (i = 0; i < SECOC_TEST_MAX_PDUS; i++) {
+      if ((SECOC_TXPDU_PROC_STATE_IDLE == txContexts[i].state) &&
+          (SECOC_RXPDU_PROC_STATE_IDLE == rxContexts[i].state)) {
+        PduInfo.SduDataPtr = testPdus[i].payload;
+        PduInfo.SduLength = testPdus[i].length;
+        if (E_OK == SecOC_IfTransmit((PduIdType)i, &PduInfo)) {
+          testPdus[i].requested++;
+        }
+      }
+    }
+    test_cycle();
+  }
+
+  for (cycle = 0; (cycle < TEST_DRAIN_CYCLES) && test_busy(); cycle++) {
+    test_cycle();
+    usleep(100);
+  }
+}
+
+static void Test_Rfc4493(boolean hw) {
+  /* RFC 4493 section 4 */
+  static const uint8_t M[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+  static const uint8_t T[4][16] = {
+    {0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67,
+     0x46},
+    {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28,
+     0x7c},
+    {0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8,
+     0x27},
+    {0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c,
+     0xfe},
+  };
+  static const uint32_t L[4] = {0, 16, 40, 64};
+  const Csm_MacGenPrimitiveType *p = &Csm_AesCmacPrimitive;
+  boolean native = nativeContext.hw;
+  uint8_t mac[16];
+  uint32_t macLen;
+  bool bPass = true;
+  int i;
+
+  printf("Test AES-CMAC RFC 4493 vectors with the %s AES:", hw ? "hardware" : "software");
+  nativeContext.hw = hw;
+  for (i = 0; i < 4; i++) {
+    macLen = sizeof(mac);
+    (void)p->SingleCallFnc(&nativeContext, M, L[i], mac, &macLen);
+    bPass = bPass && (0 == memcmp(mac, T[i], 16));
+    /* streaming in odd pieces */
+    macLen = sizeof(mac);
+    (void)p->StartFnc(&nativeContext);
+    (void)p->UpdateFnc(&nativeContext, M, L[i] / 3);
+    (void)p->UpdateFnc(&nativeContext, &M[L[i] / 3], L[i] - L[i] / 3);
+    (void)p->FinishFnc(&nativeContext, mac, &macLen);
+    bPass = bPass && (0 == memcmp(mac, T[i], 16));
+  }
+  nativeContext.hw = native;
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    exit(-1);
+  }
+}
+
+static void Test_LoopBack(const char *name, uint32_t jobId) {
+  uint32_t i;
+  bool bPass = true;
+
+  printf("Test loop back of %u PDUs with the %s CMAC:", SECOC_TEST_MAX_PDUS, name);
+  test_setup(jobId);
+  test_run();
+
+  bPass = (false == test_busy());
+  for (i = 0; (i < SECOC_TEST_MAX_PDUS) && bPass; i++) {
+    bPass = (testPdus[i].requested > 0u) && (testPdus[i].verified == testPdus[i].requested) &&
+            (testPdus[i].confirmed == testPdus[i].requested) && (0u == testPdus[i].corrupted);
+  }
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    i = (i > 0u) ? (i - 1u) : 0u;
+    printf("  PDU %u: requested %u, confirmed %u, verified %u, corrupted %u\n", i,
+           testPdus[i].requested, testPdus[i].confirmed, testPdus[i].verified,
+           testPdus[i].corrupted);
+    exit(-1);
+  }
+}
+
+static void Test_WrongDataId(void) {
+  uint32_t i;
+  bool bPass = true;
+
+  printf("Test the PDUs with a wrong Data ID are not indicated:");
+  test_setup(TEST_JOB_NATIVE);
+  for (i = 1; i < SECOC_TEST_MAX_PDUS; i += 2u) {
+    rxProcs[i].DataId = (uint16_t)(0x2000 + i);
+  }
+  test_run();
+
+  bPass = (false == test_busy());
+  for (i = 0; (i < SECOC_TEST_MAX_PDUS) && bPass; i++) {
+    bPass = (testPdus[i].requested > 0u) && (testPdus[i].confirmed == testPdus[i].requested) &&
+            (0u == testPdus[i].corrupted) &&
+            (testPdus[i].verified == ((0u == (i & 0x01u)) ? testPdus[i].requested : 0u));
+  }
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    i = (i > 0u) ? (i - 1u) : 0u;
+    printf("  PDU %u: requested %u, confirmed %u, verified %u, corrupted %u\n", i,
+           testPdus[i].requested, testPdus[i].confirmed, testPdus[i].verified,
+           testPdus[i].corrupted);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType PduR_SecOCTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  (void)PduInfoPtr;
+  txPending[numTxPending++] = TxPduId;
+  return E_OK;
+}
+
+void PduR_SecOCTxConfirmation(PduIdType TxPduId, Std_ReturnType result) {
+  if (E_OK == result) {
+    testPdus[TxPduId].confirmed++;
+  }
+}
+
+void PduR_SecOCRxIndication(PduIdType RxPduId, const PduInfoType *PduInfoPtr) {
+  test_pdu_t *pdu = &testPdus[RxPduId];
+
+  if ((PduInfoPtr->SduLength == pdu->length) &&
+      (0 == memcmp(PduInfoPtr->SduDataPtr, pdu->payload, pdu->length))) {
+    pdu->verified++;
+  } else {
+    pdu->corrupted++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  srand(1);
+  Csm_Init(NULL);
+
+  if (nativeContext.hw) {
+    Test_Rfc4493(TRUE);
+  }
+  Test_Rfc4493(FALSE);
+  Test_LoopBack("native", TEST_JOB_NATIVE);
+  Test_LoopBack("mbedtls", TEST_JOB_MBEDTLS);
+  Test_WrongDataId();
+
+  return 0;
+}
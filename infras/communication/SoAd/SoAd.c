@@ -478,6 +478,50 @@ Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr)
   return ret;
 }
 
+Std_ReturnType SoAd_IfTransmitToMulti(PduIdType TxPduId, const PduInfoType *PduInfoPtr,
+                                     const TcpIp_SockAddrType *RemoteAddrs,
+                                     uint16_t numOfRemoteAddrs) {
+  Std_ReturnType ret = E_NOT_OK;
+  SoAd_SoConIdType SoConId;
+  const SoAd_SocketConnectionType *connection;
+  const SoAd_SocketConnectionGroupType *conG;
+  SoAd_SocketContextType *context;
+
+  if ((TxPduId < SOAD_CONFIG->numOfTxPduIds) && (numOfRemoteAddrs > 0u)) {
+    SoConId = SOAD_CONFIG->TxPduIdToSoCondIdMap[TxPduId];
+    connection = &SOAD_CONFIG->Connections[SoConId];
+    conG = &SOAD_CONFIG->ConnectionGroups[connection->GID];
+    context = &SOAD_CONFIG->Contexts[SoConId];
+    if ((SOAD_SOCKET_READY <= context->state) && (TCPIP_IPPROTO_UDP == conG->ProtocolType)) {
+      if (0 == (context->flag & SOAD_TX_ON_GOING)) {
+        ret = E_OK;
+      }
+    }
+  }
+
+  if (E_OK == ret) {
+    ret = TcpIp_SendToMulti(context->sock, RemoteAddrs, numOfRemoteAddrs, PduInfoPtr->SduDataPtr,
+                            PduInfoPtr->SduLength);
+    if (E_OK == ret) {
+      if (NULL != conG->IF->TxConfirmation) {
+        context->flag |= SOAD_TX_ON_GOING;
+      }
+    }
+
+#if SOAD_ERROR_COUNTER_LIMIT > 0
+    if (E_OK != ret) {
+      context->errorCounter++;
+      if (context->errorCounter >= SOAD_ERROR_COUNTER_LIMIT) {
+        ASLOG(SOADE, ("[%u] If Tx to multi failed, closing\n", SoConId));
+        SoAd_CloseSoCon(SoConId, TRUE);
+      }
+    }
+#endif
+  }
+
+  return ret;
+}
+
 Std_ReturnType SoAd_TpTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
   Std_ReturnType ret = E_NOT_OK;
   SoAd_SoConIdType SoConId;
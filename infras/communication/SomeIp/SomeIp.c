@@ -54,6 +54,11 @@
 #define SOMEIP_TX_NOK_RETRY_MAX 3u
 #endif
 
+/* max number of unicast subscribers notified with one SoAd call */
+#ifndef SOMEIP_EVENT_FANOUT_MAX
+#define SOMEIP_EVENT_FANOUT_MAX 16u
+#endif
+
 #ifdef USE_PCAP
 #define PCAP_TRACE PCap_SomeIp
 #else
@@ -485,6 +490,39 @@ static Std_ReturnType SomeIp_SendNextTxTpMsg(PduIdType TxPduId, uint16_t service
   return ret;
 }
 
+static Std_ReturnType SomeIp_FanOutEvtMsg(const SomeIp_ServerServiceType *config,
+                                          const SomeIp_ServerEventType *event, PduIdType TxPduId,
+                                          TcpIp_SockAddrType *RemoteAddrs,
+                                          uint16_t numOfRemoteAddrs, uint8_t *data,
+                                          uint32_t payloadLength, uint8_t messageType,
+                                          uint16_t sessionId) {
+  Std_ReturnType ret;
+  PduInfoType PduInfo;
+
+  PduInfo.MetaDataPtr = (uint8_t *)RemoteAddrs;
+  PduInfo.SduDataPtr = data;
+  PduInfo.SduLength = payloadLength + 16u;
+  if ((NULL == RemoteAddrs) || (1u == numOfRemoteAddrs)) {
+    ret = SoAd_IfTransmit(TxPduId, &PduInfo);
+  } else {
+    ret = SoAd_IfTransmitToMulti(TxPduId, &PduInfo, RemoteAddrs, numOfRemoteAddrs);
+  }
+
+  if (E_OK != ret) {
+    ASLOG(SOMEIPE, ("Failed to notify event %x:%x to %d subscribers\n", config->serviceId,
+                    event->eventId, numOfRemoteAddrs));
+  } else {
+    /* traced once per datagram, with the first of the destinations */
+    PCAP_TRACE(config->serviceId, event->eventId, event->interfaceVersion, messageType, 0u,
+               &data[16], payloadLength, config->clientId, sessionId, RemoteAddrs, FALSE, 0u,
+               FALSE, FALSE);
+  }
+
+  return ret;
+}
+
+/* The message is serialized once, then sent once to the multicast group if any subscriber was
+ * switched to multicast by Sd, and to the unicast subscribers grouped by TxPduId */
 static Std_ReturnType SomeIp_TransmitEvtMsg(const SomeIp_ServerServiceType *config,
                                             const SomeIp_ServerEventType *event, uint8_t *data,
                                             uint32_t payloadLength, boolean isTp,
@@ -494,37 +532,55 @@ static Std_ReturnType SomeIp_TransmitEvtMsg(const SomeIp_ServerServiceType *conf
   Std_ReturnType ret2;
   Sd_EventHandlerSubscriberType *sub;
   uint8_t messageType = SOMEIP_MSG_NOTIFICATION;
-  TcpIp_SockAddrType *RemoteAddr = NULL;
+  TcpIp_SockAddrType RemoteAddrs[SOMEIP_EVENT_FANOUT_MAX];
+  uint16_t numOfRemoteAddrs = 0u;
+  PduIdType TxPduId = 0u;
   boolean bMulticast = FALSE;
 
   if (TRUE == isTp) {
     messageType |= SOMEIP_TP_FLAG;
   }
 
+  SomeIp_BuildHeader(data, config->serviceId, event->eventId, config->clientId, sessionId,
+                     event->interfaceVersion, messageType, 0u, payloadLength);
+
   sub = STAILQ_FIRST(list);
   while (NULL != sub) {
-    if (0u != sub->flags) {
-      RemoteAddr = &sub->RemoteAddr;
-      if (0u != (SD_FLG_EVENT_GROUP_MULTICAST & sub->flags)) {
+    if (0u == sub->flags) {
+      /* not subscribed */
+    } else if (0u != (SD_FLG_EVENT_GROUP_MULTICAST & sub->flags)) {
+      if (FALSE == bMulticast) {
         bMulticast = TRUE;
-        RemoteAddr = NULL;
+        ret2 = SomeIp_FanOutEvtMsg(config, event, sub->TxPduId, NULL, 0u, data, payloadLength,
+                                   messageType, sessionId);
+        if (E_OK == ret2) {
+          ret = E_OK;
+        }
       }
-      ret2 = SomeIp_Transmit(sub->TxPduId, RemoteAddr, data, config->serviceId, event->eventId,
-                             config->clientId, sessionId, event->interfaceVersion, messageType, 0u,
-                             payloadLength);
-      if (E_OK == ret2) {
-        ret = E_OK;
-      } else {
-        ASLOG(SOMEIPE, ("Failed to notify event %x:%x to %d.%d.%d.%d:%d\n", config->serviceId,
-                        event->eventId, sub->RemoteAddr.addr[0], sub->RemoteAddr.addr[1],
-                        sub->RemoteAddr.addr[2], sub->RemoteAddr.addr[3], sub->RemoteAddr.port));
+    } else {
+      if ((numOfRemoteAddrs > 0u) &&
+          ((TxPduId != sub->TxPduId) || (numOfRemoteAddrs >= ARRAY_SIZE(RemoteAddrs)))) {
+        ret2 = SomeIp_FanOutEvtMsg(config, event, TxPduId, RemoteAddrs, numOfRemoteAddrs, data,
+                                   payloadLength, messageType, sessionId);
+        if (E_OK == ret2) {
+          ret = E_OK;
+        }
+        numOfRemoteAddrs = 0u;
       }
+      TxPduId = sub->TxPduId;
+      RemoteAddrs[numOfRemoteAddrs] = sub->RemoteAddr;
+      numOfRemoteAddrs++;
     }
     /* NOTE: if any one is unsubscribed during this, TX is broken, but Sd Main and SomeIp Main
      * scheduled in one Task, not possible */
     sub = STAILQ_NEXT(sub, entry);
-    if (TRUE == bMulticast) {
-      break;
+  }
+
+  if (numOfRemoteAddrs > 0u) {
+    ret2 = SomeIp_FanOutEvtMsg(config, event, TxPduId, RemoteAddrs, numOfRemoteAddrs, data,
+                               payloadLength, messageType, sessionId);
+    if (E_OK == ret2) {
+      ret = E_OK;
     }
   }
 
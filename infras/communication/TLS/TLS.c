@@ -25,6 +25,9 @@
 #ifndef TLS_LOCAL_DATA_MAX_SIZE
 #define TLS_LOCAL_DATA_MAX_SIZE 128
 #endif
+
+#define TLS_IS_WANT(rc)                                                                            \
+  ((MBEDTLS_ERR_SSL_WANT_READ == (rc)) || (MBEDTLS_ERR_SSL_WANT_WRITE == (rc)))
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 extern const TLS_ConfigType TLS_Config;
@@ -32,6 +35,7 @@ extern const TLS_ConfigType TLS_Config;
 #ifdef TLS_USE_PB_CONFIG
 static const TLS_ConfigType *tlsConfig = NULL;
 #endif
+static TLS_SessionStoreType TLS_SessionStore;
 /* ================================ [ LOCALS    ] ============================================== */
 static void TLS_Debug(void *ctx, int level, const char *file, int line, const char *str) {
   ((void)level);
@@ -39,35 +43,110 @@ static void TLS_Debug(void *ctx, int level, const char *file, int line, const ch
   ASPRINT(TLS, ("%s:%04d: %s", file, line, str));
 }
 
-static int TLS_NetSend(void *ctx, const unsigned char *buf, size_t len) {
-  int rc = MBEDTLS_ERR_SSL_WANT_WRITE;
-  Std_ReturnType ret;
+static Std_ReturnType TLS_NetTransmit(const TLS_ServerConfigType *server, const uint8_t *buf,
+                                      uint32_t len) {
   PduInfoType PduInfo;
-  const TLS_ServerConfigType *server = (const TLS_ServerConfigType *)ctx;
   PduInfo.MetaDataPtr = NULL;
   PduInfo.SduDataPtr = (uint8_t *)buf;
   PduInfo.SduLength = (PduLengthType)len;
 
   ASHEXDUMP(TLS, ("%s send:", server->name), buf, len);
-  ret = SoAd_IfTransmit(server->TxPduId, &PduInfo);
+  return SoAd_IfTransmit(server->TxPduId, &PduInfo);
+}
+
+#if TLS_NET_BUFFER_SIZE > 0
+static Std_ReturnType TLS_NetFlush(const TLS_ServerConfigType *server) {
+  Std_ReturnType ret = E_OK;
+  TLS_ServerContextType *context = server->context;
+
+  if (context->netLen > 0u) {
+    ret = TLS_NetTransmit(server, context->netBuf, context->netLen);
+    if (E_OK == ret) {
+      context->netLen = 0;
+    }
+  }
+
+  return ret;
+}
+#endif
+
+static int TLS_NetSend(void *ctx, const unsigned char *buf, size_t len) {
+  int rc = MBEDTLS_ERR_SSL_WANT_WRITE;
+  Std_ReturnType ret = E_OK;
+  const TLS_ServerConfigType *server = (const TLS_ServerConfigType *)ctx;
+#if TLS_NET_BUFFER_SIZE > 0
+  TLS_ServerContextType *context = server->context;
+
+  if (len > (size_t)(TLS_NET_BUFFER_SIZE - context->netLen)) {
+    ret = TLS_NetFlush(server);
+  }
+
+  if (E_OK != ret) {
+    /* the SoAd is busy, the mbedtls retries later */
+  } else if (len <= (size_t)(TLS_NET_BUFFER_SIZE - context->netLen)) {
+    (void)memcpy(&context->netBuf[context->netLen], buf, len);
+    context->netLen += (uint16_t)len;
+    rc = (int)len;
+  } else {
+    ret = TLS_NetTransmit(server, buf, (uint32_t)len);
+    if (E_OK == ret) {
+      rc = (int)len;
+    }
+  }
+#else
+  ret = TLS_NetTransmit(server, buf, (uint32_t)len);
   if (E_OK == ret) {
     rc = (int)len;
   }
-  ASPRINT(TLS, ("TLS_NetSend(%" PRIu64 ") = %d\n", len, rc));
+#endif
+  ASPRINT(TLS, ("TLS_NetSend(%" PRIu64 ") = %d\n", (uint64_t)len, rc));
   return rc;
 }
 
-static int TLS_NetRecv(void *ctx, unsigned char *buf, size_t len) {
+static int TLS_NetRecvDirect(const TLS_ServerConfigType *server, unsigned char *buf,
+                             size_t len) {
   int rc = 0;
   Std_ReturnType ret;
   uint32_t length = (uint32_t)len;
-  const TLS_ServerConfigType *server = (const TLS_ServerConfigType *)ctx;
 
   ret = SoAd_ControlRecv(server->SoConId, buf, &length);
   if (E_OK == ret) {
     rc = (int)length;
   }
 
+  return rc;
+}
+
+static int TLS_NetRecv(void *ctx, unsigned char *buf, size_t len) {
+  int rc = 0;
+  const TLS_ServerConfigType *server = (const TLS_ServerConfigType *)ctx;
+#if TLS_RX_BUFFER_SIZE > 0
+  TLS_ServerContextType *context = server->context;
+  uint32_t length;
+
+  if ((context->rxPos >= context->rxLen) && (len < (size_t)(TLS_RX_BUFFER_SIZE / 2))) {
+    /* the record headers and the small records are parsed from what one receive got */
+    context->rxPos = 0;
+    context->rxLen = (uint16_t)TLS_NetRecvDirect(server, context->rxBuf, TLS_RX_BUFFER_SIZE);
+  }
+
+  if (context->rxPos < context->rxLen) {
+    length = (uint32_t)context->rxLen - context->rxPos;
+    if (length > len) {
+      length = (uint32_t)len;
+    }
+    (void)memcpy(buf, &context->rxBuf[context->rxPos], length);
+    context->rxPos += (uint16_t)length;
+    rc = (int)length;
+  } else {
+    /* the body of a large record goes directly into the record buffer of the mbedtls where it
+     * is decrypted in place */
+    rc = TLS_NetRecvDirect(server, buf, len);
+  }
+#else
+  rc = TLS_NetRecvDirect(server, buf, len);
+#endif
+
   if (0 == rc) {
     rc = MBEDTLS_ERR_SSL_WANT_READ;
   } else {
@@ -77,37 +156,100 @@ static int TLS_NetRecv(void *ctx, unsigned char *buf, size_t len) {
   return rc;
 }
 
-static Std_ReturnType TLS_ServerInit(const TLS_ServerConfigType *server) {
+static Std_ReturnType TLS_SessionStoreSetup(void) {
   Std_ReturnType ret = E_OK;
+  TLS_SessionStoreType *store = &TLS_SessionStore;
   int rc;
-  mbedtls_ssl_init(&server->context->ssl);
-  mbedtls_ssl_config_init(&server->context->conf);
+
+  if (FALSE == store->bSetup) {
+#ifdef TLS_USE_PSA_CRYPTO
+    {
+      psa_status_t status = psa_crypto_init();
+      if (status != PSA_SUCCESS) {
+        ASLOG(TLSE, ("Failed to initialize PSA Crypto implementation: %d\n", (int)status));
+        ret = E_NOT_OK;
+      }
+    }
+#endif
+
+#if defined(MBEDTLS_DEBUG_C)
+    mbedtls_debug_set_threshold(MBEDTLS_DEBUG_LEVEL);
+#endif
+
+    mbedtls_entropy_init(&store->entropy);
+    mbedtls_ctr_drbg_init(&store->ctr_drbg);
 #if defined(MBEDTLS_SSL_CACHE_C)
-  mbedtls_ssl_cache_init(&server->context->cache);
+    mbedtls_ssl_cache_init(&store->cache);
+    mbedtls_ssl_cache_set_max_entries(&store->cache, TLS_SESSION_CACHE_MAX_ENTRIES);
+#if defined(MBEDTLS_HAVE_TIME)
+    mbedtls_ssl_cache_set_timeout(&store->cache, TLS_SESSION_CACHE_TIMEOUT);
+#endif
+#endif
+#ifdef TLS_USE_SESSION_TICKETS
+    mbedtls_ssl_ticket_init(&store->ticket);
 #endif
-  mbedtls_x509_crt_init(&server->context->srvcert);
-  mbedtls_pk_init(&server->context->pkey);
-  mbedtls_entropy_init(&server->context->entropy);
-  mbedtls_ctr_drbg_init(&server->context->ctr_drbg);
 
-#if defined(MBEDTLS_USE_PSA_CRYPTO)
-  {
-    psa_status_t status = psa_crypto_init();
-    if (status != PSA_SUCCESS) {
-      ASLOG(TLSE, ("Failed to initialize PSA Crypto implementation: %d\n", (int)status));
-      ret = E_NOT_OK
+    if (E_OK == ret) {
+      rc = mbedtls_ctr_drbg_seed(&store->ctr_drbg, mbedtls_entropy_func, &store->entropy,
+                                 (const unsigned char *)"TLS", 3);
+      if (rc != 0) {
+        ASLOG(TLSE, ("session store mbedtls_ctr_drbg_seed returned %d\n", rc));
+        ret = E_NOT_OK;
+      }
     }
-  }
-#endif /* MBEDTLS_USE_PSA_CRYPTO */
 
-#if defined(MBEDTLS_DEBUG_C)
-  mbedtls_debug_set_threshold(MBEDTLS_DEBUG_LEVEL);
+#if defined(TLS_USE_SESSION_TICKETS) && (TLS_SESSION_TICKET_LIFETIME > 0)
+    if (E_OK == ret) {
+      rc = mbedtls_ssl_ticket_setup(&store->ticket, mbedtls_ctr_drbg_random, &store->ctr_drbg,
+                                    MBEDTLS_CIPHER_AES_256_GCM, TLS_SESSION_TICKET_LIFETIME);
+      if (rc != 0) {
+        ASLOG(TLSE, ("mbedtls_ssl_ticket_setup returned %d\n", rc));
+        ret = E_NOT_OK;
+      }
+    }
 #endif
 
-  if (E_OK == ret) {
-    ret = SoAd_TakeControl(server->SoConId);
+    if (E_OK == ret) {
+      store->bSetup = TRUE;
+    } else {
+#ifdef TLS_USE_SESSION_TICKETS
+      mbedtls_ssl_ticket_free(&store->ticket);
+#endif
+#if defined(MBEDTLS_SSL_CACHE_C)
+      mbedtls_ssl_cache_free(&store->cache);
+#endif
+      mbedtls_ctr_drbg_free(&store->ctr_drbg);
+      mbedtls_entropy_free(&store->entropy);
+    }
   }
 
+  return ret;
+}
+
+static void TLS_ServerFree(const TLS_ServerConfigType *server) {
+  mbedtls_x509_crt_free(&server->context->srvcert);
+  mbedtls_pk_free(&server->context->pkey);
+  mbedtls_ssl_free(&server->context->ssl);
+  mbedtls_ssl_config_free(&server->context->conf);
+  mbedtls_ctr_drbg_free(&server->context->ctr_drbg);
+  mbedtls_entropy_free(&server->context->entropy);
+  server->context->bSetup = FALSE;
+}
+
+/* the certificates, the RNG, the config and the ssl context are set up by the first connection and
+ * kept, the following connections only reset the ssl context */
+static Std_ReturnType TLS_ServerSetup(const TLS_ServerConfigType *server) {
+  Std_ReturnType ret;
+  int rc;
+  mbedtls_ssl_init(&server->context->ssl);
+  mbedtls_ssl_config_init(&server->context->conf);
+  mbedtls_x509_crt_init(&server->context->srvcert);
+  mbedtls_pk_init(&server->context->pkey);
+  mbedtls_entropy_init(&server->context->entropy);
+  mbedtls_ctr_drbg_init(&server->context->ctr_drbg);
+
+  ret = TLS_SessionStoreSetup();
+
   ASLOG(TLS, ("Init TLS %s\n", server->name));
   /*1. Seed the RNG*/
   if (E_OK == ret) {
@@ -170,10 +312,14 @@ static Std_ReturnType TLS_ServerInit(const TLS_ServerConfigType *server) {
                          &server->context->ctr_drbg);
     mbedtls_ssl_conf_dbg(&server->context->conf, TLS_Debug, NULL);
 
-#if defined(MBEDTLS_SSL_CACHE_C)
-    mbedtls_ssl_conf_session_cache(&server->context->conf, &server->context->cache,
+#if defined(MBEDTLS_SSL_CACHE_C) && (TLS_SESSION_CACHE_MAX_ENTRIES > 0)
+    mbedtls_ssl_conf_session_cache(&server->context->conf, &TLS_SessionStore.cache,
                                    mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
 #endif
+#if defined(TLS_USE_SESSION_TICKETS) && (TLS_SESSION_TICKET_LIFETIME > 0)
+    mbedtls_ssl_conf_session_tickets_cb(&server->context->conf, mbedtls_ssl_ticket_write,
+                                        mbedtls_ssl_ticket_parse, &TLS_SessionStore.ticket);
+#endif
 
     mbedtls_ssl_conf_ca_chain(&server->context->conf, server->context->srvcert.next, NULL);
   }
@@ -197,48 +343,76 @@ static Std_ReturnType TLS_ServerInit(const TLS_ServerConfigType *server) {
   }
 
   if (E_OK == ret) {
-    mbedtls_ssl_session_reset(&server->context->ssl);
     mbedtls_ssl_set_bio(&server->context->ssl, (void *)server, TLS_NetSend, TLS_NetRecv, NULL);
-    server->context->data = NULL;
-    server->context->length = 0;
+    server->context->bSetup = TRUE;
+  } else {
+    TLS_ServerFree(server);
   }
 
   return ret;
 }
 
+/* drop the state of the connection, the setup and the cached sessions are kept */
+static void TLS_ServerClose(const TLS_ServerConfigType *server) {
+  TLS_ServerContextType *context = server->context;
+
+  if (NULL != context->data) {
+    Net_MemFree(context->data);
+    context->data = NULL;
+  }
+  context->length = 0;
+  context->offset = 0;
+#if TLS_TX_BUFFER_SIZE > 0
+  context->txLen = 0;
+  context->txRecord = 0;
+#endif
+#if TLS_NET_BUFFER_SIZE > 0
+  context->netLen = 0;
+#endif
+#if TLS_RX_BUFFER_SIZE > 0
+  context->rxPos = 0;
+  context->rxLen = 0;
+#endif
+  if (TRUE == context->bSetup) {
+    (void)mbedtls_ssl_session_reset(&context->ssl);
+  }
+  context->state = TLS_SERVER_IDLE;
+}
+
+static void TLS_ServerAbort(const TLS_ServerConfigType *server, boolean bOnline) {
+  (void)SoAd_CloseSoCon(server->SoConId, TRUE);
+  TLS_ServerClose(server);
+  if (TRUE == bOnline) {
+    server->SoConModeChgNotification(server->SoConId, SOAD_SOCON_OFFLINE);
+  }
+}
+
 static void TLS_ServerSwitchOnline(const TLS_ServerConfigType *server) {
-  Std_ReturnType ret;
-  if (TLS_SERVER_IDLE == server->context->state) {
-    ret = TLS_ServerInit(server);
-    if (E_OK == ret) {
-      ASLOG(TLS, ("Server %s connected\n", server->name));
-      server->context->state = TLS_SERVER_HANDSHAKE;
-    }
-  } else {
+  Std_ReturnType ret = E_OK;
+  if (TLS_SERVER_IDLE != server->context->state) {
     ASLOG(TLSE, ("Server %s in wrong state %u, reset\n", server->name, server->context->state));
-    mbedtls_ssl_session_reset(&server->context->ssl);
-    server->context->state = TLS_SERVER_HANDSHAKE;
+    TLS_ServerClose(server);
   }
-}
 
-static void TLS_ServerDeinit(const TLS_ServerConfigType *server) {
-  mbedtls_x509_crt_free(&server->context->srvcert);
-  mbedtls_pk_free(&server->context->pkey);
-  mbedtls_ssl_free(&server->context->ssl);
-  mbedtls_ssl_config_free(&server->context->conf);
-#if defined(MBEDTLS_SSL_CACHE_C)
-  mbedtls_ssl_cache_free(&server->context->cache);
-#endif
-  mbedtls_ctr_drbg_free(&server->context->ctr_drbg);
-  mbedtls_entropy_free(&server->context->entropy);
-  server->context->state = TLS_SERVER_IDLE;
+  if (FALSE == server->context->bSetup) {
+    ret = TLS_ServerSetup(server);
+  }
+
+  if (E_OK == ret) {
+    ret = SoAd_TakeControl(server->SoConId);
+  }
+
+  if (E_OK == ret) {
+    ASLOG(TLS, ("Server %s connected\n", server->name));
+    server->context->state = TLS_SERVER_HANDSHAKE;
+  }
 }
 
 static void TLS_ServerSoConModeChg(const TLS_ServerConfigType *server, SoAd_SoConModeType Mode) {
   if (SOAD_SOCON_ONLINE == Mode) {
     TLS_ServerSwitchOnline(server);
   } else {
-    TLS_ServerDeinit(server);
+    TLS_ServerClose(server);
   }
 }
 
@@ -249,28 +423,34 @@ static void TLS_ServerHandShake(const TLS_ServerConfigType *server) {
   if (0 == rc) {
     server->SoConModeChgNotification(server->SoConId, SOAD_SOCON_ONLINE);
     server->context->state = TLS_SERVER_READY;
-  } else if ((rc != MBEDTLS_ERR_SSL_WANT_READ) && (rc != MBEDTLS_ERR_SSL_WANT_WRITE)) {
+  } else if (!TLS_IS_WANT(rc)) {
     ASLOG(TLSE, ("mbedtls_ssl_handshake returned %d\n", rc));
-    server->context->state = TLS_SERVER_DEAD;
-    (void)SoAd_CloseSoCon(server->SoConId, TRUE);
-    TLS_ServerDeinit(server);
+    TLS_ServerAbort(server, FALSE);
   } else {
     // ASLOG(TLS, ("hand shake on going, rc=%d\n", rc));
   }
 }
 
-static void TLS_ServerRecvStart(const TLS_ServerConfigType *server) {
+static boolean TLS_ServerRecvStart(const TLS_ServerConfigType *server) {
   Std_ReturnType ret = E_NOT_OK;
+  boolean bReceived = FALSE;
   int rc;
-  uint8_t *data;
+  uint8_t *data = NULL;
   PduInfoType PduInfo;
   uint32_t rxLen;
   uint32_t length = 0; /* length of left data */
   uint8_t header[TLS_HEADER_MAX_LEN];
   TcpIp_SockAddrType RemoteAddr;
 
-  (void)mbedtls_ssl_read(&server->context->ssl, NULL, 0);
-  rxLen = mbedtls_ssl_get_bytes_avail(&server->context->ssl);
+  /* parse the next record when the last one is consumed */
+  rc = mbedtls_ssl_read(&server->context->ssl, NULL, 0);
+  if ((rc < 0) && (!TLS_IS_WANT(rc))) {
+    ASLOG(TLSE, ("%s: mbedtls_ssl_read returned %d\n", server->name, rc));
+    TLS_ServerAbort(server, TRUE);
+    rxLen = 0;
+  } else {
+    rxLen = mbedtls_ssl_get_bytes_avail(&server->context->ssl);
+  }
   if (server->headerLen > 0) {
     if (rxLen >= server->headerLen) {
       rxLen = server->headerLen;
@@ -297,6 +477,7 @@ static void TLS_ServerRecvStart(const TLS_ServerConfigType *server) {
     rc = mbedtls_ssl_read(&server->context->ssl, data, rxLen);
     if (rc >= 0) {
       if (rc > 0) {
+        bReceived = TRUE;
         ASLOG(TLS, ("%s: read %d bytes\n", server->name, rc));
         PduInfo.SduDataPtr = data;
         PduInfo.SduLength = rc;
@@ -326,12 +507,9 @@ static void TLS_ServerRecvStart(const TLS_ServerConfigType *server) {
       } else {
         ASLOG(TLSE, ("%s: recv with 0 bytes\n", server->name));
       }
-    } else if ((rc != MBEDTLS_ERR_SSL_WANT_READ) && (rc != MBEDTLS_ERR_SSL_WANT_WRITE)) {
+    } else if (!TLS_IS_WANT(rc)) {
       ASLOG(TLSE, ("mbedtls_ssl_read returned %d\n", rc));
-      server->context->state = TLS_SERVER_DEAD;
-      (void)SoAd_CloseSoCon(server->SoConId, TRUE);
-      TLS_ServerDeinit(server);
-      server->SoConModeChgNotification(server->SoConId, SOAD_SOCON_OFFLINE);
+      TLS_ServerAbort(server, TRUE);
     } else {
       /* OK */
     }
@@ -339,18 +517,29 @@ static void TLS_ServerRecvStart(const TLS_ServerConfigType *server) {
       Net_MemFree(data);
     }
   }
+
+  return bReceived;
 }
 
-static void TLS_ServerRecvLeft(const TLS_ServerConfigType *server) {
+static boolean TLS_ServerRecvLeft(const TLS_ServerConfigType *server) {
   int rc;
   Std_ReturnType ret = E_NOT_OK;
+  boolean bReceived = FALSE;
   uint32_t rxLen;
   uint8_t *data = NULL;
   PduInfoType PduInfo;
   uint8_t cache[TLS_LOCAL_DATA_MAX_SIZE];
   TcpIp_SockAddrType RemoteAddr;
 
-  rxLen = mbedtls_ssl_get_bytes_avail(&server->context->ssl);
+  /* parse the next record when the last one is consumed */
+  rc = mbedtls_ssl_read(&server->context->ssl, NULL, 0);
+  if ((rc < 0) && (!TLS_IS_WANT(rc))) {
+    ASLOG(TLSE, ("%s: mbedtls_ssl_read returned %d\n", server->name, rc));
+    TLS_ServerAbort(server, TRUE);
+    rxLen = 0;
+  } else {
+    rxLen = mbedtls_ssl_get_bytes_avail(&server->context->ssl);
+  }
   if (rxLen > 0) {
     if (rxLen > server->context->length) {
       rxLen = server->context->length;
@@ -370,6 +559,7 @@ static void TLS_ServerRecvLeft(const TLS_ServerConfigType *server) {
     rc = mbedtls_ssl_read(&server->context->ssl, data, rxLen);
     if (rc >= 0) {
       if (rc > 0) {
+        bReceived = TRUE;
         server->context->offset += rc;
         if (server->context->length > rc) {
           server->context->length -= rc;
@@ -389,30 +579,73 @@ static void TLS_ServerRecvLeft(const TLS_ServerConfigType *server) {
           server->context->data = NULL;
         }
       }
-    } else if ((rc != MBEDTLS_ERR_SSL_WANT_READ) && (rc != MBEDTLS_ERR_SSL_WANT_WRITE)) {
+    } else if (!TLS_IS_WANT(rc)) {
       ASLOG(TLSE, ("mbedtls_ssl_read returned %d\n", rc));
-      server->context->state = TLS_SERVER_DEAD;
-      (void)SoAd_CloseSoCon(server->SoConId, TRUE);
-      TLS_ServerDeinit(server);
-      server->SoConModeChgNotification(server->SoConId, SOAD_SOCON_OFFLINE);
-      if (NULL != server->context->data) {
-        Net_MemFree(server->context->data);
-        server->context->data = NULL;
-      }
+      TLS_ServerAbort(server, TRUE);
     } else {
       /* OK */
     }
   }
+
+  return bReceived;
 }
 
 static void TLS_ServerReady(const TLS_ServerConfigType *server) {
+  boolean bReceived = TRUE;
+  uint16_t count = 0;
+
+  /* all the PDUs that have arrived are given to the upper layer in this cycle */
+  while ((TRUE == bReceived) && (TLS_SERVER_READY == server->context->state) &&
+         (count < TLS_RX_MAX_PDUS_PER_CYCLE)) {
+    if (0 == server->context->length) {
+      bReceived = TLS_ServerRecvStart(server);
+    } else {
+      bReceived = TLS_ServerRecvLeft(server);
+    }
+    count++;
+  }
+}
 
-  if (0 == server->context->length) {
-    TLS_ServerRecvStart(server);
-  } else {
-    TLS_ServerRecvLeft(server);
+static Std_ReturnType TLS_ServerWrite(const TLS_ServerConfigType *server, const uint8_t *data,
+                                      uint32_t length) {
+  Std_ReturnType ret = E_NOT_OK;
+  int rc;
+
+  rc = mbedtls_ssl_write(&server->context->ssl, data, length);
+  if (rc == (int)length) {
+    ret = E_OK;
+  }
+
+  return ret;
+}
+
+#if TLS_TX_BUFFER_SIZE > 0
+/* write the PDUs coalesced in this cycle as one record */
+static void TLS_ServerWritePending(const TLS_ServerConfigType *server) {
+  TLS_ServerContextType *context = server->context;
+  uint16_t len;
+  int rc;
+
+  while ((context->txLen > 0u) && (TLS_SERVER_READY == context->state)) {
+    /* after a MBEDTLS_ERR_SSL_WANT_WRITE, the mbedtls must be called with the same data */
+    len = (context->txRecord > 0u) ? context->txRecord : context->txLen;
+    rc = mbedtls_ssl_write(&context->ssl, context->txBuf, len);
+    if (rc > 0) {
+      context->txRecord = 0;
+      context->txLen -= (uint16_t)rc;
+      if (context->txLen > 0u) {
+        (void)memmove(context->txBuf, &context->txBuf[rc], context->txLen);
+      }
+    } else if (TLS_IS_WANT(rc)) {
+      context->txRecord = len;
+      break;
+    } else {
+      ASLOG(TLSE, ("%s: mbedtls_ssl_write returned %d\n", server->name, rc));
+      TLS_ServerAbort(server, TRUE);
+    }
   }
 }
+#endif
 
 static void TLS_ServerMainFunction(const TLS_ServerConfigType *server) {
   switch (server->context->state) {
@@ -425,18 +658,45 @@ static void TLS_ServerMainFunction(const TLS_ServerConfigType *server) {
   default:
     break;
   }
+
+#if TLS_TX_BUFFER_SIZE > 0
+  TLS_ServerWritePending(server);
+#endif
+#if TLS_NET_BUFFER_SIZE > 0
+  if (TLS_SERVER_IDLE != server->context->state) {
+    (void)TLS_NetFlush(server);
+  }
+#endif
 }
 
 static Std_ReturnType TLS_ServerTransmit(uint16_t serverIdx, const PduInfoType *PduInfoPtr) {
   Std_ReturnType ret = E_NOT_OK;
-  int rc;
   const TLS_ServerConfigType *server = &TLS_CONFIG->servers[serverIdx];
-  if (TLS_SERVER_READY == server->context->state) {
-    rc = mbedtls_ssl_write(&server->context->ssl, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
-    if (rc == PduInfoPtr->SduLength) {
+#if TLS_TX_BUFFER_SIZE > 0
+  TLS_ServerContextType *context = server->context;
+
+  if (TLS_SERVER_READY == context->state) {
+    if (PduInfoPtr->SduLength > (PduLengthType)(TLS_TX_BUFFER_SIZE - context->txLen)) {
+      TLS_ServerWritePending(server);
+    }
+    if (TLS_SERVER_READY != context->state) {
+      /* aborted by the write error */
+    } else if (PduInfoPtr->SduLength <= (PduLengthType)(TLS_TX_BUFFER_SIZE - context->txLen)) {
+      (void)memcpy(&context->txBuf[context->txLen], PduInfoPtr->SduDataPtr,
+                   PduInfoPtr->SduLength);
+      context->txLen += (uint16_t)PduInfoPtr->SduLength;
       ret = E_OK;
+    } else if (0u == context->txLen) {
+      ret = TLS_ServerWrite(server, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+    } else {
+      /* busy, the upper layer retries later */
     }
   }
+#else
+  if (TLS_SERVER_READY == server->context->state) {
+    ret = TLS_ServerWrite(server, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+  }
+#endif
   return ret;
 }
 /* ================================ [ FUNCTIONS ] ============================================== */
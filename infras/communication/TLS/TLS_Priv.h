@@ -18,12 +18,62 @@
 #if defined(MBEDTLS_SSL_CACHE_C)
 #include "mbedtls/ssl_cache.h"
 #endif
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+#include "mbedtls/ssl_ticket.h"
+#define TLS_USE_SESSION_TICKETS
+#endif
+#if defined(MBEDTLS_USE_PSA_CRYPTO) || defined(MBEDTLS_SSL_PROTO_TLS1_3)
+#include "psa/crypto.h"
+#define TLS_USE_PSA_CRYPTO
+#endif
 /* ================================ [ MACROS    ] ============================================== */
+/* The batching buffers below are in the context of each server, so they cost their size in RAM
+ * per server, e.g. 5 KB for 1024, 2048 and 2048. They are disabled by default. */
+
+/* the application PDUs given by TLS_IfTransmit within one main function cycle are coalesced in
+ * a buffer of this size and written as one TLS record, 0 to write each PDU as its own record */
+#ifndef TLS_TX_BUFFER_SIZE
+#define TLS_TX_BUFFER_SIZE 0
+#endif
+
+/* the records and handshake messages produced within one main function cycle are collected in a
+ * buffer of this size and given to the SoAd by one transmit, 0 to transmit each one directly */
+#ifndef TLS_NET_BUFFER_SIZE
+#define TLS_NET_BUFFER_SIZE 0
+#endif
+
+/* all the data available on the socket up to this size is read by one receive and then parsed
+ * from this buffer, record bodies not smaller than the half of it are received directly into the
+ * record buffer of the mbedtls, 0 to receive exactly what the mbedtls asks for */
+#ifndef TLS_RX_BUFFER_SIZE
+#define TLS_RX_BUFFER_SIZE 0
+#endif
+
+/* the max number of PDUs given to the upper layer by one main function cycle */
+#ifndef TLS_RX_MAX_PDUS_PER_CYCLE
+#define TLS_RX_MAX_PDUS_PER_CYCLE 32
+#endif
+
+/* sessions of the clients are kept in a cache shared by all servers for an abbreviated handshake
+ * when the client reconnects, 0 to disable the session ID resumption */
+#ifndef TLS_SESSION_CACHE_MAX_ENTRIES
+#define TLS_SESSION_CACHE_MAX_ENTRIES 8
+#endif
+
+/* in seconds */
+#ifndef TLS_SESSION_CACHE_TIMEOUT
+#define TLS_SESSION_CACHE_TIMEOUT 3600
+#endif
+
+/* the lifetime of the session tickets in seconds, 0 to disable the session tickets */
+#ifndef TLS_SESSION_TICKET_LIFETIME
+#define TLS_SESSION_TICKET_LIFETIME 3600
+#endif
+
 #define TLS_SERVER_IDLE ((TLS_ServerStateType)0)
 #define TLS_SERVER_HANDSHAKE ((TLS_ServerStateType)1)
 #define TLS_SERVER_READY ((TLS_ServerStateType)2)
 #define TLS_SERVER_RESPONSE ((TLS_ServerStateType)3)
-#define TLS_SERVER_DEAD ((TLS_ServerStateType)4)
 /* ================================ [ TYPES     ] ============================================== */
 typedef uint8_t TLS_ServerStateType;
 
@@ -35,14 +85,40 @@ typedef struct {
   mbedtls_ssl_config conf;
   mbedtls_x509_crt srvcert;
   mbedtls_pk_context pkey;
-#if defined(MBEDTLS_SSL_CACHE_C)
-  mbedtls_ssl_cache_context cache;
-#endif
   TLS_ServerStateType state;
+  boolean bSetup; /* the certificates, RNG, config and ssl context are kept over connections */
   PduLengthType length; /* length of the whole packet size */
   PduLengthType offset;
+#if TLS_TX_BUFFER_SIZE > 0
+  uint16_t txLen;    /* plaintext in txBuf not yet written to the mbedtls */
+  uint16_t txRecord; /* length of the write pending on MBEDTLS_ERR_SSL_WANT_WRITE */
+  uint8_t txBuf[TLS_TX_BUFFER_SIZE];
+#endif
+#if TLS_NET_BUFFER_SIZE > 0
+  uint16_t netLen; /* ciphertext in netBuf not yet given to the SoAd */
+  uint8_t netBuf[TLS_NET_BUFFER_SIZE];
+#endif
+#if TLS_RX_BUFFER_SIZE > 0
+  uint16_t rxPos; /* ciphertext in rxBuf from rxPos to rxLen not yet given to the mbedtls */
+  uint16_t rxLen;
+  uint8_t rxBuf[TLS_RX_BUFFER_SIZE];
+#endif
 } TLS_ServerContextType;
 
+/* the session cache and the ticket key are shared by all servers as a client may be accepted by
+ * another server of the same port when it reconnects */
+typedef struct {
+  mbedtls_entropy_context entropy;
+  mbedtls_ctr_drbg_context ctr_drbg;
+#if defined(MBEDTLS_SSL_CACHE_C)
+  mbedtls_ssl_cache_context cache;
+#endif
+#ifdef TLS_USE_SESSION_TICKETS
+  mbedtls_ssl_ticket_context ticket;
+#endif
+  boolean bSetup;
+} TLS_SessionStoreType;
+
 typedef struct {
   TLS_ServerContextType *context;
   const char *name;
@@ -0,0 +1,20 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * the network memory of the TLS test and bench, implemented by tls_test.c and tls_bench.c on the
+ * heap
+ */
+#ifndef NET_MEM_H
+#define NET_MEM_H
+/* ================================ [ INCLUDES  ] ============================================== */
+#include <stdint.h>
+/* ================================ [ MACROS    ] ============================================== */
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+void *Net_MemAlloc(uint32_t size);
+void Net_MemFree(void *buffer);
+#endif /* NET_MEM_H */
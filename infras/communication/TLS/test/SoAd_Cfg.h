@@ -0,0 +1,19 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * SoAd IDs of the TLS test and bench, the SoAd is stubbed by tls_test.c and tls_bench.c over a
+ * loopback TCP connection
+ */
+#ifndef SOAD_CFG_H
+#define SOAD_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#define SOAD_SOCKID_TEST_TCP 0
+#define SOAD_TX_PID_TEST_TCP 0
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* SOAD_CFG_H */
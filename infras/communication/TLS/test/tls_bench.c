@@ -0,0 +1,516 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Handshakes per second and throughput of the TLS server on the host loopback: the SoAd is stubbed
+ * by a TCP connection on 127.0.0.1 whose other end is a mbedtls client driven in the same thread as
+ * the TLS_MainFunction, one call of the TLS_MainFunction is one main function cycle.
+ * The full handshakes are compared with the ones resumed by the session of the previous
+ * connection, the upload sends large PDUs from the client to the server and the download sends
+ * small PDUs from the server to the client. Build the ApplicationTLSBenchDirect with the
+ * direct/TLS.json to measure without the coalescing, the read ahead and the session resumption.
+ * The functional checks of the same setup are done by tls_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "TLS.h"
+#include "TLS_Cfg.h"
+#include "TLS_Priv.h"
+#include "SoAd_Cfg.h"
+#include "NetMem.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_HANDSHAKES
+#define BENCH_HANDSHAKES 100u
+#endif
+
+#ifndef BENCH_BYTES
+#define BENCH_BYTES (8u * 1024u * 1024u)
+#endif
+
+#ifndef BENCH_UPLOAD_PDU_SIZE
+#define BENCH_UPLOAD_PDU_SIZE 1024u
+#endif
+
+#ifndef BENCH_DOWNLOAD_PDU_SIZE
+#define BENCH_DOWNLOAD_PDU_SIZE 64u
+#endif
+
+/* the PDUs given to the TLS by the upper layer or sent by the client within one cycle */
+#ifndef BENCH_PDUS_PER_CYCLE
+#define BENCH_PDUS_PER_CYCLE 16u
+#endif
+
+/* large enough that a send on the loopback is never partial */
+#define BENCH_SOCKET_BUFFER_SIZE (4 * 1024 * 1024)
+
+/* a step of the connection not done within this time is a failure */
+#define BENCH_TIMEOUT (2 * STD_TIMER_ONE_SECOND)
+
+#define BENCH_IS_WANT(rc)                                                                          \
+  ((MBEDTLS_ERR_SSL_WANT_READ == (rc)) || (MBEDTLS_ERR_SSL_WANT_WRITE == (rc)))
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t recvs;  /* receives done by the TLS */
+  uint32_t sends;  /* transmits done by the TLS */
+  uint64_t wire;   /* bytes transmitted by the TLS */
+  uint64_t rxData; /* plaintext bytes given to the upper layer */
+} Bench_StatsType;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static int Bench_ListenFd = -1;
+static int Bench_ServerFd = -1;
+static int Bench_ClientFd = -1;
+static boolean Bench_Online = FALSE;
+static boolean Bench_Closed = FALSE;
+static boolean Bench_Echo = FALSE;
+static Bench_StatsType Bench_Stats;
+
+static mbedtls_entropy_context Bench_Entropy;
+static mbedtls_ctr_drbg_context Bench_CtrDrbg;
+static mbedtls_ssl_config Bench_Conf;
+static mbedtls_ssl_context Bench_Ssl;
+static mbedtls_ssl_session Bench_Session;
+static boolean Bench_HasSession = FALSE;
+/* ================================ [ LOCALS    ] ============================================== */
+static int Bench_ClientSend(void *ctx, const unsigned char *buf, size_t len) {
+  int rc;
+  ssize_t n = send(Bench_ClientFd, buf, len, MSG_NOSIGNAL);
+
+  if (n >= 0) {
+    rc = (int)n;
+  } else if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+    rc = MBEDTLS_ERR_SSL_WANT_WRITE;
+  } else {
+    rc = MBEDTLS_ERR_NET_SEND_FAILED;
+  }
+
+  return rc;
+}
+
+static int Bench_ClientRecv(void *ctx, unsigned char *buf, size_t len) {
+  int rc;
+  ssize_t n = recv(Bench_ClientFd, buf, len, 0);
+
+  if (n > 0) {
+    rc = (int)n;
+  } else if (0 == n) {
+    rc = MBEDTLS_ERR_NET_CONN_RESET;
+  } else if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+    rc = MBEDTLS_ERR_SSL_WANT_READ;
+  } else {
+    rc = MBEDTLS_ERR_NET_RECV_FAILED;
+  }
+
+  return rc;
+}
+
+static void Bench_SetupSocket(int fd) {
+  int on = 1;
+  int size = BENCH_SOCKET_BUFFER_SIZE;
+
+  (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  (void)setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+  (void)setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void Bench_Listen(void) {
+  struct sockaddr_in addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  Bench_ListenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if ((Bench_ListenFd < 0) || (0 != bind(Bench_ListenFd, (struct sockaddr *)&addr, sizeof(addr))) ||
+      (0 != listen(Bench_ListenFd, 4))) {
+    printf("failed to listen on the loopback: %s\n", strerror(errno));
+    exit(-1);
+  }
+}
+
+static void Bench_ClientSetup(void) {
+  int rc;
+
+#ifdef TLS_USE_PSA_CRYPTO
+  (void)psa_crypto_init();
+#endif
+  mbedtls_entropy_init(&Bench_Entropy);
+  mbedtls_ctr_drbg_init(&Bench_CtrDrbg);
+  mbedtls_ssl_config_init(&Bench_Conf);
+  mbedtls_ssl_init(&Bench_Ssl);
+  mbedtls_ssl_session_init(&Bench_Session);
+
+  rc = mbedtls_ctr_drbg_seed(&Bench_CtrDrbg, mbedtls_entropy_func, &Bench_Entropy,
+                             (const unsigned char *)"bench", 5);
+  if (0 == rc) {
+    rc = mbedtls_ssl_config_defaults(&Bench_Conf, MBEDTLS_SSL_IS_CLIENT,
+                                     MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+  }
+  if (0 == rc) {
+    mbedtls_ssl_conf_authmode(&Bench_Conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&Bench_Conf, mbedtls_ctr_drbg_random, &Bench_CtrDrbg);
+    rc = mbedtls_ssl_setup(&Bench_Ssl, &Bench_Conf);
+  }
+  if (0 != rc) {
+    printf("failed to setup the client: %d\n", rc);
+    exit(-1);
+  }
+  mbedtls_ssl_set_bio(&Bench_Ssl, NULL, Bench_ClientSend, Bench_ClientRecv, NULL);
+}
+
+static void Bench_Connect(boolean bResume) {
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+
+  (void)getsockname(Bench_ListenFd, (struct sockaddr *)&addr, &len);
+  Bench_ClientFd = socket(AF_INET, SOCK_STREAM, 0);
+  if ((Bench_ClientFd < 0) || (0 != connect(Bench_ClientFd, (struct sockaddr *)&addr, len))) {
+    printf("failed to connect: %s\n", strerror(errno));
+    exit(-1);
+  }
+  Bench_ServerFd = accept(Bench_ListenFd, NULL, NULL);
+  if (Bench_ServerFd < 0) {
+    printf("failed to accept: %s\n", strerror(errno));
+    exit(-1);
+  }
+  Bench_SetupSocket(Bench_ClientFd);
+  Bench_SetupSocket(Bench_ServerFd);
+
+  Bench_Online = FALSE;
+  Bench_Closed = FALSE;
+  TLS_SoConModeChg(SOAD_SOCKID_TEST_TCP, SOAD_SOCON_ONLINE);
+
+  (void)mbedtls_ssl_session_reset(&Bench_Ssl);
+  if ((TRUE == bResume) && (TRUE == Bench_HasSession)) {
+    (void)mbedtls_ssl_set_session(&Bench_Ssl, &Bench_Session);
+  }
+}
+
+static void Bench_Disconnect(void) {
+  Std_TimerType timer;
+
+  Std_TimerStart(&timer);
+  (void)mbedtls_ssl_close_notify(&Bench_Ssl);
+  /* the server closes the socket on the close notify */
+  while ((FALSE == Bench_Closed) && (Std_GetTimerElapsedTime(&timer) < BENCH_TIMEOUT)) {
+    TLS_MainFunction();
+  }
+  close(Bench_ClientFd);
+  Bench_ClientFd = -1;
+  if (FALSE == Bench_Closed) {
+    printf("the server has not seen the close notify\n");
+    (void)SoAd_CloseSoCon(SOAD_SOCKID_TEST_TCP, TRUE);
+  }
+  /* as what the SoAd does after the socket is closed */
+  TLS_SoConModeChg(SOAD_SOCKID_TEST_TCP, SOAD_SOCON_OFFLINE);
+}
+
+static boolean Bench_Handshake(void) {
+  Std_TimerType timer;
+  int rc;
+
+  Std_TimerStart(&timer);
+  do {
+    rc = mbedtls_ssl_handshake(&Bench_Ssl);
+    TLS_MainFunction();
+  } while (BENCH_IS_WANT(rc) && (Std_GetTimerElapsedTime(&timer) < BENCH_TIMEOUT));
+
+  while ((0 == rc) && (FALSE == Bench_Online) && (FALSE == Bench_Closed) &&
+         (Std_GetTimerElapsedTime(&timer) < BENCH_TIMEOUT)) {
+    TLS_MainFunction();
+  }
+
+  if ((0 != rc) || (FALSE == Bench_Online)) {
+    printf("handshake failed: %d\n", rc);
+  }
+
+  return (0 == rc) && (TRUE == Bench_Online);
+}
+
+/* an echo through the upper layer, the client has then got the session ticket if any */
+static boolean Bench_Ping(void) {
+  Std_TimerType timer;
+  const uint8_t ping[4] = {'p', 'i', 'n', 'g'};
+  uint8_t pong[sizeof(ping)];
+  size_t got = 0;
+  int rc;
+
+  Std_TimerStart(&timer);
+  Bench_Echo = TRUE;
+  do {
+    rc = mbedtls_ssl_write(&Bench_Ssl, ping, sizeof(ping));
+    TLS_MainFunction();
+  } while (BENCH_IS_WANT(rc) && (Std_GetTimerElapsedTime(&timer) < BENCH_TIMEOUT));
+
+  while ((rc > 0) && (got < sizeof(pong)) && (Std_GetTimerElapsedTime(&timer) < BENCH_TIMEOUT)) {
+    rc = mbedtls_ssl_read(&Bench_Ssl, &pong[got], sizeof(pong) - got);
+    if (rc > 0) {
+      got += (size_t)rc;
+    } else if (BENCH_IS_WANT(rc)
+#ifdef MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET
+               || (MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET == rc)
+#endif
+    ) {
+      rc = 1;
+      TLS_MainFunction();
+    } else {
+      printf("ping failed: %d\n", rc);
+    }
+  }
+  Bench_Echo = FALSE;
+
+  return (got == sizeof(pong)) && (0 == memcmp(ping, pong, sizeof(ping)));
+}
+
+static void Bench_Handshakes(const char *name, boolean bResume) {
+  Std_TimerType timer;
+  std_time_t elapsed;
+  uint32_t i;
+  uint32_t done = 0;
+  uint64_t wire = 0;
+
+  mbedtls_ssl_session_free(&Bench_Session);
+  mbedtls_ssl_session_init(&Bench_Session);
+  Bench_HasSession = FALSE;
+
+  /* the first connection is not counted, it makes the session to be resumed */
+  for (i = 0; i <= BENCH_HANDSHAKES; i++) {
+    if (1u == i) {
+      Std_TimerStart(&timer);
+      done = 0;
+      wire = 0;
+    }
+    Bench_Connect(bResume);
+    memset(&Bench_Stats, 0, sizeof(Bench_Stats));
+    if ((TRUE == Bench_Handshake()) && (TRUE == Bench_Ping())) {
+      done++;
+      wire += Bench_Stats.wire;
+      if (TRUE == bResume) {
+        mbedtls_ssl_session_free(&Bench_Session);
+        mbedtls_ssl_session_init(&Bench_Session);
+        Bench_HasSession = (0 == mbedtls_ssl_get_session(&Bench_Ssl, &Bench_Session));
+      }
+    }
+    Bench_Disconnect();
+  }
+  elapsed = Std_GetTimerElapsedTime(&timer);
+
+  printf("%-8s: %u/%u connections in %.3f s, %.1f handshakes/s, %.0f bytes from the server "
+         "per connection\n",
+         name, done, BENCH_HANDSHAKES, (double)elapsed / 1000000.0,
+         (double)done * 1000000.0 / (double)elapsed, (done > 0) ? (double)wire / done : 0.0);
+}
+
+static void Bench_Upload(void) {
+  static uint8_t pdu[BENCH_UPLOAD_PDU_SIZE];
+  Std_TimerType timer;
+  std_time_t elapsed;
+  uint64_t sent = 0;
+  uint32_t cycles = 0;
+  uint32_t i;
+  int rc = 0;
+
+  memset(pdu, 0x5A, sizeof(pdu));
+  Bench_Connect(TRUE);
+  if (FALSE == Bench_Handshake()) {
+    Bench_Disconnect();
+    return;
+  }
+
+  memset(&Bench_Stats, 0, sizeof(Bench_Stats));
+  Std_TimerStart(&timer);
+  while ((Bench_Stats.rxData < BENCH_BYTES) &&
+         (Std_GetTimerElapsedTime(&timer) < (BENCH_TIMEOUT * 10))) {
+    for (i = 0; (i < BENCH_PDUS_PER_CYCLE) && (sent < BENCH_BYTES); i++) {
+      rc = mbedtls_ssl_write(&Bench_Ssl, pdu, sizeof(pdu));
+      if (rc > 0) {
+        sent += (uint64_t)rc;
+      } else {
+        break;
+      }
+    }
+    if ((rc < 0) && (!BENCH_IS_WANT(rc))) {
+      printf("upload failed: %d\n", rc);
+      break;
+    }
+    TLS_MainFunction();
+    cycles++;
+  }
+  elapsed = Std_GetTimerElapsedTime(&timer);
+
+  printf("upload  : %.1f MB in %.3f s, %.1f MB/s, %u cycles, %.2f receives per %u bytes PDU\n",
+         (double)Bench_Stats.rxData / 1048576.0, (double)elapsed / 1000000.0,
+         (double)Bench_Stats.rxData / (double)elapsed, cycles,
+         (double)Bench_Stats.recvs * BENCH_UPLOAD_PDU_SIZE / (double)Bench_Stats.rxData,
+         BENCH_UPLOAD_PDU_SIZE);
+  Bench_Disconnect();
+}
+
+static void Bench_Download(void) {
+  static uint8_t pdu[BENCH_DOWNLOAD_PDU_SIZE];
+  static uint8_t buf[16 * 1024];
+  PduInfoType PduInfo;
+  Std_TimerType timer;
+  std_time_t elapsed;
+  uint64_t given = 0;
+  uint64_t received = 0;
+  uint32_t cycles = 0;
+  uint32_t i;
+  int rc = 0;
+
+  memset(pdu, 0xA5, sizeof(pdu));
+  PduInfo.SduDataPtr = pdu;
+  PduInfo.SduLength = sizeof(pdu);
+  PduInfo.MetaDataPtr = NULL;
+  Bench_Connect(TRUE);
+  if (FALSE == Bench_Handshake()) {
+    Bench_Disconnect();
+    return;
+  }
+
+  memset(&Bench_Stats, 0, sizeof(Bench_Stats));
+  Std_TimerStart(&timer);
+  while ((received < BENCH_BYTES) && (Std_GetTimerElapsedTime(&timer) < (BENCH_TIMEOUT * 10))) {
+    for (i = 0; (i < BENCH_PDUS_PER_CYCLE) && (given < BENCH_BYTES); i++) {
+      if (E_OK == TLS_IfTransmit(TLS_TX_PID_TEST_TCP, &PduInfo)) {
+        given += sizeof(pdu);
+      }
+    }
+    TLS_MainFunction();
+    cycles++;
+    do {
+      rc = mbedtls_ssl_read(&Bench_Ssl, buf, sizeof(buf));
+      if (rc > 0) {
+        received += (uint64_t)rc;
+      }
+    } while (rc > 0);
+    if (!BENCH_IS_WANT(rc)) {
+      printf("download failed: %d\n", rc);
+      break;
+    }
+  }
+  elapsed = Std_GetTimerElapsedTime(&timer);
+
+  printf("download: %.1f MB in %.3f s, %.1f MB/s, %u cycles, %.2f transmits per cycle, "
+         "%.3f wire bytes per payload byte\n",
+         (double)received / 1048576.0, (double)elapsed / 1000000.0,
+         (double)received / (double)elapsed, cycles, (double)Bench_Stats.sends / cycles,
+         (received > 0) ? (double)Bench_Stats.wire / (double)received : 0.0);
+  Bench_Disconnect();
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+void *Net_MemAlloc(uint32_t size) {
+  return malloc(size);
+}
+
+void Net_MemFree(void *buffer) {
+  free(buffer);
+}
+
+Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  ssize_t n;
+
+  if (Bench_ServerFd >= 0) {
+    n = send(Bench_ServerFd, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength, MSG_NOSIGNAL);
+    if (n == (ssize_t)PduInfoPtr->SduLength) {
+      Bench_Stats.sends++;
+      Bench_Stats.wire += (uint64_t)n;
+      ret = E_OK;
+    } else if (n > 0) {
+      printf("partial send %d of %u bytes\n", (int)n, (uint32_t)PduInfoPtr->SduLength);
+      exit(-1);
+    } else {
+      /* the socket buffer is full */
+    }
+  }
+
+  return ret;
+}
+
+Std_ReturnType SoAd_ControlRecv(SoAd_SoConIdType SoConId, uint8_t *data, uint32_t *length) {
+  Std_ReturnType ret = E_NOT_OK;
+  ssize_t n;
+  int avail = 0;
+
+  if (Bench_ServerFd >= 0) {
+    ret = E_OK;
+    if (NULL == data) {
+      (void)ioctl(Bench_ServerFd, FIONREAD, &avail);
+      *length = (uint32_t)avail;
+    } else {
+      Bench_Stats.recvs++;
+      n = recv(Bench_ServerFd, data, *length, 0);
+      if (n >= 0) {
+        *length = (uint32_t)n;
+      } else if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+        *length = 0;
+      } else {
+        ret = E_NOT_OK;
+      }
+    }
+  }
+
+  return ret;
+}
+
+Std_ReturnType SoAd_TakeControl(SoAd_SoConIdType SoConId) {
+  return E_OK;
+}
+
+Std_ReturnType SoAd_CloseSoCon(SoAd_SoConIdType SoConId, boolean abort) {
+  if (Bench_ServerFd >= 0) {
+    close(Bench_ServerFd);
+    Bench_ServerFd = -1;
+  }
+  Bench_Closed = TRUE;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_GetRemoteAddr(SoAd_SoConIdType SoConId, TcpIp_SockAddrType *IpAddrPtr) {
+  memset(IpAddrPtr, 0, sizeof(TcpIp_SockAddrType));
+  return E_OK;
+}
+
+void Test_SoConModeChg(SoAd_SoConIdType SoConId, SoAd_SoConModeType Mode) {
+  Bench_Online = (SOAD_SOCON_ONLINE == Mode);
+}
+
+Std_ReturnType Test_HeaderIndication(PduIdType id, const PduInfoType *info,
+                                     uint32_t *payloadLength) {
+  return E_NOT_OK;
+}
+
+void Test_RxIndication(PduIdType id, const PduInfoType *info) {
+  Bench_Stats.rxData += info->SduLength;
+  if (TRUE == Bench_Echo) {
+    (void)TLS_IfTransmit(TLS_TX_PID_TEST_TCP, info);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  printf("TLS_TX_BUFFER_SIZE=%u TLS_NET_BUFFER_SIZE=%u TLS_RX_BUFFER_SIZE=%u "
+         "TLS_SESSION_CACHE_MAX_ENTRIES=%u TLS_SESSION_TICKET_LIFETIME=%u\n",
+         TLS_TX_BUFFER_SIZE, TLS_NET_BUFFER_SIZE, TLS_RX_BUFFER_SIZE,
+         TLS_SESSION_CACHE_MAX_ENTRIES, TLS_SESSION_TICKET_LIFETIME);
+  TLS_Init(NULL);
+  Bench_Listen();
+  Bench_ClientSetup();
+  Bench_Handshakes("full", FALSE);
+  Bench_Handshakes("resumed", TRUE);
+  Bench_Upload();
+  Bench_Download();
+  return 0;
+}
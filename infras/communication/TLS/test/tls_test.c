@@ -0,0 +1,551 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * TLS server on the host loopback: the SoAd is stubbed by a TCP connection on 127.0.0.1 whose
+ * other end is a mbedtls client driven in the same thread as the TLS_MainFunction, one call of the
+ * TLS_MainFunction is one main function cycle. Every connection must handshake and echo a ping,
+ * a connection resumed by the session of the previous one must cost the server fewer bytes than a
+ * full handshake, the large PDUs uploaded by the client and the small PDUs downloaded from the
+ * server must all arrive intact, with fewer receives than records by the read ahead and fewer
+ * transmits than PDUs by the coalescing. The ApplicationTLSTestDirect is built with the
+ * direct/TLS.json without the coalescing, the read ahead and the session resumption.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "TLS.h"
+#include "TLS_Cfg.h"
+#include "TLS_Priv.h"
+#include "SoAd_Cfg.h"
+#include "NetMem.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_HANDSHAKES
+#define TEST_HANDSHAKES 100u
+#endif
+
+#ifndef TEST_BYTES
+#define TEST_BYTES (8u * 1024u * 1024u)
+#endif
+
+#ifndef TEST_UPLOAD_PDU_SIZE
+#define TEST_UPLOAD_PDU_SIZE 1024u
+#endif
+
+#ifndef TEST_DOWNLOAD_PDU_SIZE
+#define TEST_DOWNLOAD_PDU_SIZE 64u
+#endif
+
+/* the PDUs given to the TLS by the upper layer or sent by the client within one cycle */
+#ifndef TEST_PDUS_PER_CYCLE
+#define TEST_PDUS_PER_CYCLE 16u
+#endif
+
+/* large enough that a send on the loopback is never partial */
+#define TEST_SOCKET_BUFFER_SIZE (4 * 1024 * 1024)
+
+/* a step of the connection not done within this time is a failure */
+#define TEST_TIMEOUT (2 * STD_TIMER_ONE_SECOND)
+
+#define TEST_IS_WANT(rc)                                                                           \
+  ((MBEDTLS_ERR_SSL_WANT_READ == (rc)) || (MBEDTLS_ERR_SSL_WANT_WRITE == (rc)))
+
+#if (defined(MBEDTLS_SSL_CACHE_C) && (TLS_SESSION_CACHE_MAX_ENTRIES > 0)) ||                       \
+  (defined(TLS_USE_SESSION_TICKETS) && (TLS_SESSION_TICKET_LIFETIME > 0))
+#define TEST_USE_RESUMPTION
+#endif
+
+#define TEST_UPLOAD_BYTE 0x5A
+#define TEST_DOWNLOAD_BYTE 0xA5
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t recvs;  /* receives done by the TLS */
+  uint32_t sends;  /* transmits done by the TLS */
+  uint64_t wire;   /* bytes transmitted by the TLS */
+  uint64_t rxData; /* plaintext bytes given to the upper layer */
+  uint32_t rxBad;  /* plaintext bytes given to the upper layer not as uploaded */
+} test_stats_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static int testListenFd = -1;
+static int testServerFd = -1;
+static int testClientFd = -1;
+static boolean testOnline = FALSE;
+static boolean testClosed = FALSE;
+static boolean testEcho = FALSE;
+static test_stats_t testStats;
+
+static mbedtls_entropy_context testEntropy;
+static mbedtls_ctr_drbg_context testCtrDrbg;
+static mbedtls_ssl_config testConf;
+static mbedtls_ssl_context testSsl;
+static mbedtls_ssl_session testSession;
+static boolean testHasSession = FALSE;
+static uint64_t testFullWire;
+/* ================================ [ LOCALS    ] ============================================== */
+static int test_client_send(void *ctx, const unsigned char *buf, size_t len) {
+  int rc;
+  ssize_t n = send(testClientFd, buf, len, MSG_NOSIGNAL);
+
+  if (n >= 0) {
+    rc = (int)n;
+  } else if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+    rc = MBEDTLS_ERR_SSL_WANT_WRITE;
+  } else {
+    rc = MBEDTLS_ERR_NET_SEND_FAILED;
+  }
+
+  return rc;
+}
+
+static int test_client_recv(void *ctx, unsigned char *buf, size_t len) {
+  int rc;
+  ssize_t n = recv(testClientFd, buf, len, 0);
+
+  if (n > 0) {
+    rc = (int)n;
+  } else if (0 == n) {
+    rc = MBEDTLS_ERR_NET_CONN_RESET;
+  } else if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+    rc = MBEDTLS_ERR_SSL_WANT_READ;
+  } else {
+    rc = MBEDTLS_ERR_NET_RECV_FAILED;
+  }
+
+  return rc;
+}
+
+static void test_setup_socket(int fd) {
+  int on = 1;
+  int size = TEST_SOCKET_BUFFER_SIZE;
+
+  (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  (void)setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+  (void)setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void test_listen(void) {
+  struct sockaddr_in addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  testListenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if ((testListenFd < 0) || (0 != bind(testListenFd, (struct sockaddr *)&addr, sizeof(addr))) ||
+      (0 != listen(testListenFd, 4))) {
+    printf("failed to listen on the loopback: %s\n", strerror(errno));
+    exit(-1);
+  }
+}
+
+static void test_client_setup(void) {
+  int rc;
+
+#ifdef TLS_USE_PSA_CRYPTO
+  (void)psa_crypto_init();
+#endif
+  mbedtls_entropy_init(&testEntropy);
+  mbedtls_ctr_drbg_init(&testCtrDrbg);
+  mbedtls_ssl_config_init(&testConf);
+  mbedtls_ssl_init(&testSsl);
+  mbedtls_ssl_session_init(&testSession);
+
+  rc = mbedtls_ctr_drbg_seed(&testCtrDrbg, mbedtls_entropy_func, &testEntropy,
+                             (const unsigned char *)"bench", 5);
+  if (0 == rc) {
+    rc = mbedtls_ssl_config_defaults(&testConf, MBEDTLS_SSL_IS_CLIENT,
+                                     MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+  }
+  if (0 == rc) {
+    mbedtls_ssl_conf_authmode(&testConf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&testConf, mbedtls_ctr_drbg_random, &testCtrDrbg);
+    rc = mbedtls_ssl_setup(&testSsl, &testConf);
+  }
+  if (0 != rc) {
+    printf("failed to setup the client: %d\n", rc);
+    exit(-1);
+  }
+  mbedtls_ssl_set_bio(&testSsl, NULL, test_client_send, test_client_recv, NULL);
+}
+
+static void test_connect(boolean bResume) {
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+
+  (void)getsockname(testListenFd, (struct sockaddr *)&addr, &len);
+  testClientFd = socket(AF_INET, SOCK_STREAM, 0);
+  if ((testClientFd < 0) || (0 != connect(testClientFd, (struct sockaddr *)&addr, len))) {
+    printf("failed to connect: %s\n", strerror(errno));
+    exit(-1);
+  }
+  testServerFd = accept(testListenFd, NULL, NULL);
+  if (testServerFd < 0) {
+    printf("failed to accept: %s\n", strerror(errno));
+    exit(-1);
+  }
+  test_setup_socket(testClientFd);
+  test_setup_socket(testServerFd);
+
+  testOnline = FALSE;
+  testClosed = FALSE;
+  TLS_SoConModeChg(SOAD_SOCKID_TEST_TCP, SOAD_SOCON_ONLINE);
+
+  (void)mbedtls_ssl_session_reset(&testSsl);
+  if ((TRUE == bResume) && (TRUE == testHasSession)) {
+    (void)mbedtls_ssl_set_session(&testSsl, &testSession);
+  }
+}
+
+static void test_disconnect(void) {
+  Std_TimerType timer;
+
+  Std_TimerStart(&timer);
+  (void)mbedtls_ssl_close_notify(&testSsl);
+  /* the server closes the socket on the close notify */
+  while ((FALSE == testClosed) && (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT)) {
+    TLS_MainFunction();
+  }
+  close(testClientFd);
+  testClientFd = -1;
+  if (FALSE == testClosed) {
+    printf("the server has not seen the close notify\n");
+    (void)SoAd_CloseSoCon(SOAD_SOCKID_TEST_TCP, TRUE);
+  }
+  /* as what the SoAd does after the socket is closed */
+  TLS_SoConModeChg(SOAD_SOCKID_TEST_TCP, SOAD_SOCON_OFFLINE);
+}
+
+static boolean test_handshake(void) {
+  Std_TimerType timer;
+  int rc;
+
+  Std_TimerStart(&timer);
+  do {
+    rc = mbedtls_ssl_handshake(&testSsl);
+    TLS_MainFunction();
+  } while (TEST_IS_WANT(rc) && (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT));
+
+  while ((0 == rc) && (FALSE == testOnline) && (FALSE == testClosed) &&
+         (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT)) {
+    TLS_MainFunction();
+  }
+
+  if ((0 != rc) || (FALSE == testOnline)) {
+    printf("handshake failed: %d\n", rc);
+  }
+
+  return (0 == rc) && (TRUE == testOnline);
+}
+
+/* an echo through the upper layer, the client has then got the session ticket if any */
+static boolean test_ping(void) {
+  Std_TimerType timer;
+  const uint8_t ping[4] = {'p', 'i', 'n', 'g'};
+  uint8_t pong[sizeof(ping)];
+  size_t got = 0;
+  int rc;
+
+  Std_TimerStart(&timer);
+  testEcho = TRUE;
+  do {
+    rc = mbedtls_ssl_write(&testSsl, ping, sizeof(ping));
+    TLS_MainFunction();
+  } while (TEST_IS_WANT(rc) && (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT));
+
+  while ((rc > 0) && (got < sizeof(pong)) && (Std_GetTimerElapsedTime(&timer) < TEST_TIMEOUT)) {
+    rc = mbedtls_ssl_read(&testSsl, &pong[got], sizeof(pong) - got);
+    if (rc > 0) {
+      got += (size_t)rc;
+    } else if (TEST_IS_WANT(rc)
+#ifdef MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET
+               || (MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET == rc)
+#endif
+    ) {
+      rc = 1;
+      TLS_MainFunction();
+    } else {
+      printf("ping failed: %d\n", rc);
+    }
+  }
+  testEcho = FALSE;
+
+  return (got == sizeof(pong)) && (0 == memcmp(ping, pong, sizeof(ping)));
+}
+
+static void Test_Handshakes(const char *name, boolean bResume) {
+  uint32_t i;
+  uint32_t done = 0;
+  uint64_t wire = 0;
+  bool bPass;
+
+  printf("Test %u %s handshakes:", TEST_HANDSHAKES, name);
+  mbedtls_ssl_session_free(&testSession);
+  mbedtls_ssl_session_init(&testSession);
+  testHasSession = FALSE;
+
+  /* the first connection is not counted, it makes the session to be resumed */
+  for (i = 0; i <= TEST_HANDSHAKES; i++) {
+    test_connect(bResume);
+    memset(&testStats, 0, sizeof(testStats));
+    if ((TRUE == test_handshake()) && (TRUE == test_ping()) && (i > 0u)) {
+      done++;
+      wire += testStats.wire;
+    }
+    if (TRUE == bResume) {
+      mbedtls_ssl_session_free(&testSession);
+      mbedtls_ssl_session_init(&testSession);
+      testHasSession = (0 == mbedtls_ssl_get_session(&testSsl, &testSession));
+    }
+    test_disconnect();
+  }
+
+  bPass = (TEST_HANDSHAKES == done);
+  if (FALSE == bResume) {
+    testFullWire = wire;
+  } else {
+#ifdef TEST_USE_RESUMPTION
+    /* no certificate is sent for a resumed session */
+    bPass = bPass && (wire < testFullWire);
+#endif
+  }
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u/%u connections, %.0f bytes from the server per connection, %.0f for a full "
+           "handshake\n",
+           done, TEST_HANDSHAKES, (done > 0) ? (double)wire / done : 0.0,
+           (double)testFullWire / TEST_HANDSHAKES);
+    exit(-1);
+  }
+}
+
+static void Test_Upload(void) {
+  static uint8_t pdu[TEST_UPLOAD_PDU_SIZE];
+  Std_TimerType timer;
+  uint64_t sent = 0;
+  uint32_t i;
+  int rc = 0;
+  bool bPass;
+
+  printf("Test upload of %u bytes in %u bytes PDUs:", TEST_BYTES, TEST_UPLOAD_PDU_SIZE);
+  memset(pdu, TEST_UPLOAD_BYTE, sizeof(pdu));
+  test_connect(TRUE);
+  bPass = test_handshake();
+
+  memset(&testStats, 0, sizeof(testStats));
+  Std_TimerStart(&timer);
+  while (bPass && (testStats.rxData < TEST_BYTES) &&
+         (Std_GetTimerElapsedTime(&timer) < (TEST_TIMEOUT * 10))) {
+    for (i = 0; (i < TEST_PDUS_PER_CYCLE) && (sent < TEST_BYTES); i++) {
+      rc = mbedtls_ssl_write(&testSsl, pdu, sizeof(pdu));
+      if (rc > 0) {
+        sent += (uint64_t)rc;
+      } else {
+        break;
+      }
+    }
+    if ((rc < 0) && (!TEST_IS_WANT(rc))) {
+      printf(" upload failed: %d", rc);
+      bPass = false;
+    }
+    TLS_MainFunction();
+  }
+  test_disconnect();
+
+  bPass = bPass && (TEST_BYTES == testStats.rxData) && (0u == testStats.rxBad);
+#if TLS_RX_BUFFER_SIZE > 0
+  /* the read ahead takes several records by one receive */
+  bPass = bPass && (testStats.recvs < (TEST_BYTES / TEST_UPLOAD_PDU_SIZE));
+#endif
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %llu bytes received, %u not as sent, %u receives\n",
+           (unsigned long long)testStats.rxData, testStats.rxBad, testStats.recvs);
+    exit(-1);
+  }
+}
+
+static void Test_Download(void) {
+  static uint8_t pdu[TEST_DOWNLOAD_PDU_SIZE];
+  static uint8_t buf[16 * 1024];
+  PduInfoType PduInfo;
+  Std_TimerType timer;
+  uint64_t given = 0;
+  uint64_t received = 0;
+  uint32_t bad = 0;
+  uint32_t i;
+  int rc = 0;
+  bool bPass;
+
+  printf("Test download of %u bytes in %u bytes PDUs:", TEST_BYTES, TEST_DOWNLOAD_PDU_SIZE);
+  memset(pdu, TEST_DOWNLOAD_BYTE, sizeof(pdu));
+  PduInfo.SduDataPtr = pdu;
+  PduInfo.SduLength = sizeof(pdu);
+  PduInfo.MetaDataPtr = NULL;
+  test_connect(TRUE);
+  bPass = test_handshake();
+
+  memset(&testStats, 0, sizeof(testStats));
+  Std_TimerStart(&timer);
+  while (bPass && (received < TEST_BYTES) &&
+         (Std_GetTimerElapsedTime(&timer) < (TEST_TIMEOUT * 10))) {
+    for (i = 0; (i < TEST_PDUS_PER_CYCLE) && (given < TEST_BYTES); i++) {
+      if (E_OK == TLS_IfTransmit(TLS_TX_PID_TEST_TCP, &PduInfo)) {
+        given += sizeof(pdu);
+      }
+    }
+    TLS_MainFunction();
+    do {
+      rc = mbedtls_ssl_read(&testSsl, buf, sizeof(buf));
+      for (i = 0; (rc > 0) && (i < (uint32_t)rc); i++) {
+        if (TEST_DOWNLOAD_BYTE != buf[i]) {
+          bad++;
+        }
+      }
+      if (rc > 0) {
+        received += (uint64_t)rc;
+      }
+    } while (rc > 0);
+    if (!TEST_IS_WANT(rc)) {
+      printf(" download failed: %d", rc);
+      bPass = false;
+    }
+  }
+  test_disconnect();
+
+  bPass = bPass && (TEST_BYTES == received) && (0u == bad);
+#if TLS_TX_BUFFER_SIZE > 0
+  /* the PDUs given within one cycle are coalesced into fewer records */
+  bPass = bPass && (testStats.sends < (TEST_BYTES / TEST_DOWNLOAD_PDU_SIZE));
+#endif
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %llu bytes received, %u not as sent, %u transmits\n", (unsigned long long)received,
+           bad, testStats.sends);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+void *Net_MemAlloc(uint32_t size) {
+  return malloc(size);
+}
+
+void Net_MemFree(void *buffer) {
+  free(buffer);
+}
+
+Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType ret = E_NOT_OK;
+  ssize_t n;
+
+  if (testServerFd >= 0) {
+    n = send(testServerFd, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength, MSG_NOSIGNAL);
+    if (n == (ssize_t)PduInfoPtr->SduLength) {
+      testStats.sends++;
+      testStats.wire += (uint64_t)n;
+      ret = E_OK;
+    } else if (n > 0) {
+      printf("partial send %d of %u bytes\n", (int)n, (uint32_t)PduInfoPtr->SduLength);
+      exit(-1);
+    } else {
+      /* the socket buffer is full */
+    }
+  }
+
+  return ret;
+}
+
+Std_ReturnType SoAd_ControlRecv(SoAd_SoConIdType SoConId, uint8_t *data, uint32_t *length) {
+  Std_ReturnType ret = E_NOT_OK;
+  ssize_t n;
+  int avail = 0;
+
+  if (testServerFd >= 0) {
+    ret = E_OK;
+    if (NULL == data) {
+      (void)ioctl(testServerFd, FIONREAD, &avail);
+      *length = (uint32_t)avail;
+    } else {
+      testStats.recvs++;
+      n = recv(testServerFd, data, *length, 0);
+      if (n >= 0) {
+        *length = (uint32_t)n;
+      } else if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+        *length = 0;
+      } else {
+        ret = E_NOT_OK;
+      }
+    }
+  }
+
+  return ret;
+}
+
+Std_ReturnType SoAd_TakeControl(SoAd_SoConIdType SoConId) {
+  return E_OK;
+}
+
+Std_ReturnType SoAd_CloseSoCon(SoAd_SoConIdType SoConId, boolean abort) {
+  if (testServerFd >= 0) {
+    close(testServerFd);
+    testServerFd = -1;
+  }
+  testClosed = TRUE;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_GetRemoteAddr(SoAd_SoConIdType SoConId, TcpIp_SockAddrType *IpAddrPtr) {
+  memset(IpAddrPtr, 0, sizeof(TcpIp_SockAddrType));
+  return E_OK;
+}
+
+void Test_SoConModeChg(SoAd_SoConIdType SoConId, SoAd_SoConModeType Mode) {
+  testOnline = (SOAD_SOCON_ONLINE == Mode);
+}
+
+Std_ReturnType Test_HeaderIndication(PduIdType id, const PduInfoType *info,
+                                      uint32_t *payloadLength) {
+  return E_NOT_OK;
+}
+
+void Test_RxIndication(PduIdType id, const PduInfoType *info) {
+  PduLengthType i;
+
+  testStats.rxData += info->SduLength;
+  if (TRUE == testEcho) {
+    (void)TLS_IfTransmit(TLS_TX_PID_TEST_TCP, info);
+  } else {
+    for (i = 0; i < info->SduLength; i++) {
+      if (TEST_UPLOAD_BYTE != info->SduDataPtr[i]) {
+        testStats.rxBad++;
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  printf("TLS_TX_BUFFER_SIZE=%u TLS_NET_BUFFER_SIZE=%u TLS_RX_BUFFER_SIZE=%u "
+         "TLS_SESSION_CACHE_MAX_ENTRIES=%u TLS_SESSION_TICKET_LIFETIME=%u\n",
+         TLS_TX_BUFFER_SIZE, TLS_NET_BUFFER_SIZE, TLS_RX_BUFFER_SIZE,
+         TLS_SESSION_CACHE_MAX_ENTRIES, TLS_SESSION_TICKET_LIFETIME);
+  TLS_Init(NULL);
+  test_listen();
+  test_client_setup();
+  Test_Handshakes("full", FALSE);
+  Test_Handshakes("resumed", TRUE);
+  Test_Upload();
+  Test_Download();
+  return 0;
+}
@@ -5,6 +5,9 @@
  * ref: Specification of TCP/IP Stack AUTOSAR CP Release 4.4.0
  */
 /* ================================ [ INCLUDES  ] ============================================== */
+#if defined(linux) && !defined(USE_LWIP) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for sendmmsg */
+#endif
 #include <string.h>
 #include <stdlib.h>
 
@@ -47,6 +50,10 @@
 #define TCPIP_MAX_DATA_SIZE 1420
 #endif
 
+#ifndef TCPIP_SENDMMSG_MAX
+#define TCPIP_SENDMMSG_MAX 32
+#endif
+
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 extern const TcpIp_ConfigType TcpIp_Config;
@@ -620,6 +627,68 @@ Std_ReturnType TcpIp_SendTo(TcpIp_SocketIdType SocketId, const TcpIp_SockAddrTyp
   return ret;
 }
 
+Std_ReturnType TcpIp_SendToMulti(TcpIp_SocketIdType SocketId, const TcpIp_SockAddrType *RemoteAddrs,
+                                 uint16_t numOfRemoteAddrs, const uint8_t *BufPtr,
+                                 uint32_t Length) {
+  Std_ReturnType ret = E_OK;
+#if defined(linux) && !defined(USE_LWIP)
+  struct mmsghdr msgs[TCPIP_SENDMMSG_MAX];
+  struct sockaddr_in toAddrs[TCPIP_SENDMMSG_MAX];
+  struct iovec iov;
+  uint16_t offset = 0;
+  uint16_t num;
+  uint16_t i;
+  int nmsgs;
+
+  iov.iov_base = (void *)BufPtr;
+  iov.iov_len = Length;
+  while ((offset < numOfRemoteAddrs) && (E_OK == ret)) {
+    num = numOfRemoteAddrs - offset;
+    if (num > TCPIP_SENDMMSG_MAX) {
+      num = TCPIP_SENDMMSG_MAX;
+    }
+    memset(msgs, 0, sizeof(struct mmsghdr) * num);
+    for (i = 0; i < num; i++) {
+      toAddrs[i].sin_family = AF_INET;
+      memcpy(&toAddrs[i].sin_addr.s_addr, RemoteAddrs[offset + i].addr, 4);
+      toAddrs[i].sin_port = htons(RemoteAddrs[offset + i].port);
+      msgs[i].msg_hdr.msg_name = &toAddrs[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(toAddrs[i]);
+      msgs[i].msg_hdr.msg_iov = &iov;
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    nmsgs = sendmmsg(SocketId, msgs, num, 0);
+    ASLOG(TCPIP, ("[%d] sendmmsg %d/%d x %d bytes\n", SocketId, nmsgs, num, Length));
+    if (nmsgs < 0) {
+      ASLOG(TCPIPE, ("[%d] sendmmsg(%d x %d), error is %d\n", SocketId, num, Length, errno));
+      ret = E_NOT_OK;
+    } else if (nmsgs != num) {
+      ASLOG(TCPIPE, ("[%d] sendmmsg(%d x %d) sent %d\n", SocketId, num, Length, nmsgs));
+      ret = TCPIP_E_NOSPACE;
+    } else {
+      for (i = 0; (i < num) && (E_OK == ret); i++) {
+        if (msgs[i].msg_len != Length) {
+          ret = TCPIP_E_NOSPACE;
+        }
+      }
+      offset += num;
+    }
+  }
+#else
+  uint16_t i;
+  Std_ReturnType ret2;
+
+  for (i = 0; i < numOfRemoteAddrs; i++) {
+    ret2 = TcpIp_SendTo(SocketId, &RemoteAddrs[i], BufPtr, Length);
+    if (E_OK != ret2) {
+      ret = ret2;
+    }
+  }
+#endif
+
+  return ret;
+}
+
 Std_ReturnType TcpIp_Send(TcpIp_SocketIdType SocketId, const uint8_t *BufPtr, uint32_t Length) {
   Std_ReturnType ret = E_OK;
   int nbytes;
@@ -8,27 +8,158 @@
 #include "Csm.h"
 #include "Csm_Priv.h"
 #include "Det.h"
+#include "Std_Critical.h"
 
 #include <string.h>
+#ifdef CSM_USE_JOB_WORKER
+#include <pthread.h>
+#endif
 /* ================================ [ MACROS    ] ============================================== */
 #ifdef CSM_USE_PB_CONFIG
 #define CSM_CONFIG csmConfig
 #else
 #define CSM_CONFIG (&Csm_Config)
 #endif
+
+#define CSM_JOB_INDEX(x) ((x) & (CSM_JOB_QUEUE_SIZE - 1u))
+
+#ifdef CSM_USE_JOB_WORKER
+#define csmLock() (void)pthread_mutex_lock(&csmJobMutex)
+#define csmUnlock() (void)pthread_mutex_unlock(&csmJobMutex)
+#else
+#define csmLock() EnterCritical()
+#define csmUnlock() ExitCritical()
+#endif
 /* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  const uint8_t *dataPtr;
+  uint8_t *macPtr;          /* MAC output of a generate job */
+  const uint8_t *refMacPtr; /* reference MAC of a verify job */
+  uint32_t *macLengthPtr;
+  uint32_t dataLength;
+  uint32_t macLength;
+  Csm_JobNotificationType notification;
+  void *ctx;
+  uint16_t AlgoRef;
+  Crypto_ServiceInfoType serviceType;
+  Std_ReturnType result;
+} Csm_JobRequestType;
+
+/* The queue is a ring with 3 free running counters: [notify, exec) are the finished jobs waiting
+ * for the notification, [exec, put) are the jobs waiting to be processed. */
+typedef struct {
+  Csm_JobRequestType jobs[CSM_JOB_QUEUE_SIZE];
+  uint32_t put;
+  uint32_t exec;
+  uint32_t notify;
+} Csm_JobQueueType;
 /* ================================ [ DECLARES  ] ============================================== */
 extern const Csm_ConfigType Csm_Config;
 /* ================================ [ DATAS     ] ============================================== */
 #ifdef CSM_USE_PB_CONFIG
 static const Csm_ConfigType *csmConfig = NULL;
 #endif
+static Csm_JobQueueType csmJobQueue;
+#ifdef CSM_USE_JOB_WORKER
+static pthread_mutex_t csmJobMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t csmJobCond = PTHREAD_COND_INITIALIZER;
+static pthread_t csmJobWorker;
+static boolean csmJobWorkerStarted = FALSE;
+/* the jobs are processed by the worker, else by Csm_MainFunction */
+static boolean csmJobWorkerActive = FALSE;
+#endif
 /* ================================ [ LOCALS    ] ============================================== */
+/* without the single call primitive the streaming state of the shared context is used, so this is
+ * only called in the context of the synchronous services, never by the job worker */
+static Std_ReturnType Csm_MacSingleCall(const Csm_MacGenerateConfigType *mg, const uint8_t *data,
+                                        uint32_t len, uint8_t *mac, uint32_t *macLen) {
+  Std_ReturnType ret;
+  if (NULL != mg->Primitive->SingleCallFnc) {
+    ret = mg->Primitive->SingleCallFnc(mg->AlgorithmContext, data, len, mac, macLen);
+  } else {
+    ret = mg->Primitive->StartFnc(mg->AlgorithmContext);
+    if (E_OK == ret) {
+      ret = mg->Primitive->UpdateFnc(mg->AlgorithmContext, data, len);
+    }
+    if (E_OK == ret) {
+      ret = mg->Primitive->FinishFnc(mg->AlgorithmContext, mac, macLen);
+    }
+  }
+  return ret;
+}
+
+static void Csm_ProcessJob(Csm_JobRequestType *job) {
+  const Csm_MacGenerateConfigType *mg = &CSM_CONFIG->MacGenerateConfigs[job->AlgoRef];
+  uint8_t mac[CSM_MAC_MAX_LENGTH];
+  uint32_t macLen = sizeof(mac);
+
+  if (CRYPTO_MAC_GENERATE == job->serviceType) {
+    job->result = Csm_MacSingleCall(mg, job->dataPtr, job->dataLength, job->macPtr,
+                                    job->macLengthPtr);
+  } else {
+    job->result = Csm_MacSingleCall(mg, job->dataPtr, job->dataLength, mac, &macLen);
+    if ((E_OK == job->result) &&
+        ((job->macLength > macLen) || (0 != memcmp(mac, job->refMacPtr, job->macLength)))) {
+      job->result = E_NOT_OK;
+    }
+  }
+}
+
+/* process all the jobs queued so far as one batch, the lock is only held to grab the batch */
+static void Csm_ProcessJobs(void) {
+  uint32_t exec;
+  uint32_t put;
+
+  csmLock();
+  exec = csmJobQueue.exec;
+  put = csmJobQueue.put;
+  csmUnlock();
+
+  if (exec != put) {
+    for (; exec != put; exec++) {
+      Csm_ProcessJob(&csmJobQueue.jobs[CSM_JOB_INDEX(exec)]);
+    }
+    csmLock();
+    csmJobQueue.exec = put;
+    csmUnlock();
+  }
+}
+
+#ifdef CSM_USE_JOB_WORKER
+static void *Csm_JobWorker(void *args) {
+  (void)args;
+  while (TRUE) {
+    (void)pthread_mutex_lock(&csmJobMutex);
+    while (csmJobQueue.exec == csmJobQueue.put) {
+      (void)pthread_cond_wait(&csmJobCond, &csmJobMutex);
+    }
+    (void)pthread_mutex_unlock(&csmJobMutex);
+    Csm_ProcessJobs();
+  }
+  return NULL;
+}
+#endif
+
+static Std_ReturnType Csm_QueueJob(const Csm_JobRequestType *request) {
+  Std_ReturnType ret = E_OK;
+
+  csmLock();
+  if ((csmJobQueue.put - csmJobQueue.notify) < CSM_JOB_QUEUE_SIZE) {
+    csmJobQueue.jobs[CSM_JOB_INDEX(csmJobQueue.put)] = *request;
+    csmJobQueue.put++;
+  } else {
+    ret = E_BUSY;
+  }
+  csmUnlock();
+
+  return ret;
+}
 /* ================================ [ FUNCTIONS ] ============================================== */
 void Csm_Init(const Csm_ConfigType *configPtr) {
   uint16_t i;
   Std_ReturnType ret;
   const Csm_MacGenerateConfigType *mg;
+  boolean reentrant = TRUE;
 
 #ifdef CSM_USE_PB_CONFIG
   if (NULL != configPtr) {
@@ -46,7 +177,30 @@ void Csm_Init(const Csm_ConfigType *configPtr) {
     ret = mg->Primitive->InitFnc(mg->AlgorithmContext, mg->AlgorithmKey, mg->AlgorithmKeyLength);
     DET_VALIDATE(E_OK == ret, 0x00, CSM_E_INIT_FAILED, (void)ret);
     (void)ret;
+    if (NULL == mg->Primitive->SingleCallFnc) {
+      reentrant = FALSE;
+    }
+  }
+
+  csmLock();
+  csmJobQueue.put = 0;
+  csmJobQueue.exec = 0;
+  csmJobQueue.notify = 0;
+  csmUnlock();
+
+#ifdef CSM_USE_JOB_WORKER
+  /* the worker runs concurrently with the synchronous services on the same algorithm contexts,
+   * which is only safe if all the primitives provide the single call */
+  if ((TRUE == reentrant) && (FALSE == csmJobWorkerStarted)) {
+    if (0 == pthread_create(&csmJobWorker, NULL, Csm_JobWorker, NULL)) {
+      csmJobWorkerStarted = TRUE;
+    }
+    DET_VALIDATE(TRUE == csmJobWorkerStarted, 0x00, CSM_E_INIT_FAILED, (void)0);
   }
+  csmJobWorkerActive = reentrant && csmJobWorkerStarted;
+#else
+  (void)reentrant;
+#endif
 }
 
 Std_ReturnType Csm_MacGenerate(uint32_t jobId, Crypto_OperationModeType mode,
@@ -77,6 +231,9 @@ Std_ReturnType Csm_MacGenerate(uint32_t jobId, Crypto_OperationModeType mode,
   case CRYPTO_OPERATION_MODE_FINISH:
     ret = mg->Primitive->FinishFnc(mg->AlgorithmContext, macPtr, macLengthPtr);
     break;
+  case CRYPTO_OPERATION_MODE_SINGLE_CALL:
+    ret = Csm_MacSingleCall(mg, dataPtr, dataLength, macPtr, macLengthPtr);
+    break;
   default:
     DET_VALIDATE(FALSE, 0x60, CSM_E_PARAM_HANDLE, return E_NOT_OK);
     ret = E_NOT_OK;
@@ -98,7 +255,7 @@ Std_ReturnType Csm_MacVerify(uint32_t jobId, Crypto_OperationModeType mode, cons
   DET_VALIDATE((NULL != macPtr) && (macLength > 0), 0x61, CSM_E_PARAM_POINTER, return E_NOT_OK);
   DET_VALIDATE(jobId < CSM_CONFIG->numOfJobs, 0x61, CSM_E_PARAM_HANDLE, return E_NOT_OK);
   jobCfg = &CSM_CONFIG->JobConfigs[jobId];
-  DET_VALIDATE(CRYPTO_MAC_GENERATE == jobCfg->serviceType, 0x61, CSM_E_SERVICE_TYPE,
+  DET_VALIDATE(CRYPTO_MAC_VERIFY == jobCfg->serviceType, 0x61, CSM_E_SERVICE_TYPE,
                return E_NOT_OK);
   DET_VALIDATE(jobCfg->AlgoRef < CSM_CONFIG->numOfMacGen, 0x61, CSM_E_SERVICE_TYPE,
                return E_NOT_OK);
@@ -121,10 +278,123 @@ Std_ReturnType Csm_MacVerify(uint32_t jobId, Crypto_OperationModeType mode, cons
       }
     }
     break;
+  case CRYPTO_OPERATION_MODE_SINGLE_CALL:
+    ret = Csm_MacSingleCall(mg, dataPtr, dataLength, mg->MacBuf, &macLen);
+    if (E_OK == ret) {
+      if (0 != memcmp(mg->MacBuf, macPtr, macLen)) {
+        ret = E_NOT_OK;
+      }
+    }
+    break;
   default:
     DET_VALIDATE(FALSE, 0x61, CSM_E_PARAM_HANDLE, return E_NOT_OK);
     ret = E_NOT_OK;
     break;
   }
   return ret;
-}
\ No newline at end of file
+}
+
+Std_ReturnType Csm_MacGenerateAsync(uint32_t jobId, const uint8_t *dataPtr, uint32_t dataLength,
+                                    uint8_t *macPtr, uint32_t *macLengthPtr,
+                                    Csm_JobNotificationType notification, void *ctx) {
+  const Csm_JobConfigType *jobCfg;
+  Csm_JobRequestType request;
+
+  DET_VALIDATE(NULL != CSM_CONFIG, 0x60, CSM_E_UNINIT, return E_NOT_OK);
+  DET_VALIDATE((NULL != dataPtr) && (dataLength > 0), 0x60, CSM_E_PARAM_POINTER, return E_NOT_OK);
+  DET_VALIDATE((NULL != macPtr) && (NULL != macLengthPtr) && (*macLengthPtr > 0), 0x60,
+               CSM_E_PARAM_POINTER, return E_NOT_OK);
+  DET_VALIDATE(NULL != notification, 0x60, CSM_E_PARAM_POINTER, return E_NOT_OK);
+  DET_VALIDATE(jobId < CSM_CONFIG->numOfJobs, 0x60, CSM_E_PARAM_HANDLE, return E_NOT_OK);
+  jobCfg = &CSM_CONFIG->JobConfigs[jobId];
+  DET_VALIDATE(CRYPTO_MAC_GENERATE == jobCfg->serviceType, 0x60, CSM_E_SERVICE_TYPE,
+               return E_NOT_OK);
+  DET_VALIDATE(jobCfg->AlgoRef < CSM_CONFIG->numOfMacGen, 0x60, CSM_E_SERVICE_TYPE,
+               return E_NOT_OK);
+
+  request.dataPtr = dataPtr;
+  request.macPtr = macPtr;
+  request.refMacPtr = NULL;
+  request.macLengthPtr = macLengthPtr;
+  request.dataLength = dataLength;
+  request.macLength = *macLengthPtr;
+  request.notification = notification;
+  request.ctx = ctx;
+  request.AlgoRef = jobCfg->AlgoRef;
+  request.serviceType = CRYPTO_MAC_GENERATE;
+  request.result = E_NOT_OK;
+
+  return Csm_QueueJob(&request);
+}
+
+Std_ReturnType Csm_MacVerifyAsync(uint32_t jobId, const uint8_t *dataPtr, uint32_t dataLength,
+                                  const uint8_t *macPtr, uint32_t macLength,
+                                  Csm_JobNotificationType notification, void *ctx) {
+  const Csm_JobConfigType *jobCfg;
+  Csm_JobRequestType request;
+
+  DET_VALIDATE(NULL != CSM_CONFIG, 0x61, CSM_E_UNINIT, return E_NOT_OK);
+  DET_VALIDATE((NULL != dataPtr) && (dataLength > 0), 0x61, CSM_E_PARAM_POINTER, return E_NOT_OK);
+  DET_VALIDATE((NULL != macPtr) && (macLength > 0) && (macLength <= CSM_MAC_MAX_LENGTH), 0x61,
+               CSM_E_PARAM_POINTER, return E_NOT_OK);
+  DET_VALIDATE(NULL != notification, 0x61, CSM_E_PARAM_POINTER, return E_NOT_OK);
+  DET_VALIDATE(jobId < CSM_CONFIG->numOfJobs, 0x61, CSM_E_PARAM_HANDLE, return E_NOT_OK);
+  jobCfg = &CSM_CONFIG->JobConfigs[jobId];
+  DET_VALIDATE(CRYPTO_MAC_VERIFY == jobCfg->serviceType, 0x61, CSM_E_SERVICE_TYPE,
+               return E_NOT_OK);
+  DET_VALIDATE(jobCfg->AlgoRef < CSM_CONFIG->numOfMacGen, 0x61, CSM_E_SERVICE_TYPE,
+               return E_NOT_OK);
+
+  request.dataPtr = dataPtr;
+  request.macPtr = NULL;
+  request.refMacPtr = macPtr;
+  request.macLengthPtr = NULL;
+  request.dataLength = dataLength;
+  request.macLength = macLength;
+  request.notification = notification;
+  request.ctx = ctx;
+  request.AlgoRef = jobCfg->AlgoRef;
+  request.serviceType = CRYPTO_MAC_VERIFY;
+  request.result = E_NOT_OK;
+
+  return Csm_QueueJob(&request);
+}
+
+void Csm_MainFunction(void) {
+  uint32_t notify;
+  uint32_t exec;
+  Csm_JobRequestType *job;
+
+#ifdef CSM_USE_JOB_WORKER
+  if (FALSE == csmJobWorkerActive) {
+    Csm_ProcessJobs();
+  }
+#else
+  Csm_ProcessJobs();
+#endif
+
+  csmLock();
+  notify = csmJobQueue.notify;
+  exec = csmJobQueue.exec;
+  csmUnlock();
+
+  if (notify != exec) {
+    /* notify in the order of queuing, a notification may queue new jobs */
+    for (; notify != exec; notify++) {
+      job = &csmJobQueue.jobs[CSM_JOB_INDEX(notify)];
+      job->notification(job->ctx, job->result);
+    }
+    csmLock();
+    csmJobQueue.notify = exec;
+    csmUnlock();
+  }
+
+#ifdef CSM_USE_JOB_WORKER
+  /* wake up the worker once per cycle for all the jobs queued in this cycle */
+  csmLock();
+  if ((TRUE == csmJobWorkerActive) && (csmJobQueue.exec != csmJobQueue.put)) {
+    (void)pthread_cond_signal(&csmJobCond);
+  }
+  csmUnlock();
+#endif
+}
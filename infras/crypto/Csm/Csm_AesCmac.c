@@ -0,0 +1,302 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * ref: RFC 4493 The AES-CMAC Algorithm
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Csm.h"
+#include "Csm_Priv.h"
+#include "Det.h"
+#include <string.h>
+#ifdef CSM_USE_AES_CMAC
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <wmmintrin.h>
+#define CSM_USE_AESNI
+#define CSM_AESNI_TARGET __attribute__((target("aes,sse2")))
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#define CSM_USE_ARMV8_AES
+#endif
+/* ================================ [ MACROS    ] ============================================== */
+#define CSM_AES_BLOCK_SIZE 16u
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static const uint8_t Csm_AesSbox[256] = {
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+/* ================================ [ LOCALS    ] ============================================== */
+/* FIPS-197 key expansion, the round keys are kept in the byte order used by AES-NI and AESE */
+static void Csm_AesKeyExpansion(uint8_t rk[15][16], const uint8_t *key, uint32_t keyLen) {
+  uint8_t *w = &rk[0][0];
+  uint32_t Nk = keyLen / 4u;
+  uint32_t total = 4u * (Nk + 7u);
+  uint8_t rcon = 0x01u;
+  uint8_t t[4];
+  uint8_t tmp;
+  uint32_t i;
+
+  (void)memcpy(w, key, keyLen);
+  for (i = Nk; i < total; i++) {
+    (void)memcpy(t, &w[4u * (i - 1u)], 4u);
+    if (0u == (i % Nk)) {
+      tmp = t[0];
+      t[0] = Csm_AesSbox[t[1]] ^ rcon;
+      t[1] = Csm_AesSbox[t[2]];
+      t[2] = Csm_AesSbox[t[3]];
+      t[3] = Csm_AesSbox[tmp];
+      rcon = (uint8_t)((rcon << 1) ^ ((rcon & 0x80u) ? 0x1Bu : 0u));
+    } else if ((Nk > 6u) && (4u == (i % Nk))) {
+      t[0] = Csm_AesSbox[t[0]];
+      t[1] = Csm_AesSbox[t[1]];
+      t[2] = Csm_AesSbox[t[2]];
+      t[3] = Csm_AesSbox[t[3]];
+    }
+    w[4u * i + 0u] = w[4u * (i - Nk) + 0u] ^ t[0];
+    w[4u * i + 1u] = w[4u * (i - Nk) + 1u] ^ t[1];
+    w[4u * i + 2u] = w[4u * (i - Nk) + 2u] ^ t[2];
+    w[4u * i + 3u] = w[4u * (i - Nk) + 3u] ^ t[3];
+  }
+}
+
+#ifdef CSM_USE_AESNI
+static boolean Csm_AesHwAvailable(void) {
+  return (0 != __builtin_cpu_supports("aes")) ? TRUE : FALSE;
+}
+
+/* X = E(X ^ block) over nBlocks, the round keys and the chain value stay in registers */
+static CSM_AESNI_TARGET void Csm_AesHwCbcMac(const Csm_AesCmacContextType *ctx, uint8_t *X,
+                                             const uint8_t *data, uint32_t nBlocks) {
+  __m128i k[15];
+  __m128i x;
+  uint8_t nr = ctx->nr;
+  uint8_t r;
+
+  for (r = 0; r <= nr; r++) {
+    k[r] = _mm_loadu_si128((const __m128i *)ctx->rk[r]);
+  }
+  x = _mm_loadu_si128((const __m128i *)X);
+  while (nBlocks > 0u) {
+    x = _mm_xor_si128(x, _mm_loadu_si128((const __m128i *)data));
+    x = _mm_xor_si128(x, k[0]);
+    for (r = 1; r < nr; r++) {
+      x = _mm_aesenc_si128(x, k[r]);
+    }
+    x = _mm_aesenclast_si128(x, k[nr]);
+    data += CSM_AES_BLOCK_SIZE;
+    nBlocks--;
+  }
+  _mm_storeu_si128((__m128i *)X, x);
+}
+#elif defined(CSM_USE_ARMV8_AES)
+static boolean Csm_AesHwAvailable(void) {
+  return TRUE;
+}
+
+static void Csm_AesHwCbcMac(const Csm_AesCmacContextType *ctx, uint8_t *X, const uint8_t *data,
+                            uint32_t nBlocks) {
+  uint8x16_t k[15];
+  uint8x16_t x;
+  uint8_t nr = ctx->nr;
+  uint8_t r;
+
+  for (r = 0; r <= nr; r++) {
+    k[r] = vld1q_u8(ctx->rk[r]);
+  }
+  x = vld1q_u8(X);
+  while (nBlocks > 0u) {
+    x = veorq_u8(x, vld1q_u8(data));
+    /* AESE does AddRoundKey before SubBytes/ShiftRows, so the last key is xored at the end */
+    for (r = 0; r < (nr - 1u); r++) {
+      x = vaesmcq_u8(vaeseq_u8(x, k[r]));
+    }
+    x = veorq_u8(vaeseq_u8(x, k[nr - 1u]), k[nr]);
+    data += CSM_AES_BLOCK_SIZE;
+    nBlocks--;
+  }
+  vst1q_u8(X, x);
+}
+#endif
+
+static void Csm_AesCbcMac(const Csm_AesCmacContextType *ctx, uint8_t *X, const uint8_t *data,
+                          uint32_t nBlocks) {
+  uint32_t i;
+#if defined(CSM_USE_AESNI) || defined(CSM_USE_ARMV8_AES)
+  if (ctx->hw) {
+    Csm_AesHwCbcMac(ctx, X, data, nBlocks);
+    return;
+  }
+#endif
+  while (nBlocks > 0u) {
+    for (i = 0; i < CSM_AES_BLOCK_SIZE; i++) {
+      X[i] ^= data[i];
+    }
+    (void)mbedtls_aes_crypt_ecb((mbedtls_aes_context *)&ctx->aes, MBEDTLS_AES_ENCRYPT, X, X);
+    data += CSM_AES_BLOCK_SIZE;
+    nBlocks--;
+  }
+}
+
+static void Csm_AesCmacShift(uint8_t *out, const uint8_t *in) {
+  uint8_t carry = 0;
+  uint8_t msb = in[0] & 0x80u;
+  int i;
+  for (i = (int)CSM_AES_BLOCK_SIZE - 1; i >= 0; i--) {
+    out[i] = (uint8_t)((in[i] << 1) | carry);
+    carry = in[i] >> 7;
+  }
+  if (0u != msb) {
+    out[CSM_AES_BLOCK_SIZE - 1u] ^= 0x87u;
+  }
+}
+
+/* M holds the last 0..16 bytes of the message */
+static void Csm_AesCmacLast(const Csm_AesCmacContextType *ctx, uint8_t *X, const uint8_t *M,
+                            uint32_t mlen, uint8_t *mac) {
+  uint8_t last[CSM_AES_BLOCK_SIZE];
+  const uint8_t *K;
+  uint32_t i;
+
+  if (CSM_AES_BLOCK_SIZE == mlen) {
+    K = ctx->K1;
+    (void)memcpy(last, M, CSM_AES_BLOCK_SIZE);
+  } else {
+    K = ctx->K2;
+    (void)memcpy(last, M, mlen);
+    last[mlen] = 0x80u;
+    (void)memset(&last[mlen + 1u], 0, CSM_AES_BLOCK_SIZE - mlen - 1u);
+  }
+  for (i = 0; i < CSM_AES_BLOCK_SIZE; i++) {
+    last[i] ^= K[i];
+  }
+  Csm_AesCbcMac(ctx, X, last, 1u);
+  (void)memcpy(mac, X, CSM_AES_BLOCK_SIZE);
+}
+
+static Std_ReturnType Csm_AesCmacInit(void *AlgorithmContext, const uint8_t *AlgorithmKey,
+                                      uint32_t AlgorithmKeyLength) {
+  Std_ReturnType ret = E_OK;
+  Csm_AesCmacContextType *ctx = (Csm_AesCmacContextType *)AlgorithmContext;
+  uint8_t L[CSM_AES_BLOCK_SIZE];
+
+  if ((16u != AlgorithmKeyLength) && (24u != AlgorithmKeyLength) &&
+      (32u != AlgorithmKeyLength)) {
+    ret = E_NOT_OK;
+  } else {
+    mbedtls_aes_init(&ctx->aes);
+    if (0 != mbedtls_aes_setkey_enc(&ctx->aes, AlgorithmKey, AlgorithmKeyLength * 8u)) {
+      ret = E_NOT_OK;
+    }
+  }
+
+  if (E_OK == ret) {
+    ctx->nr = (uint8_t)(AlgorithmKeyLength / 4u + 6u);
+    Csm_AesKeyExpansion(ctx->rk, AlgorithmKey, AlgorithmKeyLength);
+#if defined(CSM_USE_AESNI) || defined(CSM_USE_ARMV8_AES)
+    ctx->hw = Csm_AesHwAvailable();
+#else
+    ctx->hw = FALSE;
+#endif
+    /* @RFC4493 2.3: L = AES(K, 0), K1 = L << 1 ^ Rb, K2 = K1 << 1 ^ Rb */
+    (void)memset(L, 0, sizeof(L));
+    (void)memset(ctx->X, 0, sizeof(ctx->X));
+    Csm_AesCbcMac(ctx, L, ctx->X, 1u);
+    Csm_AesCmacShift(ctx->K1, L);
+    Csm_AesCmacShift(ctx->K2, ctx->K1);
+    (void)memset(L, 0, sizeof(L));
+    ctx->mlen = 0;
+  }
+
+  return ret;
+}
+
+static Std_ReturnType Csm_AesCmacStart(void *AlgorithmContext) {
+  Csm_AesCmacContextType *ctx = (Csm_AesCmacContextType *)AlgorithmContext;
+  (void)memset(ctx->X, 0, sizeof(ctx->X));
+  ctx->mlen = 0;
+  return E_OK;
+}
+
+static Std_ReturnType Csm_AesCmacUpdate(void *AlgorithmContext, const uint8_t *data,
+                                        uint32_t len) {
+  Csm_AesCmacContextType *ctx = (Csm_AesCmacContextType *)AlgorithmContext;
+  uint32_t n;
+
+  /* the last block is always kept in M as it is only known to be the last one in Finish */
+  if ((ctx->mlen > 0u) && (len > 0u)) {
+    n = CSM_AES_BLOCK_SIZE - ctx->mlen;
+    n = (len < n) ? len : n;
+    (void)memcpy(&ctx->M[ctx->mlen], data, n);
+    ctx->mlen += (uint8_t)n;
+    data += n;
+    len -= n;
+    if ((CSM_AES_BLOCK_SIZE == ctx->mlen) && (len > 0u)) {
+      Csm_AesCbcMac(ctx, ctx->X, ctx->M, 1u);
+      ctx->mlen = 0;
+    }
+  }
+
+  if (len > 0u) {
+    n = (len - 1u) / CSM_AES_BLOCK_SIZE;
+    Csm_AesCbcMac(ctx, ctx->X, data, n);
+    data += n * CSM_AES_BLOCK_SIZE;
+    len -= n * CSM_AES_BLOCK_SIZE;
+    (void)memcpy(ctx->M, data, len);
+    ctx->mlen = (uint8_t)len;
+  }
+
+  return E_OK;
+}
+
+static Std_ReturnType Csm_AesCmacFinish(void *AlgorithmContext, uint8_t *mac, uint32_t *len) {
+  Csm_AesCmacContextType *ctx = (Csm_AesCmacContextType *)AlgorithmContext;
+  DET_VALIDATE(*len >= CSM_AES_BLOCK_SIZE, 0x60, CSM_E_PARAM_HANDLE, return E_NOT_OK);
+  Csm_AesCmacLast(ctx, ctx->X, ctx->M, ctx->mlen, mac);
+  *len = CSM_AES_BLOCK_SIZE;
+  return E_OK;
+}
+
+static void Csm_AesCmacDeinit(void *AlgorithmContext) {
+  Csm_AesCmacContextType *ctx = (Csm_AesCmacContextType *)AlgorithmContext;
+  mbedtls_aes_free(&ctx->aes);
+  (void)memset(ctx, 0, sizeof(Csm_AesCmacContextType));
+}
+
+static Std_ReturnType Csm_AesCmacSingleCall(const void *AlgorithmContext, const uint8_t *data,
+                                            uint32_t len, uint8_t *mac, uint32_t *macLen) {
+  const Csm_AesCmacContextType *ctx = (const Csm_AesCmacContextType *)AlgorithmContext;
+  uint8_t X[CSM_AES_BLOCK_SIZE];
+  uint32_t n = 0;
+
+  DET_VALIDATE(*macLen >= CSM_AES_BLOCK_SIZE, 0x60, CSM_E_PARAM_HANDLE, return E_NOT_OK);
+  (void)memset(X, 0, sizeof(X));
+  if (len > 0u) {
+    n = (len - 1u) / CSM_AES_BLOCK_SIZE;
+    Csm_AesCbcMac(ctx, X, data, n);
+  }
+  Csm_AesCmacLast(ctx, X, &data[n * CSM_AES_BLOCK_SIZE], len - n * CSM_AES_BLOCK_SIZE, mac);
+  *macLen = CSM_AES_BLOCK_SIZE;
+  return E_OK;
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+const Csm_MacGenPrimitiveType Csm_AesCmacPrimitive = {
+  Csm_AesCmacInit,   Csm_AesCmacStart,  Csm_AesCmacUpdate,
+  Csm_AesCmacFinish, Csm_AesCmacDeinit, Csm_AesCmacSingleCall,
+};
+#endif /* CSM_USE_AES_CMAC */
@@ -8,10 +8,20 @@
 #define CSM_PRIV_H
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "Crypto_GeneralTypes.h"
+#ifdef CSM_USE_AES_CMAC
+#include "mbedtls/aes.h"
+#endif
 /* ================================ [ MACROS    ] ============================================== */
 #ifndef DET_THIS_MODULE_ID
 #define DET_THIS_MODULE_ID MODULE_ID_CSM
 #endif
+
+/* number of outstanding asynchronous jobs, must be a power of 2 */
+#ifndef CSM_JOB_QUEUE_SIZE
+#define CSM_JOB_QUEUE_SIZE 64u
+#endif
+
+#define CSM_MAC_MAX_LENGTH 32u
 /* ================================ [ TYPES     ] ============================================== */
 typedef Std_ReturnType (*Csm_MacGenerateInitFncType)(void *AlgorithmContext,
                                                      const uint8_t *AlgorithmKey,
@@ -27,12 +37,19 @@ typedef Std_ReturnType (*Csm_MacGenerateFinishFncType)(void *AlgorithmContext, u
 
 typedef void (*Csm_MacGenerateDeinitFncType)(void *AlgorithmContext);
 
+/* single call MAC generation, it only reads the key material of the context and keeps the
+ * streaming state untouched, so it is safe to run it on the job worker thread */
+typedef Std_ReturnType (*Csm_MacGenerateSingleCallFncType)(const void *AlgorithmContext,
+                                                           const uint8_t *data, uint32_t len,
+                                                           uint8_t *mac, uint32_t *macLen);
+
 typedef struct {
   Csm_MacGenerateInitFncType InitFnc;
   Csm_MacGenerateStartFncType StartFnc;
   Csm_MacGenerateUpdateFncType UpdateFnc;
   Csm_MacGenerateFinishFncType FinishFnc;
   Csm_MacGenerateDeinitFncType DeinitFnc;
+  Csm_MacGenerateSingleCallFncType SingleCallFnc; /* optional */
 } Csm_MacGenPrimitiveType;
 
 typedef struct {
@@ -50,6 +67,21 @@ typedef struct {
   Crypto_ServiceInfoType serviceType;
 } Csm_JobConfigType;
 
+#ifdef CSM_USE_AES_CMAC
+/* AES-CMAC (RFC 4493) with the key schedule and the subkeys K1/K2 derived once in Init */
+typedef struct {
+  mbedtls_aes_context aes; /* software block cipher */
+  uint8_t rk[15][16];      /* expanded key for the AES-NI/ARMv8 AES block cipher */
+  uint8_t K1[16];
+  uint8_t K2[16];
+  uint8_t X[16]; /* streaming state: CBC-MAC chain value */
+  uint8_t M[16]; /* streaming state: the pending last block */
+  uint8_t nr;    /* number of rounds */
+  uint8_t mlen;
+  boolean hw;
+} Csm_AesCmacContextType;
+#endif
+
 struct Csm_Config_s {
   const Csm_JobConfigType *JobConfigs;
   const Csm_MacGenerateConfigType *MacGenerateConfigs;
@@ -57,6 +89,9 @@ struct Csm_Config_s {
   uint16_t numOfMacGen;
 };
 /* ================================ [ DECLARES  ] ============================================== */
+#ifdef CSM_USE_AES_CMAC
+extern const Csm_MacGenPrimitiveType Csm_AesCmacPrimitive;
+#endif
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
 /* ================================ [ FUNCTIONS ] ============================================== */
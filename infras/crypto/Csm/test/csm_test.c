@@ -0,0 +1,266 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Asynchronous MAC jobs processed while the synchronous MAC services are used on the same jobs,
+ * with the native AES-CMAC and with the same primitive without its single call, whose streaming
+ * state must then only be used by the task of the synchronous services and never by the job
+ * worker. Every MAC is compared with the one of a private context.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Csm.h"
+#include "Csm_Priv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define TEST_JOB_GENERATE 0u
+#define TEST_JOB_VERIFY 1u
+
+#define TEST_MAC_LENGTH 16u
+#define TEST_MAX_DATA 64u
+
+/* asynchronous jobs queued per round, both generate and verify */
+#define TEST_JOBS 16u
+
+#ifndef TEST_ROUNDS
+#define TEST_ROUNDS 500u
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint8_t data[TEST_MAX_DATA];
+  uint8_t mac[TEST_MAC_LENGTH];
+  uint8_t ref[TEST_MAC_LENGTH];
+  uint32_t length;
+  uint32_t macLength;
+  Std_ReturnType result;
+  bool notified;
+} test_job_t;
+/* ================================ [ DECLARES  ] ============================================== */
+static Std_ReturnType test_init(void *AlgorithmContext, const uint8_t *AlgorithmKey,
+                                uint32_t AlgorithmKeyLength);
+static Std_ReturnType test_start(void *AlgorithmContext);
+static Std_ReturnType test_update(void *AlgorithmContext, const uint8_t *data, uint32_t len);
+static Std_ReturnType test_finish(void *AlgorithmContext, uint8_t *mac, uint32_t *len);
+static void test_deinit(void *AlgorithmContext);
+/* ================================ [ DATAS     ] ============================================== */
+static const uint8_t testKey[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+static Csm_AesCmacContextType testContext;
+static Csm_AesCmacContextType refContext;
+static uint8_t testMacBuf[TEST_MAC_LENGTH];
+static pthread_t testMainThread;
+static bool testForeignThread;
+
+static const Csm_JobConfigType testJobConfigs[] = {
+  {0, CRYPTO_MAC_GENERATE},
+  {0, CRYPTO_MAC_VERIFY},
+};
+
+static const Csm_MacGenerateConfigType testNativeMacConfigs[] = {
+  {&testContext, testKey, &Csm_AesCmacPrimitive, testMacBuf, sizeof(testKey), CRYPTO_ALGOFAM_AES,
+   CRYPTO_ALGOMODE_CMAC},
+};
+
+/* the native AES-CMAC without the single call, so only the streaming state is used */
+static const Csm_MacGenPrimitiveType testStreamingPrimitive = {
+  test_init, test_start, test_update, test_finish, test_deinit, NULL,
+};
+
+static const Csm_MacGenerateConfigType testStreamingMacConfigs[] = {
+  {&testContext, testKey, &testStreamingPrimitive, testMacBuf, sizeof(testKey),
+   CRYPTO_ALGOFAM_AES, CRYPTO_ALGOMODE_CMAC},
+};
+
+const Csm_ConfigType Csm_Config = {
+  testJobConfigs,
+  testNativeMacConfigs,
+  ARRAY_SIZE(testJobConfigs),
+  ARRAY_SIZE(testNativeMacConfigs),
+};
+
+static const Csm_ConfigType testStreamingConfig = {
+  testJobConfigs,
+  testStreamingMacConfigs,
+  ARRAY_SIZE(testJobConfigs),
+  ARRAY_SIZE(testStreamingMacConfigs),
+};
+
+static test_job_t testGenJobs[TEST_JOBS];
+static test_job_t testVerJobs[TEST_JOBS];
+static test_job_t testSyncJob;
+/* ================================ [ LOCALS    ] ============================================== */
+static void test_check_thread(void) {
+  if (0 == pthread_equal(testMainThread, pthread_self())) {
+    testForeignThread = true;
+  }
+}
+
+static Std_ReturnType test_init(void *AlgorithmContext, const uint8_t *AlgorithmKey,
+                                uint32_t AlgorithmKeyLength) {
+  return Csm_AesCmacPrimitive.InitFnc(AlgorithmContext, AlgorithmKey, AlgorithmKeyLength);
+}
+
+static Std_ReturnType test_start(void *AlgorithmContext) {
+  test_check_thread();
+  return Csm_AesCmacPrimitive.StartFnc(AlgorithmContext);
+}
+
+static Std_ReturnType test_update(void *AlgorithmContext, const uint8_t *data, uint32_t len) {
+  test_check_thread();
+  return Csm_AesCmacPrimitive.UpdateFnc(AlgorithmContext, data, len);
+}
+
+static Std_ReturnType test_finish(void *AlgorithmContext, uint8_t *mac, uint32_t *len) {
+  test_check_thread();
+  return Csm_AesCmacPrimitive.FinishFnc(AlgorithmContext, mac, len);
+}
+
+static void test_deinit(void *AlgorithmContext) {
+  Csm_AesCmacPrimitive.DeinitFnc(AlgorithmContext);
+}
+
+static void test_prepare(test_job_t *job) {
+  uint32_t i;
+  uint32_t macLen = TEST_MAC_LENGTH;
+
+  job->length = 1u + ((uint32_t)rand() % TEST_MAX_DATA);
+  for (i = 0; i < job->length; i++) {
+    job->data[i] = (uint8_t)rand();
+  }
+  (void)Csm_AesCmacPrimitive.SingleCallFnc(&refContext, job->data, job->length, job->ref,
+                                           &macLen);
+  memset(job->mac, 0, sizeof(job->mac));
+  job->macLength = TEST_MAC_LENGTH;
+  job->result = E_NOT_OK;
+  job->notified = false;
+}
+
+static void test_notification(void *ctx, Std_ReturnType result) {
+  test_job_t *job = (test_job_t *)ctx;
+
+  job->result = result;
+  job->notified = true;
+}
+
+/* the synchronous services on the same jobs, single call and streaming */
+static bool test_sync(void) {
+  Crypto_VerifyResultType verify;
+  uint32_t half;
+  bool bPass = true;
+
+  test_prepare(&testSyncJob);
+  if ((E_OK != Csm_MacGenerate(TEST_JOB_GENERATE, CRYPTO_OPERATION_MODE_SINGLE_CALL,
+                               testSyncJob.data, testSyncJob.length, testSyncJob.mac,
+                               &testSyncJob.macLength)) ||
+      (0 != memcmp(testSyncJob.mac, testSyncJob.ref, TEST_MAC_LENGTH))) {
+    bPass = false;
+  }
+
+  half = testSyncJob.length / 2u;
+  memset(testSyncJob.mac, 0, sizeof(testSyncJob.mac));
+  (void)Csm_MacGenerate(TEST_JOB_GENERATE, CRYPTO_OPERATION_MODE_START, testSyncJob.data,
+                        testSyncJob.length, testSyncJob.mac, &testSyncJob.macLength);
+  if (half > 0u) {
+    (void)Csm_MacGenerate(TEST_JOB_GENERATE, CRYPTO_OPERATION_MODE_UPDATE, testSyncJob.data, half,
+                          testSyncJob.mac, &testSyncJob.macLength);
+  }
+  (void)Csm_MacGenerate(TEST_JOB_GENERATE, CRYPTO_OPERATION_MODE_UPDATE, &testSyncJob.data[half],
+                        testSyncJob.length - half, testSyncJob.mac, &testSyncJob.macLength);
+  (void)Csm_MacGenerate(TEST_JOB_GENERATE, CRYPTO_OPERATION_MODE_FINISH, testSyncJob.data,
+                        testSyncJob.length, testSyncJob.mac, &testSyncJob.macLength);
+  if (0 != memcmp(testSyncJob.mac, testSyncJob.ref, TEST_MAC_LENGTH)) {
+    bPass = false;
+  }
+
+  if (E_OK != Csm_MacVerify(TEST_JOB_VERIFY, CRYPTO_OPERATION_MODE_SINGLE_CALL, testSyncJob.data,
+                            testSyncJob.length, testSyncJob.ref, TEST_MAC_LENGTH, &verify)) {
+    bPass = false;
+  }
+
+  return bPass;
+}
+
+static void Test_AsyncWithSync(const char *name, const Csm_ConfigType *config) {
+  uint32_t round, i, notified;
+  uint32_t numSync = 0;
+  bool bPass = true;
+
+  printf("Test async and sync MAC with %s:", name);
+  testForeignThread = false;
+  Csm_Init(config);
+  for (round = 0; (round < TEST_ROUNDS) && bPass; round++) {
+    for (i = 0; (i < TEST_JOBS) && bPass; i++) {
+      test_prepare(&testGenJobs[i]);
+      test_prepare(&testVerJobs[i]);
+      testVerJobs[i].ref[TEST_MAC_LENGTH - 1u] ^= (uint8_t)(i & 0x01u); /* odd ones mismatch */
+      bPass = (E_OK == Csm_MacGenerateAsync(TEST_JOB_GENERATE, testGenJobs[i].data,
+                                            testGenJobs[i].length, testGenJobs[i].mac,
+                                            &testGenJobs[i].macLength, test_notification,
+                                            &testGenJobs[i])) &&
+              (E_OK == Csm_MacVerifyAsync(TEST_JOB_VERIFY, testVerJobs[i].data,
+                                          testVerJobs[i].length, testVerJobs[i].ref,
+                                          TEST_MAC_LENGTH, test_notification, &testVerJobs[i]));
+    }
+    do {
+      bPass = bPass && test_sync();
+      numSync++;
+      Csm_MainFunction();
+      notified = 0;
+      for (i = 0; i < TEST_JOBS; i++) {
+        notified += (testGenJobs[i].notified ? 1u : 0u) + (testVerJobs[i].notified ? 1u : 0u);
+      }
+    } while (bPass && (notified < (2u * TEST_JOBS)));
+    for (i = 0; (i < TEST_JOBS) && bPass; i++) {
+      if ((E_OK != testGenJobs[i].result) ||
+          (0 != memcmp(testGenJobs[i].mac, testGenJobs[i].ref, TEST_MAC_LENGTH))) {
+        bPass = false;
+      }
+      if (((0u == (i & 0x01u)) ? E_OK : E_NOT_OK) != testVerJobs[i].result) {
+        bPass = false;
+      }
+    }
+  }
+
+  bPass = bPass && (false == testForeignThread);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  round %u, %u synchronous MACs, streaming state used by another thread: %s\n", round,
+           numSync, testForeignThread ? "yes" : "no");
+    exit(-1);
+  }
+}
+
+static void Test_Rfc4493(void) {
+  /* RFC 4493 example 2 */
+  static const uint8_t M[16] = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+                                0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a};
+  static const uint8_t T[16] = {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+                                0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c};
+  uint8_t mac[TEST_MAC_LENGTH];
+  uint32_t macLen = sizeof(mac);
+  bool bPass;
+
+  printf("Test AES-CMAC RFC 4493 example 2:");
+  bPass = (E_OK == Csm_AesCmacPrimitive.SingleCallFnc(&refContext, M, sizeof(M), mac, &macLen)) &&
+          (0 == memcmp(mac, T, sizeof(T)));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  srand(1);
+  testMainThread = pthread_self();
+  (void)Csm_AesCmacPrimitive.InitFnc(&refContext, testKey, sizeof(testKey));
+
+  Test_Rfc4493();
+  Test_AsyncWithSync("single call primitive", &Csm_Config);
+  Test_AsyncWithSync("streaming primitive", &testStreamingConfig);
+
+  return 0;
+}
@@ -19,51 +19,18 @@
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
-static Dcm_ContextType Dcm_Context;
+static Dcm_ServerContextType Dcm_ServerContext;
 extern CONSTANT(Dcm_ConfigType, DCM_CONST) Dcm_Config;
 /* ================================ [ LOCALS    ] ============================================== */
-/* ================================ [ FUNCTIONS ] ============================================== */
-Dcm_ContextType *Dcm_GetContext(void) {
-  return (&Dcm_Context);
-}
-
-P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) Dcm_GetConfig(void) {
-  return (&Dcm_Config);
+static P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) Dcm_GetChannelConnection(PduIdType id) {
+  return &Dcm_Config.connections[Dcm_Config.channles[id].connection];
 }
 
-void Dcm_Init(P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) ConfigPtr) {
-  Dcm_ContextType *context = Dcm_GetContext();
-  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
-
-  (void)ConfigPtr;
-
-  (void)memset(context, 0, sizeof(Dcm_ContextType));
-  context->rxBufferState = DCM_BUFFER_IDLE;
-  context->txBufferState = DCM_BUFFER_IDLE;
-  context->curPduId = DCM_INVALID_PDU_ID;
-  Dcm_DslInit();
-  Dcm_DspInit();
-#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
-  if (Dcm_NvmSecurityAccess_Ram.AttemptCounter >= config->SecurityNumAttDelay) {
-    context->securityDelayTimer = config->SecurityDelayTime;
-    ASLOG(DCME, ("Security Delay Timer: %d\n", config->SecurityDelayTime));
-  }
-#endif
-}
-
-void Dcm_MainFunction(void) {
-  Dcm_MainFunction_Request();
-  Dcm_DslMainFunction();
-  Dcm_MainFunction_Response();
-#ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
-  Dcm_MainFunction_ReadPeriodicDID();
-#endif
-}
-
-void Dcm_MainFunction_Response(void) {
+static void Dcm_MainFunction_ConnectionResponse(P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST)
+                                                  connection) {
   Std_ReturnType r;
   PduInfoType PduInfo;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ContextType *context = connection->context;
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
 
   if (DCM_RESPONSE_PENDING == context->responsePending) {
@@ -83,15 +50,16 @@ void Dcm_MainFunction_Response(void) {
   } else if (DCM_BUFFER_FULL == context->txBufferState) {
     if (context->curPduId < config->numOfChls) {
       PduInfo.MetaDataPtr = NULL;
-      PduInfo.SduDataPtr = config->txBuffer;
+      PduInfo.SduDataPtr = connection->txBuffer;
       PduInfo.SduLength = context->TxTpSduLength;
       context->txBufferState = DCM_BUFFER_PROVIDED;
       context->TxIndex = 0;
-      ASLOG(DCM, ("Tx %02X %02X %02X ...\n", config->txBuffer[0], config->txBuffer[1],
-                  config->txBuffer[2]));
+      ASLOG(DCM, ("Tx %02X %02X %02X ...\n", connection->txBuffer[0], connection->txBuffer[1],
+                  connection->txBuffer[2]));
       r = PduR_DcmTransmit(config->channles[context->curPduId].TxPduId, &PduInfo);
       if (E_OK != r) {
-        /* This Dcm will ensure only 1 tx request, so if Transmit failed, it was a fatal error! */
+        /* This Dcm will ensure only 1 tx request per connection, so if Transmit failed, it was a
+         * fatal error! */
         context->txBufferState = DCM_BUFFER_IDLE;
         ASLOG(DCME, ("Tx Failed!\n"));
       }
@@ -103,6 +71,71 @@ void Dcm_MainFunction_Response(void) {
     /* do nothing */
   }
 }
+/* ================================ [ FUNCTIONS ] ============================================== */
+Dcm_ContextType *Dcm_GetContext(void) {
+  return Dcm_Config.connections[Dcm_ServerContext.active].context;
+}
+
+Dcm_ServerContextType *Dcm_GetServerContext(void) {
+  return (&Dcm_ServerContext);
+}
+
+P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) Dcm_GetConnection(void) {
+  return &Dcm_Config.connections[Dcm_ServerContext.active];
+}
+
+P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) Dcm_GetConfig(void) {
+  return (&Dcm_Config);
+}
+
+void Dcm_Init(P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) ConfigPtr) {
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  uint8_t i;
+
+  (void)ConfigPtr;
+
+  (void)memset(server, 0, sizeof(Dcm_ServerContextType));
+  for (i = 0u; i < config->numOfConnections; i++) {
+    Dcm_DslInitConnection(config->connections[i].context);
+  }
+  Dcm_DslInit();
+  Dcm_DspInit();
+#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
+  if (Dcm_NvmSecurityAccess_Ram.AttemptCounter >= config->SecurityNumAttDelay) {
+    server->securityDelayTimer = config->SecurityDelayTime;
+    ASLOG(DCME, ("Security Delay Timer: %d\n", config->SecurityDelayTime));
+  }
+#endif
+}
+
+void Dcm_MainFunction(void) {
+#ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+#endif
+
+  Dcm_MainFunction_Request();
+  Dcm_DslMainFunction();
+  Dcm_MainFunction_Response();
+#ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
+  /* the periodic DIDs run in a non default session, respond on the connection which owns it */
+  if (DCM_INVALID_CONNECTION != server->owner) {
+    server->active = server->owner;
+  } else {
+    server->active = 0u;
+  }
+  Dcm_MainFunction_ReadPeriodicDID();
+#endif
+}
+
+void Dcm_MainFunction_Response(void) {
+  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  uint8_t i;
+
+  for (i = 0u; i < config->numOfConnections; i++) {
+    Dcm_MainFunction_ConnectionResponse(&config->connections[i]);
+  }
+}
 
 Std_ReturnType Dcm_GetRxPduId(PduIdType *PduId) {
   Std_ReturnType ret = E_OK;
@@ -118,35 +151,37 @@ Std_ReturnType Dcm_GetRxPduId(PduIdType *PduId) {
 BufReq_ReturnType Dcm_StartOfReception(PduIdType id, const PduInfoType *info,
                                        PduLengthType TpSduLength, PduLengthType *bufferSizePtr) {
   BufReq_ReturnType ret = BUFREQ_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
-  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection;
+  Dcm_ContextType *context;
 
-  DET_VALIDATE(id < config->numOfChls, 0x46, DCM_E_PARAM, return BUFREQ_E_NOT_OK);
+  DET_VALIDATE(id < Dcm_GetConfig()->numOfChls, 0x46, DCM_E_PARAM, return BUFREQ_E_NOT_OK);
   DET_VALIDATE((NULL != info) && (NULL != info->SduDataPtr), 0x46, DCM_E_PARAM_POINTER,
                return BUFREQ_E_NOT_OK);
   DET_VALIDATE(NULL != bufferSizePtr, 0x46, DCM_E_PARAM_POINTER, return BUFREQ_E_NOT_OK);
 
+  connection = Dcm_GetChannelConnection(id);
+  context = connection->context;
   if ((2u == TpSduLength) && (0x3Eu == info->SduDataPtr[0]) && (0x80u == info->SduDataPtr[1])) {
     /* @SWS_Dcm_00557, @SWS_Dcm_01145
      * Only support 3E request without positive response */
-    if (context->currentSession != DCM_DEFAULT_SESSION) {
-      context->timerS3Server = config->timing->S3Server;
+    if (Dcm_GetServerContext()->currentSession != DCM_DEFAULT_SESSION) {
+      Dcm_DslRestartS3Server(context);
     }
     ret = BUFREQ_E_BUSY;
   } else if ((DCM_BUFFER_IDLE != context->txBufferState) && (id != context->curPduId)) {
-    /* As this Dcm share the same context & buffers across all the Dcm protocal channels, thus
-     * if there is a responsing on going, can't accept the new incoming request from the other
-     * channel. */
+    /* As the channels of a connection share the same context & buffers, thus if there is a
+     * responsing on going, can't accept the new incoming request from the other channel of this
+     * connection. */
     ret = BUFREQ_E_BUSY;
   } else if (DCM_BUFFER_IDLE == context->rxBufferState) {
-    if (TpSduLength > config->rxBufferSize) {
+    if (TpSduLength > connection->rxBufferSize) {
       /* @SWS_Dcm_00444 */
       ret = BUFREQ_E_OVFL;
     } else if (0u == TpSduLength) {
       /* @SWS_Dcm_00642 */
       ret = BUFREQ_E_NOT_OK;
     } else {
-      *bufferSizePtr = config->rxBufferSize;
+      *bufferSizePtr = connection->rxBufferSize;
       context->curPduId = id;
       context->RxIndex = 0u;
       context->RxTpSduLength = TpSduLength;
@@ -162,22 +197,24 @@ BufReq_ReturnType Dcm_StartOfReception(PduIdType id, const PduInfoType *info,
 BufReq_ReturnType Dcm_CopyRxData(PduIdType id, const PduInfoType *info,
                                  PduLengthType *bufferSizePtr) {
   BufReq_ReturnType ret = BUFREQ_E_NOT_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
-  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection;
+  Dcm_ContextType *context;
 
-  DET_VALIDATE(id < config->numOfChls, 0x44, DCM_E_PARAM, return BUFREQ_E_NOT_OK);
+  DET_VALIDATE(id < Dcm_GetConfig()->numOfChls, 0x44, DCM_E_PARAM, return BUFREQ_E_NOT_OK);
   DET_VALIDATE((NULL != info) && (NULL != info->SduDataPtr), 0x44, DCM_E_PARAM_POINTER,
                return BUFREQ_E_NOT_OK);
   DET_VALIDATE(NULL != bufferSizePtr, 0x44, DCM_E_PARAM_POINTER, return BUFREQ_E_NOT_OK);
 
+  connection = Dcm_GetChannelConnection(id);
+  context = connection->context;
   if (DCM_BUFFER_PROVIDED == context->rxBufferState) {
     if (context->curPduId == id) {
       if (0u == info->SduLength) {
         /* @SWS_Dcm_00996 */
         ret = BUFREQ_OK;
       } else if (((context->RxIndex + info->SduLength) <= context->RxTpSduLength) &&
-                 (context->RxTpSduLength <= config->rxBufferSize)) {
-        (void)memcpy(&config->rxBuffer[context->RxIndex], info->SduDataPtr, info->SduLength);
+                 (context->RxTpSduLength <= connection->rxBufferSize)) {
+        (void)memcpy(&connection->rxBuffer[context->RxIndex], info->SduDataPtr, info->SduLength);
         context->RxIndex += info->SduLength;
         ret = BUFREQ_OK;
       } else {
@@ -198,11 +235,14 @@ BufReq_ReturnType Dcm_CopyRxData(PduIdType id, const PduInfoType *info,
 }
 
 void Dcm_TpRxIndication(PduIdType id, Std_ReturnType result) {
-  Dcm_ContextType *context = Dcm_GetContext();
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection;
+  Dcm_ContextType *context;
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
 
   DET_VALIDATE(id < config->numOfChls, 0x45, DCM_E_PARAM, return);
 
+  connection = Dcm_GetChannelConnection(id);
+  context = connection->context;
   if ((E_OK == result) && (DCM_BUFFER_PROVIDED == context->rxBufferState) &&
       (context->curPduId == id)) {
     if (context->RxIndex == context->RxTpSduLength) {
@@ -210,15 +250,15 @@ void Dcm_TpRxIndication(PduIdType id, Std_ReturnType result) {
       context->msgContext.msgAddInfo.suppressPosResponse = DCM_NOT_SUPRESS_POSITIVE_RESPONCE;
       context->msgContext.dcmRxPduId = id;
       /* context->msgContext.idContext = 0; */
-      context->msgContext.reqData = &config->rxBuffer[1];
+      context->msgContext.reqData = &connection->rxBuffer[1];
       context->msgContext.reqDataLen = context->RxTpSduLength - 1u;
-      context->msgContext.resData = &config->txBuffer[1];
+      context->msgContext.resData = &connection->txBuffer[1];
       context->msgContext.resDataLen = 0;
-      context->msgContext.resMaxDataLen = config->txBufferSize - 1u;
+      context->msgContext.resMaxDataLen = connection->txBufferSize - 1u;
       context->opStatus = DCM_INITIAL;
       context->rxBufferState = DCM_BUFFER_FULL;
-      ASLOG(DCM, ("Rx %02X %02X %02X ...\n", config->rxBuffer[0], config->rxBuffer[1],
-                  config->rxBuffer[2]));
+      ASLOG(DCM, ("Rx %02X %02X %02X ...\n", connection->rxBuffer[0], connection->rxBuffer[1],
+                  connection->rxBuffer[2]));
     } else {
       ASLOG(DCME, ("Fatal Error when do RxInd, reset to Idle\n"));
     }
@@ -231,15 +271,17 @@ void Dcm_TpRxIndication(PduIdType id, Std_ReturnType result) {
 BufReq_ReturnType Dcm_CopyTxData(PduIdType id, const PduInfoType *info, const RetryInfoType *retry,
                                  PduLengthType *availableDataPtr) {
   BufReq_ReturnType ret = BUFREQ_E_NOT_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
-  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection;
+  Dcm_ContextType *context;
   (void)retry;
 
-  DET_VALIDATE(id < config->numOfChls, 0x43, DCM_E_PARAM, return BUFREQ_E_NOT_OK);
+  DET_VALIDATE(id < Dcm_GetConfig()->numOfChls, 0x43, DCM_E_PARAM, return BUFREQ_E_NOT_OK);
   DET_VALIDATE((NULL != info) && (NULL != info->SduDataPtr), 0x43, DCM_E_PARAM_POINTER,
                return BUFREQ_E_NOT_OK);
   DET_VALIDATE(NULL != availableDataPtr, 0x43, DCM_E_PARAM_POINTER, return BUFREQ_E_NOT_OK);
 
+  connection = Dcm_GetChannelConnection(id);
+  context = connection->context;
   if (DCM_RESPONSE_PENDING_PROVIDED == context->responsePending) {
     if (info->SduLength >= 3u) {
       info->SduDataPtr[0] = SID_NEGATIVE_RESPONSE;
@@ -255,8 +297,8 @@ BufReq_ReturnType Dcm_CopyTxData(PduIdType id, const PduInfoType *info, const Re
   } else if (DCM_BUFFER_PROVIDED == context->txBufferState) {
     if (context->curPduId == id) {
       if (((context->TxIndex + info->SduLength) <= context->TxTpSduLength) &&
-          (context->TxTpSduLength <= config->txBufferSize)) {
-        (void)memcpy(info->SduDataPtr, &config->txBuffer[context->TxIndex], info->SduLength);
+          (context->TxTpSduLength <= connection->txBufferSize)) {
+        (void)memcpy(info->SduDataPtr, &connection->txBuffer[context->TxIndex], info->SduLength);
         context->TxIndex += info->SduLength;
         *availableDataPtr = context->TxTpSduLength - context->TxIndex;
         ret = BUFREQ_OK;
@@ -274,10 +316,11 @@ BufReq_ReturnType Dcm_CopyTxData(PduIdType id, const PduInfoType *info, const Re
 }
 
 void Dcm_TpTxConfirmation(PduIdType id, Std_ReturnType result) {
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ContextType *context;
 
   DET_VALIDATE(id < Dcm_GetConfig()->numOfChls, 0x48, DCM_E_PARAM, return);
 
+  context = Dcm_GetChannelConnection(id)->context;
   if (DCM_RESPONSE_PENDING_TXING == context->responsePending) {
     context->responsePending = DCM_NO_RESPONSE_PENDING;
   } else {
@@ -295,6 +338,16 @@ void Dcm_TpTxConfirmation(PduIdType id, Std_ReturnType result) {
   }
 }
 
+void Dcm_TxConfirmation(PduIdType TxPduId, Std_ReturnType result) {
+#ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
+  /* only the periodic DIDs are sent by the IF layer */
+  Dcm_ReadPeriodicDID_TxConfirmation(TxPduId, result);
+#else
+  (void)TxPduId;
+  (void)result;
+#endif
+}
+
 void Dcm_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   DET_VALIDATE(NULL != versionInfo, 0x24, DCM_E_PARAM_POINTER, return);
 
@@ -302,7 +355,7 @@ void Dcm_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   versionInfo->moduleID = MODULE_ID_DCM;
   versionInfo->sw_major_version = 4;
   versionInfo->sw_minor_version = 0;
-  versionInfo->sw_patch_version = 7;
+  versionInfo->sw_patch_version = 10;
 }
 /** @brief release notes
  * - 4.0.1: Typo Fix: responcePending -> responsePending
@@ -313,4 +366,10 @@ void Dcm_GetVersionInfo(Std_VersionInfoType *versionInfo) {
  * - 4.0.5: OPT: Ensure the same length format response for request download/upload.
  * - 4.0.6: Add read DID with Dynamic length support.
  * - 4.0.7: Add routine control state tracking with automatic stop when session change.
+ * - 4.0.8: Read periodic DID scheduler with rate slots, a transmit queue and optional single
+ *    frame transmission per DID on a dedicated PDU.
+ * - 4.0.9: Parallel connections with own context, buffers and P2 timer, the session and security
+ *    state is owned by one connection and preempted by a higher priority connection.
+ * - 4.0.10: Fixed: the periodic DID single frames are sent through the IF layer, not the TP
+ *    layer, and are counted as sent on their TxConfirmation.
  */
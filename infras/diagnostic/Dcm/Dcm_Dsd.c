@@ -40,7 +40,8 @@ static void Dsd_HandleRequest(Dcm_ContextType *context,
   P2CONST(Dcm_ServiceTableType, AUTOMATIC, DCM_CONST)
   servieTable = Dcm_GetActiveServiceTable(context, config);
   P2CONST(Dcm_ServiceType, AUTOMATIC, DCM_CONST) service;
-  uint8_t SID = config->rxBuffer[0];
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection = Dcm_GetConnection();
+  uint8_t SID = connection->rxBuffer[0];
   /* atomic on this to prevent ISR tx confirm that changed this 'responsePending' state */
   uint8_t responsePending = context->responsePending;
 
@@ -49,10 +50,10 @@ static void Dsd_HandleRequest(Dcm_ContextType *context,
                  context->msgContext.msgAddInfo.reqType ? "funtional" : "physical", SID,
                  context->RxTpSduLength));
     /* always restart the s3server timer on any request */
-    context->timerS3Server = config->timing->S3Server;
+    Dcm_DslRestartS3Server(context);
 
     if (NULL != config->ServiceVerificationFnc) {
-      r = config->ServiceVerificationFnc(context->msgContext.dcmRxPduId, config->rxBuffer,
+      r = config->ServiceVerificationFnc(context->msgContext.dcmRxPduId, connection->rxBuffer,
                                          context->RxTpSduLength, &nrc);
       if (E_REQUEST_NOT_ACCEPTED == r) { /* @SWS_Dcm_00462:  reject and no response */
         context->rxBufferState = DCM_BUFFER_IDLE;
@@ -70,18 +71,22 @@ static void Dsd_HandleRequest(Dcm_ContextType *context,
       r = E_OK;
     }
 
+    if (E_OK == r) {
+      r = Dcm_DslArbitrate(context, SID, &nrc);
+    }
+
     if (E_OK == r) {
       service = Dsd_FindService(servieTable, SID);
       if (NULL != service) {
         r = Dcm_DslServiceSesSecPhyFuncCheck(context, &service->SesSecAccess, &nrc);
         if (E_OK == r) {
-          context->currentSID = config->rxBuffer[0];
+          context->currentSID = SID;
           context->curService = service;
           context->msgContext.msgAddInfo.suppressPosResponse = DCM_NOT_SUPRESS_POSITIVE_RESPONCE;
           if (0u != (service->SesSecAccess.miscMask & DCM_MISC_SUB_FUNCTION)) {
-            if (0u != (SUPPRESS_POS_RESP_BIT & config->rxBuffer[1])) {
+            if (0u != (SUPPRESS_POS_RESP_BIT & connection->rxBuffer[1])) {
               context->msgContext.msgAddInfo.suppressPosResponse = DCM_SUPRESS_POSITIVE_RESPONCE;
-              config->rxBuffer[1] &= ~SUPPRESS_POS_RESP_BIT;
+              connection->rxBuffer[1] &= ~SUPPRESS_POS_RESP_BIT;
             }
           }
         }
@@ -158,9 +163,18 @@ Dcm_GetActiveServiceTable(Dcm_ContextType *context,
 }
 
 void Dcm_MainFunction_Request(void) {
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  Dcm_ContextType *context;
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
-  if ((DCM_BUFFER_FULL == context->rxBufferState) && (DCM_BUFFER_IDLE == context->txBufferState)) {
-    Dsd_HandleRequest(context, config);
+  uint8_t i;
+
+  /* the requests of all the connections are processed in parallel in one main cycle */
+  for (i = 0u; i < config->numOfConnections; i++) {
+    server->active = i;
+    context = config->connections[i].context;
+    if ((DCM_BUFFER_FULL == context->rxBufferState) &&
+        (DCM_BUFFER_IDLE == context->txBufferState)) {
+      Dsd_HandleRequest(context, config);
+    }
   }
 }
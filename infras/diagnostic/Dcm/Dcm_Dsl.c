@@ -39,34 +39,136 @@ static uint8_t Dcm_DslSession2Mask(Dcm_SesCtrlType sesCtrl) {
 
   return mask;
 }
+
+static boolean Dcm_DslIsSessionOwner(Dcm_ServerContextType *server, Dcm_ContextType *context) {
+  boolean bOwner = TRUE;
+
+  if (DCM_INVALID_CONNECTION != server->owner) {
+    if (context != Dcm_GetConfig()->connections[server->owner].context) {
+      bOwner = FALSE;
+    }
+  }
+
+  return bOwner;
+}
+
+static void Dcm_DslResetSession(Dcm_ServerContextType *server, boolean timeout) {
+  Dcm_SessionChangeIndication(server->currentSession, DCM_DEFAULT_SESSION, timeout);
+  Dcm_DslInit();
+  Dcm_DspInit();
+}
+
+/* cancel the request in processing of the owner connection without any response, then return to
+ * the default session so that the preempting connection could take the session over */
+static void Dcm_DslPreempt(Dcm_ServerContextType *server) {
+  Dcm_NegativeResponseCodeType nrc;
+  uint8_t active = server->active;
+  Dcm_ContextType *context;
+
+  server->active = server->owner;
+  context = Dcm_GetContext();
+  if ((DCM_BUFFER_FULL == context->rxBufferState) && (DCM_INITIAL != context->opStatus)) {
+    context->opStatus = DCM_CANCEL;
+    if (context->curService != NULL) {
+      (void)context->curService->dspServiceFnc(&context->msgContext, &nrc);
+      (void)nrc;
+    }
+    if (DCM_RESPONSE_PENDING == context->responsePending) {
+      context->responsePending = DCM_NO_RESPONSE_PENDING;
+    }
+    context->rxBufferState = DCM_BUFFER_IDLE;
+    context->opStatus = DCM_INITIAL;
+    context->timerP2Server = 0;
+  }
+  server->active = active;
+
+  Dcm_DslResetSession(server, FALSE);
+}
 /* ================================ [ FUNCTIONS ] ============================================== */
 void Dcm_DslInit(void) {
-  Dcm_ContextType *context = Dcm_GetContext();
-  context->currentSession = DCM_DEFAULT_SESSION;
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  server->currentSession = DCM_DEFAULT_SESSION;
 #ifdef DCM_USE_SERVICE_SECURITY_ACCESS
-  context->currentLevel = DCM_SEC_LEV_LOCKED;
-  context->requestLevel = DCM_SEC_LEV_LOCKED;
+  server->currentLevel = DCM_SEC_LEV_LOCKED;
+  server->requestLevel = DCM_SEC_LEV_LOCKED;
 #endif
-  context->timerS3Server = 0;
-  context->timerP2Server = 0;
-  context->opStatus = DCM_INITIAL;
+  server->timerS3Server = 0;
+  server->owner = DCM_INVALID_CONNECTION;
 #if defined(DCM_USE_SERVICE_REQUEST_DOWNLOAD) || defined(DCM_USE_SERVICE_REQUEST_UPLOAD)
-  context->UDTData.state = DCM_UDT_IDLE_STATE;
-  context->UDTData.blockSequenceCounter = 0;
-  context->UDTData.memoryAddress = 0;
-  context->UDTData.memorySize = 0;
-  context->UDTData.offset = 0;
+  server->UDTData.state = DCM_UDT_IDLE_STATE;
+  server->UDTData.blockSequenceCounter = 0;
+  server->UDTData.memoryAddress = 0;
+  server->UDTData.memorySize = 0;
+  server->UDTData.offset = 0;
 #endif
 
 #ifdef DCM_USE_SERVICE_ECU_RESET
-  context->resetType = 0;
-  context->timer2Reset = 0;
+  server->resetType = 0;
+  server->timer2Reset = 0;
+#endif
+}
+
+void Dcm_DslInitConnection(Dcm_ContextType *context) {
+  (void)memset(context, 0, sizeof(Dcm_ContextType));
+  context->rxBufferState = DCM_BUFFER_IDLE;
+  context->txBufferState = DCM_BUFFER_IDLE;
+  context->curPduId = DCM_INVALID_PDU_ID;
+  context->opStatus = DCM_INITIAL;
+}
+
+void Dcm_DslRestartS3Server(Dcm_ContextType *context) {
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+
+  /* only the connection which owns the session keeps it alive */
+  if (TRUE == Dcm_DslIsSessionOwner(server, context)) {
+    server->timerS3Server = Dcm_GetConfig()->timing->S3Server;
+  }
+}
+
+/* The session and security state is shared by all the connections, a connection which doesn't own
+ * it is served as in the default session and locked, and the request of such a connection to change
+ * the session or security level is rejected with busyRepeatRequest unless its priority is higher
+ * than the owner's, in which case the owner is preempted. */
+Std_ReturnType Dcm_DslArbitrate(Dcm_ContextType *context, uint8_t SID,
+                                Dcm_NegativeResponseCodeType *nrc) {
+  Std_ReturnType r = E_OK;
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+
+  if ((FALSE == Dcm_DslIsSessionOwner(server, context)) &&
+      ((SID_DIAGNOSTIC_SESSION_CONTROL == SID) || (SID_SECURITY_ACCESS == SID))) {
+    if (Dcm_GetConnection()->priority < config->connections[server->owner].priority) {
+      ASLOG(DCMI, ("connection %d preempts connection %d\n", server->active, server->owner));
+      Dcm_DslPreempt(server);
+    } else {
+      *nrc = DCM_E_BUSY_REPEAT_REQUEST;
+      r = E_NOT_OK;
+    }
+  }
+
+  return r;
+}
+
+/* the connection in processing takes the session and security state over once it has left the
+ * default session or unlocked a security level */
+void Dcm_DslUpdateOwner(void) {
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+
+  server->owner = DCM_INVALID_CONNECTION;
+  if (DCM_DEFAULT_SESSION != server->currentSession) {
+    server->owner = server->active;
+  }
+#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
+  if (DCM_SEC_LEV_LOCKED != server->currentLevel) {
+    server->owner = server->active;
+  }
 #endif
 }
 
 void Dcm_DslProcessingDone(Dcm_ContextType *context,
                            P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config,
                            Dcm_NegativeResponseCodeType nrc) {
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection = Dcm_GetConnection();
 
   if (DCM_BUFFER_IDLE != context->txBufferState) {
     ASLOG(ERROR, ("Dcm Tx buffer is not idel when processing is done, drop previous response\n"));
@@ -78,7 +180,7 @@ void Dcm_DslProcessingDone(Dcm_ContextType *context,
     if (DCM_SUPRESS_POSITIVE_RESPONCE == context->msgContext.msgAddInfo.suppressPosResponse) {
       context->txBufferState = DCM_BUFFER_IDLE;
     } else {
-      config->txBuffer[0] = config->rxBuffer[0] | SID_RESPONSE_BIT;
+      connection->txBuffer[0] = connection->rxBuffer[0] | SID_RESPONSE_BIT;
       context->TxTpSduLength = context->msgContext.resDataLen + 1u;
       context->txBufferState = DCM_BUFFER_FULL;
     }
@@ -96,9 +198,9 @@ void Dcm_DslProcessingDone(Dcm_ContextType *context,
     context->opStatus = DCM_PENDING;
     context->responsePending = DCM_RESPONSE_PENDING;
   } else {
-    config->txBuffer[0] = SID_NEGATIVE_RESPONSE;
-    config->txBuffer[1] = config->rxBuffer[0];
-    config->txBuffer[2] = nrc;
+    connection->txBuffer[0] = SID_NEGATIVE_RESPONSE;
+    connection->txBuffer[1] = connection->rxBuffer[0];
+    connection->txBuffer[2] = nrc;
 
     context->TxTpSduLength = 3;
     context->txBufferState = DCM_BUFFER_FULL;
@@ -108,7 +210,7 @@ void Dcm_DslProcessingDone(Dcm_ContextType *context,
     context->timerP2Server = 0;
   }
   /* restart S3Server if any response transmited */
-  context->timerS3Server = config->timing->S3Server;
+  Dcm_DslRestartS3Server(context);
 }
 
 Std_ReturnType Dcm_DslIsSessionSupported(Dcm_SesCtrlType sesCtrl, uint8_t sesMask) {
@@ -127,12 +229,25 @@ Std_ReturnType Dcm_DslServiceSesSecPhyFuncCheck(Dcm_ContextType *context,
                                                   sesSecAccess,
                                                 Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  Dcm_SesCtrlType session = DCM_DEFAULT_SESSION;
+#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
+  Dcm_SecLevelType level = DCM_SEC_LEV_LOCKED;
+#endif
+
+  /* the connection which doesn't own the session is served as in the default session */
+  if (TRUE == Dcm_DslIsSessionOwner(server, context)) {
+    session = server->currentSession;
+#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
+    level = server->currentLevel;
+#endif
+  }
 
-  r = Dcm_DslIsSessionSupported(context->currentSession, sesSecAccess->sessionMask);
+  r = Dcm_DslIsSessionSupported(session, sesSecAccess->sessionMask);
   if (E_OK == r) {
     r = E_NOT_OK;
 #ifdef DCM_USE_SERVICE_SECURITY_ACCESS
-    if (0u != (sesSecAccess->securityMask & (1u << context->currentLevel))) {
+    if (0u != (sesSecAccess->securityMask & (1u << level))) {
 #endif
       if (0u != (sesSecAccess->miscMask & (1u << context->msgContext.msgAddInfo.reqType))) {
         r = E_OK;
@@ -186,8 +301,8 @@ Std_ReturnType Dcm_DslServiceDIDSesSecPhyFuncCheck(Dcm_ContextType *context,
 
 Std_ReturnType Dcm_GetSecurityLevel(Dcm_SecLevelType *SecLevel) {
 #ifdef DCM_USE_SERVICE_SECURITY_ACCESS
-  Dcm_ContextType *context = Dcm_GetContext();
-  *SecLevel = context->currentLevel;
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  *SecLevel = server->currentLevel;
 #else
   *SecLevel = DCM_SEC_LEV_LOCKED;
 #endif
@@ -195,65 +310,73 @@ Std_ReturnType Dcm_GetSecurityLevel(Dcm_SecLevelType *SecLevel) {
 }
 
 Std_ReturnType Dcm_GetSesCtrlType(Dcm_SesCtrlType *SesCtrlType) {
-  Dcm_ContextType *context = Dcm_GetContext();
-  *SesCtrlType = context->currentSession;
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  *SesCtrlType = server->currentSession;
   return E_OK;
 }
 
 void Dcm_DslMainFunction(void) {
   Dcm_NegativeResponseCodeType nrc;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
+  Dcm_ContextType *context;
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
-
-  if (context->timerP2Server > 0u) { /* @SWS_Dcm_00024 */
-    context->timerP2Server--;
-    if (0u == context->timerP2Server) {
-      if (context->respPendCnt < config->dslDisgResp->MaxNumRespPend) {
-        ASLOG(DCM, ("p2server timeout!\n"));
-        Dcm_DslProcessingDone(context, config, DCM_E_RESPONSE_PENDING);
-        context->respPendCnt++;
-        context->timerP2Server =
-          config->timing->P2StarServerMax - config->timing->P2StarServerAdjust;
-      } else { /* @SWS_Dcm_00120 */
-        context->opStatus = DCM_CANCEL;
-        if (context->curService != NULL) {
-          (void)context->curService->dspServiceFnc(&context->msgContext, &nrc);
-          (void)nrc;
-        } else {
-          ASLOG(DCME, ("Fatal ERROR as null service\n"));
+  uint8_t i;
+
+  for (i = 0u; i < config->numOfConnections; i++) {
+    server->active = i;
+    context = config->connections[i].context;
+    if (context->timerP2Server > 0u) { /* @SWS_Dcm_00024 */
+      context->timerP2Server--;
+      if (0u == context->timerP2Server) {
+        if (context->respPendCnt < config->dslDisgResp->MaxNumRespPend) {
+          ASLOG(DCM, ("p2server timeout!\n"));
+          Dcm_DslProcessingDone(context, config, DCM_E_RESPONSE_PENDING);
+          context->respPendCnt++;
+          context->timerP2Server =
+            config->timing->P2StarServerMax - config->timing->P2StarServerAdjust;
+        } else { /* @SWS_Dcm_00120 */
+          context->opStatus = DCM_CANCEL;
+          if (context->curService != NULL) {
+            (void)context->curService->dspServiceFnc(&context->msgContext, &nrc);
+            (void)nrc;
+          } else {
+            ASLOG(DCME, ("Fatal ERROR as null service\n"));
+          }
+          Dcm_DslProcessingDone(context, config, DCM_E_GENERAL_REJECT);
         }
-        Dcm_DslProcessingDone(context, config, DCM_E_GENERAL_REJECT);
       }
     }
   }
 
-  if (context->timerS3Server > 0u) {
-    context->timerS3Server--;
-    if (0u == context->timerS3Server) {
-      Dcm_SessionChangeIndication(context->currentSession, DCM_DEFAULT_SESSION, TRUE);
-      (void)memset(context, 0, sizeof(Dcm_ContextType));
-      context->rxBufferState = DCM_BUFFER_IDLE;
-      context->txBufferState = DCM_BUFFER_IDLE;
-      context->curPduId = DCM_INVALID_PDU_ID;
-      Dcm_DslInit();
-      Dcm_DspInit();
+  if (server->timerS3Server > 0u) {
+    server->timerS3Server--;
+    if (0u == server->timerS3Server) {
+      if (DCM_INVALID_CONNECTION != server->owner) {
+        server->active = server->owner;
+        Dcm_DslInitConnection(Dcm_GetContext());
+      } else {
+        for (i = 0u; i < config->numOfConnections; i++) {
+          Dcm_DslInitConnection(config->connections[i].context);
+        }
+      }
+      Dcm_DslResetSession(server, TRUE);
       ASLOG(INFO, ("DCM s3server timeout!\n"));
     }
   }
 
 #ifdef DCM_USE_SERVICE_ECU_RESET
-  if (context->timer2Reset > 0u) {
-    context->timer2Reset--;
-    if (0u == context->timer2Reset) {
-      Dcm_PerformReset(context->resetType);
+  if (server->timer2Reset > 0u) {
+    server->timer2Reset--;
+    if (0u == server->timer2Reset) {
+      Dcm_PerformReset(server->resetType);
     }
   }
 #endif
 
 #ifdef DCM_USE_SERVICE_SECURITY_ACCESS
-  if (context->securityDelayTimer > 0u) {
-    context->securityDelayTimer--;
-    if (0u == context->securityDelayTimer) {
+  if (server->securityDelayTimer > 0u) {
+    server->securityDelayTimer--;
+    if (0u == server->securityDelayTimer) {
       ASLOG(DCM, ("DCM security timer timeout!\n"));
     }
   }
@@ -266,24 +389,24 @@ Std_ReturnType Dcm_DslSecurityAccessRequestSeed(Dcm_MsgContextType *msgContext,
                                                         DCM_CONST) secLevelConfig,
                                                 Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
 #ifdef DCM_USE_SECURITY_SEED_PROTECTION
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
 #endif
 
-  if (secLevelConfig->secLevel == context->currentLevel) {
+  if (secLevelConfig->secLevel == server->currentLevel) {
     /* @SWS_Dcm_00323: already unlocked send 0 seed */
     r = E_OK;
     (void)memset(&msgContext->resData[1], 0, secLevelConfig->seedSize);
   } else {
 #ifdef DCM_USE_SECURITY_SEED_PROTECTION
-    if (context->requestLevel != secLevelConfig->secLevel) {
+    if (server->requestLevel != secLevelConfig->secLevel) {
       r = secLevelConfig->GetSeedFnc(&msgContext->resData[1], nrc);
       if (E_OK == r) {
-        (void)memcpy(context->cachedSeed, &msgContext->resData[1], secLevelConfig->seedSize);
+        (void)memcpy(server->cachedSeed, &msgContext->resData[1], secLevelConfig->seedSize);
       }
     } else {
-      (void)memcpy(&msgContext->resData[1], context->cachedSeed, secLevelConfig->seedSize);
+      (void)memcpy(&msgContext->resData[1], server->cachedSeed, secLevelConfig->seedSize);
       r = E_OK; /* given the same seed for seed protection purpose */
     }
 #else
@@ -294,7 +417,7 @@ Std_ReturnType Dcm_DslSecurityAccessRequestSeed(Dcm_MsgContextType *msgContext,
   if (E_OK == r) {
     msgContext->resData[0] = msgContext->reqData[0];
     msgContext->resDataLen = 1u + secLevelConfig->seedSize;
-    context->requestLevel = secLevelConfig->secLevel;
+    server->requestLevel = secLevelConfig->secLevel;
 #ifdef DCM_USE_SECURITY_SEED_PROTECTION
     if (Dcm_NvmSecurityAccess_Ram.AttemptCounter < (config->SecurityNumAttDelay + 2u)) {
       Dcm_NvmSecurityAccess_Ram.AttemptCounter++;
@@ -304,11 +427,11 @@ Std_ReturnType Dcm_DslSecurityAccessRequestSeed(Dcm_MsgContextType *msgContext,
       ASLOG(DCMI, ("Seurity Att Cnt=%" PRIu8 "\n", Dcm_NvmSecurityAccess_Ram.AttemptCounter));
     }
     if (Dcm_NvmSecurityAccess_Ram.AttemptCounter > (config->SecurityNumAttDelay + 1u)) {
-      context->securityDelayTimer = config->SecurityDelayTime;
+      server->securityDelayTimer = config->SecurityDelayTime;
     } else if (Dcm_NvmSecurityAccess_Ram.AttemptCounter == (config->SecurityNumAttDelay + 1u)) {
-      context->securityDelayTimer = config->SecurityDelayTime;
+      server->securityDelayTimer = config->SecurityDelayTime;
       /* allow to generate a new seed if timer timeout */
-      context->requestLevel = DCM_SEC_LEV_LOCKED;
+      server->requestLevel = DCM_SEC_LEV_LOCKED;
       *nrc = DCM_E_EXCEED_NUMBER_OF_ATTEMPTS;
       r = E_NOT_OK;
     } else {
@@ -316,7 +439,7 @@ Std_ReturnType Dcm_DslSecurityAccessRequestSeed(Dcm_MsgContextType *msgContext,
     }
 #endif
   } else {
-    context->requestLevel = DCM_SEC_LEV_LOCKED;
+    server->requestLevel = DCM_SEC_LEV_LOCKED;
   }
 
   return r;
@@ -327,21 +450,22 @@ Std_ReturnType Dcm_DslSecurityAccessCompareKey(Dcm_MsgContextType *msgContext,
                                                  secLevelConfig,
                                                Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
 #if !defined(DCM_USE_SECURITY_SEED_PROTECTION) || defined(USE_NVM)
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
 #endif
-  if (context->requestLevel != secLevelConfig->secLevel) {
+  if (server->requestLevel != secLevelConfig->secLevel) {
     *nrc = DCM_E_REQUEST_SEQUENCE_ERROR;
   } else {
-    context->requestLevel = DCM_SEC_LEV_LOCKED; /* reset request level */
+    server->requestLevel = DCM_SEC_LEV_LOCKED; /* reset request level */
     r = secLevelConfig->CompareKeyFnc(&msgContext->reqData[1], nrc);
   }
 
   if (E_OK == r) {
     msgContext->resData[0] = msgContext->reqData[0];
     msgContext->resDataLen = 1;
-    context->currentLevel = secLevelConfig->secLevel;
+    server->currentLevel = secLevelConfig->secLevel;
+    Dcm_DslUpdateOwner();
 #ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
     Dcm_ReadPeriodicDID_OnSessionSecurityChange(); /* @SWS_Dcm_01112 */
 #endif
@@ -367,7 +491,7 @@ Std_ReturnType Dcm_DslSecurityAccessCompareKey(Dcm_MsgContextType *msgContext,
         ASLOG(DCMI, ("Seurity Att Cnt=%" PRIu8 "\n", Dcm_NvmSecurityAccess_Ram.AttemptCounter));
       }
       if (Dcm_NvmSecurityAccess_Ram.AttemptCounter >= config->SecurityNumAttDelay) {
-        context->securityDelayTimer = config->SecurityDelayTime;
+        server->securityDelayTimer = config->SecurityDelayTime;
         *nrc = DCM_E_EXCEED_NUMBER_OF_ATTEMPTS;
       }
 #endif
@@ -379,9 +503,10 @@ Std_ReturnType Dcm_DslSecurityAccessCompareKey(Dcm_MsgContextType *msgContext,
 
 Std_ReturnType Dcm_SetSecurityLevel(Dcm_SecLevelType SecLevel) {
   Std_ReturnType r = E_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
 
-  context->currentLevel = SecLevel;
+  server->currentLevel = SecLevel;
+  Dcm_DslUpdateOwner();
 
   return r;
 }
@@ -389,20 +514,18 @@ Std_ReturnType Dcm_SetSecurityLevel(Dcm_SecLevelType SecLevel) {
 
 Std_ReturnType Dcm_SetSesCtrlType(Dcm_SesCtrlType SesCtrlType) {
   Std_ReturnType r = E_NOT_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
   uint8_t mask = Dcm_DslSession2Mask(SesCtrlType);
 
   if (mask != 0u) {
-    (void)memset(context, 0, sizeof(Dcm_ContextType));
-    context->rxBufferState = DCM_BUFFER_IDLE;
-    context->txBufferState = DCM_BUFFER_IDLE;
-    context->curPduId = DCM_INVALID_PDU_ID;
+    Dcm_DslInitConnection(Dcm_GetContext());
     Dcm_DslInit();
-    context->currentSession = SesCtrlType;
+    server->currentSession = SesCtrlType;
     if (SesCtrlType != DCM_DEFAULT_SESSION) {
-      context->timerS3Server = config->timing->S3Server;
+      server->timerS3Server = config->timing->S3Server;
     }
+    Dcm_DslUpdateOwner();
     r = E_OK;
   }
 
@@ -10,13 +10,34 @@
 #include "Dcm_Priv.h"
 #include "Std_Debug.h"
 #include "Dem.h"
+#include "PduR_Dcm.h"
 #include <string.h>
 /* ================================ [ MACROS    ] ============================================== */
 #define AS_LOG_DCM 0
 #define AS_LOG_DCME 3
 /* ================================ [ TYPES     ] ============================================== */
+#ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
+typedef struct {
+  uint32_t tick; /* main function cycles */
+  /* one slot for each rate, when it expires all DIDs of this rate are due */
+  uint16_t timer[DCM_TM_NUM_OF_RATES];
+  uint8_t head[DCM_TM_NUM_OF_RATES]; /* the DIDs of each rate */
+  /* the due DIDs, they are sent in order so that each DID gets its turn */
+  uint8_t qHead;
+  uint8_t qTail;
+  /* the DIDs of the UUDT frames waiting for their TxConfirmation in the transmit order, a ring
+   * written by the main function at txTail and read by the TxConfirmation at txHead */
+  uint8_t txPending[DCM_PERIODIC_MAX_TX_PENDING + 1u];
+  uint16_t txHead;
+  uint16_t txTail;
+  uint16_t txTimer; /* main function cycles left for the next TxConfirmation */
+} Dcm_ReadPeriodicDIDSchedulerType;
+#endif
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
+#ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
+static Dcm_ReadPeriodicDIDSchedulerType Dcm_PDIDScheduler;
+#endif
 /* ================================ [ LOCALS    ] ============================================== */
 #ifdef DCM_USE_SERVICE_ROUTINE_CONTROL
 static void Dcm_RoutineControl_Init(void) {
@@ -345,6 +366,7 @@ Std_ReturnType Dcm_DspSessionControl(Dcm_MsgContextType *msgContext,
 
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
   P2CONST(Dcm_SessionControlConfigType, AUTOMATIC, DCM_CONST)
   sesCtrlConfig =
@@ -370,7 +392,7 @@ Std_ReturnType Dcm_DspSessionControl(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    r = sesCtrlConfig->GetSesChgPermissionFnc(context->currentSession, sesCtrl, nrc);
+    r = sesCtrlConfig->GetSesChgPermissionFnc(server->currentSession, sesCtrl, nrc);
     if (E_OK == r) {
       if (DCM_E_RESPONSE_PENDING == *nrc) {
         r = DCM_E_PENDING; /* pending on session check */
@@ -379,9 +401,10 @@ Std_ReturnType Dcm_DspSessionControl(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    Dcm_SessionChangeIndication(context->currentSession, sesCtrl, FALSE);
+    Dcm_SessionChangeIndication(server->currentSession, sesCtrl, FALSE);
     Dcm_DslInit();
-    context->currentSession = sesCtrl;
+    server->currentSession = sesCtrl;
+    Dcm_DslUpdateOwner();
 #ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
     Dcm_ReadPeriodicDID_OnSessionSecurityChange(); /* @SWS_Dcm_01111 */
 #endif
@@ -393,7 +416,7 @@ Std_ReturnType Dcm_DspSessionControl(Dcm_MsgContextType *msgContext,
     msgContext->resData[3] = (u16V >> 8) & 0xFFu; /* P2*Server_max */
     msgContext->resData[4] = u16V & 0xFFu;
     msgContext->resDataLen = 5u;
-    context->timerS3Server = config->timing->S3Server;
+    server->timerS3Server = config->timing->S3Server;
   }
 
   return r;
@@ -403,6 +426,7 @@ Std_ReturnType Dcm_DspSecurityAccess(Dcm_MsgContextType *msgContext,
                                      Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_SecurityAccessConfigType, AUTOMATIC, DCM_CONST)
   secAccConfig =
     (P2CONST(Dcm_SecurityAccessConfigType, AUTOMATIC, DCM_CONST))context->curService->config;
@@ -432,7 +456,7 @@ Std_ReturnType Dcm_DspSecurityAccess(Dcm_MsgContextType *msgContext,
       }
 
       if (E_OK == r) {
-        r = Dcm_DslIsSessionSupported(context->currentSession, secLevelConfig->sessionMask);
+        r = Dcm_DslIsSessionSupported(server->currentSession, secLevelConfig->sessionMask);
         if (E_OK != r) {
           *nrc = DCM_E_SUB_FUNCTION_NOT_SUPPORTED_IN_ACTIVE_SESSION;
         }
@@ -445,7 +469,7 @@ Std_ReturnType Dcm_DspSecurityAccess(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    if ((context->securityDelayTimer > 0u)
+    if ((server->securityDelayTimer > 0u)
 #ifdef DCM_USE_SECURITY_SEED_PROTECTION
         && (0u != (msgContext->reqData[0] & 0x01u)) /* request seed */
 #endif
@@ -520,7 +544,7 @@ Std_ReturnType Dcm_DspRequestDownload(Dcm_MsgContextType *msgContext,
                                       Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
-  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_RequestDownloadConfigType, AUTOMATIC, DCM_CONST)
   rdConfig =
     (P2CONST(Dcm_RequestDownloadConfigType, AUTOMATIC, DCM_CONST))context->curService->config;
@@ -530,7 +554,7 @@ Std_ReturnType Dcm_DspRequestDownload(Dcm_MsgContextType *msgContext,
   uint32_t memoryAddress;
   uint32_t memorySize;
   /* @SWS_Dcm_01420 */
-  uint32_t BlockLength = config->rxBufferSize;
+  uint32_t BlockLength = Dcm_GetConnection()->rxBufferSize;
   uint16_t i;
 
   if (msgContext->reqDataLen > 3) {
@@ -561,7 +585,7 @@ Std_ReturnType Dcm_DspRequestDownload(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    if (DCM_UDT_IDLE_STATE != context->UDTData.state) {
+    if (DCM_UDT_IDLE_STATE != server->UDTData.state) {
       *nrc = DCM_E_REQUEST_SEQUENCE_ERROR;
     }
   }
@@ -582,11 +606,11 @@ Std_ReturnType Dcm_DspRequestDownload(Dcm_MsgContextType *msgContext,
       msgContext->resData[memorySizeLen - i] = (BlockLength >> (8 * i)) & 0xFFu;
     }
     msgContext->resDataLen = 1u + memorySizeLen;
-    context->UDTData.state = DCM_UDT_DOWNLOAD_STATE;
-    context->UDTData.memoryAddress = memoryAddress;
-    context->UDTData.memorySize = memorySize;
-    context->UDTData.offset = 0u;
-    context->UDTData.blockSequenceCounter = 1u;
+    server->UDTData.state = DCM_UDT_DOWNLOAD_STATE;
+    server->UDTData.memoryAddress = memoryAddress;
+    server->UDTData.memorySize = memorySize;
+    server->UDTData.offset = 0u;
+    server->UDTData.blockSequenceCounter = 1u;
   }
 
   return r;
@@ -598,6 +622,7 @@ Std_ReturnType Dcm_DspRequestUpload(Dcm_MsgContextType *msgContext,
                                     Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
   P2CONST(Dcm_RequestUploadConfigType, AUTOMATIC, DCM_CONST)
   ruConfig =
@@ -639,7 +664,7 @@ Std_ReturnType Dcm_DspRequestUpload(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    if (DCM_UDT_IDLE_STATE != context->UDTData.state) {
+    if (DCM_UDT_IDLE_STATE != server->UDTData.state) {
       *nrc = DCM_E_REQUEST_SEQUENCE_ERROR;
     }
   }
@@ -660,11 +685,11 @@ Std_ReturnType Dcm_DspRequestUpload(Dcm_MsgContextType *msgContext,
       msgContext->resData[memorySizeLen - i] = (BlockLength >> (8 * i)) & 0xFFu;
     }
     msgContext->resDataLen = 1u + memorySizeLen;
-    context->UDTData.state = DCM_UDT_UPLOAD_STATE;
-    context->UDTData.memoryAddress = memoryAddress;
-    context->UDTData.memorySize = memorySize;
-    context->UDTData.offset = 0u;
-    context->UDTData.blockSequenceCounter = 1u;
+    server->UDTData.state = DCM_UDT_UPLOAD_STATE;
+    server->UDTData.memoryAddress = memoryAddress;
+    server->UDTData.memorySize = memorySize;
+    server->UDTData.offset = 0u;
+    server->UDTData.blockSequenceCounter = 1u;
   }
 
   return r;
@@ -676,18 +701,19 @@ Std_ReturnType Dcm_DspTransferData(Dcm_MsgContextType *msgContext,
                                    Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_TransferDataConfigType, AUTOMATIC, DCM_CONST)
   tfdConfig =
     (P2CONST(Dcm_TransferDataConfigType, AUTOMATIC, DCM_CONST))context->curService->config;
-  uint32_t memoryAddress = context->UDTData.memoryAddress + context->UDTData.offset;
-  uint32_t memorySize = context->UDTData.memorySize - context->UDTData.offset;
+  uint32_t memoryAddress = server->UDTData.memoryAddress + server->UDTData.offset;
+  uint32_t memorySize = server->UDTData.memorySize - server->UDTData.offset;
   Dcm_ReturnWriteMemoryType retW;
   Dcm_ReturnReadMemoryType retR;
 
   if (msgContext->reqDataLen >= 1) {
-    if (context->UDTData.state != DCM_UDT_IDLE_STATE) {
-      if (context->UDTData.blockSequenceCounter == msgContext->reqData[0]) {
-        if (DCM_UDT_DOWNLOAD_STATE == context->UDTData.state) {
+    if (server->UDTData.state != DCM_UDT_IDLE_STATE) {
+      if (server->UDTData.blockSequenceCounter == msgContext->reqData[0]) {
+        if (DCM_UDT_DOWNLOAD_STATE == server->UDTData.state) {
           if (tfdConfig->WriteFnc != NULL) {
             r = E_OK;
           } else {
@@ -711,7 +737,7 @@ Std_ReturnType Dcm_DspTransferData(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    if (DCM_UDT_DOWNLOAD_STATE == context->UDTData.state) {
+    if (DCM_UDT_DOWNLOAD_STATE == server->UDTData.state) {
       if (memorySize < (msgContext->reqDataLen - 1)) {
         *nrc = DCM_E_INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT;
         r = E_NOT_OK;
@@ -731,7 +757,7 @@ Std_ReturnType Dcm_DspTransferData(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    if (DCM_UDT_DOWNLOAD_STATE == context->UDTData.state) {
+    if (DCM_UDT_DOWNLOAD_STATE == server->UDTData.state) {
       retW = tfdConfig->WriteFnc(context->opStatus, 0x00, memoryAddress, memorySize,
                                  &msgContext->reqData[1], nrc);
       if (DCM_WRITE_PENDING == retW) {
@@ -739,10 +765,10 @@ Std_ReturnType Dcm_DspTransferData(Dcm_MsgContextType *msgContext,
       } else if (DCM_WRITE_FORCE_RCRRP == retW) {
         r = DCM_E_FORCE_RCRRP;
       } else if (DCM_WRITE_OK == retW) {
-        context->UDTData.offset += memorySize;
-        msgContext->resData[0] = context->UDTData.blockSequenceCounter;
+        server->UDTData.offset += memorySize;
+        msgContext->resData[0] = server->UDTData.blockSequenceCounter;
         msgContext->resDataLen = 1;
-        context->UDTData.blockSequenceCounter++;
+        server->UDTData.blockSequenceCounter++;
       } else { /* FAILED */
         r = E_NOT_OK;
         if (DCM_POS_RESP == *nrc) {
@@ -757,10 +783,10 @@ Std_ReturnType Dcm_DspTransferData(Dcm_MsgContextType *msgContext,
       } else if (DCM_READ_FORCE_RCRRP == retR) {
         r = DCM_E_FORCE_RCRRP;
       } else if (DCM_READ_OK == retR) {
-        context->UDTData.offset += memorySize;
-        msgContext->resData[0] = context->UDTData.blockSequenceCounter;
+        server->UDTData.offset += memorySize;
+        msgContext->resData[0] = server->UDTData.blockSequenceCounter;
         msgContext->resDataLen = 1 + memorySize;
-        context->UDTData.blockSequenceCounter++;
+        server->UDTData.blockSequenceCounter++;
       } else { /* FAILED */
         r = E_NOT_OK;
         if (DCM_POS_RESP == *nrc) {
@@ -779,6 +805,7 @@ Std_ReturnType Dcm_DspRequestTransferExit(Dcm_MsgContextType *msgContext,
                                           Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_TransferExitConfigType, AUTOMATIC, DCM_CONST)
   tfeConfig =
     (P2CONST(Dcm_TransferExitConfigType, AUTOMATIC, DCM_CONST))context->curService->config;
@@ -790,7 +817,7 @@ Std_ReturnType Dcm_DspRequestTransferExit(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    if (DCM_UDT_IDLE_STATE == context->UDTData.state) {
+    if (DCM_UDT_IDLE_STATE == server->UDTData.state) {
       r = E_NOT_OK;
       *nrc = DCM_E_REQUEST_SEQUENCE_ERROR;
     }
@@ -801,11 +828,11 @@ Std_ReturnType Dcm_DspRequestTransferExit(Dcm_MsgContextType *msgContext,
   }
 
   if (E_OK == r) {
-    context->UDTData.state = DCM_UDT_IDLE_STATE;
-    context->UDTData.blockSequenceCounter = 0;
-    context->UDTData.memoryAddress = 0;
-    context->UDTData.memorySize = 0;
-    context->UDTData.offset = 0;
+    server->UDTData.state = DCM_UDT_IDLE_STATE;
+    server->UDTData.blockSequenceCounter = 0;
+    server->UDTData.memoryAddress = 0;
+    server->UDTData.memorySize = 0;
+    server->UDTData.offset = 0;
   }
 
   return r;
@@ -816,6 +843,7 @@ Std_ReturnType Dcm_DspRequestTransferExit(Dcm_MsgContextType *msgContext,
 Std_ReturnType Dcm_DspEcuReset(Dcm_MsgContextType *msgContext, Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_NOT_OK;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   P2CONST(Dcm_EcuResetConfigType, AUTOMATIC, DCM_CONST)
   rstConfig = (P2CONST(Dcm_EcuResetConfigType, AUTOMATIC, DCM_CONST))context->curService->config;
   if (1u == msgContext->reqDataLen) {
@@ -828,8 +856,8 @@ Std_ReturnType Dcm_DspEcuReset(Dcm_MsgContextType *msgContext, Dcm_NegativeRespo
     switch (msgContext->reqData[0]) {
     case 0x01u: /* hard reset */
     case 0x03u: /* soft reset */
-      context->resetType = msgContext->reqData[0];
-      msgContext->resData[0] = context->resetType;
+      server->resetType = msgContext->reqData[0];
+      msgContext->resData[0] = server->resetType;
       msgContext->resDataLen = 1u;
       break;
     default:
@@ -843,16 +871,16 @@ Std_ReturnType Dcm_DspEcuReset(Dcm_MsgContextType *msgContext, Dcm_NegativeRespo
     r = rstConfig->GetEcuResetPermissionFnc(context->opStatus, nrc);
     if (E_OK == r) {
       if (DCM_E_RESPONSE_PENDING == *nrc) {
-        context->timer2Reset = 0;
+        server->timer2Reset = 0;
       } else {
         if (rstConfig->delay == 0u) {
-          context->timer2Reset = 1u;
+          server->timer2Reset = 1u;
         } else {
-          context->timer2Reset = rstConfig->delay;
+          server->timer2Reset = rstConfig->delay;
         }
       }
     } else {
-      context->timer2Reset = 0;
+      server->timer2Reset = 0;
     }
   }
 
@@ -1517,7 +1545,8 @@ static void Dcm_IOCtlByID_Init(void) {
     if (IOCtrl->context->requestMask != 0u) {
       if (IOCtrl->ReturnControlToEcuFnc != NULL) {
         ASLOG(DCM, ("IOCTL %X return to ECU\n", IOCtrl->id));
-        (void)IOCtrl->ReturnControlToEcuFnc(NULL, 0, config->txBuffer, &resDataLen, &nrc);
+        (void)IOCtrl->ReturnControlToEcuFnc(NULL, 0, Dcm_GetConnection()->txBuffer, &resDataLen,
+                                            &nrc);
       }
     }
     IOCtrl->context->requestMask = 0;
@@ -1640,16 +1669,312 @@ Std_ReturnType Dcm_DspCommunicationControl(Dcm_MsgContextType *msgContext,
 #endif
 
 #ifdef DCM_USE_SERVICE_READ_DATA_BY_PERIODIC_IDENTIFIER
+static uint16_t Dcm_ReadPeriodicDIDReload(uint8_t rate) {
+  uint16_t reload;
+
+  switch (rate) {
+  case DCM_TM_SEND_AT_SLOW_RATE:
+    reload = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_TM_SLOW_TIME_MS);
+    break;
+  case DCM_TM_SEND_AT_MEDIUM_RATE:
+    reload = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_TM_MEDIUM_TIME_MS);
+    break;
+  default:
+    reload = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_TM_FAST_TIME_MS);
+    break;
+  }
+
+  if (0u == reload) {
+    reload = 1u;
+  }
+
+  return reload;
+}
+
+/* append the DID to the transmit queue, a DID already queued is not due twice and the sample
+ * is counted as missed if it has been sent before */
+static void Dcm_ReadPeriodicDIDEnqueue(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST)
+                                         pDIDConfig,
+                                       uint8_t index) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  Dcm_ReadPeriodicDIDContextType *ctx = pDIDConfig->DIDs[index].context;
+
+  if (TRUE == ctx->queued) {
+    if ((ctx->numOfSent > 0u) && (ctx->numOfMissed < 0xFFFFu)) {
+      ctx->numOfMissed++;
+    }
+  } else {
+    ctx->queued = TRUE;
+    ctx->qNext = DCM_PERIODIC_NONE;
+    if (DCM_PERIODIC_NONE == sched->qTail) {
+      sched->qHead = index;
+    } else {
+      pDIDConfig->DIDs[sched->qTail].context->qNext = index;
+    }
+    sched->qTail = index;
+  }
+}
+
+static void Dcm_ReadPeriodicDIDDequeue(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST)
+                                         pDIDConfig) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  Dcm_ReadPeriodicDIDContextType *ctx = pDIDConfig->DIDs[sched->qHead].context;
+
+  sched->qHead = ctx->qNext;
+  if (DCM_PERIODIC_NONE == sched->qHead) {
+    sched->qTail = DCM_PERIODIC_NONE;
+  }
+  ctx->queued = FALSE;
+  ctx->qNext = DCM_PERIODIC_NONE;
+}
+
+/* unlink the DID from the list of its rate and from the transmit queue */
+static void Dcm_ReadPeriodicDIDStop(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST)
+                                      pDIDConfig,
+                                    uint8_t index) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  Dcm_ReadPeriodicDIDContextType *ctx = pDIDConfig->DIDs[index].context;
+  uint8_t *link;
+  uint8_t prev = DCM_PERIODIC_NONE;
+
+  if (0u != ctx->rate) {
+    link = &sched->head[ctx->rate - 1u];
+    while ((DCM_PERIODIC_NONE != *link) && (index != *link)) {
+      link = &pDIDConfig->DIDs[*link].context->next;
+    }
+    if (index == *link) {
+      *link = ctx->next;
+    }
+  }
+
+  if (TRUE == ctx->queued) {
+    link = &sched->qHead;
+    while ((DCM_PERIODIC_NONE != *link) && (index != *link)) {
+      prev = *link;
+      link = &pDIDConfig->DIDs[*link].context->qNext;
+    }
+    if (index == *link) {
+      *link = ctx->qNext;
+      if (index == sched->qTail) {
+        sched->qTail = prev;
+      }
+    }
+  }
+
+  ctx->rate = 0u;
+  ctx->next = DCM_PERIODIC_NONE;
+  ctx->qNext = DCM_PERIODIC_NONE;
+  ctx->queued = FALSE;
+  ctx->opStatus = DCM_INITIAL;
+}
+
+static void Dcm_ReadPeriodicDIDStart(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST)
+                                       pDIDConfig,
+                                     uint8_t index, uint8_t rate) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  Dcm_ReadPeriodicDIDContextType *ctx = pDIDConfig->DIDs[index].context;
+
+  if (rate != ctx->rate) {
+    Dcm_ReadPeriodicDIDStop(pDIDConfig, index);
+    ctx->rate = rate;
+    ctx->next = sched->head[rate - 1u];
+    sched->head[rate - 1u] = index;
+    if (0u == sched->timer[rate - 1u]) {
+      sched->timer[rate - 1u] = Dcm_ReadPeriodicDIDReload(rate);
+    }
+    ctx->numOfSent = 0u;
+    ctx->numOfMissed = 0u;
+    /* the first sample is sent as soon as possible */
+    Dcm_ReadPeriodicDIDEnqueue(pDIDConfig, index);
+  }
+}
+
+/* return E_OK if the data is read, DCM_E_PENDING to read again later, E_NOT_OK to drop it */
+static Std_ReturnType Dcm_ReadPeriodicDIDRead(P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC,
+                                                      DCM_CONST) rDid,
+                                              uint8_t *data) {
+  Dcm_NegativeResponseCodeType nrc = DCM_POS_RESP;
+  Std_ReturnType r;
+
+  r = rDid->DID->readDIdFnc(rDid->context->opStatus, data, rDid->DID->length, &nrc);
+  if ((DCM_E_PENDING == r) || (DCM_E_FORCE_RCRRP == r) ||
+      ((E_OK == r) && (DCM_E_RESPONSE_PENDING == nrc))) {
+    rDid->context->opStatus = DCM_PENDING;
+    r = DCM_E_PENDING;
+  } else {
+    rDid->context->opStatus = DCM_INITIAL;
+    if ((E_OK != r) || (DCM_POS_RESP != nrc)) {
+      ASLOG(DCME, ("read periodic DID %X failed: %d, nrc=%02X\n", rDid->DID->id, r, nrc));
+      r = E_NOT_OK;
+    }
+  }
+
+  return r;
+}
+
+static void Dcm_ReadPeriodicDIDSent(P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid) {
+  Dcm_ReadPeriodicDIDContextType *ctx = rDid->context;
+
+  if (0u == ctx->numOfSent) {
+    ctx->firstTick = Dcm_PDIDScheduler.tick;
+  }
+  if (ctx->numOfSent < 0xFFFFu) {
+    ctx->numOfSent++;
+  }
+  ctx->lastTick = Dcm_PDIDScheduler.tick;
+}
+
+static void Dcm_ReadPeriodicDIDLost(P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid) {
+  Dcm_ReadPeriodicDIDContextType *ctx = rDid->context;
+
+  if (ctx->numOfMissed < 0xFFFFu) {
+    ctx->numOfMissed++;
+  }
+}
+
+static uint16_t Dcm_ReadPeriodicDIDTxNext(uint16_t pos) {
+  pos++;
+  if (pos > DCM_PERIODIC_MAX_TX_PENDING) {
+    pos = 0u;
+  }
+
+  return pos;
+}
+
+/* the frames the IF layer did not confirm in time are counted as lost, this frees the ring */
+static void Dcm_ReadPeriodicDIDTxTimeout(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC,
+                                                 DCM_CONST) pDIDConfig) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+
+  if (sched->txHead != sched->txTail) {
+    if (sched->txTimer > 0u) {
+      sched->txTimer--;
+    }
+    if (0u == sched->txTimer) {
+      ASLOG(DCME, ("periodic DID frames not confirmed in time\n"));
+      while (sched->txHead != sched->txTail) {
+        Dcm_ReadPeriodicDIDLost(&pDIDConfig->DIDs[sched->txPending[sched->txHead]]);
+        sched->txHead = Dcm_ReadPeriodicDIDTxNext(sched->txHead);
+      }
+    }
+  }
+}
+
+/* each due DID is sent as one single frame [pDID, data] on the dedicated IF PDU, the IF layer
+ * copies the frame in the transmit call and the DID is counted as sent on its TxConfirmation */
+static void Dcm_ReadPeriodicDIDSendUUDT(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC,
+                                                DCM_CONST) pDIDConfig) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid;
+  uint8_t frame[DCM_PERIODIC_FRAME_SIZE];
+  PduInfoType PduInfo;
+  uint8_t firstPending = DCM_PERIODIC_NONE;
+  uint8_t index;
+  uint16_t numOfTx = 0u;
+  uint16_t txTail;
+  boolean stop = FALSE;
+  Std_ReturnType r;
+
+  PduInfo.SduDataPtr = frame;
+  PduInfo.MetaDataPtr = NULL;
+  while ((FALSE == stop) && (DCM_PERIODIC_NONE != sched->qHead) &&
+         (firstPending != sched->qHead) && (numOfTx < DCM_PERIODIC_MAX_TX_PER_CYCLE) &&
+         (Dcm_ReadPeriodicDIDTxNext(sched->txTail) != sched->txHead)) {
+    index = sched->qHead;
+    rDid = &pDIDConfig->DIDs[index];
+    frame[0] = (uint8_t)(rDid->DID->id & 0xFFu);
+    r = Dcm_ReadPeriodicDIDRead(rDid, &frame[1]);
+    if (DCM_E_PENDING == r) {
+      /* give the others a chance, this one is read again on its next turn */
+      Dcm_ReadPeriodicDIDDequeue(pDIDConfig);
+      Dcm_ReadPeriodicDIDEnqueue(pDIDConfig, index);
+      if (DCM_PERIODIC_NONE == firstPending) {
+        firstPending = index;
+      }
+    } else if (E_OK == r) {
+      PduInfo.SduLength = (PduLengthType)rDid->DID->length + 1u;
+      /* in the ring before the transmit, the TxConfirmation may come within the call */
+      txTail = sched->txTail;
+      if (txTail == sched->txHead) {
+        sched->txTimer = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_PERIODIC_TX_TIMEOUT_MS) + 1u;
+      }
+      sched->txPending[txTail] = index;
+      sched->txTail = Dcm_ReadPeriodicDIDTxNext(txTail);
+      r = DCM_PERIODIC_TRANSMIT(pDIDConfig->TxPduId, &PduInfo);
+      if (E_OK == r) {
+        Dcm_ReadPeriodicDIDDequeue(pDIDConfig);
+        numOfTx++;
+      } else {
+        /* the bus is busy, keep it at the head and try again on the next cycle */
+        sched->txTail = txTail;
+        stop = TRUE;
+      }
+    } else {
+      Dcm_ReadPeriodicDIDDequeue(pDIDConfig);
+    }
+  }
+}
+
+/* pack the due DIDs from the head of the queue into one 0x6A response */
+static void Dcm_ReadPeriodicDIDSendResponse(P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC,
+                                                    DCM_CONST) pDIDConfig) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  Dcm_ContextType *context = Dcm_GetContext();
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection = Dcm_GetConnection();
+  P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid;
+  Dcm_MsgType resData = connection->txBuffer;
+  Dcm_MsgLenType totalResLength = 1u;
+  uint8_t firstPending = DCM_PERIODIC_NONE;
+  uint8_t index;
+  Std_ReturnType r;
+
+  if (DCM_BUFFER_IDLE == context->txBufferState) {
+    resData[0] = 0x6Au;
+    while ((DCM_PERIODIC_NONE != sched->qHead) && (firstPending != sched->qHead)) {
+      index = sched->qHead;
+      rDid = &pDIDConfig->DIDs[index];
+      if ((totalResLength + 1u + rDid->DID->length) > connection->txBufferSize) {
+        break;
+      }
+      r = Dcm_ReadPeriodicDIDRead(rDid, &resData[totalResLength + 1u]);
+      Dcm_ReadPeriodicDIDDequeue(pDIDConfig);
+      if (DCM_E_PENDING == r) {
+        Dcm_ReadPeriodicDIDEnqueue(pDIDConfig, index);
+        if (DCM_PERIODIC_NONE == firstPending) {
+          firstPending = index;
+        }
+      } else if (E_OK == r) {
+        resData[totalResLength] = (uint8_t)(rDid->DID->id & 0xFFu);
+        totalResLength += 1u + rDid->DID->length;
+        Dcm_ReadPeriodicDIDSent(rDid);
+      } else {
+        /* drop this sample */
+      }
+    }
+    if (totalResLength > 1u) {
+      context->TxTpSduLength = totalResLength;
+      context->txBufferState = DCM_BUFFER_FULL;
+    }
+  }
+}
+
 void Dcm_ReadPeriodicDID_Init(void) {
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
   P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST) pDIDConfig = config->rPDIDConfig;
   P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid = NULL;
   uint16_t i;
+
+  (void)memset(&Dcm_PDIDScheduler, 0, sizeof(Dcm_PDIDScheduler));
+  (void)memset(Dcm_PDIDScheduler.head, DCM_PERIODIC_NONE, sizeof(Dcm_PDIDScheduler.head));
+  Dcm_PDIDScheduler.qHead = DCM_PERIODIC_NONE;
+  Dcm_PDIDScheduler.qTail = DCM_PERIODIC_NONE;
   if (NULL != pDIDConfig) {
     for (i = 0; i < pDIDConfig->numOfDIDs; i++) {
       rDid = &pDIDConfig->DIDs[i];
       (void)memset(rDid->context, 0, sizeof(Dcm_ReadPeriodicDIDContextType));
-      rDid->context->opStatus = DCM_CANCEL;
+      rDid->context->opStatus = DCM_INITIAL;
+      rDid->context->next = DCM_PERIODIC_NONE;
+      rDid->context->qNext = DCM_PERIODIC_NONE;
     }
   }
 }
@@ -1659,6 +1984,7 @@ void Dcm_ReadPeriodicDID_OnSessionSecurityChange(void) {
   P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST) pDIDConfig = config->rPDIDConfig;
   P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid = NULL;
   Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ServerContextType *server = Dcm_GetServerContext();
   Dcm_NegativeResponseCodeType nrc;
   boolean stopIt;
   uint16_t i;
@@ -1668,7 +1994,7 @@ void Dcm_ReadPeriodicDID_OnSessionSecurityChange(void) {
     for (i = 0; i < pDIDConfig->numOfDIDs; i++) {
       rDid = &pDIDConfig->DIDs[i];
       stopIt = FALSE;
-      if (DCM_DEFAULT_SESSION == context->currentSession) { /* @SWS_Dcm_01107*/
+      if (DCM_DEFAULT_SESSION == server->currentSession) { /* @SWS_Dcm_01107*/
         stopIt = TRUE;
       } else {
         /*  @SWS_Dcm_01108, @SWS_Dcm_01109 */
@@ -1678,79 +2004,96 @@ void Dcm_ReadPeriodicDID_OnSessionSecurityChange(void) {
           stopIt = TRUE;
         }
       }
-      if (TRUE == stopIt) {
-        (void)memset(rDid->context, 0, sizeof(Dcm_ReadPeriodicDIDContextType));
-        rDid->context->opStatus = DCM_CANCEL;
+      if ((TRUE == stopIt) && (0u != rDid->context->rate)) {
+        Dcm_ReadPeriodicDIDStop(pDIDConfig, (uint8_t)i);
       }
     }
   }
 }
 
 void Dcm_MainFunction_ReadPeriodicDID(void) {
-  Std_ReturnType r = E_OK;
-  Dcm_ContextType *context = Dcm_GetContext();
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
   P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST) pDIDConfig = config->rPDIDConfig;
-  P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid = NULL;
-  uint16_t i;
-  Dcm_MsgType resData = config->txBuffer;
-  Dcm_MsgLenType totalResLength;
-  Dcm_NegativeResponseCodeType nrc;
+  uint8_t index;
+  uint8_t i;
 
   if (NULL != pDIDConfig) {
-    for (i = 0; i < pDIDConfig->numOfDIDs; i++) {
-      rDid = &pDIDConfig->DIDs[i];
-      if (rDid->context->reload > 0u) {
-        if (rDid->context->timer > 0u) {
-          rDid->context->timer--;
-          if (0u == rDid->context->timer) {
-            rDid->context->opStatus = DCM_INITIAL;
-            rDid->context->timer = rDid->context->reload;
+    sched->tick++;
+    for (i = 0u; i < DCM_TM_NUM_OF_RATES; i++) {
+      if (DCM_PERIODIC_NONE == sched->head[i]) {
+        sched->timer[i] = 0u; /* no DIDs of this rate, park the slot */
+      } else if (sched->timer[i] > 0u) {
+        sched->timer[i]--;
+        if (0u == sched->timer[i]) {
+          sched->timer[i] = Dcm_ReadPeriodicDIDReload(i + 1u);
+          for (index = sched->head[i]; DCM_PERIODIC_NONE != index;
+               index = pDIDConfig->DIDs[index].context->next) {
+            Dcm_ReadPeriodicDIDEnqueue(pDIDConfig, index);
           }
-        } else {
-          ASLOG(DCME, ("read periodic timer stopt\n"));
-          rDid->context->timer = rDid->context->reload;
         }
+      } else {
+        /* started by the service handler */
       }
     }
+
+    Dcm_ReadPeriodicDIDTxTimeout(pDIDConfig);
+    if (DCM_PERIODIC_NONE != sched->qHead) {
+      if (DCM_PERIODIC_TX_PDU_INVALID != pDIDConfig->TxPduId) {
+        Dcm_ReadPeriodicDIDSendUUDT(pDIDConfig);
+      } else {
+        Dcm_ReadPeriodicDIDSendResponse(pDIDConfig);
+      }
+    }
+  }
+}
+
+void Dcm_ReadPeriodicDID_TxConfirmation(PduIdType TxPduId, Std_ReturnType result) {
+  Dcm_ReadPeriodicDIDSchedulerType *sched = &Dcm_PDIDScheduler;
+  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST) pDIDConfig = config->rPDIDConfig;
+  P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid;
+
+  if ((NULL == pDIDConfig) || (TxPduId != pDIDConfig->TxPduId)) {
+    ASLOG(DCME, ("TxConfirmation %d is not for the periodic DIDs\n", TxPduId));
+  } else if (sched->txHead != sched->txTail) {
+    rDid = &pDIDConfig->DIDs[sched->txPending[sched->txHead]];
+    sched->txHead = Dcm_ReadPeriodicDIDTxNext(sched->txHead);
+    sched->txTimer = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_PERIODIC_TX_TIMEOUT_MS) + 1u;
+    if (E_OK == result) {
+      Dcm_ReadPeriodicDIDSent(rDid);
+    } else {
+      Dcm_ReadPeriodicDIDLost(rDid);
+    }
+  } else {
+    ASLOG(DCME, ("periodic DID TxConfirmation %d without a frame\n", TxPduId));
   }
+}
 
-  if ((NULL != pDIDConfig) && (DCM_BUFFER_IDLE == context->txBufferState)) {
-    resData[0] = 0x6Au;
-    totalResLength = 1u;
+Std_ReturnType Dcm_GetPeriodicDIDRate(uint8_t id, uint32_t *periodMs, uint16_t *numOfMissed) {
+  Std_ReturnType r = E_NOT_OK;
+  P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST) pDIDConfig = config->rPDIDConfig;
+  P2CONST(Dcm_ReadPeriodicDIDContextType, AUTOMATIC, DCM_CONST) ctx;
+  uint16_t i;
+
+  if ((NULL != pDIDConfig) && (NULL != periodMs) && (NULL != numOfMissed)) {
     for (i = 0u; i < pDIDConfig->numOfDIDs; i++) {
-      rDid = &pDIDConfig->DIDs[i];
-      if (rDid->context->opStatus != DCM_CANCEL) {
-        if ((totalResLength + 1u + rDid->DID->length) > config->txBufferSize) {
-          break;
-        }
-        nrc = DCM_POS_RESP;
-        r = rDid->DID->readDIdFnc(rDid->context->opStatus, &resData[totalResLength + 1u],
-                                  rDid->DID->length, &nrc);
-        if ((DCM_E_PENDING == r) || (DCM_E_FORCE_RCRRP == r)) {
-          r = E_OK;
-          nrc = DCM_E_RESPONSE_PENDING;
-        }
-        if (r != E_OK) {
-          ASLOG(DCME, ("read periodic DID FAILED\n"));
-          rDid->context->opStatus = DCM_CANCEL;
-        } else if (DCM_POS_RESP == nrc) { /* reading is done */
-          resData[totalResLength] = rDid->DID->id & 0xFFu;
-          totalResLength += 1u + rDid->DID->length;
-          rDid->context->opStatus = DCM_CANCEL;
-        } else if (DCM_E_RESPONSE_PENDING == nrc) {
-          rDid->context->opStatus = DCM_PENDING;
-        } else {
-          ASLOG(DCME, ("read periodic DID meet invalid NRC\n"));
-          rDid->context->opStatus = DCM_CANCEL;
+      if (pDIDConfig->DIDs[i].DID->id == ((uint16_t)id + 0xF200u)) {
+        ctx = pDIDConfig->DIDs[i].context;
+        *periodMs = 0u;
+        if (ctx->numOfSent > 1u) {
+          *periodMs = (ctx->lastTick - ctx->firstTick) * DCM_MAIN_FUNCTION_PERIOD /
+                      ((uint32_t)ctx->numOfSent - 1u);
         }
+        *numOfMissed = ctx->numOfMissed;
+        r = E_OK;
+        break;
       }
     }
-    if (totalResLength > 1u) {
-      context->TxTpSduLength = totalResLength;
-      context->txBufferState = DCM_BUFFER_FULL;
-    }
   }
+
+  return r;
 }
 
 Std_ReturnType Dcm_DspReadDataByPeriodicIdentifier(Dcm_MsgContextType *msgContext,
@@ -1762,17 +2105,19 @@ Std_ReturnType Dcm_DspReadDataByPeriodicIdentifier(Dcm_MsgContextType *msgContex
     (P2CONST(Dcm_ReadPeriodicDIDConfigType, AUTOMATIC, DCM_CONST))context->curService->config;
   P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) rDid = NULL;
   uint8_t id;
-  uint8_t transmissionMode;
+  uint8_t transmissionMode = 0u;
   uint16_t numOfDids = 0;
   Dcm_MsgLenType totalResLength = 0;
-  uint16_t reload = 0;
   uint16_t i;
   uint16_t j;
 
-  if (msgContext->reqDataLen >= 2u) {
+  if (msgContext->reqDataLen >= 1u) {
     transmissionMode = msgContext->reqData[0];
     numOfDids = msgContext->reqDataLen - 1u;
-  } else {
+  }
+
+  /* stop sending without any DID stops all of them */
+  if ((0u == numOfDids) && (DCM_TM_STOP_SENDING != transmissionMode)) {
     *nrc = DCM_E_INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT;
     r = E_NOT_OK;
   }
@@ -1780,16 +2125,9 @@ Std_ReturnType Dcm_DspReadDataByPeriodicIdentifier(Dcm_MsgContextType *msgContex
   if (E_OK == r) {
     switch (transmissionMode) {
     case DCM_TM_SEND_AT_SLOW_RATE:
-      reload = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_TM_SLOW_TIME_MS);
-      break;
     case DCM_TM_SEND_AT_MEDIUM_RATE:
-      reload = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_TM_MEDIUM_TIME_MS);
-      break;
     case DCM_TM_SEND_AT_FAST_RATE:
-      reload = (uint16_t)DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_TM_FAST_TIME_MS);
-      break;
     case DCM_TM_STOP_SENDING:
-      reload = 0;
       break;
     default:
       *nrc = DCM_E_SUB_FUNCTION_NOT_SUPPORTED;
@@ -1810,7 +2148,14 @@ Std_ReturnType Dcm_DspReadDataByPeriodicIdentifier(Dcm_MsgContextType *msgContex
       }
       if (NULL != rDid) {
         totalResLength += rDid->DID->length + 1u;
-        r = Dcm_DslServiceDIDSesSecPhyFuncCheck(context, &rDid->DID->SesSecAccess, nrc);
+        if ((DCM_PERIODIC_TX_PDU_INVALID != config->TxPduId) &&
+            ((rDid->DID->length + 1u) > DCM_PERIODIC_FRAME_SIZE)) {
+          /* doesn't fit into one single frame */
+          *nrc = DCM_E_REQUEST_OUT_OF_RANGE;
+          r = E_NOT_OK;
+        } else {
+          r = Dcm_DslServiceDIDSesSecPhyFuncCheck(context, &rDid->DID->SesSecAccess, nrc);
+        }
       } else {
         *nrc = DCM_E_REQUEST_OUT_OF_RANGE;
         r = E_NOT_OK;
@@ -1826,19 +2171,18 @@ Std_ReturnType Dcm_DspReadDataByPeriodicIdentifier(Dcm_MsgContextType *msgContex
   }
 
   if (E_OK == r) {
-    for (i = 0u; i < numOfDids; i++) {
-      rDid = NULL;
-      id = msgContext->reqData[i + 1u];
-      for (j = 0u; j < config->numOfDIDs; j++) {
-        if (config->DIDs[j].DID->id == ((uint16_t)id + 0xF200u)) {
-          rDid = &config->DIDs[j];
-          if (0u == rDid->context->reload) {
-            rDid->context->opStatus = DCM_CANCEL;
-          }
-          rDid->context->reload = reload;
-          if (DCM_CANCEL == rDid->context->opStatus) {
-            rDid->context->timer = 1;
-          }
+    for (j = 0u; j < config->numOfDIDs; j++) {
+      rDid = &config->DIDs[j];
+      for (i = 0u; i < numOfDids; i++) {
+        if (rDid->DID->id == ((uint16_t)msgContext->reqData[i + 1u] + 0xF200u)) {
+          break;
+        }
+      }
+      if ((i < numOfDids) || (0u == numOfDids)) {
+        if (DCM_TM_STOP_SENDING == transmissionMode) {
+          Dcm_ReadPeriodicDIDStop(config, (uint8_t)j);
+        } else {
+          Dcm_ReadPeriodicDIDStart(config, (uint8_t)j, transmissionMode);
         }
       }
     }
@@ -2072,6 +2416,7 @@ Std_ReturnType Dcm_DspReadDDDID(P2CONST(Dcm_DDDIDConfigType, AUTOMATIC, DCM_CONS
                                 Dcm_NegativeResponseCodeType *nrc) {
   Std_ReturnType r = E_OK;
   P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) config = Dcm_GetConfig();
+  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection = Dcm_GetConnection();
   P2CONST(Dcm_rDIDConfigType, AUTOMATIC, DCM_CONST)
   rDID;
   Dcm_DDDIDEntryType *entry;
@@ -2111,7 +2456,7 @@ Std_ReturnType Dcm_DspReadDDDID(P2CONST(Dcm_DDDIDConfigType, AUTOMATIC, DCM_CONS
           (DCM_PENDING == entry->opStatus)) {
         entry->opStatus = DCM_CANCEL; /* set to invalid */
         /* NOTE: use the end of TX buffer to saving the whole DID data */
-        tmp = &config->txBuffer[config->txBufferSize - rDID->length];
+        tmp = &connection->txBuffer[connection->txBufferSize - rDID->length];
         r = rDID->readDIdFnc(opStatus, tmp, rDID->length, nrc);
         if (DCM_E_PENDING == r) {
           r = E_OK;
@@ -12,6 +12,8 @@
 
 #define DCM_INVALID_PDU_ID ((PduIdType) - 1)
 
+#define DCM_INVALID_CONNECTION ((uint8_t)0xFF)
+
 /* @SWS_Dcm_00978 */
 #define DCM_DFTS_MASK 0x01u
 #define DCM_PRGS_MASK 0x02u
@@ -122,6 +124,38 @@
 #define DCM_TM_FAST_TIME_MS 500u
 #endif
 
+#define DCM_TM_NUM_OF_RATES 3u
+
+/* the periodic DIDs are sent as 0x6A responses on the request channel */
+#define DCM_PERIODIC_TX_PDU_INVALID ((PduIdType)-1)
+
+/* the max UUDT frame, 8 for CAN and 64 for CAN FD, it holds the periodic DID and its data */
+#ifndef DCM_PERIODIC_FRAME_SIZE
+#define DCM_PERIODIC_FRAME_SIZE 8u
+#endif
+
+/* the max UUDT frames sent in one main function cycle */
+#ifndef DCM_PERIODIC_MAX_TX_PER_CYCLE
+#define DCM_PERIODIC_MAX_TX_PER_CYCLE 64u
+#endif
+
+/* the max UUDT frames accepted by the IF layer and not yet confirmed */
+#ifndef DCM_PERIODIC_MAX_TX_PENDING
+#define DCM_PERIODIC_MAX_TX_PENDING 64u
+#endif
+
+/* the UUDT frames not confirmed within this time are dropped */
+#ifndef DCM_PERIODIC_TX_TIMEOUT_MS
+#define DCM_PERIODIC_TX_TIMEOUT_MS 100u
+#endif
+
+/* the UUDT frames are single frames, they go through the IF layer, not the TP layer */
+#ifndef DCM_PERIODIC_TRANSMIT
+#define DCM_PERIODIC_TRANSMIT PduR_DcmIfTransmit
+#endif
+
+#define DCM_PERIODIC_NONE 0xFFu
+
 #ifndef DCM_DDDID_MAX_ENTRY
 #define DCM_DDDID_MAX_ENTRY 32u
 #endif
@@ -171,28 +205,36 @@ typedef struct {
 } Dcm_UDTType;
 #endif
 
+/* the per connection Dsl context, the requests of the connections are processed in parallel */
 typedef struct {
   PduIdType curPduId;
   PduLengthType RxTpSduLength;
   PduLengthType RxIndex;
   PduLengthType TxTpSduLength;
   PduLengthType TxIndex;
-  uint16_t timerS3Server;
   uint16_t timerP2Server;
   uint8_t respPendCnt;
   uint8_t currentSID;
-  Dcm_SesCtrlType currentSession;
-#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
-  Dcm_SecLevelType currentLevel;
-  Dcm_SecLevelType requestLevel;
-  uint16_t securityDelayTimer;
-#endif
   uint8_t rxBufferState;
   uint8_t txBufferState;
   Dcm_OpStatusType opStatus;
   P2CONST(Dcm_ServiceType, AUTOMATIC, DCM_CONST) curService;
   Dcm_MsgContextType msgContext;
   uint8_t responsePending;
+} Dcm_ContextType;
+
+/* the session and security state shared by all the connections, a non default session or an
+ * unlocked security level is owned by the connection which has activated it */
+typedef struct {
+  uint16_t timerS3Server;
+  Dcm_SesCtrlType currentSession;
+#ifdef DCM_USE_SERVICE_SECURITY_ACCESS
+  Dcm_SecLevelType currentLevel;
+  Dcm_SecLevelType requestLevel;
+  uint16_t securityDelayTimer;
+#endif
+  uint8_t owner;  /* the connection which owns the session and security state */
+  uint8_t active; /* the connection whose request is being processed */
 #if defined(DCM_USE_SERVICE_REQUEST_DOWNLOAD) || defined(DCM_USE_SERVICE_REQUEST_UPLOAD)
   Dcm_UDTType UDTData;
 #endif
@@ -203,7 +245,7 @@ typedef struct {
 #ifdef DCM_USE_SECURITY_SEED_PROTECTION
   uint8_t cachedSeed[DCM_MAX_SEED_SIZE];
 #endif
-} Dcm_ContextType;
+} Dcm_ServerContextType;
 
 typedef struct {
   uint8_t sessionMask;
@@ -453,8 +495,14 @@ typedef struct {
 
 typedef struct {
   Dcm_OpStatusType opStatus;
-  uint16_t reload; /* timer reload value */
-  uint16_t timer;
+  uint8_t rate;   /* DCM_TM_SEND_AT_xxx_RATE, 0 if stopped */
+  uint8_t next;   /* the next DID of the same rate */
+  uint8_t qNext;  /* the next DID in the transmit queue */
+  boolean queued; /* in the transmit queue */
+  uint16_t numOfSent;
+  uint16_t numOfMissed; /* due again before it was sent, or its frame was not confirmed */
+  uint32_t firstTick;   /* the main function cycle of the first and the last sent */
+  uint32_t lastTick;
 } Dcm_ReadPeriodicDIDContextType;
 
 typedef struct {
@@ -465,6 +513,7 @@ typedef struct {
 typedef struct {
   P2CONST(Dcm_ReadPeriodicDIDType, AUTOMATIC, DCM_CONST) DIDs;
   uint8_t numOfDIDs;
+  PduIdType TxPduId; /* the UUDT PDU or DCM_PERIODIC_TX_PDU_INVALID */
 } Dcm_ReadPeriodicDIDConfigType;
 
 typedef struct {
@@ -548,8 +597,21 @@ typedef struct {
 typedef struct {
   PduIdType TxPduId;
   uint8_t reqType;
+  uint8_t connection; /* the index of the connection which serves this channel */
 } Dcm_ChannelType;
 
+/* the physical and functional channels of one tester share a connection */
+typedef struct {
+  Dcm_ContextType *context;
+  uint8_t *rxBuffer;
+  uint8_t *txBuffer;
+  PduLengthType rxBufferSize;
+  PduLengthType txBufferSize;
+  /* the protocol priority, a lower value is a higher priority. A request from a higher priority
+   * connection preempts the session owned by a lower priority connection. */
+  uint8_t priority;
+} Dcm_ConnectionType;
+
 /* @SWS_Dcm_00218, SWS_Dcm_00516*/
 typedef Std_ReturnType (*Dcm_ServiceVerificationFncType)(PduIdType RxPduId, uint8_t *payload,
                                                          PduLengthType length,
@@ -557,10 +619,8 @@ typedef Std_ReturnType (*Dcm_ServiceVerificationFncType)(PduIdType RxPduId, uint
 
 struct Dcm_Config_s {
   Dcm_ServiceVerificationFncType ServiceVerificationFnc;
-  uint8_t *rxBuffer;
-  uint8_t *txBuffer;
-  PduLengthType rxBufferSize;
-  PduLengthType txBufferSize;
+  P2CONST(Dcm_ConnectionType, DCM_CONST, DCM_CONST) connections;
+  uint8_t numOfConnections;
   P2CONST(Dcm_ChannelType, DCM_CONST, DCM_CONST) channles;
   uint8_t numOfChls;
   P2CONST(Dcm_ServiceTableType *const, DCM_CONST, DCM_CONST) serviceTables;
@@ -600,6 +660,10 @@ struct Dcm_Config_s {
 /* ================================ [ FUNCTIONS ] ============================================== */
 Dcm_ContextType *Dcm_GetContext(void);
 
+Dcm_ServerContextType *Dcm_GetServerContext(void);
+
+P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) Dcm_GetConnection(void);
+
 P2CONST(Dcm_ConfigType, AUTOMATIC, DCM_CONST) Dcm_GetConfig(void);
 
 void Dcm_DslProcessingDone(Dcm_ContextType *context,
@@ -658,8 +722,13 @@ Std_ReturnType Dem_DspReportSupportedDTC(Dcm_MsgContextType *msgContext,
 Std_ReturnType Dcm_DspIOControlByIdentifier(Dcm_MsgContextType *msgContext,
                                             Dcm_NegativeResponseCodeType *nrc);
 void Dcm_DslInit(void);
+void Dcm_DslInitConnection(Dcm_ContextType *context);
 void Dcm_DspInit(void);
 void Dcm_DslMainFunction(void);
+void Dcm_DslRestartS3Server(Dcm_ContextType *context);
+Std_ReturnType Dcm_DslArbitrate(Dcm_ContextType *context, uint8_t SID,
+                                Dcm_NegativeResponseCodeType *nrc);
+void Dcm_DslUpdateOwner(void);
 Std_ReturnType Dcm_DslIsSessionSupported(Dcm_SesCtrlType sesCtrl, uint8_t sesMask);
 Std_ReturnType Dcm_DslServiceSesSecPhyFuncCheck(Dcm_ContextType *context,
                                                 P2CONST(Dcm_SesSecAccessType, AUTOMATIC, DCM_CONST)
@@ -689,6 +758,7 @@ Std_ReturnType Dcm_DslSecurityAccessCompareKey(Dcm_MsgContextType *msgContext,
 void Dcm_ReadPeriodicDID_Init(void);
 void Dcm_MainFunction_ReadPeriodicDID(void);
 void Dcm_ReadPeriodicDID_OnSessionSecurityChange(void);
+void Dcm_ReadPeriodicDID_TxConfirmation(PduIdType TxPduId, Std_ReturnType result);
 Std_ReturnType Dcm_DspReadDataByPeriodicIdentifier(Dcm_MsgContextType *msgContext,
                                                    Dcm_NegativeResponseCodeType *nrc);
 
@@ -0,0 +1,339 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Two DoIP testers served by the Dcm in parallel: each tester is a Dcm connection with its own
+ * physical and functional channels, the DoIP layer is simulated by delivering every diagnostic
+ * message in one shot through the Dcm Tp API and by fetching the whole response when it is
+ * transmitted. The arbitration of the shared session is checked first, then one tester and both
+ * testers read a DID whose read function pends for some main cycles, like a read from an external
+ * EEPROM: every request must be accepted and answered with the data of its tester, and two testers
+ * must each get as many responses as one tester alone. The aggregate request throughput is printed
+ * in requests per second of the simulated main cycles, with the host time per main cycle.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Dcm.h"
+#include "Dcm_Cfg.h"
+#include "Dcm_Priv.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_CYCLES
+#define TEST_CYCLES 30000u
+#endif
+
+/* the main cycles the DID read functions pend for */
+#ifndef TEST_READ_CYCLES
+#define TEST_READ_CYCLES 2u
+#endif
+
+#define TEST_NUM_OF_TESTERS 2u
+#define TEST_TIMEOUT_CYCLES 1000u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  PduIdType RxPduId; /* the Dcm channel of the physical requests */
+  const uint8_t *req;
+  PduLengthType reqLen;
+  uint8_t res[256];
+  PduLengthType resLen;
+  PduLengthType txLen; /* the length given by PduR_DcmTransmit, 0 if nothing to transmit */
+  PduIdType TxPduId;
+  boolean bWaiting; /* a request is on the way */
+  boolean bResponse;
+  uint32_t requests;
+  uint32_t responses;
+  uint32_t pendings; /* the 0x78 response pending */
+  uint32_t busy;     /* the requests refused by the Dcm_StartOfReception */
+  uint32_t errors;   /* the responses without the data of the tester */
+} test_tester_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static test_tester_t test_testers[TEST_NUM_OF_TESTERS];
+
+static uint8_t test_readTimer[2];
+/* ================================ [ LOCALS    ] ============================================== */
+static test_tester_t *test_get_tester(PduIdType TxPduId) {
+  test_tester_t *tester = &test_testers[0];
+
+  if (TxPduId >= DCM_P2P_1_PDU) {
+    tester = &test_testers[1];
+  }
+
+  return tester;
+}
+
+static void test_reset(void) {
+  Dcm_Init(NULL);
+  memset(test_testers, 0, sizeof(test_testers));
+  test_testers[0].RxPduId = DCM_P2P_PDU;
+  test_testers[1].RxPduId = DCM_P2P_1_PDU;
+}
+
+static Std_ReturnType test_read_data(uint8_t index, Dcm_OpStatusType opStatus, uint8_t *data,
+                                     uint16_t length) {
+  Std_ReturnType r = E_OK;
+
+  if (DCM_INITIAL == opStatus) {
+    test_readTimer[index] = TEST_READ_CYCLES;
+  }
+
+  if (test_readTimer[index] > 0u) {
+    test_readTimer[index]--;
+    r = DCM_E_PENDING;
+  } else {
+    memset(data, 0xA0 + index, length);
+  }
+
+  return r;
+}
+
+static void test_send(test_tester_t *tester) {
+  BufReq_ReturnType ret;
+  PduInfoType info;
+  PduLengthType bufferSize;
+
+  info.SduDataPtr = (uint8_t *)tester->req;
+  info.SduLength = tester->reqLen;
+  info.MetaDataPtr = NULL;
+  ret = Dcm_StartOfReception(tester->RxPduId, &info, tester->reqLen, &bufferSize);
+  if (BUFREQ_OK == ret) {
+    ret = Dcm_CopyRxData(tester->RxPduId, &info, &bufferSize);
+    Dcm_TpRxIndication(tester->RxPduId, (BUFREQ_OK == ret) ? E_OK : E_NOT_OK);
+    tester->bWaiting = TRUE;
+    tester->bResponse = FALSE;
+    tester->requests++;
+  } else {
+    tester->busy++;
+  }
+}
+
+/* the DoIP layer copies the whole diagnostic message to the TCP socket at once */
+static void test_receive(test_tester_t *tester) {
+  PduInfoType info;
+  PduLengthType available;
+  BufReq_ReturnType ret;
+
+  if (tester->txLen > 0u) {
+    info.SduDataPtr = tester->res;
+    info.SduLength = tester->txLen;
+    info.MetaDataPtr = NULL;
+    tester->txLen = 0u;
+    ret = Dcm_CopyTxData(tester->TxPduId, &info, NULL, &available);
+    Dcm_TpTxConfirmation(tester->TxPduId, (BUFREQ_OK == ret) ? E_OK : E_NOT_OK);
+    if ((0x7Fu == tester->res[0]) && (DCM_E_RESPONSE_PENDING == tester->res[2])) {
+      tester->pendings++;
+    } else {
+      tester->resLen = info.SduLength;
+      tester->bWaiting = FALSE;
+      tester->bResponse = TRUE;
+      tester->responses++;
+    }
+  }
+}
+
+static void test_cycle(boolean bSend[TEST_NUM_OF_TESTERS]) {
+  uint8_t i;
+
+  for (i = 0u; i < TEST_NUM_OF_TESTERS; i++) {
+    if ((TRUE == bSend[i]) && (FALSE == test_testers[i].bWaiting)) {
+      test_send(&test_testers[i]);
+    }
+  }
+  Dcm_MainFunction();
+  for (i = 0u; i < TEST_NUM_OF_TESTERS; i++) {
+    test_receive(&test_testers[i]);
+  }
+}
+
+static void test_expect(uint8_t index, const uint8_t *req, PduLengthType reqLen,
+                        const uint8_t *res, PduLengthType resLen, const char *desc) {
+  test_tester_t *tester = &test_testers[index];
+  boolean bSend[TEST_NUM_OF_TESTERS] = {FALSE, FALSE};
+  uint32_t cycles;
+  bool bPass;
+
+  printf("Test tester%u %s:", index, desc);
+  tester->req = req;
+  tester->reqLen = reqLen;
+  bSend[index] = TRUE;
+  test_cycle(bSend);
+  bSend[index] = FALSE;
+  for (cycles = 0u; (FALSE == tester->bResponse) && (cycles < TEST_TIMEOUT_CYCLES); cycles++) {
+    test_cycle(bSend);
+  }
+
+  bPass = (TRUE == tester->bResponse) && (tester->resLen >= resLen) &&
+          (0 == memcmp(tester->res, res, resLen));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  response %02X %02X %02X, expected %02X %02X %02X\n", tester->res[0], tester->res[1],
+           tester->res[2], res[0], res[1], (resLen > 2u) ? res[2] : tester->res[2]);
+    exit(-1);
+  }
+}
+
+/* tester1 has the higher priority */
+static void Test_Arbitration(void) {
+  static const uint8_t reqExtended[] = {0x10, 0x03};
+  static const uint8_t resExtended[] = {0x50, 0x03};
+  static const uint8_t reqDefault[] = {0x10, 0x01};
+  static const uint8_t resDefault[] = {0x50, 0x01};
+  static const uint8_t resBusy[] = {0x7F, 0x10, DCM_E_BUSY_REPEAT_REQUEST};
+  static const uint8_t reqRead[] = {0x22, 0xF1, 0xA0};
+  static const uint8_t resRead[] = {0x62, 0xF1, 0xA0};
+  static const uint8_t resOutOfRange[] = {0x7F, 0x22, DCM_E_REQUEST_OUT_OF_RANGE};
+
+  test_reset();
+  test_expect(0, reqExtended, sizeof(reqExtended), resExtended, sizeof(resExtended),
+              "enters the extended session");
+  test_expect(1, reqRead, sizeof(reqRead), resOutOfRange, sizeof(resOutOfRange),
+              "reads the extended DID in the default session");
+  test_expect(0, reqRead, sizeof(reqRead), resRead, sizeof(resRead), "reads the extended DID");
+  test_expect(1, reqExtended, sizeof(reqExtended), resExtended, sizeof(resExtended),
+              "of higher priority preempts the extended session");
+  test_expect(0, reqExtended, sizeof(reqExtended), resBusy, sizeof(resBusy),
+              "enters the extended session of tester1");
+  test_expect(0, reqRead, sizeof(reqRead), resOutOfRange, sizeof(resOutOfRange),
+              "reads the extended DID in the default session");
+  test_expect(1, reqDefault, sizeof(reqDefault), resDefault, sizeof(resDefault),
+              "returns to the default session");
+  test_expect(0, reqExtended, sizeof(reqExtended), resExtended, sizeof(resExtended),
+              "enters the extended session");
+}
+
+static void Test_Throughput(uint8_t numOfTesters) {
+  static const uint8_t reqRead0[] = {0x22, 0xF1, 0x90};
+  static const uint8_t reqRead1[] = {0x22, 0xF1, 0x91};
+  boolean bSend[TEST_NUM_OF_TESTERS] = {FALSE, FALSE};
+  /* a request is received, read for TEST_READ_CYCLES and answered in the next cycle */
+  uint32_t responses = TEST_CYCLES / (TEST_READ_CYCLES + 1u) - 1u;
+  test_tester_t *tester;
+  uint32_t total = 0u;
+  uint32_t cycles;
+  std_time_t start;
+  std_time_t elapsed;
+  float seconds;
+  bool bPass = true;
+  uint8_t i;
+
+  printf("Test %u tester(s) reading DIDs pending for %u main cycles:", numOfTesters,
+         TEST_READ_CYCLES);
+  test_reset();
+  test_testers[0].req = reqRead0;
+  test_testers[0].reqLen = sizeof(reqRead0);
+  test_testers[1].req = reqRead1;
+  test_testers[1].reqLen = sizeof(reqRead1);
+  for (i = 0u; i < numOfTesters; i++) {
+    bSend[i] = TRUE;
+  }
+
+  start = Std_GetTime();
+  for (cycles = 0u; cycles < TEST_CYCLES; cycles++) {
+    test_cycle(bSend);
+    for (i = 0u; i < numOfTesters; i++) {
+      tester = &test_testers[i];
+      if (TRUE == tester->bResponse) {
+        tester->bResponse = FALSE;
+        if ((tester->resLen < 4u) || (0x62u != tester->res[0]) ||
+            (0 != memcmp(&tester->res[1], &tester->req[1], 2)) ||
+            ((0xA0u + i) != tester->res[3])) {
+          tester->errors++;
+        }
+      }
+    }
+  }
+  elapsed = Std_GetTime() - start;
+
+  for (i = 0u; i < numOfTesters; i++) {
+    tester = &test_testers[i];
+    total += tester->responses;
+    bPass = bPass && (tester->responses >= responses) && (0u == tester->busy) &&
+            (0u == tester->pendings) && (0u == tester->errors);
+  }
+  /* the testers share the Dcm main function, so the aggregate scales with the testers */
+  bPass = bPass && (total >= (numOfTesters * responses));
+  seconds = (float)TEST_CYCLES * DCM_MAIN_FUNCTION_PERIOD / 1000.0f;
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  printf("  %.1f requests/s in %.0f s of %u ms main cycles, %.2f us per main cycle\n",
+         total / seconds, seconds, DCM_MAIN_FUNCTION_PERIOD, (float)elapsed / TEST_CYCLES);
+  if (false == bPass) {
+    for (i = 0u; i < numOfTesters; i++) {
+      tester = &test_testers[i];
+      printf("  tester%u: requests=%u responses=%u/%u pendings=%u busy=%u errors=%u\n", i,
+             tester->requests, tester->responses, responses, tester->pendings, tester->busy,
+             tester->errors);
+    }
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+Std_ReturnType PduR_DcmTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  test_tester_t *tester = test_get_tester(TxPduId);
+
+  tester->TxPduId = TxPduId;
+  tester->txLen = PduInfoPtr->SduLength;
+
+  return E_OK;
+}
+
+void Dcm_SessionChangeIndication(Dcm_SesCtrlType sesCtrlTypeActive, Dcm_SesCtrlType sesCtrlTypeNew,
+                                 boolean timeout) {
+  (void)sesCtrlTypeActive;
+  (void)sesCtrlTypeNew;
+  (void)timeout;
+}
+
+Std_ReturnType Test_GetSessionChangePermission(Dcm_SesCtrlType sesCtrlTypeActive,
+                                               Dcm_SesCtrlType sesCtrlTypeNew,
+                                               Dcm_NegativeResponseCodeType *errorCode) {
+  (void)sesCtrlTypeActive;
+  (void)sesCtrlTypeNew;
+  (void)errorCode;
+  return E_OK;
+}
+
+Std_ReturnType Test_ReadTester0Data(Dcm_OpStatusType opStatus, uint8_t *data, uint16_t length,
+                                    Dcm_NegativeResponseCodeType *errorCode) {
+  (void)errorCode;
+  return test_read_data(0u, opStatus, data, length);
+}
+
+Std_ReturnType Test_ReadTester1Data(Dcm_OpStatusType opStatus, uint8_t *data, uint16_t length,
+                                    Dcm_NegativeResponseCodeType *errorCode) {
+  (void)errorCode;
+  return test_read_data(1u, opStatus, data, length);
+}
+
+Std_ReturnType Test_ReadExtendedData(Dcm_OpStatusType opStatus, uint8_t *data, uint16_t length,
+                                     Dcm_NegativeResponseCodeType *errorCode) {
+  (void)opStatus;
+  (void)errorCode;
+  memset(data, 0xEE, length);
+  return E_OK;
+}
+
+Std_ReturnType Test_GetExtendedLevelSeed(uint8_t *seed, Dcm_NegativeResponseCodeType *errorCode) {
+  (void)errorCode;
+  memset(seed, 0x5A, 4);
+  return E_OK;
+}
+
+Std_ReturnType Test_CompareExtendedLevelKey(const uint8_t *key,
+                                            Dcm_NegativeResponseCodeType *errorCode) {
+  (void)errorCode;
+  return (0xA5u == key[0]) ? E_OK : E_NOT_OK;
+}
+
+int main(int argc, char *argv[]) {
+  (void)argc;
+  (void)argv;
+
+  Test_Arbitration();
+  Test_Throughput(1u);
+  Test_Throughput(2u);
+
+  return 0;
+}
@@ -0,0 +1,441 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Test of the periodic DIDs sent as single frames [pDID, data] on the IF PDU: the bytes of the
+ * frames, the periods reached with a 10 ms main function when the bus takes 45 frames per cycle
+ * (8 bytes frames at 500 kbps) and the IF TxConfirmation, which frees the frames in flight when
+ * it is for the TxPduId of the periodic DIDs.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Dcm.h"
+#include "Dcm_Cfg.h"
+#include "Dcm_Priv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+/* the TxPduId of the read periodic DID service in Dcm.json */
+#define TEST_PERIODIC_TX_PDU 7u
+
+#define TEST_NUM_OF_DIDS 40u
+/* the last one needs two read calls */
+#define TEST_SLOW_DID TEST_NUM_OF_DIDS
+#define TEST_LARGE_DID 0x29u
+
+#define TEST_BUS_FRAMES_PER_CYCLE 45u
+#define TEST_MAX_FRAMES 1024u
+
+/* 4 s, within the S3 time of the extended session */
+#define TEST_CYCLES 400u
+#define TEST_TIMEOUT_CYCLES 100u
+
+#define TEST_READ_P(n)                                                                             \
+  Std_ReturnType Test_ReadP##n(Dcm_OpStatusType opStatus, uint8_t *data, uint16_t length,        \
+                               Dcm_NegativeResponseCodeType *errorCode) {                          \
+    return test_read(0x##n, opStatus, data, length, errorCode);                                    \
+  }
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint8_t data[8];
+  PduLengthType length;
+} test_frame_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static uint8_t test_res[256];
+static PduLengthType test_txLen;
+static PduIdType test_txPduId;
+static uint32_t test_numOfTpTx;
+
+static test_frame_t test_frames[TEST_MAX_FRAMES];
+static uint32_t test_numOfFrames;
+static uint32_t test_numOfUnconfirmed;
+static uint32_t test_budget;
+static bool test_badPdu;
+static bool test_confirm;
+
+static uint16_t test_samples[TEST_LARGE_DID + 1u];
+/* ================================ [ LOCALS    ] ============================================== */
+static Std_ReturnType test_read(uint8_t id, Dcm_OpStatusType opStatus, uint8_t *data,
+                                uint16_t length, Dcm_NegativeResponseCodeType *errorCode) {
+  Std_ReturnType r = E_OK;
+
+  (void)errorCode;
+  if ((TEST_SLOW_DID == id) && (DCM_INITIAL == opStatus)) {
+    r = DCM_E_PENDING;
+  } else {
+    /* the DID and the sample counter, big endian */
+    memset(data, 0, length);
+    data[0] = id;
+    data[length - 2u] = (uint8_t)(test_samples[id] >> 8);
+    data[length - 1u] = (uint8_t)test_samples[id];
+    test_samples[id]++;
+  }
+
+  return r;
+}
+
+/* the bus confirms the frames of the last cycle and takes the next ones */
+static void test_cycle(void) {
+  Dcm_MainFunction();
+  if (test_confirm) {
+    while (test_numOfUnconfirmed > 0u) {
+      test_numOfUnconfirmed--;
+      Dcm_TxConfirmation(DCM_PERIODIC_TX, E_OK);
+    }
+  }
+  test_budget = TEST_BUS_FRAMES_PER_CYCLE;
+}
+
+/* the request is received and its response is copied in one shot by the TP layer, the response
+ * starts with res, or there is none if res is NULL */
+static bool test_request(const uint8_t *req, PduLengthType reqLen, const uint8_t *res,
+                         PduLengthType resLen) {
+  BufReq_ReturnType ret;
+  PduInfoType info;
+  PduLengthType bufferSize;
+  uint32_t cycles;
+  bool bOk = false;
+
+  info.SduDataPtr = (uint8_t *)req;
+  info.SduLength = reqLen;
+  info.MetaDataPtr = NULL;
+  ret = Dcm_StartOfReception(DCM_P2P_PDU, &info, reqLen, &bufferSize);
+  if (BUFREQ_OK == ret) {
+    ret = Dcm_CopyRxData(DCM_P2P_PDU, &info, &bufferSize);
+    Dcm_TpRxIndication(DCM_P2P_PDU, (BUFREQ_OK == ret) ? E_OK : E_NOT_OK);
+    cycles = 0u;
+    do {
+      test_cycle();
+      cycles++;
+    } while ((0u == test_txLen) && (NULL != res) && (cycles < TEST_TIMEOUT_CYCLES));
+    if (NULL == res) {
+      bOk = (0u == test_txLen);
+    } else if (0u != test_txLen) {
+      info.SduDataPtr = test_res;
+      info.SduLength = test_txLen;
+      test_txLen = 0u;
+      ret = Dcm_CopyTxData(test_txPduId, &info, NULL, &bufferSize);
+      Dcm_TpTxConfirmation(test_txPduId, (BUFREQ_OK == ret) ? E_OK : E_NOT_OK);
+      bOk = (BUFREQ_OK == ret) && (info.SduLength >= resLen) &&
+            (0 == memcmp(test_res, res, resLen));
+    }
+  }
+
+  return bOk;
+}
+
+static void test_reset(void) {
+  static const uint8_t reqExtended[] = {0x10, 0x03};
+  static const uint8_t resExtended[] = {0x50, 0x03};
+
+  Dcm_Init(NULL);
+  memset(test_samples, 0, sizeof(test_samples));
+  test_numOfFrames = 0u;
+  test_numOfUnconfirmed = 0u;
+  test_numOfTpTx = 0u;
+  test_budget = TEST_BUS_FRAMES_PER_CYCLE;
+  test_badPdu = false;
+  test_confirm = true;
+  if (false == test_request(reqExtended, sizeof(reqExtended), resExtended, sizeof(resExtended))) {
+    printf("  failed to enter the extended session\n");
+    exit(-1);
+  }
+  test_numOfTpTx = 0u;
+}
+
+/* no positive response, the periodic DIDs follow */
+static bool test_start(uint8_t rate, uint8_t numOfDids) {
+  uint8_t req[2u + TEST_NUM_OF_DIDS];
+  uint8_t i;
+
+  req[0] = 0x2A;
+  req[1] = rate;
+  for (i = 0u; i < numOfDids; i++) {
+    req[2u + i] = i + 1u;
+  }
+
+  return test_request(req, 2u + numOfDids, NULL, 0u);
+}
+
+static void Test_Frames(void) {
+  uint32_t i;
+  uint16_t sample[3] = {0, 0, 0};
+  uint8_t id;
+  bool bPass;
+
+  printf("Test periodic DIDs sent as single frames on the IF PDU:");
+  test_reset();
+  bPass = test_start(DCM_TM_SEND_AT_FAST_RATE, 2u);
+  for (i = 0u; i < 10u; i++) {
+    test_cycle();
+  }
+  /* the first samples in the cycle of the request, then one of each DID every 10 ms */
+  bPass = bPass && ((2u * (1u + 10u)) == test_numOfFrames) && (false == test_badPdu) &&
+          (0u == test_numOfTpTx);
+  /* [pDID, the 4 bytes of the DID: pDID, 0, sample counter] */
+  for (i = 0u; (i < test_numOfFrames) && bPass; i++) {
+    id = test_frames[i].data[0];
+    bPass = ((1u == id) || (2u == id)) && (5u == test_frames[i].length) &&
+            (id == test_frames[i].data[1]) && (0u == test_frames[i].data[2]) &&
+            ((uint8_t)(sample[id] >> 8) == test_frames[i].data[3]) &&
+            ((uint8_t)sample[id] == test_frames[i].data[4]);
+    sample[id]++;
+  }
+  bPass = bPass && (sample[1] == sample[2]);
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u frames, %u TP transmits, bad PDU: %s\n", test_numOfFrames, test_numOfTpTx,
+           test_badPdu ? "yes" : "no");
+    exit(-1);
+  }
+}
+
+static void Test_Large(void) {
+  static const uint8_t req[] = {0x2A, DCM_TM_SEND_AT_FAST_RATE, TEST_LARGE_DID};
+  static const uint8_t res[] = {0x7F, 0x2A, DCM_E_REQUEST_OUT_OF_RANGE};
+  bool bPass;
+
+  printf("Test periodic DID larger than a single frame rejected:");
+  test_reset();
+  bPass = test_request(req, sizeof(req), res, sizeof(res));
+  test_cycle();
+  bPass = bPass && (0u == test_numOfFrames);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    exit(-1);
+  }
+}
+
+static void Test_Rate(void) {
+  uint32_t periodMs;
+  uint32_t sum = 0u;
+  uint16_t numOfMissed;
+  uint16_t missed = 0u;
+  uint32_t slowPeriodMs = 0u;
+  uint32_t i;
+  bool bPass;
+
+  printf("Test %u periodic DIDs at the fast rate with %u frames per cycle:", TEST_NUM_OF_DIDS,
+         TEST_BUS_FRAMES_PER_CYCLE);
+  test_reset();
+  bPass = test_start(DCM_TM_SEND_AT_FAST_RATE, TEST_NUM_OF_DIDS);
+  for (i = 0u; i < TEST_CYCLES; i++) {
+    test_cycle();
+  }
+
+  for (i = 1u; (i <= TEST_NUM_OF_DIDS) && bPass; i++) {
+    bPass = (E_OK == Dcm_GetPeriodicDIDRate((uint8_t)i, &periodMs, &numOfMissed));
+    sum += periodMs;
+    if (TEST_SLOW_DID == i) {
+      slowPeriodMs = periodMs;
+    } else {
+      /* each DID gets its frame in each cycle */
+      bPass = bPass && (DCM_TM_FAST_TIME_MS == periodMs) && (0u == numOfMissed);
+      missed += numOfMissed;
+    }
+  }
+  /* the slow DID is read on every second turn */
+  bPass = bPass && (2u * DCM_TM_FAST_TIME_MS == slowPeriodMs);
+  /* the average is 10.25 ms */
+  bPass = bPass && (((TEST_NUM_OF_DIDS + 1u) * DCM_TM_FAST_TIME_MS) == sum);
+  bPass = bPass && (false == test_badPdu) && (0u == test_numOfTpTx);
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  average period %.2f ms, slow DID %u ms, %u missed\n", (float)sum / TEST_NUM_OF_DIDS,
+           slowPeriodMs, missed);
+    exit(-1);
+  }
+}
+
+static void Test_TxConfirmation(void) {
+  static const uint8_t reqStop[] = {0x2A, DCM_TM_STOP_SENDING};
+  uint32_t timeoutCycles = DCM_CONVERT_MS_TO_MAIN_CYCLES(DCM_PERIODIC_TX_TIMEOUT_MS) + 1u;
+  uint32_t numOfFullCycles = 0u;
+  uint32_t numOfFrames;
+  uint32_t periodMs;
+  uint16_t numOfMissed;
+  uint32_t i;
+  bool bPass;
+
+  printf("Test periodic DID frames held until their TxConfirmation:");
+  test_reset();
+  test_confirm = false;
+  bPass = test_start(DCM_TM_SEND_AT_FAST_RATE, TEST_NUM_OF_DIDS - 1u);
+  /* without TxConfirmation not more than the frames in flight, until they time out */
+  for (i = 0u; (i < TEST_TIMEOUT_CYCLES) && (test_numOfFrames <= DCM_PERIODIC_MAX_TX_PENDING);
+       i++) {
+    if (DCM_PERIODIC_MAX_TX_PENDING == test_numOfFrames) {
+      numOfFullCycles++;
+    }
+    test_cycle();
+  }
+  bPass = bPass && (numOfFullCycles + 2u >= timeoutCycles) && (numOfFullCycles <= timeoutCycles);
+  /* then they are lost and the next ones are sent */
+  numOfFrames = test_numOfFrames;
+  bPass = bPass && (numOfFrames > DCM_PERIODIC_MAX_TX_PENDING);
+  bPass = bPass && (E_OK == Dcm_GetPeriodicDIDRate(1u, &periodMs, &numOfMissed)) &&
+          (numOfMissed > 0u);
+  /* the frames in flight are confirmed again, after one cycle each DID gets its frame again */
+  test_confirm = true;
+  test_numOfUnconfirmed = numOfFrames - DCM_PERIODIC_MAX_TX_PENDING;
+  test_cycle();
+  numOfFrames = test_numOfFrames;
+  for (i = 0u; i < 10u; i++) {
+    test_cycle();
+  }
+  bPass = bPass && (test_numOfFrames == numOfFrames + 10u * (TEST_NUM_OF_DIDS - 1u));
+  bPass = bPass && test_request(reqStop, sizeof(reqStop), NULL, 0u);
+  numOfFrames = test_numOfFrames;
+  for (i = 0u; i < 10u; i++) {
+    test_cycle();
+  }
+  bPass = bPass && (numOfFrames == test_numOfFrames) && (false == test_badPdu);
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u frames, %u cycles with all frames in flight\n", test_numOfFrames,
+           numOfFullCycles);
+    exit(-1);
+  }
+}
+/* the TxConfirmation of another IF PDU must not free the periodic DID frames in flight */
+static void Test_OtherTxConfirmation(void) {
+  uint32_t numOfFrames;
+  uint32_t i;
+  bool bPass;
+
+  printf("Test periodic DID frames kept on the TxConfirmation of another PDU:");
+  test_reset();
+  test_confirm = false;
+  bPass = test_start(DCM_TM_SEND_AT_FAST_RATE, TEST_NUM_OF_DIDS - 1u);
+  for (i = 0u; (i < 10u) && (test_numOfFrames < DCM_PERIODIC_MAX_TX_PENDING); i++) {
+    test_cycle();
+  }
+  numOfFrames = test_numOfFrames;
+  bPass = bPass && (DCM_PERIODIC_MAX_TX_PENDING == numOfFrames);
+  for (i = 0u; i < numOfFrames; i++) {
+    Dcm_TxConfirmation(DCM_PERIODIC_TX + 1u, E_OK);
+  }
+  test_cycle();
+  bPass = bPass && (numOfFrames == test_numOfFrames);
+  /* the right ones free them */
+  test_confirm = true;
+  test_cycle();
+  test_cycle();
+  bPass = bPass && (test_numOfFrames > numOfFrames) && (false == test_badPdu);
+
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u frames, %u before the TxConfirmations\n", test_numOfFrames, numOfFrames);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+TEST_READ_P(01)
+TEST_READ_P(02)
+TEST_READ_P(03)
+TEST_READ_P(04)
+TEST_READ_P(05)
+TEST_READ_P(06)
+TEST_READ_P(07)
+TEST_READ_P(08)
+TEST_READ_P(09)
+TEST_READ_P(0A)
+TEST_READ_P(0B)
+TEST_READ_P(0C)
+TEST_READ_P(0D)
+TEST_READ_P(0E)
+TEST_READ_P(0F)
+TEST_READ_P(10)
+TEST_READ_P(11)
+TEST_READ_P(12)
+TEST_READ_P(13)
+TEST_READ_P(14)
+TEST_READ_P(15)
+TEST_READ_P(16)
+TEST_READ_P(17)
+TEST_READ_P(18)
+TEST_READ_P(19)
+TEST_READ_P(1A)
+TEST_READ_P(1B)
+TEST_READ_P(1C)
+TEST_READ_P(1D)
+TEST_READ_P(1E)
+TEST_READ_P(1F)
+TEST_READ_P(20)
+TEST_READ_P(21)
+TEST_READ_P(22)
+TEST_READ_P(23)
+TEST_READ_P(24)
+TEST_READ_P(25)
+TEST_READ_P(26)
+TEST_READ_P(27)
+TEST_READ_P(28)
+
+Std_ReturnType Test_ReadLarge(Dcm_OpStatusType opStatus, uint8_t *data, uint16_t length,
+                              Dcm_NegativeResponseCodeType *errorCode) {
+  return test_read(TEST_LARGE_DID, opStatus, data, length, errorCode);
+}
+
+Std_ReturnType PduR_DcmTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  test_txPduId = TxPduId;
+  test_txLen = PduInfoPtr->SduLength;
+  test_numOfTpTx++;
+
+  return E_OK;
+}
+
+/* the frame is copied in the call, like CanIf_Transmit */
+Std_ReturnType PduR_DcmIfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  Std_ReturnType r = E_NOT_OK;
+
+  if ((TEST_PERIODIC_TX_PDU != TxPduId) || (PduInfoPtr->SduLength > 8u)) {
+    test_badPdu = true;
+  } else if (test_budget > 0u) {
+    test_budget--;
+    if (test_numOfFrames < TEST_MAX_FRAMES) {
+      memcpy(test_frames[test_numOfFrames].data, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+      test_frames[test_numOfFrames].length = PduInfoPtr->SduLength;
+    }
+    test_numOfFrames++;
+    test_numOfUnconfirmed++;
+    r = E_OK;
+  } else {
+    /* the bus is busy */
+  }
+
+  return r;
+}
+
+void Dcm_SessionChangeIndication(Dcm_SesCtrlType sesCtrlTypeActive, Dcm_SesCtrlType sesCtrlTypeNew,
+                                 boolean timeout) {
+  (void)sesCtrlTypeActive;
+  (void)sesCtrlTypeNew;
+  (void)timeout;
+}
+
+Std_ReturnType Test_GetSessionChangePermission(Dcm_SesCtrlType sesCtrlTypeActive,
+                                               Dcm_SesCtrlType sesCtrlTypeNew,
+                                               Dcm_NegativeResponseCodeType *errorCode) {
+  (void)sesCtrlTypeActive;
+  (void)sesCtrlTypeNew;
+  (void)errorCode;
+  return E_OK;
+}
+
+int main(int argc, char *argv[]) {
+  (void)argc;
+  (void)argv;
+
+  Test_Frames();
+  Test_Large();
+  Test_Rate();
+  Test_TxConfirmation();
+  Test_OtherTxConfirmation();
+
+  return 0;
+}
@@ -43,6 +43,15 @@
 #define Mirror_ExitCritical ExitCritical
 #endif
 
+/* orders the frame data against the ring indexes shared with the reporting context */
+#ifndef Mirror_MemoryBarrier
+#if defined(__GNUC__)
+#define Mirror_MemoryBarrier() __sync_synchronize()
+#else
+#define Mirror_MemoryBarrier()
+#endif
+#endif
+
 /* @SWS_Can_00416 */
 #ifndef CAN_EXTENDED_ID_TYPE
 #define CAN_EXTENDED_ID_TYPE ((Can_IdType)0x80000000u)
@@ -68,6 +77,12 @@ static void Mirror_InitSourceCan(NetworkHandleType network) {
   for (i = 0; i < ((uint16_t)config->NumStaticFilters + config->MaxDynamicFilters); i++) {
     config->CanFiltersStatus[i] = FALSE;
   }
+  if (NULL != config->Ring) {
+    config->Ring->context->in = 0;
+    config->Ring->context->out = 0;
+    config->Ring->context->lost = 0;
+    config->Ring->context->lostSeen = 0;
+  }
 }
 
 static void Mirror_InitSourceLin(NetworkHandleType network) {
@@ -331,13 +346,44 @@ Std_ReturnType Mirror_RemoveLinFilter(NetworkHandleType network, uint8 filterId)
 }
 
 #ifdef MIRROR_USE_DEST_CAN
+/* copy the payload to the DataElements from in, which are consecutive until the ring wraps */
+static void Mirror_RingCopyIn(const Mirror_RingBufferType *RingBuffer, const uint8_t *payload,
+                              uint8_t length) {
+  uint16_t index = RingBuffer->context->in % RingBuffer->NumOfDataElements;
+  uint16_t numPackets = ((uint16_t)length + 7u) >> 3;
+  uint16_t doSz = length;
+
+  if ((RingBuffer->NumOfDataElements - index) < numPackets) {
+    doSz = (RingBuffer->NumOfDataElements - index) * sizeof(Mirror_DataElementType);
+  }
+  (void)memcpy(RingBuffer->DataElements[index].data, payload, doSz);
+  if (doSz < length) {
+    (void)memcpy(RingBuffer->DataElements[0].data, &payload[doSz], length - doSz);
+  }
+  RingBuffer->context->in += numPackets;
+}
+
+static void Mirror_RingCopyOut(const Mirror_RingBufferType *RingBuffer, uint16_t *out,
+                               uint8_t *data, uint16_t length) {
+  uint16_t index = *out % RingBuffer->NumOfDataElements;
+  uint16_t numPackets = (length + 7u) >> 3;
+  uint16_t doSz = length;
+
+  if ((RingBuffer->NumOfDataElements - index) < numPackets) {
+    doSz = (RingBuffer->NumOfDataElements - index) * sizeof(Mirror_DataElementType);
+  }
+  (void)memcpy(data, RingBuffer->DataElements[index].data, doSz);
+  if (doSz < length) {
+    (void)memcpy(&data[doSz], RingBuffer->DataElements[0].data, length - doSz);
+  }
+  *out += numPackets;
+}
+
 static void Mirror_EnqueCanFrame(const Mirror_RingBufferType *RingBuffer, uint8_t NetworkId,
                                  Can_IdType canId, uint8_t length, const uint8_t *payload) {
   uint8_t numPackets = (length + 15) >> 3;
   uint16_t capability;
   Mirror_DataElementType *dataElement;
-  uint8_t offset = 0;
-  uint8_t doSz;
 
   Mirror_EnterCritical();
   if (RingBuffer->context->in >= RingBuffer->context->out) {
@@ -366,17 +412,7 @@ static void Mirror_EnqueCanFrame(const Mirror_RingBufferType *RingBuffer, uint8_
     dataElement->data[5] = (canId >> 16) & 0xFFu;
     dataElement->data[6] = (canId >> 8) & 0xFFu;
     dataElement->data[7] = canId & 0xFFu;
-    while (offset < length) {
-      dataElement =
-        &RingBuffer->DataElements[RingBuffer->context->in % RingBuffer->NumOfDataElements];
-      RingBuffer->context->in++;
-      doSz = length - offset;
-      if (doSz > 8) {
-        doSz = 8;
-      }
-      (void)memcpy(dataElement->data, &payload[offset], doSz);
-      offset += doSz;
-    }
+    Mirror_RingCopyIn(RingBuffer, payload, length);
     ASLOG(MIRROR, ("in = %u out = %u\n", RingBuffer->context->in, RingBuffer->context->out));
   } else {
     ASLOG(MIRRORE, ("No free space\n"));
@@ -399,7 +435,6 @@ static void Mirror_EnqueLinFrame(const Mirror_RingBufferType *RingBuffer, uint8_
   uint8_t numPackets;
   uint16_t capability;
   Mirror_DataElementType *dataElement;
-  uint8_t offset = 0;
   uint8_t doSz;
 
   if ((LIN_TX_OK == status) || (LIN_RX_OK == status)) {
@@ -429,17 +464,7 @@ static void Mirror_EnqueLinFrame(const Mirror_RingBufferType *RingBuffer, uint8_
     dataElement->data[4] = pid;
     dataElement->data[5] = status;
     if ((LIN_TX_OK == status) || (LIN_RX_OK == status)) {
-      while (offset < length) {
-        dataElement =
-          &RingBuffer->DataElements[RingBuffer->context->in % RingBuffer->NumOfDataElements];
-        RingBuffer->context->in++;
-        doSz = length - offset;
-        if (doSz > 8) {
-          doSz = 8;
-        }
-        (void)memcpy(dataElement->data, &payload[offset], doSz);
-        offset += doSz;
-      }
+      Mirror_RingCopyIn(RingBuffer, payload, length);
     }
     ASLOG(MIRROR, ("in = %u out = %u\n", RingBuffer->context->in, RingBuffer->context->out));
   } else {
@@ -457,12 +482,27 @@ static void Mirror_ReportLinFrameToDestCan(NetworkHandleType network, uint8_t co
 }
 #endif
 
-static void Mirror_GetHeaderTimestamp(uint8_t *Seconds, uint8_t *Nanoseconds) {
+/* age: how long ago in us the first frame of the buffer was reported */
+static void Mirror_GetHeaderTimestamp(uint8_t *Seconds, uint8_t *Nanoseconds, std_time_t age) {
 
   StbM_TimeTupleType timeTuple;
   StbM_UserDataType userData;
+  uint64_t seconds;
+  uint32_t nanoseconds;
 
   (void)StbM_GetCurrentTime(0, &timeTuple, &userData);
+  if (age > 0u) {
+    seconds = ((uint64_t)timeTuple.globalTime.secondsHi << 32) + timeTuple.globalTime.seconds;
+    nanoseconds = (uint32_t)(age % STD_TIMER_ONE_SECOND) * 1000u;
+    seconds -= age / STD_TIMER_ONE_SECOND;
+    if (timeTuple.globalTime.nanoseconds < nanoseconds) {
+      timeTuple.globalTime.nanoseconds += 1000000000u;
+      seconds--;
+    }
+    timeTuple.globalTime.nanoseconds -= nanoseconds;
+    timeTuple.globalTime.secondsHi = (uint32_t)(seconds >> 32);
+    timeTuple.globalTime.seconds = (uint32_t)seconds;
+  }
 
   Seconds[0] = (timeTuple.globalTime.secondsHi >> 8) & 0xFFu;
   Seconds[1] = timeTuple.globalTime.secondsHi & 0xFFu;
@@ -477,16 +517,38 @@ static void Mirror_GetHeaderTimestamp(uint8_t *Seconds, uint8_t *Nanoseconds) {
   Nanoseconds[3] = timeTuple.globalTime.nanoseconds & 0xFFu;
 }
 
+static void Mirror_IpOpenDestBuf(const Mirror_DestNetworkIpType *config,
+                                 const Mirror_DestBufferType *DestBuffer, std_time_t timestamp) {
+  std_time_t age;
+
+  /* @SWS_Mirror_00055 */
+  DestBuffer->data[0] = 1u; /* ProtocolVersion */
+  DestBuffer->data[1] = config->context->SequenceNumber;
+  Std_TimerStart(&config->context->timer);
+  age = config->context->timer.time - timestamp;
+  if (age > (STD_TIME_MAX >> 1)) {
+    age = 0;
+  }
+  /* frames from the source rings are older than the buffer, start it at the first one */
+  config->context->timer.time -= age;
+  Mirror_GetHeaderTimestamp(&DestBuffer->data[2], &DestBuffer->data[8], age);
+  *DestBuffer->offset = 14;
+  config->context->SequenceNumber++;
+  config->context->TxDeadlineTimer = config->MirrorDestTransmissionDeadline;
+}
+
 static void Mirror_IpAddCanFrameToDestBuf(const Mirror_DestNetworkIpType *config,
                                           const Mirror_DestBufferType *DestBuffer,
                                           uint8_t NetworkId, Can_IdType canId, uint8_t length,
-                                          const uint8_t *payload) {
+                                          const uint8_t *payload, std_time_t timestamp) {
   boolean bHasState = FALSE;
   uint8_t NetworkState = 0;
   uint16_t offset = *DestBuffer->offset;
-  std_time_t timestamp;
 
-  timestamp = Std_GetTimerElapsedTime(&config->context->timer);
+  timestamp = timestamp - config->context->timer.time;
+  if (timestamp > (STD_TIME_MAX >> 1)) {
+    timestamp = 0; /* reported before the buffer was opened by another frame */
+  }
   timestamp = timestamp / 10;
 
   /* timestamp 2 Byte */
@@ -531,30 +593,25 @@ static void Mirror_IpAddCanFrameToDestBuf(const Mirror_DestNetworkIpType *config
   *DestBuffer->offset = offset;
 }
 
-static void Mirror_ReportCanFrameToDestIp(NetworkHandleType network, uint8_t NetworkId,
-                                          Can_IdType canId, uint8_t length,
-                                          const uint8_t *payload) {
+/* called within the critical section, E_NOT_OK if all the dest buffers are full */
+static Std_ReturnType Mirror_IpAddCanFrame(const Mirror_DestNetworkIpType *config,
+                                           uint8_t NetworkId, Can_IdType canId, uint8_t length,
+                                           const uint8_t *payload, std_time_t timestamp) {
+  Std_ReturnType ret = E_NOT_OK;
   boolean bMoveToNextDestBuf = FALSE;
-  const Mirror_DestNetworkIpType *config = &MIRROR_CONFIG->DestNetworkIps[network];
   const Mirror_DestBufferType *DestBuffer;
   uint8_t used;
   do {
     bMoveToNextDestBuf = FALSE;
-    Mirror_EnterCritical();
     DestBuffer = &config->DestBuffers[config->context->in % config->NumDestBuffers];
     if (0 == *DestBuffer->offset) { /* start of the dest buffer */
-      /* @SWS_Mirror_00055 */
-      DestBuffer->data[0] = 1u; /* ProtocolVersion */
-      DestBuffer->data[1] = config->context->SequenceNumber;
-      Std_TimerStart(&config->context->timer);
-      Mirror_GetHeaderTimestamp(&DestBuffer->data[2], &DestBuffer->data[8]);
-      *DestBuffer->offset = 14;
-      config->context->SequenceNumber++;
-      config->context->TxDeadlineTimer = config->MirrorDestTransmissionDeadline;
+      Mirror_IpOpenDestBuf(config, DestBuffer, timestamp);
     }
 
     if ((*DestBuffer->offset + 10u + length) <= DestBuffer->size) { /* space enough */
-      Mirror_IpAddCanFrameToDestBuf(config, DestBuffer, NetworkId, canId, length, payload);
+      Mirror_IpAddCanFrameToDestBuf(config, DestBuffer, NetworkId, canId, length, payload,
+                                    timestamp);
+      ret = E_OK;
     } else {
       ASLOG(MIRROR, ("DestBuffer %u full\n", config->context->in));
       config->context->in++;
@@ -566,13 +623,95 @@ static void Mirror_ReportCanFrameToDestIp(NetworkHandleType network, uint8_t Net
       if (used < config->NumDestBuffers) {
         bMoveToNextDestBuf = TRUE;
       } else {
-        ASLOG(MIRRORE, ("No Free DestBuffer\n"));
-        config->context->bFrameLost = TRUE; /* SWS_Mirror_00113 */
-        config->context->in--;              /* rollback */
+        config->context->in--; /* rollback */
       }
     }
-    Mirror_ExitCritical();
   } while (TRUE == bMoveToNextDestBuf);
+
+  return ret;
+}
+
+static void Mirror_ReportCanFrameToDestIp(NetworkHandleType network, uint8_t NetworkId,
+                                          Can_IdType canId, uint8_t length,
+                                          const uint8_t *payload) {
+  const Mirror_DestNetworkIpType *config = &MIRROR_CONFIG->DestNetworkIps[network];
+  Std_ReturnType ret;
+
+  Mirror_EnterCritical();
+  ret = Mirror_IpAddCanFrame(config, NetworkId, canId, length, payload, Std_GetTime());
+  if (E_OK != ret) {
+    ASLOG(MIRRORE, ("No Free DestBuffer\n"));
+    config->context->bFrameLost = TRUE; /* SWS_Mirror_00113 */
+  }
+  Mirror_ExitCritical();
+}
+
+/* lock free as only the reporting context of this controller writes in */
+static void Mirror_EnqueSourceCanFrame(const Mirror_SourceCanRingType *Ring, Can_IdType canId,
+                                       uint8_t length, const uint8_t *payload) {
+  Mirror_SourceRingContextType *context = Ring->context;
+  uint16_t in = context->in;
+  Mirror_CanFrameType *frame;
+
+  if (((uint16_t)(in - context->out) < Ring->NumOfFrames) && (length <= sizeof(frame->data))) {
+    frame = &Ring->Frames[in & (Ring->NumOfFrames - 1u)];
+    frame->timestamp = Std_GetTime();
+    frame->canId = canId;
+    frame->length = length;
+    (void)memcpy(frame->data, payload, length);
+    Mirror_MemoryBarrier(); /* the frame is complete before it gets visible */
+    context->in = in + 1u;
+  } else {
+    context->lost++;
+  }
+}
+
+/* move the frames of all the source rings to the dest buffers, the frames stay in the ring if
+ * no dest buffer is free so that the reporting context sees the ring full and reports the loss,
+ * return TRUE if any frame is left in the rings */
+static boolean Mirror_IpPackSourceRings(const Mirror_DestNetworkIpType *config) {
+  const Mirror_SourceNetworkCanType *source;
+  const Mirror_SourceCanRingType *Ring;
+  const Mirror_CanFrameType *frame;
+  NetworkHandleType network;
+  Std_ReturnType ret;
+  uint16_t in;
+  uint16_t out;
+  uint16_t lost;
+  boolean bPending = FALSE;
+
+  for (network = 0u; network < MIRROR_CONFIG->NumOfSourceNetworkCans; network++) {
+    source = &MIRROR_CONFIG->SourceNetworkCans[network];
+    Ring = source->Ring;
+    if ((NULL != Ring) && (Ring->context->in != Ring->context->out)) {
+      in = Ring->context->in;
+      Mirror_MemoryBarrier(); /* the frames before in are complete */
+      out = Ring->context->out;
+      ret = E_OK;
+      Mirror_EnterCritical();
+      lost = Ring->context->lost;
+      if (lost != Ring->context->lostSeen) {
+        Ring->context->lostSeen = lost;
+        config->context->bFrameLost = TRUE; /* SWS_Mirror_00113 */
+      }
+      while ((out != in) && (E_OK == ret)) {
+        frame = &Ring->Frames[out & (Ring->NumOfFrames - 1u)];
+        ret = Mirror_IpAddCanFrame(config, source->NetworkId, frame->canId, frame->length,
+                                   frame->data, frame->timestamp);
+        if (E_OK == ret) {
+          out++;
+        }
+      }
+      Mirror_ExitCritical();
+      Mirror_MemoryBarrier(); /* done with the frames before the slots are given back */
+      Ring->context->out = out;
+      if (out != in) {
+        bPending = TRUE;
+      }
+    }
+  }
+
+  return bPending;
 }
 
 static void Mirror_IpAddCanStateToDestBuf(const Mirror_DestNetworkIpType *config,
@@ -611,7 +750,7 @@ static void Mirror_ReportCanStateToDestIp(NetworkHandleType network, uint8_t Net
       DestBuffer->data[0] = 1u; /* ProtocolVersion */
       DestBuffer->data[1] = config->context->SequenceNumber;
       Std_TimerStart(&config->context->timer);
-      Mirror_GetHeaderTimestamp(&DestBuffer->data[2], &DestBuffer->data[8]);
+      Mirror_GetHeaderTimestamp(&DestBuffer->data[2], &DestBuffer->data[8], 0);
       *DestBuffer->offset = 14;
       config->context->SequenceNumber++;
       config->context->TxDeadlineTimer = config->MirrorDestTransmissionDeadline;
@@ -755,7 +894,7 @@ static void Mirror_ReportLinFrameToDestIp(NetworkHandleType network, uint8_t con
       DestBuffer->data[0] = 1u; /* ProtocolVersion */
       DestBuffer->data[1] = config->context->SequenceNumber;
       Std_TimerStart(&config->context->timer);
-      Mirror_GetHeaderTimestamp(&DestBuffer->data[2], &DestBuffer->data[8]);
+      Mirror_GetHeaderTimestamp(&DestBuffer->data[2], &DestBuffer->data[8], 0);
       *DestBuffer->offset = 14;
       config->context->SequenceNumber++;
       config->context->TxDeadlineTimer = config->MirrorDestTransmissionDeadline;
@@ -843,8 +982,6 @@ static void Mirror_MainFunctionDestCan(NetworkHandleType network) {
   uint32_t canid;
   uint8_t data[64]; /* 64 for CanFd */
   const Mirror_RingBufferType *RingBuffer = config->RingBuffer;
-  uint8_t offset = 0;
-  uint8_t doSz;
   boolean bStatusFrame = FALSE;
   uint16_t out = RingBuffer->context->out;
 
@@ -895,17 +1032,8 @@ static void Mirror_MainFunctionDestCan(NetworkHandleType network) {
     }
   }
 
-  if ((PduInfo.SduLength > 0) && (FALSE != bStatusFrame)) {
-    while (offset < PduInfo.SduLength) {
-      doSz = PduInfo.SduLength - offset;
-      if (doSz > 8) {
-        doSz = 8;
-      }
-      DataElement = &RingBuffer->DataElements[out % RingBuffer->NumOfDataElements];
-      out++;
-      (void)memcpy(&data[offset], DataElement->data, doSz);
-      offset += doSz;
-    }
+  if ((PduInfo.SduLength > 0) && (FALSE == bStatusFrame)) {
+    Mirror_RingCopyOut(RingBuffer, &out, data, PduInfo.SduLength);
   }
 
   if (PduInfo.SduLength > 0) {
@@ -919,41 +1047,26 @@ static void Mirror_MainFunctionDestCan(NetworkHandleType network) {
 }
 #endif /* MIRROR_USE_DEST_CAN */
 
-static void Mirror_MainFunctionDestIp(NetworkHandleType network) {
-  const Mirror_DestNetworkIpType *config = &MIRROR_CONFIG->DestNetworkIps[network];
+/* send all the ready buffers, stop at the first failure and re-try it next time */
+static uint8_t Mirror_IpTransmitReadyBuffers(const Mirror_DestNetworkIpType *config,
+                                             boolean bLinkedUp) {
 #ifdef USE_SOAD
   Std_ReturnType ret;
 #endif
   PduInfoType PduInfo;
-  const Mirror_DestBufferType *DestBuffer = NULL;
-  boolean bLinkedUp = TcpIp_IsLinkedUp();
-
-  PduInfo.SduLength = 0;
-
-  if ((config->context->TxDeadlineTimer > 0) && (TRUE == bLinkedUp)) {
-    config->context->TxDeadlineTimer--;
-    if (0 == config->context->TxDeadlineTimer) {
-      Mirror_EnterCritical();
-      DestBuffer = &config->DestBuffers[config->context->in % config->NumDestBuffers];
-      if (*DestBuffer->offset > 0) {
-        config->context->in++; /* trigger transmit */
-        ASLOG(MIRROR, ("Tx Deadline timeout, tx %u\n", config->context->out));
-      }
-      Mirror_ExitCritical();
-    }
-  }
+  const Mirror_DestBufferType *DestBuffer;
+  boolean bSent = TRUE;
+  uint8_t numOfSent = 0;
 
-  if ((config->context->in != config->context->out) &&
-      (TRUE == bLinkedUp)) { /* @SWS_Mirror_00055 */
+  while ((config->context->in != config->context->out) && (TRUE == bLinkedUp) &&
+         (TRUE == bSent)) { /* @SWS_Mirror_00055 */
     DestBuffer = &config->DestBuffers[config->context->out % config->NumDestBuffers];
     PduInfo.MetaDataPtr = NULL;
     PduInfo.SduDataPtr = DestBuffer->data;
     PduInfo.SduLength = *DestBuffer->offset;
     PduInfo.SduDataPtr[12] = ((PduInfo.SduLength - 14u) >> 8) & 0xFFu;
     PduInfo.SduDataPtr[13] = (PduInfo.SduLength - 14u) & 0xFFu;
-  }
 
-  if (PduInfo.SduLength > 0) {
     ASHEXDUMP(MIRROR, ("UDP Tx:"), PduInfo.SduDataPtr, PduInfo.SduLength);
 #ifdef USE_SOAD
     ret = SoAd_IfTransmit(config->TxPduId, &PduInfo);
@@ -967,12 +1080,49 @@ static void Mirror_MainFunctionDestIp(NetworkHandleType network) {
       /* just cancel it according to SWS_Mirror_00150 maybe not good, do re-try next times */
 #endif
       ASLOG(MIRRORE, ("Failed to send ip packet\n"));
+      bSent = FALSE;
     } else {
+      Mirror_EnterCritical();
       *DestBuffer->offset = 0;
       config->context->out++;
+      Mirror_ExitCritical();
+      numOfSent++;
     }
+#else
+    bSent = FALSE;
 #endif
   }
+
+  return numOfSent;
+}
+
+static void Mirror_MainFunctionDestIp(NetworkHandleType network) {
+  const Mirror_DestNetworkIpType *config = &MIRROR_CONFIG->DestNetworkIps[network];
+  const Mirror_DestBufferType *DestBuffer = NULL;
+  boolean bLinkedUp = TcpIp_IsLinkedUp();
+  boolean bPending;
+  uint8_t numOfSent;
+
+  (void)Mirror_IpPackSourceRings(config);
+
+  if ((config->context->TxDeadlineTimer > 0) && (TRUE == bLinkedUp)) {
+    config->context->TxDeadlineTimer--;
+    if (0 == config->context->TxDeadlineTimer) {
+      Mirror_EnterCritical();
+      DestBuffer = &config->DestBuffers[config->context->in % config->NumDestBuffers];
+      if (*DestBuffer->offset > 0) {
+        config->context->in++; /* trigger transmit */
+        ASLOG(MIRROR, ("Tx Deadline timeout, tx %u\n", config->context->out));
+      }
+      Mirror_ExitCritical();
+    }
+  }
+
+  do {
+    /* the ready buffers are sent to make room for the frames left in the source rings */
+    numOfSent = Mirror_IpTransmitReadyBuffers(config, bLinkedUp);
+    bPending = (numOfSent > 0u) ? Mirror_IpPackSourceRings(config) : FALSE;
+  } while (TRUE == bPending);
 }
 /* ================================ [ FUNCTIONS ] ============================================== */
 void Mirror_Init(const Mirror_ConfigType *configPtr) {
@@ -1194,9 +1344,13 @@ void Mirror_ReportCanFrame(uint8_t controllerId, Can_IdType canId, uint8_t lengt
 #endif
       if (MIRROR_CONFIG->ComChannelMaps[Mirror_Context.ActiveDestNetwork].NetworkType ==
           (MIRROR_NT_ETHERNET | MIRROR_NT_DEST)) {
-      Mirror_ReportCanFrameToDestIp(
-        MIRROR_CONFIG->ComChannelMaps[Mirror_Context.ActiveDestNetwork].NetworkId,
-        config->NetworkId, canId, length, payload);
+      if (NULL != config->Ring) {
+        Mirror_EnqueSourceCanFrame(config->Ring, canId, length, payload);
+      } else {
+        Mirror_ReportCanFrameToDestIp(
+          MIRROR_CONFIG->ComChannelMaps[Mirror_Context.ActiveDestNetwork].NetworkId,
+          config->NetworkId, canId, length, payload);
+      }
     } else {
       /* do nothing */
       ASLOG(MIRROR, ("drop as ActiveDestNetwork=%u\n", Mirror_Context.ActiveDestNetwork));
@@ -1540,9 +1694,12 @@ void Mirror_GetVersionInfo(Std_VersionInfoType *versionInfo) {
   versionInfo->moduleID = MODULE_ID_MIRROR;
   versionInfo->sw_major_version = 4;
   versionInfo->sw_minor_version = 0;
-  versionInfo->sw_patch_version = 1;
+  versionInfo->sw_patch_version = 2;
 }
 
 /** @brief release notes
  * - 4.0.1: Fixed typo and corrected capability check for next buffer switch.
+ * - 4.0.2: Optional per source CAN frame ring packed to the IP dest buffers by the main function,
+ *          all the ready IP dest buffers are sent per main function, bulk copy of the dest CAN
+ *          ring and fixed the payload of the dest CAN frames not being copied.
  */
@@ -85,6 +85,29 @@ typedef struct {
   boolean bStarted;
 } Mirror_SourceNetworkCanContextType;
 
+/* a whole CAN frame as reported, queued for the packer of the IP destination */
+typedef struct {
+  std_time_t timestamp; /* Std_GetTime() when reported */
+  Can_IdType canId;
+  uint8_t length;
+  uint8_t data[64];
+} Mirror_CanFrameType;
+
+/* single producer (the reporting context of the controller) and single consumer (the main
+ * function), the producer only writes in and lost, the consumer only writes out and lostSeen */
+typedef struct {
+  volatile uint16_t in;
+  volatile uint16_t out;
+  volatile uint16_t lost;
+  uint16_t lostSeen;
+} Mirror_SourceRingContextType;
+
+typedef struct {
+  Mirror_SourceRingContextType *context;
+  Mirror_CanFrameType *Frames;
+  uint16_t NumOfFrames; /* must be power of 2 */
+} Mirror_SourceCanRingType;
+
 typedef struct { /* @ECUC_Mirror_00010 */
   const Mirror_SourceCanFilterType *StaticFilters;
   Mirror_SourceCanFilterType *DynamicFilters;
@@ -92,6 +115,8 @@ typedef struct { /* @ECUC_Mirror_00010 */
   const Mirror_SourceCanMaskBasedIdMappingType *MaskBasedIdMappings;
   const Mirror_SourceCanSingleIdMappingType *SingleIdMappings;
   boolean *CanFiltersStatus; /* size = MaxDynamicFilters + NumStaticFilters */
+  /* NULL: the frames are added to the IP destination buffer by the reporting context */
+  const Mirror_SourceCanRingType *Ring;
   uint16_t NumMaskBasedIdMappings;
   uint16_t NumSingleIdMappings;
   uint8_t NumStaticFilters;
@@ -0,0 +1,32 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Mirror config of the mirror benchmark, the networks are set up by mirror_bench.c
+ */
+#ifndef MIRROR_CFG_H
+#define MIRROR_CFG_H
+/* ================================ [ INCLUDES  ] ============================================== */
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef MIRROR_MAIN_FUNCTION_PERIOD
+#define MIRROR_MAIN_FUNCTION_PERIOD 1u
+#endif
+#define MIRROR_CONVERT_MS_TO_MAIN_CYCLES(x)                                                        \
+  (((x) + MIRROR_MAIN_FUNCTION_PERIOD - 1u) / MIRROR_MAIN_FUNCTION_PERIOD)
+
+/* Source Network CAN IDs */
+#define MIRROR_USE_SOURCE_CAN
+#define MIRROR_SRC_NT_CAN_CAN0 0u
+#define MIRROR_SRC_NT_CAN_CAN1 1u
+
+/* Dest Network IP IDs */
+#define MIRROR_USE_DEST_IP
+#define MIRROR_DST_NT_IP_AS 2u
+
+// #define MIRROR_USE_PB_CONFIG
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* MIRROR_CFG_H */
@@ -0,0 +1,398 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Mirror of 2 CAN FD buses to the IP destination, with the 64 bytes frames reported directly to
+ * the dest buffers and through the per source rings. The frames carry a sequence counter which
+ * the SoAd stub checks: within the capacity no frame may be lost, beyond it the frames must stay
+ * in order and every loss must be flagged. At last one thread per bus reports frames while the
+ * main thread runs Mirror_MainFunction every 1ms, which must keep the same invariants.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Mirror.h"
+#include "Mirror_Cfg.h"
+#include "Mirror_Priv.h"
+#include "SoAd.h"
+#include "TcpIp.h"
+#include "Std_Critical.h"
+#include "Std_Timer.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#define TEST_BUSES 2u
+#define TEST_RING_SIZE 256u
+#define TEST_DEST_BUFFERS 8u
+#define TEST_DEST_BUFFER_SIZE 1400u
+#define TEST_FRAME_LENGTH 64u
+
+/* frames per bus reported between 2 main functions */
+#define TEST_FRAMES_PER_CYCLE 32u
+#define TEST_OVERLOAD_FRAMES_PER_CYCLE 400u
+#define TEST_CYCLES 200u
+
+#ifndef TEST_CONCURRENT_MS
+#define TEST_CONCURRENT_MS 500u
+#endif
+#define TEST_CONCURRENT_RATE 16000u /* frames per second per bus */
+
+#define TEST_NT_STATE_AVAIABLE 0x80u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t rate; /* frames per second */
+  uint32_t reported;
+  uint8_t controllerId;
+} test_producer_t;
+
+typedef struct {
+  uint32_t next; /* the next expected sequence counter */
+  uint32_t received;
+  uint32_t gaps;
+  uint32_t disorders; /* frames older than the last one received */
+} test_bus_stats_t;
+/* ================================ [ DECLARES  ] ============================================== */
+extern const Mirror_ConfigType Mirror_Config;
+/* ================================ [ DATAS     ] ============================================== */
+static pthread_mutex_t testLock;
+static volatile int testRunning;
+static test_bus_stats_t testStats[TEST_BUSES];
+static uint32_t testPackets;
+static uint32_t testLostFlags;
+
+static Mirror_CanFrameType testRingFrames[TEST_BUSES][TEST_RING_SIZE];
+static Mirror_SourceRingContextType testRingContexts[TEST_BUSES];
+static const Mirror_SourceCanRingType testRings[TEST_BUSES] = {
+  {&testRingContexts[0], testRingFrames[0], TEST_RING_SIZE},
+  {&testRingContexts[1], testRingFrames[1], TEST_RING_SIZE},
+};
+
+static boolean testFilterStatus[TEST_BUSES][1];
+static Mirror_SourceNetworkCanContextType testSourceContexts[TEST_BUSES];
+/* the Ring is switched by the test between the runs */
+static Mirror_SourceNetworkCanType testSourceNetworkCans[TEST_BUSES] = {
+  {NULL, NULL, &testSourceContexts[0], NULL, NULL, testFilterStatus[0], NULL, 0, 0, 0, 0, 0, 1},
+  {NULL, NULL, &testSourceContexts[1], NULL, NULL, testFilterStatus[1], NULL, 0, 0, 0, 0, 1, 2},
+};
+
+static uint8_t testDestBufferData[TEST_DEST_BUFFERS][TEST_DEST_BUFFER_SIZE];
+static uint16_t testDestBufferOffset[TEST_DEST_BUFFERS];
+static const Mirror_DestBufferType testDestBuffers[TEST_DEST_BUFFERS] = {
+  {testDestBufferData[0], &testDestBufferOffset[0], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[1], &testDestBufferOffset[1], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[2], &testDestBufferOffset[2], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[3], &testDestBufferOffset[3], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[4], &testDestBufferOffset[4], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[5], &testDestBufferOffset[5], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[6], &testDestBufferOffset[6], TEST_DEST_BUFFER_SIZE},
+  {testDestBufferData[7], &testDestBufferOffset[7], TEST_DEST_BUFFER_SIZE},
+};
+
+static Mirror_DestNetworkIpContextType testDestIpContext;
+static const Mirror_DestNetworkIpType testDestNetworkIps[] = {
+  {
+    &testDestIpContext,
+    testDestBuffers,
+    MIRROR_CONVERT_MS_TO_MAIN_CYCLES(10u), /* MirrorDestTransmissionDeadline */
+    0,                                     /* TxPduId */
+    TEST_DEST_BUFFERS,                    /* NumDestBuffers */
+  },
+};
+
+static const NetworkHandleType CanCtrlIdToNetworkMaps[] = {
+  0u, /* ControllerId = 0 -> MIRROR_SRC_NT_CAN_CAN0 */
+  1u, /* ControllerId = 1 -> MIRROR_SRC_NT_CAN_CAN1 */
+};
+
+static const Mirror_ComMChannelMapType Mirror_ComChannelMaps[] = {
+  {/* MIRROR_SRC_NT_CAN_CAN0 */ 0u, MIRROR_NT_CAN},
+  {/* MIRROR_SRC_NT_CAN_CAN1 */ 1u, MIRROR_NT_CAN},
+  {/* MIRROR_DST_NT_IP_AS */ 0u, MIRROR_NT_ETHERNET | MIRROR_NT_DEST},
+};
+
+const Mirror_ConfigType Mirror_Config = {
+  testSourceNetworkCans,
+  NULL, /* SourceNetworkLins */
+  NULL, /* DestNetworkCans */
+  testDestNetworkIps,
+  CanCtrlIdToNetworkMaps,
+  NULL, /* LinCtrlIdToNetworkMaps */
+  Mirror_ComChannelMaps,
+  TEST_BUSES, /* NumOfSourceNetworkCans */
+  0u,          /* NumOfSourceNetworkLins */
+  0u,          /* NumOfDestNetworkCans */
+  1u,          /* NumOfDestNetworkIps */
+  ARRAY_SIZE(CanCtrlIdToNetworkMaps),
+  0, /* SizeOfLinCtrlIdToNetworkMaps */
+  ARRAY_SIZE(Mirror_ComChannelMaps),
+};
+
+static uint32_t testReported[TEST_BUSES];
+/* ================================ [ LOCALS    ] ============================================== */
+static void test_report(uint8_t controllerId, uint32_t seq) {
+  uint8_t payload[TEST_FRAME_LENGTH];
+
+  memset(payload, controllerId, sizeof(payload));
+  payload[0] = (uint8_t)(seq >> 24);
+  payload[1] = (uint8_t)(seq >> 16);
+  payload[2] = (uint8_t)(seq >> 8);
+  payload[3] = (uint8_t)seq;
+  Mirror_ReportCanFrame(controllerId, 0x100u + controllerId, TEST_FRAME_LENGTH, payload);
+}
+
+static void test_start(boolean useRing) {
+  uint32_t i;
+
+  for (i = 0; i < TEST_BUSES; i++) {
+    testSourceNetworkCans[i].Ring = (TRUE == useRing) ? &testRings[i] : NULL;
+  }
+  memset(testStats, 0, sizeof(testStats));
+  memset(testReported, 0, sizeof(testReported));
+  testPackets = 0;
+  testLostFlags = 0;
+  Mirror_Init(NULL);
+  (void)Mirror_SwitchDestNetwork(MIRROR_DST_NT_IP_AS); /* resets the sources if switched */
+  (void)Mirror_StartSourceNetwork(MIRROR_SRC_NT_CAN_CAN0);
+  (void)Mirror_StartSourceNetwork(MIRROR_SRC_NT_CAN_CAN1);
+}
+
+/* flush what is left in the rings and the dest buffers */
+static void test_flush(void) {
+  uint32_t i;
+
+  for (i = 0; i < MIRROR_CONVERT_MS_TO_MAIN_CYCLES(20u); i++) {
+    Mirror_MainFunction();
+  }
+}
+
+static void test_run_cycles(uint32_t framesPerCycle) {
+  uint32_t cycle, i, bus;
+
+  for (cycle = 0; cycle < TEST_CYCLES; cycle++) {
+    for (i = 0; i < framesPerCycle; i++) {
+      for (bus = 0; bus < TEST_BUSES; bus++) {
+        test_report((uint8_t)bus, testReported[bus]);
+        testReported[bus]++;
+      }
+    }
+    Mirror_MainFunction();
+  }
+  test_flush();
+}
+
+static void test_print(void) {
+  uint32_t bus;
+
+  for (bus = 0; bus < TEST_BUSES; bus++) {
+    printf("  bus %u: reported %u, received %u, %u gaps, %u disorders\n", bus, testReported[bus],
+           testStats[bus].received, testStats[bus].gaps, testStats[bus].disorders);
+  }
+  printf("  %u packets, %u lost flags\n", testPackets, testLostFlags);
+}
+
+/* the frames are in order and if any is lost, the loss is flagged */
+static bool test_is_ordered(void) {
+  uint32_t bus;
+  uint32_t gaps = 0;
+  bool r = true;
+
+  for (bus = 0; bus < TEST_BUSES; bus++) {
+    gaps += testStats[bus].gaps;
+    r = r && (0u == testStats[bus].disorders) && (testStats[bus].received <= testReported[bus]);
+  }
+
+  return r && ((0u == gaps) || (testLostFlags > 0u));
+}
+
+static bool test_is_lossless(void) {
+  uint32_t bus;
+  bool r = true;
+
+  for (bus = 0; bus < TEST_BUSES; bus++) {
+    r = r && (testStats[bus].received == testReported[bus]) && (0u == testStats[bus].gaps) &&
+        (0u == testStats[bus].disorders);
+  }
+
+  return r && (0u == testLostFlags);
+}
+
+static void Test_NoLoss(const char *name, boolean useRing) {
+  bool bPass;
+
+  printf("Test %s %u frames per bus and cycle are all mirrored:", name, TEST_FRAMES_PER_CYCLE);
+  test_start(useRing);
+  test_run_cycles(TEST_FRAMES_PER_CYCLE);
+  bPass = test_is_lossless();
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    test_print();
+    exit(-1);
+  }
+}
+
+static void Test_Overload(const char *name, boolean useRing) {
+  uint32_t gaps;
+  bool bPass;
+
+  printf("Test %s %u frames per bus and cycle are flagged as lost:", name,
+         TEST_OVERLOAD_FRAMES_PER_CYCLE);
+  test_start(useRing);
+  test_run_cycles(TEST_OVERLOAD_FRAMES_PER_CYCLE);
+  gaps = testStats[0].gaps + testStats[1].gaps;
+  bPass = test_is_ordered() && (gaps > 0u) && (testStats[0].received > 0u) &&
+          (testStats[1].received > 0u);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    test_print();
+    exit(-1);
+  }
+}
+
+static void test_sleep_until(struct timespec *next, long ns) {
+  next->tv_nsec += ns;
+  while (next->tv_nsec >= 1000000000L) {
+    next->tv_nsec -= 1000000000L;
+    next->tv_sec++;
+  }
+  (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL);
+}
+
+/* report the frames due since the start every 100us to keep the rate */
+static void *test_producer(void *arg) {
+  test_producer_t *producer = (test_producer_t *)arg;
+  struct timespec start, now, next;
+  uint32_t due;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  next = start;
+  while (testRunning) {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    due = (uint32_t)(((now.tv_sec - start.tv_sec) * 1000000000LL + now.tv_nsec - start.tv_nsec) *
+                     producer->rate / 1000000000LL);
+    while (producer->reported < due) {
+      test_report(producer->controllerId, producer->reported);
+      producer->reported++;
+    }
+    test_sleep_until(&next, 100000L);
+  }
+
+  return NULL;
+}
+
+static void Test_Concurrent(const char *name, boolean useRing) {
+  pthread_t threads[TEST_BUSES];
+  test_producer_t producers[TEST_BUSES];
+  struct timespec next;
+  uint32_t i;
+  bool bPass;
+
+  printf("Test %s %u fps per bus from one thread per bus:", name, TEST_CONCURRENT_RATE);
+  test_start(useRing);
+  testRunning = 1;
+  for (i = 0; i < TEST_BUSES; i++) {
+    producers[i].rate = TEST_CONCURRENT_RATE;
+    producers[i].reported = 0;
+    producers[i].controllerId = (uint8_t)i;
+    pthread_create(&threads[i], NULL, test_producer, &producers[i]);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  for (i = 0; i < TEST_CONCURRENT_MS; i++) {
+    Mirror_MainFunction();
+    test_sleep_until(&next, 1000000L);
+  }
+  testRunning = 0;
+  for (i = 0; i < TEST_BUSES; i++) {
+    pthread_join(threads[i], NULL);
+    testReported[i] = producers[i].reported;
+  }
+  test_flush();
+
+  bPass = test_is_ordered() && (testStats[0].received > 0u) && (testStats[1].received > 0u);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    test_print();
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+imask_t Std_EnterCritical(void) {
+  pthread_mutex_lock(&testLock);
+  return 0;
+}
+
+void Std_ExitCritical(imask_t mask) {
+  (void)mask;
+  pthread_mutex_unlock(&testLock);
+}
+
+boolean TcpIp_IsLinkedUp(void) {
+  return TRUE;
+}
+
+Std_ReturnType SoAd_GetSoConId(PduIdType TxPduId, SoAd_SoConIdType *SoConIdPtr) {
+  *SoConIdPtr = 0;
+  return E_OK;
+}
+
+Std_ReturnType SoAd_OpenSoCon(SoAd_SoConIdType SoConId) {
+  return E_OK;
+}
+
+Std_ReturnType SoAd_CloseSoCon(SoAd_SoConIdType SoConId, boolean Abort) {
+  return E_OK;
+}
+
+/* count the gaps and disorders of the sequence counter of each bus and the frame lost states */
+Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  const uint8_t *data = PduInfoPtr->SduDataPtr;
+  uint16_t offset = 14;
+  uint8_t flags, length;
+  uint32_t seq;
+  test_bus_stats_t *stats;
+
+  testPackets++;
+  while ((offset + 10u) <= PduInfoPtr->SduLength) {
+    flags = data[offset + 2u];
+    stats = &testStats[(data[offset + 3u] - 1u) % TEST_BUSES];
+    offset += 4;
+    if (0u != (flags & TEST_NT_STATE_AVAIABLE)) {
+      if (0u != (data[offset] & MIRROR_NS_FRAME_LOST)) {
+        testLostFlags++;
+      }
+      offset += 1;
+    }
+    offset += 4; /* FrameID */
+    length = data[offset];
+    offset += 1;
+    seq = ((uint32_t)data[offset] << 24) + ((uint32_t)data[offset + 1u] << 16) +
+          ((uint32_t)data[offset + 2u] << 8) + data[offset + 3u];
+    offset += length;
+    if (seq < stats->next) {
+      stats->disorders++;
+    } else if (seq != stats->next) {
+      stats->gaps++;
+    } else {
+      /* in order */
+    }
+    stats->next = seq + 1u;
+    stats->received++;
+  }
+
+  return E_OK;
+}
+
+int main(int argc, char *argv[]) {
+  pthread_mutex_init(&testLock, NULL);
+
+  Test_NoLoss("direct", FALSE);
+  Test_NoLoss("ring", TRUE);
+  Test_Overload("direct", FALSE);
+  Test_Overload("ring", TRUE);
+  Test_Concurrent("direct", FALSE);
+  Test_Concurrent("ring", TRUE);
+
+  return 0;
+}
@@ -19,6 +19,10 @@
 #define CSM_E_SERVICE_TYPE 0x09
 /* ================================ [ TYPES     ] ============================================== */
 typedef struct Csm_Config_s Csm_ConfigType;
+
+/* @brief completion notification of an asynchronous job, it is invoked from Csm_MainFunction.
+ * For a MAC verify job, result E_NOT_OK also means that the MAC doesn't match. */
+typedef void (*Csm_JobNotificationType)(void *ctx, Std_ReturnType result);
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
@@ -35,4 +39,19 @@ Std_ReturnType Csm_MacGenerate(uint32_t jobId, Crypto_OperationModeType mode,
 Std_ReturnType Csm_MacVerify(uint32_t jobId, Crypto_OperationModeType mode, const uint8_t *dataPtr,
                              uint32_t dataLength, const uint8_t *macPtr, const uint32_t macLength,
                              Crypto_VerifyResultType *verifyPtr);
+
+/* @brief queue a single call MAC generation, the data and MAC buffer must be kept valid until the
+ * notification, return E_BUSY if the job queue is full */
+Std_ReturnType Csm_MacGenerateAsync(uint32_t jobId, const uint8_t *dataPtr, uint32_t dataLength,
+                                    uint8_t *macPtr, uint32_t *macLengthPtr,
+                                    Csm_JobNotificationType notification, void *ctx);
+
+/* @brief queue a single call MAC verification, the first macLength bytes of the MAC are compared,
+ * so a truncated MAC is allowed */
+Std_ReturnType Csm_MacVerifyAsync(uint32_t jobId, const uint8_t *dataPtr, uint32_t dataLength,
+                                  const uint8_t *macPtr, uint32_t macLength,
+                                  Csm_JobNotificationType notification, void *ctx);
+
+/* @SWS_Csm_00479 */
+void Csm_MainFunction(void);
 #endif /* CSM_H */
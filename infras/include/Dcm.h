@@ -83,6 +83,7 @@ extern "C" {
 #define DCM_E_SUB_FUNCTION_NOT_SUPPORTED ((Dcm_NegativeResponseCodeType)0x12)
 #define DCM_E_INCORRECT_MESSAGE_LENGTH_OR_INVALID_FORMAT ((Dcm_NegativeResponseCodeType)0x13)
 #define DCM_E_RESPONSE_TOO_LONG ((Dcm_NegativeResponseCodeType)0x14)
+#define DCM_E_BUSY_REPEAT_REQUEST ((Dcm_NegativeResponseCodeType)0x21)
 #define DCM_E_CONDITIONS_NOT_CORRECT ((Dcm_NegativeResponseCodeType)0x22)
 #define DCM_E_REQUEST_SEQUENCE_ERROR ((Dcm_NegativeResponseCodeType)0x24)
 #define DCM_E_REQUEST_OUT_OF_RANGE ((Dcm_NegativeResponseCodeType)0x31)
@@ -278,6 +279,10 @@ Std_ReturnType Dcm_AuthenticationVerifyProofOfOwnership(const uint8_t *signature
 
 Std_ReturnType Dcm_GetRxPduId(PduIdType *PduId);
 
+/* the average period in ms and the number of missed slots of a periodic DID (0x2A) since it
+ * was started, the DID is the low byte of 0xF2xx */
+Std_ReturnType Dcm_GetPeriodicDIDRate(uint8_t id, uint32_t *periodMs, uint16_t *numOfMissed);
+
 /* @SWS_Dcm_00065 */
 void Dcm_GetVersionInfo(Std_VersionInfoType *versionInfo);
 
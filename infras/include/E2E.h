@@ -32,10 +32,33 @@ extern "C" {
 #define E2E_E_SM_DEINIT ((Std_ReturnType)0xEA)
 #define E2E_E_SM_INIT ((Std_ReturnType)0xEB)
 #define E2E_E_SM_INVALID ((Std_ReturnType)0xEC)
+
+/* the operation of an E2E_ExecuteBatch item */
+#define E2E_PROTECT_P11 ((E2E_OperationType)0)
+#define E2E_CHECK_P11 ((E2E_OperationType)1)
+#define E2E_PROTECT_P22 ((E2E_OperationType)2)
+#define E2E_CHECK_P22 ((E2E_OperationType)3)
+#define E2E_PROTECT_P44 ((E2E_OperationType)4)
+#define E2E_CHECK_P44 ((E2E_OperationType)5)
+#define E2E_PROTECT_P05 ((E2E_OperationType)6)
+#define E2E_CHECK_P05 ((E2E_OperationType)7)
+#define E2E_PROTECT_P07 ((E2E_OperationType)8)
+#define E2E_CHECK_P07 ((E2E_OperationType)9)
+#define E2E_OPERATION_MAX ((E2E_OperationType)10)
 /* ================================ [ TYPES     ] ============================================== */
 typedef struct E2E_Config_s E2E_ConfigType;
 
 typedef uint16_t E2E_ProfileIdType;
+
+typedef uint8_t E2E_OperationType;
+
+typedef struct {
+  uint8_t *data;
+  uint32_t length; /* up to 0xFFFF except for P07 */
+  E2E_ProfileIdType profileId;
+  E2E_OperationType operation;
+  Std_ReturnType result; /* output, the return value of the operation */
+} E2E_BatchItemType;
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
@@ -62,6 +85,15 @@ Std_ReturnType E2E_P44Check(E2E_ProfileIdType profileId, uint8_t *data, uint16_t
 Std_ReturnType E2E_P05Protect(E2E_ProfileIdType profileId, uint8_t *data, uint16_t length);
 /* @PRS_E2E_00411 */
 Std_ReturnType E2E_P05Check(E2E_ProfileIdType profileId, uint8_t *data, uint16_t length);
+
+/* @PRS_E2E_00486 */
+Std_ReturnType E2E_P07Protect(E2E_ProfileIdType profileId, uint8_t *data, uint32_t length);
+/* @PRS_E2E_00495 */
+Std_ReturnType E2E_P07Check(E2E_ProfileIdType profileId, uint8_t *data, uint32_t length);
+
+/* Protect or check the items in one go, the result of each is returned in the item, returns the
+ * number of items with E2E_E_OK or E2E_E_OK_SOME_LOST */
+uint16_t E2E_ExecuteBatch(E2E_BatchItemType *items, uint16_t numOfItems);
 #ifdef __cplusplus
 }
 #endif
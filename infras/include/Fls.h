@@ -104,7 +104,7 @@ Std_ReturnType Fls_AcBlankCheck(Fls_AddressType address, Fls_LengthType length);
 boolean Fls_AcIsIdle(void);
 /* ================================ [ DATAS     ] ============================================== */
 #if defined(linux) || defined(_WIN32)
-extern uint8_t g_FlsAcMirror[];
+extern uint8_t *g_FlsAcMirror;
 #endif
 /* ================================ [ LOCALS    ] ============================================== */
 /* ================================ [ FUNCTIONS ] ============================================== */
@@ -82,6 +82,10 @@ void LinIf_MainFunction(void);
 
 void LinIf_MainFunction_Read(void);
 
+/* For the LINIF_SCHED_MODE_DEADLINE, return the time in us till the start of the next slot of all
+ * the master channels, the LinIf_MainFunction should be called at that time. */
+uint32_t LinIf_GetNextSlotTime(void);
+
 /* for slave */
 /* @SWS_LinIf_91004 */
 Std_ReturnType LinIf_HeaderIndication(NetworkHandleType Channel, Lin_PduType *PduPtr);
@@ -42,6 +42,7 @@
 #define MODULE_ID_E2E ((uint16_t)207)
 #define MODULE_ID_MIRROR ((uint16_t)48)
 #define MODULE_ID_CANTSYN ((uint16_t)161)
+#define MODULE_ID_STBM ((uint16_t)160)
 #define MODULE_ID_SD ((uint16_t)171)
 #define MODULE_ID_SOAD ((uint16_t)56)
 #define MODULE_ID_SOMEIPTP ((uint16_t)177)
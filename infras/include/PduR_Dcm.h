@@ -10,6 +10,7 @@
 #include "ComStack_Types.h"
 #ifdef PDUR_DCM_CANTP_ZERO_COST
 #include "CanTp.h"
+#include "CanIf.h"
 #endif
 #ifdef PDUR_DCM_LINTP_ZERO_COST
 #include "LinTp.h"
@@ -20,6 +21,7 @@ extern "C" {
 /* ================================ [ MACROS    ] ============================================== */
 #ifdef PDUR_DCM_CANTP_ZERO_COST
 #define PduR_DcmTransmit CanTp_Transmit
+#define PduR_DcmIfTransmit CanIf_Transmit
 #endif
 #ifdef PDUR_DCM_LINTP_ZERO_COST
 #define PduR_DcmTransmit LinTp_Transmit
@@ -39,6 +41,11 @@ Std_ReturnType PduR_DcmCancelTransmit(PduIdType TxPduId);
 Std_ReturnType PduR_DcmCancelReceive(PduIdType RxPduId);
 #endif
 
+#ifndef PDUR_DCM_CANTP_ZERO_COST
+/* the periodic DIDs are sent as single frames on an IF route */
+Std_ReturnType PduR_DcmIfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,11 @@ void SoAd_Init(const SoAd_ConfigType *ConfigPtr);
 /* @SWS_SoAd_00091 */
 Std_ReturnType SoAd_IfTransmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr);
 
+/* send the same UDP PDU to several remote addresses with one call, for event fan-out */
+Std_ReturnType SoAd_IfTransmitToMulti(PduIdType TxPduId, const PduInfoType *PduInfoPtr,
+                                     const TcpIp_SockAddrType *RemoteAddrs,
+                                     uint16_t numOfRemoteAddrs);
+
 /* @SWS_SoAd_00656 */
 Std_ReturnType SoAd_IfRoutingGroupTransmit(SoAd_RoutingGroupIdType id);
 
@@ -15,6 +15,13 @@
 #define STBM_STATUS_GLOBAL_TIME_BASE ((StbM_TimeBaseStatusType)0x08)
 #define STBM_STATUS_TIMELEAP_FUTURE ((StbM_TimeBaseStatusType)0x10)
 #define STBM_STATUS_TIMELEAP_PAST ((StbM_TimeBaseStatusType)0x20)
+
+/* @SWS_StbM_00041 */
+#define STBM_E_PARAM 0x0A
+#define STBM_E_UNINIT 0x0B
+#define STBM_E_PARAM_POINTER 0x10
+#define STBM_E_INIT_FAILED 0x11
+#define STBM_E_SERVICE_DISABLED 0x12
 /* ================================ [ TYPES     ] ============================================== */
 typedef struct StbM_Config_s StbM_ConfigType;
 
@@ -51,6 +58,9 @@ typedef struct {
   uint8_t userByte2;
 } StbM_UserDataType;
 
+/* @SWS_StbM_00255: in ppm */
+typedef int16_t StbM_RateDeviationType;
+
 /* @SWS_StbM_91013 */
 typedef struct {
   StbM_VirtualLocalTimeType virtualLocalTime;
@@ -77,6 +87,11 @@ Std_ReturnType StbM_BusGetCurrentTime(StbM_SynchronizedTimeBaseType timeBaseId,
 Std_ReturnType StbM_GetCurrentTime(StbM_SynchronizedTimeBaseType timeBaseId,
                                    StbM_TimeTupleType *timeTuple, StbM_UserDataType *userData);
 
+/* @SWS_StbM_00213 */
+Std_ReturnType StbM_SetGlobalTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                  const StbM_TimeStampType *timeStamp,
+                                  const StbM_UserDataType *userData);
+
 /* @SWS_StbM_00233 */
 Std_ReturnType StbM_BusSetGlobalTime(StbM_SynchronizedTimeBaseType timeBaseId,
                                      const StbM_TimeStampType *globalTimePtr,
@@ -95,4 +110,14 @@ Std_ReturnType StbM_GetOffset(StbM_SynchronizedTimeBaseType timeBaseId,
 
 /* @SWS_StbM_00347 */
 uint8_t StbM_GetTimeBaseUpdateCounter(StbM_SynchronizedTimeBaseType timeBaseId);
+
+/* @SWS_StbM_00378 */
+Std_ReturnType StbM_GetRateDeviation(StbM_SynchronizedTimeBaseType timeBaseId,
+                                     StbM_RateDeviationType *rateDeviation);
+
+/* @SWS_StbM_00057 */
+void StbM_MainFunction(void);
+
+/* @SWS_StbM_00066 */
+void StbM_GetVersionInfo(Std_VersionInfoType *versionInfo);
 #endif /* __STB_M_H__ */
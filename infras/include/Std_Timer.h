@@ -52,6 +52,9 @@ typedef struct {
 /* ================================ [ LOCALS    ] ============================================== */
 /* ================================ [ FUNCTIONS ] ============================================== */
 std_time_t Std_GetTime(void);
+/* return a monotonic time in ns(nanoseconds) of the free running local clock, it is not steered
+ * by NTP and so it is the reference that a synchronized time base is disciplined against */
+uint64_t Std_GetTimeNs(void);
 void Std_Sleep(std_time_t time);
 void Std_TimerStart(Std_TimerType *timer);
 void Std_TimerStop(Std_TimerType *timer);
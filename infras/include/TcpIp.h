@@ -149,6 +149,12 @@ Std_ReturnType TcpIp_RecvFrom(TcpIp_SocketIdType SocketId, TcpIp_SockAddrType *R
 Std_ReturnType TcpIp_SendTo(TcpIp_SocketIdType SocketId, const TcpIp_SockAddrType *RemoteAddrPtr,
                             const uint8_t *BufPtr, uint32_t Length);
 
+/* send the same datagram to several remote addresses, on linux with one sendmmsg per
+ * TCPIP_SENDMMSG_MAX addresses */
+Std_ReturnType TcpIp_SendToMulti(TcpIp_SocketIdType SocketId, const TcpIp_SockAddrType *RemoteAddrs,
+                                 uint16_t numOfRemoteAddrs, const uint8_t *BufPtr,
+                                 uint32_t Length);
+
 Std_ReturnType TcpIp_Send(TcpIp_SocketIdType SocketId, const uint8_t *BufPtr, uint32_t Length);
 
 /*
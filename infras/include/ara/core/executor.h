@@ -0,0 +1,287 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ */
+#ifndef ARA_CORE_EXECUTOR_H
+#define ARA_CORE_EXECUTOR_H
+/* ================================ [ INCLUDES  ] ============================================== */
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ara {
+namespace core {
+/* ================================ [ MACROS    ] ============================================== */
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ CLASS    ] ============================================== */
+namespace internal {
+/** @brief Move-only void() callable with inline storage.
+ * Callables up to kInlineSize bytes which are nothrow move constructible are stored in place, so
+ * posting a continuation or a job does not touch the heap, bigger ones fall back to new/delete. */
+class Task final {
+public:
+  static constexpr std::size_t kInlineSize = 64;
+
+  Task() noexcept = default;
+
+  template <typename F,
+            typename = typename std::enable_if<
+              !std::is_same<typename std::decay<F>::type, Task>::value>::type>
+  Task(F &&func) {
+    using FuncT = typename std::decay<F>::type;
+    using IsInline =
+      std::integral_constant<bool, (sizeof(FuncT) <= kInlineSize) &&
+                                     (alignof(FuncT) <= alignof(std::max_align_t)) &&
+                                     std::is_nothrow_move_constructible<FuncT>::value>;
+    Emplace<FuncT>(std::forward<F>(func), IsInline());
+  }
+
+  Task(const Task &) = delete;
+
+  Task &operator=(const Task &) = delete;
+
+  Task(Task &&other) noexcept {
+    MoveFrom(other);
+  }
+
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  ~Task() noexcept {
+    Reset();
+  }
+
+  explicit operator bool() const noexcept {
+    return nullptr != m_ops;
+  }
+
+  void operator()() {
+    m_ops->invoke(m_storage);
+  }
+
+  void Reset() noexcept {
+    if (nullptr != m_ops) {
+      m_ops->destroy(m_storage);
+      m_ops = nullptr;
+    }
+  }
+
+private:
+  struct Ops {
+    void (*invoke)(void *storage);
+    void (*move)(void *dst, void *src) noexcept;
+    void (*destroy)(void *storage) noexcept;
+  };
+
+  template <typename FuncT> struct InlineOps {
+    static void Invoke(void *storage) {
+      (*static_cast<FuncT *>(storage))();
+    }
+    static void Move(void *dst, void *src) noexcept {
+      new (dst) FuncT(std::move(*static_cast<FuncT *>(src)));
+      static_cast<FuncT *>(src)->~FuncT();
+    }
+    static void Destroy(void *storage) noexcept {
+      static_cast<FuncT *>(storage)->~FuncT();
+    }
+    static const Ops *Get() noexcept {
+      static const Ops ops = {Invoke, Move, Destroy};
+      return &ops;
+    }
+  };
+
+  template <typename FuncT> struct HeapOps {
+    static void Invoke(void *storage) {
+      (**static_cast<FuncT **>(storage))();
+    }
+    static void Move(void *dst, void *src) noexcept {
+      *static_cast<FuncT **>(dst) = *static_cast<FuncT **>(src);
+    }
+    static void Destroy(void *storage) noexcept {
+      delete *static_cast<FuncT **>(storage);
+    }
+    static const Ops *Get() noexcept {
+      static const Ops ops = {Invoke, Move, Destroy};
+      return &ops;
+    }
+  };
+
+  template <typename FuncT, typename F> void Emplace(F &&func, std::true_type) {
+    new (m_storage) FuncT(std::forward<F>(func));
+    m_ops = InlineOps<FuncT>::Get();
+  }
+
+  template <typename FuncT, typename F> void Emplace(F &&func, std::false_type) {
+    *reinterpret_cast<FuncT **>(m_storage) = new FuncT(std::forward<F>(func));
+    m_ops = HeapOps<FuncT>::Get();
+  }
+
+  void MoveFrom(Task &other) noexcept {
+    m_ops = other.m_ops;
+    if (nullptr != m_ops) {
+      m_ops->move(m_storage, other.m_storage);
+      other.m_ops = nullptr;
+    }
+  }
+
+private:
+  const Ops *m_ops = nullptr;
+  alignas(std::max_align_t) unsigned char m_storage[kInlineSize];
+};
+
+/** @brief Keep an executor passed to Future::then alive until the continuation is dispatched,
+ * an lvalue executor is referenced, an rvalue executor is moved into the holder. */
+template <typename ExecutorT> class ExecutorHolder final {
+public:
+  explicit ExecutorHolder(ExecutorT &&executor) : m_executor(std::move(executor)) {
+  }
+
+  void operator()(Task &&task) {
+    m_executor(std::move(task));
+  }
+
+private:
+  typename std::decay<ExecutorT>::type m_executor;
+};
+
+template <typename ExecutorT> class ExecutorHolder<ExecutorT &> final {
+public:
+  explicit ExecutorHolder(ExecutorT &executor) noexcept : m_executor(&executor) {
+  }
+
+  void operator()(Task &&task) {
+    (*m_executor)(std::move(task));
+  }
+
+private:
+  ExecutorT *m_executor;
+};
+} // namespace internal
+
+/** @brief Executor which runs the job in the calling context. */
+class InlineExecutor final {
+public:
+  template <typename F> void operator()(F &&func) {
+    func();
+  }
+};
+
+/** @brief Fixed size thread pool executor.
+ * The job queue is a ring of preallocated Tasks, it only grows when more jobs than the initial
+ * capacity are outstanding at the same time. */
+class ThreadPoolExecutor final {
+public:
+  explicit ThreadPoolExecutor(std::size_t numThreads = 2, std::size_t capacity = 64)
+    : m_queue(capacity > 0 ? capacity : 1) {
+    if (0 == numThreads) {
+      numThreads = 1;
+    }
+    m_workers.reserve(numThreads);
+    for (std::size_t i = 0; i < numThreads; i++) {
+      m_workers.emplace_back([this]() { Worker(); });
+    }
+  }
+
+  ThreadPoolExecutor(const ThreadPoolExecutor &) = delete;
+
+  ThreadPoolExecutor &operator=(const ThreadPoolExecutor &) = delete;
+
+  ~ThreadPoolExecutor() noexcept {
+    {
+      std::lock_guard<std::mutex> lck(m_lock);
+      m_stop = true;
+    }
+    m_cond.notify_all();
+    for (auto &worker : m_workers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  /** @brief Queue a job, it will be run by one of the pool threads. */
+  template <typename F> void operator()(F &&func) {
+    Post(internal::Task(std::forward<F>(func)));
+  }
+
+  void Post(internal::Task &&task) {
+    bool bWakeup;
+    {
+      std::lock_guard<std::mutex> lck(m_lock);
+      if (m_count == m_queue.size()) {
+        Grow();
+      }
+      m_queue[(m_head + m_count) % m_queue.size()] = std::move(task);
+      m_count++;
+      bWakeup = (m_idle > 0);
+    }
+    if (bWakeup) {
+      m_cond.notify_one();
+    }
+  }
+
+  std::size_t GetThreadCount() const noexcept {
+    return m_workers.size();
+  }
+
+private:
+  void Grow() {
+    std::vector<internal::Task> queue(m_queue.size() * 2);
+    for (std::size_t i = 0; i < m_count; i++) {
+      queue[i] = std::move(m_queue[(m_head + i) % m_queue.size()]);
+    }
+    m_queue.swap(queue);
+    m_head = 0;
+  }
+
+  void Worker() {
+    internal::Task task;
+    std::unique_lock<std::mutex> lck(m_lock);
+    while (true) {
+      while ((0 == m_count) && (false == m_stop)) {
+        m_idle++;
+        m_cond.wait(lck);
+        m_idle--;
+      }
+      if (0 == m_count) { /* stopped and drained */
+        break;
+      }
+      task = std::move(m_queue[m_head]);
+      m_head = (m_head + 1) % m_queue.size();
+      m_count--;
+      lck.unlock();
+      task();
+      task.Reset();
+      lck.lock();
+    }
+  }
+
+private:
+  std::mutex m_lock;
+  std::condition_variable m_cond;
+  std::vector<internal::Task> m_queue;
+  std::size_t m_head = 0;
+  std::size_t m_count = 0;
+  std::size_t m_idle = 0;
+  bool m_stop = false;
+  std::vector<std::thread> m_workers;
+};
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+} // namespace core
+} // namespace ara
+#endif /* ARA_CORE_EXECUTOR_H */
@@ -7,10 +7,13 @@
 #define ARA_CORE_FUTURE_H
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "ara/core/error_code.h"
+#include "ara/core/executor.h"
 #include "ara/core/future_error_domain.h"
 #include "ara/core/result.h"
+#include <atomic>
 #include <chrono>
-#include <future>
+#include <condition_variable>
+#include <mutex>
 
 namespace ara {
 namespace core {
@@ -23,8 +26,219 @@ enum class FutureStatus : std::uint8_t {
   kTimeout,
 };
 
+template <typename T, typename E> class Promise;
+
+namespace internal {
+/** @brief Cache of fixed size memory blocks, used to recycle the shared states of small result
+ * types so that one request/response does not cost a malloc/free pair in the steady state.
+ * The pool is never destroyed as static futures may release their state during exit. */
+template <std::size_t kBlockSize> class BlockPool final {
+public:
+  static constexpr std::size_t kMaxCached = 64;
+
+  static BlockPool &Instance() noexcept {
+    static BlockPool *pool = new BlockPool();
+    return *pool;
+  }
+
+  void *Alloc() {
+    {
+      std::lock_guard<std::mutex> lck(m_lock);
+      if (nullptr != m_free) {
+        Node *node = m_free;
+        m_free = node->next;
+        m_cached--;
+        return node;
+      }
+    }
+    return ::operator new(kBlockSize);
+  }
+
+  void Free(void *ptr) noexcept {
+    {
+      std::lock_guard<std::mutex> lck(m_lock);
+      if (m_cached < kMaxCached) {
+        Node *node = static_cast<Node *>(ptr);
+        node->next = m_free;
+        m_free = node;
+        m_cached++;
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+
+private:
+  struct Node {
+    Node *next;
+  };
+
+  std::mutex m_lock;
+  Node *m_free = nullptr;
+  std::size_t m_cached = 0;
+};
+
+/** @brief Error used when a future has no state or its promise was destroyed unsatisfied.
+ * Only ErrorCode can carry a FutureErrc, there is no mapping to any other error type. */
+template <typename E> struct FutureError;
+
+template <> struct FutureError<ErrorCode> {
+  static ErrorCode Make(FutureErrc errc) noexcept {
+    return MakeErrorCode(errc, ErrorDomain::SupportDataType());
+  }
+
+  /** @brief Error of a continuation which has thrown, to be called from a catch handler. */
+  static ErrorCode FromException() noexcept {
+    try {
+      throw;
+    } catch (const Exception &e) {
+      return e.Error();
+    } catch (...) {
+      return Make(FutureErrc::kBrokenPromise);
+    }
+  }
+};
+
+/** @brief State shared by one Promise and one Future.
+ * It is reference counted, the Promise, the Future and a pending continuation each hold one
+ * reference. The continuation is run exactly once, by the thread which makes the state ready, or
+ * directly by the thread which attaches it if the state is already ready. */
+template <typename T, typename E> class SharedState final {
+  static_assert(std::is_same<E, ErrorCode>::value,
+                "the error type of Future/Promise must be ara::core::ErrorCode");
+
+public:
+  using ResultType = Result<T, E>;
+
+  static constexpr std::size_t kSmallStateSize = 512;
+  static constexpr std::size_t kBlockSize = (sizeof(ResultType) + 256 + 63) & ~std::size_t(63);
+
+  static SharedState *Create() {
+    return new (Allocate()) SharedState();
+  }
+
+  void Retain() noexcept {
+    m_refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Release() noexcept {
+    if (1 == m_refs.fetch_sub(1, std::memory_order_acq_rel)) {
+      this->~SharedState();
+      Deallocate(this);
+    }
+  }
+
+  bool IsReady() const noexcept {
+    return m_ready.load(std::memory_order_acquire);
+  }
+
+  /** @brief Store the result and fire the continuation, false if it was already satisfied. */
+  bool SetResult(ResultType &&result) {
+    Task continuation;
+    {
+      std::lock_guard<std::mutex> lck(m_lock);
+      if (true == m_ready.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      m_result = std::move(result);
+      m_ready.store(true, std::memory_order_release);
+      continuation = std::move(m_continuation);
+      if (m_waiters > 0) {
+        m_cond.notify_all();
+      }
+    }
+    if (continuation) {
+      continuation();
+    }
+    return true;
+  }
+
+  void SetContinuation(Task &&task) {
+    {
+      std::lock_guard<std::mutex> lck(m_lock);
+      if (false == m_ready.load(std::memory_order_relaxed)) {
+        m_continuation = std::move(task);
+        return;
+      }
+    }
+    task();
+  }
+
+  void Wait() {
+    if (false == IsReady()) {
+      std::unique_lock<std::mutex> lck(m_lock);
+      m_waiters++;
+      while (false == m_ready.load(std::memory_order_relaxed)) {
+        m_cond.wait(lck);
+      }
+      m_waiters--;
+    }
+  }
+
+  template <typename Clock, typename Duration>
+  bool WaitUntil(const std::chrono::time_point<Clock, Duration> &deadline) {
+    if (false == IsReady()) {
+      std::unique_lock<std::mutex> lck(m_lock);
+      m_waiters++;
+      while (false == m_ready.load(std::memory_order_relaxed)) {
+        if (std::cv_status::timeout == m_cond.wait_until(lck, deadline)) {
+          break;
+        }
+      }
+      m_waiters--;
+    }
+    return IsReady();
+  }
+
+  ResultType &GetResult() noexcept {
+    return m_result;
+  }
+
+private:
+  SharedState() = default;
+
+  ~SharedState() = default;
+
+  static void *Allocate() {
+    if (kBlockSize <= kSmallStateSize) {
+      static_assert(sizeof(SharedState) <= kBlockSize, "shared state block size too small");
+      return BlockPool<kBlockSize>::Instance().Alloc();
+    }
+    return ::operator new(sizeof(SharedState));
+  }
+
+  static void Deallocate(void *ptr) noexcept {
+    if (kBlockSize <= kSmallStateSize) {
+      BlockPool<kBlockSize>::Instance().Free(ptr);
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+
+private:
+  std::atomic<uint32_t> m_refs{1};
+  std::atomic<bool> m_ready{false};
+  uint32_t m_waiters = 0;
+  std::mutex m_lock;
+  std::condition_variable m_cond;
+  Task m_continuation;
+  ResultType m_result;
+};
+
+template <typename E, typename F> Result<void, E> InvokeVoid(F &func, std::true_type) {
+  func();
+  return Result<void, E>();
+}
+
+template <typename E, typename F> Result<void, E> InvokeVoid(F &func, std::false_type) {
+  return Result<void, E>(func());
+}
+} // namespace internal
+
 /** @SWS_CORE_00321 @brief Future class template. */
 template <typename T, typename E = ErrorCode> class Future final {
+  using State = internal::SharedState<T, E>;
+
 public:
   /** @SWS_CORE_00334 @brief Copy constructor deleted. */
   Future(const Future &) = delete;
@@ -33,7 +247,8 @@ public:
   Future() noexcept = default;
 
   /** @SWS_CORE_00323 @brief Move constructor. */
-  Future(Future &&other) noexcept : m_future(std::move(other.m_future)) {
+  Future(Future &&other) noexcept : m_state(other.m_state) {
+    other.m_state = nullptr;
   }
 
   /** @SWS_CORE_00335 @brief Copy assignment deleted. */
@@ -41,325 +256,498 @@ public:
 
   /** @SWS_CORE_00325 @brief Move assignment. */
   Future &operator=(Future &&other) noexcept {
-    m_future = std::move(other.m_future);
+    if (this != &other) {
+      Reset();
+      m_state = other.m_state;
+      other.m_state = nullptr;
+    }
     return *this;
   }
 
   /** @SWS_CORE_00333 @brief Destructor. */
   ~Future() noexcept {
+    Reset();
   }
 
   /** @SWS_CORE_00336 @brief Get Result from Future. */
   Result<T, E> GetResult() noexcept(std::is_nothrow_move_constructible<T>::value &&
                                     std::is_nothrow_move_constructible<E>::value) {
+    if (nullptr == m_state) {
+      return Result<T, E>(internal::FutureError<E>::Make(FutureErrc::kNoState));
+    }
+
     if (is_ready()) {
       /* no wait */
     } else {
       wait();
     }
 
-    return m_future.get();
+    Result<T, E> result(std::move(m_state->GetResult()));
+    Reset();
+    return result;
   }
 
   /** @SWS_CORE_00326 @brief Get value from Future. */
   T get() noexcept(false) {
-    Result<T, E> rslt = m_future.get();
-    return rslt.ValueOrThrow();
+    Result<T, E> rslt = GetResult();
+    return std::move(rslt).ValueOrThrow();
   }
 
   /** @SWS_CORE_00332 @brief Check if Future is ready. */
   bool is_ready() const noexcept {
-    std::future_status status = m_future.wait_for(std::chrono::seconds(0));
-    return (status == std::future_status::ready);
+    return (nullptr != m_state) && m_state->IsReady();
   }
 
-  /** @SWS_CORE_00337 @brief Attach continuation with executor. */
+  /** @SWS_CORE_00337 @brief Attach continuation with executor.
+   * The continuation is queued to the executor once the result is available, an executor passed
+   * as lvalue must outlive the continuation. The allocation of the shared state or of the task
+   * may throw std::bad_alloc, this Future is then left untouched. */
   template <typename F, typename ExecutorT>
-  auto then(F &&func, ExecutorT &&executor) noexcept -> Future {
-    return Future<T, E>(executor([this, func = std::forward<F>(func)]() mutable {
-      auto result = this->GetResult();
-      if (result.HasValue()) {
-        return func(result.Value());
-      }
-      return Result<T, E>(result.Error());
-    }));
+  auto then(F &&func, ExecutorT &&executor) -> Future {
+    State *prev = m_state;
+    State *next = State::Create();
+    Future future(next);
+    if (nullptr == prev) {
+      next->SetResult(Result<T, E>(internal::FutureError<E>::Make(FutureErrc::kNoState)));
+    } else {
+      internal::Task task(
+        [prev, next, func = std::forward<F>(func),
+         executor = internal::ExecutorHolder<ExecutorT>(std::forward<ExecutorT>(executor))]() mutable {
+          executor(MakeContinuation(prev, next, std::move(func)));
+        });
+      m_state = nullptr;
+      next->Retain();
+      prev->SetContinuation(std::move(task));
+    }
+    return future;
   }
 
-  /** @SWS_CORE_00331 @brief Attach continuation. */
-  template <typename F> auto then(F &&func) noexcept -> Future {
-    return Future<T, E>(std::async([this, func = std::forward<F>(func)]() mutable {
-      auto result = this->GetResult();
-      if (result.HasValue()) {
-        return func(result.Value());
-      }
-      return Result<T, E>(result.Error());
-    }));
+  /** @SWS_CORE_00331 @brief Attach continuation.
+   * The continuation runs inline, in the context which sets the value of the Promise, or right now
+   * if this Future is already ready. An exception thrown by the continuation is stored as the
+   * error of the returned Future, std::bad_alloc of the allocation of the shared state or of the
+   * task is thrown by then() and leaves this Future untouched. */
+  template <typename F> auto then(F &&func) -> Future {
+    State *prev = m_state;
+    State *next = State::Create();
+    Future future(next);
+    if (nullptr == prev) {
+      next->SetResult(Result<T, E>(internal::FutureError<E>::Make(FutureErrc::kNoState)));
+    } else {
+      internal::Task task = MakeContinuation(prev, next, std::forward<F>(func));
+      m_state = nullptr;
+      next->Retain();
+      prev->SetContinuation(std::move(task));
+    }
+    return future;
   }
 
   /** @SWS_CORE_00327 @brief Check if Future is valid. */
   bool valid() const noexcept {
-    return m_future.valid();
+    return nullptr != m_state;
   }
 
   /** @SWS_CORE_00328 @brief Wait for Future to complete. */
   void wait() const noexcept {
-    return m_future.wait();
+    if (nullptr != m_state) {
+      m_state->Wait();
+    }
   }
 
   /** @SWS_CORE_00329 @brief Wait with duration timeout. */
   template <typename Rep, typename Period>
   FutureStatus wait_for(const std::chrono::duration<Rep, Period> &timeoutDuration) const noexcept {
-    auto status = m_future.wait_for(timeoutDuration);
-    return (status == std::future_status::ready) ? FutureStatus::kReady : FutureStatus::kTimeout;
+    return wait_until(std::chrono::steady_clock::now() + timeoutDuration);
   }
 
   /** @SWS_CORE_00330 @brief Wait until deadline. */
   template <typename Clock, typename Duration>
   FutureStatus wait_until(const std::chrono::time_point<Clock, Duration> &deadline) const noexcept {
-    auto status = m_future.wait_until(deadline);
-    return (status == std::future_status::ready) ? FutureStatus::kReady : FutureStatus::kTimeout;
+    bool bReady = (nullptr != m_state) && m_state->WaitUntil(deadline);
+    return bReady ? FutureStatus::kReady : FutureStatus::kTimeout;
   }
 
-public:
-  Future(std::future<Result<T, E>> &&other) noexcept : m_future(std::move(other)) {
+private:
+  explicit Future(State *state) noexcept : m_state(state) {
+  }
+
+  void Reset() noexcept {
+    if (nullptr != m_state) {
+      m_state->Release();
+      m_state = nullptr;
+    }
   }
 
+  template <typename F> static internal::Task MakeContinuation(State *prev, State *next, F &&func) {
+    return internal::Task([prev, next, func = std::forward<F>(func)]() mutable {
+      Result<T, E> &result = prev->GetResult();
+      if (result.HasValue()) {
+        try {
+          next->SetResult(Result<T, E>(func(result.Value())));
+        } catch (...) {
+          next->SetResult(Result<T, E>(internal::FutureError<E>::FromException()));
+        }
+      } else {
+        next->SetResult(Result<T, E>(result.Error()));
+      }
+      prev->Release();
+      next->Release();
+    });
+  }
+
+  friend class Promise<T, E>;
+
 private:
-  std::future<Result<T, E>> m_future;
+  State *m_state = nullptr;
 };
 
-/** @SWS_CORE_06221 @brief Future specialization for void type. */
-template <typename E> class Future<void, E> final {
-public:
-  /** @SWS_CORE_06234 @brief Copy constructor deleted. */
-  Future(const Future &other) = delete;
-
-  /** @SWS_CORE_06222 @brief Default constructor. */
-  Future() noexcept = default;
-
-  /** @SWS_CORE_06223 @brief Move constructor. */
-  Future(Future &&other) noexcept : m_future(std::move(other.m_future)) {}
-
-  /** @SWS_CORE_06235 @brief Copy assignment deleted. */
-  Future &operator=(const Future &other) = delete;
-
-  /** @SWS_CORE_06225 @brief Move assignment. */
-  Future &operator=(Future &&other) noexcept {
-    m_future = std::move(other.m_future);
-    return *this;
-  }
-
-  /** @SWS_CORE_06233 @brief Destructor. */
-  ~Future() noexcept = default;
-
-  /** @SWS_CORE_06236 @brief Get Result from Future. */
-  Result<void, E> GetResult() noexcept(std::is_nothrow_move_constructible<E>::value) {
-    if (is_ready()) {
-    } else {
-      wait();
-    }
-    return m_future.get();
-  }
-
-  /** @SWS_CORE_06226 @brief Get from Future. */
-  void get() noexcept(false) {
-    Result<void, E> rslt = m_future.get();
-    rslt.ValueOrThrow();
-  }
-
-  /** @SWS_CORE_06232 @brief Check if Future is ready. */
-  bool is_ready() const noexcept {
-    std::future_status status = m_future.wait_for(std::chrono::seconds(0));
-    return (status == std::future_status::ready);
-  }
-
-  /** @SWS_CORE_06237 @brief Attach continuation with executor. */
-  template <typename F, typename ExecutorT>
-  auto then(F &&func, ExecutorT &&executor) noexcept -> Future {
-    return Future<void, E>(executor([this, func = std::forward<F>(func)]() mutable {
-      auto result = this->GetResult();
-      if (result.HasValue()) {
-        return func();
-      }
-      return Result<void, E>(result.Error());
-    }));
-  }
-
-  /** @SWS_CORE_06231 @brief Attach continuation. */
-  template <typename F> auto then(F &&func) noexcept -> Future {
-    return Future<void, E>(std::async([this, func = std::forward<F>(func)]() mutable {
-      auto result = this->GetResult();
-      if (result.HasValue()) {
-        return func();
-      }
-      return Result<void, E>(result.Error());
-    }));
-  }
-
-  /** @SWS_CORE_00327 @brief Check if Future is valid. */
-  bool valid() const noexcept {
-    return m_future.valid();
-  }
-
-  /** @SWS_CORE_00328 @brief Wait for Future to complete. */
-  void wait() const noexcept {
-    m_future.wait();
-  }
-
-  /** @SWS_CORE_00329 @brief Wait with duration timeout. */
-  template <typename Rep, typename Period>
-  FutureStatus wait_for(const std::chrono::duration<Rep, Period> &timeoutDuration) const noexcept {
-    auto status = m_future.wait_for(timeoutDuration);
-    return (status == std::future_status::ready) ? FutureStatus::kReady : FutureStatus::kTimeout;
-  }
-
-  /** @SWS_CORE_06230 @brief Wait until deadline. */
-  template <typename Clock, typename Duration>
-  FutureStatus wait_until(const std::chrono::time_point<Clock, Duration> &deadline) const noexcept {
-    auto status = m_future.wait_until(deadline);
-    return (status == std::future_status::ready) ? FutureStatus::kReady : FutureStatus::kTimeout;
-  }
-
-public:
-  Future(std::future<Result<void, E>> &&other) noexcept : m_future(std::move(other)) {}
-
-private:
-  std::future<Result<void, E>> m_future;
+/** @SWS_CORE_06221 @brief Future specialization for void type. */
+template <typename E> class Future<void, E> final {
+  using State = internal::SharedState<void, E>;
+
+public:
+  /** @SWS_CORE_06234 @brief Copy constructor deleted. */
+  Future(const Future &other) = delete;
+
+  /** @SWS_CORE_06222 @brief Default constructor. */
+  Future() noexcept = default;
+
+  /** @SWS_CORE_06223 @brief Move constructor. */
+  Future(Future &&other) noexcept : m_state(other.m_state) {
+    other.m_state = nullptr;
+  }
+
+  /** @SWS_CORE_06235 @brief Copy assignment deleted. */
+  Future &operator=(const Future &other) = delete;
+
+  /** @SWS_CORE_06225 @brief Move assignment. */
+  Future &operator=(Future &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      m_state = other.m_state;
+      other.m_state = nullptr;
+    }
+    return *this;
+  }
+
+  /** @SWS_CORE_06233 @brief Destructor. */
+  ~Future() noexcept {
+    Reset();
+  }
+
+  /** @SWS_CORE_06236 @brief Get Result from Future. */
+  Result<void, E> GetResult() noexcept(std::is_nothrow_move_constructible<E>::value) {
+    if (nullptr == m_state) {
+      return Result<void, E>(internal::FutureError<E>::Make(FutureErrc::kNoState));
+    }
+
+    if (is_ready()) {
+    } else {
+      wait();
+    }
+
+    Result<void, E> result(std::move(m_state->GetResult()));
+    Reset();
+    return result;
+  }
+
+  /** @SWS_CORE_06226 @brief Get from Future. */
+  void get() noexcept(false) {
+    Result<void, E> rslt = GetResult();
+    rslt.ValueOrThrow();
+  }
+
+  /** @SWS_CORE_06232 @brief Check if Future is ready. */
+  bool is_ready() const noexcept {
+    return (nullptr != m_state) && m_state->IsReady();
+  }
+
+  /** @SWS_CORE_06237 @brief Attach continuation with executor. */
+  template <typename F, typename ExecutorT>
+  auto then(F &&func, ExecutorT &&executor) -> Future {
+    State *prev = m_state;
+    State *next = State::Create();
+    Future future(next);
+    if (nullptr == prev) {
+      next->SetResult(Result<void, E>(internal::FutureError<E>::Make(FutureErrc::kNoState)));
+    } else {
+      internal::Task task(
+        [prev, next, func = std::forward<F>(func),
+         executor = internal::ExecutorHolder<ExecutorT>(std::forward<ExecutorT>(executor))]() mutable {
+          executor(MakeContinuation(prev, next, std::move(func)));
+        });
+      m_state = nullptr;
+      next->Retain();
+      prev->SetContinuation(std::move(task));
+    }
+    return future;
+  }
+
+  /** @SWS_CORE_06231 @brief Attach continuation. */
+  template <typename F> auto then(F &&func) -> Future {
+    State *prev = m_state;
+    State *next = State::Create();
+    Future future(next);
+    if (nullptr == prev) {
+      next->SetResult(Result<void, E>(internal::FutureError<E>::Make(FutureErrc::kNoState)));
+    } else {
+      internal::Task task = MakeContinuation(prev, next, std::forward<F>(func));
+      m_state = nullptr;
+      next->Retain();
+      prev->SetContinuation(std::move(task));
+    }
+    return future;
+  }
+
+  /** @SWS_CORE_00327 @brief Check if Future is valid. */
+  bool valid() const noexcept {
+    return nullptr != m_state;
+  }
+
+  /** @SWS_CORE_00328 @brief Wait for Future to complete. */
+  void wait() const noexcept {
+    if (nullptr != m_state) {
+      m_state->Wait();
+    }
+  }
+
+  /** @SWS_CORE_00329 @brief Wait with duration timeout. */
+  template <typename Rep, typename Period>
+  FutureStatus wait_for(const std::chrono::duration<Rep, Period> &timeoutDuration) const noexcept {
+    return wait_until(std::chrono::steady_clock::now() + timeoutDuration);
+  }
+
+  /** @SWS_CORE_06230 @brief Wait until deadline. */
+  template <typename Clock, typename Duration>
+  FutureStatus wait_until(const std::chrono::time_point<Clock, Duration> &deadline) const noexcept {
+    bool bReady = (nullptr != m_state) && m_state->WaitUntil(deadline);
+    return bReady ? FutureStatus::kReady : FutureStatus::kTimeout;
+  }
+
+private:
+  explicit Future(State *state) noexcept : m_state(state) {
+  }
+
+  void Reset() noexcept {
+    if (nullptr != m_state) {
+      m_state->Release();
+      m_state = nullptr;
+    }
+  }
+
+  template <typename F> static internal::Task MakeContinuation(State *prev, State *next, F &&func) {
+    return internal::Task([prev, next, func = std::forward<F>(func)]() mutable {
+      Result<void, E> &result = prev->GetResult();
+      if (result.HasValue()) {
+        try {
+          next->SetResult(internal::InvokeVoid<E>(
+            func, std::integral_constant<bool, std::is_void<decltype(func())>::value>()));
+        } catch (...) {
+          next->SetResult(Result<void, E>(internal::FutureError<E>::FromException()));
+        }
+      } else {
+        next->SetResult(Result<void, E>(result.Error()));
+      }
+      prev->Release();
+      next->Release();
+    });
+  }
+
+  friend class Promise<void, E>;
+
+private:
+  State *m_state = nullptr;
 };
 
 /** @SWS_CORE_00340 @brief Promise class template. */
 template <typename T, typename E = ErrorCode> class Promise final {
+  using State = internal::SharedState<T, E>;
+
 public:
   /** @SWS_CORE_00350 @brief Copy constructor deleted. */
   Promise(const Promise &) = delete;
 
   /** @SWS_CORE_00341 @brief Default constructor. */
-  Promise() noexcept = default;
+  Promise() noexcept : m_state(State::Create()) {
+  }
 
   /** @SWS_CORE_00342 @brief Move constructor. */
-  Promise(Promise &&other) noexcept : m_promise(std::move(other.m_promise)) {};
+  Promise(Promise &&other) noexcept : m_state(other.m_state) {
+    other.m_state = nullptr;
+  }
 
   /** @SWS_CORE_00351 @brief Copy assignment deleted. */
   Promise &operator=(const Promise &) = delete;
 
   /** @SWS_CORE_00343 @brief Move assignment. */
   Promise &operator=(Promise &&other) noexcept {
-    m_promise = std::move(other.m_promise);
+    if (this != &other) {
+      Reset();
+      m_state = other.m_state;
+      other.m_state = nullptr;
+    }
+    return *this;
   }
 
   /** @SWS_CORE_00349 @brief Destructor. */
   ~Promise() noexcept {
+    Reset();
   }
 
   /** @SWS_CORE_00353 @brief Set error (rvalue). */
   void SetError(E &&error) noexcept(std::is_nothrow_move_constructible<E>::value) {
-    m_promise.set_value(Result<T, E>(std::move(error)));
+    SetResult(Result<T, E>(std::move(error)));
   }
 
   /** @SWS_CORE_00354 @brief Set error (lvalue). */
   void SetError(const E &error) noexcept(std::is_nothrow_copy_constructible<E>::value) {
-    m_promise.set_value(Result<T, E>(error));
+    SetResult(Result<T, E>(error));
   }
 
   /** @SWS_CORE_00356 @brief Set result (rvalue). */
   void SetResult(Result<T, E> &&result) noexcept(std::is_nothrow_move_constructible<T>::value &&
                                                  std::is_nothrow_move_constructible<E>::value) {
-    m_promise.set_value(result);
+    if (nullptr != m_state) {
+      m_state->SetResult(std::move(result));
+    }
   }
 
   /** @SWS_CORE_00355 @brief Set result (lvalue). */
   void
   SetResult(const Result<T, E> &result) noexcept(std::is_nothrow_copy_constructible<T>::value &&
                                                  std::is_nothrow_copy_constructible<E>::value) {
-    m_promise.set_value(result);
+    SetResult(Result<T, E>(result));
   }
 
   /** @SWS_CORE_00344 @brief Get Future from Promise. */
   Future<T, E> get_future() noexcept {
-    return Future<T, E>(m_promise.get_future());
+    if (nullptr != m_state) {
+      m_state->Retain();
+    }
+    return Future<T, E>(m_state);
   }
 
   /** @SWS_CORE_00345 @brief Set value (lvalue). */
   void set_value(const T &value) noexcept(std::is_nothrow_copy_constructible<T>::value) {
-    m_promise.set_value(Result<T, E>(value));
+    SetResult(Result<T, E>(value));
   }
 
   /** @SWS_CORE_00346 @brief Set value (rvalue). */
   void set_value(T &&value) noexcept(std::is_nothrow_move_constructible<T>::value) {
-    m_promise.set_value(Result<T, E>(std::move(value)));
+    SetResult(Result<T, E>(std::move(value)));
   }
 
   /** @SWS_CORE_00352 @brief Swap with another Promise. */
   void swap(Promise &other) noexcept {
-    m_promise.swap(other.m_promise);
+    std::swap(m_state, other.m_state);
+  }
+
+private:
+  void Reset() noexcept {
+    if (nullptr != m_state) {
+      if (false == m_state->IsReady()) {
+        m_state->SetResult(
+          Result<T, E>(internal::FutureError<E>::Make(FutureErrc::kBrokenPromise)));
+      }
+      m_state->Release();
+      m_state = nullptr;
+    }
   }
 
 private:
-  std::promise<Result<T, E>> m_promise;
+  State *m_state;
 };
 
-/** @SWS_CORE_06340 @brief Promise specialization for void type. */
-template <typename E> class Promise<void, E> final {
-public:
-  /** @SWS_CORE_06342 @brief Move constructor. */
-  Promise(Promise &&other) noexcept : m_promise(std::move(other.m_promise)) {}
-
-  /** @SWS_CORE_06341 @brief Default constructor. */
-  Promise() noexcept = default;
-
-  /** @SWS_CORE_06350 @brief Copy constructor deleted. */
-  Promise(const Promise &) = delete;
-
-  /** @SWS_CORE_06351 @brief Copy assignment deleted. */
-  Promise &operator=(const Promise &) = delete;
-
-  /** @SWS_CORE_06343 @brief Move assignment. */
-  Promise &operator=(Promise &&other) noexcept {
-    m_promise = std::move(other.m_promise);
-    return *this;
-  }
-
-  /** @SWS_CORE_06349 @brief Destructor. */
-  ~Promise() noexcept = default;
-
-  /** @SWS_CORE_06353 @brief Set error (rvalue). */
-  void SetError(E &&error) noexcept(std::is_nothrow_move_constructible<E>::value) {
-    m_promise.set_value(Result<void, E>(std::move(error)));
-  }
-
-  /** @SWS_CORE_06354 @brief Set error (lvalue). */
-  void SetError(const E &error) noexcept(std::is_nothrow_copy_constructible<E>::value) {
-    m_promise.set_value(Result<void, E>(error));
-  }
-
-  /** @SWS_CORE_06356 @brief Set result (rvalue). */
-  void SetResult(Result<void, E> &&result) noexcept(std::is_nothrow_move_constructible<E>::value) {
-    m_promise.set_value(std::move(result));
-  }
-
-  /** @SWS_CORE_06355 @brief Set result (lvalue). */
-  void
-  SetResult(const Result<void, E> &result) noexcept(std::is_nothrow_copy_constructible<E>::value) {
-    m_promise.set_value(result);
-  }
-
-  /** @SWS_CORE_06344 @brief Get Future from Promise. */
-  Future<void, E> get_future() noexcept {
-    return Future<void, E>(m_promise.get_future());
-  }
-
-  /** @SWS_CORE_06345 @brief Set void value. */
-  void set_value() noexcept {
-    m_promise.set_value(Result<void, E>());
-  }
-
-  /** @SWS_CORE_06352 @brief Swap with another Promise. */
-  void swap(Promise &other) noexcept {
-    m_promise.swap(other.m_promise);
-  }
-
-private:
-  std::promise<Result<void, E>> m_promise;
+/** @SWS_CORE_06340 @brief Promise specialization for void type. */
+template <typename E> class Promise<void, E> final {
+  using State = internal::SharedState<void, E>;
+
+public:
+  /** @SWS_CORE_06342 @brief Move constructor. */
+  Promise(Promise &&other) noexcept : m_state(other.m_state) {
+    other.m_state = nullptr;
+  }
+
+  /** @SWS_CORE_06341 @brief Default constructor. */
+  Promise() noexcept : m_state(State::Create()) {
+  }
+
+  /** @SWS_CORE_06350 @brief Copy constructor deleted. */
+  Promise(const Promise &) = delete;
+
+  /** @SWS_CORE_06351 @brief Copy assignment deleted. */
+  Promise &operator=(const Promise &) = delete;
+
+  /** @SWS_CORE_06343 @brief Move assignment. */
+  Promise &operator=(Promise &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      m_state = other.m_state;
+      other.m_state = nullptr;
+    }
+    return *this;
+  }
+
+  /** @SWS_CORE_06349 @brief Destructor. */
+  ~Promise() noexcept {
+    Reset();
+  }
+
+  /** @SWS_CORE_06353 @brief Set error (rvalue). */
+  void SetError(E &&error) noexcept(std::is_nothrow_move_constructible<E>::value) {
+    SetResult(Result<void, E>(std::move(error)));
+  }
+
+  /** @SWS_CORE_06354 @brief Set error (lvalue). */
+  void SetError(const E &error) noexcept(std::is_nothrow_copy_constructible<E>::value) {
+    SetResult(Result<void, E>(error));
+  }
+
+  /** @SWS_CORE_06356 @brief Set result (rvalue). */
+  void SetResult(Result<void, E> &&result) noexcept(std::is_nothrow_move_constructible<E>::value) {
+    if (nullptr != m_state) {
+      m_state->SetResult(std::move(result));
+    }
+  }
+
+  /** @SWS_CORE_06355 @brief Set result (lvalue). */
+  void
+  SetResult(const Result<void, E> &result) noexcept(std::is_nothrow_copy_constructible<E>::value) {
+    SetResult(Result<void, E>(result));
+  }
+
+  /** @SWS_CORE_06344 @brief Get Future from Promise. */
+  Future<void, E> get_future() noexcept {
+    if (nullptr != m_state) {
+      m_state->Retain();
+    }
+    return Future<void, E>(m_state);
+  }
+
+  /** @SWS_CORE_06345 @brief Set void value. */
+  void set_value() noexcept {
+    SetResult(Result<void, E>());
+  }
+
+  /** @SWS_CORE_06352 @brief Swap with another Promise. */
+  void swap(Promise &other) noexcept {
+    std::swap(m_state, other.m_state);
+  }
+
+private:
+  void Reset() noexcept {
+    if (nullptr != m_state) {
+      if (false == m_state->IsReady()) {
+        m_state->SetResult(
+          Result<void, E>(internal::FutureError<E>::Make(FutureErrc::kBrokenPromise)));
+      }
+      m_state->Release();
+      m_state = nullptr;
+    }
+  }
+
+private:
+  State *m_state;
 };
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
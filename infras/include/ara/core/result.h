@@ -520,21 +520,22 @@ public:
 
   /** @SWS_CORE_00825 @brief Copy constructor. */
   Result(const Result &other) noexcept(std::is_nothrow_copy_constructible<E>::value)
-    : m_error(other.m_error) {
+    : m_hasValue(other.m_hasValue), m_error(other.m_error) {
   }
 
   /** @SWS_CORE_00826 @brief Move constructor. */
   Result(Result &&other) noexcept(std::is_nothrow_move_constructible<E>::value)
-    : m_error(std::move(other.m_error)) {
+    : m_hasValue(other.m_hasValue), m_error(std::move(other.m_error)) {
   }
 
   /** @SWS_CORE_00821 @brief Default constructor. */
-  Result() noexcept : m_error() {
+  Result() noexcept : m_hasValue(true), m_error() {
   }
 
   /** @SWS_CORE_00842 @brief Move assignment. */
   Result &operator=(Result &&other) noexcept(std::is_nothrow_move_constructible<E>::value &&
                                              std::is_nothrow_move_assignable<E>::value) {
+    m_hasValue = other.m_hasValue;
     m_error = std::move(other.m_error);
     return *this;
   }
@@ -542,17 +543,19 @@ public:
   /** @SWS_CORE_00841 @brief Copy assignment. */
   Result &operator=(const Result &other) noexcept(std::is_nothrow_copy_constructible<E>::value &&
                                                   std::is_nothrow_copy_assignable<E>::value) {
+    m_hasValue = other.m_hasValue;
     m_error = other.m_error;
     return *this;
   }
 
   /** @SWS_CORE_00824 @brief Constructor from error rvalue. */
   explicit Result(E &&e) noexcept(std::is_nothrow_move_constructible<E>::value)
-    : m_error(std::move(e)) {
+    : m_hasValue(false), m_error(std::move(e)) {
   }
 
   /** @SWS_CORE_00823 @brief Constructor from error lvalue. */
-  explicit Result(const E &e) noexcept(std::is_nothrow_copy_constructible<E>::value) : m_error(e) {
+  explicit Result(const E &e) noexcept(std::is_nothrow_copy_constructible<E>::value)
+    : m_hasValue(false), m_error(e) {
   }
 
   /** @SWS_CORE_00865 @brief Check for error. */
@@ -560,25 +563,32 @@ public:
     return (Error() == error);
   }
 
+  /** @SWS_CORE_00851 @brief Check whether *this contains a value. */
+  bool HasValue() const noexcept {
+    return m_hasValue;
+  }
+
   /** @SWS_CORE_00844 @brief Emplace error in-place. */
   template <typename... Args>
   void EmplaceError(Args &&...args) noexcept(std::is_nothrow_constructible<E, Args...>::value) {
+    m_hasValue = false;
     m_error = E(std::forward<Args>(args)...);
   }
 
   /** @SWS_CORE_00843 @brief Emplace value in-place. */
   template <typename... Args> void EmplaceValue(Args &&...args) noexcept {
+    m_hasValue = true;
     m_error = E();
   }
 
   /** @SWS_CORE_00868 @brief Return error as Optional (const lvalue). */
   Optional<E> Err() const & noexcept(std::is_nothrow_constructible<Optional<E>, const E &>::value) {
-    return (m_error == E()) ? nullopt : Optional<E>(m_error);
+    return m_hasValue ? nullopt : Optional<E>(m_error);
   }
 
   /** @SWS_CORE_00869 @brief Return error as Optional (rvalue). */
   Optional<E> Err() && noexcept(std::is_nothrow_constructible<Optional<E>, E &&>::value) {
-    return (m_error == E()) ? nullopt : Optional<E>(std::move(m_error));
+    return m_hasValue ? nullopt : Optional<E>(std::move(m_error));
   }
 
   /** @SWS_CORE_00858 @brief Access error (rvalue). */
@@ -600,17 +610,18 @@ public:
   template <typename G>
   E ErrorOr(G &&defaultError) && noexcept(std::is_nothrow_move_constructible<E>::value &&
                                           std::is_nothrow_constructible<E, G &&>::value) {
-    return (m_error != E()) ? std::move(m_error) : E(std::forward<G>(defaultError));
+    return m_hasValue ? E(std::forward<G>(defaultError)) : std::move(m_error);
   }
 
   /** @SWS_CORE_00866 @brief Return the contained value or throw an exception (void). */
   void ValueOrThrow() const & noexcept(false) {
-    if (m_error != E()) {
+    if (false == m_hasValue) {
       throw std::runtime_error("Result contains error");
     }
   }
 
 private:
+  bool m_hasValue = true;
   E m_error;
 };
 
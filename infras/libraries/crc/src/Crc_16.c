@@ -7,6 +7,7 @@
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "Crc.h"
+#include "Std_Compiler.h"
 /* ================================ [ MACROS    ] ============================================== */
 #define crc_update crc16_update
 /* ================================ [ TYPES     ] ============================================== */
@@ -15,6 +16,36 @@
 /* ================================ [ LOCALS    ] ============================================== */
 #include "crc16/crc16.h"
 #include "crc16/crc16.c"
+
+#ifdef CRC_USE_SLICE_BY_8
+/* crc16_slice[k][n] is the CRC of byte n followed by k + 1 zero bytes */
+static uint16_t crc16_slice[7][256];
+
+INITIALIZER(crc16_slice_init) {
+  uint32_t n, k;
+  uint16_t crc;
+
+  for (n = 0; n < 256u; n++) {
+    crc = (uint16_t)crc_table[n];
+    for (k = 0; k < 7u; k++) {
+      crc = (uint16_t)(crc_table[crc >> 8] ^ (crc << 8));
+      crc16_slice[k][n] = crc;
+    }
+  }
+}
+
+static uint16_t crc16_slice_update(uint16_t crc, const uint8_t *data, uint32_t length) {
+  while (length >= 8u) {
+    crc = crc16_slice[6][data[0] ^ (crc >> 8)] ^ crc16_slice[5][data[1] ^ (crc & 0xFFu)] ^
+          crc16_slice[4][data[2]] ^ crc16_slice[3][data[3]] ^ crc16_slice[2][data[4]] ^
+          crc16_slice[1][data[5]] ^ crc16_slice[0][data[6]] ^ (uint16_t)crc_table[data[7]];
+    data += 8;
+    length -= 8u;
+  }
+
+  return (uint16_t)crc_update(crc, data, length);
+}
+#endif
 /* ================================ [ FUNCTIONS ] ============================================== */
 uint16_t Crc_CalculateCRC16(const uint8_t *Crc_DataPtr, uint32_t Crc_Length,
                             uint16_t Crc_StartValue16, boolean Crc_IsFirstCall) {
@@ -24,7 +55,11 @@ uint16_t Crc_CalculateCRC16(const uint8_t *Crc_DataPtr, uint32_t Crc_Length,
     u16Crc = crc_finalize(u16Crc);
   }
 
+#ifdef CRC_USE_SLICE_BY_8
+  u16Crc = crc16_slice_update(u16Crc, Crc_DataPtr, Crc_Length);
+#else
   u16Crc = crc_update(u16Crc, Crc_DataPtr, Crc_Length);
+#endif
 
   u16Crc = crc_finalize(u16Crc);
 
@@ -7,6 +7,7 @@
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "Crc.h"
+#include "Std_Compiler.h"
 #ifndef DISABLE_CRC32
 /* ================================ [ MACROS    ] ============================================== */
 #define crc_update crc32p4_update
@@ -16,6 +17,43 @@
 /* ================================ [ LOCALS    ] ============================================== */
 #include "crc32p4/crc32p4.h"
 #include "crc32p4/crc32p4.c"
+
+#ifdef CRC_USE_SLICE_BY_8
+/* crc32p4_slice[k][n] is the CRC of byte n followed by k + 1 zero bytes */
+static uint32_t crc32p4_slice[7][256];
+
+INITIALIZER(crc32p4_slice_init) {
+  uint32_t n, k;
+  uint32_t crc;
+
+  for (n = 0; n < 256u; n++) {
+    crc = (uint32_t)crc_table[n];
+    for (k = 0; k < 7u; k++) {
+      crc = (uint32_t)crc_table[crc & 0xFFu] ^ (crc >> 8);
+      crc32p4_slice[k][n] = crc;
+    }
+  }
+}
+
+static uint32_t crc32p4_slice_update(uint32_t crc, const uint8_t *data, uint32_t length) {
+  uint32_t one, two;
+
+  while (length >= 8u) {
+    one = crc ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+                 ((uint32_t)data[3] << 24));
+    two = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) |
+          ((uint32_t)data[7] << 24);
+    crc = crc32p4_slice[6][one & 0xFFu] ^ crc32p4_slice[5][(one >> 8) & 0xFFu] ^
+          crc32p4_slice[4][(one >> 16) & 0xFFu] ^ crc32p4_slice[3][one >> 24] ^
+          crc32p4_slice[2][two & 0xFFu] ^ crc32p4_slice[1][(two >> 8) & 0xFFu] ^
+          crc32p4_slice[0][(two >> 16) & 0xFFu] ^ (uint32_t)crc_table[two >> 24];
+    data += 8;
+    length -= 8u;
+  }
+
+  return (uint32_t)crc_update(crc, data, length);
+}
+#endif
 /* ================================ [ FUNCTIONS ] ============================================== */
 uint32_t Crc_CalculateCRC32P4(const uint8_t *Crc_DataPtr, uint32_t Crc_Length,
                               uint32_t Crc_StartValue32, boolean Crc_IsFirstCall) {
@@ -25,7 +63,11 @@ uint32_t Crc_CalculateCRC32P4(const uint8_t *Crc_DataPtr, uint32_t Crc_Length,
     u32Crc = crc_finalize(u32Crc);
   }
 
+#ifdef CRC_USE_SLICE_BY_8
+  u32Crc = crc32p4_slice_update(u32Crc, Crc_DataPtr, Crc_Length);
+#else
   u32Crc = crc_update(u32Crc, Crc_DataPtr, Crc_Length);
+#endif
 
   u32Crc = crc_finalize(u32Crc);
 
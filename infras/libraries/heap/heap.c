@@ -4,6 +4,7 @@
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <sys/queue.h>
@@ -21,7 +22,7 @@
 #endif
 
 #if defined(linux) || defined(_WIN32)
-#ifndef HEAP_TRACK
+#if !defined(HEAP_TRACK) && !defined(USE_HEAP_TLSF)
 #define HEAP_TRACK
 #endif
 #endif
@@ -49,16 +50,99 @@
 
 #define HEAP_ALIGN(x) HEAP_ALIGN_BY(x, HEAP_MIN_ALIGNED_SIZE)
 
-#define HEAP_MAGIC_SIZE HEAP_ALIGN(sizeof(heap_magic_t))
-
 #ifndef HEAP_SIZE
 #define HEAP_SIZE (1 * 1024 * 1024)
 #endif
 
 #define HEAP_ADDR(addr, offset) (((uint8_t *)(addr)) + offset)
+
+#ifdef USE_HEAP_TLSF
+/* Two-Level Segregated Fit: the free blocks are kept in HEAP_FL_INDEX_COUNT x HEAP_SL_INDEX_COUNT
+ * lists, the first level is the power of 2 size class and the second level splits it linearly,
+ * the 2 bitmaps make malloc/free/memalign O(1) whatever the fragmentation is. */
+#ifndef HEAP_SL_INDEX_COUNT_LOG2
+#define HEAP_SL_INDEX_COUNT_LOG2 4
+#endif
+#define HEAP_SL_INDEX_COUNT (1u << HEAP_SL_INDEX_COUNT_LOG2)
+
+#if HEAP_MIN_ALIGNED_SIZE == 8
+#define HEAP_ALIGN_SIZE_LOG2 3
+#elif HEAP_MIN_ALIGNED_SIZE == 16
+#define HEAP_ALIGN_SIZE_LOG2 4
+#elif HEAP_MIN_ALIGNED_SIZE == 32
+#define HEAP_ALIGN_SIZE_LOG2 5
+#elif HEAP_MIN_ALIGNED_SIZE == 64
+#define HEAP_ALIGN_SIZE_LOG2 6
+#else
+#error "HEAP_MIN_ALIGNED_SIZE must be 8, 16, 32 or 64 for TLSF"
+#endif
+
+/* blocks smaller than this are all in first level list 0, split by HEAP_MIN_ALIGNED_SIZE */
+#define HEAP_FL_INDEX_SHIFT (HEAP_SL_INDEX_COUNT_LOG2 + HEAP_ALIGN_SIZE_LOG2)
+#define HEAP_SMALL_BLOCK_SIZE (1u << HEAP_FL_INDEX_SHIFT)
+
+/* log2 of the size that no block could reach, decides the number of first level lists */
+#ifndef HEAP_FL_INDEX_MAX
+#if HEAP_SIZE <= (64 * 1024)
+#define HEAP_FL_INDEX_MAX 16
+#elif HEAP_SIZE <= (1024 * 1024)
+#define HEAP_FL_INDEX_MAX 20
+#elif HEAP_SIZE <= (16 * 1024 * 1024)
+#define HEAP_FL_INDEX_MAX 24
+#elif HEAP_SIZE <= (256 * 1024 * 1024)
+#define HEAP_FL_INDEX_MAX 28
+#else
+#define HEAP_FL_INDEX_MAX 31
+#endif
+#endif
+#define HEAP_FL_INDEX_COUNT (HEAP_FL_INDEX_MAX - HEAP_FL_INDEX_SHIFT + 1)
+
+#define HEAP_BLOCK_FREE 0x1u
+#define HEAP_BLOCK_PREV_FREE 0x2u
+#define HEAP_BLOCK_FLAGS (HEAP_BLOCK_FREE | HEAP_BLOCK_PREV_FREE)
+
+/* the header of a used block, the payload follows it */
+#define HEAP_MAGIC_SIZE HEAP_ALIGN(offsetof(heap_block_t, next))
+/* a free block must be able to hold the free list links */
+#define HEAP_BLOCK_MIN_SIZE HEAP_ALIGN(sizeof(heap_block_t))
+/* the zero sized used block at the end, so the last block always has a next */
+#define HEAP_SENTINEL_SIZE HEAP_BLOCK_MIN_SIZE
+
+#define HEAP_BLOCK_SIZE(b) ((b)->size & (~HEAP_BLOCK_FLAGS))
+#define HEAP_BLOCK_IS_FREE(b) (0u != ((b)->size & HEAP_BLOCK_FREE))
+#define HEAP_BLOCK_IS_PREV_FREE(b) (0u != ((b)->size & HEAP_BLOCK_PREV_FREE))
+#define HEAP_BLOCK_NEXT(b) ((heap_block_t *)HEAP_ADDR(b, HEAP_BLOCK_SIZE(b)))
+#define HEAP_BLOCK_PREV(b) ((heap_block_t *)HEAP_ADDR(b, -(int32_t)(b)->prev_size))
+#define HEAP_BLOCK_OF(pMem) ((heap_block_t *)HEAP_ADDR(pMem, -HEAP_MAGIC_SIZE))
+#define HEAP_BLOCK_MEM(b) ((void *)HEAP_ADDR(b, HEAP_MAGIC_SIZE))
+#else
+#define HEAP_MAGIC_SIZE HEAP_ALIGN(sizeof(heap_magic_t))
+#endif
 /* ================================ [ TYPES     ] ============================================== */
 typedef HEAP_SYSTEM_BASE_TYPE heap_base_t;
 
+#ifdef USE_HEAP_TLSF
+/* physical blocks are contiguous, the heap ends with a zero sized used block as sentinel */
+typedef struct heap_block_s {
+  uint32_t prev_size; /* size of the previous physical block, valid only if it is free */
+  uint32_t size;      /* size including this header, the low 2 bits are HEAP_BLOCK_FLAGS */
+  uint32_t rsz;       /* real size for realloc */
+  /* below only valid when this block is free */
+  struct heap_block_s *next;
+  struct heap_block_s *prev;
+} heap_block_t;
+
+typedef struct {
+  uint32_t flBitmap;
+  uint32_t slBitmap[HEAP_FL_INDEX_COUNT];
+  heap_block_t *blocks[HEAP_FL_INDEX_COUNT][HEAP_SL_INDEX_COUNT];
+  uint32_t freeSize;
+  uint32_t minFreeSize;
+  uint32_t numOfFreeBlocks;
+  uint32_t numOfUsedBlocks;
+  uint8_t initialized;
+} heap_t;
+#else
 /* a heap block is a memory that is free */
 typedef struct heap_block_s {
   SLIST_ENTRY(heap_block_s) entry;
@@ -79,19 +163,247 @@ typedef struct {
 #ifdef HEAP_TRACK
   SLIST_HEAD(heap_block_used_s, heap_magic_s) used;
 #endif
+  uint32_t freeSize;
+  uint32_t minFreeSize;
+  uint32_t numOfUsedBlocks;
   uint8_t initialized;
 } heap_t;
+#endif
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 static heap_base_t lHeapMem[HEAP_SIZE / sizeof(heap_base_t)];
+#ifdef USE_HEAP_TLSF
+static heap_t lHeap;
+#else
 static heap_t lHeap = {
   SLIST_HEAD_INITIALIZER(free),
 #ifdef HEAP_TRACK
   SLIST_HEAD_INITIALIZER(used),
 #endif
   0,
+  0,
+  0,
+  0,
 };
+#endif
 /* ================================ [ LOCALS    ] ============================================== */
+#ifdef USE_HEAP_TLSF
+#if defined(__GNUC__)
+static inline int heap_ffs(uint32_t word) {
+  return __builtin_ffs((int)word) - 1;
+}
+
+static inline int heap_fls(uint32_t word) {
+  return (0u != word) ? (31 - __builtin_clz(word)) : -1;
+}
+#else
+static int heap_ffs(uint32_t word) {
+  int bit = -1;
+  int i;
+
+  for (i = 0; (i < 32) && (-1 == bit); i++) {
+    if (0u != (word & (1u << i))) {
+      bit = i;
+    }
+  }
+
+  return bit;
+}
+
+static int heap_fls(uint32_t word) {
+  int bit = -1;
+  int i;
+
+  for (i = 31; (i >= 0) && (-1 == bit); i--) {
+    if (0u != (word & (1u << i))) {
+      bit = i;
+    }
+  }
+
+  return bit;
+}
+#endif
+
+static void heap_mapping_insert(uint32_t size, int *fl, int *sl) {
+  if (size < HEAP_SMALL_BLOCK_SIZE) {
+    *fl = 0;
+    *sl = (int)(size >> HEAP_ALIGN_SIZE_LOG2);
+  } else {
+    *fl = heap_fls(size);
+    *sl = (int)((size >> (*fl - HEAP_SL_INDEX_COUNT_LOG2)) ^ HEAP_SL_INDEX_COUNT);
+    *fl -= (HEAP_FL_INDEX_SHIFT - 1);
+  }
+}
+
+/* round the size up to the next list so that any block of that list is big enough */
+static void heap_mapping_search(uint32_t size, int *fl, int *sl) {
+  uint32_t round;
+
+  if (size >= HEAP_SMALL_BLOCK_SIZE) {
+    round = (1u << (heap_fls(size) - HEAP_SL_INDEX_COUNT_LOG2)) - 1u;
+    size += round;
+  }
+  heap_mapping_insert(size, fl, sl);
+}
+
+static heap_block_t *heap_search_suitable_block(int *fl, int *sl) {
+  heap_block_t *block = NULL;
+  uint32_t slMap = 0;
+  uint32_t flMap;
+
+  if (*fl < HEAP_FL_INDEX_COUNT) {
+    slMap = lHeap.slBitmap[*fl] & (~0u << *sl);
+    if (0u == slMap) {
+      flMap = (*fl + 1 < 32) ? (lHeap.flBitmap & (~0u << (*fl + 1))) : 0u;
+      if (0u != flMap) {
+        *fl = heap_ffs(flMap);
+        slMap = lHeap.slBitmap[*fl];
+      }
+    }
+  }
+
+  if (0u != slMap) {
+    *sl = heap_ffs(slMap);
+    block = lHeap.blocks[*fl][*sl];
+  }
+
+  return block;
+}
+
+static void heap_insert_free_block(heap_block_t *block) {
+  int fl, sl;
+  heap_block_t *next = HEAP_BLOCK_NEXT(block);
+
+  asAssert(HEAP_ADDR(block, 0) >= HEAP_ADDR(lHeapMem, 0));
+  asAssert(HEAP_ADDR(next, HEAP_SENTINEL_SIZE) <= HEAP_ADDR(lHeapMem, sizeof(lHeapMem)));
+  heap_mapping_insert(HEAP_BLOCK_SIZE(block), &fl, &sl);
+  block->size |= HEAP_BLOCK_FREE;
+  block->prev = NULL;
+  block->next = lHeap.blocks[fl][sl];
+  if (NULL != block->next) {
+    block->next->prev = block;
+  }
+  lHeap.blocks[fl][sl] = block;
+  lHeap.flBitmap |= (1u << fl);
+  lHeap.slBitmap[fl] |= (1u << sl);
+  next->prev_size = HEAP_BLOCK_SIZE(block);
+  next->size |= HEAP_BLOCK_PREV_FREE;
+  lHeap.freeSize += HEAP_BLOCK_SIZE(block);
+  lHeap.numOfFreeBlocks++;
+}
+
+static void heap_remove_free_block(heap_block_t *block) {
+  int fl, sl;
+
+  heap_mapping_insert(HEAP_BLOCK_SIZE(block), &fl, &sl);
+  if (NULL != block->next) {
+    block->next->prev = block->prev;
+  }
+  if (NULL != block->prev) {
+    block->prev->next = block->next;
+  } else {
+    lHeap.blocks[fl][sl] = block->next;
+    if (NULL == block->next) {
+      lHeap.slBitmap[fl] &= ~(1u << sl);
+      if (0u == lHeap.slBitmap[fl]) {
+        lHeap.flBitmap &= ~(1u << fl);
+      }
+    }
+  }
+  block->size &= ~HEAP_BLOCK_FREE;
+  HEAP_BLOCK_NEXT(block)->size &= ~HEAP_BLOCK_PREV_FREE;
+  lHeap.freeSize -= HEAP_BLOCK_SIZE(block);
+  lHeap.numOfFreeBlocks--;
+}
+
+/* merge the used block with its free neighbours and put the result into the free lists */
+static void heap_release_block(heap_block_t *block) {
+  heap_block_t *b;
+
+  if (HEAP_BLOCK_IS_PREV_FREE(block)) {
+    b = HEAP_BLOCK_PREV(block);
+    ASLOG(HEAP, ("  merge with before %u@%p\n", (uint32_t)HEAP_BLOCK_SIZE(b), b));
+    heap_remove_free_block(b);
+    b->size += HEAP_BLOCK_SIZE(block);
+    block = b;
+  }
+
+  b = HEAP_BLOCK_NEXT(block);
+  if (HEAP_BLOCK_IS_FREE(b)) {
+    ASLOG(HEAP, ("  merge with after %u@%p\n", (uint32_t)HEAP_BLOCK_SIZE(b), b));
+    heap_remove_free_block(b);
+    block->size += HEAP_BLOCK_SIZE(b);
+  }
+
+  heap_insert_free_block(block);
+}
+
+/* give back the tail of the block beyond size */
+static void heap_trim_block(heap_block_t *block, uint32_t size) {
+  heap_block_t *b;
+
+  if (HEAP_BLOCK_SIZE(block) >= (size + HEAP_BLOCK_MIN_SIZE)) {
+    b = (heap_block_t *)HEAP_ADDR(block, size);
+    b->size = HEAP_BLOCK_SIZE(block) - size;
+    block->size = size | (block->size & HEAP_BLOCK_FLAGS);
+    heap_release_block(b);
+  }
+}
+
+static void *heap_use_block(heap_block_t *block, uint32_t size, uint32_t rsz) {
+  heap_remove_free_block(block);
+  heap_trim_block(block, size);
+  block->rsz = rsz;
+  lHeap.numOfUsedBlocks++;
+  if (lHeap.freeSize < lHeap.minFreeSize) {
+    lHeap.minFreeSize = lHeap.freeSize;
+  }
+  ASLOG(HEAP, ("  use(%u@%p)\n", (uint32_t)HEAP_BLOCK_SIZE(block), block));
+  return HEAP_BLOCK_MEM(block);
+}
+
+static uint32_t heap_adjust_size(uint32_t size) {
+  uint32_t adjust = 0;
+
+  if (size <= (sizeof(lHeapMem) - HEAP_MAGIC_SIZE)) {
+    adjust = HEAP_ALIGN(size) + HEAP_MAGIC_SIZE;
+    if (adjust < HEAP_BLOCK_MIN_SIZE) {
+      adjust = HEAP_BLOCK_MIN_SIZE;
+    }
+  }
+
+  return adjust;
+}
+
+static uint32_t heap_max_free_block(void) {
+  uint32_t maxSize = 0;
+  heap_block_t *b;
+  int fl, sl;
+
+  if (0u != lHeap.flBitmap) {
+    fl = heap_fls(lHeap.flBitmap);
+    sl = heap_fls(lHeap.slBitmap[fl]);
+    for (b = lHeap.blocks[fl][sl]; NULL != b; b = b->next) {
+      if (HEAP_BLOCK_SIZE(b) > maxSize) {
+        maxSize = HEAP_BLOCK_SIZE(b);
+      }
+    }
+  }
+
+  return maxSize;
+}
+
+#ifdef USE_SHELL
+static void heap_dump(void) {
+  heap_block_t *b = (heap_block_t *)lHeapMem;
+
+  while (HEAP_BLOCK_SIZE(b) > 0u) {
+    PRINTF("  %s: %u@%p\n", HEAP_BLOCK_IS_FREE(b) ? "free" : "used", HEAP_BLOCK_SIZE(b), b);
+    b = HEAP_BLOCK_NEXT(b);
+  }
+}
+#endif
+#else
 static void heap_add_block(heap_block_t *block) {
   heap_block_t *b;
   heap_block_t *prev = NULL;
@@ -118,14 +430,20 @@ static void heap_add_block(heap_block_t *block) {
 #endif
 }
 
+static void heap_account_used(uint32_t size) {
+  lHeap.freeSize -= size;
+  lHeap.numOfUsedBlocks++;
+  if (lHeap.freeSize < lHeap.minFreeSize) {
+    lHeap.minFreeSize = lHeap.freeSize;
+  }
+}
+
 #ifdef USE_SHELL
-static int freeFunc(int argc, const char *argv[]) {
+static void heap_dump(void) {
   heap_block_t *b;
 #ifdef HEAP_TRACK
   heap_magic_t *m;
 #endif
-  size_t free_size = heap_free_size();
-  PRINTF("free %u%%(%ub)\n", (uint32_t)(free_size * 100 / sizeof(lHeapMem)), (uint32_t)free_size);
   SLIST_FOREACH(b, &lHeap.free, entry) {
     PRINTF("  free: %u@%p\n", (uint32_t)b->size, b);
   }
@@ -134,12 +452,215 @@ static int freeFunc(int argc, const char *argv[]) {
     PRINTF("  used: %u@%p\n", (uint32_t)m->size, m);
   }
 #endif
+}
+#endif
+#endif
+
+#ifdef USE_SHELL
+static int freeFunc(int argc, const char *argv[]) {
+  heap_stats_t stats;
+
+  heap_get_stats(&stats);
+  PRINTF("free %u%%(%ub)\n", (uint32_t)(stats.freeSize * 100 / sizeof(lHeapMem)),
+         (uint32_t)stats.freeSize);
+  PRINTF("  min free %ub, largest free block %ub, fragmentation %u%%\n", stats.minFreeSize,
+         stats.maxFreeBlock, stats.fragmentation);
+  PRINTF("  %u free blocks, %u used blocks\n", stats.numOfFreeBlocks, stats.numOfUsedBlocks);
+  heap_dump();
   return 0;
 }
 SHELL_REGISTER(free, "free - show heap status\n", freeFunc);
 #endif
 
 /* ================================ [ FUNCTIONS ] ============================================== */
+#ifdef USE_HEAP_TLSF
+void heap_init(void) {
+  heap_block_t *block;
+  heap_block_t *sentinel;
+
+  if (0 == lHeap.initialized) {
+    memset(&lHeap, 0, sizeof(lHeap));
+    block = (heap_block_t *)lHeapMem;
+    block->prev_size = 0;
+    block->size = sizeof(lHeapMem) - HEAP_SENTINEL_SIZE;
+    sentinel = HEAP_BLOCK_NEXT(block);
+    sentinel->size = 0;
+    heap_insert_free_block(block);
+    lHeap.minFreeSize = lHeap.freeSize;
+    ASLOG(HEAP, ("Heap: %u@%p\n", (uint32_t)HEAP_BLOCK_SIZE(block), block));
+    lHeap.initialized = 1;
+  }
+}
+
+void *heap_malloc(uint32_t size) {
+  void *pMem = NULL;
+  uint32_t adjust = heap_adjust_size(size);
+  heap_block_t *block = NULL;
+  int fl, sl;
+
+  HEAP_LOCK();
+  if (0 == lHeap.initialized) {
+    heap_init();
+  }
+  ASLOG(HEAP, ("malloc(%u)\n", (uint32_t)size));
+  if (adjust > 0u) {
+    heap_mapping_search(adjust, &fl, &sl);
+    block = heap_search_suitable_block(&fl, &sl);
+  }
+  if (NULL != block) {
+    pMem = heap_use_block(block, adjust, size);
+  } else {
+    ASLOG(HEAPE, ("  malloc OoM for %u\n", (uint32_t)size));
+  }
+  HEAP_UNLOCK();
+
+  return pMem;
+}
+
+void *heap_realloc(void *pMem, uint32_t size) {
+  heap_block_t *block;
+  heap_block_t *next;
+  uint32_t adjust = heap_adjust_size(size);
+  void *newPtr = NULL;
+  uint32_t sz = 0;
+
+  if (NULL == pMem) {
+    newPtr = heap_malloc(size);
+  } else if (adjust > 0u) {
+    block = HEAP_BLOCK_OF(pMem);
+    HEAP_LOCK();
+    next = HEAP_BLOCK_NEXT(block);
+    if (adjust <= HEAP_BLOCK_SIZE(block)) {
+      heap_trim_block(block, adjust);
+      newPtr = pMem;
+    } else if (HEAP_BLOCK_IS_FREE(next) &&
+               ((HEAP_BLOCK_SIZE(block) + HEAP_BLOCK_SIZE(next)) >= adjust)) {
+      /* grow in place by taking the free block behind */
+      heap_remove_free_block(next);
+      block->size += HEAP_BLOCK_SIZE(next);
+      heap_trim_block(block, adjust);
+      if (lHeap.freeSize < lHeap.minFreeSize) {
+        lHeap.minFreeSize = lHeap.freeSize;
+      }
+      newPtr = pMem;
+    } else {
+      sz = block->rsz;
+    }
+    if (NULL != newPtr) {
+      block->rsz = size;
+    }
+    HEAP_UNLOCK();
+    if (NULL == newPtr) {
+      newPtr = heap_malloc(size);
+      if (NULL != newPtr) {
+        memcpy(newPtr, pMem, sz);
+        heap_free(pMem);
+      }
+    }
+  } else {
+    /* size too big */
+  }
+
+  if (NULL == newPtr) {
+    ASLOG(HEAPE, ("  realloc OoM for %u\n", (uint32_t)size));
+  }
+
+  return newPtr;
+}
+
+void heap_free(void *pMem) {
+  heap_block_t *block = HEAP_BLOCK_OF(pMem);
+
+  HEAP_LOCK();
+  ASLOG(HEAP, ("free(%u@%p)\n", (uint32_t)HEAP_BLOCK_SIZE(block), block));
+  asAssert(0 != lHeap.initialized);
+  asAssert(0u == (block->size & HEAP_BLOCK_FREE));
+  lHeap.numOfUsedBlocks--;
+  heap_release_block(block);
+  HEAP_UNLOCK();
+}
+
+uint32_t heap_free_size(void) {
+  uint32_t sz;
+
+  HEAP_LOCK();
+  if (0 == lHeap.initialized) {
+    heap_init();
+  }
+  sz = lHeap.freeSize;
+  HEAP_UNLOCK();
+
+  return sz;
+}
+
+void *heap_memalign(uint32_t alignment, uint32_t size) {
+  void *pMem = NULL;
+  uint32_t adjust = heap_adjust_size(size);
+  uint32_t gap;
+  uintptr_t aligned;
+  heap_block_t *block = NULL;
+  heap_block_t *b;
+  int fl, sl;
+
+  asAssert(0 == (alignment % HEAP_MIN_ALIGNED_SIZE));
+  asAssert(alignment >= HEAP_MIN_ALIGNED_SIZE);
+
+  HEAP_LOCK();
+  if (0 == lHeap.initialized) {
+    heap_init();
+  }
+  ASLOG(HEAP, ("memalign(%u, %u)\n", (uint32_t)alignment, (uint32_t)size));
+  if ((adjust > 0u) && ((adjust + alignment + HEAP_BLOCK_MIN_SIZE) <= sizeof(lHeapMem))) {
+    /* big enough to cut a free block in front of the aligned memory in any case */
+    heap_mapping_search(adjust + alignment + HEAP_BLOCK_MIN_SIZE, &fl, &sl);
+    block = heap_search_suitable_block(&fl, &sl);
+  }
+
+  if (NULL != block) {
+    aligned = HEAP_ALIGN_BY((uintptr_t)HEAP_BLOCK_MEM(block), (uintptr_t)alignment);
+    gap = (uint32_t)(aligned - (uintptr_t)HEAP_BLOCK_MEM(block));
+    if ((gap > 0u) && (gap < HEAP_BLOCK_MIN_SIZE)) {
+      aligned = HEAP_ALIGN_BY(aligned + HEAP_BLOCK_MIN_SIZE, (uintptr_t)alignment);
+      gap = (uint32_t)(aligned - (uintptr_t)HEAP_BLOCK_MEM(block));
+    }
+    if (gap > 0u) {
+      heap_remove_free_block(block);
+      b = (heap_block_t *)HEAP_ADDR(block, gap);
+      b->size = HEAP_BLOCK_SIZE(block) - gap;
+      block->size = gap | (block->size & HEAP_BLOCK_FLAGS);
+      heap_insert_free_block(block);
+      heap_insert_free_block(b);
+      block = b;
+    }
+    pMem = heap_use_block(block, adjust, size);
+    ASLOG(HEAP, ("  memalign(%u@%p) = %p\n", (uint32_t)HEAP_BLOCK_SIZE(block), block, pMem));
+  } else {
+    ASLOG(HEAPE, ("  memalign OoM for %u\n", (uint32_t)size));
+  }
+  HEAP_UNLOCK();
+
+  return pMem;
+}
+
+void heap_get_stats(heap_stats_t *stats) {
+  HEAP_LOCK();
+  if (0 == lHeap.initialized) {
+    heap_init();
+  }
+  stats->size = sizeof(lHeapMem);
+  stats->freeSize = lHeap.freeSize;
+  stats->minFreeSize = lHeap.minFreeSize;
+  stats->maxFreeBlock = heap_max_free_block();
+  stats->numOfFreeBlocks = lHeap.numOfFreeBlocks;
+  stats->numOfUsedBlocks = lHeap.numOfUsedBlocks;
+  HEAP_UNLOCK();
+  stats->fragmentation = 0;
+  if (stats->freeSize > 0u) {
+    stats->fragmentation =
+      100u - (uint32_t)(((uint64_t)stats->maxFreeBlock * 100u) / stats->freeSize);
+  }
+}
+#else
 void heap_init(void) {
   heap_block_t *block;
 
@@ -152,6 +673,9 @@ void heap_init(void) {
 #ifdef HEAP_TRACK
     SLIST_INIT(&lHeap.used);
 #endif
+    lHeap.freeSize = sizeof(lHeapMem);
+    lHeap.minFreeSize = sizeof(lHeapMem);
+    lHeap.numOfUsedBlocks = 0;
     lHeap.initialized = 1;
   }
 }
@@ -199,6 +723,7 @@ void *heap_malloc(uint32_t size) {
       pMagic->size = aligned_size + left_size;
     }
     pMagic->rsz = size;
+    heap_account_used(pMagic->size);
     ASLOG(HEAP, ("  malloc(%u@%p)\n", (uint32_t)pMagic->size, HEAP_ADDR(pMem, -HEAP_MAGIC_SIZE)));
 #ifdef HEAP_TRACK
     SLIST_INSERT_HEAD(&lHeap.used, pMagic, entry);
@@ -272,6 +797,8 @@ void heap_free(void *pMem) {
 #ifdef HEAP_TRACK
   SLIST_REMOVE(&lHeap.used, pMagic, heap_magic_s, entry);
 #endif
+  lHeap.freeSize += size;
+  lHeap.numOfUsedBlocks--;
 
   if ((NULL != before) && (NULL != after)) {
     ASLOG(HEAP, ("  merge with before %u@%p and after %u@%p\n", (uint32_t)before->size, before,
@@ -317,16 +844,13 @@ void heap_free(void *pMem) {
 }
 
 uint32_t heap_free_size(void) {
-  uint32_t sz = 0;
-  heap_block_t *b;
+  uint32_t sz;
 
   HEAP_LOCK();
   if (0 == lHeap.initialized) {
     heap_init();
   }
-  SLIST_FOREACH(b, &lHeap.free, entry) {
-    sz += b->size;
-  }
+  sz = lHeap.freeSize;
   HEAP_UNLOCK();
 
   return sz;
@@ -352,13 +876,17 @@ void *heap_memalign(uint32_t alignment, uint32_t size) {
   ASLOG(HEAP, ("memalign(%u, %u)\n", (uint32_t)alignment, (uint32_t)size));
   SLIST_FOREACH(b, &lHeap.free, entry) {
     if (b->size >= aligned_size) {
-      pMem = (void *)HEAP_ALIGN_BY((uintptr_t)b, alignment);
+      /* the magic goes right before the aligned memory, the gap in front of it must be either
+       * empty or big enough to stay a free block */
+      pMem = (void *)HEAP_ALIGN_BY((uintptr_t)b + HEAP_MAGIC_SIZE, (uintptr_t)alignment);
       offset = (uintptr_t)pMem - (uintptr_t)b;
-      if ((offset == HEAP_MAGIC_SIZE) || (offset >= (2 * HEAP_MAGIC_SIZE))) {
-        if (b->size >= (offset - HEAP_MAGIC_SIZE + aligned_size)) {
-          best = b;
-          break;
-        }
+      if ((offset != HEAP_MAGIC_SIZE) && (offset < (2 * HEAP_MAGIC_SIZE))) {
+        pMem = (void *)HEAP_ALIGN_BY((uintptr_t)b + (2 * HEAP_MAGIC_SIZE), (uintptr_t)alignment);
+        offset = (uintptr_t)pMem - (uintptr_t)b;
+      }
+      if (b->size >= (offset - HEAP_MAGIC_SIZE + aligned_size)) {
+        best = b;
+        break;
       }
     }
     prev = b;
@@ -368,7 +896,7 @@ void *heap_memalign(uint32_t alignment, uint32_t size) {
 
   if (best) {
     ASLOG(HEAP, ("  Best Heap: %u@%p\n", (uint32_t)best->size, best));
-    pMem = (void *)HEAP_ALIGN_BY((uintptr_t)best, alignment);
+    pMem = (void *)HEAP_ADDR(best, offset);
     pMagic = (heap_magic_t *)HEAP_ADDR(pMem, -HEAP_MAGIC_SIZE);
 
     if (NULL == prev) {
@@ -377,8 +905,6 @@ void *heap_memalign(uint32_t alignment, uint32_t size) {
       SLIST_REMOVE_AFTER(prev, entry);
     }
 
-    offset = (uintptr_t)pMem - (uintptr_t)best;
-
     left_size = best->size - aligned_size - (offset - HEAP_MAGIC_SIZE);
     if (left_size >= sizeof(heap_block_t)) {
       b = (heap_block_t *)HEAP_ADDR(pMagic, aligned_size);
@@ -396,6 +922,8 @@ void *heap_memalign(uint32_t alignment, uint32_t size) {
       b->size = left_size;
       (void)heap_add_block(b);
     }
+    pMagic->rsz = size;
+    heap_account_used(pMagic->size);
     ASLOG(HEAP, ("  memalign(%u@%p) = %p\n", (uint32_t)pMagic->size,
                  HEAP_ADDR(pMem, -HEAP_MAGIC_SIZE), pMem));
 #ifdef HEAP_TRACK
@@ -409,6 +937,32 @@ void *heap_memalign(uint32_t alignment, uint32_t size) {
   return pMem;
 }
 
+void heap_get_stats(heap_stats_t *stats) {
+  heap_block_t *b;
+
+  HEAP_LOCK();
+  if (0 == lHeap.initialized) {
+    heap_init();
+  }
+  stats->size = sizeof(lHeapMem);
+  stats->freeSize = lHeap.freeSize;
+  stats->minFreeSize = lHeap.minFreeSize;
+  stats->maxFreeBlock = 0;
+  stats->numOfFreeBlocks = 0;
+  stats->numOfUsedBlocks = lHeap.numOfUsedBlocks;
+  SLIST_FOREACH(b, &lHeap.free, entry) {
+    stats->maxFreeBlock = b->size; /* sorted from small to large */
+    stats->numOfFreeBlocks++;
+  }
+  HEAP_UNLOCK();
+  stats->fragmentation = 0;
+  if (stats->freeSize > 0u) {
+    stats->fragmentation =
+      100u - (uint32_t)(((uint64_t)stats->maxFreeBlock * 100u) / stats->freeSize);
+  }
+}
+#endif
+
 void *heap_calloc(uint32_t nitems, uint32_t size) {
   void *ptr = heap_malloc(nitems * size);
   if (NULL != ptr) {
@@ -452,16 +1006,25 @@ void *realloc(void *ptr, size_t size) {
 #endif
 
 #ifdef HEAP_TEST
+#ifdef USE_HEAP_TLSF
+#define HEAP_USED_SIZE(ptr) HEAP_BLOCK_SIZE(HEAP_BLOCK_OF(ptr))
+#define HEAP_OVERHEAD HEAP_SENTINEL_SIZE
+#else
+#define HEAP_USED_SIZE(ptr) (((heap_magic_t *)HEAP_ADDR(ptr, -HEAP_MAGIC_SIZE))->size)
+#define HEAP_OVERHEAD 0
+#endif
 /* gcc -g infras\libraries\heap\heap.c -I infras\include -DHEAP_TEST -DAS_LOG_DEFAULT=1 */
 int main(int argc, char *argv[]) {
-  int N;
+  int N = 0;
   void **ptr;
   size_t *sz;
   int i, k;
   int doFree;
-  heap_block_t *b;
   int try;
   size_t used = 0;
+  size_t j, nsz;
+  void *p;
+  heap_stats_t stats;
 
   if (argc > 1) {
     N = atoi(argv[1]);
@@ -477,41 +1040,63 @@ int main(int argc, char *argv[]) {
   for (i = 0; i < N; i++) {
     doFree = (1 == (rand() % 2));
     sz[i] = 1 + (rand() % 1000);
-    // ptr[i] = heap_malloc(sz[i]);
-    ptr[i] = heap_memalign(4096, sz[i]);
+    if (0 == (i % 3)) {
+      ptr[i] = heap_malloc(sz[i]);
+    } else {
+      ptr[i] = heap_memalign(4096, sz[i]);
+    }
     if (ptr[i]) {
-      used += ((heap_magic_t *)HEAP_ADDR(ptr[i], -HEAP_MAGIC_SIZE))->size;
+      used += HEAP_USED_SIZE(ptr[i]);
       memset(ptr[i], i, sz[i]);
     }
-    asAssert((used + heap_free_size()) == HEAP_SIZE);
+    asAssert((used + heap_free_size()) == (HEAP_SIZE - HEAP_OVERHEAD));
+    k = rand() % (i + 1);
+    if ((0 == (i % 5)) && (NULL != ptr[k])) {
+      nsz = 1 + (rand() % 2000);
+      used -= HEAP_USED_SIZE(ptr[k]);
+      p = heap_realloc(ptr[k], nsz);
+      if (NULL != p) {
+        for (j = 0; (j < sz[k]) && (j < nsz); j++) {
+          asAssert(((uint8_t *)p)[j] == (uint8_t)k);
+        }
+        memset(p, k, nsz);
+        ptr[k] = p;
+        sz[k] = nsz;
+      }
+      used += HEAP_USED_SIZE(ptr[k]);
+      asAssert((used + heap_free_size()) == (HEAP_SIZE - HEAP_OVERHEAD));
+    }
     if (doFree) {
       try = N * 3;
       do {
         k = rand() % (i + 1);
         if (ptr[k]) {
-          used -= ((heap_magic_t *)HEAP_ADDR(ptr[k], -HEAP_MAGIC_SIZE))->size;
+          used -= HEAP_USED_SIZE(ptr[k]);
           heap_free(ptr[k]);
           ptr[k] = NULL;
           break;
         }
       } while (--try > 0);
     }
-    asAssert((used + heap_free_size()) == HEAP_SIZE);
+    asAssert((used + heap_free_size()) == (HEAP_SIZE - HEAP_OVERHEAD));
   }
 
   for (i = 0; i < N; i++) {
     if (NULL != ptr[i]) {
-      used -= ((heap_magic_t *)HEAP_ADDR(ptr[i], -HEAP_MAGIC_SIZE))->size;
+      used -= HEAP_USED_SIZE(ptr[i]);
       heap_free(ptr[i]);
 
-      asAssert((used + heap_free_size()) == HEAP_SIZE);
+      asAssert((used + heap_free_size()) == (HEAP_SIZE - HEAP_OVERHEAD));
     }
   }
 
-  PRINTF("Test Done\n");
-  SLIST_FOREACH(b, &lHeap.free, entry) {
-    ASLOG(HEAP, ("Heap: %u@%p\n", (uint32_t)b->size, b));
-  }
+  heap_get_stats(&stats);
+  asAssert(1 == stats.numOfFreeBlocks);
+  asAssert(0 == stats.numOfUsedBlocks);
+  asAssert(0 == stats.fragmentation);
+  PRINTF("Test Done, min free %u\n", stats.minFreeSize);
+  free(ptr);
+  free(sz);
   return 0;
 }
 #endif
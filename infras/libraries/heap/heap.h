@@ -8,6 +8,15 @@
 #include <stdint.h>
 /* ================================ [ MACROS    ] ============================================== */
 /* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t size;            /* the total heap size */
+  uint32_t freeSize;        /* free size right now */
+  uint32_t minFreeSize;     /* the lowest free size ever seen */
+  uint32_t maxFreeBlock;    /* the largest free block, the biggest malloc that could succeed */
+  uint32_t numOfFreeBlocks;
+  uint32_t numOfUsedBlocks;
+  uint32_t fragmentation;   /* in percent: 100 - maxFreeBlock * 100 / freeSize */
+} heap_stats_t;
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
@@ -19,6 +28,7 @@ void *heap_realloc(void *pMem, uint32_t size);
 void heap_free(void *pMem);
 uint32_t heap_free_size(void);
 void *heap_memalign(uint32_t alignment, uint32_t size);
+void heap_get_stats(heap_stats_t *stats);
 #if !defined(linux) && !defined(_WIN32)
 void *malloc(size_t sz);
 void free(void *ptr);
@@ -0,0 +1,228 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Heap latency under a randomized malloc/memalign/realloc/free workload, built once for the
+ * default size sorted free list and once with USE_HEAP_TLSF to compare the worst cases. The same
+ * workload is checked for correctness by heap_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "heap.h"
+#include "Std_Critical.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_SLOTS
+#define BENCH_SLOTS 4096
+#endif
+
+#ifndef BENCH_OPS
+#define BENCH_OPS 2000000
+#endif
+
+#define BENCH_OP_MALLOC 0
+#define BENCH_OP_FREE 1
+#define BENCH_OP_REALLOC 2
+#define BENCH_OP_MAX 3
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t *ns;
+  uint32_t num;
+  uint32_t numOfFails;
+} Bench_LatencyType;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static void *Bench_Ptrs[BENCH_SLOTS];
+static uint32_t Bench_Sizes[BENCH_SLOTS];
+static Bench_LatencyType Bench_Latency[BENCH_OP_MAX];
+static const char *Bench_OpNames[BENCH_OP_MAX] = {"malloc", "free", "realloc"};
+/* ================================ [ LOCALS    ] ============================================== */
+/* mostly small protocol buffers, some frames and a few big file/TP buffers */
+static uint32_t Bench_RandSize(void) {
+  uint32_t r = (uint32_t)rand() % 100u;
+  uint32_t size;
+
+  if (r < 60u) {
+    size = 8u + ((uint32_t)rand() % 248u);
+  } else if (r < 90u) {
+    size = 256u + ((uint32_t)rand() % 1792u);
+  } else if (r < 98u) {
+    size = 2048u + ((uint32_t)rand() % 14336u);
+  } else {
+    size = 16384u + ((uint32_t)rand() % 49152u);
+  }
+
+  return size;
+}
+
+static uint32_t Bench_Now(struct timespec *start) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000000 + (now.tv_nsec - start->tv_nsec));
+}
+
+static void Bench_Record(int op, uint32_t ns) {
+  Bench_Latency[op].ns[Bench_Latency[op].num++] = ns;
+}
+
+static void Bench_Fill(int slot) {
+  uint8_t *p = (uint8_t *)Bench_Ptrs[slot];
+
+  p[0] = (uint8_t)slot;
+  p[Bench_Sizes[slot] - 1u] = (uint8_t)(slot >> 8);
+}
+
+static void Bench_Check(int slot) {
+  uint8_t *p = (uint8_t *)Bench_Ptrs[slot];
+
+  if ((p[0] != (uint8_t)slot) || (p[Bench_Sizes[slot] - 1u] != (uint8_t)(slot >> 8))) {
+    printf("slot %d corrupted\n", slot);
+    exit(-1);
+  }
+}
+
+static int Bench_Compare(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+static void Bench_Report(int op) {
+  Bench_LatencyType *lat = &Bench_Latency[op];
+  uint64_t sum = 0;
+  uint32_t i;
+
+  if (lat->num > 0u) {
+    qsort(lat->ns, lat->num, sizeof(uint32_t), Bench_Compare);
+    for (i = 0; i < lat->num; i++) {
+      sum += lat->ns[i];
+    }
+    printf("%-8s: %8u ops, avg %6.1f ns, p50 %5u ns, p99 %6u ns, p99.99 %7u ns, max %8u ns, "
+           "%u failed\n",
+           Bench_OpNames[op], lat->num, (double)sum / lat->num, lat->ns[lat->num / 2],
+           lat->ns[(uint64_t)lat->num * 99u / 100u], lat->ns[(uint64_t)lat->num * 9999u / 10000u],
+           lat->ns[lat->num - 1u], lat->numOfFails);
+  }
+}
+
+static void Bench_ReportHeap(const char *title) {
+  heap_stats_t stats;
+
+  heap_get_stats(&stats);
+  printf("%s: free %u/%u bytes, min free %u, largest free block %u, %u free blocks, %u used "
+         "blocks, fragmentation %u%%\n",
+         title, stats.freeSize, stats.size, stats.minFreeSize, stats.maxFreeBlock,
+         stats.numOfFreeBlocks, stats.numOfUsedBlocks, stats.fragmentation);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+/* the bench is single threaded */
+imask_t Std_EnterCritical(void) {
+  return 0;
+}
+
+void Std_ExitCritical(imask_t mask) {
+  (void)mask;
+}
+
+int main(int argc, char *argv[]) {
+  struct timespec start;
+  uint32_t ops = BENCH_OPS;
+  uint32_t i, t0, ns, size;
+  int slot, op;
+  void *p;
+
+  if (argc > 1) {
+    ops = (uint32_t)atoi(argv[1]);
+  }
+  srand(1);
+
+  for (op = 0; op < BENCH_OP_MAX; op++) {
+    Bench_Latency[op].ns = (uint32_t *)malloc(sizeof(uint32_t) * ops);
+  }
+
+#ifdef USE_HEAP_TLSF
+  printf("TLSF heap, %u random operations over %u slots\n", ops, BENCH_SLOTS);
+#else
+  printf("list heap, %u random operations over %u slots\n", ops, BENCH_SLOTS);
+#endif
+  heap_init();
+  /* touch the whole heap first so that page faults are not measured on host */
+  size = heap_free_size();
+  do {
+    size -= 64u;
+    p = heap_malloc(size);
+  } while (NULL == p);
+  memset(p, 0, size);
+  heap_free(p);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < ops; i++) {
+    slot = (int)((uint32_t)rand() % BENCH_SLOTS);
+    if (NULL == Bench_Ptrs[slot]) {
+      size = Bench_RandSize();
+      if (0u == ((uint32_t)rand() % 10u)) {
+        t0 = Bench_Now(&start);
+        p = heap_memalign(64u << ((uint32_t)rand() % 7u), size);
+      } else {
+        t0 = Bench_Now(&start);
+        p = heap_malloc(size);
+      }
+      ns = Bench_Now(&start) - t0;
+      op = BENCH_OP_MALLOC;
+    } else if (0u == ((uint32_t)rand() % 8u)) {
+      Bench_Check(slot);
+      size = Bench_RandSize();
+      t0 = Bench_Now(&start);
+      p = heap_realloc(Bench_Ptrs[slot], size);
+      ns = Bench_Now(&start) - t0;
+      op = BENCH_OP_REALLOC;
+    } else {
+      Bench_Check(slot);
+      t0 = Bench_Now(&start);
+      heap_free(Bench_Ptrs[slot]);
+      ns = Bench_Now(&start) - t0;
+      op = BENCH_OP_FREE;
+      Bench_Ptrs[slot] = NULL;
+      p = NULL;
+      size = 0;
+    }
+    Bench_Record(op, ns);
+
+    if (BENCH_OP_FREE != op) {
+      if (NULL != p) {
+        if ((BENCH_OP_REALLOC == op) && (((uint8_t *)p)[0] != (uint8_t)slot)) {
+          printf("slot %d lost its content on realloc\n", slot);
+          exit(-1);
+        }
+        Bench_Ptrs[slot] = p;
+        Bench_Sizes[slot] = size;
+        Bench_Fill(slot);
+      } else {
+        Bench_Latency[op].numOfFails++;
+      }
+    }
+  }
+
+  Bench_ReportHeap("at end");
+  for (op = 0; op < BENCH_OP_MAX; op++) {
+    Bench_Report(op);
+  }
+
+  for (slot = 0; slot < BENCH_SLOTS; slot++) {
+    if (NULL != Bench_Ptrs[slot]) {
+      Bench_Check(slot);
+      heap_free(Bench_Ptrs[slot]);
+      Bench_Ptrs[slot] = NULL;
+    }
+  }
+  Bench_ReportHeap("all freed");
+
+  for (op = 0; op < BENCH_OP_MAX; op++) {
+    free(Bench_Latency[op].ns);
+  }
+
+  return 0;
+}
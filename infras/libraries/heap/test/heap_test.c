@@ -0,0 +1,187 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Randomized malloc/memalign/realloc/free workload of mostly small protocol buffers, some frames
+ * and a few big file/TP buffers, built once for the default size sorted free list and once with
+ * USE_HEAP_TLSF. Every block must keep its content and alignment, none may fail while the heap is
+ * far from full, the stats must follow the live blocks and everything must merge back into one
+ * free block at the end.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "heap.h"
+#include "Std_Critical.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_SLOTS
+#define TEST_SLOTS 4096
+#endif
+
+#ifndef TEST_OPS
+#define TEST_OPS 500000
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static void *testPtrs[TEST_SLOTS];
+static uint32_t testSizes[TEST_SLOTS];
+static uint32_t testAligns[TEST_SLOTS];
+static uint32_t testInitialFreeSize;
+/* ================================ [ LOCALS    ] ============================================== */
+static uint32_t test_rand_size(void) {
+  uint32_t r = (uint32_t)rand() % 100u;
+  uint32_t size;
+
+  if (r < 60u) {
+    size = 8u + ((uint32_t)rand() % 248u);
+  } else if (r < 90u) {
+    size = 256u + ((uint32_t)rand() % 1792u);
+  } else if (r < 98u) {
+    size = 2048u + ((uint32_t)rand() % 14336u);
+  } else {
+    size = 16384u + ((uint32_t)rand() % 49152u);
+  }
+
+  return size;
+}
+
+static void test_fill(int slot) {
+  memset(testPtrs[slot], (uint8_t)slot, testSizes[slot]);
+}
+
+static bool test_check(int slot, uint32_t size) {
+  const uint8_t *p = (const uint8_t *)testPtrs[slot];
+  uint32_t i;
+  bool r = (0u == ((uintptr_t)p % testAligns[slot]));
+
+  for (i = 0; (i < size) && r; i++) {
+    r = (p[i] == (uint8_t)slot);
+  }
+
+  return r;
+}
+
+static bool test_check_stats(uint32_t numOfUsed) {
+  heap_stats_t stats;
+
+  heap_get_stats(&stats);
+  return (numOfUsed == stats.numOfUsedBlocks) && (stats.freeSize == heap_free_size()) &&
+         (stats.freeSize <= stats.size) && (stats.minFreeSize <= stats.freeSize) &&
+         (stats.maxFreeBlock <= stats.freeSize) && (stats.fragmentation <= 100u) &&
+         ((stats.freeSize == 0u) || (stats.numOfFreeBlocks > 0u));
+}
+
+static void Test_RandomWorkload(void) {
+  uint32_t i, size, numOfUsed = 0;
+  uint32_t numOfMemalign = 0, numOfRealloc = 0;
+  int slot = 0;
+  void *p;
+  bool bPass = true;
+
+  printf("Test %u random operations over %u slots:", TEST_OPS, TEST_SLOTS);
+  for (i = 0; (i < TEST_OPS) && bPass; i++) {
+    slot = rand() % TEST_SLOTS;
+    if (NULL == testPtrs[slot]) {
+      size = test_rand_size();
+      testAligns[slot] = sizeof(void *);
+      if (0 == (rand() % 10)) {
+        testAligns[slot] = 64u << (rand() % 7);
+        p = heap_memalign(testAligns[slot], size);
+        numOfMemalign++;
+      } else {
+        p = heap_malloc(size);
+      }
+      bPass = (NULL != p);
+      if (bPass) {
+        testPtrs[slot] = p;
+        testSizes[slot] = size;
+        test_fill(slot);
+        numOfUsed++;
+      }
+    } else if (0 == (rand() % 8)) {
+      bPass = test_check(slot, testSizes[slot]);
+      size = test_rand_size();
+      p = heap_realloc(testPtrs[slot], size);
+      bPass = bPass && (NULL != p);
+      if (bPass) {
+        /* the content is kept up to the smaller size, realloc aligns as malloc does */
+        testPtrs[slot] = p;
+        testAligns[slot] = sizeof(void *);
+        bPass = test_check(slot, (size < testSizes[slot]) ? size : testSizes[slot]);
+        testSizes[slot] = size;
+        test_fill(slot);
+        numOfRealloc++;
+      }
+    } else {
+      bPass = test_check(slot, testSizes[slot]);
+      heap_free(testPtrs[slot]);
+      testPtrs[slot] = NULL;
+      numOfUsed--;
+    }
+    bPass = bPass && test_check_stats(numOfUsed);
+  }
+
+  bPass = bPass && (numOfMemalign > 0u) && (numOfRealloc > 0u);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  operation %u on slot %d, %u used blocks, %u free bytes\n", i, slot, numOfUsed,
+           heap_free_size());
+    exit(-1);
+  }
+}
+
+static void Test_AllFreed(void) {
+  heap_stats_t stats;
+  int slot;
+  bool bPass = true;
+
+  printf("Test all the blocks freed merge back into one:");
+  for (slot = 0; slot < TEST_SLOTS; slot++) {
+    if (NULL != testPtrs[slot]) {
+      bPass = bPass && test_check(slot, testSizes[slot]);
+      heap_free(testPtrs[slot]);
+      testPtrs[slot] = NULL;
+    }
+  }
+
+  heap_get_stats(&stats);
+  bPass = bPass && (testInitialFreeSize == stats.freeSize) && (1u == stats.numOfFreeBlocks) &&
+          (0u == stats.numOfUsedBlocks) && (0u == stats.fragmentation) &&
+          (stats.maxFreeBlock == stats.freeSize) && (stats.minFreeSize < stats.freeSize);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  free %u/%u bytes, initially %u, largest free block %u, %u free blocks, %u used "
+           "blocks, fragmentation %u%%\n",
+           stats.freeSize, stats.size, testInitialFreeSize, stats.maxFreeBlock,
+           stats.numOfFreeBlocks, stats.numOfUsedBlocks, stats.fragmentation);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+/* the test is single threaded */
+imask_t Std_EnterCritical(void) {
+  return 0;
+}
+
+void Std_ExitCritical(imask_t mask) {
+  (void)mask;
+}
+
+int main(int argc, char *argv[]) {
+  srand(1);
+#ifdef USE_HEAP_TLSF
+  printf("TLSF heap\n");
+#else
+  printf("list heap\n");
+#endif
+  heap_init();
+  testInitialFreeSize = heap_free_size();
+
+  Test_RandomWorkload();
+  Test_AllFreed();
+
+  return 0;
+}
@@ -5,6 +5,9 @@
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "ringbuffer.h"
 #include <string.h>
+#if defined(RB_USE_INDEX_FUNCTIONS) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 /* ================================ [ MACROS    ] ============================================== */
 /* ================================ [ TYPES     ] ============================================== */
 typedef enum {
@@ -15,48 +18,43 @@ typedef enum {
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
+/* the contiguous span of len elements at most from index to the end of the buffer */
+static rb_size_t RB_Span(const RingBufferType *rb, rb_size_t index, rb_size_t len) {
+  rb_size_t doSz = rb->C->num - (index & (rb->C->num - 1));
+
+  if (doSz > len) {
+    doSz = len;
+  }
+
+  return doSz;
+}
+
 static rb_size_t RB_Action(const RingBufferType *rb, void *data, rb_size_t len,
                            rb_action_t action) {
   rb_size_t l = 0;
   rb_size_t doSz, used;
   rb_size_t num = rb->C->num;
   rb_size_t size = rb->C->size;
-  rb_size_t in = rb->V->in & (num - 1);
-  rb_size_t out = rb->V->out & (num - 1);
+  rb_size_t out = rb->V->out;
   uint8_t *src = (uint8_t *)rb->C->buffer;
   uint8_t *dst = (uint8_t *)data;
 
-  used = rb->V->in - rb->V->out;
+  used = (rb_size_t)(RB_LOAD_ACQUIRE(rb->V->in) - out);
   if (len > used) {
     len = used;
   }
-  for (l = 0; l < len;) {
-    if (out < in) {
-      doSz = in - out;
-      if (doSz > (len - l)) {
-        doSz = len - l;
-      }
-      if (action != eRB_DROP) {
-        memcpy(dst, src + out * size, doSz * size);
-        dst += doSz * size;
-      }
-      l += doSz;
-    } else {
-      doSz = num - out;
-      if (doSz > (len - l)) {
-        doSz = len - l;
-      }
-      if (action != eRB_DROP) {
-        memcpy(dst, src + out * size, doSz * size);
-        dst += doSz * size;
-      }
-      l += doSz;
-      out = 0;
+  /* at most 2 spans: to the end of the buffer and from the start */
+  while (l < len) {
+    doSz = RB_Span(rb, (rb_size_t)(out + l), len - l);
+    if (action != eRB_DROP) {
+      memcpy(dst, src + ((rb_size_t)(out + l) & (num - 1)) * size, doSz * size);
+      dst += doSz * size;
     }
+    l += doSz;
   }
 
   if (action != eRB_POLL) {
-    rb->V->out += l;
+    RB_STORE_RELEASE(rb->V->out, (rb_size_t)(out + l));
   }
 
   return l;
@@ -72,8 +70,7 @@ rb_size_t RB_Push(const RingBufferType *rb, void *data, rb_size_t len) {
   rb_size_t doSz, used;
   rb_size_t num = rb->C->num;
   rb_size_t size = rb->C->size;
-  rb_size_t in = rb->V->in & (num - 1);
-  rb_size_t out = rb->V->out & (num - 1);
+  rb_size_t in = rb->V->in;
   uint8_t *src = (uint8_t *)data;
   uint8_t *dst = (uint8_t *)rb->C->buffer;
 
@@ -89,30 +86,16 @@ rb_size_t RB_Push(const RingBufferType *rb, void *data, rb_size_t len) {
    *          out
    */
 
-  used = rb->V->in - rb->V->out;
+  used = (rb_size_t)(in - RB_LOAD_ACQUIRE(rb->V->out));
   if ((used + len) <= num) {
-    for (l = 0; l < len;) {
-      if (in < out) {
-        doSz = out - in;
-        if (doSz > len) {
-          doSz = len;
-        }
-        memcpy(dst + in * size, src, doSz * size);
-        src += doSz * size;
-        l += doSz;
-      } else {
-        doSz = num - in;
-        if (doSz > len) {
-          doSz = len;
-        }
-        memcpy(dst + in * size, src, doSz * size);
-        src += doSz * size;
-        l += doSz;
-        in = 0;
-      }
+    while (l < len) {
+      doSz = RB_Span(rb, (rb_size_t)(in + l), len - l);
+      memcpy(dst + ((rb_size_t)(in + l) & (num - 1)) * size, src, doSz * size);
+      src += doSz * size;
+      l += doSz;
     }
 
-    rb->V->in += l;
+    RB_STORE_RELEASE(rb->V->in, (rb_size_t)(in + l));
   } else {
     /* full, do nothing */
   }
@@ -136,12 +119,12 @@ void *RB_OutP(const RingBufferType *rb) {
   rb_size_t used;
   rb_size_t num = rb->C->num;
   rb_size_t size = rb->C->size;
-  rb_size_t out = rb->V->out & (num - 1);
+  rb_size_t out = rb->V->out;
   uint8_t *dst = (uint8_t *)rb->C->buffer;
 
-  used = rb->V->in - rb->V->out;
+  used = (rb_size_t)(RB_LOAD_ACQUIRE(rb->V->in) - out);
   if (used > 0) {
-    dst = dst + out * size;
+    dst = dst + (out & (num - 1)) * size;
   } else {
     dst = NULL;
   }
@@ -153,12 +136,12 @@ void *RB_InP(const RingBufferType *rb) {
   rb_size_t used;
   rb_size_t num = rb->C->num;
   rb_size_t size = rb->C->size;
-  rb_size_t in = rb->V->in & (num - 1);
+  rb_size_t in = rb->V->in;
   uint8_t *dst = (uint8_t *)rb->C->buffer;
 
-  used = rb->V->in - rb->V->out;
+  used = (rb_size_t)(in - RB_LOAD_ACQUIRE(rb->V->out));
   if (used < num) {
-    dst = dst + in * size;
+    dst = dst + (in & (num - 1)) * size;
   } else {
     dst = NULL;
   }
@@ -169,7 +152,7 @@ void *RB_InP(const RingBufferType *rb) {
 rb_size_t RB_Left(const RingBufferType *rb) {
   rb_size_t left;
 
-  left = rb->V->in - rb->V->out;
+  left = RB_Size(rb);
 
   left = rb->C->num - left;
 
@@ -179,7 +162,67 @@ rb_size_t RB_Left(const RingBufferType *rb) {
 rb_size_t RB_Size(const RingBufferType *rb) {
   rb_size_t size;
 
-  size = rb->V->in - rb->V->out;
+  size = (rb_size_t)(RB_LOAD_ACQUIRE(rb->V->in) - RB_LOAD_ACQUIRE(rb->V->out));
 
   return size;
 }
+
+rb_size_t RB_Reserve(const RingBufferType *rb, void **data, rb_size_t len) {
+  rb_size_t in = rb->V->in;
+  rb_size_t left = rb->C->num - (rb_size_t)(in - RB_LOAD_ACQUIRE(rb->V->out));
+
+  if (len > left) {
+    len = left;
+  }
+  len = RB_Span(rb, in, len);
+  *data = rb->C->buffer + (in & (rb->C->num - 1)) * rb->C->size;
+
+  return len;
+}
+
+rb_size_t RB_Commit(const RingBufferType *rb, rb_size_t len) {
+  rb_size_t in = rb->V->in;
+  rb_size_t left = rb->C->num - (rb_size_t)(in - RB_LOAD_ACQUIRE(rb->V->out));
+
+  if (len > left) {
+    len = left;
+  }
+  RB_STORE_RELEASE(rb->V->in, (rb_size_t)(in + len));
+
+  return len;
+}
+
+rb_size_t RB_Peek(const RingBufferType *rb, void **data, rb_size_t len) {
+  rb_size_t out = rb->V->out;
+  rb_size_t used = (rb_size_t)(RB_LOAD_ACQUIRE(rb->V->in) - out);
+
+  if (len > used) {
+    len = used;
+  }
+  len = RB_Span(rb, out, len);
+  *data = rb->C->buffer + (out & (rb->C->num - 1)) * rb->C->size;
+
+  return len;
+}
+
+rb_size_t RB_Release(const RingBufferType *rb, rb_size_t len) {
+  return RB_Action(rb, NULL, len, eRB_DROP);
+}
+
+#ifdef RB_USE_INDEX_FUNCTIONS
+/* the call is opaque to the caller, the barriers still order the access if it is inlined */
+rb_size_t RB_LoadAcquire(const volatile rb_size_t *index) {
+  rb_size_t value = *index;
+#ifdef RB_COMPILER_BARRIER
+  RB_COMPILER_BARRIER();
+#endif
+  return value;
+}
+
+void RB_StoreRelease(volatile rb_size_t *index, rb_size_t value) {
+#ifdef RB_COMPILER_BARRIER
+  RB_COMPILER_BARRIER();
+#endif
+  *index = value;
+}
+#endif
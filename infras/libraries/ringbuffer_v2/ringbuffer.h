@@ -10,21 +10,67 @@
 #ifndef RB_SIZE_TYPE
 #define RB_SIZE_TYPE uint16_t
 #endif
+
+/* The ring is lock free for one producer and one consumer: the producer only writes in and the
+ * consumer only writes out, each index is published with release after the elements and read by
+ * the other side with acquire. Several producers or several consumers still need a lock.
+ * RB_LOCK_FREE is defined when the compiler is known to keep the element copies on their side of
+ * the index accesses, else the callers keep their critical section. */
+#ifndef RB_LOAD_ACQUIRE
+#if defined(__GNUC__)
+#define RB_LOAD_ACQUIRE(v) __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define RB_STORE_RELEASE(v, x) __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#define RB_LOCK_FREE
+#else
+/* single core targets: a volatile access alone doesn't stop the compiler from moving the copy of
+ * the elements across it, so the indexes are accessed by out of line functions which wrap the
+ * access with RB_COMPILER_BARRIER, which the port could define for its compiler */
+#if !defined(RB_COMPILER_BARRIER) && defined(_MSC_VER)
+#define RB_COMPILER_BARRIER() _ReadWriteBarrier()
+#endif
+#define RB_LOAD_ACQUIRE(v) RB_LoadAcquire(&(v))
+#define RB_STORE_RELEASE(v, x) RB_StoreRelease(&(v), (x))
+#define RB_USE_INDEX_FUNCTIONS
+#ifdef RB_COMPILER_BARRIER
+#define RB_LOCK_FREE
+#endif
+#endif
+#else /* given by the port */
+#define RB_LOCK_FREE
+#endif
+
+/* keep in and out on their own cache line so that the producer and the consumer on different
+ * cores do not bounce one line, 0 to pack them on the targets without data cache */
+#ifndef RB_CACHE_LINE_SIZE
+#if defined(_WIN32) || defined(linux)
+#define RB_CACHE_LINE_SIZE 64
+#else
+#define RB_CACHE_LINE_SIZE 0
+#endif
+#endif
+
+#if (RB_CACHE_LINE_SIZE > 0) && defined(__GNUC__)
+#define RB_CACHE_ALIGNED __attribute__((aligned(RB_CACHE_LINE_SIZE)))
+#else
+#define RB_CACHE_ALIGNED
+#endif
+
 #define RB_DECLARE(name, type, size)                                                               \
   static type rbBuf_##name[size];                                                                  \
   static const RingBufferConstType rbC_##name = {                                                  \
     (void *)rbBuf_##name, sizeof(rbBuf_##name) / sizeof(rbBuf_##name[0]), sizeof(type)};           \
-  static RingBufferVariantType rbV_##name = {0, 0};                                                \
+  static RingBufferVariantType rbV_##name;                                                         \
   const RingBufferType rb_##name = {&rbC_##name, &rbV_##name}
 
 #define RB_EXTERN(name) extern RingBufferType rb_##name;
 
 #define RB_PUSH_FAST(api, type)                                                                    \
   static inline rb_size_t RB_Push##api(const RingBufferType *rb, type *typeV) {                    \
-    rb_size_t used = rb->V->in - rb->V->out;                                                       \
+    rb_size_t in = rb->V->in;                                                                      \
+    rb_size_t used = (rb_size_t)(in - RB_LOAD_ACQUIRE(rb->V->out));                                \
     if (used < rb->C->num) {                                                                       \
-      ((type *)rb->C->buffer)[rb->V->in & (rb->C->num - 1)] = *typeV;                              \
-      rb->V->in++;                                                                                 \
+      ((type *)rb->C->buffer)[in & (rb->C->num - 1)] = *typeV;                                     \
+      RB_STORE_RELEASE(rb->V->in, (rb_size_t)(in + 1));                                            \
       used = 1;                                                                                    \
     } else {                                                                                       \
       used = 0;                                                                                    \
@@ -41,7 +87,11 @@
 #define RB_SIZE(name) RB_Size(&rb_##name)
 #define RB_INP(name) RB_InP(&rb_##name)
 #define RB_OUTP(name) RB_OutP(&rb_##name)
-#define IS_RB_EMPTY(name) ((rb_##name.V->in) == (rb_##name.V->out))
+#define RB_RESERVE(name, data, sz) RB_Reserve(&rb_##name, data, sz)
+#define RB_COMMIT(name, sz) RB_Commit(&rb_##name, sz)
+#define RB_PEEK(name, data, sz) RB_Peek(&rb_##name, data, sz)
+#define RB_RELEASE(name, sz) RB_Release(&rb_##name, sz)
+#define IS_RB_EMPTY(name) (0 == RB_Size(&rb_##name))
 /* ================================ [ TYPES     ] ============================================== */
 typedef RB_SIZE_TYPE rb_size_t;
 
@@ -52,8 +102,14 @@ typedef struct {
 } RingBufferConstType;
 
 typedef struct {
-  rb_size_t in;
-  rb_size_t out;
+  RB_CACHE_ALIGNED rb_size_t in; /* written by the producer only */
+#if RB_CACHE_LINE_SIZE > 0
+  uint8_t inPad[RB_CACHE_LINE_SIZE - sizeof(rb_size_t)];
+#endif
+  RB_CACHE_ALIGNED rb_size_t out; /* written by the consumer only */
+#if RB_CACHE_LINE_SIZE > 0
+  uint8_t outPad[RB_CACHE_LINE_SIZE - sizeof(rb_size_t)];
+#endif
 } RingBufferVariantType;
 
 typedef struct RingBuffer_s {
@@ -61,6 +117,10 @@ typedef struct RingBuffer_s {
   RingBufferVariantType *V;
 } RingBufferType;
 /* ================================ [ DECLARES  ] ============================================== */
+#ifdef RB_USE_INDEX_FUNCTIONS
+rb_size_t RB_LoadAcquire(const volatile rb_size_t *index);
+void RB_StoreRelease(volatile rb_size_t *index, rb_size_t value);
+#endif
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
 RB_PUSH_FAST(Char, char)
@@ -77,4 +137,16 @@ rb_size_t RB_Left(const RingBufferType *rb);
 rb_size_t RB_Size(const RingBufferType *rb);
 void *RB_OutP(const RingBufferType *rb);
 void *RB_InP(const RingBufferType *rb);
+
+/* Zero copy producer: *data is set to the free span at in, the return value is its number of
+ * elements, at most len and 0 if full. The span stops at the end of the buffer, after RB_Commit
+ * reserve again for the rest that wraps to the start. RB_Commit publishes len elements of it. */
+rb_size_t RB_Reserve(const RingBufferType *rb, void **data, rb_size_t len);
+rb_size_t RB_Commit(const RingBufferType *rb, rb_size_t len);
+
+/* Zero copy consumer: *data is set to the span of elements at out, the return value is its number
+ * of elements, at most len and 0 if empty, with the same wrap as RB_Reserve. RB_Release gives len
+ * elements of it back to the producer. */
+rb_size_t RB_Peek(const RingBufferType *rb, void **data, rb_size_t len);
+rb_size_t RB_Release(const RingBufferType *rb, rb_size_t len);
 #endif /* RING_BUFFER_V2_H */
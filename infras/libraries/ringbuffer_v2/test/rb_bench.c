@@ -0,0 +1,300 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * One producer thread and one consumer thread on a ring of 32 bits elements. The throughput in
+ * elements per second is measured with RB_Push/RB_Pop under a mutex as the callers did before,
+ * with RB_Push/RB_Pop lock free and with RB_Reserve/RB_Commit and RB_Peek/RB_Release without any
+ * copy. The consumer checks the sequence of every element. The latency is the round trip of one
+ * element sent over a ring and echoed back over another one, as median and 99th percentile. The
+ * spans, the wrap and the order of the elements are asserted by rb_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "ringbuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_ELEMENTS
+#define BENCH_ELEMENTS 20000000u
+#endif
+
+#ifndef BENCH_BATCH
+#define BENCH_BATCH 32u
+#endif
+
+#ifndef BENCH_PINGS
+#define BENCH_PINGS 100000u
+#endif
+
+#define BENCH_RING_SIZE 1024
+/* ================================ [ TYPES     ] ============================================== */
+typedef void *(*bench_thread_t)(void *arg);
+
+typedef struct {
+  const char *name;
+  bench_thread_t producer;
+  bench_thread_t consumer;
+} bench_mode_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+RB_DECLARE(bench, uint32_t, BENCH_RING_SIZE);
+RB_DECLARE(ping, uint32_t, 16);
+RB_DECLARE(pong, uint32_t, 16);
+
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile int bench_error;
+static uint64_t bench_rtt[BENCH_PINGS];
+/* ================================ [ LOCALS    ] ============================================== */
+static uint64_t bench_now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/* the threads may share one core, give it to the other side when there is nothing to do */
+static void bench_idle(void) {
+  (void)sched_yield();
+}
+
+static void bench_check(uint32_t *expected, const uint32_t *data, rb_size_t len) {
+  rb_size_t i;
+
+  for (i = 0; i < len; i++) {
+    if (data[i] != *expected) {
+      bench_error = 1;
+    }
+    (*expected)++;
+  }
+}
+
+static void *bench_locked_producer(void *arg) {
+  uint32_t data[BENCH_BATCH];
+  uint32_t seq = 0;
+  uint32_t i;
+  rb_size_t r;
+
+  while (seq < BENCH_ELEMENTS) {
+    for (i = 0; i < BENCH_BATCH; i++) {
+      data[i] = seq + i;
+    }
+    pthread_mutex_lock(&bench_lock);
+    r = RB_PUSH(bench, data, BENCH_BATCH);
+    pthread_mutex_unlock(&bench_lock);
+    if (0 == r) {
+      bench_idle();
+    }
+    seq += r;
+  }
+
+  return NULL;
+}
+
+static void *bench_locked_consumer(void *arg) {
+  uint32_t data[BENCH_BATCH];
+  uint32_t seq = 0;
+  rb_size_t r;
+
+  while (seq < BENCH_ELEMENTS) {
+    pthread_mutex_lock(&bench_lock);
+    r = RB_POP(bench, data, BENCH_BATCH);
+    pthread_mutex_unlock(&bench_lock);
+    if (0 == r) {
+      bench_idle();
+    }
+    bench_check(&seq, data, r);
+  }
+
+  return NULL;
+}
+
+static void *bench_copy_producer(void *arg) {
+  uint32_t data[BENCH_BATCH];
+  uint32_t seq = 0;
+  uint32_t i;
+  rb_size_t r;
+
+  while (seq < BENCH_ELEMENTS) {
+    for (i = 0; i < BENCH_BATCH; i++) {
+      data[i] = seq + i;
+    }
+    r = RB_PUSH(bench, data, BENCH_BATCH);
+    if (0 == r) {
+      bench_idle();
+    }
+    seq += r;
+  }
+
+  return NULL;
+}
+
+static void *bench_copy_consumer(void *arg) {
+  uint32_t data[BENCH_BATCH];
+  uint32_t seq = 0;
+  rb_size_t r;
+
+  while (seq < BENCH_ELEMENTS) {
+    r = RB_POP(bench, data, BENCH_BATCH);
+    if (0 == r) {
+      bench_idle();
+    }
+    bench_check(&seq, data, r);
+  }
+
+  return NULL;
+}
+
+static void *bench_zero_copy_producer(void *arg) {
+  uint32_t *data;
+  uint32_t seq = 0;
+  rb_size_t i, r;
+
+  while (seq < BENCH_ELEMENTS) {
+    r = RB_RESERVE(bench, (void **)&data, BENCH_BATCH);
+    if (r > (BENCH_ELEMENTS - seq)) {
+      r = BENCH_ELEMENTS - seq;
+    }
+    for (i = 0; i < r; i++) {
+      data[i] = seq + i;
+    }
+    if (0 == r) {
+      bench_idle();
+    } else {
+      (void)RB_COMMIT(bench, r);
+    }
+    seq += r;
+  }
+
+  return NULL;
+}
+
+static void *bench_zero_copy_consumer(void *arg) {
+  uint32_t *data;
+  uint32_t seq = 0;
+  rb_size_t r;
+
+  while (seq < BENCH_ELEMENTS) {
+    r = RB_PEEK(bench, (void **)&data, BENCH_BATCH);
+    if (0 == r) {
+      bench_idle();
+    } else {
+      bench_check(&seq, data, r);
+      (void)RB_RELEASE(bench, r);
+    }
+  }
+
+  return NULL;
+}
+
+static const bench_mode_t bench_modes[] = {
+  {"locked push/pop", bench_locked_producer, bench_locked_consumer},
+  {"lock free push/pop", bench_copy_producer, bench_copy_consumer},
+  {"reserve/peek", bench_zero_copy_producer, bench_zero_copy_consumer},
+};
+
+static int bench_throughput(const bench_mode_t *mode) {
+  int ercd = 0;
+  pthread_t producer, consumer;
+  uint64_t t0, elapsed;
+
+  RB_INIT(bench);
+  bench_error = 0;
+  t0 = bench_now();
+  if ((0 != pthread_create(&consumer, NULL, mode->consumer, NULL)) ||
+      (0 != pthread_create(&producer, NULL, mode->producer, NULL))) {
+    printf("failed to create the threads\n");
+    exit(-1);
+  }
+  pthread_join(producer, NULL);
+  pthread_join(consumer, NULL);
+  elapsed = bench_now() - t0;
+
+  if ((0 != bench_error) || (0 != RB_SIZE(bench))) {
+    printf("%-20s: sequence error\n", mode->name);
+    ercd = -1;
+  } else {
+    printf("%-20s: %7.1f M elements/s\n", mode->name,
+           (double)BENCH_ELEMENTS * 1000.0 / (double)elapsed);
+  }
+
+  return ercd;
+}
+
+static void *bench_echo(void *arg) {
+  uint32_t value;
+  uint32_t i;
+
+  for (i = 0; i < BENCH_PINGS; i++) {
+    while (0 == RB_POP(ping, &value, 1)) {
+      bench_idle();
+    }
+    while (0 == RB_PushU32(&rb_pong, &value)) {
+      bench_idle();
+    }
+  }
+
+  return NULL;
+}
+
+static int bench_compare(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+
+  return (x > y) ? 1 : ((x < y) ? -1 : 0);
+}
+
+static int bench_latency(void) {
+  int ercd = 0;
+  pthread_t echo;
+  uint32_t i, value;
+  uint64_t t0;
+
+  RB_INIT(ping);
+  RB_INIT(pong);
+  if (0 != pthread_create(&echo, NULL, bench_echo, NULL)) {
+    printf("failed to create the threads\n");
+    exit(-1);
+  }
+  for (i = 0; (i < BENCH_PINGS) && (0 == ercd); i++) {
+    t0 = bench_now();
+    (void)RB_PushU32(&rb_ping, &i);
+    while (0 == RB_POP(pong, &value, 1)) {
+      bench_idle();
+    }
+    bench_rtt[i] = bench_now() - t0;
+    if (value != i) {
+      ercd = -1;
+    }
+  }
+  pthread_join(echo, NULL);
+
+  if (0 == ercd) {
+    qsort(bench_rtt, BENCH_PINGS, sizeof(bench_rtt[0]), bench_compare);
+    printf("%-20s: median %.0f ns, p99 %.0f ns\n", "round trip",
+           (double)bench_rtt[BENCH_PINGS / 2], (double)bench_rtt[(BENCH_PINGS * 99u) / 100u]);
+  } else {
+    printf("%-20s: sequence error\n", "round trip");
+  }
+
+  return ercd;
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  int ercd = 0;
+  uint32_t m;
+
+  printf("ring of %u elements, batch of %u, cache line %u\n", BENCH_RING_SIZE, BENCH_BATCH,
+         RB_CACHE_LINE_SIZE);
+  for (m = 0; (m < ARRAY_SIZE(bench_modes)) && (0 == ercd); m++) {
+    ercd = bench_throughput(&bench_modes[m]);
+  }
+  if (0 == ercd) {
+    ercd = bench_latency();
+  }
+
+  return (0 == ercd) ? 0 : -1;
+}
@@ -0,0 +1,369 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * The spans of RB_Reserve/RB_Peek must stop at the end of the buffer and RB_Push must take all of
+ * the elements or none when they do not fit. Then one producer thread and one consumer thread
+ * pass a sequence of 32 bits elements in batches of random length with RB_Push/RB_Pop under a
+ * mutex as the callers did before, with RB_Push/RB_Pop lock free and with RB_Reserve/RB_Commit and
+ * RB_Peek/RB_Release without any copy: the consumer must get every element once and in order, past
+ * the wrap of the indexes. At last one element at a time is sent over a ring and must be echoed
+ * back in order over another.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "ringbuffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_ELEMENTS
+#define TEST_ELEMENTS 2000000u
+#endif
+
+#ifndef TEST_BATCH
+#define TEST_BATCH 32u
+#endif
+
+#ifndef TEST_PINGS
+#define TEST_PINGS 10000u
+#endif
+
+#define TEST_RING_SIZE 1024
+/* the random batch lengths, shared by both threads so that rand() is only called by main */
+#define TEST_BATCHES 1024u
+/* ================================ [ TYPES     ] ============================================== */
+typedef void *(*test_thread_t)(void *arg);
+
+typedef struct {
+  const char *name;
+  test_thread_t producer;
+  test_thread_t consumer;
+} test_mode_t;
+
+typedef struct {
+  uint32_t count;    /* elements received */
+  uint32_t errors;   /* elements out of sequence */
+  uint32_t overflow; /* elements received past the end of the sequence */
+} test_stats_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+RB_DECLARE(test, uint32_t, TEST_RING_SIZE);
+RB_DECLARE(ping, uint32_t, 16);
+RB_DECLARE(pong, uint32_t, 16);
+
+static pthread_mutex_t testLock = PTHREAD_MUTEX_INITIALIZER;
+static test_stats_t testStats;
+static rb_size_t testBatch[TEST_BATCHES];
+/* ================================ [ LOCALS    ] ============================================== */
+/* the threads may share one core, give it to the other side when there is nothing to do */
+static void test_idle(void) {
+  (void)sched_yield();
+}
+
+static rb_size_t test_batch(uint32_t *index) {
+  return testBatch[(*index)++ % TEST_BATCHES];
+}
+
+static void test_check(uint32_t *expected, const uint32_t *data, rb_size_t len) {
+  rb_size_t i;
+
+  for (i = 0; i < len; i++) {
+    if (data[i] != *expected) {
+      testStats.errors++;
+    }
+    if (*expected >= TEST_ELEMENTS) {
+      testStats.overflow++;
+    }
+    (*expected)++;
+  }
+  testStats.count += len;
+}
+
+static void *test_locked_producer(void *arg) {
+  uint32_t data[TEST_BATCH];
+  uint32_t seq = 0;
+  uint32_t batch = 0;
+  rb_size_t i, len, r;
+
+  while (seq < TEST_ELEMENTS) {
+    len = test_batch(&batch);
+    if (len > (TEST_ELEMENTS - seq)) {
+      len = TEST_ELEMENTS - seq;
+    }
+    for (i = 0; i < len; i++) {
+      data[i] = seq + i;
+    }
+    pthread_mutex_lock(&testLock);
+    r = RB_PUSH(test, data, len);
+    pthread_mutex_unlock(&testLock);
+    if (0 == r) {
+      test_idle();
+    }
+    seq += r;
+  }
+
+  return NULL;
+}
+
+static void *test_locked_consumer(void *arg) {
+  uint32_t data[TEST_BATCH];
+  uint32_t seq = 0;
+  uint32_t batch = TEST_BATCHES / 2;
+  rb_size_t r;
+
+  while (seq < TEST_ELEMENTS) {
+    pthread_mutex_lock(&testLock);
+    r = RB_POP(test, data, test_batch(&batch));
+    pthread_mutex_unlock(&testLock);
+    if (0 == r) {
+      test_idle();
+    }
+    test_check(&seq, data, r);
+  }
+
+  return NULL;
+}
+
+static void *test_copy_producer(void *arg) {
+  uint32_t data[TEST_BATCH];
+  uint32_t seq = 0;
+  uint32_t batch = 0;
+  rb_size_t i, len, r;
+
+  while (seq < TEST_ELEMENTS) {
+    len = test_batch(&batch);
+    if (len > (TEST_ELEMENTS - seq)) {
+      len = TEST_ELEMENTS - seq;
+    }
+    for (i = 0; i < len; i++) {
+      data[i] = seq + i;
+    }
+    r = RB_PUSH(test, data, len);
+    if (0 == r) {
+      test_idle();
+    }
+    seq += r;
+  }
+
+  return NULL;
+}
+
+static void *test_copy_consumer(void *arg) {
+  uint32_t data[TEST_BATCH];
+  uint32_t seq = 0;
+  uint32_t batch = TEST_BATCHES / 2;
+  rb_size_t r;
+
+  while (seq < TEST_ELEMENTS) {
+    r = RB_POP(test, data, test_batch(&batch));
+    if (0 == r) {
+      test_idle();
+    }
+    test_check(&seq, data, r);
+  }
+
+  return NULL;
+}
+
+static void *test_zero_copy_producer(void *arg) {
+  uint32_t *data;
+  uint32_t seq = 0;
+  uint32_t batch = 0;
+  rb_size_t i, r;
+
+  while (seq < TEST_ELEMENTS) {
+    r = RB_RESERVE(test, (void **)&data, test_batch(&batch));
+    if (r > (TEST_ELEMENTS - seq)) {
+      r = TEST_ELEMENTS - seq;
+    }
+    for (i = 0; i < r; i++) {
+      data[i] = seq + i;
+    }
+    if (0 == r) {
+      test_idle();
+    } else {
+      (void)RB_COMMIT(test, r);
+    }
+    seq += r;
+  }
+
+  return NULL;
+}
+
+static void *test_zero_copy_consumer(void *arg) {
+  uint32_t *data;
+  uint32_t seq = 0;
+  uint32_t batch = TEST_BATCHES / 2;
+  rb_size_t r;
+
+  while (seq < TEST_ELEMENTS) {
+    r = RB_PEEK(test, (void **)&data, test_batch(&batch));
+    if (0 == r) {
+      test_idle();
+    } else {
+      test_check(&seq, data, r);
+      (void)RB_RELEASE(test, r);
+    }
+  }
+
+  return NULL;
+}
+
+static const test_mode_t testModes[] = {
+  {"locked push/pop", test_locked_producer, test_locked_consumer},
+  {"lock free push/pop", test_copy_producer, test_copy_consumer},
+  {"reserve/peek", test_zero_copy_producer, test_zero_copy_consumer},
+};
+
+static void *test_echo(void *arg) {
+  uint32_t value;
+  uint32_t i;
+
+  for (i = 0; i < TEST_PINGS; i++) {
+    while (0 == RB_POP(ping, &value, 1)) {
+      test_idle();
+    }
+    while (0 == RB_PushU32(&rb_pong, &value)) {
+      test_idle();
+    }
+  }
+
+  return NULL;
+}
+
+/* move in and out of the test ring to index, which is less than its size */
+static void test_seek(rb_size_t index) {
+  void *data;
+
+  RB_INIT(test);
+  (void)RB_RESERVE(test, &data, index);
+  (void)RB_COMMIT(test, index);
+  (void)RB_DROP(test, index);
+}
+
+static void Test_Span(void) {
+  uint32_t data[TEST_RING_SIZE];
+  uint32_t *span0 = NULL;
+  uint32_t *span1 = NULL;
+  rb_size_t r0, r1, rp, r;
+  bool bPass;
+
+  printf("Test reserve and peek stop at the end of the buffer:");
+  test_seek(TEST_RING_SIZE - 24);
+  r0 = RB_RESERVE(test, (void **)&span0, 100);
+  (void)RB_COMMIT(test, r0);
+  r1 = RB_RESERVE(test, (void **)&span1, 100 - r0);
+  (void)RB_COMMIT(test, r1);
+  bPass = (24 == r0) && (&rbBuf_test[TEST_RING_SIZE - 24] == span0) && (76 == r1) &&
+          (&rbBuf_test[0] == span1) && (100 == RB_SIZE(test)) &&
+          ((TEST_RING_SIZE - 100) == RB_LEFT(test));
+  if (bPass) {
+    rp = RB_PEEK(test, (void **)&span0, 100);
+    bPass = (24 == rp) && (&rbBuf_test[TEST_RING_SIZE - 24] == span0);
+    (void)RB_RELEASE(test, rp);
+    rp = RB_PEEK(test, (void **)&span1, 100);
+    bPass = bPass && (76 == rp) && (&rbBuf_test[0] == span1);
+    (void)RB_RELEASE(test, rp);
+    bPass = bPass && IS_RB_EMPTY(test);
+  }
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  reserve %u + %u, size %u\n", r0, r1, RB_SIZE(test));
+    exit(-1);
+  }
+
+  printf("Test push takes all or nothing up to a full ring:");
+  test_seek(TEST_RING_SIZE - 10);
+  memset(data, 0, sizeof(data));
+  r0 = RB_PUSH(test, data, TEST_RING_SIZE - 100);
+  r1 = RB_PUSH(test, data, 101);
+  r1 += RB_PUSH(test, data, 100);
+  r = RB_PushU32(&rb_test, &data[0]);
+  rp = RB_RESERVE(test, (void **)&span0, 1);
+  bPass = ((TEST_RING_SIZE - 100) == r0) && (100 == r1) && (0 == r) && (0 == rp) &&
+          (0 == RB_LEFT(test)) && (TEST_RING_SIZE == RB_POP(test, data, TEST_RING_SIZE + 1)) &&
+          (0 == RB_POP(test, data, 1));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  push %u + %u + %u, reserve %u\n", r0, r1, r, rp);
+    exit(-1);
+  }
+}
+
+static void Test_Sequence(const test_mode_t *mode) {
+  pthread_t producer, consumer;
+  bool bPass;
+
+  printf("Test %s keeps the sequence:", mode->name);
+  RB_INIT(test);
+  memset(&testStats, 0, sizeof(testStats));
+  if ((0 != pthread_create(&consumer, NULL, mode->consumer, NULL)) ||
+      (0 != pthread_create(&producer, NULL, mode->producer, NULL))) {
+    printf(" failed to create the threads\n");
+    exit(-1);
+  }
+  pthread_join(producer, NULL);
+  pthread_join(consumer, NULL);
+  bPass = (0 == testStats.errors) && (0 == testStats.overflow) &&
+          (TEST_ELEMENTS == testStats.count) && IS_RB_EMPTY(test);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  received %u of %u, %u out of sequence, %u too many, %u left\n", testStats.count,
+           TEST_ELEMENTS, testStats.errors, testStats.overflow, RB_SIZE(test));
+    exit(-1);
+  }
+}
+
+static void Test_RoundTrip(void) {
+  pthread_t echo;
+  uint32_t i, value = 0;
+  bool bPass = true;
+
+  printf("Test round trip over the ping and pong rings:");
+  RB_INIT(ping);
+  RB_INIT(pong);
+  if (0 != pthread_create(&echo, NULL, test_echo, NULL)) {
+    printf(" failed to create the threads\n");
+    exit(-1);
+  }
+  for (i = 0; i < TEST_PINGS; i++) {
+    (void)RB_PushU32(&rb_ping, &i);
+    while (0 == RB_POP(pong, &value, 1)) {
+      test_idle();
+    }
+    if (value != i) {
+      bPass = false;
+      break;
+    }
+  }
+  if (false == bPass) {
+    printf(" FAIL\n  ping %u got pong %u\n", i, value);
+    exit(-1);
+  }
+  pthread_join(echo, NULL);
+  bPass = IS_RB_EMPTY(ping) && IS_RB_EMPTY(pong);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  uint32_t i;
+
+  srand(1);
+  for (i = 0; i < TEST_BATCHES; i++) {
+    testBatch[i] = (rb_size_t)(1u + ((uint32_t)rand() % TEST_BATCH));
+  }
+
+  Test_Span();
+  for (i = 0; i < ARRAY_SIZE(testModes); i++) {
+    Test_Sequence(&testModes[i]);
+  }
+  Test_RoundTrip();
+
+  return 0;
+}
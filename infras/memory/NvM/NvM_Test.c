@@ -11,7 +11,7 @@
 #include <string.h>
 /* ================================ [ MACROS    ] ============================================== */
 #if defined(_WIN32) || defined(linux)
-extern uint8_t g_FlsAcMirror[];
+extern uint8_t *g_FlsAcMirror;
 #define FEE_ADDRESS(v) ((void *)(&g_FlsAcMirror[(v)]))
 #else
 #define FEE_ADDRESS(v) ((void *)(v))
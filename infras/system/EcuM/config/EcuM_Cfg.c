@@ -44,6 +44,9 @@ static const EcuM_DriverInitItemType EcuM_DriverInitListZero[] = {
 };
 
 static const EcuM_DriverInitItemType EcuM_DriverInitListOne[] = {
+#ifdef USE_STBM
+  {(EcuM_DriverInitFncType)StbM_Init, NULL},
+#endif
 #ifdef USE_CANIF
   {(EcuM_DriverInitFncType)CanIf_Init, NULL},
 #endif
@@ -143,6 +146,9 @@ static const EcuM_DriverInitItemType EcuM_DriverInitListTwo[] = {
 };
 
 static const EcuM_DriverMainFncType EcuM_DriverMainList[] = {
+#ifdef USE_STBM
+  StbM_MainFunction,
+#endif
 #ifdef USE_CAN
 #ifdef USE_CANIF
   CanIf_MainFunction,
@@ -261,6 +267,9 @@ static const EcuM_DriverMainFncType EcuM_DriverMainFastList[] = {
 #ifdef USE_SECOC
   SecOC_MainFunctionTx,     SecOC_MainFunctionRx,
 #endif
+#ifdef USE_CSM
+  Csm_MainFunction,
+#endif
 #ifdef USE_MIRROR
   Mirror_MainFunction,
 #endif
@@ -14,6 +14,7 @@
 #include "CanSM.h"
 #include "ComM.h"
 #include "Nm.h"
+#include "StbM.h"
 #include "CanTSyn.h"
 #include "Lin.h"
 #include "LinIf.h"
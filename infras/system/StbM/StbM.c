@@ -0,0 +1,300 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * ref:
+ * https://www.autosar.org/fileadmin/standards/R20-11/CP/AUTOSAR_SWS_SynchronizedTimeBaseManager.pdf
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "StbM_Priv.h"
+#include "Std_Timer.h"
+#include "Std_Debug.h"
+#include <string.h>
+
+#include "Det.h"
+/* ================================ [ MACROS    ] ============================================== */
+#define AS_LOG_STBM 0
+#define AS_LOG_STBMI 0
+#define AS_LOG_STBME 0
+
+#define STBM_CONFIG (&StbM_Config)
+
+#define STBM_NANOSECONDS_PER_SECOND 1000000000
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+extern const StbM_ConfigType StbM_Config;
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* The time base is a linear function of the free running local clock:
+ *   global = globalRef + (local - localRef) * (1 + rate / 1e9)
+ * a received global time moves it by the PI servo which changes the rate only, so the time base
+ * is continuous and keeps monotonic, only offsets beyond the stepThreshold make it jump. */
+static uint64_t StbM_GetGlobalNs(const StbM_TimeBaseContextType *context, uint64_t local) {
+  int64_t elapsed = (int64_t)(local - context->localRef);
+  int64_t correction;
+
+  /* split to not overflow for a time base which is not synchronized for a long time */
+  correction = (elapsed / STBM_NANOSECONDS_PER_SECOND) * context->rate +
+               ((elapsed % STBM_NANOSECONDS_PER_SECOND) * context->rate) /
+                 STBM_NANOSECONDS_PER_SECOND;
+
+  return context->globalRef + (uint64_t)(elapsed + correction);
+}
+
+static int32_t StbM_Clamp(int64_t value, int32_t limit) {
+  if (value > limit) {
+    value = limit;
+  } else if (value < -limit) {
+    value = -limit;
+  } else {
+    /* in range */
+  }
+
+  return (int32_t)value;
+}
+
+static void StbM_ToTimeStamp(uint64_t ns, StbM_TimeStampType *timeStamp) {
+  uint64_t seconds = ns / STBM_NANOSECONDS_PER_SECOND;
+
+  timeStamp->secondsHi = (uint32_t)(seconds >> 32);
+  timeStamp->seconds = (uint32_t)(seconds & 0xFFFFFFFFul);
+  timeStamp->nanoseconds = (uint32_t)(ns - seconds * STBM_NANOSECONDS_PER_SECOND);
+}
+
+static uint64_t StbM_FromTimeStamp(const StbM_TimeStampType *timeStamp) {
+  return ((((uint64_t)timeStamp->secondsHi << 32) + timeStamp->seconds) *
+          STBM_NANOSECONDS_PER_SECOND) +
+         timeStamp->nanoseconds;
+}
+
+static void StbM_ToVirtualLocalTime(uint64_t ns, StbM_VirtualLocalTimeType *localTime) {
+  localTime->nanosecondsHi = (uint32_t)(ns >> 32);
+  localTime->nanosecondsLo = (uint32_t)(ns & 0xFFFFFFFFul);
+}
+
+static void StbM_Step(StbM_TimeBaseContextType *context, uint64_t local, uint64_t global) {
+  context->localRef = local;
+  context->globalRef = global;
+  /* the frequency error of the local clock is still valid after a step */
+  context->rate = context->drift;
+}
+
+/* the PI servo, the offset is turned into the frequency error which would remove it within one
+ * sync interval, the integral part of it converges to the frequency error of the local clock */
+static void StbM_Servo(const StbM_TimeBaseConfigType *config, uint64_t local, int64_t offset) {
+  StbM_TimeBaseContextType *context = config->context;
+  uint64_t now = Std_GetTimeNs();
+  int64_t interval = (int64_t)(local - context->lastSync);
+  int64_t error;
+
+  if (interval > 0) {
+    error = offset * STBM_NANOSECONDS_PER_SECOND / interval;
+    context->drift = StbM_Clamp((int64_t)context->drift + error * config->ki / STBM_SERVO_GAIN(1),
+                                config->maxRate);
+    /* rebase at now so that the time base is continuous when the rate is changed */
+    context->globalRef = StbM_GetGlobalNs(context, now);
+    context->localRef = now;
+    context->rate = StbM_Clamp((int64_t)context->drift + error * config->kp / STBM_SERVO_GAIN(1),
+                               config->maxRate);
+  }
+  ASLOG(STBM, ("offset %d ns, interval %d us, rate %d ppb, drift %d ppb\n", (int)offset,
+               (int)(interval / 1000), context->rate, context->drift));
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+void StbM_Init(const StbM_ConfigType *ConfigPtr) {
+  uint16_t i;
+  uint64_t now = Std_GetTimeNs();
+  StbM_TimeBaseContextType *context;
+
+  (void)ConfigPtr;
+  for (i = 0; i < STBM_CONFIG->numOfTimeBases; i++) {
+    context = STBM_CONFIG->timeBases[i].context;
+    memset(context, 0, sizeof(StbM_TimeBaseContextType));
+    /* the time base starts from 0 and runs with the local clock until it is synchronized */
+    context->localRef = now;
+    context->lastSync = now;
+  }
+}
+
+Std_ReturnType StbM_GetCurrentVirtualLocalTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                               StbM_VirtualLocalTimeType *localTimePtr) {
+  DET_VALIDATE(timeBaseId < STBM_CONFIG->numOfTimeBases, 0x1e, STBM_E_PARAM, return E_NOT_OK);
+  DET_VALIDATE(NULL != localTimePtr, 0x1e, STBM_E_PARAM_POINTER, return E_NOT_OK);
+
+  StbM_ToVirtualLocalTime(Std_GetTimeNs(), localTimePtr);
+
+  return E_OK;
+}
+
+Std_ReturnType StbM_BusGetCurrentTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                      StbM_TimeStampType *globalTimePtr,
+                                      StbM_VirtualLocalTimeType *localTimePtr,
+                                      StbM_UserDataType *userData) {
+  const StbM_TimeBaseContextType *context;
+  uint64_t now;
+
+  DET_VALIDATE(timeBaseId < STBM_CONFIG->numOfTimeBases, 0x1f, STBM_E_PARAM, return E_NOT_OK);
+  DET_VALIDATE((NULL != globalTimePtr) && (NULL != localTimePtr), 0x1f, STBM_E_PARAM_POINTER,
+               return E_NOT_OK);
+
+  context = STBM_CONFIG->timeBases[timeBaseId].context;
+  now = Std_GetTimeNs();
+  StbM_ToTimeStamp(StbM_GetGlobalNs(context, now), globalTimePtr);
+  globalTimePtr->timeBaseStatus = context->status;
+  StbM_ToVirtualLocalTime(now, localTimePtr);
+  if (NULL != userData) {
+    *userData = context->userData;
+  }
+
+  return E_OK;
+}
+
+Std_ReturnType StbM_GetCurrentTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                   StbM_TimeTupleType *timeTuple, StbM_UserDataType *userData) {
+  Std_ReturnType ret;
+
+  DET_VALIDATE(NULL != timeTuple, 0x07, STBM_E_PARAM_POINTER, return E_NOT_OK);
+
+  ret = StbM_BusGetCurrentTime(timeBaseId, &timeTuple->globalTime, &timeTuple->virtualLocalTime,
+                               userData);
+  if (E_OK == ret) {
+    timeTuple->timeBaseStatus = timeTuple->globalTime.timeBaseStatus;
+  }
+
+  return ret;
+}
+
+Std_ReturnType StbM_SetGlobalTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                  const StbM_TimeStampType *timeStamp,
+                                  const StbM_UserDataType *userData) {
+  StbM_TimeBaseContextType *context;
+  uint64_t now;
+
+  DET_VALIDATE(timeBaseId < STBM_CONFIG->numOfTimeBases, 0x0b, STBM_E_PARAM, return E_NOT_OK);
+  DET_VALIDATE(NULL != timeStamp, 0x0b, STBM_E_PARAM_POINTER, return E_NOT_OK);
+
+  context = STBM_CONFIG->timeBases[timeBaseId].context;
+  now = Std_GetTimeNs();
+  /* the time base of a time master is not disciplined */
+  context->drift = 0;
+  StbM_Step(context, now, StbM_FromTimeStamp(timeStamp));
+  context->lastSync = now;
+  context->status |= STBM_STATUS_GLOBAL_TIME_BASE;
+  context->status &= ~STBM_STATUS_TIMEOUT;
+  if (NULL != userData) {
+    context->userData = *userData;
+  }
+  context->updateCounter++;
+
+  return E_OK;
+}
+
+Std_ReturnType StbM_BusSetGlobalTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                     const StbM_TimeStampType *globalTimePtr,
+                                     const StbM_UserDataType *userDataPtr,
+                                     const StbM_MeasurementType *measureDataPtr,
+                                     const StbM_VirtualLocalTimeType *localTimePtr) {
+  const StbM_TimeBaseConfigType *config;
+  StbM_TimeBaseContextType *context;
+  uint64_t local;
+  uint64_t received;
+  int64_t offset;
+
+  DET_VALIDATE(timeBaseId < STBM_CONFIG->numOfTimeBases, 0x1c, STBM_E_PARAM, return E_NOT_OK);
+  DET_VALIDATE(NULL != globalTimePtr, 0x1c, STBM_E_PARAM_POINTER, return E_NOT_OK);
+
+  config = &STBM_CONFIG->timeBases[timeBaseId];
+  context = config->context;
+  /* the global time is valid at the virtual local time when it was received */
+  if (NULL != localTimePtr) {
+    local = ((uint64_t)localTimePtr->nanosecondsHi << 32) + localTimePtr->nanosecondsLo;
+  } else {
+    local = Std_GetTimeNs();
+  }
+
+  received = StbM_FromTimeStamp(globalTimePtr);
+  if (NULL != measureDataPtr) {
+    received += measureDataPtr->pathDelay;
+  }
+
+  if (0u == (context->status & STBM_STATUS_GLOBAL_TIME_BASE)) {
+    StbM_Step(context, local, received);
+    context->offset = 0;
+  } else {
+    offset = (int64_t)(received - StbM_GetGlobalNs(context, local));
+    context->offset = offset;
+    context->status &= ~(STBM_STATUS_TIMELEAP_FUTURE | STBM_STATUS_TIMELEAP_PAST);
+    if (offset > (int64_t)config->stepThreshold) {
+      context->status |= STBM_STATUS_TIMELEAP_FUTURE;
+      StbM_Step(context, local, received);
+    } else if (offset < -(int64_t)config->stepThreshold) {
+      context->status |= STBM_STATUS_TIMELEAP_PAST;
+      StbM_Step(context, local, received);
+    } else {
+      StbM_Servo(config, local, offset);
+    }
+    ASLOG(STBMI, ("[%d] offset %d ns\n", (int)timeBaseId, (int)offset));
+  }
+
+  context->lastSync = local;
+  context->timer = config->syncLossTimeout;
+  context->status &= ~(STBM_STATUS_TIMEOUT | STBM_STATUS_SYNC_TO_GATEWAY);
+  context->status |= STBM_STATUS_GLOBAL_TIME_BASE |
+                     (globalTimePtr->timeBaseStatus & STBM_STATUS_SYNC_TO_GATEWAY);
+  if (NULL != userDataPtr) {
+    context->userData = *userDataPtr;
+  }
+  context->updateCounter++;
+
+  return E_OK;
+}
+
+uint8_t StbM_GetTimeBaseUpdateCounter(StbM_SynchronizedTimeBaseType timeBaseId) {
+  DET_VALIDATE(timeBaseId < STBM_CONFIG->numOfTimeBases, 0x1b, STBM_E_PARAM, return 0);
+
+  return STBM_CONFIG->timeBases[timeBaseId].context->updateCounter;
+}
+
+Std_ReturnType StbM_GetRateDeviation(StbM_SynchronizedTimeBaseType timeBaseId,
+                                     StbM_RateDeviationType *rateDeviation) {
+  Std_ReturnType ret = E_NOT_OK;
+  const StbM_TimeBaseContextType *context;
+
+  DET_VALIDATE(timeBaseId < STBM_CONFIG->numOfTimeBases, 0x11, STBM_E_PARAM, return E_NOT_OK);
+  DET_VALIDATE(NULL != rateDeviation, 0x11, STBM_E_PARAM_POINTER, return E_NOT_OK);
+
+  context = STBM_CONFIG->timeBases[timeBaseId].context;
+  if (0u != (context->status & STBM_STATUS_GLOBAL_TIME_BASE)) {
+    *rateDeviation = (StbM_RateDeviationType)(context->drift / 1000);
+    ret = E_OK;
+  }
+
+  return ret;
+}
+
+void StbM_MainFunction(void) {
+  uint16_t i;
+  StbM_TimeBaseContextType *context;
+
+  for (i = 0; i < STBM_CONFIG->numOfTimeBases; i++) {
+    context = STBM_CONFIG->timeBases[i].context;
+    if (context->timer > 0u) {
+      context->timer--;
+      if (0u == context->timer) {
+        /* @SWS_StbM_00183 */
+        ASLOG(STBME, ("[%d] sync loss timeout\n", (int)i));
+        context->status |= STBM_STATUS_TIMEOUT;
+      }
+    }
+  }
+}
+
+void StbM_GetVersionInfo(Std_VersionInfoType *versionInfo) {
+  DET_VALIDATE(NULL != versionInfo, 0x05, STBM_E_PARAM_POINTER, return);
+
+  versionInfo->vendorID = STD_VENDOR_ID_AS;
+  versionInfo->moduleID = MODULE_ID_STBM;
+  versionInfo->sw_major_version = 4;
+  versionInfo->sw_minor_version = 0;
+  versionInfo->sw_patch_version = 0;
+}
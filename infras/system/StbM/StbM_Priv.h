@@ -0,0 +1,53 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * ref:
+ * https://www.autosar.org/fileadmin/standards/R20-11/CP/AUTOSAR_SWS_SynchronizedTimeBaseManager.pdf
+ */
+#ifndef __STB_M_PRIV_H__
+#define __STB_M_PRIV_H__
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "Std_Types.h"
+#include "StbM.h"
+/* ================================ [ MACROS    ] ============================================== */
+#define DET_THIS_MODULE_ID MODULE_ID_STBM
+
+/* the gains of the clock servo are fixed point numbers with STBM_SERVO_GAIN(1.0) as 1 */
+#define STBM_SERVO_GAIN_SHIFT 16
+#define STBM_SERVO_GAIN(x) ((int32_t)((x) * (1 << STBM_SERVO_GAIN_SHIFT)))
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint64_t localRef;  /* the local time in ns where the rate was last changed */
+  uint64_t globalRef; /* the global time in ns at localRef */
+  uint64_t lastSync;  /* the local time in ns of the last received global time */
+  int64_t offset;     /* the last measured offset: received - expected global time in ns */
+  int32_t rate;       /* the rate correction in ppb applied to the local time since localRef */
+  int32_t drift;      /* the integral part of the rate, the frequency error of the local clock */
+  uint16_t timer;     /* the sync loss timer in main cycles */
+  StbM_TimeBaseStatusType status;
+  uint8_t updateCounter;
+  StbM_UserDataType userData;
+} StbM_TimeBaseContextType;
+
+/* @ECUC_StbM_00030 */
+typedef struct {
+  StbM_TimeBaseContextType *context;
+  /* the received global time is stepped to when it is ahead of or behind the time base by more
+   * than this threshold in ns, smaller offsets are slewed by the rate correction */
+  uint32_t stepThreshold;
+  int32_t maxRate;          /* the limit of the rate correction in ppb */
+  int32_t kp;               /* the proportional gain of the PI servo, STBM_SERVO_GAIN */
+  int32_t ki;               /* the integral gain of the PI servo, STBM_SERVO_GAIN */
+  uint16_t syncLossTimeout; /* @ECUC_StbM_00025: in main cycles, 0 to disable */
+} StbM_TimeBaseConfigType;
+
+struct StbM_Config_s {
+  const StbM_TimeBaseConfigType *timeBases;
+  uint16_t numOfTimeBases;
+};
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+#endif /* __STB_M_PRIV_H__ */
@@ -0,0 +1,53 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * CanTSyn config of the offline sync test: two slaves of the same time domain, each one updates
+ * its own time base of the StbM
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "CanTSyn_Priv.h"
+#include "CanTSyn.h"
+/* ================================ [ MACROS    ] ============================================== */
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static CanTSyn_SlaveContextType CanTSyn_SlaveContext0;
+static CanTSyn_SlaveContextType CanTSyn_SlaveContext1;
+static const CanTSyn_GlobalTimeSlaveType CanTSyn_GlobalTimeSlave = {
+  100,                 /* GlobalTimeFollowUpTimeout */
+  10,                  /* GlobalTimeMinMsgGap */
+  3,                   /* GlobalTimeSequenceCounterJumpWidth */
+  CANTSYN_CRC_IGNORED, /* RxCrcValidated */
+  FALSE,               /* RxTmacValidated */
+};
+
+static const CanTSyn_GlobalTimeDomainType CanTSyn_GlobalTimeDomains[2] = {
+  {
+    {{&CanTSyn_SlaveContext0, &CanTSyn_GlobalTimeSlave}},
+    FALSE, /* EnableTimeValidation */
+    0,     /* GlobalTimeDomainId */
+    0,     /* GlobalTimeNetworkSegmentId */
+    0,     /* GlobalTimeSecureTmacLength */
+    FALSE, /* UseExtendedMsgFormat */
+    0,     /* SynchronizedTimeBaseRef */
+    CANTSYN_SLAVE,
+  },
+  {
+    {{&CanTSyn_SlaveContext1, &CanTSyn_GlobalTimeSlave}},
+    FALSE, /* EnableTimeValidation */
+    0,     /* GlobalTimeDomainId */
+    0,     /* GlobalTimeNetworkSegmentId */
+    0,     /* GlobalTimeSecureTmacLength */
+    FALSE, /* UseExtendedMsgFormat */
+    1,     /* SynchronizedTimeBaseRef */
+    CANTSYN_SLAVE,
+  },
+};
+
+const CanTSyn_ConfigType CanTSyn_Config = {
+  CanTSyn_GlobalTimeDomains,
+  ARRAY_SIZE(CanTSyn_GlobalTimeDomains),
+};
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
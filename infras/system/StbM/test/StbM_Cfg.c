@@ -0,0 +1,42 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * StbM config of the offline sync test: time base 0 is stepped by every received global time as a
+ * reference, time base 1 is disciplined by the PI servo
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "StbM_Priv.h"
+#include "StbM.h"
+/* ================================ [ MACROS    ] ============================================== */
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static StbM_TimeBaseContextType StbM_TimeBaseContext0;
+static StbM_TimeBaseContextType StbM_TimeBaseContext1;
+
+static const StbM_TimeBaseConfigType StbM_TimeBases[2] = {
+  {
+    &StbM_TimeBaseContext0,
+    0, /* stepThreshold */
+    0, /* maxRate */
+    0, /* kp */
+    0, /* ki */
+    0, /* syncLossTimeout */
+  },
+  {
+    &StbM_TimeBaseContext1,
+    1000000,              /* stepThreshold: 1ms */
+    500000,               /* maxRate: 500ppm */
+    STBM_SERVO_GAIN(0.7), /* kp */
+    STBM_SERVO_GAIN(0.3), /* ki */
+    0,                    /* syncLossTimeout */
+  },
+};
+
+const StbM_ConfigType StbM_Config = {
+  StbM_TimeBases,
+  ARRAY_SIZE(StbM_TimeBases),
+};
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
@@ -0,0 +1,350 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Offline test of the StbM clock servo: a SYNC/FUP sequence of a CanTSyn time master is recorded as
+ * seen by a slave whose local clock runs fast or slow with a slow wander, each record is
+ * "<local ns> <master time ns> <8 bytes PDU in hex>". The recording is replayed through the
+ * CanTSyn_RxIndication into time base 0 which is stepped by each global time and time base 1 which
+ * is slewed by the PI servo. Between the records the time bases are sampled every TEST_SAMPLE_US
+ * and compared with the master time interpolated from the records. Once settled, the stepped time
+ * base must stay within the drift of one SYNC period and the servo one within a few us of the
+ * master, never stepped nor set back, with a rate correction close to the true one.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "StbM.h"
+#include "StbM_Priv.h"
+#include "ComStack_Types.h"
+#include "CanTSyn.h"
+#include "CanIf.h"
+#include "Std_Timer.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_SECONDS
+#define TEST_SECONDS 600u
+#endif
+
+#ifndef TEST_PERIOD_MS
+#define TEST_PERIOD_MS 1000u
+#endif
+
+/* the amplitude of the frequency wander of the slave local clock */
+#define TEST_WANDER_PPM 10.0
+#define TEST_WANDER_PERIOD_S 300.0
+
+/* the max interrupt latency of the slave to take t2r after the SYNC is transmitted */
+#define TEST_RX_LATENCY_US 5u
+
+/* the time bases are only checked once the servo had time to converge */
+#define TEST_SETTLE_SECONDS 60u
+
+/* the bounds of the servo time base once settled */
+#define TEST_SERVO_MAX_OFFSET_NS 10000.0
+#define TEST_SERVO_RMS_OFFSET_NS 5000.0
+#define TEST_SERVO_MAX_RATE_PPB 10000.0
+#define TEST_SERVO_MEAN_RATE_PPB 3000.0
+
+#define TEST_SAMPLE_US 1000u
+#define TEST_NUM_TIME_BASES 2u
+#define TEST_STEP 0u
+#define TEST_SERVO 1u
+#define TEST_MASTER_EPOCH_S 1700000000ull
+#define TEST_PI 3.14159265358979323846
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint64_t local;  /* the slave local time when the PDU is received */
+  uint64_t master; /* the master time at local, 0 if unknown */
+  uint8_t data[8];
+} test_record_t;
+
+typedef struct {
+  double sum;
+  double sumSquare;
+  double maxError;
+  double sumRateError;
+  double maxRateError;
+  uint32_t samples;
+  uint32_t syncs;
+  uint32_t backwards; /* the time base is set back by a received global time */
+  uint32_t steps;     /* the time base jumps by more than 1us at a received global time */
+} test_stats_t;
+/* ================================ [ DECLARES  ] ============================================== */
+extern const StbM_ConfigType StbM_Config;
+/* ================================ [ DATAS     ] ============================================== */
+static uint64_t testLocal;
+static double testSlavePpm;
+static test_stats_t testStats[TEST_NUM_TIME_BASES];
+/* ================================ [ LOCALS    ] ============================================== */
+static uint64_t test_uniform(uint64_t min, uint64_t max) {
+  return min + (uint64_t)rand() % (max - min + 1u);
+}
+
+/* the integral of the frequency error of the slave clock over the master time t in ns */
+static double test_slave_drift(uint64_t t) {
+  double w = 2 * TEST_PI / (TEST_WANDER_PERIOD_S * 1e9);
+
+  return ((double)t * testSlavePpm + TEST_WANDER_PPM * (1 - cos(w * (double)t)) / w) / 1e6;
+}
+
+/* the rate correction in ppb which turns the slave local time into the master time */
+static double test_slave_rate(uint64_t t) {
+  double w = 2 * TEST_PI / (TEST_WANDER_PERIOD_S * 1e9);
+  double ppm = testSlavePpm + TEST_WANDER_PPM * sin(w * (double)t);
+
+  return (1 / (1 + ppm / 1e6) - 1) * 1e9;
+}
+
+static uint64_t test_slave_local(uint64_t t) {
+  /* the slave was booted 5s before the master */
+  return 5000000000ull + t + (uint64_t)(int64_t)llround(test_slave_drift(t));
+}
+
+static void test_write(FILE *fp, uint64_t t, uint64_t master, const uint8_t *data) {
+  fprintf(fp, "%" PRIu64 " %" PRIu64 " %02X%02X%02X%02X%02X%02X%02X%02X\n", test_slave_local(t),
+          master, data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
+}
+
+/*  t0: the master takes T0 and sends the SYNC with s(T0)
+ *  t1: the SYNC is transmitted, the master takes T1 by the TxConfirmation
+ *  t2: the slave takes t2r in the RxIndication, delayed by the interrupt latency
+ *  t3: the slave takes t3r when the FUP with T1 - s(T0) is received */
+static int test_record(const char *path) {
+  FILE *fp = fopen(path, "wb");
+  uint64_t t0, t1, t2, t3, T0, T1, t4r;
+  uint32_t st0r;
+  uint8_t SC = 0;
+  uint8_t data[8];
+
+  if (NULL == fp) {
+    return -1;
+  }
+
+  for (t0 = 100000000u; t0 < (uint64_t)TEST_SECONDS * 1000000000u;
+       t0 += (uint64_t)TEST_PERIOD_MS * 1000000u) {
+    t1 = t0 + test_uniform(100000u, 500000u);
+    t2 = t1 + test_uniform(0u, TEST_RX_LATENCY_US * 1000u);
+    t3 = t2 + test_uniform(2000000u, 10000000u);
+    T0 = TEST_MASTER_EPOCH_S * 1000000000u + t0;
+    T1 = TEST_MASTER_EPOCH_S * 1000000000u + t1;
+
+    st0r = (uint32_t)(T0 / 1000000000u);
+    data[0] = 0x10; /* SYNC without CRC */
+    data[1] = 0x00;
+    data[2] = SC;
+    data[3] = 0x00;
+    data[4] = (uint8_t)(st0r >> 24);
+    data[5] = (uint8_t)(st0r >> 16);
+    data[6] = (uint8_t)(st0r >> 8);
+    data[7] = (uint8_t)st0r;
+    test_write(fp, t2, TEST_MASTER_EPOCH_S * 1000000000u + t2, data);
+
+    t4r = T1 - (uint64_t)st0r * 1000000000u;
+    data[0] = 0x18; /* FUP without CRC */
+    data[3] = 0x00; /* OVS is 0 as t4r < 4.29s */
+    data[4] = (uint8_t)(t4r >> 24);
+    data[5] = (uint8_t)(t4r >> 16);
+    data[6] = (uint8_t)(t4r >> 8);
+    data[7] = (uint8_t)t4r;
+    test_write(fp, t3, TEST_MASTER_EPOCH_S * 1000000000u + t3, data);
+
+    SC = (SC + 1u) & 0xFu;
+  }
+
+  fclose(fp);
+  return 0;
+}
+
+static int test_read(FILE *fp, test_record_t *record) {
+  char hex[17];
+  int i, r = -1;
+  unsigned int byte;
+
+  if (3 == fscanf(fp, "%" SCNu64 " %" SCNu64 " %16s", &record->local, &record->master, hex)) {
+    r = 0;
+    for (i = 0; (0 == r) && (i < 8); i++) {
+      if (1 == sscanf(&hex[2 * i], "%2x", &byte)) {
+        record->data[i] = (uint8_t)byte;
+      } else {
+        r = -1;
+      }
+    }
+  }
+
+  return r;
+}
+
+static uint64_t test_get_time_base(StbM_SynchronizedTimeBaseType timeBaseId) {
+  StbM_TimeTupleType timeTuple;
+
+  (void)StbM_GetCurrentTime(timeBaseId, &timeTuple, NULL);
+  return (((uint64_t)timeTuple.globalTime.secondsHi << 32) + timeTuple.globalTime.seconds) *
+           1000000000u +
+         timeTuple.globalTime.nanoseconds;
+}
+
+static void test_sample(const test_record_t *prev, const test_record_t *cur, boolean settled) {
+  uint64_t local;
+  double master, error;
+  StbM_SynchronizedTimeBaseType id;
+  test_stats_t *stats;
+
+  for (local = prev->local + TEST_SAMPLE_US * 1000u; local < cur->local;
+       local += TEST_SAMPLE_US * 1000u) {
+    testLocal = local;
+    /* the master time is linear between 2 records close to each other, it is kept relative to
+     * the previous record as the double has no ns resolution for a time since the epoch */
+    master = (double)(cur->master - prev->master) * (double)(local - prev->local) /
+             (double)(cur->local - prev->local);
+    for (id = 0; id < TEST_NUM_TIME_BASES; id++) {
+      stats = &testStats[id];
+      if (settled && (0u != prev->master) && (0u != cur->master)) {
+        error = (double)(int64_t)(test_get_time_base(id) - prev->master) - master;
+        stats->sum += error;
+        stats->sumSquare += error * error;
+        if (fabs(error) > stats->maxError) {
+          stats->maxError = fabs(error);
+        }
+        stats->samples++;
+      }
+    }
+  }
+}
+
+static int test_replay(const char *path) {
+  FILE *fp = fopen(path, "rb");
+  test_record_t prev, cur;
+  PduInfoType PduInfo;
+  StbM_SynchronizedTimeBaseType id;
+  const StbM_TimeBaseContextType *context;
+  test_stats_t *stats;
+  uint64_t first = 0;
+  boolean settled;
+  double rate, error;
+  uint64_t before, after;
+
+  if (NULL == fp) {
+    return -1;
+  }
+
+  memset(testStats, 0, sizeof(testStats));
+  memset(&prev, 0, sizeof(prev));
+  while (0 == test_read(fp, &cur)) {
+    if (0u == first) {
+      first = cur.local;
+      testLocal = cur.local;
+      StbM_Init(NULL);
+      CanTSyn_Init(NULL);
+    }
+    settled = (cur.local - first) >= (uint64_t)TEST_SETTLE_SECONDS * 1000000000u;
+    if (cur.local != first) {
+      test_sample(&prev, &cur, settled);
+    }
+
+    testLocal = cur.local;
+    PduInfo.SduDataPtr = cur.data;
+    PduInfo.MetaDataPtr = NULL;
+    PduInfo.SduLength = 8;
+    for (id = 0; id < TEST_NUM_TIME_BASES; id++) {
+      stats = &testStats[id];
+      context = StbM_Config.timeBases[id].context;
+      before = test_get_time_base(id);
+      CanTSyn_RxIndication((PduIdType)id, &PduInfo);
+      after = test_get_time_base(id);
+      if (settled && (0x18 == cur.data[0])) {
+        if (after < before) {
+          stats->backwards++;
+        }
+        if (((int64_t)(after - before) > 1000) || ((int64_t)(after - before) < -1000)) {
+          stats->steps++;
+        }
+      }
+      if (settled && (0x18 == cur.data[0]) && (0u != cur.master)) {
+        /* the rate correction applied to the local clock against the true one */
+        rate = test_slave_rate(cur.master - TEST_MASTER_EPOCH_S * 1000000000u);
+        error = fabs((double)context->rate - rate);
+        stats->sumRateError += error;
+        if (error > stats->maxRateError) {
+          stats->maxRateError = error;
+        }
+        stats->syncs++;
+      }
+    }
+    prev = cur;
+  }
+  fclose(fp);
+
+  return 0;
+}
+
+static void test_print(void) {
+  StbM_SynchronizedTimeBaseType id;
+  test_stats_t *stats;
+
+  for (id = 0; id < TEST_NUM_TIME_BASES; id++) {
+    stats = &testStats[id];
+    printf("  time base %u %-5s: residual offset mean=%.1f ns rms=%.1f ns max=%.1f ns, rate "
+           "error mean=%.1f ppb max=%.1f ppb, steps=%u backwards=%u\n",
+           id, (TEST_STEP == id) ? "step" : "servo",
+           (stats->samples > 0u) ? stats->sum / stats->samples : 0.0,
+           (stats->samples > 0u) ? sqrt(stats->sumSquare / stats->samples) : 0.0, stats->maxError,
+           (stats->syncs > 0u) ? stats->sumRateError / stats->syncs : 0.0, stats->maxRateError,
+           stats->steps, stats->backwards);
+  }
+}
+
+static void Test_Sync(double slavePpm) {
+  const char *path = "stbm_test.log";
+  const test_stats_t *step = &testStats[TEST_STEP];
+  const test_stats_t *servo = &testStats[TEST_SERVO];
+  /* the stepped time base is off by the drift over a SYNC period and the FUP delay of up to 10ms
+   * plus the rx latency */
+  double stepMaxError =
+    (fabs(slavePpm) + TEST_WANDER_PPM) * (TEST_PERIOD_MS + 10u) + TEST_RX_LATENCY_US * 1000.0;
+  uint32_t syncs = (TEST_SECONDS - TEST_SETTLE_SECONDS) * 1000u / TEST_PERIOD_MS;
+  bool bPass;
+
+  printf("Test sync of a slave clock of %+.1f ppm wander %.1f ppm:", slavePpm, TEST_WANDER_PPM);
+  testSlavePpm = slavePpm;
+  bPass = (0 == test_record(path)) && (0 == test_replay(path));
+  bPass = bPass && (step->syncs >= (syncs - 1u)) && (servo->syncs == step->syncs) &&
+          (step->samples > 0u) && (servo->samples == step->samples);
+  /* the stepped time base is set back by every SYNC for a fast clock and has no rate correction */
+  bPass = bPass && (step->maxError <= stepMaxError) && (step->steps == step->syncs) &&
+          ((slavePpm > 0) ? (step->backwards == step->syncs) : (0u == step->backwards));
+  bPass = bPass && (servo->maxError <= TEST_SERVO_MAX_OFFSET_NS) &&
+          (sqrt(servo->sumSquare / servo->samples) <= TEST_SERVO_RMS_OFFSET_NS) &&
+          (servo->maxRateError <= TEST_SERVO_MAX_RATE_PPB) &&
+          ((servo->sumRateError / servo->syncs) <= TEST_SERVO_MEAN_RATE_PPB) &&
+          (0u == servo->steps) && (0u == servo->backwards);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    test_print();
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+uint64_t Std_GetTimeNs(void) {
+  return testLocal;
+}
+
+std_time_t Std_GetTime(void) {
+  return (std_time_t)(testLocal / 1000u);
+}
+
+Std_ReturnType CanIf_Transmit(PduIdType TxPduId, const PduInfoType *PduInfoPtr) {
+  return E_NOT_OK;
+}
+
+int main(int argc, char *argv[]) {
+  srand(1);
+
+  Test_Sync(80.0);
+  Test_Sync(-80.0);
+
+  return 0;
+}
@@ -0,0 +1,499 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "blkcache.h"
+#include <string.h>
+#include "Std_Debug.h"
+/* ================================ [ MACROS    ] ============================================== */
+#define AS_LOG_BLKCACHE 0
+#define AS_LOG_BLKCACHEE 3
+
+/* the filesystems on top are not reentrant by default, define them to a mutex if the filesystems
+ * of different devices are accessed by different tasks */
+#ifndef BLKCACHE_LOCK
+#define BLKCACHE_LOCK()
+#endif
+
+#ifndef BLKCACHE_UNLOCK
+#define BLKCACHE_UNLOCK()
+#endif
+
+#define BLKCACHE_LINE_SIZE (BLKCACHE_LINE_SECTORS * BLKCACHE_SECTOR_SIZE)
+#define BLKCACHE_FULL_MASK ((blkcache_mask_t)(((uint64_t)1 << BLKCACHE_LINE_SECTORS) - 1u))
+/* requests of this size or bigger bypass the lines to not flush the cache by streaming */
+#define BLKCACHE_BYPASS_SECTORS (BLKCACHE_READ_AHEAD * BLKCACHE_LINE_SECTORS)
+
+#if BLKCACHE_NUM_LINES > 0
+#if BLKCACHE_LINE_SECTORS > 32
+#error BLKCACHE_LINE_SECTORS must not be bigger than 32
+#endif
+#if (BLKCACHE_READ_AHEAD < 1) || (BLKCACHE_READ_AHEAD > BLKCACHE_NUM_LINES)
+#error BLKCACHE_READ_AHEAD must be in range [1, BLKCACHE_NUM_LINES]
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef uint32_t blkcache_mask_t; /* one bit for each sector of a line */
+
+typedef struct blkcache_line_s {
+  const device_t *device; /* NULL if the line is free */
+  size_t line;            /* the first sector of the line is line * BLKCACHE_LINE_SECTORS */
+  blkcache_mask_t valid;
+  blkcache_mask_t dirty;
+  uint8_t *data;
+  TAILQ_ENTRY(blkcache_line_s) lru;
+  LIST_ENTRY(blkcache_line_s) hash;
+} blkcache_line_t;
+
+typedef struct {
+  const device_t *device;
+  size_t numOfSectors;
+  size_t nextPos; /* the sector next to the last read, to detect the sequential reads */
+  boolean cached;
+} blkcache_device_t;
+
+TAILQ_HEAD(blkcache_lru_head, blkcache_line_s);
+LIST_HEAD(blkcache_hash_head, blkcache_line_s);
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static uint8_t blkcache_data[BLKCACHE_NUM_LINES][BLKCACHE_LINE_SIZE];
+static uint8_t blkcache_stage[BLKCACHE_READ_AHEAD * BLKCACHE_LINE_SIZE];
+static blkcache_line_t blkcache_lines[BLKCACHE_NUM_LINES];
+static blkcache_line_t *blkcache_dirty[BLKCACHE_NUM_LINES];
+static size_t blkcache_used = 0;
+static blkcache_device_t blkcache_devices[BLKCACHE_MAX_DEVICES];
+/* the most recently used line is at the head, the free lines are at the tail */
+static struct blkcache_lru_head blkcache_lru = TAILQ_HEAD_INITIALIZER(blkcache_lru);
+static struct blkcache_hash_head blkcache_hash[BLKCACHE_NUM_LINES];
+/* ================================ [ LOCALS    ] ============================================== */
+static blkcache_mask_t blkcache_mask(size_t first, size_t count) {
+  blkcache_mask_t mask = BLKCACHE_FULL_MASK;
+
+  if (count < BLKCACHE_LINE_SECTORS) {
+    mask = (((blkcache_mask_t)1 << count) - 1u) << first;
+  }
+
+  return mask;
+}
+
+static struct blkcache_hash_head *blkcache_bucket(const device_t *device, size_t line) {
+  size_t index = ((uintptr_t)device / sizeof(device_t)) + line;
+
+  return &blkcache_hash[index % BLKCACHE_NUM_LINES];
+}
+
+static blkcache_device_t *blkcache_get_device(const device_t *device) {
+  blkcache_device_t *dev = NULL;
+  blkcache_device_t *unused = NULL;
+  size_t sectorSize = 0;
+  size_t i;
+
+  for (i = 0; (i < BLKCACHE_MAX_DEVICES) && (NULL == dev); i++) {
+    if (device == blkcache_devices[i].device) {
+      dev = &blkcache_devices[i];
+    } else if ((NULL == unused) && (NULL == blkcache_devices[i].device)) {
+      unused = &blkcache_devices[i];
+    }
+  }
+
+  if ((NULL == dev) && (NULL != unused)) {
+    dev = unused;
+    dev->device = device;
+    dev->numOfSectors = 0;
+    dev->nextPos = 0;
+    dev->cached = FALSE;
+    if (NULL != device->ops.ctrl) {
+      if ((0 == device->ops.ctrl(device, DEVICE_CTRL_GET_SECTOR_SIZE, &sectorSize)) &&
+          (BLKCACHE_SECTOR_SIZE == sectorSize) &&
+          (0 == device->ops.ctrl(device, DEVICE_CTRL_GET_SECTOR_COUNT, &dev->numOfSectors))) {
+        dev->cached = TRUE;
+      }
+    }
+    ASLOG(BLKCACHE, ("%s: sector size %u, %u sectors, %s\n", device->name, (uint32_t)sectorSize,
+                     (uint32_t)dev->numOfSectors, dev->cached ? "cached" : "not cached"));
+  }
+
+  return dev;
+}
+
+static blkcache_line_t *blkcache_lookup(const device_t *device, size_t line) {
+  blkcache_line_t *l;
+
+  LIST_FOREACH(l, blkcache_bucket(device, line), hash) {
+    if ((device == l->device) && (line == l->line)) {
+      break;
+    }
+  }
+
+  return l;
+}
+
+static void blkcache_touch(blkcache_line_t *l) {
+  if (l != TAILQ_FIRST(&blkcache_lru)) {
+    TAILQ_REMOVE(&blkcache_lru, l, lru);
+    TAILQ_INSERT_HEAD(&blkcache_lru, l, lru);
+  }
+}
+
+static int blkcache_flush_line(blkcache_line_t *l) {
+  int ercd = 0;
+  size_t first = 0;
+  size_t last;
+
+  while ((first < BLKCACHE_LINE_SECTORS) && (0 == ercd)) {
+    if (0u != (l->dirty & ((blkcache_mask_t)1 << first))) {
+      last = first + 1;
+      while ((last < BLKCACHE_LINE_SECTORS) && (0u != (l->dirty & ((blkcache_mask_t)1 << last)))) {
+        last++;
+      }
+      ercd = l->device->ops.write(l->device, l->line * BLKCACHE_LINE_SECTORS + first,
+                                  &l->data[first * BLKCACHE_SECTOR_SIZE], last - first);
+      first = last;
+    } else {
+      first++;
+    }
+  }
+
+  if (0 == ercd) {
+    l->dirty = 0;
+  } else {
+    ASLOG(BLKCACHEE, ("%s: write back line %u failed: %d\n", l->device->name, (uint32_t)l->line,
+                      ercd));
+  }
+
+  return ercd;
+}
+
+static blkcache_line_t *blkcache_alloc(const device_t *device, size_t line) {
+  blkcache_line_t *l;
+
+  if (blkcache_used < BLKCACHE_NUM_LINES) {
+    l = &blkcache_lines[blkcache_used];
+    l->data = blkcache_data[blkcache_used];
+    blkcache_used++;
+  } else {
+    l = TAILQ_LAST(&blkcache_lru, blkcache_lru_head);
+    if (NULL != l->device) {
+      if ((0u != l->dirty) && (0 != blkcache_flush_line(l))) {
+        l = NULL;
+      } else {
+        LIST_REMOVE(l, hash);
+      }
+    }
+    if (NULL != l) {
+      TAILQ_REMOVE(&blkcache_lru, l, lru);
+    }
+  }
+
+  if (NULL != l) {
+    l->device = device;
+    l->line = line;
+    l->valid = 0;
+    l->dirty = 0;
+    LIST_INSERT_HEAD(blkcache_bucket(device, line), l, hash);
+    TAILQ_INSERT_HEAD(&blkcache_lru, l, lru);
+  }
+
+  return l;
+}
+
+static void blkcache_free(blkcache_line_t *l) {
+  LIST_REMOVE(l, hash);
+  TAILQ_REMOVE(&blkcache_lru, l, lru);
+  TAILQ_INSERT_TAIL(&blkcache_lru, l, lru);
+  l->device = NULL;
+  l->valid = 0;
+  l->dirty = 0;
+}
+
+/* read count lines in one device transaction, the sectors already in the cache are kept as they
+ * may be dirty */
+static int blkcache_fetch(blkcache_device_t *dev, size_t line, size_t count) {
+  int ercd;
+  const device_t *device = dev->device;
+  blkcache_line_t *l;
+  size_t pos = line * BLKCACHE_LINE_SECTORS;
+  size_t sectors = count * BLKCACHE_LINE_SECTORS;
+  size_t i, s, n;
+
+  if ((pos + sectors) > dev->numOfSectors) {
+    sectors = dev->numOfSectors - pos;
+  }
+
+  /* make the cached lines of the range the most recently used, so that they are not evicted and
+   * written back by the allocation of the other lines after their stale data is read */
+  for (i = 0; (i * BLKCACHE_LINE_SECTORS) < sectors; i++) {
+    l = blkcache_lookup(device, line + i);
+    if (NULL != l) {
+      blkcache_touch(l);
+    }
+  }
+
+  ercd = device->ops.read(device, pos, blkcache_stage, sectors);
+  for (i = 0; (0 == ercd) && ((i * BLKCACHE_LINE_SECTORS) < sectors); i++) {
+    l = blkcache_lookup(device, line + i);
+    if (NULL == l) {
+      l = blkcache_alloc(device, line + i);
+    } else {
+      blkcache_touch(l);
+    }
+    if (NULL != l) {
+      n = sectors - i * BLKCACHE_LINE_SECTORS;
+      if (n > BLKCACHE_LINE_SECTORS) {
+        n = BLKCACHE_LINE_SECTORS;
+      }
+      if (0u == l->valid) {
+        memcpy(l->data, &blkcache_stage[i * BLKCACHE_LINE_SIZE], n * BLKCACHE_SECTOR_SIZE);
+      } else {
+        for (s = 0; s < n; s++) {
+          if (0u == (l->valid & ((blkcache_mask_t)1 << s))) {
+            memcpy(&l->data[s * BLKCACHE_SECTOR_SIZE],
+                   &blkcache_stage[i * BLKCACHE_LINE_SIZE + s * BLKCACHE_SECTOR_SIZE],
+                   BLKCACHE_SECTOR_SIZE);
+          }
+        }
+      }
+      l->valid |= blkcache_mask(0, n);
+    } else {
+      ercd = -EIO;
+    }
+  }
+
+  return ercd;
+}
+
+/* keep the lines in range [pos, pos + size) coherent with a request which bypassed the cache:
+ * the read buffer gets the dirty sectors, the written sectors are copied to the lines */
+static void blkcache_bypass(const device_t *device, size_t pos, uint8_t *buffer, size_t size,
+                            boolean isWrite) {
+  blkcache_line_t *l;
+  blkcache_mask_t bit;
+  size_t end = pos + size;
+  size_t line, s, offset;
+
+  for (line = pos / BLKCACHE_LINE_SECTORS; (line * BLKCACHE_LINE_SECTORS) < end; line++) {
+    l = blkcache_lookup(device, line);
+    if (NULL != l) {
+      for (s = 0; s < BLKCACHE_LINE_SECTORS; s++) {
+        offset = line * BLKCACHE_LINE_SECTORS + s;
+        bit = (blkcache_mask_t)1 << s;
+        if ((offset >= pos) && (offset < end)) {
+          offset = (offset - pos) * BLKCACHE_SECTOR_SIZE;
+          if (isWrite) {
+            memcpy(&l->data[s * BLKCACHE_SECTOR_SIZE], &buffer[offset], BLKCACHE_SECTOR_SIZE);
+            l->valid |= bit;
+            l->dirty &= ~bit;
+          } else if (0u != (l->dirty & bit)) {
+            memcpy(&buffer[offset], &l->data[s * BLKCACHE_SECTOR_SIZE], BLKCACHE_SECTOR_SIZE);
+          } else {
+            /* the device has the same data */
+          }
+        }
+      }
+    }
+  }
+}
+
+static void blkcache_sort(blkcache_line_t **lines, size_t num) {
+  blkcache_line_t *l;
+  size_t i, j;
+
+  for (i = 1; i < num; i++) {
+    l = lines[i];
+    j = i;
+    while ((j > 0) && (((uintptr_t)lines[j - 1]->device > (uintptr_t)l->device) ||
+                       ((lines[j - 1]->device == l->device) && (lines[j - 1]->line > l->line)))) {
+      lines[j] = lines[j - 1];
+      j--;
+    }
+    lines[j] = l;
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int blkcache_read(const device_t *device, size_t pos, void *buffer, size_t size) {
+  int ercd = 0;
+  blkcache_device_t *dev;
+  blkcache_line_t *l;
+  uint8_t *dst = (uint8_t *)buffer;
+  size_t end = pos + size;
+  size_t line, first, n, count;
+  blkcache_mask_t mask;
+  boolean sequential;
+
+  BLKCACHE_LOCK();
+  dev = blkcache_get_device(device);
+  if ((NULL == dev) || (FALSE == dev->cached) || (end > dev->numOfSectors)) {
+    ercd = device->ops.read(device, pos, buffer, size);
+  } else if (size >= BLKCACHE_BYPASS_SECTORS) {
+    dev->nextPos = end;
+    ercd = device->ops.read(device, pos, buffer, size);
+    if (0 == ercd) {
+      blkcache_bypass(device, pos, dst, size, FALSE);
+    }
+  } else {
+    sequential = (pos == dev->nextPos);
+    dev->nextPos = end;
+    while ((pos < end) && (0 == ercd)) {
+      line = pos / BLKCACHE_LINE_SECTORS;
+      first = pos % BLKCACHE_LINE_SECTORS;
+      n = BLKCACHE_LINE_SECTORS - first;
+      if (n > (end - pos)) {
+        n = end - pos;
+      }
+      mask = blkcache_mask(first, n);
+      l = blkcache_lookup(device, line);
+      if ((NULL != l) && (mask == (l->valid & mask))) {
+        memcpy(dst, &l->data[first * BLKCACHE_SECTOR_SIZE], n * BLKCACHE_SECTOR_SIZE);
+        blkcache_touch(l);
+        pos += n;
+        dst += n * BLKCACHE_SECTOR_SIZE;
+      } else {
+        count = (end - 1) / BLKCACHE_LINE_SECTORS - line + 1;
+        if (sequential || (count > BLKCACHE_READ_AHEAD)) {
+          count = BLKCACHE_READ_AHEAD;
+        }
+        ercd = blkcache_fetch(dev, line, count);
+      }
+    }
+  }
+  BLKCACHE_UNLOCK();
+
+  return ercd;
+}
+
+int blkcache_write(const device_t *device, size_t pos, const void *buffer, size_t size) {
+  int ercd = 0;
+  blkcache_device_t *dev;
+  blkcache_line_t *l;
+  const uint8_t *src = (const uint8_t *)buffer;
+  size_t end = pos + size;
+  size_t line, first, n;
+  blkcache_mask_t mask;
+
+  BLKCACHE_LOCK();
+  dev = blkcache_get_device(device);
+  if ((NULL == dev) || (FALSE == dev->cached) || (end > dev->numOfSectors)) {
+    ercd = device->ops.write(device, pos, buffer, size);
+  } else if (size >= BLKCACHE_BYPASS_SECTORS) {
+    ercd = device->ops.write(device, pos, buffer, size);
+    if (0 == ercd) {
+      blkcache_bypass(device, pos, (uint8_t *)buffer, size, TRUE);
+    }
+  } else {
+    while ((pos < end) && (0 == ercd)) {
+      line = pos / BLKCACHE_LINE_SECTORS;
+      first = pos % BLKCACHE_LINE_SECTORS;
+      n = BLKCACHE_LINE_SECTORS - first;
+      if (n > (end - pos)) {
+        n = end - pos;
+      }
+      mask = blkcache_mask(first, n);
+      l = blkcache_lookup(device, line);
+      if (NULL == l) {
+        l = blkcache_alloc(device, line);
+      } else {
+        blkcache_touch(l);
+      }
+      if (NULL != l) {
+        memcpy(&l->data[first * BLKCACHE_SECTOR_SIZE], src, n * BLKCACHE_SECTOR_SIZE);
+        l->valid |= mask;
+        l->dirty |= mask;
+        pos += n;
+        src += n * BLKCACHE_SECTOR_SIZE;
+      } else {
+        ercd = -EIO;
+      }
+    }
+  }
+  BLKCACHE_UNLOCK();
+
+  return ercd;
+}
+
+int blkcache_sync(const device_t *device) {
+  int ercd = 0;
+  blkcache_line_t *l;
+  size_t num = 0;
+  size_t i = 0;
+  size_t j, count;
+
+  BLKCACHE_LOCK();
+  for (j = 0; j < blkcache_used; j++) {
+    l = &blkcache_lines[j];
+    if ((NULL != l->device) && (0u != l->dirty) && ((NULL == device) || (device == l->device))) {
+      blkcache_dirty[num] = l;
+      num++;
+    }
+  }
+
+  blkcache_sort(blkcache_dirty, num);
+
+  while ((i < num) && (0 == ercd)) {
+    l = blkcache_dirty[i];
+    count = 1;
+    if (BLKCACHE_FULL_MASK == l->dirty) {
+      /* merge the fully dirty adjacent lines into one device transaction */
+      while (((i + count) < num) && (count < BLKCACHE_READ_AHEAD) &&
+             (blkcache_dirty[i + count]->device == l->device) &&
+             (blkcache_dirty[i + count]->line == (l->line + count)) &&
+             (BLKCACHE_FULL_MASK == blkcache_dirty[i + count]->dirty)) {
+        count++;
+      }
+    }
+    if (count > 1) {
+      for (j = 0; j < count; j++) {
+        memcpy(&blkcache_stage[j * BLKCACHE_LINE_SIZE], blkcache_dirty[i + j]->data,
+               BLKCACHE_LINE_SIZE);
+      }
+      ercd = l->device->ops.write(l->device, l->line * BLKCACHE_LINE_SECTORS, blkcache_stage,
+                                  count * BLKCACHE_LINE_SECTORS);
+      for (j = 0; (j < count) && (0 == ercd); j++) {
+        blkcache_dirty[i + j]->dirty = 0;
+      }
+    } else {
+      ercd = blkcache_flush_line(l);
+    }
+    i += count;
+  }
+  BLKCACHE_UNLOCK();
+
+  return ercd;
+}
+
+void blkcache_invalidate(const device_t *device) {
+  blkcache_line_t *l;
+  size_t i;
+
+  BLKCACHE_LOCK();
+  for (i = 0; i < blkcache_used; i++) {
+    l = &blkcache_lines[i];
+    if ((NULL != l->device) && ((NULL == device) || (device == l->device))) {
+      blkcache_free(l);
+    }
+  }
+
+  for (i = 0; i < BLKCACHE_MAX_DEVICES; i++) {
+    if ((NULL == device) || (device == blkcache_devices[i].device)) {
+      blkcache_devices[i].device = NULL;
+    }
+  }
+  BLKCACHE_UNLOCK();
+}
+#else /* BLKCACHE_NUM_LINES */
+int blkcache_read(const device_t *device, size_t pos, void *buffer, size_t size) {
+  return device->ops.read(device, pos, buffer, size);
+}
+
+int blkcache_write(const device_t *device, size_t pos, const void *buffer, size_t size) {
+  return device->ops.write(device, pos, buffer, size);
+}
+
+int blkcache_sync(const device_t *device) {
+  (void)device;
+  return 0;
+}
+
+void blkcache_invalidate(const device_t *device) {
+  (void)device;
+}
+#endif /* BLKCACHE_NUM_LINES */
@@ -0,0 +1,50 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ */
+#ifndef _BLKCACHE_H_
+#define _BLKCACHE_H_
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "device.h"
+/* ================================ [ MACROS    ] ============================================== */
+/* the number of cache lines shared by all the block devices, 0 to disable the cache */
+#ifndef BLKCACHE_NUM_LINES
+#define BLKCACHE_NUM_LINES 16
+#endif
+
+/* the number of sectors of one cache line, at most 32 */
+#ifndef BLKCACHE_LINE_SECTORS
+#define BLKCACHE_LINE_SECTORS 8
+#endif
+
+/* only the devices with this sector size are cached, the others are accessed directly */
+#ifndef BLKCACHE_SECTOR_SIZE
+#define BLKCACHE_SECTOR_SIZE 512
+#endif
+
+/* the number of lines read in one device transaction on a sequential read miss */
+#ifndef BLKCACHE_READ_AHEAD
+#define BLKCACHE_READ_AHEAD 4
+#endif
+
+/* the number of block devices which could be cached at the same time */
+#ifndef BLKCACHE_MAX_DEVICES
+#define BLKCACHE_MAX_DEVICES 4
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+/* read and write in sectors as the device ops, the writes are kept in the cache until the
+ * dirty line is evicted or the device is synchronized */
+int blkcache_read(const device_t *device, size_t pos, void *buffer, size_t size);
+int blkcache_write(const device_t *device, size_t pos, const void *buffer, size_t size);
+
+/* write back all the dirty lines of the device, or of all the devices if device is NULL */
+int blkcache_sync(const device_t *device);
+
+/* drop all the lines of the device, or of all the devices if device is NULL, without write back,
+ * call blkcache_sync before if needed */
+void blkcache_invalidate(const device_t *device);
+#endif /* _BLKCACHE_H_ */
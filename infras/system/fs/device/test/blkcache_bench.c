@@ -0,0 +1,300 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * MB/s of the block device access patterns of FatFS and lwext4 on an image file backed device,
+ * directly by the device ops and through the block cache. Every device op is one pread/pwrite of
+ * the image file, so the numbers show the cost of the device transactions saved by the cache.
+ * A random read/write/sync sequence is checked against a reference copy of the image before. The
+ * transactions each access pattern may take are asserted by blkcache_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "blkcache.h"
+#include "Std_Timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_IMAGE
+#define BENCH_IMAGE "blkcache_bench.img"
+#endif
+
+#ifndef BENCH_IMAGE_SECTORS
+#define BENCH_IMAGE_SECTORS (32u * 1024u) /* 16 MB */
+#endif
+
+#ifndef BENCH_CHECK_STEPS
+#define BENCH_CHECK_STEPS 20000u
+#endif
+
+#define BENCH_SECTOR_SIZE BLKCACHE_SECTOR_SIZE
+#define BENCH_HOT_SECTORS 96u /* the FAT and the directory sectors read again and again */
+#define BENCH_MAX_SECTORS 128u
+/* ================================ [ TYPES     ] ============================================== */
+typedef int (*bench_read_t)(const device_t *device, size_t pos, void *buffer, size_t size);
+typedef int (*bench_write_t)(const device_t *device, size_t pos, const void *buffer, size_t size);
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static int bench_fd = -1;
+static uint32_t bench_transactions;
+static uint8_t bench_buffer[BENCH_MAX_SECTORS * BENCH_SECTOR_SIZE];
+static uint8_t *bench_reference;
+/* ================================ [ LOCALS    ] ============================================== */
+static int dev_img_open(const device_t *device) {
+  int ercd = 0;
+
+  if (bench_fd < 0) {
+    bench_fd = open(BENCH_IMAGE, O_RDWR | O_CREAT, 0644);
+    if ((bench_fd < 0) ||
+        (0 != ftruncate(bench_fd, (off_t)BENCH_IMAGE_SECTORS * BENCH_SECTOR_SIZE))) {
+      ercd = -1;
+    }
+  }
+
+  return ercd;
+}
+
+static int dev_img_close(const device_t *device) {
+  if (bench_fd >= 0) {
+    close(bench_fd);
+    bench_fd = -1;
+  }
+
+  return 0;
+}
+
+static int dev_img_read(const device_t *device, size_t pos, void *buffer, size_t size) {
+  ssize_t len;
+
+  bench_transactions++;
+  len = pread(bench_fd, buffer, size * BENCH_SECTOR_SIZE, (off_t)pos * BENCH_SECTOR_SIZE);
+
+  return (len == (ssize_t)(size * BENCH_SECTOR_SIZE)) ? 0 : -1;
+}
+
+static int dev_img_write(const device_t *device, size_t pos, const void *buffer, size_t size) {
+  ssize_t len;
+
+  bench_transactions++;
+  len = pwrite(bench_fd, buffer, size * BENCH_SECTOR_SIZE, (off_t)pos * BENCH_SECTOR_SIZE);
+
+  return (len == (ssize_t)(size * BENCH_SECTOR_SIZE)) ? 0 : -1;
+}
+
+static int dev_img_ctrl(const device_t *device, int cmd, void *args) {
+  int ercd = 0;
+
+  switch (cmd) {
+  case DEVICE_CTRL_GET_SECTOR_SIZE:
+    *(size_t *)args = BENCH_SECTOR_SIZE;
+    break;
+  case DEVICE_CTRL_GET_BLOCK_SIZE:
+    *(size_t *)args = 4096;
+    break;
+  case DEVICE_CTRL_GET_SECTOR_COUNT:
+    *(size_t *)args = BENCH_IMAGE_SECTORS;
+    break;
+  case DEVICE_CTRL_GET_DISK_SIZE:
+    *(size_t *)args = (size_t)BENCH_IMAGE_SECTORS * BENCH_SECTOR_SIZE;
+    break;
+  default:
+    ercd = EINVAL;
+    break;
+  }
+
+  return ercd;
+}
+
+DEVICE_REGISTER(img0, BLOCK, img, NULL);
+
+static int bench_device_read(const device_t *device, size_t pos, void *buffer, size_t size) {
+  return device->ops.read(device, pos, buffer, size);
+}
+
+static int bench_device_write(const device_t *device, size_t pos, const void *buffer,
+                              size_t size) {
+  return device->ops.write(device, pos, buffer, size);
+}
+
+static uint32_t bench_random(void) {
+  static uint32_t seed = 0x12345678u;
+
+  seed = seed * 1103515245u + 12345u;
+  return seed >> 8;
+}
+
+static int bench_check(void) {
+  int ercd = 0;
+  uint32_t step;
+  uint32_t op;
+  size_t pos, size, i;
+
+  bench_reference = malloc((size_t)BENCH_IMAGE_SECTORS * BENCH_SECTOR_SIZE);
+  if (NULL == bench_reference) {
+    ercd = -1;
+  } else {
+    for (i = 0; i < ((size_t)BENCH_IMAGE_SECTORS * BENCH_SECTOR_SIZE); i++) {
+      bench_reference[i] = (uint8_t)(i * 7u);
+    }
+    ercd = dev_img_write(&dev_img0, 0, bench_reference, BENCH_IMAGE_SECTORS);
+  }
+
+  for (step = 0; (step < BENCH_CHECK_STEPS) && (0 == ercd); step++) {
+    op = bench_random() % 16u;
+    /* most requests are small and close to each other, some are big enough to bypass the lines */
+    pos = bench_random() % 4096u;
+    size = 1u + ((op < 12u) ? (bench_random() % 12u) : (bench_random() % BENCH_MAX_SECTORS));
+    if (op < 7u) {
+      ercd = blkcache_read(&dev_img0, pos, bench_buffer, size);
+      if ((0 == ercd) && (0 != memcmp(bench_buffer, &bench_reference[pos * BENCH_SECTOR_SIZE],
+                                      size * BENCH_SECTOR_SIZE))) {
+        printf("step %u: read %u sectors at %u mismatch\n", step, (uint32_t)size, (uint32_t)pos);
+        ercd = -1;
+      }
+    } else if (op < 14u) {
+      for (i = 0; i < (size * BENCH_SECTOR_SIZE); i++) {
+        bench_buffer[i] = (uint8_t)bench_random();
+      }
+      memcpy(&bench_reference[pos * BENCH_SECTOR_SIZE], bench_buffer, size * BENCH_SECTOR_SIZE);
+      ercd = blkcache_write(&dev_img0, pos, bench_buffer, size);
+    } else if (op < 15u) {
+      ercd = blkcache_sync(&dev_img0);
+    } else {
+      ercd = blkcache_sync(&dev_img0);
+      blkcache_invalidate(&dev_img0);
+    }
+  }
+
+  if (0 == ercd) {
+    ercd = blkcache_sync(&dev_img0);
+  }
+
+  for (pos = 0; (pos < 4096u + BENCH_MAX_SECTORS) && (0 == ercd); pos += BENCH_MAX_SECTORS) {
+    ercd = dev_img_read(&dev_img0, pos, bench_buffer, BENCH_MAX_SECTORS);
+    if ((0 == ercd) && (0 != memcmp(bench_buffer, &bench_reference[pos * BENCH_SECTOR_SIZE],
+                                    sizeof(bench_buffer)))) {
+      printf("image at %u is not synchronized\n", (uint32_t)pos);
+      ercd = -1;
+    }
+  }
+
+  blkcache_invalidate(&dev_img0);
+  free(bench_reference);
+
+  printf("check   : %u random steps %s\n", BENCH_CHECK_STEPS, (0 == ercd) ? "passed" : "FAILED");
+
+  return ercd;
+}
+
+static void bench_report(const char *name, const char *mode, std_time_t elapsed, size_t bytes) {
+  printf("%-22s %-6s: %7.1f MB/s, %6u device transactions\n", name, mode,
+         (double)bytes / (double)elapsed, bench_transactions);
+}
+
+static int bench_sequential_read(const char *mode, bench_read_t rd, size_t sectors) {
+  int ercd = 0;
+  size_t pos;
+  Std_TimerType timer;
+  char name[32];
+
+  bench_transactions = 0;
+  Std_TimerStart(&timer);
+  for (pos = 0; ((pos + sectors) <= BENCH_IMAGE_SECTORS) && (0 == ercd); pos += sectors) {
+    ercd = rd(&dev_img0, pos, bench_buffer, sectors);
+  }
+  snprintf(name, sizeof(name), "sequential read %uB", (uint32_t)(sectors * BENCH_SECTOR_SIZE));
+  bench_report(name, mode, Std_GetTimerElapsedTime(&timer),
+               (size_t)BENCH_IMAGE_SECTORS * BENCH_SECTOR_SIZE);
+
+  return ercd;
+}
+
+static int bench_sequential_write(const char *mode, bench_write_t wr, size_t sectors) {
+  int ercd = 0;
+  size_t pos;
+  Std_TimerType timer;
+  char name[32];
+
+  bench_transactions = 0;
+  Std_TimerStart(&timer);
+  for (pos = 0; ((pos + sectors) <= BENCH_IMAGE_SECTORS) && (0 == ercd); pos += sectors) {
+    ercd = wr(&dev_img0, pos, bench_buffer, sectors);
+  }
+  if (0 == ercd) {
+    ercd = blkcache_sync(&dev_img0);
+  }
+  snprintf(name, sizeof(name), "sequential write %uB", (uint32_t)(sectors * BENCH_SECTOR_SIZE));
+  bench_report(name, mode, Std_GetTimerElapsedTime(&timer),
+               (size_t)BENCH_IMAGE_SECTORS * BENCH_SECTOR_SIZE);
+
+  return ercd;
+}
+
+/* the sectors of a file interleaved with the lookups of the FAT and the directory */
+static int bench_mixed_read(const char *mode, bench_read_t rd) {
+  int ercd = 0;
+  size_t pos;
+  Std_TimerType timer;
+
+  bench_transactions = 0;
+  Std_TimerStart(&timer);
+  for (pos = BENCH_HOT_SECTORS; (pos < BENCH_IMAGE_SECTORS) && (0 == ercd); pos++) {
+    ercd = rd(&dev_img0, pos, bench_buffer, 1);
+    if ((0 == ercd) && (0u == (pos % 8u))) {
+      ercd = rd(&dev_img0, bench_random() % BENCH_HOT_SECTORS, bench_buffer, 1);
+    }
+  }
+  bench_report("file and FAT read 512B", mode, Std_GetTimerElapsedTime(&timer),
+               ((size_t)BENCH_IMAGE_SECTORS - BENCH_HOT_SECTORS) * BENCH_SECTOR_SIZE * 9u / 8u);
+
+  return ercd;
+}
+
+static int bench_run(const char *mode, bench_read_t rd, bench_write_t wr) {
+  int ercd;
+
+  ercd = bench_sequential_read(mode, rd, 1);
+  if (0 == ercd) {
+    ercd = bench_sequential_read(mode, rd, 8);
+  }
+  if (0 == ercd) {
+    ercd = bench_sequential_read(mode, rd, 128);
+  }
+  if (0 == ercd) {
+    ercd = bench_mixed_read(mode, rd);
+  }
+  if (0 == ercd) {
+    ercd = bench_sequential_write(mode, wr, 1);
+  }
+  if (0 == ercd) {
+    ercd = bench_sequential_write(mode, wr, 8);
+  }
+  blkcache_invalidate(&dev_img0);
+
+  return ercd;
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  int ercd;
+
+  printf("block cache: %u lines of %u sectors, read ahead %u lines\n", BLKCACHE_NUM_LINES,
+         BLKCACHE_LINE_SECTORS, BLKCACHE_READ_AHEAD);
+
+  ercd = dev_img_open(&dev_img0);
+  if (0 == ercd) {
+    ercd = bench_check();
+  }
+  if (0 == ercd) {
+    ercd = bench_run("device", bench_device_read, bench_device_write);
+  }
+  if (0 == ercd) {
+    ercd = bench_run("cache", blkcache_read, blkcache_write);
+  }
+
+  dev_img_close(&dev_img0);
+  unlink(BENCH_IMAGE);
+
+  return (0 == ercd) ? 0 : -1;
+}
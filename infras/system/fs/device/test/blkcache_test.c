@@ -0,0 +1,342 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * The block cache on an image file backed device whose every op is one pread/pwrite of the image
+ * file, counted as one device transaction. A random read/write/sync sequence is checked against a
+ * reference copy of the image, then the block device access patterns of FatFS and lwext4 must read
+ * and write the right sectors with the device transactions saved by the lines, the read ahead and
+ * the write back.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "blkcache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_IMAGE
+#define TEST_IMAGE "blkcache.img"
+#endif
+
+#ifndef TEST_IMAGE_SECTORS
+#define TEST_IMAGE_SECTORS (32u * 1024u) /* 16 MB */
+#endif
+
+#ifndef TEST_RANDOM_STEPS
+#define TEST_RANDOM_STEPS 20000u
+#endif
+
+#define TEST_SECTOR_SIZE BLKCACHE_SECTOR_SIZE
+#define TEST_HOT_SECTORS 96u /* the FAT and the directory sectors read again and again */
+#define TEST_MAX_SECTORS 128u
+#define TEST_READ_AHEAD_SECTORS (BLKCACHE_LINE_SECTORS * BLKCACHE_READ_AHEAD)
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static int test_fd = -1;
+static uint32_t test_transactions;
+static uint8_t test_buffer[TEST_MAX_SECTORS * TEST_SECTOR_SIZE];
+static uint8_t *test_reference;
+/* ================================ [ LOCALS    ] ============================================== */
+static int dev_img_open(const device_t *device) {
+  int ercd = 0;
+
+  if (test_fd < 0) {
+    test_fd = open(TEST_IMAGE, O_RDWR | O_CREAT, 0644);
+    if ((test_fd < 0) ||
+        (0 != ftruncate(test_fd, (off_t)TEST_IMAGE_SECTORS * TEST_SECTOR_SIZE))) {
+      ercd = -1;
+    }
+  }
+
+  return ercd;
+}
+
+static int dev_img_close(const device_t *device) {
+  if (test_fd >= 0) {
+    close(test_fd);
+    test_fd = -1;
+  }
+
+  return 0;
+}
+
+static int dev_img_read(const device_t *device, size_t pos, void *buffer, size_t size) {
+  ssize_t len;
+
+  test_transactions++;
+  len = pread(test_fd, buffer, size * TEST_SECTOR_SIZE, (off_t)pos * TEST_SECTOR_SIZE);
+
+  return (len == (ssize_t)(size * TEST_SECTOR_SIZE)) ? 0 : -1;
+}
+
+static int dev_img_write(const device_t *device, size_t pos, const void *buffer, size_t size) {
+  ssize_t len;
+
+  test_transactions++;
+  len = pwrite(test_fd, buffer, size * TEST_SECTOR_SIZE, (off_t)pos * TEST_SECTOR_SIZE);
+
+  return (len == (ssize_t)(size * TEST_SECTOR_SIZE)) ? 0 : -1;
+}
+
+static int dev_img_ctrl(const device_t *device, int cmd, void *args) {
+  int ercd = 0;
+
+  switch (cmd) {
+  case DEVICE_CTRL_GET_SECTOR_SIZE:
+    *(size_t *)args = TEST_SECTOR_SIZE;
+    break;
+  case DEVICE_CTRL_GET_BLOCK_SIZE:
+    *(size_t *)args = 4096;
+    break;
+  case DEVICE_CTRL_GET_SECTOR_COUNT:
+    *(size_t *)args = TEST_IMAGE_SECTORS;
+    break;
+  case DEVICE_CTRL_GET_DISK_SIZE:
+    *(size_t *)args = (size_t)TEST_IMAGE_SECTORS * TEST_SECTOR_SIZE;
+    break;
+  default:
+    ercd = EINVAL;
+    break;
+  }
+
+  return ercd;
+}
+
+DEVICE_REGISTER(img0, BLOCK, img, NULL);
+
+/* the content of each sector is given by its position and a salt */
+static void test_fill(size_t pos, size_t size, uint8_t salt) {
+  size_t i;
+
+  for (i = 0; i < (size * TEST_SECTOR_SIZE); i++) {
+    test_buffer[i] = (uint8_t)((pos + i / TEST_SECTOR_SIZE) * 7u + i + salt);
+  }
+}
+
+static bool test_is_filled(size_t pos, size_t size, uint8_t salt) {
+  size_t i;
+  bool r = true;
+
+  for (i = 0; (i < (size * TEST_SECTOR_SIZE)) && r; i++) {
+    r = (test_buffer[i] == (uint8_t)((pos + i / TEST_SECTOR_SIZE) * 7u + i + salt));
+  }
+
+  return r;
+}
+
+/* write the whole image directly by the device, bypassing the cache */
+static int test_format(uint8_t salt) {
+  int ercd = 0;
+  size_t pos;
+
+  blkcache_invalidate(&dev_img0);
+  for (pos = 0; (pos < TEST_IMAGE_SECTORS) && (0 == ercd); pos += TEST_MAX_SECTORS) {
+    test_fill(pos, TEST_MAX_SECTORS, salt);
+    ercd = dev_img_write(&dev_img0, pos, test_buffer, TEST_MAX_SECTORS);
+  }
+
+  return ercd;
+}
+
+/* read the whole image directly by the device, bypassing the cache */
+static bool test_image_is_filled(uint8_t salt) {
+  size_t pos;
+  bool r = true;
+
+  for (pos = 0; (pos < TEST_IMAGE_SECTORS) && r; pos += TEST_MAX_SECTORS) {
+    r = (0 == dev_img_read(&dev_img0, pos, test_buffer, TEST_MAX_SECTORS)) &&
+        test_is_filled(pos, TEST_MAX_SECTORS, salt);
+  }
+
+  return r;
+}
+
+static void Test_Random(void) {
+  int ercd = 0;
+  uint32_t step;
+  uint32_t op = 0;
+  size_t pos = 0, size = 0, i;
+  bool bPass;
+
+  printf("Test %u random reads, writes and syncs against a reference image:", TEST_RANDOM_STEPS);
+  test_reference = malloc((size_t)TEST_IMAGE_SECTORS * TEST_SECTOR_SIZE);
+  if (NULL == test_reference) {
+    ercd = -1;
+  } else {
+    for (i = 0; i < ((size_t)TEST_IMAGE_SECTORS * TEST_SECTOR_SIZE); i++) {
+      test_reference[i] = (uint8_t)(i * 7u);
+    }
+    ercd = dev_img_write(&dev_img0, 0, test_reference, TEST_IMAGE_SECTORS);
+  }
+
+  for (step = 0; (step < TEST_RANDOM_STEPS) && (0 == ercd); step++) {
+    op = (uint32_t)rand() % 16u;
+    /* most requests are small and close to each other, some are big enough to bypass the lines */
+    pos = (size_t)rand() % 4096u;
+    size = 1u + ((op < 12u) ? ((size_t)rand() % 12u) : ((size_t)rand() % TEST_MAX_SECTORS));
+    if (op < 7u) {
+      ercd = blkcache_read(&dev_img0, pos, test_buffer, size);
+      if ((0 == ercd) && (0 != memcmp(test_buffer, &test_reference[pos * TEST_SECTOR_SIZE],
+                                      size * TEST_SECTOR_SIZE))) {
+        ercd = -2;
+      }
+    } else if (op < 14u) {
+      for (i = 0; i < (size * TEST_SECTOR_SIZE); i++) {
+        test_buffer[i] = (uint8_t)rand();
+      }
+      memcpy(&test_reference[pos * TEST_SECTOR_SIZE], test_buffer, size * TEST_SECTOR_SIZE);
+      ercd = blkcache_write(&dev_img0, pos, test_buffer, size);
+    } else if (op < 15u) {
+      ercd = blkcache_sync(&dev_img0);
+    } else {
+      ercd = blkcache_sync(&dev_img0);
+      blkcache_invalidate(&dev_img0);
+    }
+  }
+
+  if (0 == ercd) {
+    ercd = blkcache_sync(&dev_img0);
+  }
+
+  /* the image is synchronized */
+  for (i = 0; (i < 4096u + TEST_MAX_SECTORS) && (0 == ercd); i += TEST_MAX_SECTORS) {
+    ercd = dev_img_read(&dev_img0, i, test_buffer, TEST_MAX_SECTORS);
+    if ((0 == ercd) && (0 != memcmp(test_buffer, &test_reference[i * TEST_SECTOR_SIZE],
+                                    sizeof(test_buffer)))) {
+      ercd = -3;
+    }
+  }
+
+  blkcache_invalidate(&dev_img0);
+  free(test_reference);
+
+  bPass = (0 == ercd);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  error %d at step %u: op %u of %u sectors at %u\n", ercd, step, op, (uint32_t)size,
+           (uint32_t)pos);
+    exit(-1);
+  }
+}
+
+static void Test_SequentialRead(size_t sectors) {
+  /* the small reads are served by the lines read ahead, the big ones go to the device directly */
+  size_t span = (sectors > TEST_READ_AHEAD_SECTORS) ? sectors : TEST_READ_AHEAD_SECTORS;
+  uint32_t maxTransactions = (uint32_t)(TEST_IMAGE_SECTORS / span) + 1u;
+  int ercd;
+  size_t pos;
+  bool bPass;
+
+  printf("Test sequential read of %u bytes:", (uint32_t)(sectors * TEST_SECTOR_SIZE));
+  ercd = test_format(0x11);
+  test_transactions = 0;
+  for (pos = 0; ((pos + sectors) <= TEST_IMAGE_SECTORS) && (0 == ercd); pos += sectors) {
+    ercd = blkcache_read(&dev_img0, pos, test_buffer, sectors);
+    if ((0 == ercd) && (false == test_is_filled(pos, sectors, 0x11))) {
+      ercd = -2;
+    }
+  }
+
+  bPass = (0 == ercd) && (test_transactions <= maxTransactions);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  error %d at sector %u, %u device transactions, expected at most %u\n", ercd,
+           (uint32_t)pos, test_transactions, maxTransactions);
+    exit(-1);
+  }
+}
+
+/* the sectors of a file interleaved with the lookups of the FAT and the directory */
+static void Test_MixedRead(void) {
+  uint32_t reads = 0;
+  int ercd;
+  size_t pos, hot = 0;
+  bool bPass;
+
+  printf("Test file sectors read with FAT lookups:");
+  ercd = test_format(0x22);
+  test_transactions = 0;
+  for (pos = TEST_HOT_SECTORS; (pos < TEST_IMAGE_SECTORS) && (0 == ercd); pos++) {
+    ercd = blkcache_read(&dev_img0, pos, test_buffer, 1);
+    if ((0 == ercd) && (false == test_is_filled(pos, 1, 0x22))) {
+      ercd = -2;
+    }
+    reads++;
+    if ((0 == ercd) && (0u == (pos % 8u))) {
+      hot = (size_t)rand() % TEST_HOT_SECTORS;
+      ercd = blkcache_read(&dev_img0, hot, test_buffer, 1);
+      if ((0 == ercd) && (false == test_is_filled(hot, 1, 0x22))) {
+        ercd = -3;
+      }
+      reads++;
+    }
+  }
+
+  /* the hot sectors stay in the lines between the read ahead of the file */
+  bPass = (0 == ercd) && (test_transactions <= (reads / 4u));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  error %d at sector %u/%u, %u device transactions for %u reads\n", ercd,
+           (uint32_t)pos, (uint32_t)hot, test_transactions, reads);
+    exit(-1);
+  }
+}
+
+static void Test_SequentialWrite(size_t sectors) {
+  /* the writes are merged in the lines and written back once per line */
+  uint32_t maxTransactions = TEST_IMAGE_SECTORS / BLKCACHE_LINE_SECTORS;
+  uint8_t salt = (uint8_t)(0x30u + sectors);
+  uint32_t transactions;
+  int ercd;
+  size_t pos;
+  bool bPass;
+
+  printf("Test sequential write of %u bytes:", (uint32_t)(sectors * TEST_SECTOR_SIZE));
+  ercd = test_format(0x33);
+  test_transactions = 0;
+  for (pos = 0; ((pos + sectors) <= TEST_IMAGE_SECTORS) && (0 == ercd); pos += sectors) {
+    test_fill(pos, sectors, salt);
+    ercd = blkcache_write(&dev_img0, pos, test_buffer, sectors);
+  }
+  if (0 == ercd) {
+    ercd = blkcache_sync(&dev_img0);
+  }
+  transactions = test_transactions;
+
+  bPass = (0 == ercd) && (transactions <= maxTransactions) && test_image_is_filled(salt);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  error %d, %u device transactions, expected at most %u\n", ercd, transactions,
+           maxTransactions);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  srand(1);
+  printf("block cache: %u lines of %u sectors, read ahead %u lines\n", BLKCACHE_NUM_LINES,
+         BLKCACHE_LINE_SECTORS, BLKCACHE_READ_AHEAD);
+
+  if (0 != dev_img_open(&dev_img0)) {
+    printf("failed to open %s\n", TEST_IMAGE);
+    return -1;
+  }
+
+  Test_Random();
+  Test_SequentialRead(1);
+  Test_SequentialRead(8);
+  Test_SequentialRead(TEST_MAX_SECTORS);
+  Test_MixedRead();
+  Test_SequentialWrite(1);
+  Test_SequentialWrite(8);
+
+  blkcache_invalidate(&dev_img0);
+  dev_img_close(&dev_img0);
+  unlink(TEST_IMAGE);
+
+  return 0;
+}
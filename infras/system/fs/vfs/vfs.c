@@ -4,6 +4,7 @@
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "vfs.h"
+#include "blkcache.h"
 #include <string.h>
 #include "heap.h"
 #include <stdarg.h>
@@ -519,6 +520,22 @@ static int mountFunc(int argc, const char *argv[]) {
 }
 SHELL_REGISTER(mount, "mount device format dir\n", mountFunc);
 
+static int umountFunc(int argc, const char *argv[]) {
+  int r = -1;
+
+  if (2 == argc) {
+    r = vfs_umount(argv[1]);
+  }
+
+  return r;
+}
+SHELL_REGISTER(umount, "umount dir\n", umountFunc);
+
+static int syncFunc(int argc, const char *argv[]) {
+  return blkcache_sync(NULL);
+}
+SHELL_REGISTER(sync, "sync - write back the block cache of all devices\n", syncFunc);
+
 static int mkfsFunc(int argc, const char *argv[]) {
   int r = 0;
   const struct vfs_filesystem_ops **o;
@@ -572,6 +589,9 @@ VFS_FILE *vfs_fopen(const char *filename, const char *opentype) {
     mnt = search_mnt(abspath);
     if (NULL != mnt) {
       file = mnt->ops->fopen(mnt, abspath, opentype);
+      if (NULL != file) {
+        file->device = mnt->device;
+      }
     }
     heap_free(abspath);
   }
@@ -596,7 +616,14 @@ int vfs_fwrite(const void *data, size_t size, size_t count, VFS_FILE *stream) {
 ELF_EXPORT_ALIAS(vfs_fwrite, "fwrite");
 
 int vfs_fflush(VFS_FILE *stream) {
-  return stream->fops->fflush(stream);
+  int ercd;
+
+  ercd = stream->fops->fflush(stream);
+  if ((0 == ercd) && (NULL != stream->device)) {
+    ercd = blkcache_sync(stream->device);
+  }
+
+  return ercd;
 }
 ELF_EXPORT_ALIAS(vfs_fflush, "fflush");
 
@@ -911,11 +938,48 @@ int vfs_mkfs(const device_t *device, const char *type) {
     ercd = EINVAL;
   } else {
     ercd = ops->mkfs(device);
+    if (0 == ercd) {
+      ercd = blkcache_sync(device);
+    }
   }
 
   return ercd;
 }
 
+int vfs_umount(const char *mount_point) {
+  int ercd = ENOENT;
+  vfs_mount_t *m;
+
+  VFS_LOCK();
+  TAILQ_FOREACH(m, &vfs_mount_list, entry) {
+    if (0 == strcmp(m->mount_point, mount_point)) {
+      ercd = 0;
+      break;
+    }
+  }
+  VFS_UNLOCK();
+
+  if (0 == ercd) {
+    ercd = m->ops->umount(m->device, m->mount_point);
+  }
+
+  if (0 == ercd) {
+    VFS_LOCK();
+    TAILQ_REMOVE(&vfs_mount_list, m, entry);
+    VFS_UNLOCK();
+    /* the filesystem has written back its metadata to the block cache on umount */
+    ercd = blkcache_sync(m->device);
+    if (0 == ercd) {
+      blkcache_invalidate(m->device);
+    }
+    heap_free(m);
+  }
+
+  ASLOG(VFS, ("umount %s %s\n", mount_point, (0 == ercd) ? "okay" : "failed"));
+
+  return ercd;
+}
+
 #if !defined(_WIN32) && !defined(linux) && defined(__GNUC__)
 FILE *fopen(const char *filename, const char *opentype) __attribute__((weak, alias("vfs_fopen")));
 int fclose(FILE *stream) __attribute__((weak, alias("vfs_fclose")));
@@ -50,6 +50,7 @@ typedef struct {
 
 typedef struct {
   const struct vfs_filesystem_ops *fops;
+  const device_t *device; /* set by vfs_fopen, the block device to sync on vfs_fflush */
   void *priv;
 } VFS_FILE;
 
@@ -89,6 +90,7 @@ struct vfs_filesystem_ops {
   int (*rename)(const vfs_mount_t *mnt, const char *oldname, const char *newname);
 
   int (*mount)(const device_t *device, const char *mount_point);
+  int (*umount)(const device_t *device, const char *mount_point);
   int (*mkfs)(const device_t *device);
 };
 /* ================================ [ DATAS     ] ============================================== */
@@ -122,5 +124,6 @@ int vfs_fprintf(VFS_FILE *fp, const char *fmt, ...);
 
 void vfs_init(void);
 int vfs_mount(const device_t *device, const char *type, const char *mount_point);
+int vfs_umount(const char *mount_point);
 int vfs_mkfs(const device_t *device, const char *type);
 #endif /* _VFS_H */
@@ -7,6 +7,7 @@
 #include "ff.h"
 #include "diskio.h"
 #include "vfs.h"
+#include "blkcache.h"
 #include <string.h>
 #include "heap.h"
 #include "Std_Debug.h"
@@ -457,6 +458,24 @@ static int fatfs_mount(const device_t *device, const char *mount_point) {
   return ercd;
 }
 
+static int fatfs_umount(const device_t *device, const char *mount_point) {
+  int ercd;
+  int index;
+  char mp[3] = "0:";
+
+  index = get_dev_index(device);
+
+  if (index < FF_VOLUMES) {
+    mp[0] += index;
+    ercd = f_mount(NULL, mp, 0);
+    fatfs_device_table[index] = NULL;
+  } else {
+    ercd = -1;
+  }
+
+  return ercd;
+}
+
 static int fatfs_mkfs(const device_t *device) {
   int ercd;
   int index;
@@ -503,6 +522,7 @@ const struct vfs_filesystem_ops fatfs_ops = {
   /*.rmdir =*/fatfs_rmdir,
   /*.rename =*/fatfs_rename,
   /*.mount =*/fatfs_mount,
+  /*.umount =*/fatfs_umount,
   /*.mkfs =*/fatfs_mkfs};
 
 DSTATUS disk_status(BYTE pdrv /* Physical drive nmuber to identify the drive */
@@ -547,7 +567,7 @@ DRESULT disk_read(BYTE pdrv,    /* Physical drive nmuber to identify the drive *
   if (pdrv < FF_VOLUMES) {
     device = fatfs_device_table[pdrv];
     if ((device != NULL) && (device->ops.read != NULL)) {
-      res = (DRESULT)device->ops.read(device, sector, buff, count);
+      res = (0 == blkcache_read(device, sector, buff, count)) ? RES_OK : RES_ERROR;
     }
   }
 
@@ -566,7 +586,7 @@ DRESULT disk_write(BYTE pdrv,        /* Physical drive nmuber to identify the dr
   if (pdrv < FF_VOLUMES) {
     device = fatfs_device_table[pdrv];
     if ((device != NULL) && (device->ops.write != NULL)) {
-      res = (DRESULT)device->ops.write(device, sector, buff, count);
+      res = (0 == blkcache_write(device, sector, buff, count)) ? RES_OK : RES_ERROR;
     }
   }
 
@@ -587,7 +607,7 @@ DRESULT disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
     if ((device != NULL) && (device->ops.ctrl != NULL)) {
       switch (cmd) {
       case CTRL_SYNC:
-        res = RES_OK;
+        res = (0 == blkcache_sync(device)) ? RES_OK : RES_ERROR;
         break;
 
       case GET_SECTOR_COUNT: {
@@ -245,6 +245,12 @@ static int host_mount(const device_t *device, const char *mount_point) {
   return 0;
 }
 
+static int host_umount(const device_t *device, const char *mount_point) {
+  (void)device;
+  (void)mount_point;
+  return 0;
+}
+
 static int host_mkfs(const device_t *device) {
   (void)device;
   return 0;
@@ -279,5 +285,6 @@ const struct vfs_filesystem_ops hofs_ops = {.name = "host",
                                             .rmdir = host_rmdir,
                                             .rename = host_rename,
                                             .mount = host_mount,
+                                            .umount = host_umount,
                                             .mkfs = host_mkfs};
 #endif
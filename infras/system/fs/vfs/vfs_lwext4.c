@@ -5,6 +5,7 @@
 #ifdef USE_LWEXT4
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "vfs.h"
+#include "blkcache.h"
 #include "ext4.h"
 #include "ext4_mkfs.h"
 #include "Std_Debug.h"
@@ -129,8 +130,8 @@ static int lwext_fwrite(const void *data, size_t size, size_t count, VFS_FILE *s
 
 static int lwext_fflush(VFS_FILE *stream) {
   (void)stream;
-
-  return ENOTSUP;
+  /* ext4_fwrite has passed the data to the block device, vfs_fflush syncs the block cache */
+  return 0;
 }
 
 static int lwext_fseek(VFS_FILE *stream, long int offset, int whence) {
@@ -344,6 +345,29 @@ static int lwext_mount(const device_t *device, const char *mount_point) {
   return ercd;
 }
 
+static int lwext_umount(const device_t *device, const char *mount_point) {
+  int ercd;
+  int index;
+
+  for (index = 0; index < CONFIG_EXT4_BLOCKDEVS_COUNT; index++) {
+    if (lwext_device_table[index] == device) {
+      break;
+    }
+  }
+
+  if (index < CONFIG_EXT4_BLOCKDEVS_COUNT) {
+    ercd = ext4_umount(mount_point);
+    if (0 == ercd) {
+      (void)ext4_device_unregister(device->name);
+      lwext_device_table[index] = NULL;
+    }
+  } else {
+    ercd = -1;
+  }
+
+  return ercd;
+}
+
 static int lwext_mkfs(const device_t *device) {
   int ercd = 0;
   int index;
@@ -428,8 +452,11 @@ static int blockdev_bread(struct ext4_blockdev *bdev, void *buf, uint64_t blk_id
   if (index >= 0) {
     device = lwext_device_table[index];
     if ((device != NULL) && (device->ops.read != NULL)) {
-      ret = device->ops.read(device, blk_id * (bdev->bdif->ph_bsize / disk_sector_size[index]), buf,
-                             blk_cnt * (bdev->bdif->ph_bsize / disk_sector_size[index]));
+      ret = blkcache_read(device, blk_id * (bdev->bdif->ph_bsize / disk_sector_size[index]), buf,
+                          blk_cnt * (bdev->bdif->ph_bsize / disk_sector_size[index]));
+      if (0 != ret) {
+        ret = EIO;
+      }
     }
   }
 
@@ -447,8 +474,11 @@ static int blockdev_bwrite(struct ext4_blockdev *bdev, const void *buf, uint64_t
   if (index >= 0) {
     device = lwext_device_table[index];
     if ((device != NULL) && (device->ops.write != NULL)) {
-      ret = device->ops.write(device, blk_id * (bdev->bdif->ph_bsize / disk_sector_size[index]),
-                              buf, blk_cnt * (bdev->bdif->ph_bsize / disk_sector_size[index]));
+      ret = blkcache_write(device, blk_id * (bdev->bdif->ph_bsize / disk_sector_size[index]), buf,
+                           blk_cnt * (bdev->bdif->ph_bsize / disk_sector_size[index]));
+      if (0 != ret) {
+        ret = EIO;
+      }
     }
   }
 
@@ -485,5 +515,6 @@ const struct vfs_filesystem_ops lwext_ops = {.name = "ext",
                                              .rmdir = lwext_rmdir,
                                              .rename = lwext_rename,
                                              .mount = lwext_mount,
+                                             .umount = lwext_umount,
                                              .mkfs = lwext_mkfs};
 #endif
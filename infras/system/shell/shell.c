@@ -218,6 +218,7 @@ void Shell_Input(char ch) {
   if (ch == '\r') {
     /* ignore */
   } else {
+    /* the stdin thread and the CAN/CanTp shell all produce */
     EnterCritical();
 #ifdef RB_PUSH_FAST
     r = RB_PushChar(&rb_shin, &ch);
@@ -235,9 +236,14 @@ void Shell_MainFunction(void) {
   rb_size_t r;
   char ch;
 
+  /* the only consumer of the lock free ring */
+#ifndef RB_LOCK_FREE
   EnterCritical();
+#endif
   r = RB_POP(shin, &ch, 1);
+#ifndef RB_LOCK_FREE
   ExitCritical();
+#endif
   if (1 == r) {
     if (lCmdPos >= SHELL_CMDLINE_MAX) {
       lCmdPos = 0;
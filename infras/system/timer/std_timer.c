@@ -29,9 +29,13 @@
 
 #define STD_TIMER_SET_MAX (STD_TIME_MAX / 2)
 
-#if defined(_WIN32) || defined(linux)
+#if (defined(_WIN32) || defined(linux)) && !defined(USE_STBM)
 #define USE_STBM_DFT
 #endif
+
+#if defined(linux) && !defined(CLOCK_MONOTONIC_RAW)
+#define CLOCK_MONOTONIC_RAW CLOCK_MONOTONIC
+#endif
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
@@ -40,6 +44,20 @@ static std_time_t lTimeBase0 = 0;
 static std_time_t lGTP = 0;
 #endif
 /* ================================ [ LOCALS    ] ============================================== */
+#ifdef USE_STBM_DFT
+/* the wall clock time in us, the Std_GetTime is monotonic and starts from an arbitrary point */
+static std_time_t Std_GetRealTime(void) {
+#if defined(_MSC_VER)
+  return Std_GetTime();
+#else
+  struct timeval now;
+
+  (void)gettimeofday(&now, NULL);
+  return (std_time_t)now.tv_sec * 1000000 + now.tv_usec;
+#endif
+}
+#endif
+
 #if defined(_WIN32)
 static void __std_timer_deinit(void) {
   TIMECAPS xTimeCaps;
@@ -78,6 +96,17 @@ std_time_t Std_GetTime(void) {
   tm = tm * 1000;
   return tm;
 }
+#elif defined(linux)
+std_time_t Std_GetTime(void) {
+  struct timespec now;
+  std_time_t tm;
+
+  /* monotonic, so that the timers are not disturbed when the wall clock is set */
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  tm = (std_time_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+  return tm;
+}
 #else
 std_time_t Std_GetTime(void) {
   struct timeval now;
@@ -89,6 +118,34 @@ std_time_t Std_GetTime(void) {
   return tm;
 }
 #endif
+
+#if defined(_WIN32)
+uint64_t Std_GetTimeNs(void) {
+  static LARGE_INTEGER frequency = {0};
+  LARGE_INTEGER counter;
+
+  if (0 == frequency.QuadPart) {
+    (void)QueryPerformanceFrequency(&frequency);
+  }
+  (void)QueryPerformanceCounter(&counter);
+
+  return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000u +
+         (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000u / frequency.QuadPart;
+}
+#else
+uint64_t Std_GetTimeNs(void) {
+  struct timespec now;
+
+  /* the raw hardware clock, which is never slewed by NTP */
+  (void)clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+#endif
+#else
+uint64_t Std_GetTimeNs(void) {
+  return (uint64_t)Std_GetTime() * 1000u;
+}
 #endif
 #endif
 
@@ -129,6 +186,26 @@ Std_ReturnType StbM_BusSetGlobalTime(StbM_SynchronizedTimeBaseType timeBaseId,
   return ret;
 }
 
+Std_ReturnType StbM_BusGetCurrentTime(StbM_SynchronizedTimeBaseType timeBaseId,
+                                      StbM_TimeStampType *globalTimePtr,
+                                      StbM_VirtualLocalTimeType *localTimePtr,
+                                      StbM_UserDataType *userData) {
+  Std_ReturnType ret;
+  uint64_t tm;
+
+  /* the simulated global time is the virtual local time */
+  ret = StbM_GetCurrentVirtualLocalTime(timeBaseId, localTimePtr);
+  if (E_OK == ret) {
+    tm = ((uint64_t)localTimePtr->nanosecondsHi << 32) + localTimePtr->nanosecondsLo;
+    globalTimePtr->secondsHi = (uint32_t)((tm / 1000000000u) >> 32);
+    globalTimePtr->seconds = (uint32_t)((tm / 1000000000u) & 0xFFFFFFFFul);
+    globalTimePtr->nanoseconds = (uint32_t)(tm % 1000000000u);
+    globalTimePtr->timeBaseStatus = STBM_STATUS_GLOBAL_TIME_BASE;
+  }
+
+  return ret;
+}
+
 uint8_t StbM_GetTimeBaseUpdateCounter(StbM_SynchronizedTimeBaseType timeBaseId) {
   return 0;
 }
@@ -138,7 +215,7 @@ Std_ReturnType StbM_GetCurrentTime(StbM_SynchronizedTimeBaseType timeBaseId,
   Std_ReturnType ret = E_OK;
   std_time_t tm;
   if (0 == timeBaseId) {
-    tm = Std_GetTime();
+    tm = Std_GetRealTime();
     timeTuple->globalTime.secondsHi = (tm / 1000000) >> 32;
     timeTuple->globalTime.seconds = (tm / 1000000) & 0xFFFFFFFFul;
     timeTuple->globalTime.nanoseconds = (tm % 1000000) * 1000;
@@ -22,21 +22,10 @@ namespace as {
 /* ================================ [ TYPES     ] ============================================== */
 typedef Std_ReturnType (*E2E_ExecuteFncType)(E2E_ProfileIdType profileId, uint8_t *data,
                                              uint16_t length);
-typedef enum {
-  E2E_PROTECT_P11,
-  E2E_CHECK_P11,
-  E2E_PROTECT_P22,
-  E2E_CHECK_P22,
-  E2E_PROTECT_P44,
-  E2E_CHECK_P44,
-  E2E_PROTECT_P05,
-  E2E_CHECK_P05,
-  E2E_TYPE_MAX,
-} E2EType_e;
-
 class E2EExecutor {
 public:
-  E2EExecutor(E2E_ProfileIdType profileId, E2E_ExecuteFncType fnc, bool bProtect, E2EType_e type)
+  E2EExecutor(E2E_ProfileIdType profileId, E2E_ExecuteFncType fnc, bool bProtect,
+              E2E_OperationType type)
     : m_ExecuteFnc(fnc), m_ProfileId(profileId), m_bProtect(bProtect), m_Type(type) {
   }
 
@@ -46,6 +35,20 @@ public:
     bool rv = false;
     Std_ReturnType ret;
     ret = m_ExecuteFnc(m_ProfileId, data, length);
+    rv = IsOK(ret);
+    return rv;
+  }
+
+  void Prepare(E2E_BatchItemType &item, uint8_t *data, uint16_t length) {
+    item.data = data;
+    item.length = length;
+    item.profileId = m_ProfileId;
+    item.operation = m_Type;
+    item.result = E_NOT_OK;
+  }
+
+  bool IsOK(Std_ReturnType ret) {
+    bool rv = false;
     if (m_bProtect) {
       rv = (E_OK == ret);
     } else {
@@ -58,12 +61,12 @@ private:
   E2E_ExecuteFncType m_ExecuteFnc;
   E2E_ProfileIdType m_ProfileId;
   bool m_bProtect;
-  E2EType_e m_Type;
+  E2E_OperationType m_Type;
 };
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
-static std::queue<E2E_ProfileIdType> E2E_RecycleQueue[E2E_TYPE_MAX];
+static std::queue<E2E_ProfileIdType> E2E_RecycleQueue[E2E_OPERATION_MAX];
 static std::vector<E2E_ProtectProfile11ContextType> E2E_ProtectP11_Contexts;
 static std::vector<E2E_ProtectProfile11ConfigType> E2E_ProtectProfile11Configs;
 static std::vector<E2E_CheckProfile11ContextType> E2E_CheckP11_Contexts;
@@ -118,6 +121,7 @@ static E2EExecutor *E2E_CFGAddProtectP11(json &js) {
 
   E2E_Config.ProtectP11Configs = E2E_ProtectProfile11Configs.data();
   E2E_ProtectP11_Contexts[profileId].Counter = 0;
+  E2E_ProtectP11_Contexts[profileId].Seed.bValid = FALSE;
   config = &E2E_ProtectProfile11Configs[profileId];
   config->context = &E2E_ProtectP11_Contexts[profileId];
   config->P11.DataID = js["DataID"].get<uint16_t>();
@@ -163,6 +167,7 @@ static E2EExecutor *E2E_CFGAddCheckP11(json &js) {
   }
   E2E_Config.CheckP11Configs = E2E_CheckProfile11Configs.data();
   E2E_CheckP11_Contexts[profileId].Counter = 0;
+  E2E_CheckP11_Contexts[profileId].Seed.bValid = FALSE;
   config = &E2E_CheckProfile11Configs[profileId];
   config->context = &E2E_CheckP11_Contexts[profileId];
   config->P11.DataID = js["DataID"].get<uint16_t>();
@@ -429,6 +434,20 @@ bool E2E_Execute(E2EExecutor *e2e, uint8_t *data, uint16_t length) {
   return e2e->Execute(data, length);
 }
 
+std::vector<bool> E2E_ExecuteBatch(std::vector<E2EExecutor *> &e2es, std::vector<uint8_t *> &datas,
+                                   std::vector<uint16_t> &lengths) {
+  std::vector<E2E_BatchItemType> items(e2es.size());
+  std::vector<bool> oks(e2es.size());
+  for (size_t i = 0; i < e2es.size(); i++) {
+    e2es[i]->Prepare(items[i], datas[i], lengths[i]);
+  }
+  (void)E2E_ExecuteBatch(items.data(), (uint16_t)items.size());
+  for (size_t i = 0; i < e2es.size(); i++) {
+    oks[i] = e2es[i]->IsOK(items[i].result);
+  }
+  return oks;
+}
+
 E2EExecutor::~E2EExecutor() {
   std::unique_lock<std::mutex> lck(m_E2ELock);
   E2E_RecycleQueue[m_Type].push(m_ProfileId);
@@ -198,7 +198,8 @@ public:
   static void callbackToLua(std::string api);
 
 private:
-  void transmit(std::shared_ptr<Message> msg);
+  void transmit(std::vector<std::shared_ptr<Message>> &msgs);
+  void transmit(std::shared_ptr<Message> msg, bool r);
   void receive(std::shared_ptr<Message> msg);
 
 private:
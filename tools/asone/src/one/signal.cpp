@@ -25,6 +25,9 @@ template <typename T> T get(json &obj, std::string key, T dft) {
 extern E2EExecutor *E2E_New(json &js, bool bProtect);
 extern void E2E_Free(E2EExecutor *e2e);
 extern bool E2E_Execute(E2EExecutor *e2e, uint8_t *data, uint16_t length);
+extern std::vector<bool> E2E_ExecuteBatch(std::vector<E2EExecutor *> &e2es,
+                                          std::vector<uint8_t *> &datas,
+                                          std::vector<uint16_t> &lengths);
 
 static int figure_create(lua_State *L);
 static int figure_add_point(lua_State *L);
@@ -760,16 +763,22 @@ void Network::schedule(void) {
 
 void Network::run(void) {
   LOG(INFO, "network %s online: %s:%d:%d\n", m_Name.c_str(), m_Device.c_str(), m_Port, m_Baudrate);
+  std::vector<std::shared_ptr<Message>> txMsgs;
+  txMsgs.reserve(m_Messages.size());
   while (false == m_Stop) {
     for (auto msg : m_Messages) {
       msg->run();
       auto state = msg->state();
       if (Message::State::TRANSMIT == state) {
-        transmit(msg);
+        txMsgs.push_back(msg);
       } else if (Message::State::RECEIVE == state) {
         receive(msg);
       }
     }
+    if (false == txMsgs.empty()) {
+      transmit(txMsgs);
+      txMsgs.clear();
+    }
     Network::runLua();
     std::unique_lock<std::mutex> lck(m_Lock);
     m_CondVar.wait_for(lck, std::chrono::milliseconds(1));
@@ -799,14 +808,41 @@ bool Network::stop(void) {
   return true;
 }
 
-void Network::transmit(std::shared_ptr<Message> msg) {
-  bool r = true;
-  auto &lock = msg->getLock();
-  std::unique_lock<std::recursive_mutex> lck(lock);
-  msg->backward();
-  if (nullptr != msg->E2E()) {
-    r = E2E_Execute(msg->E2E(), msg->data(), (uint16_t)msg->dlc());
+/* protect all the messages due in this tick with one E2E batch, the messages stay locked until
+ * written so that the protected payload can't be changed in between */
+void Network::transmit(std::vector<std::shared_ptr<Message>> &msgs) {
+  std::vector<std::unique_lock<std::recursive_mutex>> locks;
+  std::vector<E2EExecutor *> e2es;
+  std::vector<uint8_t *> datas;
+  std::vector<uint16_t> lengths;
+  std::vector<bool> oks;
+  locks.reserve(msgs.size());
+  for (auto &msg : msgs) {
+    locks.emplace_back(msg->getLock());
+    msg->backward();
+    if (nullptr != msg->E2E()) {
+      e2es.push_back(msg->E2E());
+      datas.push_back(msg->data());
+      lengths.push_back((uint16_t)msg->dlc());
+    }
+  }
+
+  if (false == e2es.empty()) {
+    oks = E2E_ExecuteBatch(e2es, datas, lengths);
   }
+
+  size_t idx = 0;
+  for (auto &msg : msgs) {
+    bool r = true;
+    if (nullptr != msg->E2E()) {
+      r = oks[idx];
+      idx++;
+    }
+    transmit(msg, r);
+  }
+}
+
+void Network::transmit(std::shared_ptr<Message> msg, bool r) {
   if (true == r) {
     if (Type::CAN == m_Type) {
       r = can_write(m_Fd, msg->id(), (uint8_t)msg->dlc(), msg->data());
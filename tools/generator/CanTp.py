@@ -30,6 +30,8 @@ def Gen_CanTp(cfg, dir):
         H.write("#define PDUR_%s_LINTP_ZERO_COST\n\n" % (cfg["zero_cost"].upper()))
     H.write("/* #define CANTP_USE_STD_TIMER */\n\n")
     H.write("#define CANTP_STMIN_ADJUST %su\n" % (cfg.get("STMinAdjust", 0)))
+    H.write("#define CANTP_CF_BURST_MAX %su\n" % (cfg.get("CFBurstMax", 1)))
+    H.write("#define CANTP_RX_CACHE_SIZE %su\n" % (cfg.get("RxCacheSize", 0)))
     H.write("#ifndef CANTP_MAIN_FUNCTION_PERIOD\n")
     H.write("#define CANTP_MAIN_FUNCTION_PERIOD %su\n" % (cfg.get("MainFunctionPeriod", 10)))
     H.write("#endif\n")
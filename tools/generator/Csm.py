@@ -87,6 +87,7 @@ def GenMacGenPrimitive(C, Family, Mode, BitLen):
     C.write("  Csm_MacGenerateUpdate_%s,\n" % (ApiName))
     C.write("  Csm_MacGenerateFinish_%s,\n" % (ApiName))
     C.write("  Csm_MacGenerateDeinit_%s,\n" % (ApiName))
+    C.write("  NULL,\n")
     C.write("};\n\n")
 
 
@@ -135,10 +136,22 @@ def Gen_Csm(cfg, dir):
         BitLen = len(mg["Key"]) * 8
         ks = "_".join([Family, Mode, str(BitLen)])
         if ks not in MGL:
+            MGL.append(ks)
+            if Family == "AES":
+                C.write("#ifndef CSM_USE_AES_CMAC\n")
             GenMacGenPrimitive(C, Family, Mode, BitLen)
+            if Family == "AES":
+                C.write("#endif\n")
     C.write("/* ================================ [ DATAS     ] ============================================== */\n")
     for mg in cfg.get("MacGen", []):
-        C.write("static mbedtls_cipher_context_t Csm_MacGen_%s_Context;\n" % (mg["name"]))
+        if mg["Family"] == "AES":
+            C.write("#ifdef CSM_USE_AES_CMAC\n")
+            C.write("static Csm_AesCmacContextType Csm_MacGen_%s_Context;\n" % (mg["name"]))
+            C.write("#else\n")
+            C.write("static mbedtls_cipher_context_t Csm_MacGen_%s_Context;\n" % (mg["name"]))
+            C.write("#endif\n")
+        else:
+            C.write("static mbedtls_cipher_context_t Csm_MacGen_%s_Context;\n" % (mg["name"]))
         C.write("static const uint8_t Csm_MacGen_%s_Key[] = {%s};\n" % (mg["name"], ",".join(mg["Key"])))
         if mg.get("Verify", False):
             C.write("static uint8_t Csm_MacGen_%s_MacBuffer[%s];\n" % (mg["name"], BitLen // 8))
@@ -151,7 +164,14 @@ def Gen_Csm(cfg, dir):
         C.write("  { /* %s */\n" % (mg["name"]))
         C.write("    &Csm_MacGen_%s_Context,\n" % (mg["name"]))
         C.write("    Csm_MacGen_%s_Key,\n" % (mg["name"]))
-        C.write("    &Csm_MacGenPrimitive_%s,\n" % (ks))
+        if Family == "AES":
+            C.write("#ifdef CSM_USE_AES_CMAC\n")
+            C.write("    &Csm_AesCmacPrimitive,\n")
+            C.write("#else\n")
+            C.write("    &Csm_MacGenPrimitive_%s,\n" % (ks))
+            C.write("#endif\n")
+        else:
+            C.write("    &Csm_MacGenPrimitive_%s,\n" % (ks))
         if mg.get("Verify", False):
             C.write("    Csm_MacGen_%s_MacBuffer,\n" % (mg["name"]))
         else:
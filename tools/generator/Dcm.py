@@ -173,6 +173,8 @@ def gen_read_periodic_did_api(C, service, cfg):
 
 def gen_read_periodic_did_config(C, service, cfg):
     numOfDDDID = get_number_of_DDDID(cfg)
+    # 0xFF ends the lists of the periodic scheduler
+    assert (len(service["DIDs"]) + numOfDDDID) < 0xFF
     C.write(
         "static Dcm_ReadPeriodicDIDContextType Dcm_ReadPeriodicDIDContexts[%d];\n" % (len(service["DIDs"]) + numOfDDDID)
     )
@@ -192,6 +194,7 @@ def gen_read_periodic_did_config(C, service, cfg):
     C.write("static CONSTANT(Dcm_ReadPeriodicDIDConfigType, DCM_CONST) Dcm_ReadDataByPeriodicIdentifierConfig = {\n")
     C.write("  Dcm_ReadPeriodicDIDs,\n")
     C.write("  ARRAY_SIZE(Dcm_ReadPeriodicDIDs),\n")
+    C.write("  %s,\n" % (service.get("TxPduId", "DCM_PERIODIC_TX_PDU_INVALID")))
     C.write("};\n\n")
 
 
@@ -664,6 +667,14 @@ def get_all_readable_dids(cfg):
     return DIDs
 
 
+def get_connection_index(chl, conns):
+    name = chl.get("connection", conns[0]["name"])
+    for idx, conn in enumerate(conns):
+        if conn["name"] == name:
+            return idx
+    raise Exception("channel %s refers to unknown connection %s" % (chl["name"], name))
+
+
 def Gen_Dcm(cfg, dir):
     preprocess(cfg)
     H = open("%s/Dcm_Cfg.h" % (dir), "w")
@@ -682,10 +693,20 @@ def Gen_Dcm(cfg, dir):
     H.write("#define DCM_CONST\n")
     H.write("#endif\n\n")
     chls = cfg.get("channels", [{"name": "P2P"}, {"name": "P2A"}])
+    conns = cfg.get("connections", [{"name": "Main"}])
     for idx, chl in enumerate(chls):
         H.write("#define DCM_%s_PDU %su\n" % (chl["name"], idx))
         H.write("#define DCM_%s_RX %su\n" % (chl["name"], idx))
         H.write("#define DCM_%s_TX %su\n" % (chl["name"], idx))
+    for service in cfg["services"]:
+        if service["id"] == 0x2A and "TxPduId" in service:
+            # the handle of the periodic DID frames confirmed by the IF layer, the PduR route from
+            # Dcm is named PERIODIC_TX, so its source handle is the TxPduId the frames are sent on
+            H.write("#define DCM_PERIODIC_TX %s\n" % (service["TxPduId"]))
+        if service["id"] == 0x2A:
+            for rate in ["Slow", "Medium", "Fast"]:
+                if "%sRate" % (rate) in service:
+                    H.write("#define DCM_TM_%s_TIME_MS %su\n" % (rate.upper(), service["%sRate" % (rate)]))
     iMask = 4
     for session in cfg["sessions"]:
         H.write("#ifndef DCM_%s_SESSION\n" % (toMacro(session["name"])))
@@ -793,10 +814,16 @@ def Gen_Dcm(cfg, dir):
         C.write("                                          uint16_t length,\n")
         C.write("                                          Dcm_NegativeResponseCodeType *errorCode);\n\n")
     C.write("/* ================================ [ DATAS     ] ============================================== */\n")
+    for conn in conns:
+        C.write("static Dcm_ContextType Dcm_Context_%s;\n" % (conn["name"]))
+    C.write("\n")
     C.write("#define DCM_START_SEC_CONST\n")
     C.write('#include "Dcm_MemMap.h"\n')
-    C.write("static uint8_t rxBuffer[%s];\n" % (cfg["buffer"]["rx"]))
-    C.write("static uint8_t txBuffer[%s];\n\n" % (cfg["buffer"]["tx"]))
+    for conn in conns:
+        buffer = conn.get("buffer", cfg["buffer"])
+        C.write("static uint8_t Dcm_RxBuffer_%s[%s];\n" % (conn["name"], buffer["rx"]))
+        C.write("static uint8_t Dcm_TxBuffer_%s[%s];\n" % (conn["name"], buffer["tx"]))
+    C.write("\n")
     mems = cfg.get("memories", [])
     if len(mems):
         C.write(
@@ -925,6 +952,18 @@ def Gen_Dcm(cfg, dir):
     C.write("  %s,\n" % (cfg.get("MaxNumRespPend", 8)))
     C.write("};\n\n")
 
+    C.write("static CONSTANT(Dcm_ConnectionType, DCM_CONST) Dcm_Connections[] = {\n")
+    for conn in conns:
+        C.write("  {\n")
+        C.write("     &Dcm_Context_%s,\n" % (conn["name"]))
+        C.write("     Dcm_RxBuffer_%s,\n" % (conn["name"]))
+        C.write("     Dcm_TxBuffer_%s,\n" % (conn["name"]))
+        C.write("     sizeof(Dcm_RxBuffer_%s),\n" % (conn["name"]))
+        C.write("     sizeof(Dcm_TxBuffer_%s),\n" % (conn["name"]))
+        C.write("     %s, /* priority */\n" % (conn.get("priority", 0)))
+        C.write("  },\n")
+    C.write("};\n\n")
+
     C.write("static CONSTANT(Dcm_ChannelType, DCM_CONST) Dcm_Channels[] = {\n")
     for chl in chls:
         C.write("  {\n")
@@ -933,15 +972,14 @@ def Gen_Dcm(cfg, dir):
             C.write("     DCM_FUNCTIONAL_REQUEST,\n")
         else:
             C.write("     DCM_PHYSICAL_REQUEST,\n")
+        C.write("     %s, /* connection %s */\n" % (get_connection_index(chl, conns), chl.get("connection", conns[0]["name"])))
         C.write("  },\n")
     C.write("};\n\n")
 
     C.write("CONSTANT(Dcm_ConfigType, DCM_CONST) Dcm_Config = {\n")
     C.write("  %s,\n" % (cfg.get("ServiceVerification", "NULL")))
-    C.write("  rxBuffer,\n")
-    C.write("  txBuffer,\n")
-    C.write("  sizeof(rxBuffer),\n")
-    C.write("  sizeof(txBuffer),\n")
+    C.write("  Dcm_Connections,\n")
+    C.write("  ARRAY_SIZE(Dcm_Connections),\n")
     C.write("  Dcm_Channels,\n")
     C.write("  ARRAY_SIZE(Dcm_Channels),\n")
     C.write("  Dcm_ServiceTables,\n")
@@ -992,16 +1030,18 @@ def Gen_Dcm(cfg, dir):
     C.write("/* ================================ [ FUNCTIONS ] ============================================== */\n")
     C.write("Std_ReturnType Dcm_Transmit(const uint8_t *buffer, PduLengthType length, int functional) {\n")
     C.write("  Std_ReturnType r = E_NOT_OK;\n")
-    C.write("  Dcm_ContextType *context = Dcm_GetContext();\n\n")
-
-    C.write("  if ((DCM_BUFFER_IDLE == context->txBufferState) && (Dcm_Config.txBufferSize >= length)) {\n")
+    C.write("  PduIdType id = DCM_P2P_PDU;\n")
+    C.write("  P2CONST(Dcm_ConnectionType, AUTOMATIC, DCM_CONST) connection;\n")
+    C.write("  Dcm_ContextType *context;\n\n")
+    C.write("  if (functional) {\n")
+    C.write("    id = DCM_P2A_PDU;\n")
+    C.write("  }\n")
+    C.write("  connection = &Dcm_Connections[Dcm_Channels[id].connection];\n")
+    C.write("  context = connection->context;\n")
+    C.write("  if ((DCM_BUFFER_IDLE == context->txBufferState) && (connection->txBufferSize >= length)) {\n")
     C.write("    r = E_OK;\n")
-    C.write("    if (functional) {\n")
-    C.write("      context->curPduId = DCM_P2A_PDU;\n")
-    C.write("    } else {\n")
-    C.write("      context->curPduId = DCM_P2P_PDU;\n")
-    C.write("    }\n")
-    C.write("    memcpy(Dcm_Config.txBuffer, buffer, (size_t)length);\n")
+    C.write("    context->curPduId = id;\n")
+    C.write("    memcpy(connection->txBuffer, buffer, (size_t)length);\n")
     C.write("    context->TxTpSduLength = (PduLengthType)length;\n")
     C.write("    context->txBufferState = DCM_BUFFER_FULL;\n")
     C.write("  }\n\n")
@@ -46,11 +46,20 @@ def Gen_E2E(cfg, dir):
         H.write("\n#define E2E_USE_PROTECT_P05\n")
     for idx, profile in enumerate(cfg.get("ProtectP05", [])):
         H.write("#define E2E_PROTECT_P05_%s %su\n" % (toMacro(profile["name"]), idx))
-    if len(cfg.get("CheckP44", [])):
+    if len(cfg.get("CheckP05", [])):
         H.write("\n#define E2E_USE_CHECK_P05\n")
     for idx, profile in enumerate(cfg.get("CheckP05", [])):
         H.write("#define E2E_CHECK_P05_%s %su\n" % (toMacro(profile["name"]), idx))
 
+    if len(cfg.get("ProtectP07", [])):
+        H.write("\n#define E2E_USE_PROTECT_P07\n")
+    for idx, profile in enumerate(cfg.get("ProtectP07", [])):
+        H.write("#define E2E_PROTECT_P07_%s %su\n" % (toMacro(profile["name"]), idx))
+    if len(cfg.get("CheckP07", [])):
+        H.write("\n#define E2E_USE_CHECK_P07\n")
+    for idx, profile in enumerate(cfg.get("CheckP07", [])):
+        H.write("#define E2E_CHECK_P07_%s %su\n" % (toMacro(profile["name"]), idx))
+
     H.write("\n%s#define E2E_USE_PB_CONFIG\n\n" % ("" if cfg.get("UsePostBuildConfig", False) else "// "))
     H.write("/* ================================ [ TYPES     ] ============================================== */\n")
     H.write("/* ================================ [ DECLARES  ] ============================================== */\n")
@@ -192,6 +201,33 @@ def Gen_E2E(cfg, dir):
             C.write("    %su, /* MaxDeltaCounter */\n" % (profile.get("MaxDeltaCounter", 1)))
             C.write("  },\n")
         C.write("};\n\n")
+    if len(cfg.get("ProtectP07", [])) > 0:
+        for profile in cfg.get("ProtectP07", []):
+            C.write("static E2E_ProtectProfile07ContextType E2E_ProtectP07_%s_Context;\n" % (profile["name"]))
+        C.write("static const E2E_ProtectProfile07ConfigType E2E_ProtectProfile07Configs[] = {\n")
+        for profile in cfg.get("ProtectP07", []):
+            C.write("  { /* %s */\n" % (profile["name"]))
+            C.write("    &E2E_ProtectP07_%s_Context,\n" % (profile["name"]))
+            C.write("    { /* P07 */\n")
+            C.write("      %su, /* DataID */\n" % (profile["DataID"]))
+            C.write("      %su, /* Offset */\n" % (profile.get("Offset", 0)))
+            C.write("    }\n")
+            C.write("  },\n")
+        C.write("};\n\n")
+    if len(cfg.get("CheckP07", [])) > 0:
+        for profile in cfg.get("CheckP07", []):
+            C.write("static E2E_CheckProfile07ContextType E2E_CheckP07_%s_Context;\n" % (profile["name"]))
+        C.write("static const E2E_CheckProfile07ConfigType E2E_CheckProfile07Configs[] = {\n")
+        for profile in cfg.get("CheckP07", []):
+            C.write("  { /* %s */\n" % (profile["name"]))
+            C.write("    &E2E_CheckP07_%s_Context,\n" % (profile["name"]))
+            C.write("    { /* P07 */\n")
+            C.write("      %su, /* DataID */\n" % (profile["DataID"]))
+            C.write("      %su, /* Offset */\n" % (profile.get("Offset", 0)))
+            C.write("    },\n")
+            C.write("    %su, /* MaxDeltaCounter */\n" % (profile.get("MaxDeltaCounter", 1)))
+            C.write("  },\n")
+        C.write("};\n\n")
     C.write("const E2E_ConfigType E2E_Config = {\n")
     if len(cfg.get("ProtectP11", [])) > 0:
         C.write("  E2E_ProtectProfile11Configs,\n")
@@ -209,6 +245,10 @@ def Gen_E2E(cfg, dir):
         C.write("  E2E_ProtectProfile05Configs,\n")
     if len(cfg.get("CheckP05", [])) > 0:
         C.write("  E2E_CheckProfile05Configs,\n")
+    if len(cfg.get("ProtectP07", [])) > 0:
+        C.write("  E2E_ProtectProfile07Configs,\n")
+    if len(cfg.get("CheckP07", [])) > 0:
+        C.write("  E2E_CheckProfile07Configs,\n")
     if len(cfg.get("ProtectP11", [])) > 0:
         C.write("  ARRAY_SIZE(E2E_ProtectProfile11Configs),\n")
     if len(cfg.get("CheckP11", [])) > 0:
@@ -225,6 +265,10 @@ def Gen_E2E(cfg, dir):
         C.write("  ARRAY_SIZE(E2E_ProtectProfile05Configs),\n")
     if len(cfg.get("CheckP05", [])) > 0:
         C.write("  ARRAY_SIZE(E2E_CheckProfile05Configs),\n")
+    if len(cfg.get("ProtectP07", [])) > 0:
+        C.write("  ARRAY_SIZE(E2E_ProtectProfile07Configs),\n")
+    if len(cfg.get("CheckP07", [])) > 0:
+        C.write("  ARRAY_SIZE(E2E_CheckProfile07Configs),\n")
     C.write("};\n\n")
     C.write("/* ================================ [ FUNCTIONS ] ============================================== */\n")
 
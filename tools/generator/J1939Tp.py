@@ -54,6 +54,8 @@ def Gen_J1939Tp(cfg, dir):
             TxId = TxId + 1
         H.write("\n")
     H.write("\n")
+    H.write("/* #define J1939TP_USE_STD_TIMER */\n")
+    H.write("#define J1939TP_DT_BURST_MAX %su\n" % (cfg.get("DTBurstMax", 1)))
     H.write("#ifndef J1939TP_MAIN_FUNCTION_PERIOD\n")
     H.write("#define J1939TP_MAIN_FUNCTION_PERIOD %su\n" % (cfg.get("MainFunctionPeriod", 10)))
     H.write("#endif\n")
@@ -4,6 +4,7 @@
 import pprint
 import os
 import json
+import math
 from .helper import *
 
 __all__ = ["Gen"]
@@ -120,7 +121,12 @@ def Gen_LinIf(cfg, dir):
                     C.write("    /* Cs */ LIN_%s_CS,\n" % (pdu.get("checksum", "enhanced").upper()))
                     C.write("    /* Drc */ LIN_FRAMERESPONSE_%s,\n" % (drc))
                     C.write("    /* Callback */ LinIf_UserCallback_%s,\n" % (name))
-                    C.write("    LINIF_CONVERT_MS_TO_MAIN_CYCLES(%su * LINIF_DELAY_UINT),\n" % (toNum(entry["delay"])))
+                    delay = toNum(entry["delay"])
+                    C.write("    LINIF_CONVERT_MS_TO_MAIN_CYCLES(%su * LINIF_DELAY_UINT),\n" % (math.ceil(delay)))
+                    C.write("    #ifdef LINIF_SCHED_MODE_DEADLINE\n")
+                    # in the same unit as the delay, the Windows host runs the schedule 10 times slower
+                    C.write("    /* slotTime */ %su * LINIF_DELAY_UINT,\n" % (int(round(delay * 1000))))
+                    C.write("    #endif\n")
                     C.write("  },\n")
                 C.write("};\n\n")
                 schtbls.append("%s_%s_SchTblEnts" % (netName, schtbl["name"]))
@@ -143,6 +149,9 @@ def Gen_LinIf(cfg, dir):
                 C.write("    /* Drc */ LIN_FRAMERESPONSE_%s,\n" % (drc))
                 C.write("    /* Callback */ LinIf_UserCallback_%s,\n" % (name))
                 C.write("    /* delay us */ 0,\n")
+                C.write("    #ifdef LINIF_SCHED_MODE_DEADLINE\n")
+                C.write("    /* slotTime */ 0,\n")
+                C.write("    #endif\n")
                 C.write("  },\n")
             C.write("};\n\n")
             schtbls.append("%s_SchTblEnts" % (netName))
@@ -127,6 +127,17 @@ def Gen_Mirror(cfg, dir):
                 C.write("    %su, /* SourceCanIdMask */\n" % (mim["SourceCanIdMask"]))
                 C.write("  },\n")
             C.write("};\n\n")
+        RingSize = network.get("RingSize", 0)
+        if RingSize > 0:
+            # must be power of 2
+            assert (RingSize & (RingSize - 1)) == 0
+            C.write("static Mirror_CanFrameType Mirror_SourceCanRingFrames_%s[%s];\n\n" % (network["name"], RingSize))
+            C.write("static Mirror_SourceRingContextType Mirror_SourceCanRingContext_%s;\n\n" % (network["name"]))
+            C.write("static const Mirror_SourceCanRingType Mirror_SourceCanRing_%s = {\n" % (network["name"]))
+            C.write("  &Mirror_SourceCanRingContext_%s,\n" % (network["name"]))
+            C.write("  Mirror_SourceCanRingFrames_%s,\n" % (network["name"]))
+            C.write("  %su, /* NumOfFrames */\n" % (RingSize))
+            C.write("};\n\n")
     if len(SourceNetworkCans) > 0:
         C.write(
             "static Mirror_SourceNetworkCanContextType Mirror_SourceNetworkCanContexts[%s];\n\n"
@@ -157,6 +168,10 @@ def Gen_Mirror(cfg, dir):
             else:
                 C.write("    NULL, /* SingleIdMappings */\n")
             C.write("    Mirror_SourceNetworkCanFilterStatus_%s,\n" % (network["name"]))
+            if network.get("RingSize", 0) > 0:
+                C.write("    &Mirror_SourceCanRing_%s,\n" % (network["name"]))
+            else:
+                C.write("    NULL, /* Ring */\n")
             C.write("    %su, /* NumMaskBasedIdMappings */\n" % (len(MaskBasedIdMappings)))
             C.write("    %su, /* NumSingleIdMappings */\n" % (len(SingleIdMappings)))
             C.write("    %su, /* NumStaticFilters */\n" % (len(staticFilters)))
@@ -115,6 +115,16 @@ def Gen_PduR(cfg, dir):
         C.write("  Dcm_CopyTxData,\n")
         C.write("  Dcm_TpTxConfirmation,\n")
         C.write("};\n\n")
+        # the periodic DIDs are sent as single frames on IF routes
+        C.write("const PduR_ApiType PduR_DcmIfApi = {\n")
+        C.write("  NULL,\n")
+        C.write("  NULL,\n")
+        C.write("  NULL,\n")
+        C.write("  NULL,\n")
+        C.write("  NULL,\n")
+        C.write("  NULL,\n")
+        C.write("  Dcm_TxConfirmation,\n")
+        C.write("};\n\n")
     if "Com" in modules:
         C.write("const PduR_ApiType PduR_ComApi = {\n")
         C.write("  Com_StartOfReception,\n")
@@ -232,7 +242,10 @@ def Gen_PduR(cfg, dir):
         C.write("static const PduR_PduType PduR_SrcPdu_%s_%s_%s = {\n" % (fr, to, name))
         C.write("  PDUR_MODULE_%s,\n" % (fr.upper()))
         C.write("  %s_%s,\n" % (fr.upper(), name))
-        C.write("  &PduR_%sApi,\n" % (fr))
+        if fr == "Dcm" and to not in TP_MODULES:
+            C.write("  &PduR_DcmIfApi,\n")
+        else:
+            C.write("  &PduR_%sApi,\n" % (fr))
         C.write("};\n\n")
         dsts = []
         for dst in rt.get("destinations", []) + [{"from": fr, "to": to, "name": dest}]:
@@ -253,7 +266,7 @@ def Gen_PduR(cfg, dir):
             C.write("  },\n")
         C.write("};\n\n")
         if hasGw:
-            C.write("static PduR_BufferType PduR_Buffer_%s = { NULL, 0, 0 };\n" % (name))
+            C.write("static PduR_BufferType PduR_Buffer_%s;\n" % (name))
             DestBufferSize = rt.get("DestBufferSize", 0)
             if DestBufferSize > 0:
                 C.write("static uint8_t PduR_GwBuffer_%s[%u];\n" % (name, DestBufferSize))
@@ -290,9 +303,10 @@ def Gen_PduR(cfg, dir):
                         else:
                             a0 = "NULL"
                             a1 = 0
-                        C.write("    &PduR_Buffer_%s, %s, %s,\n" % (name, a0, a1))
+                        TpThreshold = rt.get("TpThreshold", 0)
+                        C.write("    &PduR_Buffer_%s, %s, %s, %s,\n" % (name, a0, a1, TpThreshold))
                     else:
-                        C.write("    NULL, NULL, 0,\n")
+                        C.write("    NULL, NULL, 0, 0,\n")
                     C.write("    ARRAY_SIZE(PduR_DstPdu_%s_%s_%s),\n" % (fr, to, name))
                     C.write("  },\n")
                     index += 1
@@ -35,6 +35,13 @@ def Gen_SD(cfg, dir):
         listenNum = service.get("listen", 1)
         subscriberPoolSize += listenNum * len(service.get("event-groups", []))
     H.write(f"#define SD_EVENT_HANDLER_SUBSCRIBER_POOL_SIZE {subscriberPoolSize}\n\n")
+    numOfIndexKeys = 0
+    for service in cfg.get("servers", []) + cfg.get("clients", []):
+        numOfIndexKeys += 1 + len(service.get("event-groups", []))
+    serviceIndexSize = 16
+    while serviceIndexSize < 2 * numOfIndexKeys:
+        serviceIndexSize *= 2
+    H.write(f"#define SD_SERVICE_INDEX_SIZE {serviceIndexSize}u\n\n")
     H.write("#define SD_RX_PID_MULTICAST 0\n")
     H.write("#define SD_RX_PID_UNICAST 0\n\n")
     for ID, service in enumerate(cfg.get("servers", [])):
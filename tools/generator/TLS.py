@@ -58,6 +58,15 @@ def Gen_TLS(cfg, dir):
             headerMaxLen = headerLen
     H.write("\n")
     H.write("#define TLS_HEADER_MAX_LEN %su\n" % (headerMaxLen))
+    for key, macro in [
+        ("TxBufferSize", "TLS_TX_BUFFER_SIZE"),
+        ("NetBufferSize", "TLS_NET_BUFFER_SIZE"),
+        ("RxBufferSize", "TLS_RX_BUFFER_SIZE"),
+        ("SessionCacheMaxEntries", "TLS_SESSION_CACHE_MAX_ENTRIES"),
+        ("SessionTicketLifetime", "TLS_SESSION_TICKET_LIFETIME"),
+    ]:
+        if key in cfg:
+            H.write("#define %s %s\n" % (macro, cfg[key]))
     H.write("/* ================================ [ TYPES     ] ============================================== */\n")
     H.write("/* ================================ [ DECLARES  ] ============================================== */\n")
     H.write("/* ================================ [ DATAS     ] ============================================== */\n")
@@ -150,7 +159,6 @@ def Gen_TLS(cfg, dir):
                 C.write("    sizeof(TLS_%s_ServerCerts),\n" % (srv["name"]))
                 C.write("    sizeof(TLS_%s_CasCerts),\n" % (srv["name"]))
                 C.write("    sizeof(TLS_%s_ServerKey),\n" % (srv["name"]))
-                C.write("    %su, /* MaxSize */\n" % (srv.get("MaxSize", 512)))
                 C.write("    SOAD_SOCKID_%s, /* SoConId */\n" % (srv["SoConId"]))
                 C.write("    SOAD_TX_PID_%s, /* TxPduId */\n" % (srv["SoConId"]))
                 C.write("    %s, /* RxPduId */\n" % (srv["RxPduId"]))
@@ -133,7 +133,8 @@ def p_schentrys(p):
 
 
 def p_schentry(p):
-    """schentry : ID delay INTEGER ms SEMI"""
+    """schentry : ID delay INTEGER ms SEMI
+    | ID delay DIGIT ms SEMI"""
     p[0] = {"name": p[1], "delay": p[3]}
 
 
@@ -725,7 +725,8 @@ bool can_wait(int busid, uint32_t canid, uint32_t timeoutMs) {
           break;
         }
       } else {
-        rv = false;
+        /* the notification may race with the check above, so look once more */
+        rv = hasPdu(b, canid);
         break;
       }
     }
@@ -741,6 +742,9 @@ bool can_wait_v2(int busid, uint32_t canid, uint32_t timeoutMs) {
   auto begin = std::chrono::high_resolution_clock::now();
   if (NULL == b) {
     ASLOG(ERROR, ("can bus(%d) is not on-line 'can_wait'\n", (int)busid));
+  } else if (NULL == b->device.ops->read) {
+    /* device with its own RX thread, wait on the bus notification */
+    rv = can_wait(busid, canid, timeoutMs);
   } else {
     rv = hasPdu(b, canid);
     while (false == rv) {
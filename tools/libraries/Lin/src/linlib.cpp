@@ -12,6 +12,12 @@
 
 #include <thread>
 #include <chrono>
+#include <map>
+#include <mutex>
+#ifndef _WIN32
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
 
 using namespace std::literals::chrono_literals;
 /* ================================ [ MACROS    ] ============================================== */
@@ -32,7 +38,68 @@ using namespace std::literals::chrono_literals;
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
+#ifndef _WIN32
+/* the epoll fd of each bus on its rx event */
+static std::map<int, int> lEpolls;
+static std::mutex lEpollLock;
+#endif
 /* ================================ [ LOCALS    ] ============================================== */
+#ifndef _WIN32
+static void lin_epoll_open(int busid) {
+  struct epoll_event ev;
+  int evfd = -1;
+  int epfd;
+  int ret;
+
+  ret = dev_ioctl(busid, DEV_IOCTL_GET_RX_EVENT, &evfd, sizeof(evfd));
+  if (0 == ret) {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd >= 0) {
+      ev.events = EPOLLIN;
+      ev.data.fd = evfd;
+      if (0 == epoll_ctl(epfd, EPOLL_CTL_ADD, evfd, &ev)) {
+        std::lock_guard<std::mutex> lg(lEpollLock);
+        lEpolls[busid] = epfd;
+      } else {
+        close(epfd);
+      }
+    }
+  }
+}
+
+static void lin_epoll_close(int busid) {
+  std::lock_guard<std::mutex> lg(lEpollLock);
+  auto it = lEpolls.find(busid);
+  if (it != lEpolls.end()) {
+    close(it->second);
+    lEpolls.erase(it);
+  }
+}
+#endif
+
+/* wait at most timeout us for data to read, return at once when the data arrives if the device
+ * provides the rx event, else just sleep 1ms */
+static void lin_wait(int busid, std_time_t timeout) {
+#ifndef _WIN32
+  struct epoll_event ev;
+  int epfd = -1;
+  {
+    std::lock_guard<std::mutex> lg(lEpollLock);
+    auto it = lEpolls.find(busid);
+    if (it != lEpolls.end()) {
+      epfd = it->second;
+    }
+  }
+  if (epfd >= 0) {
+    (void)epoll_wait(epfd, &ev, 1, (int)((timeout + 999) / 1000));
+  } else
+#endif
+  {
+    (void)timeout;
+    std::this_thread::sleep_for(1ms);
+  }
+}
+
 static lin_id_t get_pid(lin_id_t id) {
   uint8_t pid;
   uint8_t p0;
@@ -79,6 +146,11 @@ int lin_open(const char *device_name, uint32_t port, uint32_t baudrate) {
   snprintf(option, sizeof(option), "%u", baudrate);
 
   fd = dev_open(device, option);
+#ifndef _WIN32
+  if (fd >= 0) {
+    lin_epoll_open(fd);
+  }
+#endif
 
   return fd;
 }
@@ -123,6 +195,8 @@ bool lin_read(int busid, lin_id_t id, uint8_t dlc, uint8_t *data, bool enhanced,
   bool r = false;
   lin_id_t pid = get_pid(id);
   Std_TimerType timer;
+  std_time_t elapsed;
+  bool done = false;
   size_t len;
   uint8_t checksum;
 
@@ -151,15 +225,21 @@ bool lin_read(int busid, lin_id_t id, uint8_t dlc, uint8_t *data, bool enhanced,
     r = false;
     Std_TimerStart(&timer);
     do {
-      std::this_thread::sleep_for(1ms);
       ret = dev_read(busid, sd, sizeof(sd));
       if (ret > 0) {
         if ((ret == (dlc + 2)) && (sd[0] == (uint8_t)'D')) {
           r = true;
         }
-        break;
+        done = true;
+      } else {
+        elapsed = Std_GetTimerElapsedTime(&timer);
+        if (elapsed < ((std_time_t)timeout * 1000)) {
+          lin_wait(busid, (std_time_t)timeout * 1000 - elapsed);
+        } else {
+          done = true;
+        }
       }
-    } while (Std_GetTimerElapsedTime(&timer) < ((uint32_t)timeout * 1000));
+    } while (false == done);
   }
   dev_unlock(busid);
 
@@ -178,6 +258,10 @@ bool lin_read(int busid, lin_id_t id, uint8_t dlc, uint8_t *data, bool enhanced,
 }
 
 bool lin_close(int busid) {
-  int ret = dev_close(busid);
+  int ret;
+#ifndef _WIN32
+  lin_epoll_close(busid);
+#endif
+  ret = dev_close(busid);
   return (0 == ret);
 }
@@ -23,6 +23,8 @@ extern "C" {
 #define DEV_IOCTL_SET_TIMEOUT 0
 #define DEV_IOCTL_TRANSFER 1  /* transfer request for I2C or SPI */
 #define DEV_IOCTL_SET_DELAY 2 /* set delay for each operation */
+/* get a fd(int) which is readable when the device has data to read, for the poll/epoll */
+#define DEV_IOCTL_GET_RX_EVENT 3
 /* ================================ [ TYPES     ] ============================================== */
 typedef struct {
   uint8_t *data;
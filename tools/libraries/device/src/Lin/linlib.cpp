@@ -18,6 +18,10 @@
 #include <time.h>
 #include <ctype.h>
 #include <errno.h>
+#ifndef _WIN32
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
 
 #include <chrono>
 
@@ -33,6 +37,7 @@ static int dev_lin_write(void *param, const uint8_t *data, size_t size);
 static void dev_lin_close(void *param);
 static int dev_lin_ioctl(void *param, int type, const void *data, size_t size);
 static void rx_daemon(void *param);
+static void rx_event_set(Lin_DeviceType *dev, bool ready);
 
 extern "C" const Lin_DeviceOpsType lin_simulator_ops;
 extern "C" const Lin_DeviceOpsType lin_simulator_v2_ops;
@@ -90,6 +95,11 @@ static int dev_lin_open(const char *device, const char *option, void **param) {
     dev->size = 0;
     STAILQ_INIT(&dev->head);
     dev->killed = FALSE;
+#ifdef _WIN32
+    dev->rx_event = -1;
+#else
+    dev->rx_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
 
     r = ops->open(dev, option);
 
@@ -100,6 +110,11 @@ static int dev_lin_open(const char *device, const char *option, void **param) {
     if (0 == r) {
       *param = (void *)dev;
     } else {
+#ifndef _WIN32
+      if (dev->rx_event >= 0) {
+        close(dev->rx_event);
+      }
+#endif
       delete dev;
     }
   }
@@ -118,6 +133,10 @@ static int dev_lin_read(void *param, uint8_t *data, size_t size) {
       STAILQ_REMOVE_HEAD(&dev->head, entry);
       memcpy(data, frame->data, frame->size);
       len = frame->size;
+      free(frame);
+      if (STAILQ_EMPTY(&dev->head)) {
+        rx_event_set(dev, false);
+      }
     } else {
       ASLOG(LINE, ("lin read buffer size %d < %d\n", (int)size, (int)frame->size));
     }
@@ -206,6 +225,16 @@ static void dev_lin_close(void *param) {
     dev->rx_thread.join();
   }
   dev->ops->close(dev);
+  while (FALSE == STAILQ_EMPTY(&dev->head)) {
+    struct Lin_Frame_s *frame = STAILQ_FIRST(&dev->head);
+    STAILQ_REMOVE_HEAD(&dev->head, entry);
+    free(frame);
+  }
+#ifndef _WIN32
+  if (dev->rx_event >= 0) {
+    close(dev->rx_event);
+  }
+#endif
   delete dev;
 }
 
@@ -213,13 +242,35 @@ static int dev_lin_ioctl(void *param, int type, const void *data, size_t size) {
   int r = -ENOTSUP;
   Lin_DeviceType *dev = (Lin_DeviceType *)param;
 
-  if (dev->ops->ioctl) {
+  if (DEV_IOCTL_GET_RX_EVENT == type) {
+    if ((dev->rx_event >= 0) && (nullptr != data) && (size >= sizeof(int))) {
+      *(int *)data = dev->rx_event;
+      r = 0;
+    }
+  } else if (dev->ops->ioctl) {
     r = dev->ops->ioctl(dev, type, data, size);
   }
 
   return r;
 }
 
+/* called with the q_lock held, the rx event is kept readable while the queue is not empty */
+static void rx_event_set(Lin_DeviceType *dev, bool ready) {
+#ifndef _WIN32
+  uint64_t v = 1;
+  ssize_t r;
+
+  if (dev->rx_event >= 0) {
+    if (ready) {
+      r = write(dev->rx_event, &v, sizeof(v));
+    } else {
+      r = read(dev->rx_event, &v, sizeof(v));
+    }
+    (void)r;
+  }
+#endif
+}
+
 static void rx_daemon(void *param) {
   Lin_DeviceType *dev = (Lin_DeviceType *)param;
   Lin_FrameType frame;
@@ -281,13 +332,17 @@ static void rx_daemon(void *param) {
                       frame.checksum, (uint32_t)Std_GetTime()));
         } else {
           ASLOG(ERROR, ("invalid frame from %s\n", dev->name.c_str()));
+          free(pframe);
           continue;
         }
         std::lock_guard<std::mutex> lg(dev->q_lock);
         STAILQ_INSERT_TAIL(&dev->head, pframe, entry);
+        rx_event_set(dev, true);
       }
+    } else {
+      /* only idle when there is nothing received, a frame may be followed by its response */
+      std::this_thread::sleep_for(1ms);
     }
-    std::this_thread::sleep_for(1ms);
   }
 }
 
@@ -53,6 +53,7 @@ typedef struct Lin_Device_s {
   std::thread rx_thread;
   std::mutex q_lock;
   int killed;
+  int rx_event; /* eventfd which is readable when the queue is not empty */
   void *param;
   STAILQ_HEAD(, Lin_Frame_s) head;
   uint32_t size;
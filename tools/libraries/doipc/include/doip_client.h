@@ -33,6 +33,10 @@ typedef struct {
   uint8_t EID[6];
   uint8_t GID[6];
 } doip_node_t;
+
+/* Completion of an asynchronous UDS request, called from the client I/O thread with the
+ * result (> 0: length of the UDS response in data, < 0: DOIP_E_* error code), must not block */
+typedef void (*doip_callback_t)(void *ctx, int result, const uint8_t *data, size_t length);
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
@@ -46,6 +50,11 @@ int doip_activate(doip_node_t *node, uint16_t sa, uint8_t at, uint8_t *oem, uint
 int doip_transmit(doip_node_t *node, uint16_t ta, const uint8_t *txBuffer, size_t txSize,
                   uint8_t *rxBuffer, size_t rxSize);
 int doip_receive(doip_node_t *node, uint8_t *rxBuffer, size_t rxSize);
+/* Queue a UDS request and return immediately, requests to different nodes or different target
+ * addresses are in flight at the same time, requests to the same target address are sent one
+ * after another as the previous one completes. */
+int doip_transmit_async(doip_node_t *node, uint16_t ta, const uint8_t *txBuffer, size_t txSize,
+                        doip_callback_t callback, void *ctx);
 void doip_destory_client(doip_client_t *client);
 #ifdef __cplusplus
 }
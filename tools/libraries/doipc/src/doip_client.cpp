@@ -13,6 +13,10 @@
 #include <string.h>
 #include <sys/queue.h>
 #include <assert.h>
+#if defined(__linux__) && !defined(USE_LWIP)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
 #include "TcpIp.h"
 #include "doip_client.h"
@@ -36,6 +40,9 @@
 #include <string>
 #include <vector>
 #include <queue>
+#include <deque>
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 
 #include "Semaphore.hpp"
@@ -76,6 +83,18 @@ using namespace std::literals::chrono_literals;
 
 #define DOIP_ALIVE_TIMEOUT 5000000
 #define DOIP_ALIVE_CHECK_TIME 3000000
+#define DOIP_UDS_TIMEOUT 5000000
+
+#define DOIP_RX_BUFFER_SIZE 4096
+#define DOIP_MAX_MESSAGE_LENGTH (DOIP_HEADER_LENGTH + 4 + 0x10000)
+
+#if defined(__linux__) && !defined(USE_LWIP)
+/* all the sockets of one client are served by one epoll thread, otherwise there is a polling
+ * thread for the UDP sockets plus one for each connected node */
+#define DOIP_USE_EPOLL
+#define DOIP_MAX_EVENTS 32
+#define DOIP_MAX_WAIT_MS 1000
+#endif
 /* ================================ [ TYPES     ] ============================================== */
 typedef enum {
   DOIP_MSGQ_DEFAULT,
@@ -90,6 +109,17 @@ typedef struct {
   std::vector<uint8_t> data;
 } doip_msg_t;
 
+typedef struct {
+  uint16_t ta;
+  bool sent;
+  bool acked;
+  bool noReply;              /* suppress positive response, done on the diagnostic ack */
+  std::vector<uint8_t> data; /* the whole DoIP diagnostic message */
+  doip_callback_t callback;
+  void *ctx;
+  Std_TimerType timer;
+} doip_async_req_t;
+
 struct doip_node_s {
   doip_node_t node;
   uint8_t lastSID = 0;
@@ -110,7 +140,14 @@ struct doip_node_s {
   std::queue<doip_msg_t> msgQ[DOIP_MSGQ_MAX];
   std::condition_variable condVarQ[DOIP_MSGQ_MAX];
 
-  bool stopped;
+  /* requests of doip_transmit_async, in the order of submission */
+  std::deque<doip_async_req_t> asyncQ;
+
+  /* receive state: data is read in chunks and every complete DoIP message in it is handled */
+  std::vector<uint8_t> rxBuf;
+  uint32_t rxLen = 0;
+
+  std::atomic<bool> stopped;
   struct doip_client_s *client;
   STAILQ_ENTRY(doip_node_s) entry;
 
@@ -120,6 +157,7 @@ struct doip_node_s {
   mbedtls_ssl_context ssl;
   mbedtls_ssl_config conf;
   mbedtls_x509_crt cacert;
+  std::mutex ioLock; /* mbedtls_ssl_read/write are not allowed to run concurrently */
 };
 
 struct doip_client_s {
@@ -129,12 +167,17 @@ struct doip_client_s {
   int port;
   std::thread thread;
   std::mutex lock;
-  bool stopped;
+  std::atomic<bool> stopped;
   Semaphore sem;
 
   std::queue<doip_msg_t> msgQ;
   std::condition_variable condVar;
 
+#ifdef DOIP_USE_EPOLL
+  int epfd;
+  int evfd; /* to wake up the event loop on destroy */
+#endif
+
   STAILQ_HEAD(, doip_node_s) nodes;
   uint32_t numOfNodes;
   /* TLS related */
@@ -142,7 +185,7 @@ struct doip_client_s {
   std::vector<char> casPem;
 };
 /* ================================ [ DECLARES  ] ============================================== */
-static void doip_handle_tcp_response(struct doip_node_s *node, uint8_t *data, uint16_t length);
+static void doip_handle_tcp_response(struct doip_node_s *node, uint8_t *data, uint32_t length);
 /* ================================ [ DATAS     ] ============================================== */
 static boolean l_initialized = FALSE;
 /* ================================ [ LOCALS    ] ============================================== */
@@ -165,6 +208,7 @@ static Std_ReturnType TcpIp_TlsRecv(struct doip_node_s *node, uint8_t *buffer, u
 
   if (node->client->casPem.size() > 0) {
     int rc;
+    std::lock_guard<std::mutex> lck(node->ioLock);
     rc = mbedtls_ssl_read(&node->ssl, buffer, *length);
     *length = 0;
     if (rc >= 0) {
@@ -187,6 +231,7 @@ static Std_ReturnType TcpIp_TlsSend(struct doip_node_s *node, uint8_t *buffer, u
 
   if (node->client->casPem.size() > 0) {
     int rc;
+    std::lock_guard<std::mutex> lck(node->ioLock);
     rc = mbedtls_ssl_write(&node->ssl, buffer, length);
     if (rc == (int)length) {
       ret = E_OK;
@@ -202,6 +247,15 @@ static void doip_init(void) {
   TcpIp_Init(NULL);
 }
 
+static bool doip_is_valid_header(const uint8_t *header) {
+  return (DOIP_PROTOCOL_VERSION == header[0]) && (header[0] == ((~header[1]) & 0xFF));
+}
+
+static uint32_t doip_get_payload_length(const uint8_t *header) {
+  return ((uint32_t)header[4] << 24) + ((uint32_t)header[5] << 16) + ((uint32_t)header[6] << 8) +
+         header[7];
+}
+
 static void doip_fill_header(uint8_t *header, uint16_t payloadType, uint32_t payloadLength) {
   header[0] = DOIP_PROTOCOL_VERSION;
   header[1] = ~DOIP_PROTOCOL_VERSION;
@@ -237,7 +291,7 @@ static void doip_add_node(doip_client_t *client, struct doip_node_s *node) {
                   node->RemoteAddr.addr[1], node->RemoteAddr.addr[2], node->RemoteAddr.addr[3],
                   node->RemoteAddr.port));
   } else {
-    free(node);
+    delete node;
   }
 }
 
@@ -280,8 +334,7 @@ static void doip_handle_udp_message(doip_client_t *client, TcpIp_SockAddrType *R
                RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port,
                build_hexstring(data, length).c_str()));
 
-  if ((length >= DOIP_HEADER_LENGTH) && (DOIP_PROTOCOL_VERSION == data[0]) &&
-      (data[0] = ((~data[1])) & 0xFF)) {
+  if ((length >= DOIP_HEADER_LENGTH) && doip_is_valid_header(data)) {
     payloadType = ((uint16_t)data[2] << 8) + data[3];
     payloadLength =
       ((uint32_t)data[4] << 24) + ((uint32_t)data[5] << 16) + ((uint32_t)data[6] << 8) + data[7];
@@ -318,33 +371,40 @@ static void doip_handle_udp_message(doip_client_t *client, TcpIp_SockAddrType *R
   }
 }
 
-static void doip_daemon(void *arg) {
+static void doip_udp_poll(doip_client_t *client, TcpIp_SocketIdType sock,
+                          std::vector<uint8_t> &buffer) {
   Std_ReturnType ret;
-  doip_client_t *client = (doip_client_t *)arg;
   uint32_t length;
   TcpIp_SockAddrType RemoteAddr;
-  std::vector<uint8_t> buffer;
-  buffer.resize(4096);
 
-  ASLOG(DOIPI, ("DoIP Client request on %s:%d\n", client->ip, client->port));
-  while (false == client->stopped) {
+  do {
     length = buffer.size();
-    ret = TcpIp_RecvFrom(client->discovery, &RemoteAddr, buffer.data(), &length);
-    if ((E_OK == ret) && (length > 0)) {
-      doip_handle_udp_message(client, &RemoteAddr, buffer.data(), length);
-    }
-    length = buffer.size();
-    ret = TcpIp_RecvFrom(client->test_equipment_request, &RemoteAddr, buffer.data(), &length);
+    ret = TcpIp_RecvFrom(sock, &RemoteAddr, buffer.data(), &length);
     if ((E_OK == ret) && (length > 0)) {
       doip_handle_udp_message(client, &RemoteAddr, buffer.data(), length);
     }
+  } while ((E_OK == ret) && (length > 0));
+}
+
+#ifndef DOIP_USE_EPOLL
+static void doip_daemon(void *arg) {
+  doip_client_t *client = (doip_client_t *)arg;
+  std::vector<uint8_t> buffer;
+  buffer.resize(4096);
+
+  ASLOG(DOIPI, ("DoIP Client request on %s:%d\n", client->ip, client->port));
+  while (false == client->stopped) {
+    doip_udp_poll(client, client->discovery, buffer);
+    doip_udp_poll(client, client->test_equipment_request, buffer);
     std::this_thread::sleep_for(1ms);
   }
 
   ASLOG(DOIPI, ("DoIP Client offline\n"));
 
   TcpIp_Close(client->discovery, TRUE);
+  TcpIp_Close(client->test_equipment_request, TRUE);
 }
+#endif
 
 static void doip_alive_check_request(struct doip_node_s *node) {
   Std_ReturnType ret;
@@ -482,75 +542,338 @@ static void node_tls_setup(struct doip_node_s *node) {
   }
 }
 
-static void node_daemon(void *arg) {
+static void node_async_complete(doip_async_req_t &req, int r, const uint8_t *data, size_t length) {
+  if (NULL != req.callback) {
+    req.callback(req.ctx, r, data, length);
+  }
+}
+
+/* send the oldest queued request to ta if nothing is in flight to it, node->lock must be held */
+static void node_async_kick(struct doip_node_s *node, uint16_t ta) {
   Std_ReturnType ret;
-  struct doip_node_s *node = (struct doip_node_s *)arg;
-  uint32_t length = 0;
-  uint32_t offset = 0;
-  uint32_t payloadLength = UINT16_MAX;
-  std::vector<uint8_t> buffer;
-  buffer.resize(4096);
 
-  if (node->client->casPem.size() > 0) {
-    node_tls_setup(node);
+  for (auto &req : node->asyncQ) {
+    if (req.ta == ta) {
+      if (false == req.sent) {
+        ret = TcpIp_TlsSend(node, req.data.data(), req.data.size());
+        if (E_OK == ret) {
+          req.sent = true;
+          Std_TimerStart(&req.timer);
+        } else {
+          ASLOG(DOIPE, ("send uds request to TA=%X failed: %d\n", ta, ret));
+          node->stopped = true;
+        }
+      }
+      break;
+    }
   }
+}
 
-  if (false == node->stopped) {
-    ASLOG(DOIPI, ("DoIP node online\n"));
-    node->connected = true;
-    Std_TimerStart(&node->alive_request_timer);
-    Std_TimerStart(&node->alive_timer);
+/* hand a diagnostic message or (n)ack over to the asynchronous request it answers, returns false
+ * if there is no such request so that the message goes to doip_transmit/doip_receive */
+static bool node_async_dispatch(struct doip_node_s *node, uint16_t payloadType, uint8_t *data,
+                                uint32_t length, int r) {
+  uint16_t sa = ((uint16_t)data[DOIP_HEADER_LENGTH] << 8) + data[DOIP_HEADER_LENGTH + 1];
+  uint8_t *uds = &data[DOIP_HEADER_LENGTH + 4];
+  doip_async_req_t req;
+  bool bDone = false;
+  std::unique_lock<std::mutex> lck(node->lock);
+
+  auto it = std::find_if(node->asyncQ.begin(), node->asyncQ.end(), [&](doip_async_req_t &rq) {
+    return rq.sent && (rq.ta == sa) && ((DOIP_DIAGNOSTIC_MESSAGE == payloadType) || !rq.acked);
+  });
+  if (it == node->asyncQ.end()) {
+    return false;
   }
-  node->sem.post();
-  while (false == node->stopped) {
-    if (offset < DOIP_HEADER_LENGTH) {
-      length = DOIP_HEADER_LENGTH - offset;
+
+  switch (payloadType) {
+  case DOIP_DIAGNOSTIC_MESSAGE_POSITIVE_ACK:
+    it->acked = true;
+    if (it->noReply) {
+      r = 0;
+      bDone = true;
+    }
+    break;
+  case DOIP_DIAGNOSTIC_MESSAGE_NEGATIVE_ACK:
+    bDone = true;
+    break;
+  default:
+    if ((r >= 3) && (0x7F == uds[0]) && (it->data[DOIP_HEADER_LENGTH + 4] != uds[1])) {
+      ASLOG(DOIPI, ("negative response with different request SID, check next message\n"));
+    } else if ((r >= 3) && (0x7F == uds[0]) && (0x78 == uds[2])) {
+      Std_TimerStart(&it->timer); /* response pending */
     } else {
-      length = payloadLength - (offset - DOIP_HEADER_LENGTH);
+      bDone = true;
     }
-    ret = TcpIp_TlsRecv(node, &buffer[offset], &length);
-    if ((E_OK == ret) && (length > 0)) {
-      ASLOG(DOIP, ("recv: %s\n", build_hexstring(&buffer[offset], length).c_str()));
-      offset += length;
-      if (offset >= DOIP_HEADER_LENGTH) {
-        if ((DOIP_PROTOCOL_VERSION == buffer[0]) && (buffer[0] = ((~buffer[1])) & 0xFF)) {
-          payloadLength = ((uint32_t)buffer[4] << 24) + ((uint32_t)buffer[5] << 16) +
-                          ((uint32_t)buffer[6] << 8) + buffer[7];
-        } else {
-          offset = 0;
-          ASLOG(DOIPE, ("invalid tcp message\n"));
+    break;
+  }
+
+  if (bDone) {
+    req = std::move(*it);
+    node->asyncQ.erase(it);
+    node_async_kick(node, req.ta);
+    lck.unlock();
+    if (r > 0) {
+      node_async_complete(req, r, uds, r);
+    } else {
+      node_async_complete(req, r, NULL, 0);
+    }
+  }
+
+  return true;
+}
+
+/* fail the requests without reply in time, returns the time until the next one expires */
+static std_time_t node_async_timer_poll(struct doip_node_s *node) {
+  std::vector<doip_async_req_t> expired;
+  std_time_t next = DOIP_UDS_TIMEOUT;
+  std_time_t elapsed;
+
+  {
+    std::unique_lock<std::mutex> lck(node->lock);
+    for (auto it = node->asyncQ.begin(); it != node->asyncQ.end();) {
+      if (it->sent) {
+        elapsed = Std_GetTimerElapsedTime(&it->timer);
+        if (elapsed >= DOIP_UDS_TIMEOUT) {
+          ASLOG(DOIPE, ("uds request to TA=%X timeout\n", it->ta));
+          expired.push_back(std::move(*it));
+          it = node->asyncQ.erase(it);
+          continue;
         }
+        next = std::min(next, DOIP_UDS_TIMEOUT - elapsed);
       }
-      if (offset >= (payloadLength + DOIP_HEADER_LENGTH)) {
-        doip_handle_tcp_response(node, buffer.data(), offset);
-        offset = 0;
-        payloadLength = UINT16_MAX;
-        Std_TimerStart(&node->alive_timer); /* as thre is response, restart alive timer */
-      } else {
-        /* wait a full DoIP message received */;
-      }
+      ++it;
     }
-    if (Std_GetTimerElapsedTime(&node->alive_request_timer) > DOIP_ALIVE_CHECK_TIME) {
-      doip_alive_check_request(node);
-      Std_TimerStart(&node->alive_request_timer);
+    for (auto &req : expired) {
+      node_async_kick(node, req.ta);
+    }
+  }
+
+  for (auto &req : expired) {
+    node_async_complete(req, DOIP_E_TIMEOUT, NULL, 0);
+  }
+
+  return next;
+}
+
+/* read what is available on the node socket and handle all the complete DoIP messages */
+static void node_rx_poll(struct doip_node_s *node) {
+  Std_ReturnType ret;
+  uint32_t length;
+  uint32_t offset;
+  uint32_t msgLength;
+
+  do {
+    if (node->rxLen == node->rxBuf.size()) {
+      /* the buffer is full with the head of one big message */
+      msgLength = doip_get_payload_length(node->rxBuf.data()) + DOIP_HEADER_LENGTH;
+      if (msgLength > DOIP_MAX_MESSAGE_LENGTH) {
+        ASLOG(DOIPE, ("message too long: %u\n", msgLength));
+        node->stopped = true;
+        break;
+      }
+      node->rxBuf.resize(msgLength);
     }
-    if (Std_GetTimerElapsedTime(&node->alive_timer) > DOIP_ALIVE_TIMEOUT) {
-      ASLOG(DOIPI, ("alive timer timeout, stop this node\n"));
+    length = node->rxBuf.size() - node->rxLen;
+    ret = TcpIp_TlsRecv(node, &node->rxBuf[node->rxLen], &length);
+    if (E_OK != ret) {
       node->stopped = true;
+    } else if (length > 0) {
+      ASLOG(DOIP, ("recv: %s\n", build_hexstring(&node->rxBuf[node->rxLen], length).c_str()));
+      node->rxLen += length;
+      offset = 0;
+      while ((node->rxLen - offset) >= DOIP_HEADER_LENGTH) {
+        if (false == doip_is_valid_header(&node->rxBuf[offset])) {
+          ASLOG(DOIPE, ("invalid tcp message\n"));
+          offset = node->rxLen;
+          break;
+        }
+        msgLength = doip_get_payload_length(&node->rxBuf[offset]) + DOIP_HEADER_LENGTH;
+        if ((node->rxLen - offset) < msgLength) {
+          break; /* wait a full DoIP message received */
+        }
+        doip_handle_tcp_response(node, &node->rxBuf[offset], msgLength);
+        offset += msgLength;
+        Std_TimerStart(&node->alive_timer); /* as thre is response, restart alive timer */
+      }
+      if (offset > 0) {
+        node->rxLen -= offset;
+        memmove(node->rxBuf.data(), &node->rxBuf[offset], node->rxLen);
+      }
+    } else {
+      /* nothing more to read */
     }
-    std::this_thread::sleep_for(1ms);
+  } while ((E_OK == ret) && (length > 0) && (false == node->stopped));
+}
+
+/* alive check and request timeout, returns the time until the next timer expires */
+static std_time_t node_timer_poll(struct doip_node_s *node) {
+  std_time_t next;
+  std_time_t elapsed;
+
+  elapsed = Std_GetTimerElapsedTime(&node->alive_request_timer);
+  if (elapsed > DOIP_ALIVE_CHECK_TIME) {
+    doip_alive_check_request(node);
+    Std_TimerStart(&node->alive_request_timer);
+    elapsed = 0;
   }
+  next = DOIP_ALIVE_CHECK_TIME - elapsed;
 
+  elapsed = Std_GetTimerElapsedTime(&node->alive_timer);
+  if (elapsed > DOIP_ALIVE_TIMEOUT) {
+    ASLOG(DOIPI, ("alive timer timeout, stop this node\n"));
+    node->stopped = true;
+  } else {
+    next = std::min(next, DOIP_ALIVE_TIMEOUT - elapsed);
+  }
+
+  return std::min(next, node_async_timer_poll(node));
+}
+
+static void node_online(struct doip_node_s *node) {
+  ASLOG(DOIPI, ("DoIP node online\n"));
+  node->rxBuf.resize(DOIP_RX_BUFFER_SIZE);
+  node->rxLen = 0;
+  node->connected = true;
+  Std_TimerStart(&node->alive_request_timer);
+  Std_TimerStart(&node->alive_timer);
+}
+
+static void node_offline(struct doip_node_s *node) {
+  std::deque<doip_async_req_t> asyncQ;
   {
     std::unique_lock<std::mutex> lck(node->lock);
     TcpIp_Close(node->sock, TRUE);
     node->connected = false;
     node->activated = false;
+    asyncQ.swap(node->asyncQ);
+  }
+
+  for (auto &req : asyncQ) {
+    node_async_complete(req, DOIP_E_NODEV, NULL, 0);
   }
 
   ASLOG(DOIPI, ("DoIP node offline\n"));
 }
 
+#ifdef DOIP_USE_EPOLL
+static void doip_reactor(void *arg) {
+  doip_client_t *client = (doip_client_t *)arg;
+  struct epoll_event events[DOIP_MAX_EVENTS];
+  std::vector<struct doip_node_s *> nodes;
+  struct doip_node_s *node;
+  std::vector<uint8_t> buffer;
+  std_time_t next;
+  uint64_t u64;
+  int timeout = 0;
+  int num;
+  int i;
+
+  buffer.resize(4096);
+
+  ASLOG(DOIPI, ("DoIP Client request on %s:%d\n", client->ip, client->port));
+  while (false == client->stopped) {
+    num = epoll_wait(client->epfd, events, DOIP_MAX_EVENTS, timeout);
+    for (i = 0; i < num; i++) {
+      void *ptr = events[i].data.ptr;
+      if (ptr == &client->evfd) {
+        (void)read(client->evfd, &u64, sizeof(u64));
+      } else if (ptr == &client->discovery) {
+        doip_udp_poll(client, client->discovery, buffer);
+      } else if (ptr == &client->test_equipment_request) {
+        doip_udp_poll(client, client->test_equipment_request, buffer);
+      } else {
+        node = (struct doip_node_s *)ptr;
+        node_rx_poll(node);
+        if (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+          ASLOG(DOIPI, ("connection closed by peer\n"));
+          node->stopped = true;
+        }
+      }
+    }
+
+    /* take a snapshot so that no client lock is held while calling back the user */
+    nodes.clear();
+    {
+      std::unique_lock<std::mutex> lck(client->lock);
+      STAILQ_FOREACH(node, &client->nodes, entry) {
+        if (node->connected) {
+          nodes.push_back(node);
+        }
+      }
+    }
+
+    next = (std_time_t)DOIP_MAX_WAIT_MS * 1000;
+    for (auto n : nodes) {
+      if (false == n->stopped) {
+        next = std::min(next, node_timer_poll(n));
+      }
+      if (n->stopped) {
+        epoll_ctl(client->epfd, EPOLL_CTL_DEL, n->sock, NULL);
+        node_offline(n);
+      }
+    }
+    timeout = (int)((next + 999) / 1000);
+  }
+
+  {
+    std::unique_lock<std::mutex> lck(client->lock);
+    nodes.clear();
+    STAILQ_FOREACH(node, &client->nodes, entry) {
+      if (node->connected) {
+        nodes.push_back(node);
+      }
+    }
+  }
+  for (auto n : nodes) {
+    n->stopped = true;
+    epoll_ctl(client->epfd, EPOLL_CTL_DEL, n->sock, NULL);
+    node_offline(n);
+  }
+
+  ASLOG(DOIPI, ("DoIP Client offline\n"));
+
+  TcpIp_Close(client->discovery, TRUE);
+  TcpIp_Close(client->test_equipment_request, TRUE);
+  close(client->epfd);
+  close(client->evfd);
+}
+
+static int doip_reactor_add(doip_client_t *client, int fd, void *ptr, uint32_t events) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = ptr;
+  return epoll_ctl(client->epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+#else
+static void node_daemon(void *arg) {
+  struct doip_node_s *node = (struct doip_node_s *)arg;
+
+  if (node->client->casPem.size() > 0) {
+    node_tls_setup(node);
+  }
+
+  if (false == node->stopped) {
+    node_online(node);
+  }
+  node->sem.post();
+  while (false == node->stopped) {
+    node_rx_poll(node);
+    if (false == node->stopped) {
+      (void)node_timer_poll(node);
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+
+  if (node->connected) {
+    node_offline(node);
+  } else {
+    TcpIp_Close(node->sock, TRUE);
+  }
+}
+#endif
+
 static int doip_handle_activate_response(struct doip_node_s *node, uint8_t *payload,
                                          uint32_t length) {
   int r = 0;
@@ -632,13 +955,12 @@ static int doip_handle_general_negative_ack(struct doip_node_s *node, uint8_t *p
   return r;
 }
 
-static void doip_handle_tcp_response(struct doip_node_s *node, uint8_t *data, uint16_t length) {
+/* data is one whole DoIP message, the rx loop splits the TCP stream at the message boundaries */
+static void doip_handle_tcp_response(struct doip_node_s *node, uint8_t *data, uint32_t length) {
   int r = 0;
   uint16_t payloadType = (uint16_t)-1;
   uint32_t payloadLength;
-  // TODO: the data possible contains multiply response
-  if ((length >= DOIP_HEADER_LENGTH) && (DOIP_PROTOCOL_VERSION == data[0]) &&
-      (data[0] = ((~data[1])) & 0xFF)) {
+  if ((length >= DOIP_HEADER_LENGTH) && doip_is_valid_header(data)) {
     payloadType = ((uint16_t)data[2] << 8) + data[3];
     payloadLength =
       ((uint32_t)data[4] << 24) + ((uint32_t)data[5] << 16) + ((uint32_t)data[6] << 8) + data[7];
@@ -703,13 +1025,18 @@ static void doip_handle_tcp_response(struct doip_node_s *node, uint8_t *data, ui
     default:
       break;
     }
-    std::unique_lock<std::mutex> lck(node->lock);
-    msg.payload_type = payloadType;
-    msg.result = r;
-    msg.data.resize(length);
-    memcpy(msg.data.data(), data, length);
-    node->msgQ[queType].push(msg);
-    node->condVarQ[queType].notify_one();
+    if ((DOIP_MSGQ_DEFAULT != queType) && (length >= (DOIP_HEADER_LENGTH + 4)) &&
+        node_async_dispatch(node, payloadType, data, length, r)) {
+      /* consumed by an asynchronous request */
+    } else {
+      std::unique_lock<std::mutex> lck(node->lock);
+      msg.payload_type = payloadType;
+      msg.result = r;
+      msg.data.resize(length);
+      memcpy(msg.data.data(), data, length);
+      node->msgQ[queType].push(msg);
+      node->condVarQ[queType].notify_one();
+    }
   }
 }
 
@@ -812,9 +1139,38 @@ doip_client_t *doip_create_client(const char *ip, int port, const char *casPem)
     }
   }
 
+#ifdef DOIP_USE_EPOLL
+  if (E_OK == ret) {
+    client->epfd = epoll_create1(EPOLL_CLOEXEC);
+    client->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((client->epfd < 0) || (client->evfd < 0) ||
+        (0 != doip_reactor_add(client, client->evfd, &client->evfd, EPOLLIN)) ||
+        (0 != doip_reactor_add(client, discovery, &client->discovery, EPOLLIN)) ||
+        (0 != doip_reactor_add(client, test_equipment_request, &client->test_equipment_request,
+                               EPOLLIN))) {
+      ASLOG(DOIPE, ("Failed to setup epoll: %d\n", errno));
+      if (client->epfd >= 0) {
+        close(client->epfd);
+      }
+      if (client->evfd >= 0) {
+        close(client->evfd);
+      }
+      TcpIp_Close(discovery, TRUE);
+      TcpIp_Close(test_equipment_request, TRUE);
+      delete client;
+      client = NULL;
+      ret = E_NOT_OK;
+    }
+  }
+
+  if (E_OK == ret) {
+    client->thread = std::thread(doip_reactor, (void *)client);
+  }
+#else
   if (E_OK == ret) {
     client->thread = std::thread(doip_daemon, (void *)client);
   }
+#endif
 
   return client;
 }
@@ -884,6 +1240,7 @@ int doip_connect(doip_node_t *node) {
   }
 
   if (0 == r) {
+    n->stopped = false;
     sockId = TcpIp_Create(TCPIP_IPPROTO_TCP);
     if (sockId >= 0) {
       ret = TcpIp_TcpConnect(sockId, &n->RemoteAddr);
@@ -898,11 +1255,29 @@ int doip_connect(doip_node_t *node) {
 
     if (E_OK == ret) {
       n->sock = sockId;
+#ifdef DOIP_USE_EPOLL
+      if (n->client->casPem.size() > 0) {
+        node_tls_setup(n);
+      }
+      if (false == n->stopped) {
+        node_online(n);
+        if (0 != doip_reactor_add(n->client, sockId, n, EPOLLIN | EPOLLRDHUP)) {
+          ASLOG(DOIPE, ("Failed to add node to epoll: %d\n", errno));
+          node_offline(n);
+        }
+      } else {
+        TcpIp_Close(sockId, TRUE);
+      }
+#else
+      if (n->thread.joinable()) {
+        n->thread.join(); /* the daemon of the last connection */
+      }
       n->thread = std::thread(node_daemon, (void *)n);
       n->sem.wait();
+#endif
       if (true != n->connected) {
         ASLOG(DOIPE, ("Failed to connect\n"));
-        ret = E_NOT_OK;
+        r = DOIP_E_NOT_OK;
       }
     } else {
       r = DOIP_E_NODEV;
@@ -1040,21 +1415,68 @@ int doip_receive(doip_node_t *node, uint8_t *rxBuffer, size_t rxSize) {
   return r;
 }
 
+int doip_transmit_async(doip_node_t *node, uint16_t ta, const uint8_t *txBuffer, size_t txSize,
+                        doip_callback_t callback, void *ctx) {
+  int r = 0;
+  struct doip_node_s *n = (struct doip_node_s *)node;
+  doip_async_req_t req;
+
+  ASLOG(DOIPI, ("async uds request to TA=%X: %s\n", ta, build_hexstring(txBuffer, txSize).c_str()));
+
+  if ((NULL == txBuffer) || (0 == txSize) ||
+      ((DOIP_HEADER_LENGTH + 4 + txSize) > DOIP_MAX_MESSAGE_LENGTH)) {
+    r = DOIP_E_INVAL;
+  } else if (false == n->activated) {
+    r = DOIP_E_AGAIN;
+  }
+
+  if (0 == r) {
+    req.ta = ta;
+    req.sent = false;
+    req.acked = false;
+    req.noReply = (2 == txSize) && (0x3E == txBuffer[0]) && (0x80 == txBuffer[1]);
+    req.callback = callback;
+    req.ctx = ctx;
+    req.data.resize(DOIP_HEADER_LENGTH + 4 + txSize);
+    doip_fill_header(req.data.data(), DOIP_DIAGNOSTIC_MESSAGE, 4 + txSize);
+    req.data[DOIP_HEADER_LENGTH] = (n->SA >> 8) & 0xFF;
+    req.data[DOIP_HEADER_LENGTH + 1] = n->SA & 0xFF;
+    req.data[DOIP_HEADER_LENGTH + 2] = (ta >> 8) & 0xFF;
+    req.data[DOIP_HEADER_LENGTH + 3] = ta & 0xFF;
+    memcpy(&req.data[DOIP_HEADER_LENGTH + 4], txBuffer, txSize);
+    std::unique_lock<std::mutex> lck(n->lock);
+    if (false == n->connected) {
+      r = DOIP_E_NODEV;
+    } else {
+      n->asyncQ.push_back(std::move(req));
+      node_async_kick(n, ta);
+    }
+  }
+
+  return r;
+}
+
 void doip_destory_client(doip_client_t *client) {
   struct doip_node_s *n;
   client->stopped = true;
+#ifdef DOIP_USE_EPOLL
+  uint64_t u64 = 1;
+  (void)write(client->evfd, &u64, sizeof(u64));
+#endif
   if (client->thread.joinable()) {
     client->thread.join();
   }
-  std::unique_lock<std::mutex> lck(client->lock);
-  while (false == STAILQ_EMPTY(&client->nodes)) {
-    n = STAILQ_FIRST(&client->nodes);
-    STAILQ_REMOVE_HEAD(&client->nodes, entry);
-    n->stopped = true;
-    if (n->thread.joinable()) {
-      n->thread.join();
+  {
+    std::unique_lock<std::mutex> lck(client->lock);
+    while (false == STAILQ_EMPTY(&client->nodes)) {
+      n = STAILQ_FIRST(&client->nodes);
+      STAILQ_REMOVE_HEAD(&client->nodes, entry);
+      n->stopped = true;
+      if (n->thread.joinable()) {
+        n->thread.join();
+      }
+      delete n;
     }
-    delete n;
   }
   delete client;
 }
@@ -0,0 +1,457 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * DoIP client benchmark against a set of local simulated DoIP entities: entity i listens on
+ * 127.0.0.(2+i) and announces itself to the client by a unicast VAN, every diagnostic request is
+ * acked at once and answered after the configured ECU processing delay.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "doip_client.h"
+/* ================================ [ MACROS    ] ============================================== */
+#define DOIP_HEADER_LENGTH 8
+#define DOIP_MAX_NODES 64
+/* ================================ [ TYPES     ] ============================================== */
+typedef std::chrono::steady_clock clock_type;
+
+typedef struct {
+  clock_type::time_point due;
+  std::vector<uint8_t> data;
+} sim_response_t;
+
+typedef struct {
+  int id;
+  int port;
+  uint32_t delayUs;
+  int listenFd;
+  std::atomic<bool> stopped;
+  std::thread thread;
+} sim_node_t;
+
+typedef struct bench_s bench_t;
+
+typedef struct {
+  bench_t *bench;
+  doip_node_t *node;
+  uint16_t ta;
+  int sent;
+  int done;
+  clock_type::time_point start;
+  uint8_t request[2];
+} bench_channel_t;
+
+struct bench_s {
+  int requests; /* per channel */
+  std::mutex lock;
+  std::condition_variable cond;
+  int finished;
+  int errors;
+  std::vector<double> latency; /* us */
+  std::vector<bench_channel_t> channels;
+};
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+static void usage(char *prog) {
+  printf("usage: %s [-N nodes] [-T target addresses per node] [-n requests per target] "
+         "[-d ECU delay us] [-p port] [-s sa] [-t first ta]\n",
+         prog);
+}
+
+static void fill_header(uint8_t *header, uint16_t payloadType, uint32_t payloadLength) {
+  header[0] = 2;
+  header[1] = ~2;
+  header[2] = (payloadType >> 8) & 0xFF;
+  header[3] = payloadType & 0xFF;
+  header[4] = (payloadLength >> 24) & 0xFF;
+  header[5] = (payloadLength >> 16) & 0xFF;
+  header[6] = (payloadLength >> 8) & 0xFF;
+  header[7] = payloadLength & 0xFF;
+}
+
+static std::vector<uint8_t> sim_message(uint16_t payloadType, const uint8_t *payload,
+                                        uint32_t length) {
+  std::vector<uint8_t> msg(DOIP_HEADER_LENGTH + length);
+  fill_header(msg.data(), payloadType, length);
+  if (length > 0) {
+    memcpy(&msg[DOIP_HEADER_LENGTH], payload, length);
+  }
+  return msg;
+}
+
+static void sim_send(int fd, const std::vector<uint8_t> &msg) {
+  size_t offset = 0;
+  while (offset < msg.size()) {
+    ssize_t n = send(fd, &msg[offset], msg.size() - offset, MSG_NOSIGNAL);
+    if (n <= 0) {
+      break;
+    }
+    offset += n;
+  }
+}
+
+static void sim_announce(sim_node_t *sim) {
+  struct sockaddr_in addr;
+  uint8_t payload[33];
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(0x7F000002 + sim->id);
+  bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+
+  memset(payload, 0, sizeof(payload));
+  snprintf((char *)payload, 18, "SIMULATEDVIN%05d", sim->id);
+  payload[17] = 0;
+  payload[18] = (uint8_t)(sim->id + 1);
+  payload[19 + 5] = (uint8_t)sim->id; /* EID */
+  std::vector<uint8_t> msg = sim_message(0x0004, payload, sizeof(payload));
+
+  addr.sin_addr.s_addr = htonl(0x7F000001);
+  addr.sin_port = htons(sim->port);
+  sendto(fd, msg.data(), msg.size(), 0, (struct sockaddr *)&addr, sizeof(addr));
+  close(fd);
+}
+
+static void sim_handle(sim_node_t *sim, int fd, const uint8_t *msg, uint32_t length,
+                       std::deque<sim_response_t> &pending) {
+  uint16_t payloadType = ((uint16_t)msg[2] << 8) + msg[3];
+  const uint8_t *payload = &msg[DOIP_HEADER_LENGTH];
+  uint8_t rsp[13];
+
+  switch (payloadType) {
+  case 0x0005: /* routing activation */
+    memset(rsp, 0, sizeof(rsp));
+    rsp[0] = payload[0];
+    rsp[1] = payload[1];
+    rsp[2] = 0;
+    rsp[3] = (uint8_t)(sim->id + 1);
+    rsp[4] = 0x10;
+    sim_send(fd, sim_message(0x0006, rsp, 9));
+    break;
+  case 0x0007: /* alive check request */
+    rsp[0] = 0;
+    rsp[1] = (uint8_t)(sim->id + 1);
+    sim_send(fd, sim_message(0x0008, rsp, 2));
+    break;
+  case 0x8001: { /* diagnostic message */
+    uint32_t udsLen = length - DOIP_HEADER_LENGTH - 4;
+    rsp[0] = payload[2];
+    rsp[1] = payload[3];
+    rsp[2] = payload[0];
+    rsp[3] = payload[1];
+    rsp[4] = 0x00;
+    sim_send(fd, sim_message(0x8002, rsp, 5));
+    std::vector<uint8_t> reply(4 + udsLen);
+    memcpy(reply.data(), rsp, 4);
+    memcpy(&reply[4], &payload[4], udsLen);
+    reply[4] = payload[4] + 0x40;
+    sim_response_t r;
+    r.due = clock_type::now() + std::chrono::microseconds(sim->delayUs);
+    r.data = sim_message(0x8001, reply.data(), reply.size());
+    pending.push_back(std::move(r));
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+static void sim_main(sim_node_t *sim) {
+  std::vector<uint8_t> buffer(8192);
+  std::deque<sim_response_t> pending;
+  size_t rxLen = 0;
+  int fd = -1;
+  int timeout;
+  int on = 1;
+
+  sim_announce(sim);
+
+  while (false == sim->stopped) {
+    struct pollfd pfd;
+    pfd.fd = (fd >= 0) ? fd : sim->listenFd;
+    pfd.events = POLLIN;
+    timeout = 100;
+    if (false == pending.empty()) {
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(pending.front().due -
+                                                                      clock_type::now())
+                  .count();
+      timeout = (us > 0) ? (int)((us + 999) / 1000) : 0;
+    }
+    if (poll(&pfd, 1, timeout) > 0) {
+      if (fd < 0) {
+        fd = accept(sim->listenFd, NULL, NULL);
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        continue;
+      }
+      ssize_t n = recv(fd, &buffer[rxLen], buffer.size() - rxLen, 0);
+      if (n <= 0) {
+        break;
+      }
+      rxLen += n;
+      size_t offset = 0;
+      while ((rxLen - offset) >= DOIP_HEADER_LENGTH) {
+        uint32_t length = DOIP_HEADER_LENGTH + (((uint32_t)buffer[offset + 4] << 24) +
+                                                ((uint32_t)buffer[offset + 5] << 16) +
+                                                ((uint32_t)buffer[offset + 6] << 8) +
+                                                buffer[offset + 7]);
+        if ((rxLen - offset) < length) {
+          break;
+        }
+        sim_handle(sim, fd, &buffer[offset], length, pending);
+        offset += length;
+      }
+      rxLen -= offset;
+      memmove(buffer.data(), &buffer[offset], rxLen);
+    }
+    auto now = clock_type::now();
+    while ((false == pending.empty()) && (pending.front().due <= now)) {
+      sim_send(fd, pending.front().data);
+      pending.pop_front();
+    }
+  }
+
+  if (fd >= 0) {
+    close(fd);
+  }
+  close(sim->listenFd);
+}
+
+static int sim_start(sim_node_t *sim) {
+  struct sockaddr_in addr;
+  int on = 1;
+
+  sim->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  setsockopt(sim->listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(0x7F000002 + sim->id);
+  addr.sin_port = htons(sim->port);
+  if ((0 != bind(sim->listenFd, (struct sockaddr *)&addr, sizeof(addr))) ||
+      (0 != listen(sim->listenFd, 1))) {
+    printf("simulated node %d: failed to listen on 127.0.0.%d:%d\n", sim->id, 2 + sim->id,
+           sim->port);
+    close(sim->listenFd);
+    return -1;
+  }
+  sim->stopped = false;
+  sim->thread = std::thread(sim_main, sim);
+  return 0;
+}
+
+static void bench_report(const char *name, bench_t *bench, double seconds) {
+  std::vector<double> &lat = bench->latency;
+  double sum = 0;
+  std::sort(lat.begin(), lat.end());
+  for (auto l : lat) {
+    sum += l;
+  }
+  if (lat.empty()) {
+    printf("%-6s: no response, %d errors\n", name, bench->errors);
+    return;
+  }
+  printf("%-6s: %zu requests in %.3f s, %.0f req/s, latency us avg %.0f p50 %.0f p99 %.0f max "
+         "%.0f, %d errors\n",
+         name, lat.size(), seconds, lat.size() / seconds, sum / lat.size(), lat[lat.size() / 2],
+         lat[(lat.size() * 99) / 100], lat.back(), bench->errors);
+}
+
+static double elapsed_us(clock_type::time_point start) {
+  return std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+}
+
+static void bench_sync(bench_t *bench) {
+  uint8_t rsp[64];
+  auto start = clock_type::now();
+  for (int i = 0; i < bench->requests; i++) {
+    for (auto &ch : bench->channels) {
+      auto t0 = clock_type::now();
+      int r = doip_transmit(ch.node, ch.ta, ch.request, sizeof(ch.request), rsp, sizeof(rsp));
+      if (r > 0) {
+        bench->latency.push_back(elapsed_us(t0));
+      } else {
+        bench->errors++;
+      }
+    }
+  }
+  bench_report("sync", bench, elapsed_us(start) / 1e6);
+}
+
+static void bench_on_response(void *ctx, int result, const uint8_t *data, size_t length);
+
+static void bench_channel_next(bench_channel_t *ch) {
+  int r;
+  ch->start = clock_type::now();
+  ch->sent++;
+  r = doip_transmit_async(ch->node, ch->ta, ch->request, sizeof(ch->request), bench_on_response,
+                          ch);
+  if (0 != r) {
+    bench_on_response(ch, r, NULL, 0);
+  }
+}
+
+static void bench_on_response(void *ctx, int result, const uint8_t *data, size_t length) {
+  bench_channel_t *ch = (bench_channel_t *)ctx;
+  bench_t *bench = ch->bench;
+  double us = elapsed_us(ch->start);
+  bool bNext;
+  {
+    std::unique_lock<std::mutex> lck(bench->lock);
+    if (result > 0) {
+      bench->latency.push_back(us);
+    } else {
+      bench->errors++;
+    }
+    ch->done++;
+    bNext = (ch->sent < bench->requests);
+    if (false == bNext) {
+      bench->finished++;
+      bench->cond.notify_one();
+    }
+  }
+  if (bNext) {
+    bench_channel_next(ch);
+  }
+}
+
+static void bench_async(bench_t *bench) {
+  auto start = clock_type::now();
+  bench->finished = 0;
+  for (auto &ch : bench->channels) {
+    ch.sent = 0;
+    ch.done = 0;
+  }
+  for (auto &ch : bench->channels) {
+    bench_channel_next(&ch);
+  }
+  {
+    std::unique_lock<std::mutex> lck(bench->lock);
+    bench->cond.wait(lck, [bench]() { return bench->finished == (int)bench->channels.size(); });
+  }
+  bench_report("async", bench, elapsed_us(start) / 1e6);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  int ch;
+  int numOfNodes = 4;
+  int numOfTargets = 1;
+  int port = 13400;
+  uint32_t delayUs = 1000;
+  uint16_t sa = 0xbeef;
+  uint16_t ta = 0x0001;
+  doip_client_t *client;
+  doip_node_t *nodes[DOIP_MAX_NODES];
+  static sim_node_t sims[DOIP_MAX_NODES];
+  bench_t bench;
+  int i, j, n;
+
+  bench.requests = 1000;
+  bench.errors = 0;
+
+  opterr = 0;
+  while ((ch = getopt(argc, argv, "d:hn:N:p:s:t:T:")) != -1) {
+    switch (ch) {
+    case 'd':
+      delayUs = strtoul(optarg, NULL, 10);
+      break;
+    case 'h':
+      usage(argv[0]);
+      return 0;
+      break;
+    case 'n':
+      bench.requests = atoi(optarg);
+      break;
+    case 'N':
+      numOfNodes = std::min(atoi(optarg), DOIP_MAX_NODES);
+      break;
+    case 'p':
+      port = atoi(optarg);
+      break;
+    case 's':
+      sa = strtoul(optarg, NULL, 16);
+      break;
+    case 't':
+      ta = strtoul(optarg, NULL, 16);
+      break;
+    case 'T':
+      numOfTargets = atoi(optarg);
+      break;
+    default:
+      break;
+    }
+  }
+
+  client = doip_create_client("224.244.224.245", port, NULL);
+  if (NULL == client) {
+    printf("failed to create doip client\n");
+    return -1;
+  }
+
+  for (i = 0; i < numOfNodes; i++) {
+    sims[i].id = i;
+    sims[i].port = port;
+    sims[i].delayUs = delayUs;
+    if (0 != sim_start(&sims[i])) {
+      return -1;
+    }
+  }
+
+  auto t0 = clock_type::now();
+  do {
+    usleep(10000);
+    n = doip_await_vehicle_announcement(client, nodes, numOfNodes, 100);
+  } while ((n < numOfNodes) && (elapsed_us(t0) < 3e6));
+  if (n < numOfNodes) {
+    printf("only %d of %d simulated nodes announced\n", n, numOfNodes);
+    return -1;
+  }
+  n = doip_await_vehicle_announcement(client, nodes, numOfNodes, 0);
+
+  for (i = 0; i < numOfNodes; i++) {
+    if ((0 != doip_connect(nodes[i])) || (0 != doip_activate(nodes[i], sa, 0, NULL, 0))) {
+      printf("failed to connect/activate node %d\n", i);
+      return -1;
+    }
+    for (j = 0; j < numOfTargets; j++) {
+      bench_channel_t c;
+      c.bench = &bench;
+      c.node = nodes[i];
+      c.ta = ta + j;
+      c.request[0] = 0x22;
+      c.request[1] = (uint8_t)j;
+      bench.channels.push_back(c);
+    }
+  }
+
+  printf("%d nodes x %d targets, %d requests each, ECU delay %u us\n", numOfNodes, numOfTargets,
+         bench.requests, delayUs);
+  bench_sync(&bench);
+  bench.latency.clear();
+  bench.errors = 0;
+  bench_async(&bench);
+
+  doip_destory_client(client);
+  for (i = 0; i < numOfNodes; i++) {
+    sims[i].stopped = true;
+    sims[i].thread.join();
+  }
+
+  return 0;
+}
@@ -3,9 +3,9 @@
  * Copyright (C) 2024 Parai Wang <parai@foxmail.com>
  */
 /* ================================ [ INCLUDES  ] ============================================== */
-#include "J1939Tp_Priv.h"
 #include "J1939Tp.h"
 #include "J1939Tp_Cfg.h"
+#include "J1939Tp_Priv.h"
 #include "CanIf_Cfg.h"
 /* ================================ [ MACROS    ] ============================================== */
 #define J1939TP_NUM_PDU_PER_CHANNEL 4
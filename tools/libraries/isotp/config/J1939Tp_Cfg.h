@@ -11,6 +11,8 @@ extern "C" {
 #endif
 /* ================================ [ MACROS    ] ============================================== */
 #define J1939TP_MAIN_FUNCTION_PERIOD 10
+#define J1939TP_USE_STD_TIMER
+#define J1939TP_DT_BURST_MAX 16
 #define J1939TP_CONVERT_MS_TO_MAIN_CYCLES(x)                                                       \
   ((x + J1939TP_MAIN_FUNCTION_PERIOD - 1) / J1939TP_MAIN_FUNCTION_PERIOD)
 /* ================================ [ TYPES     ] ============================================== */
@@ -32,7 +32,7 @@ typedef struct {
   uint32_t TxCanId;
   isotp_can_version_t version;
   uint8_t BlockSize;
-  uint8_t STmin; /* ms */
+  uint8_t STmin; /* as FC.STmin: 0x00-0x7F in ms, 0xF1-0xF9 for 100-900 us */
 } isotp_can_param_t;
 
 typedef struct {
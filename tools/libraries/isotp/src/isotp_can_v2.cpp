@@ -9,7 +9,10 @@
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <time.h>
+#include <errno.h>
 #include <vector>
+#include <algorithm>
 #include "Std_Debug.h"
 /* ================================ [ MACROS    ] ============================================== */
 #ifndef CANTP_MAX_CHANNELS
@@ -35,7 +38,77 @@
 #define N_PCI_SN 0x0Fu
 
 #define PDU_LENGTH_MAX (0xFFFFUL)
+
+/* max number of CFs prepared at once when the receiver allows an unlimited block */
+#define ISOTP_CF_BATCH 64
+
+/* the OS sleep ends this much before the deadline and the rest is spun, covering the timer slack
+ * and the wakeup latency */
+#if defined(_WIN32)
+#define ISOTP_SPIN_US 2000
+#else
+#define ISOTP_SPIN_US 100
+#endif
 /* ================================ [ TYPES     ] ============================================== */
+/* Keep the separation time between 2 CFs with microsecond precision */
+class StMinPacer {
+public:
+  typedef std::chrono::steady_clock clock;
+
+  /* ISO 15765-2: 0x00-0x7F in ms, 0xF1-0xF9 in 100us, the reserved values are handled as 0x7F */
+  static std::chrono::microseconds decode(uint8_t STmin) {
+    std::chrono::microseconds us;
+    if (STmin <= 0x7Fu) {
+      us = std::chrono::microseconds((uint32_t)STmin * 1000u);
+    } else if ((STmin >= 0xF1u) && (STmin <= 0xF9u)) {
+      us = std::chrono::microseconds((uint32_t)(STmin - 0xF0u) * 100u);
+    } else {
+      us = std::chrono::microseconds(0x7Fu * 1000u);
+    }
+    return us;
+  }
+
+  void setSTmin(uint8_t STmin) {
+    m_gap = decode(STmin);
+  }
+
+  /* a frame was just sent, the next one is due one STmin later */
+  void mark() {
+    m_last = clock::now();
+  }
+
+  void wait() {
+    if (m_gap.count() > 0) {
+      sleepUntil(m_last + m_gap);
+    }
+  }
+
+private:
+  static void sleepUntil(clock::time_point deadline) {
+    clock::time_point wake = deadline - std::chrono::microseconds(ISOTP_SPIN_US);
+    if (clock::now() < wake) {
+#if defined(__linux__)
+      /* steady_clock is CLOCK_MONOTONIC, an absolute sleep does not drift on EINTR */
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wake.time_since_epoch());
+      struct timespec ts;
+      ts.tv_sec = (time_t)(ns.count() / 1000000000);
+      ts.tv_nsec = (long)(ns.count() % 1000000000);
+      while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {
+      }
+#else
+      std::this_thread::sleep_until(wake);
+#endif
+    }
+    while (clock::now() < deadline) {
+      /* spin the tail */
+    }
+  }
+
+private:
+  std::chrono::microseconds m_gap{0};
+  clock::time_point m_last;
+};
+
 class IsotpCanV2 {
 public:
   IsotpCanV2(isotp_t *isotp, int busid) : m_isotp(isotp), m_busid(busid) {
@@ -61,10 +134,13 @@ public:
       memcpy(&m_txBuffer[0], txBuffer, txSize);
       r = sendFF();
       m_waitFirstFC = true;
+      m_WftCounter = 0;
       m_SN = 1;
-      r = waitFC();
+      if (0 == r) {
+        r = waitFC();
+      }
       while ((0 == r) && (m_offset < txSize)) {
-        r = sendCF();
+        r = sendBlock();
       }
     }
 
@@ -164,13 +240,16 @@ private:
     case N_PCI_CTS:
       if (length < 2u) {
         ASLOG(ISOTPE, ("[%d]FC invalid DLC.\n", m_isotp->Channel));
+        r = -EINVAL;
       } else {
         if (true == m_waitFirstFC) {
           m_waitFirstFC = false;
           m_cfgBS = data[0];
           m_STmin = data[1];
+          m_pacer.setSTmin(m_STmin);
         }
         m_BS = m_cfgBS;
+        m_WftCounter = 0;
       }
       break;
     case N_PCI_WT:
@@ -180,7 +259,7 @@ private:
       if (m_WftCounter > m_RxWftMax) {
         r = -ETXTBSY;
       } else {
-        r = 0; /* wait more */
+        r = -EAGAIN; /* wait the next FC */
       }
       break;
     case N_PCI_OVFLW:
@@ -234,6 +313,14 @@ private:
   }
 
   int waitFC() {
+    int r;
+    do {
+      r = waitOneFC();
+    } while (-EAGAIN == r);
+    return r;
+  }
+
+  int waitOneFC() {
     int r = 0;
     uint32_t canid = m_isotp->params.U.CAN.RxCanId;
     bool ok = can_wait_v2(m_busid, canid, m_timeoutMs);
@@ -255,54 +342,75 @@ private:
     return r;
   }
 
-  int sendCF() {
-    int r = 0;
-    std::vector<uint8_t> data;
-    size_t pos = 0;
-    data.resize(m_LL_DL, m_padding);
+  /* prepare the CFs of the block, up to the BS of the receiver, in one go */
+  size_t buildCFs() {
+    size_t num = 0;
+    size_t maxNum = (m_BS > 0) ? m_BS : ISOTP_CF_BATCH;
+    size_t offset = m_offset;
 
-    if (isExtendedAddressing()) {
-      data[pos] = (uint8_t)m_N_TA;
-      pos++;
+    if (m_frames.size() < maxNum) {
+      m_frames.resize(maxNum);
     }
 
-    data[pos] = N_PCI_CF | m_SN;
-    pos++;
-    m_SN++;
-    if (m_SN > 15u) {
-      m_SN = 0u;
+    while ((num < maxNum) && (offset < m_txBuffer.size())) {
+      can_frame_t &frame = m_frames[num];
+      size_t pos = 0;
+      memset(frame.data, m_padding, m_LL_DL);
+      if (isExtendedAddressing()) {
+        frame.data[pos] = (uint8_t)m_N_TA;
+        pos++;
+      }
+      frame.data[pos] = N_PCI_CF | m_SN;
+      pos++;
+      m_SN++;
+      if (m_SN > 15u) {
+        m_SN = 0u;
+      }
+      size_t bufferSize = m_LL_DL - pos;
+      if (bufferSize > (m_txBuffer.size() - offset)) {
+        bufferSize = m_txBuffer.size() - offset;
+      }
+      memcpy(&frame.data[pos], &m_txBuffer[offset], bufferSize);
+      pos += bufferSize;
+      offset += bufferSize;
+      frame.dlc = (uint8_t)getDL(pos);
+      num++;
     }
 
-    size_t bufferSize = m_LL_DL - pos;
-    if (bufferSize > (m_txBuffer.size() - m_offset)) {
-      bufferSize = m_txBuffer.size() - m_offset;
+    return num;
+  }
+
+  /* send the CFs of one block back to back, each one paced STmin after the previous, the first
+   * one goes at once as it follows the FC */
+  int sendBlock() {
+    int r = 0;
+    size_t num = buildCFs();
+    size_t i;
+
+    for (i = 0; (i < num) && (0 == r); i++) {
+      if (i > 0) {
+        m_pacer.wait();
+      }
+      r = sendFrame(m_frames[i].data, m_frames[i].dlc);
+      m_pacer.mark();
+      if (0 == r) {
+        m_offset += std::min(getCFMaxLen(), m_txBuffer.size() - m_offset);
+      } else {
+        r = -EIO;
+      }
     }
 
-    memcpy(&data[pos], &m_txBuffer[m_offset], bufferSize);
-    pos += bufferSize;
-    m_offset += bufferSize;
-    size_t dl = getDL(pos);
-    r = sendFrame(&data[0], dl);
-    if (0 == r) {
-      if (m_offset < m_txBuffer.size()) {
-        uint8_t stMin = m_STmin;
-        if (m_BS > 0) {
-          m_BS--;
-          if (0 == m_BS) {
-            r = waitFC();
-            if (0 == r) {
-              m_BS = m_cfgBS;
-              stMin = 0;
-            }
-          }
-        }
-        if (stMin > 0) {
-          std::this_thread::sleep_for(std::chrono::milliseconds(stMin));
+    if ((0 == r) && (m_offset < m_txBuffer.size())) {
+      if (m_BS > 0) {
+        m_BS -= (uint8_t)num;
+        if (0 == m_BS) {
+          r = waitFC();
         }
+      } else {
+        m_pacer.wait(); /* the next batch of an unlimited block */
       }
-    } else {
-      r = -EIO;
     }
+
     return r;
   }
 
@@ -380,9 +488,9 @@ private:
     }
 
     if ((m_LL_DL > 8u) && (0u == TpSduLength)) {
-      TpSduLength = ((uint32_t)data[2] << 24) + ((uint32_t)data[3] << 16) +
-                    ((uint32_t)data[4] << 8) + ((uint32_t)data[5]);
-      SduDataPtr = &data[6];
+      TpSduLength = ((uint32_t)data[1] << 24) + ((uint32_t)data[2] << 16) +
+                    ((uint32_t)data[3] << 8) + ((uint32_t)data[4]);
+      SduDataPtr = &data[5];
       SduLength -= 4u;
       ffLen -= 4u;
     }
@@ -403,6 +511,7 @@ private:
       memcpy(&m_rxBuffer[0], SduDataPtr, SduLength);
       m_offset = ffLen;
       m_SN = 1;
+      m_rxBS = m_isotp->params.U.CAN.BlockSize;
       r = sendFC();
     } else {
       ASLOG(ISOTPE, ("[%d]FF received with invalid len %d(!=%d)!\n", m_isotp->Channel,
@@ -445,6 +554,13 @@ private:
         r = (int)m_rxBuffer.size();
       } else {
         r = 0;
+        if (m_rxBS > 0) {
+          m_rxBS--;
+          if (0 == m_rxBS) { /* block done, let the sender go on */
+            m_rxBS = m_isotp->params.U.CAN.BlockSize;
+            r = sendFC();
+          }
+        }
       }
     }
 
@@ -538,6 +654,10 @@ private:
     return sfMaxLen;
   }
 
+  size_t getCFMaxLen() const {
+    return isExtendedAddressing() ? (m_LL_DL - 2u) : (m_LL_DL - 1u);
+  }
+
   size_t getDL(size_t len) {
     size_t dl = m_LL_DL;
     uint32_t i;
@@ -565,11 +685,14 @@ private:
   uint32_t m_timeoutMs = ISOTP_DEFAULT_TIMEOUT;
   uint8_t m_cfgBS = 0;
   uint8_t m_BS = 0;
+  uint8_t m_rxBS = 0;
   uint8_t m_STmin = 0;
   uint8_t m_WftCounter = 0;
   uint8_t m_RxWftMax = 100;
   uint8_t m_SN;
   bool m_waitFirstFC;
+  std::vector<can_frame_t> m_frames;
+  StMinPacer m_pacer;
 };
 /* ================================ [ DECLARES  ] ============================================== */
 int isotp_can_v2_receive(isotp_t *isotp, uint8_t *rxBuffer, size_t rxSize);
@@ -0,0 +1,277 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * CAN ISO-TP v2 throughput: a child process receives with the given FC.BS and FC.STmin, the
+ * parent sends and compares the achieved bytes/s with the one allowed by STmin.
+ *
+ * With -j BAM or -j CMDT the same is done over J1939Tp, STmin is then the DT gap of the sender in
+ * ms and BS the max packets per CTS window.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <vector>
+#include "isotp.h"
+#include "canlib.h"
+/* ================================ [ MACROS    ] ============================================== */
+/* 255 DT packets of 7 bytes */
+#define J1939TP_MAX_SIZE 1785
+/* ================================ [ TYPES     ] ============================================== */
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+static void usage(char *prog) {
+  printf("usage: %s [-d device] [-p port] [-s STmin] [-b BS] [-n size] [-c count] [-l LL_DL]"
+         " [-j BAM|CMDT]\n"
+         "\tSTmin: FC.STmin byte, 0x00-0x7F ms or 0xF1-0xF9 for 100-900 us, default 0xF5\n"
+         "\t       for J1939Tp the DT gap in ms, default 50\n",
+         prog);
+}
+
+static uint32_t toU32(const char *strV) {
+  return strtoul(strV, NULL, 0);
+}
+
+static uint32_t stmin_to_us(uint8_t STmin) {
+  uint32_t us;
+  if (STmin <= 0x7F) {
+    us = (uint32_t)STmin * 1000;
+  } else if ((STmin >= 0xF1) && (STmin <= 0xF9)) {
+    us = (uint32_t)(STmin - 0xF0) * 100;
+  } else {
+    us = 127000;
+  }
+  return us;
+}
+
+static void setup(isotp_parameter_t *params, const char *device, int port, int ll_dl,
+                  uint32_t rxid, uint32_t txid, uint8_t BS, uint8_t STmin) {
+  memset(params, 0, sizeof(isotp_parameter_t));
+  strncpy(params->device, device, sizeof(params->device) - 1);
+  params->port = port;
+  params->baudrate = 500000;
+  params->protocol = ISOTP_OVER_CAN;
+  params->ll_dl = ll_dl;
+  params->N_TA = 0xFFFF;
+  params->U.CAN.RxCanId = rxid;
+  params->U.CAN.TxCanId = txid;
+  params->U.CAN.BlockSize = BS;
+  params->U.CAN.STmin = STmin;
+  params->U.CAN.version = ISOTP_CAN_V2;
+}
+
+/* the receiver listens on the TX ids of the sender and sends the CTS on its FC id, the ids of the
+ * other direction are the isotp_send defaults */
+static void setup_j1939tp(isotp_parameter_t *params, const char *device, int port, bool sender,
+                          isotp_j1939tp_protocal_t protocol, uint8_t BS, uint8_t STMin) {
+  const uint32_t txCM = 0x17ECFFE8, txDT = 0x17EBFFE8, txDirect = 0x17FECAE8, txFC = 0x17ECFFE9;
+  const uint32_t rxCM = 0x18ECFFE8, rxDT = 0x18EBFFE8, rxDirect = 0x18FECAE8, rxFC = 0x18ECFFE9;
+
+  memset(params, 0, sizeof(isotp_parameter_t));
+  strncpy(params->device, device, sizeof(params->device) - 1);
+  params->port = port;
+  params->baudrate = 500000;
+  params->protocol = ISOTP_OVER_J1939TP;
+  params->ll_dl = 8;
+  params->N_TA = 0xFFFF;
+  if (sender) {
+    params->U.J1939TP.TX.CM = txCM | CAN_ID_EXTENDED;
+    params->U.J1939TP.TX.DT = txDT | CAN_ID_EXTENDED;
+    params->U.J1939TP.TX.Direct = txDirect | CAN_ID_EXTENDED;
+    params->U.J1939TP.TX.FC = txFC;
+    params->U.J1939TP.RX.CM = rxCM;
+    params->U.J1939TP.RX.DT = rxDT;
+    params->U.J1939TP.RX.Direct = rxDirect;
+    params->U.J1939TP.RX.FC = rxFC | CAN_ID_EXTENDED;
+  } else {
+    params->U.J1939TP.TX.CM = rxCM | CAN_ID_EXTENDED;
+    params->U.J1939TP.TX.DT = rxDT | CAN_ID_EXTENDED;
+    params->U.J1939TP.TX.Direct = rxDirect | CAN_ID_EXTENDED;
+    params->U.J1939TP.TX.FC = rxFC;
+    params->U.J1939TP.RX.CM = txCM;
+    params->U.J1939TP.RX.DT = txDT;
+    params->U.J1939TP.RX.Direct = txDirect;
+    params->U.J1939TP.RX.FC = txFC | CAN_ID_EXTENDED;
+  }
+  params->U.J1939TP.protocol = protocol;
+  params->U.J1939TP.PgPGN = 0xFE00;
+  params->U.J1939TP.STMin = STMin;
+  params->U.J1939TP.Tr = 200;
+  params->U.J1939TP.T1 = 750;
+  params->U.J1939TP.T2 = 1250;
+  params->U.J1939TP.T3 = 1250;
+  params->U.J1939TP.T4 = 1050;
+  params->U.J1939TP.TxMaxPacketsPerBlock = (0 == BS) ? 0xFF : BS;
+}
+
+static int receiver(isotp_parameter_t *params, size_t size, int count) {
+  std::vector<uint8_t> buffer(size);
+  int received = 0;
+  isotp_t *isotp = isotp_create(params);
+  if (NULL == isotp) {
+    printf("receiver: failed to create isotp\n");
+    return -1;
+  }
+  while (received < count) {
+    int r = isotp_receive(isotp, buffer.data(), buffer.size());
+    if (r == (int)size) {
+      received++;
+    } else if (r < 0) {
+      printf("receiver: error %d after %d messages\n", r, received);
+      break;
+    }
+  }
+  isotp_destory(isotp);
+  return (received == count) ? 0 : -1;
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  int ch;
+  const char *device = "simulator_v2";
+  int port = 0;
+  uint8_t STmin = 0xF5;
+  uint8_t BS = 0;
+  size_t size = 4095;
+  int count = 10;
+  int ll_dl = 8;
+  int status = 0;
+  int sent = 0;
+  bool j1939tp = false;
+  bool sizeSet = false;
+  bool STminSet = false;
+  isotp_j1939tp_protocal_t jprotocol = ISOTP_J1939TP_PROTOCOL_CMDT;
+  isotp_parameter_t params;
+
+  opterr = 0;
+  while ((ch = getopt(argc, argv, "b:c:d:hj:l:n:p:s:")) != -1) {
+    switch (ch) {
+    case 'b':
+      BS = (uint8_t)toU32(optarg);
+      break;
+    case 'c':
+      count = (int)toU32(optarg);
+      break;
+    case 'd':
+      device = optarg;
+      break;
+    case 'j':
+      j1939tp = true;
+      if (0 == strncmp("BAM", optarg, 3)) {
+        jprotocol = ISOTP_J1939TP_PROTOCOL_BAM;
+      } else if (0 == strncmp("CMDT", optarg, 4)) {
+        jprotocol = ISOTP_J1939TP_PROTOCOL_CMDT;
+      } else {
+        usage(argv[0]);
+        return -1;
+      }
+      break;
+    case 'l':
+      ll_dl = (int)toU32(optarg);
+      break;
+    case 'n':
+      size = toU32(optarg);
+      sizeSet = true;
+      break;
+    case 'p':
+      port = atoi(optarg);
+      break;
+    case 's':
+      STmin = (uint8_t)toU32(optarg);
+      STminSet = true;
+      break;
+    case 'h':
+    default:
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  if (j1939tp) {
+    if (false == STminSet) {
+      STmin = 50;
+    }
+    if ((false == sizeSet) || (size > J1939TP_MAX_SIZE)) {
+      size = J1939TP_MAX_SIZE;
+    }
+    ll_dl = 8;
+  }
+
+  pid_t pid = fork();
+  if (0 == pid) {
+    if (j1939tp) {
+      setup_j1939tp(&params, device, port, false, jprotocol, BS, STmin);
+    } else {
+      setup(&params, device, port, ll_dl, 0x731, 0x732, BS, STmin);
+    }
+    return receiver(&params, size, count);
+  }
+
+  if (j1939tp) {
+    setup_j1939tp(&params, device, port, true, jprotocol, BS, STmin);
+  } else {
+    setup(&params, device, port, ll_dl, 0x732, 0x731, 0, 0);
+  }
+  isotp_t *isotp = isotp_create(&params);
+  if (NULL == isotp) {
+    printf("sender: failed to create isotp\n");
+    return -1;
+  }
+  usleep(500000); /* let the receiver be ready */
+
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = (uint8_t)i;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (sent = 0; sent < count; sent++) {
+    int r = isotp_transmit(isotp, data.data(), data.size(), NULL, 0);
+    if (0 != r) {
+      printf("sender: error %d after %d messages\n", r, sent);
+      break;
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  waitpid(pid, &status, 0);
+  isotp_destory(isotp);
+
+  if (j1939tp) {
+    /* BAM paces every DT by STmin, CMDT sends the CTS windows as fast as the bus allows */
+    size_t numDT = (size + 6) / 7;
+    printf("%d x %zu bytes, J1939Tp %s, packets per block %d, STmin %d ms, %zu DTs per message\n",
+           sent, size, (ISOTP_J1939TP_PROTOCOL_BAM == jprotocol) ? "BAM" : "CMDT",
+           params.U.J1939TP.TxMaxPacketsPerBlock, STmin, numDT);
+    if ((sent > 0) && (seconds > 0)) {
+      printf("achieved    : %.0f bytes/s, %.2f ms per DT\n", sent * size / seconds,
+             seconds * 1e3 / (sent * numDT));
+    }
+    if ((ISOTP_J1939TP_PROTOCOL_BAM == jprotocol) && (STmin > 0)) {
+      printf("theoretical : %.0f bytes/s (STmin bound)\n", size / (numDT * STmin / 1e3));
+    }
+    return ((sent == count) && (0 == status)) ? 0 : -1;
+  }
+
+  /* the first CF follows the FF/FC at once, then every CF is STmin after the previous one */
+  size_t ffLen = (size > 4095) ? (ll_dl - 6) : (ll_dl - 2);
+  size_t cfLen = ll_dl - 1;
+  size_t numCF = (size - ffLen + cfLen - 1) / cfLen;
+  size_t numBlocks = (BS > 0) ? ((numCF + BS - 1) / BS) : 1;
+  double gaps = (double)(numCF - numBlocks) * stmin_to_us(STmin) / 1e6;
+
+  printf("%d x %zu bytes, LL_DL %d, BS %d, STmin 0x%02X (%u us), %zu CFs per message\n", sent,
+         size, ll_dl, BS, STmin, stmin_to_us(STmin), numCF);
+  if ((sent > 0) && (seconds > 0)) {
+    printf("achieved    : %.0f bytes/s, %.1f us per CF\n", sent * size / seconds,
+           seconds * 1e6 / (sent * numCF));
+  }
+  if (gaps > 0) {
+    printf("theoretical : %.0f bytes/s (STmin bound)\n", size / gaps);
+  }
+
+  return ((sent == count) && (0 == status)) ? 0 : -1;
+}
@@ -1,108 +1,848 @@
 /**
  * SSAS - Simple Smart Automotive Software
  * Copyright (C) 2022 Parai Wang <parai@foxmail.com>
+ *
+ * The document is mapped and scanned once by a streaming reader which only follows the path
+ * ODX/FLASH/ECU-MEMS/ECU-MEM/MEM/FLASHDATAS/FLASHDATA, the hex text of each DATA is decoded
+ * straight into one output arena big enough for the whole document, so there is no DOM and no
+ * allocation per block. After a complete parse the block table and the arena are saved as the
+ * sidecar "<path>.odxc" with the layout below, which is then mapped as is by the next open:
+ *   odx_cache_header_t | odx_cache_mem_t[] | odx_cache_block_t[] | names | data (64 aligned)
+ * The sidecar is only used if the size, the mtime in ns and the inode of the document are the ones
+ * it was saved for and the hash of the document is the same, as a rewrite of the same size within
+ * the mtime granularity of the file system keeps the stat of the document.
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include <stdio.h>
 #include <stdlib.h>
+#include <deque>
 #include <vector>
 #include <string>
+#include <sys/stat.h>
 #include "odx.h"
-#include "tinyxml2.h"
 #include "string.h"
-
-using namespace tinyxml2;
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 /* ================================ [ MACROS    ] ============================================== */
+#define ODX_CACHE_MAGIC "ODXC0002"
+#define ODX_CACHE_SUFFIX ".odxc"
+#define ODX_CACHE_ALIGN 64
+
+/* the value of matched when the element at this level of odxPath is open */
+#define ODX_LEVEL_ECU_MEM 4
+#define ODX_LEVEL_FLASHDATA 7
+
+#define ODX_HASH_PRIME 0x9E3779B97F4A7C15ull
+
+#if defined(_WIN32)
+#define ODX_ST_MTIME_NS(st) 0
+#elif defined(__APPLE__)
+#define ODX_ST_MTIME_NS(st) (st).st_mtimespec.tv_nsec
+#else
+#define ODX_ST_MTIME_NS(st) (st).st_mtim.tv_nsec
+#endif
 /* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint64_t size;
+  int64_t mtime;   /* s */
+  int64_t mtimeNs; /* the ns within the second, 0 if the system doesn't have it */
+  uint64_t inode;  /* 0 if the system doesn't have it */
+} odx_stat_t;
+
+typedef struct {
+  char magic[8];
+  odx_stat_t src;
+  uint64_t srcHash;
+  uint32_t numOfMems;
+  uint32_t numOfBlocks;
+  uint64_t namesOffset;
+  uint64_t dataOffset;
+  uint64_t dataSize;
+} odx_cache_header_t;
+
+typedef struct {
+  uint32_t name; /* offset in names */
+  uint32_t numOfBlocks;
+} odx_cache_mem_t;
+
+typedef struct {
+  uint32_t name; /* offset in names */
+  uint32_t reserved;
+  uint64_t offset; /* offset in data */
+  uint64_t size;
+} odx_cache_block_t;
+
+typedef struct {
+  const char *data;
+  size_t size;
+  bool mapped;
+} odx_map_t;
+
+struct odx_reader_s {
+  std::string path;
+  odx_map_t src;
+  odx_map_t cache;
+  odx_stat_t srcStat;
+  /* the scanner */
+  const char *p;
+  const char *end;
+  int depth;
+  int matched;
+  bool inName;
+  bool inData;
+  bool hasName;
+  bool hasData;
+  bool badData;
+  int carry; /* the high nibble of the byte being decoded, -1 if none */
+  std::string name;
+  bool memValid;
+  bool done;
+  bool error;
+  /* the decoded data of all the blocks */
+  uint8_t *arena;
+  size_t arenaSize;
+  size_t used;
+  size_t dataStart;
+  bool arenaMapped;
+  /* the results, deque to keep the addresses stable while growing */
+  std::deque<std::string> names;
+  std::deque<odx_block_t> blocks;
+  std::deque<odx_mem_t> mems;
+  std::deque<std::vector<odx_block_t *>> memBlocks;
+  std::deque<const char *> blockMems;
+  size_t next;
+};
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
+static const char *const odxPath[] = {
+  "ODX", "FLASH", "ECU-MEMS", "ECU-MEM", "MEM", "FLASHDATAS", "FLASHDATA",
+};
+
+static const int8_t hexLut[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
 /* ================================ [ LOCALS    ] ============================================== */
-template <typename T> static XMLElement *odx_find(T *root, std::vector<std::string> where) {
-  XMLElement *next = root->FirstChildElement(where[0].c_str());
+static bool odx_map_open(odx_map_t *map, const char *path, odx_stat_t *info) {
+  struct stat st;
+  bool ok = false;
+  FILE *fp;
+  void *data = nullptr;
+
+  map->data = nullptr;
+  map->size = 0;
+  map->mapped = false;
+  if ((0 == stat(path, &st)) && (st.st_size > 0)) {
+    map->size = (size_t)st.st_size;
+    info->size = (uint64_t)st.st_size;
+    info->mtime = (int64_t)st.st_mtime;
+    info->mtimeNs = (int64_t)ODX_ST_MTIME_NS(st);
+    info->inode = (uint64_t)st.st_ino;
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+      data = mmap(nullptr, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (MAP_FAILED == data) {
+        data = nullptr;
+      } else {
+        (void)madvise(data, map->size, MADV_SEQUENTIAL);
+        map->mapped = true;
+      }
+      close(fd);
+    }
+#endif
+    if (nullptr == data) {
+      /* no mapping on this system, read it */
+      data = malloc(map->size);
+      fp = fopen(path, "rb");
+      if ((nullptr != data) && (nullptr != fp) && (1 != fread(data, map->size, 1, fp))) {
+        free(data);
+        data = nullptr;
+      }
+      if (nullptr != fp) {
+        fclose(fp);
+      }
+    }
+    if (nullptr != data) {
+      map->data = (const char *)data;
+      ok = true;
+    }
+  }
 
-  for (size_t i = 1; (i < where.size()) && (nullptr != next); i++) {
-    next = next->FirstChildElement(where[i].c_str());
+  return ok;
+}
+
+static void odx_map_close(odx_map_t *map) {
+  if (nullptr != map->data) {
+#ifndef _WIN32
+    if (map->mapped) {
+      munmap((void *)map->data, map->size);
+    } else
+#endif
+    {
+      free((void *)map->data);
+    }
   }
+  map->data = nullptr;
+  map->size = 0;
+}
 
-  if (nullptr == next) {
-    std::string path = "";
-    for (auto &s : where) {
-      path += "/" + s;
+/* 4 lanes of 8 bytes, so that the hash of the document costs far less than decoding its hex */
+static uint64_t odx_hash(const char *data, size_t size) {
+  uint64_t lanes[4] = {size, ODX_HASH_PRIME, ~(uint64_t)size, ~ODX_HASH_PRIME};
+  uint64_t word, h;
+  size_t i, n;
+
+  for (i = 0; (i + 32) <= size; i += 32) {
+    for (n = 0; n < 4; n++) {
+      memcpy(&word, &data[i + n * 8], sizeof(word));
+      lanes[n] = (lanes[n] ^ word) * ODX_HASH_PRIME;
+      lanes[n] ^= lanes[n] >> 29;
     }
-    printf("ERROR: has no %s\n", path.c_str());
   }
 
-  return next;
+  h = lanes[0] ^ (lanes[1] * 3) ^ (lanes[2] * 5) ^ (lanes[3] * 7);
+  for (; i < size; i++) {
+    h = (h ^ (uint8_t)data[i]) * ODX_HASH_PRIME;
+  }
+  h ^= h >> 32;
+
+  return h;
 }
 
-/* ================================ [ FUNCTIONS ] ============================================== */
-extern "C" {
-odx_t *odx_open(const char *path) {
-  odx_t *odx = nullptr;
-  XMLDocument doc;
-  std::vector<odx_mem_t *> mems;
-  XMLElement *ecu_mem_ = nullptr;
-  auto ret = doc.LoadFile(path);
-  if (XML_SUCCESS != ret) {
-    printf("ERROR: failed to load odx %s, error is %d\n", path, ret);
+static bool odx_cache_enabled(void) {
+  const char *env = getenv("ODX_CACHE");
+
+  return !((nullptr != env) && (0 == strcmp(env, "NO")));
+}
+
+static bool odx_cache_load(odx_reader_t *reader) {
+  odx_map_t *map = &reader->cache;
+  const odx_cache_header_t *header;
+  const odx_cache_mem_t *mems;
+  const odx_cache_block_t *blocks;
+  const char *names;
+  uint64_t namesSize;
+  odx_stat_t st;
+  uint64_t tables;
+  uint32_t i, j, b = 0;
+  bool ok = odx_map_open(map, (reader->path + ODX_CACHE_SUFFIX).c_str(), &st);
+
+  if (ok && (map->size < sizeof(odx_cache_header_t))) {
+    ok = false;
+  }
+
+  if (ok) {
+    header = (const odx_cache_header_t *)map->data;
+    tables = sizeof(odx_cache_header_t) + (uint64_t)header->numOfMems * sizeof(odx_cache_mem_t) +
+             (uint64_t)header->numOfBlocks * sizeof(odx_cache_block_t);
+    if ((0 != memcmp(header->magic, ODX_CACHE_MAGIC, sizeof(header->magic))) ||
+        (0 != memcmp(&header->src, &reader->srcStat, sizeof(header->src))) ||
+        (tables > header->namesOffset) || (header->namesOffset > header->dataOffset) ||
+        ((header->dataOffset + header->dataSize) > map->size)) {
+      ok = false;
+    }
+  }
+
+  if (ok && (header->srcHash != odx_hash(reader->src.data, reader->src.size))) {
+    ok = false;
+  }
+
+  if (ok) {
+    mems = (const odx_cache_mem_t *)&header[1];
+    blocks = (const odx_cache_block_t *)&mems[header->numOfMems];
+    names = map->data + header->namesOffset;
+    namesSize = header->dataOffset - header->namesOffset;
+    for (i = 0; (i < header->numOfMems) && ok; i++) {
+      if (mems[i].name >= namesSize) {
+        ok = false;
+        break;
+      }
+      reader->mems.push_back({(char *)&names[mems[i].name], nullptr, 0});
+      reader->memBlocks.emplace_back();
+      for (j = 0; (j < mems[i].numOfBlocks) && ok; j++, b++) {
+        if ((b >= header->numOfBlocks) || (blocks[b].name >= namesSize) ||
+            ((blocks[b].offset + blocks[b].size) > header->dataSize)) {
+          ok = false;
+        } else {
+          reader->blocks.push_back({(char *)&names[blocks[b].name],
+                                    (uint8_t *)map->data + header->dataOffset + blocks[b].offset,
+                                    (size_t)blocks[b].size});
+          reader->memBlocks.back().push_back(&reader->blocks.back());
+          reader->blockMems.push_back(reader->mems.back().name);
+        }
+      }
+    }
+  }
+
+  if (ok) {
+    reader->done = true;
+  } else {
+    reader->mems.clear();
+    reader->memBlocks.clear();
+    reader->blocks.clear();
+    reader->blockMems.clear();
+    odx_map_close(map);
+  }
+
+  return ok;
+}
+
+static void odx_cache_save(odx_reader_t *reader) {
+  std::string path = reader->path + ODX_CACHE_SUFFIX;
+  std::string tmp = path + ".tmp";
+  std::vector<odx_cache_mem_t> mems;
+  std::vector<odx_cache_block_t> blocks;
+  std::string names;
+  odx_cache_header_t header;
+  static const uint8_t padding[ODX_CACHE_ALIGN] = {0};
+  size_t pad;
+  bool ok;
+  FILE *fp;
+
+  for (size_t i = 0; i < reader->mems.size(); i++) {
+    mems.push_back({(uint32_t)names.size(), (uint32_t)reader->memBlocks[i].size()});
+    names.append(reader->mems[i].name).push_back('\0');
+    for (auto block : reader->memBlocks[i]) {
+      blocks.push_back({(uint32_t)names.size(), 0, (uint64_t)(block->data - reader->arena),
+                        (uint64_t)block->size});
+      names.append(block->name).push_back('\0');
+    }
+  }
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, ODX_CACHE_MAGIC, sizeof(header.magic));
+  header.src = reader->srcStat;
+  header.srcHash = odx_hash(reader->src.data, reader->src.size);
+  header.numOfMems = (uint32_t)mems.size();
+  header.numOfBlocks = (uint32_t)blocks.size();
+  header.namesOffset = sizeof(header) + mems.size() * sizeof(odx_cache_mem_t) +
+                       blocks.size() * sizeof(odx_cache_block_t);
+  header.dataOffset = (header.namesOffset + names.size() + ODX_CACHE_ALIGN - 1) &
+                      ~(uint64_t)(ODX_CACHE_ALIGN - 1);
+  header.dataSize = reader->used;
+  pad = (size_t)(header.dataOffset - header.namesOffset - names.size());
+
+  fp = fopen(tmp.c_str(), "wb");
+  if (nullptr != fp) {
+    ok = (1 == fwrite(&header, sizeof(header), 1, fp));
+    ok = ok && (1 == fwrite(mems.data(), mems.size() * sizeof(odx_cache_mem_t), 1, fp));
+    ok = ok && (1 == fwrite(blocks.data(), blocks.size() * sizeof(odx_cache_block_t), 1, fp));
+    ok = ok && (1 == fwrite(names.data(), names.size(), 1, fp));
+    ok = ok && ((0 == pad) || (1 == fwrite(padding, pad, 1, fp)));
+    ok = ok && ((0 == reader->used) || (1 == fwrite(reader->arena, reader->used, 1, fp)));
+    ok = (0 == fclose(fp)) && ok;
+    (void)remove(path.c_str()); /* rename doesn't replace on windows */
+    if ((false == ok) || (0 != rename(tmp.c_str(), path.c_str()))) {
+      (void)remove(tmp.c_str());
+    }
+  }
+}
+
+static bool odx_arena_alloc(odx_reader_t *reader) {
+  void *arena = nullptr;
+
+  /* the hex text decodes to at most half of the document, plus the slack of a 16 chars step */
+  reader->arenaSize = (reader->src.size / 2) + 16;
+#ifndef _WIN32
+  arena = mmap(nullptr, reader->arenaSize, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (MAP_FAILED == arena) {
+    arena = nullptr;
   } else {
-    ecu_mem_ = odx_find(&doc, {"ODX", "FLASH", "ECU-MEMS", "ECU-MEM"});
-  }
-
-  while (nullptr != ecu_mem_) {
-    const char *sid = nullptr;
-    ret = ecu_mem_->QueryStringAttribute("ID", &sid);
-    if ((XML_SUCCESS == ret) && (nullptr != sid)) {
-      std::vector<odx_block_t *> blocks;
-      XMLElement *flash_data_ = odx_find(ecu_mem_, {"MEM", "FLASHDATAS", "FLASHDATA"});
-      while (nullptr != flash_data_) {
-        auto its_name = flash_data_->FirstChildElement("SHORT-NAME");
-        auto its_data = flash_data_->FirstChildElement("DATA");
-        if ((nullptr != its_name) && (nullptr != its_data)) {
-          auto name = its_name->GetText();
-          auto data = its_data->GetText();
-          odx_block_t *block = new odx_block_t;
-          block->name = strdup(name);
-          size_t len = strlen(data) / 2;
-          block->data = new uint8_t[len];
-          block->size = len;
-          char txt[3] = {0, 0, 0};
-          for (size_t i = 0; i < len; i++) {
-            txt[0] = data[2 * i];
-            txt[1] = data[2 * i + 1];
-            block->data[i] = strtoul(txt, nullptr, 16);
-          }
-          blocks.push_back(block);
+    reader->arenaMapped = true;
+  }
+#endif
+  if (nullptr == arena) {
+    arena = malloc(reader->arenaSize);
+  }
+  reader->arena = (uint8_t *)arena;
+
+  return (nullptr != arena);
+}
+
+static void odx_arena_free(odx_reader_t *reader) {
+  if (nullptr != reader->arena) {
+#ifndef _WIN32
+    if (reader->arenaMapped) {
+      munmap(reader->arena, reader->arenaSize);
+    } else
+#endif
+    {
+      free(reader->arena);
+    }
+  }
+  reader->arena = nullptr;
+}
+
+#if defined(__SSE2__)
+/* 16 hex chars to 8 bytes, returns -1 if any of them is not a hex digit */
+static int odx_hex_decode16(const char *hex, uint8_t *dst) {
+  __m128i v = _mm_loadu_si128((const __m128i *)hex);
+  __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+  __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  __m128i nibble = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                                _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+  /* each 16 bits lane has the high nibble in its low byte and the low nibble in its high byte */
+  __m128i hi = _mm_slli_epi16(_mm_and_si128(nibble, _mm_set1_epi16(0x00FF)), 4);
+  __m128i lo = _mm_srli_epi16(nibble, 8);
+
+  _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(_mm_or_si128(hi, lo), _mm_setzero_si128()));
+
+  return (0xFFFF == _mm_movemask_epi8(_mm_or_si128(digit, alpha))) ? 0 : -1;
+}
+#endif
+
+/* the DATA text may be split by white spaces, a byte may even be split by them */
+static void odx_hex_decode(odx_reader_t *reader, const char *text, size_t len) {
+  uint8_t *dst = reader->arena + reader->used;
+  size_t i = 0;
+  int v;
+  char c;
+
+  while ((i < len) && (false == reader->badData)) {
+#if defined(__SSE2__)
+    if (reader->carry < 0) {
+      while (((i + 16) <= len) && (0 == odx_hex_decode16(&text[i], dst))) {
+        i += 16;
+        dst += 8;
+      }
+    }
+#endif
+    for (; (i < len) && (false == reader->badData); i++) {
+      c = text[i];
+      v = hexLut[(uint8_t)c];
+      if (v >= 0) {
+        if (reader->carry < 0) {
+          reader->carry = v;
         } else {
-          printf("ERROR: %s found FLASHDATA either has no SHORT-NAME or DATA\n", path);
+          *dst++ = (uint8_t)((reader->carry << 4) | v);
+          reader->carry = -1;
+          i++;
+          break; /* back to the 16 chars step */
         }
-        flash_data_ = flash_data_->NextSiblingElement("FLASHDATA");
+      } else if ((' ' == c) || ('\t' == c) || ('\r' == c) || ('\n' == c)) {
+      } else {
+        reader->badData = true;
       }
-      if (blocks.size() > 0) {
-        odx_mem_t *mem = new odx_mem_t;
-        mem->name = strdup(sid);
-        mem->blocks = new odx_block_t *[blocks.size()];
-        for (size_t i = 0; i < blocks.size(); i++) {
-          mem->blocks[i] = blocks[i];
+    }
+  }
+
+  reader->used = dst - reader->arena;
+}
+
+static void odx_append_name(odx_reader_t *reader, const char *text, size_t len, bool raw) {
+  static const struct {
+    const char *entity;
+    char c;
+  } entities[] = {{"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&apos;", '\''}};
+  size_t i, j, n;
+
+  for (i = 0; i < len; i++) {
+    if ((false == raw) && ('&' == text[i])) {
+      for (j = 0; j < sizeof(entities) / sizeof(entities[0]); j++) {
+        n = strlen(entities[j].entity);
+        if (((i + n) <= len) && (0 == strncmp(&text[i], entities[j].entity, n))) {
+          reader->name.push_back(entities[j].c);
+          i += n - 1;
+          break;
         }
-        mem->numOfBlocks = blocks.size();
-        mems.push_back(mem);
+      }
+      if (j < sizeof(entities) / sizeof(entities[0])) {
+        continue;
+      }
+    }
+    reader->name.push_back(text[i]);
+  }
+}
+
+static void odx_text(odx_reader_t *reader, const char *text, size_t len, bool raw) {
+  if (reader->inData) {
+    odx_hex_decode(reader, text, len);
+  } else if (reader->inName) {
+    odx_append_name(reader, text, len, raw);
+  } else {
+    /* not interested */
+  }
+}
+
+/* the value of the attribute ID of the tag */
+static bool odx_get_id(const char *attrs, const char *end, std::string &id) {
+  const char *p = attrs;
+  const char *name;
+  const char *value;
+  size_t len;
+  char quote;
+  bool found = false;
+
+  while ((p < end) && (false == found)) {
+    while ((p < end) && ((' ' == *p) || ('\t' == *p) || ('\r' == *p) || ('\n' == *p))) {
+      p++;
+    }
+    name = p;
+    while ((p < end) && ('=' != *p) && (' ' != *p) && ('\t' != *p) && ('\r' != *p) &&
+           ('\n' != *p)) {
+      p++;
+    }
+    len = p - name;
+    while ((p < end) && ('"' != *p) && ('\'' != *p)) {
+      p++;
+    }
+    if (p < end) {
+      quote = *p++;
+      value = p;
+      while ((p < end) && (quote != *p)) {
+        p++;
+      }
+      if ((2 == len) && (0 == strncmp(name, "ID", 2))) {
+        id.assign(value, p - value);
+        found = true;
+      }
+      p++;
+    }
+  }
+
+  return found;
+}
+
+static void odx_start_mem(odx_reader_t *reader, const char *attrs, const char *end) {
+  std::string id;
+
+  reader->memValid = odx_get_id(attrs, end, id);
+  if (reader->memValid) {
+    reader->names.push_back(id);
+    reader->mems.push_back({(char *)reader->names.back().c_str(), nullptr, 0});
+    reader->memBlocks.emplace_back();
+  } else {
+    printf("ERROR: %s found ECU-MEM has no ID\n", reader->path.c_str());
+  }
+}
+
+static void odx_end_mem(odx_reader_t *reader) {
+  if (reader->memValid && reader->memBlocks.back().empty()) {
+    printf("ERROR: %s empty FLASHDATAS\n", reader->path.c_str());
+    reader->mems.pop_back();
+    reader->memBlocks.pop_back();
+  }
+  reader->memValid = false;
+}
+
+static void odx_start_block(odx_reader_t *reader) {
+  reader->hasName = false;
+  reader->hasData = false;
+  reader->badData = false;
+  reader->name.clear();
+  reader->dataStart = reader->used;
+}
+
+/* returns true if a block is ready */
+static bool odx_end_block(odx_reader_t *reader) {
+  bool ready = false;
+
+  if ((false == reader->hasName) || (false == reader->hasData)) {
+    printf("ERROR: %s found FLASHDATA either has no SHORT-NAME or DATA\n", reader->path.c_str());
+  } else if (reader->badData) {
+    printf("ERROR: %s FLASHDATA %s has invalid hex DATA\n", reader->path.c_str(),
+           reader->name.c_str());
+  } else if (reader->memValid) {
+    reader->names.push_back(reader->name);
+    reader->blocks.push_back({(char *)reader->names.back().c_str(),
+                              reader->arena + reader->dataStart, reader->used - reader->dataStart});
+    reader->memBlocks.back().push_back(&reader->blocks.back());
+    reader->blockMems.push_back(reader->mems.back().name);
+    ready = true;
+  } else {
+    /* the ECU-MEM is ignored */
+  }
+
+  if (false == ready) {
+    reader->used = reader->dataStart;
+  }
+
+  return ready;
+}
+
+/* returns true if a block is ready */
+static bool odx_end_element(odx_reader_t *reader) {
+  bool ready = false;
+
+  if (reader->depth <= 0) {
+    reader->error = true;
+  } else if ((reader->matched == reader->depth) && (reader->matched > 0)) {
+    if (ODX_LEVEL_FLASHDATA == reader->matched) {
+      ready = odx_end_block(reader);
+    } else if (ODX_LEVEL_ECU_MEM == reader->matched) {
+      odx_end_mem(reader);
+    } else {
+    }
+    reader->matched--;
+  } else {
+    reader->inName = false;
+    reader->inData = false;
+    reader->carry = -1; /* an odd number of hex digits, the last one is ignored */
+  }
+  reader->depth--;
+
+  return ready;
+}
+
+static void odx_start_element(odx_reader_t *reader, const char *name, size_t len,
+                              const char *attrs, const char *end) {
+  reader->depth++;
+  if ((reader->matched == (reader->depth - 1)) && (reader->matched < ODX_LEVEL_FLASHDATA) &&
+      (len == strlen(odxPath[reader->matched])) &&
+      (0 == strncmp(name, odxPath[reader->matched], len))) {
+    reader->matched = reader->depth;
+    if (ODX_LEVEL_ECU_MEM == reader->matched) {
+      odx_start_mem(reader, attrs, end);
+    } else if (ODX_LEVEL_FLASHDATA == reader->matched) {
+      odx_start_block(reader);
+    } else {
+    }
+  } else if ((ODX_LEVEL_FLASHDATA == reader->matched) &&
+             ((ODX_LEVEL_FLASHDATA + 1) == reader->depth)) {
+    if ((10 == len) && (0 == strncmp(name, "SHORT-NAME", len))) {
+      reader->inName = true;
+      reader->hasName = true;
+      reader->name.clear();
+    } else if ((4 == len) && (0 == strncmp(name, "DATA", len))) {
+      reader->inData = true;
+      reader->hasData = true;
+      reader->carry = -1;
+    } else {
+    }
+  } else {
+  }
+}
+
+static const char *odx_find(const char *p, const char *end, const char *what) {
+  size_t len = strlen(what);
+  const char *found = nullptr;
+
+  while ((nullptr == found) && ((p + len) <= end)) {
+    p = (const char *)memchr(p, what[0], end - p);
+    if ((nullptr == p) || ((p + len) > end)) {
+      break;
+    }
+    if (0 == memcmp(p, what, len)) {
+      found = p;
+    } else {
+      p++;
+    }
+  }
+
+  return found;
+}
+
+/* the tag at reader->p, returns true if a block is ready */
+static bool odx_tag(odx_reader_t *reader) {
+  const char *p = reader->p;
+  const char *end = reader->end;
+  const char *e = nullptr;
+  const char *name;
+  size_t len;
+  bool ready = false;
+  char quote = 0;
+
+  if ((p + 1) >= end) {
+  } else if ('?' == p[1]) {
+    e = odx_find(p, end, "?>");
+    e = (nullptr != e) ? e + 2 : nullptr;
+  } else if (((p + 4) <= end) && (0 == strncmp(p, "<!--", 4))) {
+    e = odx_find(p + 4, end, "-->");
+    e = (nullptr != e) ? e + 3 : nullptr;
+  } else if (((p + 9) <= end) && (0 == strncmp(p, "<![CDATA[", 9))) {
+    e = odx_find(p + 9, end, "]]>");
+    if (nullptr != e) {
+      odx_text(reader, p + 9, e - (p + 9), true);
+      e += 3;
+    }
+  } else if ('!' == p[1]) {
+    e = (const char *)memchr(p, '>', end - p);
+    e = (nullptr != e) ? e + 1 : nullptr;
+  } else {
+    /* find the end of the tag, a '>' in the quoted attribute values doesn't count */
+    for (e = p + 1; e < end; e++) {
+      if (0 != quote) {
+        if (quote == *e) {
+          quote = 0;
+        }
+      } else if (('"' == *e) || ('\'' == *e)) {
+        quote = *e;
+      } else if ('>' == *e) {
+        break;
+      } else {
+      }
+    }
+    if (e < end) {
+      name = ('/' == p[1]) ? (p + 2) : (p + 1);
+      for (len = 0; ((name + len) < e) && ('/' != name[len]) && (' ' != name[len]) &&
+                    ('\t' != name[len]) && ('\r' != name[len]) && ('\n' != name[len]);
+           len++) {
+      }
+      if ('/' == p[1]) {
+        ready = odx_end_element(reader);
+      } else {
+        odx_start_element(reader, name, len, name + len, e);
+        if ('/' == e[-1]) {
+          ready = odx_end_element(reader);
+        }
+      }
+      e++;
+    } else {
+      e = nullptr;
+    }
+  }
+
+  if (nullptr == e) {
+    reader->error = true;
+  } else {
+    reader->p = e;
+  }
+
+  return ready;
+}
+
+/* parse until the next block is ready or the end of the document */
+static void odx_parse(odx_reader_t *reader) {
+  const char *lt;
+  bool ready = false;
+
+  while ((false == ready) && (false == reader->done) && (false == reader->error)) {
+    lt = (const char *)memchr(reader->p, '<', reader->end - reader->p);
+    if (nullptr == lt) {
+      reader->p = reader->end;
+      reader->done = true;
+      if (0 != reader->depth) {
+        reader->error = true;
+      } else if (reader->blocks.empty()) {
+        printf("ERROR: %s has no ODX/FLASH/ECU-MEMS/ECU-MEM/MEM/FLASHDATAS/FLASHDATA\n",
+               reader->path.c_str());
+      } else if (odx_cache_enabled()) {
+        odx_cache_save(reader);
       } else {
-        printf("ERROR: %s empty FLASHDATAS\n", path);
       }
     } else {
-      printf("ERROR: %s found ECU-MEM has no ID\n", path);
+      if (lt > reader->p) {
+        odx_text(reader, reader->p, lt - reader->p, false);
+      }
+      reader->p = lt;
+      ready = odx_tag(reader);
+    }
+  }
+
+  if (reader->error) {
+    printf("ERROR: failed to load odx %s, malformed at offset %llu\n", reader->path.c_str(),
+           (unsigned long long)(reader->p - reader->src.data));
+    reader->done = true;
+  }
+}
+
+/* ================================ [ FUNCTIONS ] ============================================== */
+extern "C" {
+odx_reader_t *odx_reader_open(const char *path) {
+  odx_reader_t *reader = new odx_reader_t();
+  bool ok;
+
+  reader->path = path;
+  reader->carry = -1;
+  ok = odx_map_open(&reader->src, path, &reader->srcStat);
+  if (false == ok) {
+    printf("ERROR: failed to load odx %s\n", path);
+  } else if (odx_cache_enabled() && odx_cache_load(reader)) {
+    /* the document is not needed any more */
+    odx_map_close(&reader->src);
+  } else {
+    ok = odx_arena_alloc(reader);
+    reader->p = reader->src.data;
+    reader->end = reader->src.data + reader->src.size;
+  }
+
+  if (false == ok) {
+    odx_reader_close(reader);
+    reader = nullptr;
+  }
+
+  return reader;
+}
+
+const odx_block_t *odx_reader_next(odx_reader_t *reader, const char **mem) {
+  const odx_block_t *block = nullptr;
+
+  if (reader->next >= reader->blocks.size()) {
+    odx_parse(reader);
+  }
+
+  if ((reader->next < reader->blocks.size()) && (false == reader->error)) {
+    block = &reader->blocks[reader->next];
+    if (nullptr != mem) {
+      *mem = reader->blockMems[reader->next];
     }
-    ecu_mem_ = ecu_mem_->NextSiblingElement("ECU-MEM");
+    reader->next++;
   }
 
-  if (mems.size() > 0) {
-    odx = new odx_t;
-    odx->mems = new odx_mem_t *[mems.size()];
-    for (size_t i = 0; i < mems.size(); i++) {
-      odx->mems[i] = mems[i];
+  return block;
+}
+
+int odx_reader_error(const odx_reader_t *reader) {
+  return reader->error ? -1 : 0;
+}
+
+void odx_reader_close(odx_reader_t *reader) {
+  odx_map_close(&reader->src);
+  odx_map_close(&reader->cache);
+  odx_arena_free(reader);
+  delete reader;
+}
+
+odx_t *odx_open(const char *path) {
+  odx_t *odx = nullptr;
+  odx_reader_t *reader = odx_reader_open(path);
+
+  if (nullptr != reader) {
+    while (nullptr != odx_reader_next(reader, nullptr)) {
+    }
+    if ((0 == odx_reader_error(reader)) && (reader->mems.size() > 0)) {
+      odx = new odx_t;
+      odx->mems = new odx_mem_t *[reader->mems.size()];
+      for (size_t i = 0; i < reader->mems.size(); i++) {
+        auto mem = &reader->mems[i];
+        auto &blocks = reader->memBlocks[i];
+        mem->blocks = new odx_block_t *[blocks.size()];
+        for (size_t j = 0; j < blocks.size(); j++) {
+          mem->blocks[j] = blocks[j];
+        }
+        mem->numOfBlocks = blocks.size();
+        odx->mems[i] = mem;
+      }
+      odx->numOfMems = reader->mems.size();
+      odx->reader = reader;
+    } else {
+      odx_reader_close(reader);
     }
-    odx->numOfMems = mems.size();
   }
 
   return odx;
@@ -110,17 +850,10 @@ odx_t *odx_open(const char *path) {
 
 void odx_close(odx_t *odx) {
   for (size_t i = 0; i < odx->numOfMems; i++) {
-    auto mem = odx->mems[i];
-    for (size_t j = 0; j < mem->numOfBlocks; j++) {
-      auto block = mem->blocks[j];
-      delete[] block->data;
-      free(block->name);
-      delete block;
-    }
-    delete[] mem->blocks;
-    free(mem->name);
-    delete mem;
+    delete[] odx->mems[i]->blocks;
   }
+  delete[] odx->mems;
+  odx_reader_close((odx_reader_t *)odx->reader);
   delete odx;
 }
 } /* extern "C" */
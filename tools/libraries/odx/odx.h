@@ -7,6 +7,7 @@
 #define _ODX_H_
 /* ================================ [ INCLUDES  ] ============================================== */
 #include <stdint.h>
+#include <stddef.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,13 +28,28 @@ typedef struct {
 typedef struct {
   odx_mem_t **mems;
   size_t numOfMems;
+  void *reader; /* owns the names and the data of the blocks */
 } odx_t;
+
+typedef struct odx_reader_s odx_reader_t;
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
 /* ================================ [ FUNCTIONS ] ============================================== */
 odx_t *odx_open(const char *path);
 void odx_close(odx_t *odx);
+
+/* The streaming reader hands out the FLASHDATA blocks in document order while the document is
+ * still being parsed, so flashing could start with the first block. The data of a block stays
+ * valid until the reader is closed. A binary sidecar "<path>.odxc" is written after a complete
+ * parse and used instead of the document while its size, modification time, inode and hash are
+ * unchanged, set the environment ODX_CACHE=NO to disable it. */
+odx_reader_t *odx_reader_open(const char *path);
+/* the next block and the ID of its ECU-MEM, NULL at the end of the document or on error */
+const odx_block_t *odx_reader_next(odx_reader_t *reader, const char **mem);
+/* 0 if the document was read without error so far, else -1 */
+int odx_reader_error(const odx_reader_t *reader);
+void odx_reader_close(odx_reader_t *reader);
 #ifdef __cplusplus
 }
 #endif
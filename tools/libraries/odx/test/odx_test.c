@@ -0,0 +1,359 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Generate an ODX-F container whose FLASHDATA blocks mix upper and lower case hex, wrapped and
+ * unwrapped lines, escaped names and sizes which are not a multiple of the decode step. The
+ * streaming reader and the full parse must give back the generated blocks in document order, the
+ * sidecar must only be written with the cache enabled, must be used by the next open and must be
+ * ignored once the document has changed, even by a rewrite of the same size and mtime.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "odx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_IMAGE_SIZE_MB
+#define TEST_IMAGE_SIZE_MB 8
+#endif
+
+#define TEST_ODX "odx_test.odx"
+#define TEST_ODXC TEST_ODX ".odxc"
+#define TEST_NUM_BLOCKS 4
+#define TEST_LINE_CHARS 128
+
+#ifdef _WIN32
+#define setenv(name, value, overwrite) _putenv_s(name, value)
+#define unsetenv(name) _putenv_s(name, "")
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  const char *mem;
+  const char *name;  /* as in the document */
+  const char *value; /* as decoded */
+  size_t size;
+  int wrapped; /* hex text split in lines */
+  int lower;
+} test_block_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static test_block_t testBlocks[TEST_NUM_BLOCKS] = {
+  {"EM_APP", "APP_0", "APP_0", 0, 0, 0},
+  {"EM_APP", "APP_1", "APP_1", 0, 1, 0},
+  {"EM_APP", "APP_2 &amp; CRC", "APP_2 & CRC", 0, 0, 1},
+  {"EM_CAL", "CAL_0", "CAL_0", 0, 1, 1},
+};
+static uint8_t *testData[TEST_NUM_BLOCKS];
+/* ================================ [ LOCALS    ] ============================================== */
+static void test_write_hex(FILE *fp, const uint8_t *data, size_t size, int wrapped, int lower) {
+  const char *digits = lower ? "0123456789abcdef" : "0123456789ABCDEF";
+  char line[TEST_LINE_CHARS + 16];
+  size_t i, n = 0;
+
+  for (i = 0; i < size; i++) {
+    line[n++] = digits[data[i] >> 4];
+    line[n++] = digits[data[i] & 0xF];
+    if (n >= TEST_LINE_CHARS) {
+      if (wrapped) {
+        memcpy(&line[n], "\r\n            ", 14);
+        n += 14;
+      }
+      fwrite(line, n, 1, fp);
+      n = 0;
+    }
+  }
+  fwrite(line, n, 1, fp);
+}
+
+static int test_generate(void) {
+  int r = 0;
+  size_t i, j;
+  size_t size = (size_t)TEST_IMAGE_SIZE_MB * 1024 * 1024 / TEST_NUM_BLOCKS;
+  FILE *fp = fopen(TEST_ODX, "wb");
+
+  if (NULL == fp) {
+    r = -1;
+  } else {
+    fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!-- generated by odx_test -->\n"
+                "<ODX MODEL-VERSION=\"2.2.0\">\n  <FLASH ID=\"FL_TEST\">\n"
+                "    <SHORT-NAME>TEST</SHORT-NAME>\n    <ECU-MEMS>\n");
+    for (i = 0; (i < TEST_NUM_BLOCKS) && (0 == r); i++) {
+      testBlocks[i].size = size + i * 3; /* not a multiple of the 8 bytes step */
+      testData[i] = (uint8_t *)malloc(testBlocks[i].size);
+      if (NULL == testData[i]) {
+        r = -1;
+        break;
+      }
+      for (j = 0; j < testBlocks[i].size; j++) {
+        testData[i][j] = (uint8_t)rand();
+      }
+      if ((0 == i) || (0 != strcmp(testBlocks[i].mem, testBlocks[i - 1].mem))) {
+        fprintf(fp,
+                "      <ECU-MEM ID=\"%s\">\n        <SHORT-NAME>%s</SHORT-NAME>\n"
+                "        <MEM>\n          <FLASHDATAS>\n",
+                testBlocks[i].mem, testBlocks[i].mem);
+      }
+      fprintf(fp,
+              "            <FLASHDATA ID=\"FD_%u\" xsi:type=\"INTERN-FLASHDATA\">\n"
+              "              <SHORT-NAME>%s</SHORT-NAME>\n"
+              "              <DATAFORMAT SELECTION=\"INTEL-HEX\"/>\n              <DATA>",
+              (uint32_t)i, testBlocks[i].name);
+      test_write_hex(fp, testData[i], testBlocks[i].size, testBlocks[i].wrapped,
+                     testBlocks[i].lower);
+      fprintf(fp, "</DATA>\n            </FLASHDATA>\n");
+      if (((i + 1) == TEST_NUM_BLOCKS) ||
+          (0 != strcmp(testBlocks[i].mem, testBlocks[i + 1].mem))) {
+        fprintf(fp, "          </FLASHDATAS>\n        </MEM>\n      </ECU-MEM>\n");
+      }
+    }
+    fprintf(fp, "    </ECU-MEMS>\n  </FLASH>\n</ODX>\n");
+    fclose(fp);
+  }
+
+  return r;
+}
+
+static bool test_exists(const char *path) {
+  FILE *fp = fopen(path, "rb");
+
+  if (NULL != fp) {
+    fclose(fp);
+  }
+
+  return (NULL != fp);
+}
+
+/* xor the last byte of a file, which in the sidecar is the last byte of the last block */
+static bool test_flip_last(const char *path) {
+  FILE *fp = fopen(path, "r+b");
+  bool ok = (NULL != fp);
+  int ch = EOF;
+
+  if (ok) {
+    ok = (0 == fseek(fp, -1, SEEK_END)) && (EOF != (ch = fgetc(fp))) &&
+         (0 == fseek(fp, -1, SEEK_END)) && (EOF != fputc(ch ^ 0xFF, fp));
+    ok = (0 == fclose(fp)) && ok;
+  }
+
+  return ok;
+}
+
+/* rewrites the first byte of the first block in place, the document keeps its size and mtime */
+static bool test_rewrite_first(void) {
+  static const char digits[] = "0123456789ABCDEF";
+  uint8_t value = testData[0][0] ^ 0xFF;
+  char head[4096];
+  char *data = NULL;
+  struct stat st;
+  size_t len;
+  FILE *fp;
+  bool ok = (0 == stat(TEST_ODX, &st));
+
+  fp = ok ? fopen(TEST_ODX, "r+b") : NULL;
+  ok = (NULL != fp);
+  if (ok) {
+    len = fread(head, 1, sizeof(head) - 1, fp);
+    head[len] = '\0';
+    data = strstr(head, "<DATA>");
+    ok = (NULL != data) && (0 == fseek(fp, (long)(data - head) + 6, SEEK_SET)) &&
+         (EOF != fputc(digits[value >> 4], fp)) && (EOF != fputc(digits[value & 0xF], fp));
+    ok = (0 == fclose(fp)) && ok;
+  }
+#ifndef _WIN32
+  if (ok) {
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+    ok = (0 == utimensat(AT_FDCWD, TEST_ODX, times, 0));
+  }
+#endif
+  if (ok) {
+    testData[0][0] = value;
+  }
+
+  return ok;
+}
+
+static bool test_check_block(size_t index, const char *mem, const odx_block_t *block) {
+  return (index < TEST_NUM_BLOCKS) && (0 == strcmp(mem, testBlocks[index].mem)) &&
+         (0 == strcmp(block->name, testBlocks[index].value)) &&
+         (block->size == testBlocks[index].size) &&
+         (0 == memcmp(block->data, testData[index], block->size));
+}
+
+/* returns the number of blocks which match the generated ones in document order */
+static size_t test_check_odx(odx_t *odx) {
+  size_t i, j, index = 0;
+  bool ok = true;
+
+  for (i = 0; (NULL != odx) && (i < odx->numOfMems) && ok; i++) {
+    for (j = 0; (j < odx->mems[i]->numOfBlocks) && ok; j++) {
+      ok = test_check_block(index, odx->mems[i]->name, odx->mems[i]->blocks[j]);
+      if (ok) {
+        index++;
+      }
+    }
+  }
+
+  return index;
+}
+
+static void Test_Reader(void) {
+  odx_reader_t *reader;
+  const odx_block_t *block;
+  const char *mem = NULL;
+  size_t index = 0;
+  bool bPass;
+
+  printf("Test the streaming reader gives the blocks in document order:");
+  setenv("ODX_CACHE", "NO", 1);
+  reader = odx_reader_open(TEST_ODX);
+  bPass = (NULL != reader);
+  while (bPass && (NULL != (block = odx_reader_next(reader, &mem)))) {
+    bPass = test_check_block(index, mem, block);
+    if (bPass) {
+      index++;
+    }
+  }
+  bPass = bPass && (0 == odx_reader_error(reader)) && (TEST_NUM_BLOCKS == index);
+  if (NULL != reader) {
+    odx_reader_close(reader);
+  }
+  bPass = bPass && (false == test_exists(TEST_ODXC));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u of %u blocks ok, sidecar %s\n", (uint32_t)index, TEST_NUM_BLOCKS,
+           test_exists(TEST_ODXC) ? "written" : "not written");
+    exit(-1);
+  }
+}
+
+static void Test_Open(const char *cache, bool sidecar) {
+  odx_t *odx;
+  size_t index;
+  bool bPass;
+
+  printf("Test parse with ODX_CACHE=%s:", (NULL != cache) ? cache : "(unset)");
+  if (NULL != cache) {
+    setenv("ODX_CACHE", cache, 1);
+  } else {
+    unsetenv("ODX_CACHE");
+  }
+  odx = odx_open(TEST_ODX);
+  index = test_check_odx(odx);
+  if (NULL != odx) {
+    odx_close(odx);
+  }
+  bPass = (TEST_NUM_BLOCKS == index) && (sidecar == test_exists(TEST_ODXC));
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u of %u blocks ok, sidecar %s\n", (uint32_t)index, TEST_NUM_BLOCKS,
+           test_exists(TEST_ODXC) ? "written" : "not written");
+    exit(-1);
+  }
+}
+
+/* the last byte of the sidecar is patched, so it is only seen when the sidecar is used */
+static void Test_Sidecar(void) {
+  uint8_t *last = &testData[TEST_NUM_BLOCKS - 1][testBlocks[TEST_NUM_BLOCKS - 1].size - 1];
+  odx_t *odx = NULL;
+  size_t index = 0;
+  bool bPass;
+
+  printf("Test the next open is served by the sidecar:");
+  unsetenv("ODX_CACHE");
+  bPass = test_flip_last(TEST_ODXC);
+  if (bPass) {
+    *last ^= 0xFF;
+    odx = odx_open(TEST_ODX);
+    index = test_check_odx(odx);
+    *last ^= 0xFF;
+    bPass = (TEST_NUM_BLOCKS == index);
+  }
+  if (NULL != odx) {
+    odx_close(odx);
+  }
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u of %u blocks as patched in the sidecar\n", (uint32_t)index, TEST_NUM_BLOCKS);
+    exit(-1);
+  }
+}
+
+/* the patched sidecar no longer matches the size, then the content of the document and must not
+ * be used */
+static void Test_SidecarStale(void) {
+  odx_t *odx = NULL;
+  size_t index = 0;
+  FILE *fp;
+  bool bPass;
+
+  printf("Test a changed document is parsed again:");
+  unsetenv("ODX_CACHE");
+  fp = fopen(TEST_ODX, "ab");
+  bPass = (NULL != fp) && (EOF != fputc('\n', fp));
+  if (NULL != fp) {
+    bPass = (0 == fclose(fp)) && bPass;
+  }
+  if (bPass) {
+    odx = odx_open(TEST_ODX);
+    index = test_check_odx(odx);
+    bPass = (TEST_NUM_BLOCKS == index);
+  }
+  if (NULL != odx) {
+    odx_close(odx);
+  }
+  if (bPass) {
+    /* and the sidecar saved again is good for the next open */
+    odx = odx_open(TEST_ODX);
+    index = test_check_odx(odx);
+    bPass = (TEST_NUM_BLOCKS == index);
+    if (NULL != odx) {
+      odx_close(odx);
+    }
+  }
+  if (bPass) {
+    /* a rewrite of the same size and mtime, the sidecar has the old first byte */
+    bPass = test_rewrite_first();
+    odx = bPass ? odx_open(TEST_ODX) : NULL;
+    index = test_check_odx(odx);
+    bPass = bPass && (TEST_NUM_BLOCKS == index);
+    if (NULL != odx) {
+      odx_close(odx);
+    }
+  }
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %u of %u blocks ok\n", (uint32_t)index, TEST_NUM_BLOCKS);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  size_t i;
+
+  srand(1);
+  (void)remove(TEST_ODXC);
+  if (0 != test_generate()) {
+    printf("failed to generate %s\n", TEST_ODX);
+    return -1;
+  }
+
+  Test_Reader();
+  Test_Open("NO", false);
+  Test_Open(NULL, true);
+  Test_Sidecar();
+  Test_SidecarStale();
+
+  (void)remove(TEST_ODXC);
+  (void)remove(TEST_ODX);
+  for (i = 0; i < TEST_NUM_BLOCKS; i++) {
+    free(testData[i]);
+  }
+
+  return 0;
+}
@@ -2,15 +2,21 @@
  * SSAS - Simple Smart Automotive Software
  * Copyright (C) 2021 Parai Wang <parai@foxmail.com>
  * ref https://wiki.wireshark.org/Development/LibpcapFileFormat
+ * ref https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-03.html
+ *
+ * The packets and the SOME/IP and SD messages are copied with a ns timestamp into a lock-free
+ * ring by the callers, a background writer thread drains the ring into the pcapng file with large
+ * buffered writes and does the text decoding of the SOME/IP and SD messages into the log file.
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "pcap.h"
-#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <math.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
 /* ================================ [ MACROS    ] ============================================== */
 #define SOMEIP_MSG_REQUEST 0x00
 #define SOMEIP_MSG_REQUEST_NO_RETURN 0x01
@@ -29,14 +35,390 @@
 #define SD_OPT_IP4_MULTICAST 0x14
 
 #define SD_FLAG_MASK 0xC0u
+
+/* the number of records in the ring, a power of 2, the records are dropped if it is full */
+#ifndef PCAP_RING_SIZE
+#define PCAP_RING_SIZE 1024
+#endif
+
+/* the captured bytes of one record, the longer packets are truncated */
+#ifndef PCAP_SNAPLEN
+#define PCAP_SNAPLEN 2048
+#endif
+
+#ifndef PCAP_WRITE_BUFFER_SIZE
+#define PCAP_WRITE_BUFFER_SIZE (256 * 1024)
+#endif
+
+/* the maximum time the captured records stay in the write buffer when the ring is idle */
+#ifndef PCAP_FLUSH_INTERVAL
+#define PCAP_FLUSH_INTERVAL 100000000ull /* ns */
+#endif
+
+/* the number of interface description blocks, the packets of the others are dropped */
+#define PCAP_MAX_INTERFACES 16
+
+#define PCAP_RECORD_PACKET 0
+#define PCAP_RECORD_SD 1
+#define PCAP_RECORD_SOMEIP 2
+
+/* the index of lLinkTypes */
+#define PCAP_IF_ETHERNET 0
+#define PCAP_IF_CAN 1
+#define PCAP_IF_LIN 2
+
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_LINKTYPE_LIN 212
+#define PCAP_LINKTYPE_CAN_SOCKETCAN 227
+
+#define PCAPNG_BLOCK_SHB 0x0A0D0D0Au
+#define PCAPNG_BLOCK_IDB 0x00000001u
+#define PCAPNG_BLOCK_EPB 0x00000006u
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4Du
+
+#define PCAPNG_OPT_ENDOFOPT 0
+#define PCAPNG_OPT_IF_NAME 2
+#define PCAPNG_OPT_IF_TSRESOL 9
+#define PCAPNG_OPT_EPB_FLAGS 2
+
+#define PCAPNG_EPB_FLAG_INBOUND 1u
+#define PCAPNG_EPB_FLAG_OUTBOUND 2u
+
+#define PCAP_CAN_EFF_FLAG 0x80000000u
+#define PCAP_CANFD_FDF 0x04u
+
+#define PCAP_ALIGN4(x) (((x) + 3u) & (~3u))
+
+#define PCAP_TIME_FMT "%u.%06u"
+#define PCAP_TIME_ARGS(ns)                                                                         \
+  (uint32_t)(((ns) - lStartTime) / 1000000000ull),                                                 \
+    (uint32_t)((((ns) - lStartTime) % 1000000000ull) / 1000u)
 /* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint16_t serviceId;
+  uint16_t methodId;
+  uint16_t clientId;
+  uint16_t sessionId;
+  uint8_t interfaceVersion;
+  uint8_t messageType;
+  uint8_t returnCode;
+  boolean isTp;
+  boolean more;
+  uint32_t offset;
+} pcap_someip_header_t;
+
+typedef struct {
+  uint64_t timestamp; /* ns since the epoch */
+  uint32_t length;    /* the original length */
+  uint32_t caplen;    /* the captured length in data */
+  uint8_t type;
+  uint8_t linkType; /* the index of lLinkTypes */
+  uint8_t channel;
+  boolean isRx;
+  boolean hasAddr;
+  TcpIp_SockAddrType addr;
+  pcap_someip_header_t someip;
+  uint8_t data[PCAP_SNAPLEN];
+} pcap_record_t;
+
+typedef struct {
+  _Atomic uint32_t sequence;
+  pcap_record_t record;
+} pcap_slot_t;
+
+typedef struct {
+  uint16_t linkType;
+  const char *name;
+} pcap_link_type_t;
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 static FILE *lPCap = NULL;
 static FILE *lWPCap = NULL;
+
+static const pcap_link_type_t lLinkTypes[] = {
+  /* PCAP_IF_xxx */
+  {PCAP_LINKTYPE_ETHERNET, "eth"},
+  {PCAP_LINKTYPE_CAN_SOCKETCAN, "can"},
+  {PCAP_LINKTYPE_LIN, "lin"},
+};
+
+/* multiple producers single consumer ring: a slot is free for the producer at position pos when
+ * its sequence is pos and is ready for the writer when its sequence is pos + 1 */
+static pcap_slot_t lSlots[PCAP_RING_SIZE];
+static _Atomic uint32_t lTail;
+static uint32_t lHead;
+static _Atomic uint32_t lDropped;
+static _Atomic boolean lRunning;
+static pthread_t lWriter;
+static boolean lWriterStarted = FALSE;
+static uint64_t lStartTime;
+
+/* owned by the writer thread */
+static uint8_t lWriteBuffer[PCAP_WRITE_BUFFER_SIZE];
+static uint32_t lWriteLength;
+static uint64_t lLastFlushTime;
+static uint8_t lInterfaceKeys[PCAP_MAX_INTERFACES][2];
+static uint32_t lNumOfInterfaces;
+static uint32_t lNoInterface; /* the packets dropped as there were too many interfaces */
+static uint64_t lDecodeTime;
 /* ================================ [ LOCALS    ] ============================================== */
+static uint64_t pcap_get_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static pcap_record_t *pcap_reserve(uint8_t type, uint32_t length) {
+  pcap_slot_t *slot = NULL;
+  pcap_record_t *record = NULL;
+  uint32_t pos = atomic_load_explicit(&lTail, memory_order_relaxed);
+  uint32_t seq;
+  int32_t diff;
+
+  if (lRunning) {
+    for (;;) {
+      slot = &lSlots[pos & (PCAP_RING_SIZE - 1)];
+      seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+      diff = (int32_t)(seq - pos);
+      if (0 == diff) {
+        if (atomic_compare_exchange_weak_explicit(&lTail, &pos, pos + 1, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+          record = &slot->record;
+          break;
+        }
+      } else if (diff < 0) {
+        atomic_fetch_add_explicit(&lDropped, 1, memory_order_relaxed);
+        break;
+      } else {
+        pos = atomic_load_explicit(&lTail, memory_order_relaxed);
+      }
+    }
+  }
+
+  if (NULL != record) {
+    record->timestamp = pcap_get_time();
+    record->type = type;
+    record->length = length;
+    record->caplen = (length < PCAP_SNAPLEN) ? length : PCAP_SNAPLEN;
+    record->linkType = PCAP_IF_ETHERNET;
+    record->channel = 0;
+    record->isRx = FALSE;
+    record->hasAddr = FALSE;
+  }
+
+  return record;
+}
+
+static void pcap_commit(pcap_record_t *record) {
+  pcap_slot_t *slot = (pcap_slot_t *)((uint8_t *)record - offsetof(pcap_slot_t, record));
+  uint32_t seq = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+  atomic_store_explicit(&slot->sequence, seq + 1, memory_order_release);
+}
+
+static void pcap_flush(void) {
+  if ((lWriteLength > 0) && (NULL != lWPCap)) {
+    fwrite(lWriteBuffer, lWriteLength, 1, lWPCap);
+  }
+  lWriteLength = 0;
+  lLastFlushTime = pcap_get_time();
+}
+
+static void pcap_out(const void *data, uint32_t length) {
+  static const uint8_t padding[4] = {0, 0, 0, 0};
+
+  if ((lWriteLength + length) > sizeof(lWriteBuffer)) {
+    pcap_flush();
+  }
+  if (NULL == data) {
+    data = padding;
+  }
+  memcpy(&lWriteBuffer[lWriteLength], data, length);
+  lWriteLength += length;
+}
+
+static void pcap_out32(uint32_t value) {
+  pcap_out(&value, sizeof(value));
+}
+
+static void pcap_out_option(uint16_t code, const void *value, uint16_t length) {
+  uint32_t header = ((uint32_t)length << 16) + code;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  header = ((uint32_t)code << 16) + length;
+#endif
+  pcap_out32(header);
+  if (length > 0) {
+    pcap_out(value, length);
+    pcap_out(NULL, PCAP_ALIGN4(length) - length);
+  }
+}
+
+static void pcap_write_shb(void) {
+  static const uint16_t version[2] = {1, 0};
+  static const int64_t sectionLength = -1;
+
+  pcap_out32(PCAPNG_BLOCK_SHB);
+  pcap_out32(28);
+  pcap_out32(PCAPNG_BYTE_ORDER_MAGIC);
+  pcap_out(version, sizeof(version));
+  pcap_out(&sectionLength, sizeof(sectionLength));
+  pcap_out32(28);
+}
+
+/* the interface of the link type and channel, its description block is written the first time,
+ * PCAP_MAX_INTERFACES if there are too many interfaces */
+static uint32_t pcap_get_interface(uint8_t linkType, uint8_t channel) {
+  static const uint8_t tsresol = 9; /* ns */
+  const pcap_link_type_t *lt = &lLinkTypes[linkType];
+  uint32_t id;
+  uint32_t length;
+  uint16_t lt16[2] = {lt->linkType, 0};
+  char name[16];
+
+  for (id = 0; id < lNumOfInterfaces; id++) {
+    if ((linkType == lInterfaceKeys[id][0]) && (channel == lInterfaceKeys[id][1])) {
+      break;
+    }
+  }
+
+  if ((id == lNumOfInterfaces) && (lNumOfInterfaces < PCAP_MAX_INTERFACES)) {
+    lInterfaceKeys[id][0] = linkType;
+    lInterfaceKeys[id][1] = channel;
+    lNumOfInterfaces++;
+    snprintf(name, sizeof(name), "%s%u", lt->name, channel);
+    length = 16 + 4 + PCAP_ALIGN4(strlen(name)) + 4 + 4 + 4 + 4;
+    pcap_out32(PCAPNG_BLOCK_IDB);
+    pcap_out32(length);
+    pcap_out(lt16, sizeof(lt16));
+    pcap_out32(PCAP_SNAPLEN);
+    pcap_out_option(PCAPNG_OPT_IF_NAME, name, strlen(name));
+    pcap_out_option(PCAPNG_OPT_IF_TSRESOL, &tsresol, sizeof(tsresol));
+    pcap_out_option(PCAPNG_OPT_ENDOFOPT, NULL, 0);
+    pcap_out32(length);
+  } else if (id == lNumOfInterfaces) {
+    id = PCAP_MAX_INTERFACES;
+  }
+
+  return id;
+}
+
+static void pcap_write_epb(const pcap_record_t *record) {
+  uint32_t id = pcap_get_interface(record->linkType, record->channel);
+  uint32_t flags = 0;
+  uint32_t length = 32 + PCAP_ALIGN4(record->caplen) + 4;
+
+  if (PCAP_MAX_INTERFACES == id) {
+    lNoInterface++;
+  } else {
+    if (PCAP_IF_ETHERNET != record->linkType) {
+      flags = record->isRx ? PCAPNG_EPB_FLAG_INBOUND : PCAPNG_EPB_FLAG_OUTBOUND;
+      length += 4 + 4;
+    }
+    pcap_out32(PCAPNG_BLOCK_EPB);
+    pcap_out32(length);
+    pcap_out32(id);
+    pcap_out32((uint32_t)(record->timestamp >> 32));
+    pcap_out32((uint32_t)record->timestamp);
+    pcap_out32(record->caplen);
+    pcap_out32(record->length);
+    pcap_out(record->data, record->caplen);
+    pcap_out(NULL, PCAP_ALIGN4(record->caplen) - record->caplen);
+    if (0 != flags) {
+      pcap_out_option(PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags));
+    }
+    pcap_out_option(PCAPNG_OPT_ENDOFOPT, NULL, 0);
+    pcap_out32(length);
+  }
+}
+
+static void pcap_decode_sd(uint8_t *data, uint32_t length, const TcpIp_SockAddrType *RemoteAddr,
+                           boolean isRx);
+static void pcap_decode_someip(const pcap_someip_header_t *header, uint8_t *payload,
+                               uint32_t payloadLength, const TcpIp_SockAddrType *RemoteAddr,
+                               boolean isRx);
+
+static void pcap_process(pcap_record_t *record) {
+  lDecodeTime = record->timestamp;
+  switch (record->type) {
+  case PCAP_RECORD_PACKET:
+    if (NULL != lWPCap) {
+      pcap_write_epb(record);
+    }
+    break;
+  case PCAP_RECORD_SD:
+    if (NULL != lPCap) {
+      pcap_decode_sd(record->data, record->caplen, &record->addr, record->isRx);
+    }
+    break;
+  case PCAP_RECORD_SOMEIP:
+    if (NULL != lPCap) {
+      pcap_decode_someip(&record->someip, record->data, record->length,
+                         record->hasAddr ? &record->addr : NULL, record->isRx);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/* returns TRUE if the ring was drained */
+static boolean pcap_drain(void) {
+  pcap_slot_t *slot = &lSlots[lHead & (PCAP_RING_SIZE - 1)];
+  boolean drained = TRUE;
+
+  while ((lHead + 1) == atomic_load_explicit(&slot->sequence, memory_order_acquire)) {
+    pcap_process(&slot->record);
+    atomic_store_explicit(&slot->sequence, lHead + PCAP_RING_SIZE, memory_order_release);
+    lHead++;
+    drained = FALSE;
+    slot = &lSlots[lHead & (PCAP_RING_SIZE - 1)];
+  }
+
+  return drained;
+}
+
+static void *pcap_writer(void *args) {
+  struct timespec ts = {0, 1000000};
+  boolean running = TRUE;
+
+  (void)args;
+
+  while (running) {
+    running = lRunning;
+    if (TRUE == pcap_drain()) {
+      if ((lWriteLength > 0) && ((pcap_get_time() - lLastFlushTime) >= PCAP_FLUSH_INTERVAL)) {
+        pcap_flush();
+      }
+      if (running) {
+        nanosleep(&ts, NULL);
+      }
+    }
+  }
+  (void)pcap_drain();
+  pcap_flush();
+
+  return NULL;
+}
+
 static void _pcap_stop(void) {
+  uint32_t dropped;
+
+  if (lWriterStarted) {
+    lRunning = FALSE;
+    pthread_join(lWriter, NULL);
+    lWriterStarted = FALSE;
+  }
+  dropped = atomic_load(&lDropped);
   if (NULL != lPCap) {
+    if (dropped > 0) {
+      fprintf(lPCap, "\n%u records dropped as the capture ring was full\n", dropped);
+    }
+    if (lNoInterface > 0) {
+      fprintf(lPCap, "\n%u packets dropped as there were more than %u interfaces\n", lNoInterface,
+              PCAP_MAX_INTERFACES);
+    }
     fclose(lPCap);
   }
   if (NULL != lWPCap) {
@@ -47,6 +429,7 @@ static void _pcap_stop(void) {
 static void __attribute__((constructor)) _pcap_start(void) {
   char path[256];
   char *name = getenv("PCAP_PATH");
+  uint32_t i;
 
   if (NULL == name) {
     snprintf(path, sizeof(path), "net.log");
@@ -56,54 +439,39 @@ static void __attribute__((constructor)) _pcap_start(void) {
   lPCap = fopen(path, "wb");
 
   if (NULL == name) {
-    snprintf(path, sizeof(path), "wireshark.pcap");
+    snprintf(path, sizeof(path), "wireshark.pcapng");
   } else {
-    snprintf(path, sizeof(path), "%s.pcap", name);
+    snprintf(path, sizeof(path), "%s.pcapng", name);
   }
   lWPCap = fopen(path, "wb");
   if (NULL != lWPCap) {
-    static const uint8_t global_header[] = {
-      0xD4, 0xC3, 0xB2, 0xA1, /* magic number */
-      0x02, 0x00, 0x04, 0x00, /* major/minor version number: 2.4 */
-      0x00, 0x00, 0x00, 0x00, /* GMT to local correction */
-      0x00, 0x00, 0x00, 0x00, /* accuracy of timestamps */
-      0xFF, 0xFF, 0x00, 0x00, /* max length of captured packets, in octets */
-      0x01, 0x00, 0x00, 0x00, /* data link type: LINKTYPE_ETHERNET */
-    };
-    fwrite(global_header, sizeof(global_header), 1, lWPCap);
+    /* the writer thread does the buffering */
+    setvbuf(lWPCap, NULL, _IONBF, 0);
+    pcap_write_shb();
   }
 
   if ((NULL != lPCap) || (NULL != lWPCap)) {
+    lStartTime = pcap_get_time();
+    lLastFlushTime = lStartTime;
+    for (i = 0; i < PCAP_RING_SIZE; i++) {
+      atomic_init(&lSlots[i].sequence, i);
+    }
+    lRunning = TRUE;
+    if (0 == pthread_create(&lWriter, NULL, pcap_writer, NULL)) {
+      lWriterStarted = TRUE;
+    } else {
+      lRunning = FALSE;
+    }
     atexit(_pcap_stop);
   }
 }
 
-static float get_rel_time(void) {
-  static struct timeval m0 = {-1, -1};
-  struct timeval m1;
-  float rtim;
-
-  if ((-1 == m0.tv_sec) && (-1 == m0.tv_usec)) {
-    gettimeofday(&m0, NULL);
-  }
-  gettimeofday(&m1, NULL);
-  rtim = m1.tv_sec - m0.tv_sec;
-  if (m1.tv_usec > m0.tv_usec) {
-    rtim += (float)(m1.tv_usec - m0.tv_usec) / 1000000.0;
-  } else {
-    rtim = rtim - 1 + (float)(1000000.0 + m1.tv_usec - m0.tv_usec) / 1000000.0;
-  }
-
-  return rtim;
-}
-
 static boolean pcap_invalid_sd(char *errMsg, uint8_t *data, uint32_t length,
                                const TcpIp_SockAddrType *RemoteAddr, boolean isRx) {
   uint32_t i;
-  float rtim = get_rel_time();
-  fprintf(lPCap, "\n%.4f: invalid(%s) SD %s %d.%d.%d.%d:%d\n  data(%u) = [", rtim,
-          isRx ? "from" : "to", errMsg, RemoteAddr->addr[0], RemoteAddr->addr[1],
-          RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port, length);
+  fprintf(lPCap, "\n" PCAP_TIME_FMT ": invalid(%s) SD %s %d.%d.%d.%d:%d\n  data(%u) = [",
+          PCAP_TIME_ARGS(lDecodeTime), isRx ? "from" : "to", errMsg, RemoteAddr->addr[0],
+          RemoteAddr->addr[1], RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port, length);
   for (i = 0; i < length; i++) {
     fprintf(lPCap, "%02x", data[i]);
   }
@@ -227,19 +595,19 @@ uint32_t pcap_sd_option_ipv4(char *ts, uint8_t *data) {
   return 12;
 }
 
-/* ================================ [ FUNCTIONS ] ============================================== */
-void PCap_SomeIp(uint16_t serviceId, uint16_t methodId, uint8_t interfaceVersion,
-                 uint8_t messageType, uint8_t returnCode, uint8_t *payload, uint32_t payloadLength,
-                 uint16_t clientId, uint16_t sessionId, const TcpIp_SockAddrType *RemoteAddr,
-                 boolean isTp, uint32_t offset, boolean more, boolean isRx) {
+static void pcap_decode_someip(const pcap_someip_header_t *header, uint8_t *payload,
+                               uint32_t payloadLength, const TcpIp_SockAddrType *RemoteAddr,
+                               boolean isRx) {
   char typeStr[32];
   const char *type;
   uint32_t i;
   uint32_t length;
-  float rtim;
+  uint8_t messageType = header->messageType;
+  boolean isTp = header->isTp;
+  uint32_t offset = header->offset;
+  boolean more = header->more;
 
   if (lPCap) {
-    rtim = get_rel_time();
     if (messageType & SOMEIP_TP_FLAG) {
       messageType &= ~SOMEIP_TP_FLAG;
       isTp = TRUE;
@@ -273,16 +641,18 @@ void PCap_SomeIp(uint16_t serviceId, uint16_t methodId, uint8_t interfaceVersion
     }
 
     if (RemoteAddr) {
-      fprintf(lPCap, "\n%.4f: SOMEIP %s %d.%d.%d.%d:%d\n", rtim, isRx ? "from" : "to",
-              RemoteAddr->addr[0], RemoteAddr->addr[1], RemoteAddr->addr[2], RemoteAddr->addr[3],
-              RemoteAddr->port);
+      fprintf(lPCap, "\n" PCAP_TIME_FMT ": SOMEIP %s %d.%d.%d.%d:%d\n",
+              PCAP_TIME_ARGS(lDecodeTime), isRx ? "from" : "to", RemoteAddr->addr[0],
+              RemoteAddr->addr[1], RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port);
     } else {
-      fprintf(lPCap, "\n%.4f: SOMEIP %s null\n", rtim, isRx ? "from" : "to");
+      fprintf(lPCap, "\n" PCAP_TIME_FMT ": SOMEIP %s null\n", PCAP_TIME_ARGS(lDecodeTime),
+              isRx ? "from" : "to");
     }
     fprintf(
       lPCap,
       "  %s service:method:version %x:%x:%x session %d client %x return code %d payload %u bytes",
-      type, serviceId, methodId, interfaceVersion, sessionId, clientId, returnCode, payloadLength);
+      type, header->serviceId, header->methodId, header->interfaceVersion, header->sessionId,
+      header->clientId, header->returnCode, payloadLength);
     if (isTp) {
       fprintf(lPCap, " TP offset=%d more=%d", offset, more);
     }
@@ -298,21 +668,17 @@ void PCap_SomeIp(uint16_t serviceId, uint16_t methodId, uint8_t interfaceVersion
   }
 }
 
-void PCap_SD(uint8_t *data, uint32_t length, const TcpIp_SockAddrType *RemoteAddr, boolean isRx) {
+static void pcap_decode_sd(uint8_t *data, uint32_t length, const TcpIp_SockAddrType *RemoteAddr,
+                           boolean isRx) {
   boolean good = TRUE;
   uint16_t sessionId;
   uint32_t i;
   uint32_t payloadLength;
-  uint32_t lengthOfEntries;
-  uint32_t lengthOfOptions;
+  uint32_t lengthOfEntries = 0;
+  uint32_t lengthOfOptions = 0;
   uint8_t flags;
   uint8_t *entries;
   uint8_t *options;
-  float rtim;
-  static const TcpIp_SockAddrType broadcast = {30490, {224, 244, 224, 245}};
-  if (NULL == RemoteAddr) {
-    RemoteAddr = &broadcast;
-  }
 
   good = pcap_validate_sd(data, length, RemoteAddr, isRx);
 
@@ -340,11 +706,12 @@ void PCap_SD(uint8_t *data, uint32_t length, const TcpIp_SockAddrType *RemoteAdd
   }
 
   if (good) {
-    rtim = get_rel_time();
-    fprintf(lPCap, "\n%.4f: SD %s %d.%d.%d.%d:%d session %d flags %x entries(%u) options(%u)\n",
-            rtim, isRx ? "from" : "to", RemoteAddr->addr[0], RemoteAddr->addr[1],
-            RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port, sessionId, flags,
-            lengthOfEntries, lengthOfOptions);
+    fprintf(lPCap,
+            "\n" PCAP_TIME_FMT
+            ": SD %s %d.%d.%d.%d:%d session %d flags %x entries(%u) options(%u)\n",
+            PCAP_TIME_ARGS(lDecodeTime), isRx ? "from" : "to", RemoteAddr->addr[0],
+            RemoteAddr->addr[1], RemoteAddr->addr[2], RemoteAddr->addr[3], RemoteAddr->port,
+            sessionId, flags, lengthOfEntries, lengthOfOptions);
     entries = &data[24];
     for (i = 0; (i < lengthOfEntries) && good;) {
       switch (entries[i]) {
@@ -385,32 +752,112 @@ void PCap_SD(uint8_t *data, uint32_t length, const TcpIp_SockAddrType *RemoteAdd
   }
 }
 
+/* ================================ [ FUNCTIONS ] ============================================== */
+void PCap_SomeIp(uint16_t serviceId, uint16_t methodId, uint8_t interfaceVersion,
+                 uint8_t messageType, uint8_t returnCode, uint8_t *payload, uint32_t payloadLength,
+                 uint16_t clientId, uint16_t sessionId, const TcpIp_SockAddrType *RemoteAddr,
+                 boolean isTp, uint32_t offset, boolean more, boolean isRx) {
+  pcap_record_t *record = pcap_reserve(PCAP_RECORD_SOMEIP, payloadLength);
+
+  if (NULL != record) {
+    record->someip.serviceId = serviceId;
+    record->someip.methodId = methodId;
+    record->someip.clientId = clientId;
+    record->someip.sessionId = sessionId;
+    record->someip.interfaceVersion = interfaceVersion;
+    record->someip.messageType = messageType;
+    record->someip.returnCode = returnCode;
+    record->someip.isTp = isTp;
+    record->someip.more = more;
+    record->someip.offset = offset;
+    record->isRx = isRx;
+    if (NULL != RemoteAddr) {
+      record->addr = *RemoteAddr;
+      record->hasAddr = TRUE;
+    }
+    memcpy(record->data, payload, record->caplen);
+    pcap_commit(record);
+  }
+}
+
+void PCap_SD(uint8_t *data, uint32_t length, const TcpIp_SockAddrType *RemoteAddr, boolean isRx) {
+  static const TcpIp_SockAddrType broadcast = {30490, {224, 244, 224, 245}};
+  pcap_record_t *record = pcap_reserve(PCAP_RECORD_SD, length);
+
+  if (NULL != record) {
+    if (NULL == RemoteAddr) {
+      RemoteAddr = &broadcast;
+    }
+    record->addr = *RemoteAddr;
+    record->hasAddr = TRUE;
+    record->isRx = isRx;
+    memcpy(record->data, data, record->caplen);
+    pcap_commit(record);
+  }
+}
+
 void PCap_Packet(const void *packet, uint32_t length) {
-  uint8_t pcaprec_hdr[16];
-  float rtim = get_rel_time();
-  uint32_t ts_sec = (uint32_t)rtim;
-  uint32_t ts_usec = (uint32_t)((rtim - ts_sec) * 1000000);
-
-  pcaprec_hdr[0] = ts_sec & 0xFF;
-  pcaprec_hdr[1] = (ts_sec >> 8) & 0xFF;
-  pcaprec_hdr[2] = (ts_sec >> 16) & 0xFF;
-  pcaprec_hdr[3] = (ts_sec >> 24) & 0xFF;
-
-  pcaprec_hdr[4] = ts_usec & 0xFF;
-  pcaprec_hdr[5] = (ts_usec >> 8) & 0xFF;
-  pcaprec_hdr[6] = (ts_usec >> 16) & 0xFF;
-  pcaprec_hdr[7] = (ts_usec >> 24) & 0xFF;
-
-  pcaprec_hdr[8] = length & 0xFF;
-  pcaprec_hdr[9] = (length >> 8) & 0xFF;
-  pcaprec_hdr[10] = (length >> 16) & 0xFF;
-  pcaprec_hdr[11] = (length >> 24) & 0xFF;
-
-  pcaprec_hdr[12] = length & 0xFF;
-  pcaprec_hdr[13] = (length >> 8) & 0xFF;
-  pcaprec_hdr[14] = (length >> 16) & 0xFF;
-  pcaprec_hdr[15] = (length >> 24) & 0xFF;
-
-  fwrite(pcaprec_hdr, sizeof(pcaprec_hdr), 1, lWPCap);
-  fwrite(packet, length, 1, lWPCap);
+  pcap_record_t *record = pcap_reserve(PCAP_RECORD_PACKET, length);
+
+  if (NULL != record) {
+    memcpy(record->data, packet, record->caplen);
+    pcap_commit(record);
+  }
+}
+
+void PCap_Can(uint8_t channel, uint32_t canid, uint8_t dlc, const uint8_t *data, boolean isRx) {
+  uint32_t length = (dlc > 8) ? 72 : 16;
+  pcap_record_t *record = pcap_reserve(PCAP_RECORD_PACKET, length);
+
+  if (dlc > 64) {
+    dlc = 64;
+  }
+
+  if (NULL != record) {
+    /* struct can_frame/canfd_frame of SocketCAN with the CAN ID in network byte order */
+    if ((0 != (canid & PCAP_CAN_EFF_FLAG)) || (canid > 0x7FFu)) {
+      canid = (canid & 0x1FFFFFFFu) | PCAP_CAN_EFF_FLAG;
+    }
+    record->data[0] = (uint8_t)(canid >> 24);
+    record->data[1] = (uint8_t)(canid >> 16);
+    record->data[2] = (uint8_t)(canid >> 8);
+    record->data[3] = (uint8_t)canid;
+    record->data[4] = dlc;
+    record->data[5] = (dlc > 8) ? PCAP_CANFD_FDF : 0;
+    record->data[6] = 0;
+    record->data[7] = 0;
+    memcpy(&record->data[8], data, dlc);
+    memset(&record->data[8 + dlc], 0, length - 8 - dlc);
+    record->linkType = PCAP_IF_CAN;
+    record->channel = channel;
+    record->isRx = isRx;
+    pcap_commit(record);
+  }
+}
+
+void PCap_Lin(uint8_t channel, uint8_t pid, uint8_t dlc, const uint8_t *data, uint8_t checksum,
+              boolean isRx) {
+  pcap_record_t *record;
+
+  if (dlc > 8) {
+    dlc = 8;
+  }
+
+  record = pcap_reserve(PCAP_RECORD_PACKET, 8 + dlc);
+  if (NULL != record) {
+    /* the LINKTYPE_LIN header: revision 1, the payload length and the message type frame */
+    record->data[0] = 1;
+    record->data[1] = 0;
+    record->data[2] = 0;
+    record->data[3] = 0;
+    record->data[4] = (uint8_t)(dlc << 4);
+    record->data[5] = pid;
+    record->data[6] = checksum;
+    record->data[7] = 0;
+    memcpy(&record->data[8], data, dlc);
+    record->linkType = PCAP_IF_LIN;
+    record->channel = channel;
+    record->isRx = isRx;
+    pcap_commit(record);
+  }
 }
@@ -6,6 +6,9 @@
 #define _PCAP_H
 /* ================================ [ INCLUDES  ] ============================================== */
 #include "TcpIp.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
 /* ================================ [ MACROS    ] ============================================== */
 /* ================================ [ TYPES     ] ============================================== */
 /* ================================ [ DECLARES  ] ============================================== */
@@ -17,5 +20,14 @@ void PCap_SomeIp(uint16_t serviceId, uint16_t methodId, uint8_t interfaceVersion
                  uint8_t messageType, uint8_t returnCode, uint8_t *payload, uint32_t payloadLength,
                  uint16_t clientId, uint16_t sessionId, const TcpIp_SockAddrType *RemoteAddr,
                  boolean isTp, uint32_t offset, boolean more, boolean isRx);
+/* an Ethernet frame */
 void PCap_Packet(const void *packet, uint32_t length);
+/* a CAN or CAN FD frame of the CAN controller channel, the extended CAN ID has bit 31 set */
+void PCap_Can(uint8_t channel, uint32_t canid, uint8_t dlc, const uint8_t *data, boolean isRx);
+/* a LIN frame of the LIN channel, pid is the protected identifier */
+void PCap_Lin(uint8_t channel, uint8_t pid, uint8_t dlc, const uint8_t *data, uint8_t checksum,
+              boolean isRx);
+#ifdef __cplusplus
+}
+#endif
 #endif /* _PCAP_H */
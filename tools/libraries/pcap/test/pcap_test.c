@@ -0,0 +1,431 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Capture CAN, CAN FD, LIN and Ethernet packets and parse the pcapng file back while the writer
+ * thread of the capture is running: the section header block, one interface description block per
+ * link type and channel and one enhanced packet block per packet in the order of the capture. The
+ * packets of the interfaces beyond the 16 interface description blocks must be dropped, the other
+ * interfaces must keep their packets.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "pcap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+/* ================================ [ MACROS    ] ============================================== */
+/* the writer flushes the file once the capture is idle for 100ms */
+#ifndef TEST_TIMEOUT
+#define TEST_TIMEOUT 3000 /* ms */
+#endif
+
+#define TEST_MAX_INTERFACES 16
+#define TEST_MAX_PACKETS 64
+#define TEST_SNAPLEN 2048
+#define TEST_ETH_LENGTH 3000 /* truncated to TEST_SNAPLEN */
+
+#define TEST_BLOCK_SHB 0x0A0D0D0Au
+#define TEST_BLOCK_IDB 0x00000001u
+#define TEST_BLOCK_EPB 0x00000006u
+#define TEST_BYTE_ORDER_MAGIC 0x1A2B3C4Du
+
+#define TEST_LINKTYPE_ETHERNET 1
+#define TEST_LINKTYPE_LIN 212
+#define TEST_LINKTYPE_CAN_SOCKETCAN 227
+
+#define TEST_FLAG_INBOUND 1u
+#define TEST_FLAG_OUTBOUND 2u
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint16_t linkType;
+  uint32_t snaplen;
+  char name[16];
+  uint8_t tsresol;
+} test_idb_t;
+
+typedef struct {
+  uint32_t id;
+  uint64_t timestamp;
+  uint32_t caplen;
+  uint32_t length;
+  const uint8_t *data;
+  uint32_t flags; /* 0 if there is no flags option */
+} test_epb_t;
+
+typedef struct {
+  uint8_t *file;
+  bool shb; /* a valid section header block comes first */
+  bool valid;
+  uint32_t numOfIdbs;
+  uint32_t numOfEpbs;
+  test_idb_t idbs[TEST_MAX_INTERFACES + 1];
+  test_epb_t epbs[TEST_MAX_PACKETS];
+} test_pcapng_t;
+
+typedef struct {
+  uint16_t linkType;
+  const char *name;
+  uint32_t caplen;
+  uint32_t length;
+  uint32_t flags;
+  uint8_t data[TEST_SNAPLEN];
+} test_packet_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static char testPath[256];
+static test_pcapng_t testPcapng;
+static test_packet_t testPackets[TEST_MAX_PACKETS];
+static uint32_t testNumOfPackets;
+static uint64_t testStartTime;
+/* ================================ [ LOCALS    ] ============================================== */
+static uint64_t test_get_time(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t test_get32(const uint8_t *data) {
+  uint32_t value;
+
+  memcpy(&value, data, sizeof(value));
+
+  return value;
+}
+
+static uint16_t test_get16(const uint8_t *data) {
+  uint16_t value;
+
+  memcpy(&value, data, sizeof(value));
+
+  return value;
+}
+
+static void test_parse_idb_options(test_idb_t *idb, const uint8_t *opt, const uint8_t *end) {
+  uint16_t code, length;
+
+  while ((opt + 4) <= end) {
+    code = test_get16(opt);
+    length = test_get16(opt + 2);
+    opt += 4;
+    if (0 == code) {
+      break;
+    } else if ((2 == code) && (length < sizeof(idb->name))) {
+      memcpy(idb->name, opt, length);
+      idb->name[length] = '\0';
+    } else if ((9 == code) && (1 == length)) {
+      idb->tsresol = opt[0];
+    }
+    opt += (length + 3u) & (~3u);
+  }
+}
+
+static void test_parse_epb_options(test_epb_t *epb, const uint8_t *opt, const uint8_t *end) {
+  uint16_t code, length;
+
+  while ((opt + 4) <= end) {
+    code = test_get16(opt);
+    length = test_get16(opt + 2);
+    opt += 4;
+    if (0 == code) {
+      break;
+    } else if ((2 == code) && (4 == length)) {
+      epb->flags = test_get32(opt);
+    }
+    opt += (length + 3u) & (~3u);
+  }
+}
+
+/* the blocks of the whole file, a block flushed in part stops the parse */
+static void test_parse(test_pcapng_t *pcapng, size_t size) {
+  const uint8_t *block = pcapng->file;
+  const uint8_t *end = pcapng->file + size;
+  test_idb_t *idb;
+  test_epb_t *epb;
+  uint32_t type, length;
+
+  pcapng->shb = (size >= 28) && (TEST_BLOCK_SHB == test_get32(block)) &&
+                (28 == test_get32(block + 4)) && (TEST_BYTE_ORDER_MAGIC == test_get32(block + 8)) &&
+                (1 == test_get16(block + 12)) && (0 == test_get16(block + 14)) &&
+                (28 == test_get32(block + 24));
+  pcapng->valid = pcapng->shb;
+  pcapng->numOfIdbs = 0;
+  pcapng->numOfEpbs = 0;
+  if (pcapng->shb) {
+    block += 28;
+  }
+
+  while (pcapng->valid && ((block + 12) <= end)) {
+    type = test_get32(block);
+    length = test_get32(block + 4);
+    if ((block + length) > end) {
+      break;
+    }
+    pcapng->valid = (length >= 12) && (0 == (length & 3)) &&
+                    (length == test_get32(block + length - 4));
+    if (false == pcapng->valid) {
+    } else if (TEST_BLOCK_IDB == type) {
+      pcapng->valid = (length >= 20) && (pcapng->numOfIdbs <= TEST_MAX_INTERFACES);
+      if (pcapng->valid) {
+        idb = &pcapng->idbs[pcapng->numOfIdbs++];
+        memset(idb, 0, sizeof(*idb));
+        idb->linkType = test_get16(block + 8);
+        idb->snaplen = test_get32(block + 12);
+        test_parse_idb_options(idb, block + 16, block + length - 4);
+      }
+    } else if (TEST_BLOCK_EPB == type) {
+      pcapng->valid = (length >= 32) && (pcapng->numOfEpbs < TEST_MAX_PACKETS);
+      if (pcapng->valid) {
+        epb = &pcapng->epbs[pcapng->numOfEpbs];
+        epb->id = test_get32(block + 8);
+        epb->timestamp = ((uint64_t)test_get32(block + 12) << 32) + test_get32(block + 16);
+        epb->caplen = test_get32(block + 20);
+        epb->length = test_get32(block + 24);
+        epb->data = block + 28;
+        epb->flags = 0;
+        pcapng->valid = ((28 + ((epb->caplen + 3u) & (~3u)) + 4) <= length);
+        if (pcapng->valid) {
+          test_parse_epb_options(epb, epb->data + ((epb->caplen + 3u) & (~3u)),
+                                 block + length - 4);
+          pcapng->numOfEpbs++;
+        }
+      }
+    } else {
+      pcapng->valid = false;
+    }
+    block += length;
+  }
+}
+
+static bool test_load(test_pcapng_t *pcapng) {
+  FILE *fp = fopen(testPath, "rb");
+  long size = -1;
+
+  if (NULL != fp) {
+    if (0 == fseek(fp, 0, SEEK_END)) {
+      size = ftell(fp);
+    }
+    free(pcapng->file);
+    pcapng->file = (size > 0) ? (uint8_t *)malloc((size_t)size) : NULL;
+    if ((NULL == pcapng->file) || (0 != fseek(fp, 0, SEEK_SET)) ||
+        (1 != fread(pcapng->file, (size_t)size, 1, fp))) {
+      size = -1;
+    }
+    fclose(fp);
+  }
+
+  if (size > 0) {
+    test_parse(pcapng, (size_t)size);
+  }
+
+  return (size > 0);
+}
+
+/* waits for the writer thread to flush the packets captured so far */
+static bool test_wait(test_pcapng_t *pcapng) {
+  uint32_t ms;
+  bool loaded = false;
+
+  for (ms = 0; ms < TEST_TIMEOUT; ms += 10) {
+    loaded = test_load(pcapng);
+    if (loaded && ((false == pcapng->valid) || (pcapng->numOfEpbs >= testNumOfPackets))) {
+      break;
+    }
+    usleep(10000);
+  }
+
+  return loaded && pcapng->valid;
+}
+
+static test_packet_t *test_add(uint16_t linkType, const char *name, uint32_t caplen,
+                               uint32_t length, uint32_t flags) {
+  test_packet_t *packet = &testPackets[testNumOfPackets++];
+
+  packet->linkType = linkType;
+  packet->name = name;
+  packet->caplen = caplen;
+  packet->length = length;
+  packet->flags = flags;
+  memset(packet->data, 0, sizeof(packet->data));
+
+  return packet;
+}
+
+static void test_random(uint8_t *data, size_t length) {
+  size_t i;
+
+  for (i = 0; i < length; i++) {
+    data[i] = (uint8_t)rand();
+  }
+}
+
+static void test_can(uint8_t channel, uint32_t canid, uint8_t dlc, boolean isRx) {
+  static char names[TEST_MAX_PACKETS][16];
+  test_packet_t *packet;
+  uint32_t id = canid;
+  uint8_t data[64];
+
+  snprintf(names[testNumOfPackets], sizeof(names[0]), "can%u", channel);
+  packet = test_add(TEST_LINKTYPE_CAN_SOCKETCAN, names[testNumOfPackets], (dlc > 8) ? 72 : 16,
+                    (dlc > 8) ? 72 : 16, isRx ? TEST_FLAG_INBOUND : TEST_FLAG_OUTBOUND);
+  if ((0 != (id & 0x80000000u)) || (id > 0x7FFu)) {
+    id = (id & 0x1FFFFFFFu) | 0x80000000u;
+  }
+  packet->data[0] = (uint8_t)(id >> 24);
+  packet->data[1] = (uint8_t)(id >> 16);
+  packet->data[2] = (uint8_t)(id >> 8);
+  packet->data[3] = (uint8_t)id;
+  packet->data[4] = dlc;
+  packet->data[5] = (dlc > 8) ? 0x04 : 0;
+  test_random(data, dlc);
+  memcpy(&packet->data[8], data, dlc);
+  PCap_Can(channel, canid, dlc, data, isRx);
+}
+
+static void test_lin(uint8_t channel, uint8_t pid, uint8_t dlc, boolean isRx) {
+  test_packet_t *packet;
+  uint8_t data[8];
+
+  packet = test_add(TEST_LINKTYPE_LIN, "lin0", 8 + dlc, 8 + dlc,
+                    isRx ? TEST_FLAG_INBOUND : TEST_FLAG_OUTBOUND);
+  test_random(data, dlc);
+  packet->data[0] = 1;
+  packet->data[4] = (uint8_t)(dlc << 4);
+  packet->data[5] = pid;
+  packet->data[6] = 0xA5;
+  memcpy(&packet->data[8], data, dlc);
+  PCap_Lin(channel, pid, dlc, data, 0xA5, isRx);
+}
+
+static void test_eth(uint32_t length) {
+  static uint8_t frame[TEST_ETH_LENGTH];
+  test_packet_t *packet;
+
+  packet = test_add(TEST_LINKTYPE_ETHERNET, "eth0",
+                    (length < TEST_SNAPLEN) ? length : TEST_SNAPLEN, length, 0);
+  test_random(frame, length);
+  memcpy(packet->data, frame, packet->caplen);
+  PCap_Packet(frame, length);
+}
+
+/* returns the number of packets found in the capture order with their interface */
+static uint32_t test_check_packets(const test_pcapng_t *pcapng) {
+  const test_packet_t *packet;
+  const test_epb_t *epb;
+  const test_idb_t *idb;
+  uint64_t timestamp = testStartTime;
+  uint32_t i;
+  bool ok = true;
+
+  for (i = 0; (i < testNumOfPackets) && (i < pcapng->numOfEpbs) && ok; i++) {
+    packet = &testPackets[i];
+    epb = &pcapng->epbs[i];
+    ok = (epb->id < pcapng->numOfIdbs) && (epb->timestamp >= timestamp) &&
+         (epb->timestamp <= test_get_time());
+    if (ok) {
+      idb = &pcapng->idbs[epb->id];
+      ok = (packet->linkType == idb->linkType) && (0 == strcmp(packet->name, idb->name)) &&
+           (TEST_SNAPLEN == idb->snaplen) && (9 == idb->tsresol) &&
+           (packet->caplen == epb->caplen) && (packet->length == epb->length) &&
+           (packet->flags == epb->flags) && (0 == memcmp(packet->data, epb->data, epb->caplen));
+      timestamp = epb->timestamp;
+    }
+    if (false == ok) {
+      printf("  packet %u on %s: interface %u of %u, caplen %u length %u flags %u\n", i,
+             packet->name, epb->id, pcapng->numOfIdbs, epb->caplen, epb->length, epb->flags);
+      break;
+    }
+  }
+
+  return i;
+}
+
+static void Test_Packets(void) {
+  uint32_t found = 0;
+  bool bPass;
+
+  printf("Test CAN, CAN FD, LIN and Ethernet packets are parsed back:");
+  test_can(0, 0x123, 8, TRUE);
+  test_can(1, 0x18DAF110u | 0x80000000u, 3, FALSE);
+  test_can(0, 0x456, 64, FALSE);
+  test_can(1, 0x7FF, 0, TRUE);
+  test_lin(0, 0x3C, 8, FALSE);
+  test_lin(0, 0x7D, 2, TRUE);
+  test_eth(60);
+  test_eth(TEST_ETH_LENGTH);
+  test_can(0, 0x124, 12, TRUE);
+
+  bPass = test_wait(&testPcapng);
+  if (bPass) {
+    found = test_check_packets(&testPcapng);
+    bPass = (testNumOfPackets == found) && (testNumOfPackets == testPcapng.numOfEpbs) &&
+            (4 == testPcapng.numOfIdbs);
+  }
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %s, %u of %u packets ok in %u blocks, %u interfaces\n",
+           testPcapng.valid ? "valid" : "invalid", found, testNumOfPackets, testPcapng.numOfEpbs,
+           testPcapng.numOfIdbs);
+    exit(-1);
+  }
+}
+
+static void Test_TooManyInterfaces(void) {
+  uint32_t found = 0;
+  uint32_t interfaces = testPcapng.numOfIdbs;
+  uint8_t channel;
+  bool bPass;
+
+  printf("Test the packets beyond %u interfaces are dropped:", TEST_MAX_INTERFACES);
+  for (channel = 2; channel < 20; channel++) {
+    if (interfaces < TEST_MAX_INTERFACES) {
+      test_can(channel, 0x200 + channel, 8, TRUE);
+      interfaces++;
+    } else {
+      PCap_Can(channel, 0x200 + channel, 0, NULL, TRUE);
+    }
+  }
+  /* the interfaces already described keep their packets */
+  test_can(1, 0x201, 8, FALSE);
+  test_eth(64);
+
+  bPass = test_wait(&testPcapng);
+  if (bPass) {
+    found = test_check_packets(&testPcapng);
+    bPass = (testNumOfPackets == found) && (testNumOfPackets == testPcapng.numOfEpbs) &&
+            (TEST_MAX_INTERFACES == testPcapng.numOfIdbs);
+  }
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  %s, %u of %u packets ok in %u blocks, %u interfaces\n",
+           testPcapng.valid ? "valid" : "invalid", found, testNumOfPackets, testPcapng.numOfEpbs,
+           testPcapng.numOfIdbs);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  char *name = getenv("PCAP_PATH");
+
+  (void)argc;
+  (void)argv;
+
+  srand(1);
+  if (NULL == name) {
+    snprintf(testPath, sizeof(testPath), "wireshark.pcapng");
+  } else {
+    snprintf(testPath, sizeof(testPath), "%s.pcapng", name);
+  }
+  testStartTime = test_get_time();
+
+  Test_Packets();
+  Test_TooManyInterfaces();
+
+  free(testPcapng.file);
+
+  return 0;
+}
@@ -39,7 +39,7 @@ extern "C" {
 Fls_ConfigType Fls_Config;
 Fee_ConfigType Fee_Config;
 }
-extern uint8_t g_FlsAcMirror[];
+extern uint8_t *g_FlsAcMirror;
 
 static Fls_SectorType *Fls_Sectors = nullptr;
 static Fee_BankType *Fee_Banks = nullptr;
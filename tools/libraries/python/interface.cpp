@@ -5,12 +5,14 @@
  */
 /* ================================ [ INCLUDES  ] ============================================== */
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <string>
 #include <thread>
 #include <chrono>
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include "canlib.h"
 #include "isotp.h"
 #include "Log.hpp"
@@ -54,6 +56,20 @@ template <typename To, typename Ti> To get(py::kwargs &kwargs, std::string key,
   return r;
 }
 /* ================================ [ TYPES     ] ============================================== */
+/* one row of the NumPy structured array used by can.read_many/write_many */
+typedef struct {
+  uint64_t timestamp; /* in nanoseconds */
+  uint32_t id;
+  uint8_t dlc;
+  uint8_t data[CAN_MAX_MTU];
+} can_np_frame_t;
+
+/* the rows keep the C padding, the same layout as np.dtype([...], align=True) */
+static_assert((0 == offsetof(can_np_frame_t, timestamp)) && (8 == offsetof(can_np_frame_t, id)) &&
+                (12 == offsetof(can_np_frame_t, dlc)) && (13 == offsetof(can_np_frame_t, data)),
+              "unexpected can_np_frame_t field offsets");
+static_assert(80 == sizeof(can_np_frame_t), "unexpected can_np_frame_t size");
+
 class can {
 public:
   can(std::string device, uint32_t port, uint32_t baudrate) {
@@ -73,27 +89,17 @@ public:
   }
 
   py::object read(uint32_t canid, uint32_t timeoutMs = 0) {
-    uint32_t rcanid = canid;
-    uint8_t data[64];
-    uint8_t dlc = sizeof(data);
-    bool r = FALSE;
-    r = can_read(busid, &rcanid, &dlc, data);
-    while (FALSE == r) {
-      if (timeoutMs > 0) {
-        timeoutMs--;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-      } else {
-        break;
-      }
-      rcanid = canid;
-      dlc = sizeof(data);
-      r = can_read(busid, &rcanid, &dlc, data);
+    can_frame_t frame;
+    bool r;
+    {
+      py::gil_scoped_release release;
+      r = read_frame(canid, timeoutMs, &frame);
     }
     py::list L;
     L.append(py::bool_(r));
     if (true == r) {
-      L.append(py::int_(rcanid));
-      L.append(py::bytes((char *)data, dlc));
+      L.append(py::int_(frame.canid));
+      L.append(py::bytes((char *)frame.data, frame.dlc));
     } else {
       L.append(py::none());
       L.append(py::none());
@@ -103,7 +109,115 @@ public:
 
   bool write(uint32_t canid, py::bytes b) {
     std::string str = b;
-    bool r = can_write(busid, canid, (uint8_t)str.size(), (uint8_t *)str.data());
+    bool r;
+    {
+      py::gil_scoped_release release;
+      r = can_write(busid, canid, (uint8_t)str.size(), (uint8_t *)str.data());
+    }
+    return r;
+  }
+
+  /* wait up to timeoutMs for the first frame, then drain whatever is already queued */
+  py::array_t<can_np_frame_t> read_many(uint32_t canid, uint32_t maxFrames, uint32_t timeoutMs) {
+    register_np_dtype();
+    py::array_t<can_np_frame_t> frames(maxFrames);
+    can_np_frame_t *rows = frames.mutable_data();
+    can_frame_t frame;
+    size_t count = 0;
+    {
+      py::gil_scoped_release release;
+      bool r = (maxFrames > 0) && read_frame(canid, timeoutMs, &frame);
+      while (true == r) {
+        rows[count].timestamp = frame.timestamp;
+        rows[count].id = frame.canid;
+        rows[count].dlc = frame.dlc;
+        memcpy(rows[count].data, frame.data, sizeof(rows[count].data));
+        count++;
+        if (count >= maxFrames) {
+          break;
+        }
+        frame.canid = canid;
+        r = can_read_v2(busid, &frame);
+      }
+    }
+    frames.resize({(py::ssize_t)count});
+    return frames;
+  }
+
+  size_t write_many(py::object obj) {
+    register_np_dtype();
+    auto frames =
+      py::array_t<can_np_frame_t, py::array::c_style | py::array::forcecast>::ensure(obj);
+    if (!frames || (1 != frames.ndim())) {
+      throw std::runtime_error("frames shall be a 1-D array of (timestamp, id, dlc, data[64])");
+    }
+    auto rows = frames.unchecked<1>();
+    size_t count = 0;
+    can_frame_t frame;
+    py::gil_scoped_release release;
+    for (py::ssize_t i = 0; i < rows.shape(0); i++) {
+      frame.canid = rows(i).id;
+      frame.dlc = rows(i).dlc;
+      frame.timestamp = rows(i).timestamp;
+      memcpy(frame.data, rows(i).data, sizeof(frame.data));
+      if (false == can_write_v2(busid, &frame)) {
+        break;
+      }
+      count++;
+    }
+    return count;
+  }
+
+  /* blocking read for the async iterator, runs in an executor thread of the event loop */
+  py::object next_frame(uint32_t canid, uint32_t timeoutMs) {
+    can_frame_t frame;
+    bool r;
+    {
+      py::gil_scoped_release release;
+      r = read_frame(canid, timeoutMs, &frame);
+    }
+    if (false == r) {
+      PyErr_SetNone(PyExc_StopAsyncIteration);
+      throw py::error_already_set();
+    }
+    return py::make_tuple(py::int_(frame.timestamp), py::int_(frame.canid),
+                          py::bytes((char *)frame.data, frame.dlc));
+  }
+
+  static py::dtype frame_dtype() {
+    register_np_dtype();
+    return py::dtype::of<can_np_frame_t>();
+  }
+
+private:
+  /* numpy is only imported once the bulk API is used */
+  static void register_np_dtype() {
+    static bool registered = false;
+    if (false == registered) {
+      PYBIND11_NUMPY_DTYPE(can_np_frame_t, timestamp, id, dlc, data);
+      registered = true;
+    }
+  }
+
+  bool read_frame(uint32_t canid, uint32_t timeoutMs, can_frame_t *frame) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    frame->canid = canid;
+    bool r = can_read_v2(busid, frame);
+    while ((false == r) && (timeoutMs > 0)) {
+      if (false == can_wait_v2(busid, canid, timeoutMs)) {
+        break;
+      }
+      frame->canid = canid;
+      r = can_read_v2(busid, frame);
+      if (false == r) { /* stolen by another reader, wait for the time left */
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+          break;
+        }
+        timeoutMs =
+          (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+      }
+    }
     return r;
   }
 
@@ -111,6 +225,30 @@ private:
   int busid;
 };
 
+/* "async for ts, canid, data in bus.aiter(canid, timeoutMs)", stops after timeoutMs of silence */
+class can_aiter {
+public:
+  can_aiter(can &bus, uint32_t canid, uint32_t timeoutMs)
+    : m_Bus(bus), m_CanId(canid), m_TimeoutMs(timeoutMs) {
+  }
+
+  py::object anext(py::object self) {
+    py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+    uint32_t canid = m_CanId;
+    uint32_t timeoutMs = m_TimeoutMs;
+    can *bus = &m_Bus;
+    /* self is captured to keep the bus object alive while the read is pending */
+    py::cpp_function fn(
+      [self, bus, canid, timeoutMs]() { return bus->next_frame(canid, timeoutMs); });
+    return loop.attr("run_in_executor")(py::none(), fn);
+  }
+
+private:
+  can &m_Bus;
+  uint32_t m_CanId;
+  uint32_t m_TimeoutMs;
+};
+
 class lin {
 public:
   lin(py::kwargs kwargs) {
@@ -140,7 +278,11 @@ public:
 
   py::object read(lin_id_t id, int dlc) {
     uint8_t data[64];
-    bool r = lin_read(busid, id, (uint8_t)dlc, data, enhanced, timeout);
+    bool r;
+    {
+      py::gil_scoped_release release;
+      r = lin_read(busid, id, (uint8_t)dlc, data, enhanced, timeout);
+    }
     py::list L;
     L.append(py::bool_(r));
     if (true == r) {
@@ -155,7 +297,11 @@ public:
 
   bool write(lin_id_t id, py::bytes b) {
     std::string str = b;
-    bool r = lin_write(busid, id, (uint8_t)str.size(), (uint8_t *)str.data(), enhanced);
+    bool r;
+    {
+      py::gil_scoped_release release;
+      r = lin_write(busid, id, (uint8_t)str.size(), (uint8_t *)str.data(), enhanced);
+    }
     return r;
   }
 
@@ -230,7 +376,10 @@ public:
 
     (void)isotp_ioctl(tp, ISOTP_IOCTL_SET_TIMEOUT, &timeoutUs, sizeof(uint32_t));
 
-    r = isotp_transmit(tp, (uint8_t *)str.data(), str.size(), nullptr, 0);
+    {
+      py::gil_scoped_release release;
+      r = isotp_transmit(tp, (uint8_t *)str.data(), str.size(), nullptr, 0);
+    }
     return (0 == r);
   }
 
@@ -240,7 +389,10 @@ public:
 
     (void)isotp_ioctl(tp, ISOTP_IOCTL_SET_TIMEOUT, &timeoutUs, sizeof(uint32_t));
 
-    r = isotp_receive(tp, buffer, sizeof(buffer));
+    {
+      py::gil_scoped_release release;
+      r = isotp_receive(tp, buffer, sizeof(buffer));
+    }
 
     if (r > 0) {
       return py::bytes((const char *)buffer, r);
@@ -534,7 +686,23 @@ PYBIND11_MODULE(AsPy, m) {
          py::arg("port") = 0, py::arg("baudrate") = 500000)
     .def("is_opened", &can::is_opened)
     .def("read", &can::read, py::arg("canid"), py::arg("timeoutMs") = 0)
-    .def("write", &can::write, py::arg("canid"), py::arg("data"));
+    .def("write", &can::write, py::arg("canid"), py::arg("data"))
+    .def("read_many", &can::read_many, py::arg("canid") = (uint32_t)-1,
+         py::arg("maxFrames") = 1024, py::arg("timeoutMs") = 0,
+         "read up to maxFrames as a NumPy structured array (timestamp, id, dlc, data[64])")
+    .def("write_many", &can::write_many, py::arg("frames"),
+         "write a NumPy structured array (timestamp, id, dlc, data[64]), returns frames written")
+    .def_static("frame_dtype", &can::frame_dtype,
+                "the NumPy dtype of the rows of read_many/write_many, itemsize 80")
+    .def(
+      "aiter",
+      [](py::object self, uint32_t canid, uint32_t timeoutMs) {
+        return can_aiter(self.cast<can &>(), canid, timeoutMs);
+      },
+      py::arg("canid") = (uint32_t)-1, py::arg("timeoutMs") = 1000, py::keep_alive<0, 1>());
+  py::class_<can_aiter>(m, "can_aiter")
+    .def("__aiter__", [](py::object self) { return self; })
+    .def("__anext__", [](py::object self) { return self.cast<can_aiter &>().anext(self); });
   py::class_<lin>(m, "lin")
     .def(py::init<py::kwargs>(), LIN_KWARGS)
     .def("is_opened", &lin::is_opened)
@@ -0,0 +1,117 @@
+import os
+import sys
+import time
+import asyncio
+import logging
+import multiprocessing
+
+import numpy as np
+
+CWD = os.path.dirname(__file__)
+if CWD == "":
+    CWD = os.path.abspath(".")
+
+ASONE = os.path.abspath("%s/../../../asone" % (CWD))
+sys.path.append(ASONE)
+
+from one.AsPy import can
+
+logging.basicConfig(
+    level=logging.INFO, format="%(asctime)s - %(filename)s[line:%(lineno)d] - %(levelname)s: %(message)s"
+)
+
+# the C struct can_np_frame_t keeps its padding, so the rows are 80 bytes, not 77
+FRAME = np.dtype([("timestamp", "<u8"), ("id", "<u4"), ("dlc", "u1"), ("data", "u1", (64,))], align=True)
+assert FRAME.itemsize == 80
+assert FRAME.itemsize == can.frame_dtype().itemsize
+for name in FRAME.names:
+    assert FRAME.fields[name][1] == can.frame_dtype().fields[name][1], name
+
+
+def writer(args, count, ready):
+    n0 = can(args.device, args.port)
+    frames = np.zeros(args.burst, dtype=FRAME)
+    frames["id"] = eval(args.canid)
+    frames["dlc"] = 8
+    ready.wait()
+    sent = 0
+    while sent < count:
+        n = min(args.burst, count - sent)
+        frames["data"][:n, 0:4] = np.arange(sent, sent + n, dtype="<u4").view("u1").reshape(n, 4)
+        sent += n0.write_many(frames[:n])
+
+
+def measure(args, name, reader):
+    n0 = can(args.device, args.port)
+    ready = multiprocessing.Event()
+    p = multiprocessing.Process(target=writer, args=(args, args.count, ready))
+    p.start()
+    time.sleep(0.5)
+    ready.set()
+    start = time.time()
+    received = reader(n0)
+    elapsed = time.time() - start
+    p.join()
+    logging.info("%s: %d/%d frames in %.3fs, %.0f frames/s" % (name, received, args.count, elapsed, received / elapsed))
+
+
+def read_one_by_one(args):
+    canid = eval(args.canid)
+
+    def reader(n0):
+        received = 0
+        while received < args.count:
+            r, _, _ = n0.read(canid, 1000)
+            if not r:
+                break
+            received += 1
+        return received
+
+    return reader
+
+
+def read_bulk(args):
+    canid = eval(args.canid)
+
+    def reader(n0):
+        received = 0
+        while received < args.count:
+            frames = n0.read_many(canid, args.burst, 1000)
+            if len(frames) == 0:
+                break
+            received += len(frames)
+        return received
+
+    return reader
+
+
+def read_async(args):
+    canid = eval(args.canid)
+
+    async def consume(n0):
+        received = 0
+        async for ts, cid, data in n0.aiter(canid, 1000):
+            received += 1
+            if received >= args.count:
+                break
+        return received
+
+    def reader(n0):
+        return asyncio.run(consume(n0))
+
+    return reader
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser(description="AsPy CAN bulk read/write throughput")
+    parser.add_argument("-d", "--device", type=str, help="CAN device", default="simulator_v2")
+    parser.add_argument("-p", "--port", type=int, help="CAN port", default=0)
+    parser.add_argument("-i", "--canid", type=str, help="CAN ID used for the test", default="0x123")
+    parser.add_argument("-n", "--count", type=int, help="number of frames", default=20000)
+    parser.add_argument("-b", "--burst", type=int, help="frames per write_many/read_many", default=64)
+    args = parser.parse_args()
+    measure(args, "read", read_one_by_one(args))
+    measure(args, "read_many", read_bulk(args))
+    measure(args, "aiter", read_async(args))
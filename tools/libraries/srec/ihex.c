@@ -4,7 +4,7 @@
  * ref: https://www.engineersgarage.com/hex-file-format/
  */
 /* ================================ [ INCLUDES  ] ============================================== */
-#include "srec.h"
+#include "srec_priv.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -20,209 +20,139 @@
 #define IHEX_TYPE_EXTEND_LINEAR_ADDR 0x04
 #define IHEX_TYPE_START_LINEAR_ADDR 0x05
 /* ================================ [ TYPES     ] ============================================== */
-typedef struct {
-  uint8_t CC; /* Character Count */
-  uint16_t addr;
-  uint8_t type;
-  uint8_t data[IHEX_MAX_ONE_LINE / 2];
-} ihex_line_t;
 /* ================================ [ DECLARES  ] ============================================== */
 /* ================================ [ DATAS     ] ============================================== */
 /* ================================ [ LOCALS    ] ============================================== */
-static uint8_t ihex_hex(const char *str) {
-  char hexs[3];
-  hexs[0] = str[0];
-  hexs[1] = str[1];
-  hexs[2] = '\0';
-
-  return (uint8_t)strtoul(hexs, NULL, 16);
-}
-
-static int ihex_decode(const char *sline, int slen, ihex_line_t *iln) {
+static int ihex_decode(const char *line, const srec_line_t *ln, uint8_t *dst) {
   int err = 0;
-  int i;
-  uint8_t checksum = 0;
   uint8_t sum = 0;
+  int i;
 
-  iln->CC = ihex_hex(&sline[1]);
-  if ((iln->CC * 2 + IHEX_MINUMU_LENGTH) > slen) {
-    err = -__LINE__;
-  }
-
-  iln->addr = ihex_hex(&sline[3]);
-  iln->addr = (iln->addr << 8) + ihex_hex(&sline[5]);
-  iln->type = ihex_hex(&sline[7]);
-
-  sum = iln->CC + ((iln->addr >> 8) & 0xFF) + (iln->addr & 0xFF) + iln->type;
-
-  for (i = 0; i < iln->CC; i++) {
-    iln->data[i] = ihex_hex(&sline[9 + i * 2]);
-    sum += iln->data[i];
+  for (i = 1; i < 9; i += 2) {
+    sum += (uint8_t)srec_hex_byte(&line[i]);
   }
 
-  sum = 1 + (~sum);
-
-  checksum = ihex_hex(&sline[9 + iln->CC * 2]);
-
-  if (sum != checksum) {
+  if (0 != srec_hex_decode(ln->data, dst, ln->length)) {
     err = -__LINE__;
   }
 
-  return err;
-}
-
-static int ihex_get_extend_segment_addr(ihex_line_t *iln, uint32_t *addr) {
-  int err = 0;
-
-  if (2 == iln->CC) {
-    *addr = ((uint32_t)iln->data[0] << 12) + ((uint32_t)iln->data[1] << 4);
-  } else {
-    err = -__LINE__;
+  for (i = 0; i < (int)ln->length; i++) {
+    sum += dst[i];
   }
 
-  return err;
-}
-
-static int ihex_get_extend_linear_addr(ihex_line_t *iln, uint32_t *addr) {
-  int err = 0;
+  sum = 1 + (~sum);
 
-  if (2 == iln->CC) {
-    *addr = ((uint32_t)iln->data[0] << 24) + ((uint32_t)iln->data[1] << 16);
-  } else {
+  if ((0 == err) && (sum != srec_hex_byte(&ln->data[2 * ln->length]))) {
     err = -__LINE__;
   }
 
   return err;
 }
 
-static int ihex_get_start_linear_addr(ihex_line_t *iln) {
+static int ihex_scan(const char *line, const char *end, srec_line_t *ln, int report) {
   int err = 0;
-  uint32_t addr;
-
-  if (4 == iln->CC) {
-    addr = ((uint32_t)iln->data[0] << 24) + ((uint32_t)iln->data[1] << 16) +
-           ((uint32_t)iln->data[2] << 8) + iln->data[3];
-    printf("  Start Linear Address: <0x%x>\n", addr);
-  } else {
+  int CC = 0;
+  int addrH, addrL, type = IHEX_TYPE_END_RECORD;
+  uint8_t data[256];
+  const char *eol = line;
+
+  ln->type = SREC_LINE_SKIP;
+  if (('\r' == line[0]) || ('\n' == line[0])) {
+    /* empty line */
+  } else if (':' != line[0]) {
+    if (report) {
+      eol = (const char *)memchr(line, '\n', end - line);
+      printf("  invalid intel hex <%.*s>, ignore\n", (int)((NULL != eol) ? (eol - line) : 0),
+             line);
+      eol = line;
+    }
+  } else if ((end - line) < IHEX_MINUMU_LENGTH) {
     err = -__LINE__;
+  } else {
+    CC = srec_hex_byte(&line[1]);
+    addrH = srec_hex_byte(&line[3]);
+    addrL = srec_hex_byte(&line[5]);
+    type = srec_hex_byte(&line[7]);
+    if (((CC | addrH | addrL | type) < 0) || ((end - line) < (CC * 2 + IHEX_MINUMU_LENGTH))) {
+      err = -__LINE__;
+    } else {
+      ln->address = ((uint32_t)addrH << 8) + (uint32_t)addrL;
+      ln->length = (uint32_t)CC;
+      ln->data = &line[9];
+      eol = &line[CC * 2 + IHEX_MINUMU_LENGTH];
+    }
   }
 
-  return err;
-}
-
-static int ihex_add_data(ihex_line_t *iln, srec_t *srec, uint32_t base_addr) {
-  int err = 0;
-  sblk_t *curBlk = NULL;
-  uint32_t address = base_addr + iln->addr;
-  uint32_t offset;
-
-  if (0 == srec->numOfBlks) {
-    curBlk = &srec->blks[0];
-    curBlk->address = address;
-    curBlk->offset = 0;
-    curBlk->data = &srec->data[curBlk->offset];
-    curBlk->length = 0;
-    srec->numOfBlks++;
-  } else {
-    curBlk = &srec->blks[srec->numOfBlks - 1];
-    if ((curBlk->address + curBlk->length) != address) {
-      offset = curBlk->offset + curBlk->length;
-      srec->numOfBlks++;
-      if (srec->numOfBlks < SREC_MAX_BLK) {
-        curBlk = &srec->blks[srec->numOfBlks - 1];
-        curBlk->address = address;
-        curBlk->offset = offset;
-        curBlk->data = &srec->data[curBlk->offset];
-        curBlk->length = 0;
+  if ((0 == err) && (line != eol)) {
+    if (IHEX_TYPE_DATA_RECORD == type) {
+      ln->type = SREC_LINE_DATA;
+    } else if (report || (IHEX_TYPE_EXTEND_SEGMENT_ADDR == type) ||
+               (IHEX_TYPE_EXTEND_LINEAR_ADDR == type)) {
+      /* the address records are rare, verify them on the scan pass */
+      if (report) {
+        err = ihex_decode(line, ln, data);
       } else {
-        srec->numOfBlks--;
+        (void)srec_hex_decode(ln->data, data, ln->length);
+      }
+      switch (type) {
+      case IHEX_TYPE_END_RECORD:
+        break;
+      case IHEX_TYPE_EXTEND_SEGMENT_ADDR:
+        if (2 == CC) {
+          ln->type = SREC_LINE_BASE;
+          ln->address = ((uint32_t)data[0] << 12) + ((uint32_t)data[1] << 4);
+        } else {
+          err = -__LINE__;
+        }
+        break;
+      case IHEX_TYPE_START_SEGMENT_ADDR:
+        printf(" type 03 not supported, ignore\n");
+        break;
+      case IHEX_TYPE_EXTEND_LINEAR_ADDR:
+        if (2 == CC) {
+          ln->type = SREC_LINE_BASE;
+          ln->address = ((uint32_t)data[0] << 24) + ((uint32_t)data[1] << 16);
+        } else {
+          err = -__LINE__;
+        }
+        break;
+      case IHEX_TYPE_START_LINEAR_ADDR:
+        if (4 == CC) {
+          printf("  Start Linear Address: <0x%x>\n",
+                 ((uint32_t)data[0] << 24) + ((uint32_t)data[1] << 16) +
+                   ((uint32_t)data[2] << 8) + data[3]);
+        } else {
+          err = -__LINE__;
+        }
+        break;
+      default:
         err = -__LINE__;
+        break;
       }
+    } else {
+      /* already reported on the scan pass */
     }
   }
 
   if (0 == err) {
-    memcpy(&curBlk->data[curBlk->length], iln->data, iln->CC);
-    curBlk->length += iln->CC;
-    srec->totalSize += iln->CC;
+    eol = (const char *)memchr(eol, '\n', end - eol);
+    ln->next = (NULL != eol) ? (eol + 1) : end;
   }
-  return err;
-}
-
-static void ihex_parse(srec_t *srec, FILE *fp) {
-  int err = 0;
-  char sline[IHEX_MAX_ONE_LINE];
-  uint32_t addr = 0;
-  int slen;
-  int linno = 0;
-  ihex_line_t iln;
 
-  while ((0 == err) && fgets(sline, sizeof(sline), fp)) {
-    slen = strlen(sline);
-    if (sline[0] == '\n') {
-      /* do nothing */
-    } else if (sline[0] != ':') {
-      printf("  invalid intel hex <%s>, ignore\n", sline);
-    } else {
-      err = ihex_decode(sline, slen, &iln);
-      if (0 == err) {
-        switch (iln.type) {
-        case IHEX_TYPE_DATA_RECORD:
-          err = ihex_add_data(&iln, srec, addr);
-          break;
-        case IHEX_TYPE_END_RECORD:
-          break;
-        case IHEX_TYPE_EXTEND_SEGMENT_ADDR:
-          err = ihex_get_extend_segment_addr(&iln, &addr);
-          break;
-        case IHEX_TYPE_START_SEGMENT_ADDR:
-          printf(" type 03 not supported, ignore\n");
-          break;
-        case IHEX_TYPE_EXTEND_LINEAR_ADDR:
-          err = ihex_get_extend_linear_addr(&iln, &addr);
-          break;
-        case IHEX_TYPE_START_LINEAR_ADDR:
-          err = ihex_get_start_linear_addr(&iln);
-          break;
-        default:
-          err = -__LINE__;
-          break;
-        }
-      }
-      if (err) {
-        printf("invalid ihex at line %d, err=%d: <%s>\n", linno, err, sline);
-      }
-    }
-    linno++;
-  }
+  return err;
 }
 /* ================================ [ FUNCTIONS ] ============================================== */
 srec_t *ihex_open(const char *path) {
   srec_t *srec = NULL;
-  FILE *fp;
-  size_t sz;
+  srec_map_t map;
+  static const srec_format_t fmt = {"ihex", ihex_scan, ihex_decode, 0, 1};
 
-  fp = fopen(path, "r");
-  if (NULL != fp) {
-    fseek(fp, 0, SEEK_END);
-    sz = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-    srec = (srec_t *)malloc(sz / 2 + sizeof(srec_t));
+  if (0 == srec_map_open(&map, path)) {
+    srec = srec_parse_text(&fmt, map.text, map.size);
     if (NULL != srec) {
-      srec->data = (uint8_t *)&srec[1];
-      srec->numOfBlks = 0;
-      srec->totalSize = 0;
-      memset(srec->blks, 0, sizeof(srec->blks));
-      ihex_parse(srec, fp);
-      if (0 == srec->numOfBlks) {
-        free(srec);
-        srec = NULL;
-      } else {
-        srec->type = SREC_IHEX;
-      }
-    } else {
-      printf("no enough memory for %d bytes\n", (int)sz / 2);
+      srec->type = SREC_IHEX;
     }
+    srec_map_close(&map);
   } else {
     printf("ihex %s not exists\n", path);
   }
@@ -274,4 +204,4 @@ void ihex_add_line(FILE *fpS, uint32_t saddr, uint8_t *data, uint32_t len) {
   snprintf(&sline[ls], sizeof(sline) - ls, "%02X\n", checksum);
 
   fputs(sline, fpS);
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -3,7 +3,8 @@
  * Copyright (C) 2021 Parai Wang <parai@foxmail.com>
  */
 /* ================================ [ INCLUDES  ] ============================================== */
-#include "srec.h"
+#include "srec_priv.h"
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,14 +28,6 @@ static const char *const signTypeName[] = {
   "CRC16", "CRC32", "CRC16_V2", "CRC32_V2", "CRC16_V3", "CRC32_V3",
 };
 /* ================================ [ LOCALS    ] ============================================== */
-static uint8_t srec_hex(char *str) {
-  char hexs[3];
-  hexs[0] = str[0];
-  hexs[1] = str[1];
-  hexs[2] = '\0';
-
-  return (uint8_t)strtoul(hexs, NULL, 16);
-}
 /*
 An s record looks like:
 
@@ -69,155 +62,110 @@ upwards, modulo 256 and subtracted from 255.
 Command to padding s19 to align secion address by 32
 srec_cat in.s19 -fill 0xFF -within in.s19 -range-padding 32 -o out.s19 -address-length=4
 */
-static int srec_decode(srec_t *srec, char *sline, int slen, int addrLen) {
+static int srec_scan(const char *line, const char *end, srec_line_t *ln, int report) {
   int err = 0;
-  int dataLen = 0;
-  int i;
-  uint8_t checksum;
-  uint8_t sum = 0;
+  int count = 0;
+  int addrLen = 0;
+  int i, v;
   uint32_t address = 0;
-  size_t offset;
-  sblk_t *curBlk = NULL;
-  uint8_t v;
-  uint32_t gap;
-  uint32_t gapThresh = 8;
+  const char *eol = line;
 
-  char *str = getenv("FLASH_WRITE_SIZE");
-  if (str != NULL) {
-    gapThresh = strtoul(str, NULL, 10);
-  }
-
-  if (slen > 6) {
-    dataLen = srec_hex(&sline[2]);
-  } else {
+  (void)report;
+  ln->type = SREC_LINE_SKIP;
+  if (('\r' == line[0]) || ('\n' == line[0])) {
+    /* empty line */
+  } else if (((end - line) < 6) || ('S' != line[0])) {
     err = -1;
-  }
-
-  if (0 == err) {
-    if (((dataLen + 4) > slen) || (dataLen <= addrLen)) {
+  } else {
+    count = srec_hex_byte(&line[2]);
+    if ((count < 0) || ((end - line) < (4 + 2 * count))) {
       err = -2;
     }
   }
 
-  if (0 == err) {
-    sum += dataLen;
-    for (i = 0; i < addrLen; i++) {
-      v = srec_hex(&sline[4 + 2 * i]);
-      address = (address << 8) + v;
-      sum += v;
+  if ((0 == err) && ('S' == line[0])) {
+    switch (line[1]) {
+    case '1':
+      addrLen = 2;
+      break;
+    case '2':
+      addrLen = 3;
+      break;
+    case '3':
+      addrLen = 4;
+      break;
+    default:
+      break;
     }
 
-    if (0 == srec->numOfBlks) {
-      curBlk = &srec->blks[0];
-      curBlk->address = address;
-      curBlk->offset = 0;
-      curBlk->data = &srec->data[curBlk->offset];
-      curBlk->length = 0;
-      srec->numOfBlks++;
-    } else {
-      curBlk = &srec->blks[srec->numOfBlks - 1];
-      gap = address - (curBlk->address + curBlk->length);
-      if (gap < gapThresh) {
-        memset(&curBlk->data[curBlk->length], 0xFF, gap);
-        curBlk->length += gap;
+    if (addrLen > 0) {
+      if (count <= addrLen) {
+        err = -2;
       }
-      if ((curBlk->address + curBlk->length) != address) {
-        offset = curBlk->offset + curBlk->length;
-        srec->numOfBlks++;
-        if (srec->numOfBlks < SREC_MAX_BLK) {
-          curBlk = &srec->blks[srec->numOfBlks - 1];
-          curBlk->address = address;
-          curBlk->offset = offset;
-          curBlk->data = &srec->data[curBlk->offset];
-          curBlk->length = 0;
-        } else {
-          srec->numOfBlks--;
-          err = -3;
+      for (i = 0; (0 == err) && (i < addrLen); i++) {
+        v = srec_hex_byte(&line[4 + 2 * i]);
+        if (v < 0) {
+          err = -1;
         }
+        address = (address << 8) + (uint32_t)v;
       }
+      ln->type = SREC_LINE_DATA;
+      ln->address = address;
+      ln->length = (uint32_t)(count - addrLen - 1);
+      ln->data = &line[4 + 2 * addrLen];
     }
+    eol = &line[4 + 2 * count];
   }
 
   if (0 == err) {
-    for (i = 0; i < (dataLen - addrLen - 1); i++) {
-      v = srec_hex(&sline[4 + addrLen * 2 + 2 * i]);
-      curBlk->data[curBlk->length++] = v;
-      sum += v;
-    }
-
-    srec->totalSize += dataLen - addrLen - 1;
-
-    sum = (~sum) & 0xFF;
-    checksum = srec_hex(&sline[4 + 2 * (dataLen - 1)]);
-
-    if (sum != checksum) {
-      err = -4;
-    }
+    eol = (const char *)memchr(eol, '\n', end - eol);
+    ln->next = (NULL != eol) ? (eol + 1) : end;
   }
 
   return err;
 }
 
-static void srec_parse(srec_t *srec, FILE *fp) {
+static int srec_decode(const char *line, const srec_line_t *ln, uint8_t *dst) {
   int err = 0;
-  char sline[SREC_MAX_ONE_LINE];
-  int slen;
-  int linno = 0;
-
-  while ((0 == err) && fgets(sline, sizeof(sline), fp)) {
-    slen = strlen(sline);
-    if (sline[0] != 'S') {
-      err = -1;
-      printf("invalid SRecord <%s>\n", sline);
-    } else {
-      switch (sline[1]) {
-      case '1':
-        err = srec_decode(srec, sline, slen, 2);
-        break;
-      case '2':
-        err = srec_decode(srec, sline, slen, 3);
-        break;
-      case '3':
-        err = srec_decode(srec, sline, slen, 4);
-        break;
-      default:
-        break;
-      }
+  const char *str;
+  uint8_t sum = 0;
+  uint32_t i;
 
-      if (err) {
-        printf("invalid SRecord at line %d, err=%d: <%s>\n", linno, err, sline);
-      }
-    }
-    linno++;
+  for (str = &line[2]; str < ln->data; str += 2) {
+    sum += (uint8_t)srec_hex_byte(str);
+  }
+
+  if (0 != srec_hex_decode(ln->data, dst, ln->length)) {
+    err = -1;
   }
+
+  for (i = 0; i < ln->length; i++) {
+    sum += dst[i];
+  }
+
+  if ((0 == err) && ((uint8_t)(~sum) != srec_hex_byte(&ln->data[2 * ln->length]))) {
+    err = -4;
+  }
+
+  return err;
 }
 
 srec_t *srec_open_impl(const char *path) {
   srec_t *srec = NULL;
-  FILE *fp;
-  size_t sz;
+  srec_map_t map;
+  srec_format_t fmt = {"SRecord", srec_scan, srec_decode, 8, 0};
+  char *str = getenv("FLASH_WRITE_SIZE");
 
-  fp = fopen(path, "r");
-  if (NULL != fp) {
-    fseek(fp, 0, SEEK_END);
-    sz = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-    srec = (srec_t *)malloc(sz / 2 + sizeof(srec_t));
+  if (str != NULL) {
+    fmt.gapThresh = strtoul(str, NULL, 10);
+  }
+
+  if (0 == srec_map_open(&map, path)) {
+    srec = srec_parse_text(&fmt, map.text, map.size);
     if (NULL != srec) {
-      srec->data = (uint8_t *)&srec[1];
-      srec->numOfBlks = 0;
-      srec->totalSize = 0;
-      memset(srec->blks, 0, sizeof(srec->blks));
-      srec_parse(srec, fp);
-      if (0 == srec->numOfBlks) {
-        free(srec);
-        srec = NULL;
-      } else {
-        srec->type = SREC_SRECORD;
-      }
-    } else {
-      printf("no enough memory for %d bytes\n", (int)sz / 2);
+      srec->type = SREC_SRECORD;
     }
+    srec_map_close(&map);
   } else {
     printf("srecord %s not exists\n", path);
   }
@@ -269,17 +217,73 @@ static void srec_add_sign(srec_t *srec, FILE *fpS, srec_sign_type_t signType, ui
   SREC_ADD_LINE(fpS, saddr, data, len);
 }
 
+/* the signed copy starts with the original text, written from its mapping in one go */
+static FILE *srec_sign_create(const char *path) {
+  FILE *fpS = NULL;
+  srec_map_t map;
+  char sline[SREC_MAX_ONE_LINE];
+
+  if (0 == srec_map_open(&map, path)) {
+    snprintf(sline, sizeof(sline), "%s.sign", path);
+    fpS = fopen(sline, "wb");
+    if ((NULL != fpS) && (map.size > 0) && (1 != fwrite(map.text, map.size, 1, fpS))) {
+      fclose(fpS);
+      fpS = NULL;
+    }
+    srec_map_close(&map);
+  }
+
+  return fpS;
+}
+
+static uint32_t srec_sign_update(srec_sign_type_t signType, const uint8_t *data, size_t length,
+                                 uint32_t crc, boolean *first, FILE *fpB) {
+  if (length > 0) {
+    if (SREC_SIGN_CRC32 == signType) {
+      crc = Crc_CalculateCRC32(data, (uint32_t)length, *first ? 0xFFFFFFFFUL : crc, *first);
+    } else {
+      crc = Crc_CalculateCRC16(data, (uint32_t)length, *first ? 0xFFFF : (uint16_t)crc, *first);
+    }
+    *first = FALSE;
+    if (NULL != fpB) {
+      fwrite(data, length, 1, fpB);
+    }
+  }
+
+  return crc;
+}
+
+static uint32_t srec_sign_fill(srec_sign_type_t signType, size_t length, uint32_t crc,
+                               boolean *first, FILE *fpB) {
+  static uint8_t fill[4096];
+  size_t sz;
+
+  if (0xFF != fill[0]) {
+    memset(fill, 0xFF, sizeof(fill));
+  }
+
+  while (length > 0) {
+    sz = (length > sizeof(fill)) ? sizeof(fill) : length;
+    crc = srec_sign_update(signType, fill, sz, crc, first, fpB);
+    length -= sz;
+  }
+
+  return crc;
+}
+
 static int srec_sign_v1(const char *path, size_t total, srec_sign_type_t signType) {
   srec_t *srec;
   int r = 0;
-  uint8_t *buffer = NULL;
-  FILE *fpO = NULL;
   FILE *fpS = NULL;
   FILE *fpB = NULL;
-  uint32_t saddr, length;
-  int i;
-  uint32_t crc;
+  uint32_t saddr, length, pos;
+  sblk_t *blks[SREC_MAX_BLK];
+  sblk_t *blk;
+  int i, j;
+  uint32_t crc = 0;
   uint32_t crcLen = 2;
+  boolean first = TRUE;
+  uint8_t data[4];
   char sline[SREC_MAX_ONE_LINE];
 
   if (SREC_SIGN_CRC32 == signType) {
@@ -303,27 +307,19 @@ static int srec_sign_v1(const char *path, size_t total, srec_sign_type_t signTyp
   }
 
   if (0 == r) {
-    buffer = malloc(total);
-    if (NULL == buffer) {
-      r = ENOMEM;
-    }
-  }
-
-  if (0 == r) {
-    memset(buffer, 0xFF, total - crcLen);
-    for (i = 0; i < srec->numOfBlks; i++) {
-      memcpy(&buffer[srec->blks[i].address - saddr], srec->blks[i].data, srec->blks[i].length);
+    /* the blocks are streamed in address order with the gaps padded by 0xFF */
+    for (i = 0; i < (int)srec->numOfBlks; i++) {
+      blk = &srec->blks[i];
+      for (j = i; (j > 0) && (blks[j - 1]->address > blk->address); j--) {
+        blks[j] = blks[j - 1];
+      }
+      blks[j] = blk;
     }
-    if (SREC_SIGN_CRC32 == signType) {
-      crc = Crc_CalculateCRC32(buffer, total - crcLen, 0xFFFFFFFF, TRUE);
-      buffer[total - 4] = (crc >> 24) & 0xFF;
-      buffer[total - 3] = (crc >> 16) & 0xFF;
-      buffer[total - 2] = (crc >> 8) & 0xFF;
-      buffer[total - 1] = crc & 0xFF;
-    } else {
-      crc = Crc_CalculateCRC16(buffer, total - crcLen, 0xFFFF, TRUE);
-      buffer[total - 2] = (crc >> 8) & 0xFF;
-      buffer[total - 1] = crc & 0xFF;
+    for (i = 1; (0 == r) && (i < (int)srec->numOfBlks); i++) {
+      if ((blks[i - 1]->address + blks[i - 1]->length) > blks[i]->address) {
+        printf(" block 0x%X overlaps with block 0x%X\n", blks[i]->address, blks[i - 1]->address);
+        r = EINVAL;
+      }
     }
   }
 
@@ -331,33 +327,42 @@ static int srec_sign_v1(const char *path, size_t total, srec_sign_type_t signTyp
     strncpy(sline, path, strlen(path) - 3);
     strcat(sline, "bin");
     fpB = fopen(sline, "wb");
+    if (NULL == fpB) {
+      printf("\n\twarning: failed to create %s\n\n", sline);
+    }
+
+    pos = saddr;
+    for (i = 0; i < (int)srec->numOfBlks; i++) {
+      crc = srec_sign_fill(signType, blks[i]->address - pos, crc, &first, fpB);
+      crc = srec_sign_update(signType, blks[i]->data, blks[i]->length, crc, &first, fpB);
+      pos = blks[i]->address + (uint32_t)blks[i]->length;
+    }
+    crc = srec_sign_fill(signType, saddr + total - crcLen - pos, crc, &first, fpB);
+
     if (NULL != fpB) {
-      fwrite(buffer, total, 1, fpB);
+      if (SREC_SIGN_CRC32 == signType) {
+        data[0] = (crc >> 24) & 0xFF;
+        data[1] = (crc >> 16) & 0xFF;
+        data[2] = (crc >> 8) & 0xFF;
+        data[3] = crc & 0xFF;
+      } else {
+        data[0] = (crc >> 8) & 0xFF;
+        data[1] = crc & 0xFF;
+      }
+      fwrite(data, crcLen, 1, fpB);
       fclose(fpB);
-    } else {
-      printf("\n\twarning: failed to create %s\n\n", sline);
     }
   }
 
   if (0 == r) {
-    snprintf(sline, sizeof(sline), "%s.sign", path);
-    fpS = fopen(sline, "w");
+    fpS = srec_sign_create(path);
     if (NULL == fpS) {
       r = EACCES;
-    } else {
-      fpO = fopen(path, "r");
-      if (NULL == fpO) {
-        r = EACCES;
-      }
     }
   }
 
   if (0 == r) {
     saddr += total - crcLen;
-    while ((0 == r) && fgets(sline, sizeof(sline), fpO)) {
-      fputs(sline, fpS);
-    }
-
     srec_add_sign(srec, fpS, signType, saddr, crc, crcLen);
   }
 
@@ -367,17 +372,11 @@ static int srec_sign_v1(const char *path, size_t total, srec_sign_type_t signTyp
     printf(" okay\n");
   }
 
-  if (buffer) {
-    free(buffer);
-  }
-
   if (fpS) {
     fclose(fpS);
   }
 
-  if (fpO) {
-    fclose(fpO);
-  }
+  srec_close(srec);
 
   return r;
 }
@@ -388,10 +387,8 @@ static int srec_sign_v2(const char *path, size_t signAddr, srec_sign_type_t sign
   int i;
   uint32_t saddr, length;
   uint32_t crc = 0xFFFFFFFFUL;
-  FILE *fpO = NULL;
   FILE *fpS = NULL;
-  char sline[SREC_MAX_ONE_LINE];
-  uint8_t *data = (uint8_t *)sline;
+  uint8_t data[16];
 
   printf("sign %s by %s:\n", path, signTypeName[signType]);
 
@@ -419,23 +416,13 @@ static int srec_sign_v2(const char *path, size_t signAddr, srec_sign_type_t sign
   }
 
   if (0 == r) {
-    snprintf(sline, sizeof(sline), "%s.sign", path);
-    fpS = fopen(sline, "w");
+    fpS = srec_sign_create(path);
     if (NULL == fpS) {
       r = EACCES;
-    } else {
-      fpO = fopen(path, "r");
-      if (NULL == fpO) {
-        r = EACCES;
-      }
     }
   }
 
   if (0 == r) {
-    while ((0 == r) && fgets(sline, sizeof(sline), fpO)) {
-      fputs(sline, fpS);
-    }
-
     saddr = signAddr;
     data[0] = (srec->numOfBlks >> 24) & 0xFF;
     data[1] = (srec->numOfBlks >> 16) & 0xFF;
@@ -479,9 +466,7 @@ static int srec_sign_v2(const char *path, size_t signAddr, srec_sign_type_t sign
     fclose(fpS);
   }
 
-  if (fpO) {
-    fclose(fpO);
-  }
+  srec_close(srec);
 
   return r;
 }
@@ -492,10 +477,8 @@ static int srec_sign_v3(const char *path, srec_sign_type_t signType) {
   int i;
   uint32_t saddr, signAddr = 0, length;
   uint32_t crc = 0xFFFFFFFFUL;
-  FILE *fpO = NULL;
   FILE *fpS = NULL;
-  char sline[SREC_MAX_ONE_LINE];
-  uint8_t *data = (uint8_t *)sline;
+  uint8_t data[16];
 
   printf("sign %s by %s:\n", path, signTypeName[signType]);
 
@@ -522,23 +505,13 @@ static int srec_sign_v3(const char *path, srec_sign_type_t signType) {
   }
 
   if (0 == r) {
-    snprintf(sline, sizeof(sline), "%s.sign", path);
-    fpS = fopen(sline, "w");
+    fpS = srec_sign_create(path);
     if (NULL == fpS) {
       r = EACCES;
-    } else {
-      fpO = fopen(path, "r");
-      if (NULL == fpO) {
-        r = EACCES;
-      }
     }
   }
 
   if (0 == r) {
-    while ((0 == r) && fgets(sline, sizeof(sline), fpO)) {
-      fputs(sline, fpS);
-    }
-
     saddr = signAddr;
     for (i = 0; i < srec->numOfBlks; i++) {
       data[0] = (srec->blks[i].address >> 24) & 0xFF;
@@ -582,9 +555,7 @@ static int srec_sign_v3(const char *path, srec_sign_type_t signType) {
     fclose(fpS);
   }
 
-  if (fpO) {
-    fclose(fpO);
-  }
+  srec_close(srec);
 
   return r;
 }
@@ -0,0 +1,555 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * The text file is mapped and split at line boundaries into chunks which are parsed in 2 passes:
+ * the scan pass only reads the line headers to collect the address runs of each chunk, the runs
+ * are then merged in file order into the coalesced blocks, which gives the exact image size and
+ * where each run lands, and the decode pass converts the payload straight to its final place.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "srec_priv.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if !defined(_MSC_VER)
+#include <pthread.h>
+#define SREC_USE_THREADS
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+/* ================================ [ MACROS    ] ============================================== */
+#define SREC_RUNS_INIT 64
+/* ================================ [ TYPES     ] ============================================== */
+/* lines with continuous addresses, gaps below the threshold included */
+typedef struct {
+  uint32_t address;
+  uint32_t length;
+  uint32_t numOfLines;
+  uint32_t gap; /* 0xFF bytes to fill before this run, set by the merge */
+  size_t dst;   /* offset in srec->data, set by the merge */
+  int relative; /* address is relative to the base at the chunk start */
+} srec_run_t;
+
+typedef struct {
+  const srec_format_t *fmt;
+  const char *start;
+  const char *end;
+  srec_run_t *runs;
+  size_t numOfRuns;
+  size_t capOfRuns;
+  size_t numOfLines;
+  size_t dataSize;
+  uint32_t base;     /* the base address at the chunk start, resolved by the merge */
+  uint32_t lastBase; /* the last base address set inside this chunk */
+  int hasBase;
+  uint8_t *data;
+  int err;
+  size_t errLine;
+  const char *errPos;
+} srec_chunk_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static const int8_t hexLut[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+/* ================================ [ LOCALS    ] ============================================== */
+#if defined(__SSE2__)
+/* 16 hex chars to 8 bytes */
+static int srec_hex_decode16(const char *hex, uint8_t *dst) {
+  __m128i v = _mm_loadu_si128((const __m128i *)hex);
+  __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+  __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  __m128i nibble = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                                _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+  /* each 16 bits lane has the high nibble in its low byte and the low nibble in its high byte */
+  __m128i hi = _mm_slli_epi16(_mm_and_si128(nibble, _mm_set1_epi16(0x00FF)), 4);
+  __m128i lo = _mm_srli_epi16(nibble, 8);
+
+  _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(_mm_or_si128(hi, lo), _mm_setzero_si128()));
+
+  return (0xFFFF == _mm_movemask_epi8(_mm_or_si128(digit, alpha))) ? 0 : -1;
+}
+#endif
+
+static srec_run_t *srec_chunk_add_run(srec_chunk_t *chunk) {
+  srec_run_t *runs = chunk->runs;
+  srec_run_t *run = NULL;
+  size_t cap = chunk->capOfRuns;
+
+  if (chunk->numOfRuns >= cap) {
+    cap = (0 == cap) ? SREC_RUNS_INIT : (cap * 2);
+    runs = (srec_run_t *)realloc(chunk->runs, cap * sizeof(srec_run_t));
+    if (NULL != runs) {
+      chunk->runs = runs;
+      chunk->capOfRuns = cap;
+    }
+  }
+
+  if (chunk->numOfRuns < chunk->capOfRuns) {
+    run = &chunk->runs[chunk->numOfRuns++];
+    memset(run, 0, sizeof(*run));
+  }
+
+  return run;
+}
+
+static void *srec_scan_chunk(void *arg) {
+  srec_chunk_t *chunk = (srec_chunk_t *)arg;
+  const srec_format_t *fmt = chunk->fmt;
+  const char *p = chunk->start;
+  srec_run_t *run = NULL;
+  srec_line_t ln;
+  uint32_t base = 0;
+  uint32_t address, gap = 0;
+  int relative = fmt->hasBase;
+  int err = 0;
+
+  while ((0 == err) && (p < chunk->end)) {
+    err = fmt->scan(p, chunk->end, &ln, 1);
+    if (0 != err) {
+      chunk->err = err;
+      chunk->errLine = chunk->numOfLines;
+      chunk->errPos = p;
+    } else if (SREC_LINE_BASE == ln.type) {
+      base = ln.address;
+      relative = 0;
+      chunk->hasBase = 1;
+      chunk->lastBase = base;
+    } else if (SREC_LINE_DATA == ln.type) {
+      address = base + ln.address;
+      if (NULL != run) {
+        gap = address - (run->address + run->length);
+      }
+      if ((NULL != run) && (run->relative == relative) &&
+          ((0u == gap) || (gap < fmt->gapThresh))) {
+        run->length += gap + ln.length;
+        run->numOfLines++;
+      } else {
+        run = srec_chunk_add_run(chunk);
+        if (NULL != run) {
+          run->address = address;
+          run->length = ln.length;
+          run->numOfLines = 1;
+          run->relative = relative;
+        } else {
+          err = chunk->err = -ENOMEM;
+          chunk->errLine = chunk->numOfLines;
+          chunk->errPos = p;
+        }
+      }
+      chunk->dataSize += ln.length;
+    } else {
+      /* nothing to do for the other lines */
+    }
+
+    if (0 == err) {
+      chunk->numOfLines++;
+      p = ln.next;
+    }
+  }
+
+  return NULL;
+}
+
+static void *srec_decode_chunk(void *arg) {
+  srec_chunk_t *chunk = (srec_chunk_t *)arg;
+  const srec_format_t *fmt = chunk->fmt;
+  const char *p = chunk->start;
+  srec_run_t *run = NULL;
+  srec_line_t ln;
+  uint32_t base = chunk->base;
+  uint32_t address, expected = 0;
+  uint32_t linesLeft = 0;
+  size_t k = 0;
+  size_t line = 0;
+  int err = 0;
+
+  while ((0 == err) && (p < chunk->end)) {
+    (void)fmt->scan(p, chunk->end, &ln, 0);
+    if (SREC_LINE_BASE == ln.type) {
+      base = ln.address;
+    } else if (SREC_LINE_DATA == ln.type) {
+      address = base + ln.address;
+      if (0u == linesLeft) {
+        run = &chunk->runs[k++];
+        linesLeft = run->numOfLines;
+        expected = run->address;
+        memset(&chunk->data[run->dst - run->gap], 0xFF, run->gap);
+      }
+      if (address != expected) {
+        memset(&chunk->data[run->dst + (expected - run->address)], 0xFF, address - expected);
+      }
+      err = fmt->decode(p, &ln, &chunk->data[run->dst + (address - run->address)]);
+      if (0 != err) {
+        chunk->err = err;
+        chunk->errLine = line;
+        chunk->errPos = p;
+      }
+      expected = address + ln.length;
+      linesLeft--;
+    } else {
+      /* nothing to do for the other lines */
+    }
+    line++;
+    p = ln.next;
+  }
+
+  return NULL;
+}
+
+static void srec_run_chunks(void *(*fn)(void *), srec_chunk_t *chunks, int numOfChunks) {
+  int i;
+#ifdef SREC_USE_THREADS
+  pthread_t threads[SREC_MAX_THREADS];
+  int started[SREC_MAX_THREADS];
+
+  for (i = 1; i < numOfChunks; i++) {
+    started[i] = (0 == pthread_create(&threads[i], NULL, fn, &chunks[i]));
+    if (!started[i]) {
+      fn(&chunks[i]);
+    }
+  }
+  fn(&chunks[0]);
+  for (i = 1; i < numOfChunks; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    }
+  }
+#else
+  for (i = 0; i < numOfChunks; i++) {
+    fn(&chunks[i]);
+  }
+#endif
+}
+
+static int srec_num_of_chunks(size_t size) {
+  long n = 1;
+#ifdef SREC_USE_THREADS
+  char *str = getenv("SREC_THREADS");
+
+  if (NULL != str) {
+    n = strtol(str, NULL, 10);
+  } else {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    n = (long)si.dwNumberOfProcessors;
+#else
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  }
+
+  if ((size_t)n > (size / SREC_CHUNK_MIN_SIZE)) {
+    n = (long)(size / SREC_CHUNK_MIN_SIZE);
+  }
+
+  if (n > SREC_MAX_THREADS) {
+    n = SREC_MAX_THREADS;
+  }
+#endif
+  if (n < 1) {
+    n = 1;
+  }
+
+  return (int)n;
+}
+
+static void srec_split_chunks(const srec_format_t *fmt, srec_chunk_t *chunks, int numOfChunks,
+                              const char *text, size_t size) {
+  const char *end = text + size;
+  const char *p = text;
+  const char *q;
+  int i;
+
+  memset(chunks, 0, sizeof(srec_chunk_t) * numOfChunks);
+  for (i = 0; i < numOfChunks; i++) {
+    chunks[i].fmt = fmt;
+    chunks[i].start = p;
+    if (i == (numOfChunks - 1)) {
+      p = end;
+    } else if ((size_t)(end - p) > (size / numOfChunks)) {
+      q = (const char *)memchr(p + size / numOfChunks, '\n', end - p - size / numOfChunks);
+      p = (NULL != q) ? (q + 1) : end;
+    } else {
+      p = end;
+    }
+    chunks[i].end = p;
+  }
+}
+
+/* resolve the run addresses and lay them out in the blocks */
+static int srec_merge_chunks(const srec_format_t *fmt, srec_chunk_t *chunks, int numOfChunks,
+                             srec_t *image) {
+  sblk_t *blk = NULL;
+  srec_run_t *run;
+  uint32_t base = 0;
+  uint32_t gap = 0;
+  size_t total = 0;
+  size_t k;
+  int err = 0;
+  int i;
+
+  for (i = 0; (0 == err) && (i < numOfChunks); i++) {
+    chunks[i].base = base;
+    for (k = 0; (0 == err) && (k < chunks[i].numOfRuns); k++) {
+      run = &chunks[i].runs[k];
+      if (run->relative) {
+        run->address += base;
+      }
+      if (NULL != blk) {
+        gap = run->address - (uint32_t)(blk->address + blk->length);
+      }
+      if ((NULL != blk) && ((0u == gap) || (gap < fmt->gapThresh))) {
+        run->gap = gap;
+        run->dst = blk->offset + blk->length + gap;
+        blk->length += gap + run->length;
+      } else if (image->numOfBlks < SREC_MAX_BLK) {
+        blk = &image->blks[image->numOfBlks++];
+        blk->address = run->address;
+        blk->offset = total;
+        blk->length = run->length;
+        run->gap = 0;
+        run->dst = blk->offset;
+      } else {
+        printf("invalid %s: more than %d blocks at address 0x%X\n", fmt->name, SREC_MAX_BLK,
+               run->address);
+        err = -3;
+      }
+      if (NULL != blk) {
+        total = blk->offset + blk->length;
+      }
+    }
+    image->totalSize += chunks[i].dataSize;
+    if (chunks[i].hasBase) {
+      base = chunks[i].lastBase;
+    }
+  }
+
+  return err;
+}
+
+static int srec_check_chunks(const srec_format_t *fmt, srec_chunk_t *chunks, int numOfChunks) {
+  const char *eol;
+  size_t line = 0;
+  int err = 0;
+  int i;
+
+  for (i = 0; (0 == err) && (i < numOfChunks); i++) {
+    if (0 != chunks[i].err) {
+      err = chunks[i].err;
+      eol = (const char *)memchr(chunks[i].errPos, '\n', chunks[i].end - chunks[i].errPos);
+      if (NULL == eol) {
+        eol = chunks[i].end;
+      }
+      if ((eol - chunks[i].errPos) > 80) {
+        eol = chunks[i].errPos + 80;
+      }
+      printf("invalid %s at line %d, err=%d: <%.*s>\n", fmt->name,
+             (int)(line + chunks[i].errLine), err, (int)(eol - chunks[i].errPos),
+             chunks[i].errPos);
+    }
+    line += chunks[i].numOfLines;
+  }
+
+  return err;
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int srec_map_open(srec_map_t *map, const char *path) {
+  int r = 0;
+  FILE *fp;
+  void *text = NULL;
+#ifdef _WIN32
+  LARGE_INTEGER size;
+
+  memset(map, 0, sizeof(*map));
+  map->hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (INVALID_HANDLE_VALUE == map->hFile) {
+    r = ENOENT;
+  } else if (GetFileSizeEx(map->hFile, &size) && (size.QuadPart > 0)) {
+    map->size = (size_t)size.QuadPart;
+    map->hMap = CreateFileMappingA(map->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (NULL != map->hMap) {
+      text = MapViewOfFile(map->hMap, FILE_MAP_READ, 0, 0, 0);
+    }
+  } else {
+    /* empty file */
+  }
+#else
+  struct stat st;
+  int fd;
+
+  memset(map, 0, sizeof(*map));
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    r = ENOENT;
+  } else {
+    if ((0 == fstat(fd, &st)) && (st.st_size > 0)) {
+      map->size = (size_t)st.st_size;
+      text = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (MAP_FAILED == text) {
+        text = NULL;
+      } else {
+        (void)madvise(text, map->size, MADV_SEQUENTIAL);
+      }
+    }
+    close(fd);
+  }
+#endif
+
+  if (NULL != text) {
+    map->text = (const char *)text;
+    map->mapped = 1;
+  } else if ((0 == r) && (map->size > 0)) {
+    /* no mapping on this file system, read it */
+    text = malloc(map->size);
+    fp = fopen(path, "rb");
+    if ((NULL != text) && (NULL != fp) && (1 == fread(text, map->size, 1, fp))) {
+      map->text = (const char *)text;
+    } else {
+      free(text);
+      r = ENOMEM;
+    }
+    if (NULL != fp) {
+      fclose(fp);
+    }
+  } else if (0 == r) {
+    map->text = "";
+  } else {
+    /* not exists */
+  }
+
+  if (0 != r) {
+    srec_map_close(map);
+  }
+
+  return r;
+}
+
+void srec_map_close(srec_map_t *map) {
+  if (map->mapped) {
+#ifdef _WIN32
+    UnmapViewOfFile((LPCVOID)map->text);
+#else
+    munmap((void *)map->text, map->size);
+#endif
+  } else if ((NULL != map->text) && (map->size > 0)) {
+    free((void *)map->text);
+  } else {
+    /* nothing mapped */
+  }
+
+#ifdef _WIN32
+  if (NULL != map->hMap) {
+    CloseHandle(map->hMap);
+  }
+  if ((NULL != map->hFile) && (INVALID_HANDLE_VALUE != map->hFile)) {
+    CloseHandle(map->hFile);
+  }
+#endif
+  memset(map, 0, sizeof(*map));
+}
+
+int srec_hex_byte(const char *hex) {
+  int hi = hexLut[(uint8_t)hex[0]];
+  int lo = hexLut[(uint8_t)hex[1]];
+
+  return ((hi | lo) < 0) ? -1 : ((hi << 4) | lo);
+}
+
+int srec_hex_decode(const char *hex, uint8_t *dst, uint32_t len) {
+  int bad = 0;
+  int hi, lo;
+  uint32_t i = 0;
+
+#if defined(__SSE2__)
+  for (; (i + 8u) <= len; i += 8u) {
+    bad |= srec_hex_decode16(&hex[2u * i], &dst[i]);
+  }
+#endif
+  for (; i < len; i++) {
+    hi = hexLut[(uint8_t)hex[2u * i]];
+    lo = hexLut[(uint8_t)hex[2u * i + 1u]];
+    bad |= hi | lo;
+    dst[i] = (uint8_t)((hi << 4) | (lo & 0x0F));
+  }
+
+  return (bad < 0) ? -1 : 0;
+}
+
+srec_t *srec_parse_text(const srec_format_t *fmt, const char *text, size_t size) {
+  srec_chunk_t chunks[SREC_MAX_THREADS];
+  srec_t image;
+  srec_t *srec = NULL;
+  size_t total = 0;
+  int numOfChunks;
+  int err;
+  int i;
+
+  memset(&image, 0, sizeof(image));
+  numOfChunks = srec_num_of_chunks(size);
+  srec_split_chunks(fmt, chunks, numOfChunks, text, size);
+
+  srec_run_chunks(srec_scan_chunk, chunks, numOfChunks);
+  err = srec_check_chunks(fmt, chunks, numOfChunks);
+  if (0 == err) {
+    err = srec_merge_chunks(fmt, chunks, numOfChunks, &image);
+  }
+
+  if ((0 == err) && (image.numOfBlks > 0)) {
+    total = image.blks[image.numOfBlks - 1].offset + image.blks[image.numOfBlks - 1].length;
+    srec = (srec_t *)malloc(sizeof(srec_t) + total);
+    if (NULL == srec) {
+      printf("no enough memory for %d bytes\n", (int)total);
+    }
+  }
+
+  if (NULL != srec) {
+    memcpy(srec, &image, sizeof(image));
+    srec->data = (uint8_t *)&srec[1];
+    for (i = 0; i < (int)srec->numOfBlks; i++) {
+      srec->blks[i].data = &srec->data[srec->blks[i].offset];
+    }
+    for (i = 0; i < numOfChunks; i++) {
+      chunks[i].data = srec->data;
+    }
+    srec_run_chunks(srec_decode_chunk, chunks, numOfChunks);
+    if (0 != srec_check_chunks(fmt, chunks, numOfChunks)) {
+      free(srec);
+      srec = NULL;
+    }
+  }
+
+  for (i = 0; i < numOfChunks; i++) {
+    free(chunks[i].runs);
+  }
+
+  return srec;
+}
@@ -0,0 +1,72 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ */
+#ifndef SREC_PRIV_H
+#define SREC_PRIV_H
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "srec.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+/* ================================ [ MACROS    ] ============================================== */
+#define SREC_LINE_SKIP 0
+#define SREC_LINE_DATA 1
+/* an ihex extended address record, the new base is in address */
+#define SREC_LINE_BASE 2
+
+/* text smaller than this is parsed by the calling thread only */
+#ifndef SREC_CHUNK_MIN_SIZE
+#define SREC_CHUNK_MIN_SIZE (4 * 1024 * 1024)
+#endif
+
+#ifndef SREC_MAX_THREADS
+#define SREC_MAX_THREADS 16
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+/* a read only view of the whole text file */
+typedef struct {
+  const char *text;
+  size_t size;
+#ifdef _WIN32
+  HANDLE hFile;
+  HANDLE hMap;
+#endif
+  int mapped;
+} srec_map_t;
+
+typedef struct {
+  const char *data; /* the hex chars of the payload */
+  const char *next; /* the start of the next line */
+  uint32_t address; /* for ihex data lines the 16 bits offset to the base */
+  uint32_t length;  /* payload bytes */
+  int type;
+} srec_line_t;
+
+typedef struct {
+  const char *name;
+  /* scan the line header without decoding the payload of data lines, return 0 if okay, report is
+   * set on the first of the 2 passes over the text to verify and print the other lines once */
+  int (*scan)(const char *line, const char *end, srec_line_t *ln, int report);
+  /* decode the payload of a data line to dst and verify the checksum, return 0 if okay */
+  int (*decode)(const char *line, const srec_line_t *ln, uint8_t *dst);
+  /* gaps smaller than this between 2 lines are filled with 0xFF */
+  uint32_t gapThresh;
+  /* the line addresses are relative to the last SREC_LINE_BASE line */
+  int hasBase;
+} srec_format_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+/* ================================ [ LOCALS    ] ============================================== */
+/* ================================ [ FUNCTIONS ] ============================================== */
+int srec_map_open(srec_map_t *map, const char *path);
+void srec_map_close(srec_map_t *map);
+
+/* return the byte value of the 2 hex chars or -1 if any of them is not a hex digit */
+int srec_hex_byte(const char *hex);
+/* decode 2*len hex chars to len bytes, return 0 if okay or -1 if not all hex digits */
+int srec_hex_decode(const char *hex, uint8_t *dst, uint32_t len);
+
+/* parse the text into exactly sized coalesced blocks, NULL on any error */
+srec_t *srec_parse_text(const srec_format_t *fmt, const char *text, size_t size);
+#endif /* SREC_PRIV_H */
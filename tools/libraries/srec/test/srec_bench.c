@@ -0,0 +1,247 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Generate a big S-Record and the same image as Intel HEX, then time the parsing with 1 thread
+ * and with all cores, verify the image against the generated data and time the signing. The
+ * chunk boundaries and the sign content are checked by srec_test.c.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "srec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef BENCH_TEXT_SIZE_MB
+#define BENCH_TEXT_SIZE_MB 256
+#endif
+
+#define BENCH_LINE_BYTES 32
+/* the first block has a hole smaller than FLASH_WRITE_SIZE, which is filled with 0xFF */
+#define BENCH_HOLE_SIZE 4
+#define BENCH_ADDRESS 0x80000000UL
+#define BENCH_SECOND_GAP 0x1000
+
+#ifdef _WIN32
+#define setenv(name, value, overwrite) _putenv_s(name, value)
+#define unsetenv(name) _putenv_s(name, "")
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t address;
+  uint32_t length;
+} Bench_BlockType;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static uint8_t *Bench_Image;
+static Bench_BlockType Bench_Blocks[3];
+static const char Bench_Hex[] = "0123456789ABCDEF";
+/* ================================ [ LOCALS    ] ============================================== */
+static double Bench_Now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void Bench_WriteSRecLine(FILE *fp, uint32_t address, const uint8_t *data, uint32_t len) {
+  char line[128];
+  uint8_t sum = (uint8_t)(len + 5);
+  int n;
+  uint32_t i;
+
+  sum += (uint8_t)(address >> 24) + (uint8_t)(address >> 16) + (uint8_t)(address >> 8) +
+         (uint8_t)address;
+  n = sprintf(line, "S3%02X%08X", len + 5, address);
+  for (i = 0; i < len; i++) {
+    line[n++] = Bench_Hex[data[i] >> 4];
+    line[n++] = Bench_Hex[data[i] & 0xF];
+    sum += data[i];
+  }
+  sprintf(&line[n], "%02X\n", (uint8_t)~sum);
+  fputs(line, fp);
+}
+
+static void Bench_WriteHexLine(FILE *fp, uint32_t *base, uint32_t address, const uint8_t *data,
+                               uint32_t len) {
+  char line[128];
+  uint8_t sum;
+  int n;
+  uint32_t i;
+
+  if ((address & 0xFFFF0000UL) != *base) {
+    *base = address & 0xFFFF0000UL;
+    sum = (uint8_t)(2 + 4 + (uint8_t)(*base >> 24) + (uint8_t)(*base >> 16));
+    fprintf(fp, ":02000004%04X%02X\n", *base >> 16, (uint8_t)(1 + ~sum));
+  }
+
+  sum = (uint8_t)(len + (uint8_t)(address >> 8) + (uint8_t)address);
+  n = sprintf(line, ":%02X%04X00", len, address & 0xFFFF);
+  for (i = 0; i < len; i++) {
+    line[n++] = Bench_Hex[data[i] >> 4];
+    line[n++] = Bench_Hex[data[i] & 0xF];
+    sum += data[i];
+  }
+  sprintf(&line[n], "%02X\n", (uint8_t)(1 + ~sum));
+  fputs(line, fp);
+}
+
+/* lines never cross a 64K boundary so that the ihex base records stay simple */
+static int Bench_Generate(const char *s19, const char *hex, size_t textSize) {
+  FILE *fpS = fopen(s19, "wb");
+  FILE *fpH = fopen(hex, "wb");
+  uint32_t base = 0xFFFFFFFFUL;
+  uint32_t total, offset, address, len;
+  int i, r = 0;
+
+  /* S3 line with 32 bytes payload is 79 chars */
+  total = (uint32_t)(textSize / 79 * BENCH_LINE_BYTES);
+  Bench_Blocks[0].address = BENCH_ADDRESS;
+  Bench_Blocks[0].length = total / 2;
+  Bench_Blocks[1].address = BENCH_ADDRESS + total / 2 + BENCH_HOLE_SIZE;
+  Bench_Blocks[1].length = total / 4;
+  Bench_Blocks[2].address = Bench_Blocks[1].address + total / 4 + BENCH_SECOND_GAP;
+  Bench_Blocks[2].length = total / 4;
+
+  Bench_Image = (uint8_t *)malloc(total);
+  if ((NULL == fpS) || (NULL == fpH) || (NULL == Bench_Image)) {
+    r = -1;
+  } else {
+    for (offset = 0; offset < total; offset++) {
+      Bench_Image[offset] = (uint8_t)rand();
+    }
+    fprintf(fpS, "S00F000068656C6C6F202020202000003C\n");
+    offset = 0;
+    for (i = 0; i < 3; i++) {
+      for (address = 0; address < Bench_Blocks[i].length; address += len) {
+        len = Bench_Blocks[i].length - address;
+        if (len > BENCH_LINE_BYTES) {
+          len = BENCH_LINE_BYTES;
+        }
+        Bench_WriteSRecLine(fpS, Bench_Blocks[i].address + address, &Bench_Image[offset], len);
+        Bench_WriteHexLine(fpH, &base, Bench_Blocks[i].address + address, &Bench_Image[offset],
+                           len);
+        offset += len;
+      }
+    }
+    fprintf(fpS, "S70580000000FA\n");
+    fprintf(fpH, ":00000001FF\n");
+  }
+
+  if (NULL != fpS) {
+    fclose(fpS);
+  }
+  if (NULL != fpH) {
+    fclose(fpH);
+  }
+
+  return r;
+}
+
+/* S-Record fills the hole of the first block with 0xFF, Intel HEX keeps it as a separate block */
+static int Bench_Verify(srec_t *srec) {
+  int filled = (SREC_SRECORD == srec->type);
+  size_t offset = 0;
+  size_t pos = 0;
+  int r = 0;
+  int i, j = 0;
+
+  if (srec->numOfBlks != (size_t)(filled ? 2 : 3)) {
+    r = -1;
+  }
+
+  for (i = 0; (0 == r) && (i < 3); i++) {
+    if ((0 == pos) && (srec->blks[j].address != Bench_Blocks[i].address)) {
+      r = -1;
+    } else if (0 != memcmp(&srec->blks[j].data[pos], &Bench_Image[offset],
+                           Bench_Blocks[i].length)) {
+      r = -2;
+    } else {
+      pos += Bench_Blocks[i].length;
+      offset += Bench_Blocks[i].length;
+    }
+
+    if ((0 == r) && filled && (0 == i)) {
+      for (; pos < (Bench_Blocks[0].length + BENCH_HOLE_SIZE); pos++) {
+        if (0xFF != srec->blks[j].data[pos]) {
+          r = -3;
+        }
+      }
+    } else if ((0 == r) && (pos != srec->blks[j].length)) {
+      r = -1;
+    } else {
+      pos = 0;
+      j++;
+    }
+  }
+
+  return r;
+}
+
+static void Bench_Parse(const char *path, const char *threads, size_t textSize) {
+  srec_t *srec;
+  double t0, t;
+  int r;
+
+  if (NULL != threads) {
+    setenv("SREC_THREADS", threads, 1);
+  } else {
+    unsetenv("SREC_THREADS");
+  }
+  t0 = Bench_Now();
+  srec = srec_open(path);
+  t = Bench_Now() - t0;
+  r = (NULL != srec) ? Bench_Verify(srec) : -4;
+  printf("parse %-18s threads=%-4s: %7.1f ms, %7.1f MB/s, verify %s(%d)\n", path,
+         (NULL != threads) ? threads : "all", t * 1000, textSize / t / 1e6,
+         (0 == r) ? "ok" : "FAIL", r);
+  srec_close(srec);
+  if (0 != r) {
+    exit(-1);
+  }
+}
+
+static void Bench_Sign(const char *path, srec_sign_type_t signType, size_t total) {
+  double t0, t;
+  int r;
+
+  t0 = Bench_Now();
+  r = srec_sign(path, total, signType);
+  t = Bench_Now() - t0;
+  printf("sign %s type %d: %7.1f ms, r=%d\n", path, signType, t * 1000, r);
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  size_t textSize = (size_t)BENCH_TEXT_SIZE_MB * 1024 * 1024;
+  const char *s19 = "srec_bench.s19";
+  const char *hex = "srec_bench.hex";
+  size_t total;
+  double t0;
+
+  if (argc > 1) {
+    textSize = (size_t)atoi(argv[1]) * 1024 * 1024;
+  }
+
+  srand(1);
+  t0 = Bench_Now();
+  if (0 != Bench_Generate(s19, hex, textSize)) {
+    printf("failed to generate the images\n");
+    return -1;
+  }
+  printf("generated %u MB S-Record and Intel HEX in %.1f s\n", (uint32_t)(textSize >> 20),
+         Bench_Now() - t0);
+
+  Bench_Parse(s19, "1", textSize);
+  Bench_Parse(s19, NULL, textSize);
+  Bench_Parse(hex, "1", textSize);
+  Bench_Parse(hex, NULL, textSize);
+
+  total = Bench_Blocks[2].address + Bench_Blocks[2].length - Bench_Blocks[0].address + 4;
+  Bench_Sign(s19, SREC_SIGN_CRC32, total);
+  Bench_Sign(s19, SREC_SIGN_CRC32_V2, Bench_Blocks[2].address + Bench_Blocks[2].length);
+  Bench_Sign(s19, SREC_SIGN_CRC32_V3, 0);
+
+  free(Bench_Image);
+  return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * SSAS - Simple Smart Automotive Software
+ * Copyright (C) 2025 Parai Wang <parai@foxmail.com>
+ *
+ * Generate a big S-Record and the same image as Intel HEX, big enough to be parsed in chunks by
+ * several threads. The image parsed with 1 thread and with several threads must be the generated
+ * one, and the S-Record signed by the v3 method must carry the blocks and the CRC32 of the image.
+ */
+/* ================================ [ INCLUDES  ] ============================================== */
+#include "srec.h"
+#include "Crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+/* ================================ [ MACROS    ] ============================================== */
+#ifndef TEST_TEXT_SIZE_MB
+#define TEST_TEXT_SIZE_MB 32
+#endif
+
+#define TEST_LINE_BYTES 32
+/* the first block has a hole smaller than FLASH_WRITE_SIZE, which is filled with 0xFF */
+#define TEST_HOLE_SIZE 4
+#define TEST_ADDRESS 0x80000000UL
+#define TEST_SECOND_GAP 0x1000
+
+#ifdef _WIN32
+#define setenv(name, value, overwrite) _putenv_s(name, value)
+#define unsetenv(name) _putenv_s(name, "")
+#endif
+/* ================================ [ TYPES     ] ============================================== */
+typedef struct {
+  uint32_t address;
+  uint32_t length;
+} test_block_t;
+/* ================================ [ DECLARES  ] ============================================== */
+/* ================================ [ DATAS     ] ============================================== */
+static uint8_t *testImage;
+static test_block_t testBlocks[3];
+static const char testHex[] = "0123456789ABCDEF";
+/* ================================ [ LOCALS    ] ============================================== */
+static void test_write_srec_line(FILE *fp, uint32_t address, const uint8_t *data, uint32_t len) {
+  char line[128];
+  uint8_t sum = (uint8_t)(len + 5);
+  int n;
+  uint32_t i;
+
+  sum += (uint8_t)(address >> 24) + (uint8_t)(address >> 16) + (uint8_t)(address >> 8) +
+         (uint8_t)address;
+  n = sprintf(line, "S3%02X%08X", len + 5, address);
+  for (i = 0; i < len; i++) {
+    line[n++] = testHex[data[i] >> 4];
+    line[n++] = testHex[data[i] & 0xF];
+    sum += data[i];
+  }
+  sprintf(&line[n], "%02X\n", (uint8_t)~sum);
+  fputs(line, fp);
+}
+
+static void test_write_hex_line(FILE *fp, uint32_t *base, uint32_t address, const uint8_t *data,
+                                uint32_t len) {
+  char line[128];
+  uint8_t sum;
+  int n;
+  uint32_t i;
+
+  if ((address & 0xFFFF0000UL) != *base) {
+    *base = address & 0xFFFF0000UL;
+    sum = (uint8_t)(2 + 4 + (uint8_t)(*base >> 24) + (uint8_t)(*base >> 16));
+    fprintf(fp, ":02000004%04X%02X\n", *base >> 16, (uint8_t)(1 + ~sum));
+  }
+
+  sum = (uint8_t)(len + (uint8_t)(address >> 8) + (uint8_t)address);
+  n = sprintf(line, ":%02X%04X00", len, address & 0xFFFF);
+  for (i = 0; i < len; i++) {
+    line[n++] = testHex[data[i] >> 4];
+    line[n++] = testHex[data[i] & 0xF];
+    sum += data[i];
+  }
+  sprintf(&line[n], "%02X\n", (uint8_t)(1 + ~sum));
+  fputs(line, fp);
+}
+
+/* lines never cross a 64K boundary so that the ihex base records stay simple */
+static int test_generate(const char *s19, const char *hex, size_t textSize) {
+  FILE *fpS = fopen(s19, "wb");
+  FILE *fpH = fopen(hex, "wb");
+  uint32_t base = 0xFFFFFFFFUL;
+  uint32_t total, offset, address, len;
+  int i, r = 0;
+
+  /* S3 line with 32 bytes payload is 79 chars */
+  total = (uint32_t)(textSize / 79 * TEST_LINE_BYTES);
+  testBlocks[0].address = TEST_ADDRESS;
+  testBlocks[0].length = total / 2;
+  testBlocks[1].address = TEST_ADDRESS + total / 2 + TEST_HOLE_SIZE;
+  testBlocks[1].length = total / 4;
+  testBlocks[2].address = testBlocks[1].address + total / 4 + TEST_SECOND_GAP;
+  testBlocks[2].length = total / 4;
+
+  testImage = (uint8_t *)malloc(total);
+  if ((NULL == fpS) || (NULL == fpH) || (NULL == testImage)) {
+    r = -1;
+  } else {
+    for (offset = 0; offset < total; offset++) {
+      testImage[offset] = (uint8_t)rand();
+    }
+    fprintf(fpS, "S00F000068656C6C6F202020202000003C\n");
+    offset = 0;
+    for (i = 0; i < 3; i++) {
+      for (address = 0; address < testBlocks[i].length; address += len) {
+        len = testBlocks[i].length - address;
+        if (len > TEST_LINE_BYTES) {
+          len = TEST_LINE_BYTES;
+        }
+        test_write_srec_line(fpS, testBlocks[i].address + address, &testImage[offset], len);
+        test_write_hex_line(fpH, &base, testBlocks[i].address + address, &testImage[offset],
+                            len);
+        offset += len;
+      }
+    }
+    fprintf(fpS, "S70580000000FA\n");
+    fprintf(fpH, ":00000001FF\n");
+  }
+
+  if (NULL != fpS) {
+    fclose(fpS);
+  }
+  if (NULL != fpH) {
+    fclose(fpH);
+  }
+
+  return r;
+}
+
+/* S-Record fills the hole of the first block with 0xFF, Intel HEX keeps it as a separate block */
+static int test_verify(srec_t *srec) {
+  int filled = (SREC_SRECORD == srec->type);
+  size_t offset = 0;
+  size_t pos = 0;
+  int r = 0;
+  int i, j = 0;
+
+  if (srec->numOfBlks != (size_t)(filled ? 2 : 3)) {
+    r = -1;
+  }
+
+  for (i = 0; (0 == r) && (i < 3); i++) {
+    if ((0 == pos) && (srec->blks[j].address != testBlocks[i].address)) {
+      r = -1;
+    } else if (0 != memcmp(&srec->blks[j].data[pos], &testImage[offset], testBlocks[i].length)) {
+      r = -2;
+    } else {
+      pos += testBlocks[i].length;
+      offset += testBlocks[i].length;
+    }
+
+    if ((0 == r) && filled && (0 == i)) {
+      for (; pos < (testBlocks[0].length + TEST_HOLE_SIZE); pos++) {
+        if (0xFF != srec->blks[j].data[pos]) {
+          r = -3;
+        }
+      }
+    } else if ((0 == r) && (pos != srec->blks[j].length)) {
+      r = -1;
+    } else {
+      pos = 0;
+      j++;
+    }
+  }
+
+  return r;
+}
+
+static srec_t *test_open(const char *path, const char *threads) {
+  if (NULL != threads) {
+    setenv("SREC_THREADS", threads, 1);
+  } else {
+    unsetenv("SREC_THREADS");
+  }
+
+  return srec_open(path);
+}
+
+static const uint8_t *test_find(srec_t *srec, uint32_t address, uint32_t length) {
+  const uint8_t *data = NULL;
+  size_t i;
+
+  for (i = 0; (i < srec->numOfBlks) && (NULL == data); i++) {
+    if ((address >= srec->blks[i].address) &&
+        ((address + length) <= (srec->blks[i].address + srec->blks[i].length))) {
+      data = &srec->blks[i].data[address - srec->blks[i].address];
+    }
+  }
+
+  return data;
+}
+
+static uint32_t test_get32(const uint8_t *data) {
+  return ((uint32_t)data[0] << 24) + ((uint32_t)data[1] << 16) + ((uint32_t)data[2] << 8) +
+         data[3];
+}
+
+static void Test_Parse(const char *path, const char *threads) {
+  srec_t *srec;
+  int r;
+
+  printf("Test parse %s with %s threads:", path, (NULL != threads) ? threads : "all");
+  srec = test_open(path, threads);
+  r = (NULL != srec) ? test_verify(srec) : -4;
+  srec_close(srec);
+  printf(" %s\n", (0 == r) ? "PASS" : "FAIL");
+  if (0 != r) {
+    printf("  verify error %d\n", r);
+    exit(-1);
+  }
+}
+
+static void Test_SignV3(const char *s19) {
+  static const uint8_t hole[TEST_HOLE_SIZE] = {0xFF, 0xFF, 0xFF, 0xFF};
+  char path[256];
+  uint32_t signAddr = testBlocks[2].address + testBlocks[2].length;
+  uint32_t crc = 0xFFFFFFFFUL;
+  uint32_t offset = 0;
+  const uint8_t *sign = NULL;
+  srec_t *srec = NULL;
+  bool bPass;
+  int i;
+
+  printf("Test sign %s by the v3 CRC32 method:", s19);
+  /* the CRC of the image as flashed, with the hole filled */
+  for (i = 0; i < 3; i++) {
+    crc = Crc_CalculateCRC32(&testImage[offset], testBlocks[i].length, crc, FALSE);
+    offset += testBlocks[i].length;
+    if (0 == i) {
+      crc = Crc_CalculateCRC32(hole, sizeof(hole), crc, FALSE);
+    }
+  }
+
+  bPass = (0 == srec_sign(s19, 0, SREC_SIGN_CRC32_V3));
+  if (bPass) {
+    snprintf(path, sizeof(path), "%s.sign", s19);
+    srec = test_open(path, NULL);
+    bPass = (NULL != srec);
+  }
+  if (bPass) {
+    sign = test_find(srec, signAddr, 2 * 8 + 16);
+    bPass = (NULL != sign);
+  }
+  if (bPass) {
+    bPass = (testBlocks[0].address == test_get32(&sign[0])) &&
+            ((testBlocks[0].length + TEST_HOLE_SIZE + testBlocks[1].length) ==
+             test_get32(&sign[4])) &&
+            (testBlocks[2].address == test_get32(&sign[8])) &&
+            (testBlocks[2].length == test_get32(&sign[12])) && (2u == test_get32(&sign[16])) &&
+            (crc == test_get32(&sign[20])) && (0 == memcmp(&sign[24], "$BYASV3#", 8));
+  }
+  srec_close(srec);
+  printf(" %s\n", bPass ? "PASS" : "FAIL");
+  if (false == bPass) {
+    printf("  no sign of 2 blocks with CRC32 %08X at %08X\n", crc, signAddr);
+    exit(-1);
+  }
+}
+/* ================================ [ FUNCTIONS ] ============================================== */
+int main(int argc, char *argv[]) {
+  size_t textSize = (size_t)TEST_TEXT_SIZE_MB * 1024 * 1024;
+  const char *s19 = "srec_test.s19";
+  const char *hex = "srec_test.hex";
+
+  srand(1);
+  if (0 != test_generate(s19, hex, textSize)) {
+    printf("failed to generate the images\n");
+    return -1;
+  }
+
+  Test_Parse(s19, "1");
+  Test_Parse(s19, "3");
+  Test_Parse(s19, NULL);
+  Test_Parse(hex, "1");
+  Test_Parse(hex, "3");
+  Test_Parse(hex, NULL);
+  Test_SignV3(s19);
+
+  free(testImage);
+  return 0;
+}